@@ -3,6 +3,7 @@
 #include "CryptoCipherModeException.h"
 #include "CryptoSymmetricException.h"
 #include "GCM.h"
+#include "GCMSIV.h"
 #include "HBA.h"
 
 NAMESPACE_HELPER
@@ -12,6 +13,7 @@ using Exception::CryptoSymmetricException;
 using Enumeration::ErrorCodes;
 using Enumeration::StreamAuthenticators;
 using Cipher::Block::Mode::GCM;
+using Cipher::Block::Mode::GCMSIV;
 using Cipher::Block::Mode::HBA;
 
 const std::string AeadModeFromName::CLASS_NAME("AeadModeFromName");
@@ -33,6 +35,11 @@ IAeadMode* AeadModeFromName::GetInstance(IBlockCipher* Cipher, AeadModes CipherM
 				mptr = new GCM(Cipher); 
 				break;
 			}
+			case AeadModes::GCMSIV:
+			{
+				mptr = new GCMSIV(Cipher);
+				break;
+			}
 			case AeadModes::HBAH256:
 			{
 				mptr = new HBA(Cipher, StreamAuthenticators::HMACSHA2256); 
@@ -89,6 +96,11 @@ IAeadMode* AeadModeFromName::GetInstance(BlockCiphers CipherType, AeadModes Ciph
 				mptr = new GCM(CipherType); 
 				break;
 			}
+			case AeadModes::GCMSIV:
+			{
+				mptr = new GCMSIV(CipherType);
+				break;
+			}
 			case AeadModes::HBAH256:
 			{
 				mptr = new HBA(CipherType, StreamAuthenticators::HMACSHA2256); 
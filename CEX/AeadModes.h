@@ -20,6 +20,10 @@ enum class AeadModes : uint8_t
 	/// </summary>
 	GCM = static_cast<uint8_t>(CipherModes::GCM),
 	/// <summary>
+	/// Galois Counter Synthetic IV Mode; nonce misuse-resistant counter mode encryption with POLYVAL authentication
+	/// </summary>
+	GCMSIV = static_cast<uint8_t>(CipherModes::GCMSIV),
+	/// <summary>
 	/// Counter-mode Hash-based Authentication AEAD mode
 	/// </summary>
 	HBA = static_cast<uint8_t>(CipherModes::HBA),
@@ -2,6 +2,7 @@
 #include "BlockCipherFromName.h"
 #include "IntegerTools.h"
 #include "MemoryTools.h"
+#include "ParallelScratch.h"
 #include "ParallelTools.h"
 #include "ProviderFromName.h"
 #include "Rijndael.h"
@@ -16,6 +17,7 @@ using Enumeration::BlockCipherConvert;
 using Enumeration::DrbgConvert;
 using Tools::IntegerTools;
 using Tools::MemoryTools;
+using Tools::ParallelScratch;
 using Tools::ParallelTools;
 using Enumeration::ProviderConvert;
 using Enumeration::ShakeModes;
@@ -29,10 +31,11 @@ class BCG::BcgState
 {
 public:
 	
-	SecureVector<uint32_t> RoundKeys;
+	SecureVector<uint64_t> RoundKeys;
 	SecureVector<uint8_t> Custom;
 	SecureVector<uint8_t> Name;
-	SecureVector<uint8_t> Nonce;
+	std::vector<uint8_t> Nonce;
+	ParallelScratch Scratch;
 	uint64_t Counter = 0;
 	size_t KeySize = 0;
 	size_t Reseed = 0;
@@ -48,6 +51,7 @@ public:
 		Custom(0),
 		Name(0),
 		Nonce(BLOCK_SIZE, 0x00),
+		Scratch(),
 		Threshold(ReseedMax),
 		IsDestroyed(Destroyed),
 		IsParallel(Parallel)
@@ -56,10 +60,11 @@ public:
 
 	~BcgState()
 	{
-		MemoryTools::Clear(RoundKeys, 0, RoundKeys.size() * sizeof(uint32_t));
+		MemoryTools::Clear(RoundKeys, 0, RoundKeys.size() * sizeof(uint64_t));
 		MemoryTools::Clear(Custom, 0, Custom.size());
 		MemoryTools::Clear(Name, 0, Name.size());
 		MemoryTools::Clear(Nonce, 0, Nonce.size());
+		Scratch.Clear();
 
 		Counter = 0;
 		KeySize = 0;
@@ -73,10 +78,11 @@ public:
 
 	void Reset()
 	{
-		MemoryTools::Clear(RoundKeys, 0, RoundKeys.size() * sizeof(uint32_t));
+		MemoryTools::Clear(RoundKeys, 0, RoundKeys.size() * sizeof(uint64_t));
 		MemoryTools::Clear(Custom, 0, Custom.size());
 		MemoryTools::Clear(Name, 0, Name.size());
 		MemoryTools::Clear(Nonce, 0, Nonce.size());
+		Scratch.Clear();
 
 		Counter = 0;
 		KeySize = 0;
@@ -106,6 +112,7 @@ BCG::BCG(Providers ProviderType, bool Parallel)
 	m_bcgState(new BcgState(DEF_RESEED, true, Parallel)),
 	m_parallelProfile(BLOCK_SIZE, true, RESERVE_CACHE, false)
 {
+	m_parallelProfile.SetAlgorithm(Name());
 }
 
 BCG::BCG(IProvider* Provider, bool Parallel)
@@ -126,6 +133,7 @@ BCG::BCG(IProvider* Provider, bool Parallel)
 	m_bcgState(new BcgState(DEF_RESEED, true, Parallel)),
 	m_parallelProfile(BLOCK_SIZE, true, RESERVE_CACHE, false)
 {
+	m_parallelProfile.SetAlgorithm(Name());
 }
 
 BCG::~BCG()
@@ -305,7 +313,7 @@ void BCG::Initialize(ISymmetricKey &Parameters)
 
 	// size the round key array
 	const size_t RNKLEN = (BLOCK_SIZE / sizeof(uint32_t)) * (static_cast<size_t>(m_bcgState->Rounds) + 1UL);
-	m_bcgState->RoundKeys.resize(RNKLEN);
+	SecureVector<uint32_t> tmpk(RNKLEN);
 	// generate the round keys to a temporary uint8_t array
 	SecureVector<uint8_t> tmpr(RNKLEN * sizeof(uint32_t));
 	// generate the ciphers round-keys
@@ -314,9 +322,12 @@ void BCG::Initialize(ISymmetricKey &Parameters)
 	// realign in big endian format
 	for (i = 0; i < tmpr.size() / sizeof(uint32_t); ++i)
 	{
-		m_bcgState->RoundKeys[i] = IntegerTools::BeBytesTo32(tmpr, i * sizeof(uint32_t));
+		tmpk[i] = IntegerTools::BeBytesTo32(tmpr, i * sizeof(uint32_t));
 	}
 
+	// transpose the round keys for the bitsliced transforms
+	BitslicedExpand(tmpk, BLOCK_SIZE, m_bcgState->RoundKeys);
+	MemoryTools::Clear(tmpk, 0, tmpk.size() * sizeof(uint32_t));
 	MemoryTools::Clear(tmpr, 0, tmpr.size());
 	m_bcgState->IsInitialized = true;
 }
@@ -372,7 +383,7 @@ void BCG::Update(const SecureVector<uint8_t> &Key)
 	}
 
 	// reinitialize the generator with the nonce and distribution codes preserved
-	SymmetricKey kp(tmpk, m_bcgState->Nonce, m_bcgState->Custom);
+	SymmetricKey kp(tmpk, SecureLock(m_bcgState->Nonce), m_bcgState->Custom);
 	Initialize(kp);
 	// reset the reseed counter
 	m_bcgState->Counter = 0;
@@ -393,15 +404,7 @@ void BCG::Derive(SecureVector<uint8_t> &Key, std::unique_ptr<IProvider> &Provide
 	gen.Generate(Key);
 }
 
-CEX_OPTIMIZE_IGNORE
-void BCG::PrefetchSbox()
-{
-	// timing defence: pre-load sbox into l1 cache
-	MemoryTools::PrefetchL1(SBox, 0, SBox.size());
-}
-CEX_OPTIMIZE_RESUME
-
-void BCG::Transform(SecureVector<uint8_t> &Output, size_t OutOffset, size_t Length, SecureVector<uint8_t> &Counter)
+void BCG::Transform(SecureVector<uint8_t> &Output, size_t OutOffset, size_t Length, std::vector<uint8_t> &Counter, std::vector<uint8_t> &Buffer)
 {
 	size_t bctr;
 
@@ -411,115 +414,50 @@ void BCG::Transform(SecureVector<uint8_t> &Output, size_t OutOffset, size_t Leng
 	// as the full counter length. This is because this cipher is not expected to encrypt
 	// more that 2^128 bytes of data with a single key.
 
-#if defined(CEX_HAS_AVX512)
-
-	const size_t AVX512BLK = 16 * BLOCK_SIZE;
-
-	if (Length >= AVX512BLK)
+	if (Length >= SCRATCH_SIZE)
 	{
-		const size_t PBKALN = Length - (Length % AVX512BLK);
-		SecureVector<uint8_t> tmpc(AVX512BLK);
+		const size_t PBKALN = Length - (Length % SCRATCH_SIZE);
 
-		// stagger counters and process 8 blocks with avx512
+		// stagger counters and process 16 blocks, eight bitsliced states
 		while (bctr != PBKALN)
 		{
-			MemoryTools::Copy(Counter, 0, tmpc, 0, BLOCK_SIZE);
-			IntegerTools::LeIncrement(Counter, 16);
-			MemoryTools::Copy(Counter, 0, tmpc, 32, BLOCK_SIZE);
-			IntegerTools::LeIncrement(Counter, 16);
-			MemoryTools::Copy(Counter, 0, tmpc, 64, BLOCK_SIZE);
-			IntegerTools::LeIncrement(Counter, 16);
-			MemoryTools::Copy(Counter, 0, tmpc, 96, BLOCK_SIZE);
-			IntegerTools::LeIncrement(Counter, 16);
-			MemoryTools::Copy(Counter, 0, tmpc, 128, BLOCK_SIZE);
-			IntegerTools::LeIncrement(Counter, 16);
-			MemoryTools::Copy(Counter, 0, tmpc, 160, BLOCK_SIZE);
-			IntegerTools::LeIncrement(Counter, 16);
-			MemoryTools::Copy(Counter, 0, tmpc, 192, BLOCK_SIZE);
-			IntegerTools::LeIncrement(Counter, 16);
-			MemoryTools::Copy(Counter, 0, tmpc, 224, BLOCK_SIZE);
-			IntegerTools::LeIncrement(Counter, 16);
-			MemoryTools::Copy(Counter, 0, tmpc, 256, BLOCK_SIZE);
+			MemoryTools::Copy(Counter, 0, Buffer, 0, BLOCK_SIZE);
 			IntegerTools::LeIncrement(Counter, 16);
-			MemoryTools::Copy(Counter, 0, tmpc, 288, BLOCK_SIZE);
+			MemoryTools::Copy(Counter, 0, Buffer, 32, BLOCK_SIZE);
 			IntegerTools::LeIncrement(Counter, 16);
-			MemoryTools::Copy(Counter, 0, tmpc, 320, BLOCK_SIZE);
+			MemoryTools::Copy(Counter, 0, Buffer, 64, BLOCK_SIZE);
 			IntegerTools::LeIncrement(Counter, 16);
-			MemoryTools::Copy(Counter, 0, tmpc, 352, BLOCK_SIZE);
+			MemoryTools::Copy(Counter, 0, Buffer, 96, BLOCK_SIZE);
 			IntegerTools::LeIncrement(Counter, 16);
-			MemoryTools::Copy(Counter, 0, tmpc, 384, BLOCK_SIZE);
+			MemoryTools::Copy(Counter, 0, Buffer, 128, BLOCK_SIZE);
 			IntegerTools::LeIncrement(Counter, 16);
-			MemoryTools::Copy(Counter, 0, tmpc, 416, BLOCK_SIZE);
+			MemoryTools::Copy(Counter, 0, Buffer, 160, BLOCK_SIZE);
 			IntegerTools::LeIncrement(Counter, 16);
-			MemoryTools::Copy(Counter, 0, tmpc, 448, BLOCK_SIZE);
+			MemoryTools::Copy(Counter, 0, Buffer, 192, BLOCK_SIZE);
 			IntegerTools::LeIncrement(Counter, 16);
-			MemoryTools::Copy(Counter, 0, tmpc, 480, BLOCK_SIZE);
+			MemoryTools::Copy(Counter, 0, Buffer, 224, BLOCK_SIZE);
 			IntegerTools::LeIncrement(Counter, 16);
-			Transform4096(tmpc, 0, Output, OutOffset + bctr);
-			bctr += AVX512BLK;
-}
-	}
-
-#elif defined(CEX_HAS_AVX2)
-
-	const size_t AVX2BLK = 8 * BLOCK_SIZE;
-
-	if (Length >= AVX2BLK)
-	{
-		const size_t PBKALN = Length - (Length % AVX2BLK);
-		SecureVector<uint8_t> tmpc(AVX2BLK);
-
-		// stagger counters and process 8 blocks with avx2
-		while (bctr != PBKALN)
-		{
-			MemoryTools::Copy(Counter, 0, tmpc, 0, BLOCK_SIZE);
+			MemoryTools::Copy(Counter, 0, Buffer, 256, BLOCK_SIZE);
 			IntegerTools::LeIncrement(Counter, 16);
-			MemoryTools::Copy(Counter, 0, tmpc, 32, BLOCK_SIZE);
+			MemoryTools::Copy(Counter, 0, Buffer, 288, BLOCK_SIZE);
 			IntegerTools::LeIncrement(Counter, 16);
-			MemoryTools::Copy(Counter, 0, tmpc, 64, BLOCK_SIZE);
+			MemoryTools::Copy(Counter, 0, Buffer, 320, BLOCK_SIZE);
 			IntegerTools::LeIncrement(Counter, 16);
-			MemoryTools::Copy(Counter, 0, tmpc, 96, BLOCK_SIZE);
+			MemoryTools::Copy(Counter, 0, Buffer, 352, BLOCK_SIZE);
 			IntegerTools::LeIncrement(Counter, 16);
-			MemoryTools::Copy(Counter, 0, tmpc, 128, BLOCK_SIZE);
+			MemoryTools::Copy(Counter, 0, Buffer, 384, BLOCK_SIZE);
 			IntegerTools::LeIncrement(Counter, 16);
-			MemoryTools::Copy(Counter, 0, tmpc, 160, BLOCK_SIZE);
+			MemoryTools::Copy(Counter, 0, Buffer, 416, BLOCK_SIZE);
 			IntegerTools::LeIncrement(Counter, 16);
-			MemoryTools::Copy(Counter, 0, tmpc, 192, BLOCK_SIZE);
+			MemoryTools::Copy(Counter, 0, Buffer, 448, BLOCK_SIZE);
 			IntegerTools::LeIncrement(Counter, 16);
-			MemoryTools::Copy(Counter, 0, tmpc, 224, BLOCK_SIZE);
+			MemoryTools::Copy(Counter, 0, Buffer, 480, BLOCK_SIZE);
 			IntegerTools::LeIncrement(Counter, 16);
-			Transform2048(tmpc, 0, Output, OutOffset + bctr);
-			bctr += AVX2BLK;
+			Transform4096(Buffer, 0, Output, OutOffset + bctr);
+			bctr += SCRATCH_SIZE;
 		}
 	}
 
-#elif defined(CEX_HAS_AVX)
-
-	const size_t AVXBLK = 4 * BLOCK_SIZE;
-
-	if (Length >= AVXBLK)
-	{
-		const size_t PBKALN = Length - (Length % AVXBLK);
-		SecureVector<uint8_t> tmpc(AVXBLK);
-
-		// 4 blocks with avx
-		while (bctr != PBKALN)
-		{
-			MemoryTools::Copy(Counter, 0, tmpc, 0, BLOCK_SIZE);
-			IntegerTools::LeIncrement(Counter, 16);
-			MemoryTools::Copy(Counter, 0, tmpc, 32, BLOCK_SIZE);
-			IntegerTools::LeIncrement(Counter, 16);
-			MemoryTools::Copy(Counter, 0, tmpc, 64, BLOCK_SIZE);
-			IntegerTools::LeIncrement(Counter, 16);
-			MemoryTools::Copy(Counter, 0, tmpc, 96, BLOCK_SIZE);
-			IntegerTools::LeIncrement(Counter, 16);
-			Transform1024(tmpc, 0, Output, OutOffset + bctr);
-			bctr += AVXBLK;
-		}
-	}
-
-#endif
-
 	const size_t BLKALN = Length - (Length % BLOCK_SIZE);
 
 	while (bctr != BLKALN)
@@ -531,11 +469,11 @@ void BCG::Transform(SecureVector<uint8_t> &Output, size_t OutOffset, size_t Leng
 
 	if (bctr != Length)
 	{
-		SecureVector<uint8_t> otp(BLOCK_SIZE);
-		Transform256(Counter, 0, otp, 0);
-		IntegerTools::LeIncrement(Counter, 16);
 		const size_t RMDLEN = Length % BLOCK_SIZE;
-		MemoryTools::Copy(otp, 0, Output, OutOffset + (Length - RMDLEN), RMDLEN);
+		// the partial block is generated in the scratch buffer
+		BitslicedEncrypt256(m_bcgState->RoundKeys, m_bcgState->Rounds, Counter, 0, Buffer, 0, BLOCK_SIZE);
+		IntegerTools::LeIncrement(Counter, 16);
+		MemoryTools::Copy(Buffer, 0, Output, OutOffset + (Length - RMDLEN), RMDLEN);
 	}
 }
 
@@ -543,32 +481,30 @@ void BCG::Process(SecureVector<uint8_t> &Output, size_t OutOffset, size_t Length
 {
 	if (!IsParallel() || Length < ParallelBlockSize())
 	{
+		m_bcgState->Scratch.Reserve(1, BLOCK_SIZE, SCRATCH_SIZE);
 		// not parallel or too small; generate pseudo-random directly to output
-		Transform(Output, OutOffset, Length, m_bcgState->Nonce);
+		Transform(Output, OutOffset, Length, m_bcgState->Nonce, m_bcgState->Scratch.Buffer(0));
 	}
 	else
 	{
 		const size_t CNKLEN = ParallelBlockSize() / m_parallelProfile.ParallelMaxDegree();
 		const size_t CTRLEN = (CNKLEN / BLOCK_SIZE);
-		std::vector<uint8_t> tmpc(BLOCK_SIZE);
 
-		ParallelTools::ParallelFor(0, m_parallelProfile.ParallelMaxDegree(), [this, &Output, OutOffset, &tmpc, CNKLEN, CTRLEN](size_t i)
+		// the per-worker counters and blocks are kept by the instance, and are allocated only on first use
+		m_bcgState->Scratch.Reserve(m_parallelProfile.ParallelMaxDegree(), BLOCK_SIZE, SCRATCH_SIZE);
+
+		ParallelTools::ParallelFor(m_parallelProfile, Output.data() + OutOffset, 0, m_parallelProfile.ParallelMaxDegree(), [this, &Output, OutOffset, CNKLEN, CTRLEN](size_t i)
 		{
 			// thread level counter
-			SecureVector<uint8_t> thdCtr(BLOCK_SIZE);
+			std::vector<uint8_t> &thdc = m_bcgState->Scratch.Counter(i);
 			// offset counter by chunk size / block size  
-			IntegerTools::BeIncrease8(m_bcgState->Nonce, thdCtr, static_cast<uint32_t>(CTRLEN * i));
+			IntegerTools::BeIncrease8(m_bcgState->Nonce, thdc, static_cast<uint32_t>(CTRLEN * i));
 			// generate random at output offset
-			this->Transform(Output, OutOffset + (i * CNKLEN), CNKLEN, thdCtr);
-			// store last counter
-			if (i == m_parallelProfile.ParallelMaxDegree() - 1)
-			{
-				MemoryTools::Copy(thdCtr, 0, tmpc, 0, tmpc.size());
-			}
+			this->Transform(Output, OutOffset + (i * CNKLEN), CNKLEN, thdc, m_bcgState->Scratch.Buffer(i));
 		});
 
 		// copy last counter to class variable
-		MemoryTools::Copy(tmpc, 0, m_bcgState->Nonce, 0, m_bcgState->Nonce.size());
+		MemoryTools::Copy(m_bcgState->Scratch.Counter(m_parallelProfile.ParallelMaxDegree() - 1), 0, m_bcgState->Nonce, 0, m_bcgState->Nonce.size());
 		// last block processing
 		const size_t ALNLEN = CNKLEN * m_parallelProfile.ParallelMaxDegree();
 
@@ -576,54 +512,30 @@ void BCG::Process(SecureVector<uint8_t> &Output, size_t OutOffset, size_t Length
 		{
 			const size_t FNLLEN = Length - ALNLEN;
 			OutOffset += ALNLEN;
-			Transform(Output, OutOffset, FNLLEN, m_bcgState->Nonce);
+			Transform(Output, OutOffset, FNLLEN, m_bcgState->Nonce, m_bcgState->Scratch.Buffer(0));
 		}
 	}
 }
 
-void BCG::Transform256(const SecureVector<uint8_t> &Input, size_t InOffset, SecureVector<uint8_t> &Output, size_t OutOffset)
+void BCG::Transform256(const std::vector<uint8_t> &Input, size_t InOffset, SecureVector<uint8_t> &Output, size_t OutOffset)
 {
-	SecureVector<uint8_t> state(BLOCK_SIZE, 0x00);
-	size_t i;
-
-	MemoryTools::Copy(Input, InOffset, state, 0, BLOCK_SIZE);
-	KeyAddition(state, m_bcgState->RoundKeys, 0);
-
-	// pre-load the s-box into L1 cache
-#if defined(CEX_PREFETCH_RIJNDAEL_TABLES)
-	PrefetchSbox();
-#endif
-
-	for (i = 1; i < m_bcgState->Rounds; ++i)
-	{
-		Substitution(state);
-		ShiftRows256(state);
-		MixColumns(state);
-		KeyAddition(state, m_bcgState->RoundKeys, (i << 3UL));
-	}
-
-	Substitution(state);
-	ShiftRows256(state);
-	KeyAddition(state, m_bcgState->RoundKeys, static_cast<size_t>(m_bcgState->Rounds) << 3UL);
-
-	MemoryTools::Copy(state, 0, Output, OutOffset, BLOCK_SIZE);
+	BitslicedEncrypt256(m_bcgState->RoundKeys, m_bcgState->Rounds, Input, InOffset, Output, OutOffset, BLOCK_SIZE);
 }
 
-void BCG::Transform1024(const SecureVector<uint8_t> &Input, size_t InOffset, SecureVector<uint8_t> &Output, size_t OutOffset)
+void BCG::Transform1024(const std::vector<uint8_t> &Input, size_t InOffset, SecureVector<uint8_t> &Output, size_t OutOffset)
 {
-	Transform256(Input, InOffset, Output, OutOffset);
-	Transform256(Input, InOffset + 32, Output, OutOffset + 32);
-	Transform256(Input, InOffset + 64, Output, OutOffset + 64);
-	Transform256(Input, InOffset + 96, Output, OutOffset + 96);
+	// the bitsliced state holds two blocks
+	BitslicedEncrypt256(m_bcgState->RoundKeys, m_bcgState->Rounds, Input, InOffset, Output, OutOffset, 2 * BLOCK_SIZE);
+	BitslicedEncrypt256(m_bcgState->RoundKeys, m_bcgState->Rounds, Input, InOffset + 64, Output, OutOffset + 64, 2 * BLOCK_SIZE);
 }
 
-void BCG::Transform2048(const SecureVector<uint8_t> &Input, size_t InOffset, SecureVector<uint8_t> &Output, size_t OutOffset)
+void BCG::Transform2048(const std::vector<uint8_t> &Input, size_t InOffset, SecureVector<uint8_t> &Output, size_t OutOffset)
 {
 	Transform1024(Input, InOffset, Output, OutOffset);
 	Transform1024(Input, InOffset + 128, Output, OutOffset + 128);
 }
 
-void BCG::Transform4096(const SecureVector<uint8_t> &Input, size_t InOffset, SecureVector<uint8_t> &Output, size_t OutOffset)
+void BCG::Transform4096(const std::vector<uint8_t> &Input, size_t InOffset, SecureVector<uint8_t> &Output, size_t OutOffset)
 {
 	Transform2048(Input, InOffset, Output, OutOffset);
 	Transform2048(Input, InOffset + 256, Output, OutOffset + 256);
@@ -95,7 +95,7 @@ using Cipher::SymmetricKey;
 /// <item><description>The LegalKeySizes() property contains a list of supported nonce and key and sizes.</description></item>
 /// <item><description>There are three LegalKeySizes, minimum, recommended, and maximum, with BCG, the middle value is the recommended seed length for best security; i.e. LegalKeySizes()[1].</description></item>
 /// <item><description>The Generate() methods can not be used until the Initialize() function has been called, and the generator has been keyed and is ready to generate pseudo-random output.</description></item>
-/// <item><description>This implementation has been both pipelined (AVX128, AVX256, or AVX512) and optionally multi-threaded.</description></item>
+/// <item><description>The Rijndael transform is bitsliced and constant-time, with no lookup tables; the counter blocks are batched, and the generator is optionally multi-threaded.</description></item>
 /// <item><description>The security of this block cipher CTR generator is the key length to a maximum of the block size (256-bit security maximum).</description></item>
 /// </list>
 /// 
@@ -127,6 +127,8 @@ private:
 	static const size_t MINKEY_LENGTH = 16;
 	// L2 cache reserved estimate
 	static const size_t RESERVE_CACHE = 2048;
+	// the widest counter block; 16 blocks, eight bitsliced states
+	static const size_t SCRATCH_SIZE = 16 * BLOCK_SIZE;
 	// the bcg default info string
 	static const std::vector<uint8_t> BCG_INFO;
 
@@ -303,12 +305,11 @@ private:
 
 	static void Derive(SecureVector<uint8_t> &Key, std::unique_ptr<IProvider> &Provider);
 	void Process(SecureVector<uint8_t> &Output, size_t OutOffset, size_t Length);
-	static void PrefetchSbox();
-	void Transform(SecureVector<uint8_t> &Output, size_t OutOffset, size_t Length, SecureVector<uint8_t> &Counter);
-	void Transform256(const SecureVector<uint8_t> &Input, size_t InOffset, SecureVector<uint8_t> &Output, size_t OutOffset);
-	void Transform1024(const SecureVector<uint8_t> &Input, size_t InOffset, SecureVector<uint8_t> &Output, size_t OutOffset);
-	void Transform2048(const SecureVector<uint8_t> &Input, size_t InOffset, SecureVector<uint8_t> &Output, size_t OutOffset);
-	void Transform4096(const SecureVector<uint8_t> &Input, size_t InOffset, SecureVector<uint8_t> &Output, size_t OutOffset);
+	void Transform(SecureVector<uint8_t> &Output, size_t OutOffset, size_t Length, std::vector<uint8_t> &Counter, std::vector<uint8_t> &Buffer);
+	void Transform256(const std::vector<uint8_t> &Input, size_t InOffset, SecureVector<uint8_t> &Output, size_t OutOffset);
+	void Transform1024(const std::vector<uint8_t> &Input, size_t InOffset, SecureVector<uint8_t> &Output, size_t OutOffset);
+	void Transform2048(const std::vector<uint8_t> &Input, size_t InOffset, SecureVector<uint8_t> &Output, size_t OutOffset);
+	void Transform4096(const std::vector<uint8_t> &Input, size_t InOffset, SecureVector<uint8_t> &Output, size_t OutOffset);
 };
 
 NAMESPACE_DRBGEND
@@ -59,6 +59,8 @@ Blake256::Blake256(bool Parallel)
 	}
 
 	Reset();
+
+	m_parallelProfile.SetAlgorithm(Name());
 }
 
 Blake256::Blake256(BlakeParams &Params)
@@ -91,6 +93,8 @@ Blake256::Blake256(BlakeParams &Params)
 	}
 
 	Reset();
+
+	m_parallelProfile.SetAlgorithm(Name());
 }
 
 Blake256::~Blake256()
@@ -449,7 +453,7 @@ void Blake256::Update(const std::vector<uint8_t> &Input, size_t InOffset, size_t
 				tlen -= m_msgBuffer.size();
 
 				// empty the entire message buffer
-				ParallelTools::ParallelFor(0, m_treeParams.FanOut(), [this, &Input, InOffset](size_t i)
+				ParallelTools::ParallelFor(m_parallelProfile, 0, m_treeParams.FanOut(), [this, &Input, InOffset](size_t i)
 				{
 					IntegerTools::LeIncreaseW(m_dgtState[i].T, m_dgtState[i].T, Blake::BLAKE256_RATE_SIZE);
 					Permute(m_msgBuffer, i * Blake::BLAKE256_RATE_SIZE, m_dgtState[i]);
@@ -467,7 +471,7 @@ void Blake256::Update(const std::vector<uint8_t> &Input, size_t InOffset, size_t
 					}
 
 					// process large blocks
-					ParallelTools::ParallelFor(0, m_treeParams.FanOut(), [this, &Input, InOffset, plen](size_t i)
+					ParallelTools::ParallelFor(m_parallelProfile, 0, m_treeParams.FanOut(), [this, &Input, InOffset, plen](size_t i)
 					{
 						ProcessLeaf(Input, InOffset + (i * Blake::BLAKE256_RATE_SIZE), plen, m_dgtState[i]);
 					});
@@ -493,7 +497,7 @@ void Blake256::Update(const std::vector<uint8_t> &Input, size_t InOffset, size_t
 				m_msgLength = m_msgBuffer.size();
 
 				// process first half of buffer
-				ParallelTools::ParallelFor(0, m_treeParams.FanOut(), [this, &Input, InOffset](size_t i)
+				ParallelTools::ParallelFor(m_parallelProfile, 0, m_treeParams.FanOut(), [this, &Input, InOffset](size_t i)
 				{
 					IntegerTools::LeIncreaseW(m_dgtState[i].T, m_dgtState[i].T, Blake::BLAKE256_RATE_SIZE);
 					Permute(m_msgBuffer, i * Blake::BLAKE256_RATE_SIZE, m_dgtState[i]);
@@ -61,6 +61,8 @@ Blake512::Blake512(bool Parallel)
 	}
 
 	Reset();
+
+	m_parallelProfile.SetAlgorithm(Name());
 }
 
 Blake512::Blake512(BlakeParams &Params)
@@ -95,6 +97,8 @@ Blake512::Blake512(BlakeParams &Params)
 	}
 
 	Reset();
+
+	m_parallelProfile.SetAlgorithm(Name());
 }
 
 Blake512::~Blake512()
@@ -450,7 +454,7 @@ void Blake512::Update(const std::vector<uint8_t> &Input, size_t InOffset, size_t
 				tlen -= m_msgBuffer.size();
 
 				// empty the message buffer
-				ParallelTools::ParallelFor(0, m_treeParams.FanOut(), [this, &Input, InOffset](size_t i)
+				ParallelTools::ParallelFor(m_parallelProfile, 0, m_treeParams.FanOut(), [this, &Input, InOffset](size_t i)
 				{
 					IntegerTools::LeIncreaseW(m_dgtState[i].T, m_dgtState[i].T, Blake::BLAKE512_RATE_SIZE);
 					Permute(m_msgBuffer, i * Blake::BLAKE512_RATE_SIZE, m_dgtState[i]);
@@ -467,7 +471,7 @@ void Blake512::Update(const std::vector<uint8_t> &Input, size_t InOffset, size_t
 					}
 
 					// process large blocks
-					ParallelTools::ParallelFor(0, m_treeParams.FanOut(), [this, &Input, InOffset, plen](size_t i)
+					ParallelTools::ParallelFor(m_parallelProfile, 0, m_treeParams.FanOut(), [this, &Input, InOffset, plen](size_t i)
 					{
 						ProcessLeaf(Input, InOffset + (i * Blake::BLAKE512_RATE_SIZE), plen, m_dgtState[i]);
 					});
@@ -494,7 +498,7 @@ void Blake512::Update(const std::vector<uint8_t> &Input, size_t InOffset, size_t
 				m_msgLength = m_msgBuffer.size();
 
 				// process first half of buffer
-				ParallelTools::ParallelFor(0, m_treeParams.FanOut(), [this, &Input, InOffset](size_t i)
+				ParallelTools::ParallelFor(m_parallelProfile, 0, m_treeParams.FanOut(), [this, &Input, InOffset](size_t i)
 				{
 					IntegerTools::LeIncreaseW(m_dgtState[i].T, m_dgtState[i].T, Blake::BLAKE512_RATE_SIZE);
 					Permute(m_msgBuffer, i * Blake::BLAKE512_RATE_SIZE, m_dgtState[i]);
@@ -3,6 +3,7 @@
 #include "IntegerTools.h"
 #include "MemoryTools.h"
 #include "ParallelTools.h"
+#include "RHX.h"
 
 NAMESPACE_MODE
 
@@ -11,6 +12,7 @@ using Enumeration::CipherModeConvert;
 using Tools::IntegerTools;
 using Tools::MemoryTools;
 using Tools::ParallelTools;
+using Block::RHX;
 
 class CBC::CbcState
 {
@@ -54,6 +56,7 @@ CBC::CBC(BlockCiphers CipherType)
 		throw CryptoCipherModeException(CipherModeConvert::ToName(CipherModes::CBC), std::string("Constructor"), std::string("The cipher type can not be none!"), ErrorCodes::InvalidParam)),
 	m_parallelProfile(BLOCK_SIZE, true, m_blockCipher->StateCacheSize(), true)
 {
+	m_parallelProfile.SetAlgorithm(Name());
 }
 
 CBC::CBC(IBlockCipher* Cipher)
@@ -64,6 +67,7 @@ CBC::CBC(IBlockCipher* Cipher)
 		throw CryptoCipherModeException(CipherModeConvert::ToName(CipherModes::CBC), std::string("Constructor"), std::string("The cipher type can not be null!"), ErrorCodes::IllegalOperation)),
 	m_parallelProfile(BLOCK_SIZE, true, m_blockCipher->StateCacheSize(), true)
 {
+	m_parallelProfile.SetAlgorithm(Name());
 }
 
 CBC::~CBC()
@@ -157,7 +161,7 @@ void CBC::DecryptBlock(const std::vector<uint8_t> &Input, std::vector<uint8_t> &
 	CEXASSERT(IsInitialized(), "The cipher mode has not been initialized!");
 	CEXASSERT(!IsEncryption(), "The cipher mode has been initialized for encryption!");
 
-	Decrypt128(Input, 0, Output, 0);
+	Decrypt128(Input.data(), Output.data());
 }
 
 void CBC::DecryptBlock(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset)
@@ -165,7 +169,15 @@ void CBC::DecryptBlock(const std::vector<uint8_t> &Input, size_t InOffset, std::
 	CEXASSERT(IsInitialized(), "The cipher mode has not been initialized!");
 	CEXASSERT(!IsEncryption(), "The cipher mode has been initialized for encryption!");
 
-	Decrypt128(Input, InOffset, Output, OutOffset);
+	Decrypt128(Input.data() + InOffset, Output.data() + OutOffset);
+}
+
+void CBC::DecryptBlock(const uint8_t* Input, uint8_t* Output)
+{
+	CEXASSERT(IsInitialized(), "The cipher mode has not been initialized!");
+	CEXASSERT(!IsEncryption(), "The cipher mode has been initialized for encryption!");
+
+	Decrypt128(Input, Output);
 }
 
 void CBC::EncryptBlock(const std::vector<uint8_t> &Input, std::vector<uint8_t> &Output)
@@ -173,7 +185,7 @@ void CBC::EncryptBlock(const std::vector<uint8_t> &Input, std::vector<uint8_t> &
 	CEXASSERT(IsInitialized(), "The cipher mode has not been initialized!");
 	CEXASSERT(IsEncryption(), "The cipher mode has been initialized for decryption!");
 
-	Encrypt128(Input, 0, Output, 0);
+	Encrypt128(Input.data(), Output.data());
 }
 
 void CBC::EncryptBlock(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset)
@@ -181,7 +193,119 @@ void CBC::EncryptBlock(const std::vector<uint8_t> &Input, size_t InOffset, std::
 	CEXASSERT(IsInitialized(), "The cipher mode has not been initialized!");
 	CEXASSERT(IsEncryption(), "The cipher mode has been initialized for decryption!");
 
-	Encrypt128(Input, InOffset, Output, OutOffset);
+	Encrypt128(Input.data() + InOffset, Output.data() + OutOffset);
+}
+
+void CBC::EncryptBlock(const uint8_t* Input, uint8_t* Output)
+{
+	CEXASSERT(IsInitialized(), "The cipher mode has not been initialized!");
+	CEXASSERT(IsEncryption(), "The cipher mode has been initialized for decryption!");
+
+	Encrypt128(Input, Output);
+}
+
+void CBC::EncryptStreams(std::vector<CBC*> &Streams, const std::vector<std::vector<uint8_t>> &Input, std::vector<std::vector<uint8_t>> &Output)
+{
+	std::vector<size_t> act(0);
+	std::vector<RHX*> cpr(0);
+	std::vector<uint8_t> inp(STREAM_LANES * BLOCK_SIZE);
+	std::vector<uint8_t> otp(STREAM_LANES * BLOCK_SIZE);
+	std::vector<size_t> pos(Streams.size(), 0);
+	BlockCiphers ctype;
+	size_t i;
+	size_t nxt;
+	bool rhx;
+
+	if (Input.size() != Streams.size() || Output.size() != Streams.size())
+	{
+		throw CryptoCipherModeException(std::string("CBC"), std::string("EncryptStreams"), std::string("The input and output counts must equal the stream count!"), ErrorCodes::InvalidParam);
+	}
+
+	rhx = true;
+
+	for (i = 0; i < Streams.size(); ++i)
+	{
+		if (!Streams[i]->IsInitialized() || !Streams[i]->IsEncryption())
+		{
+			throw CryptoCipherModeException(std::string("CBC"), std::string("EncryptStreams"), std::string("The cipher modes must be initialized for encryption!"), ErrorCodes::NotInitialized);
+		}
+
+		if (Input[i].size() % BLOCK_SIZE != 0 || Output[i].size() < Input[i].size())
+		{
+			throw CryptoCipherModeException(std::string("CBC"), std::string("EncryptStreams"), std::string("The input must be block aligned, and the output at least the input size!"), ErrorCodes::InvalidSize);
+		}
+
+		ctype = Streams[i]->m_blockCipher->Enumeral();
+		rhx = rhx && (ctype == BlockCiphers::AES || ctype == BlockCiphers::RHXH256 || ctype == BlockCiphers::RHXH512 || ctype == BlockCiphers::RHXS256 || ctype == BlockCiphers::RHXS512);
+	}
+
+	if (!rhx)
+	{
+		for (i = 0; i < Streams.size(); ++i)
+		{
+			Streams[i]->Process(Input[i].data(), Output[i].data(), Input[i].size());
+		}
+	}
+	else
+	{
+		act.reserve(STREAM_LANES);
+		cpr.reserve(STREAM_LANES);
+		nxt = 0;
+
+		while (true)
+		{
+			// fill the free lanes with the next pending streams
+			while (act.size() < STREAM_LANES && nxt < Streams.size())
+			{
+				if (Input[nxt].size() != 0)
+				{
+					act.push_back(nxt);
+					cpr.push_back(static_cast<RHX*>(Streams[nxt]->m_blockCipher.get()));
+				}
+
+				++nxt;
+			}
+
+			if (act.size() == 0)
+			{
+				break;
+			}
+
+			for (i = 0; i < act.size(); ++i)
+			{
+				MemoryTools::COPY128(Streams[act[i]]->m_cbcState->IV, 0, inp, i * BLOCK_SIZE);
+				MemoryTools::XOR128(Input[act[i]], pos[act[i]], inp, i * BLOCK_SIZE);
+			}
+
+			RHX::EncryptLanes(cpr, inp, 0, otp, 0);
+
+			for (i = 0; i < act.size(); ++i)
+			{
+				MemoryTools::COPY128(otp, i * BLOCK_SIZE, Output[act[i]], pos[act[i]]);
+				MemoryTools::COPY128(otp, i * BLOCK_SIZE, Streams[act[i]]->m_cbcState->IV, 0);
+				pos[act[i]] += BLOCK_SIZE;
+			}
+
+			// retire the completed streams
+			i = 0;
+
+			while (i < act.size())
+			{
+				if (pos[act[i]] == Input[act[i]].size())
+				{
+					act.erase(act.begin() + i);
+					cpr.erase(cpr.begin() + i);
+				}
+				else
+				{
+					++i;
+				}
+			}
+		}
+
+		MemoryTools::Clear(inp, 0, inp.size());
+		MemoryTools::Clear(otp, 0, otp.size());
+	}
 }
 
 void CBC::Initialize(bool Encryption, ISymmetricKey &Parameters)
@@ -226,186 +350,127 @@ void CBC::ParallelMaxDegree(size_t Degree)
 void CBC::Transform(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length)
 {
 	CEXASSERT(IsInitialized(), "The cipher mode has not been initialized!");
+	CEXASSERT(IntegerTools::Min(Input.size() - InOffset, Output.size() - OutOffset) >= Length, "The data arrays are smaller than the length!");
 
-	Process(Input, InOffset, Output, OutOffset, Length);
+	Process(Input.data() + InOffset, Output.data() + OutOffset, Length);
+}
+
+void CBC::Transform(const uint8_t* Input, uint8_t* Output, size_t Length)
+{
+	CEXASSERT(IsInitialized(), "The cipher mode has not been initialized!");
+
+	// the chaining vector is carried by the instance, and chains directly on the callers memory
+	Process(Input, Output, Length);
 }
 
 //~~~Private Functions~~~//
 
-void CBC::Decrypt128(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset)
+void CBC::Decrypt128(const uint8_t* Input, uint8_t* Output)
 {
-	CEXASSERT(IntegerTools::Min(Input.size() - InOffset, Output.size() - OutOffset) >= BLOCK_SIZE, "The data arrays are smaller than the block-size!");
+	std::array<uint8_t, BLOCK_SIZE> tmpv;
 
-	std::vector<uint8_t> tmpv(BLOCK_SIZE);
-	MemoryTools::COPY128(Input, InOffset, tmpv, 0);
-	m_blockCipher->DecryptBlock(Input, InOffset, Output, OutOffset);
-	MemoryTools::XOR128(m_cbcState->IV, 0, Output, OutOffset);
-	MemoryTools::COPY128(tmpv, 0, m_cbcState->IV, 0);
+	// the cipher-text is the next chaining vector, and is read before an in-place transform overwrites it
+	MemoryTools::CopyRaw(Input, tmpv.data(), BLOCK_SIZE);
+	m_blockCipher->DecryptBlock(Input, Output);
+	MemoryTools::XorRaw(m_cbcState->IV.data(), Output, BLOCK_SIZE);
+	MemoryTools::CopyRaw(tmpv.data(), m_cbcState->IV.data(), BLOCK_SIZE);
 }
 
-void CBC::DecryptParallel(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset)
+void CBC::DecryptParallel(const uint8_t* Input, uint8_t* Output)
 {
-	const size_t SEGLEN = m_parallelProfile.ParallelBlockSize() / m_parallelProfile.ParallelMaxDegree();
+	const size_t SEGCNT = m_parallelProfile.ParallelSegmentCount();
+	const size_t SEGLEN = m_parallelProfile.ParallelBlockSize() / SEGCNT;
 	const size_t BLKCNT = (SEGLEN / BLOCK_SIZE);
+	std::vector<uint8_t> tmpr(SEGCNT * BLOCK_SIZE);
 	std::vector<uint8_t> tmpv(BLOCK_SIZE);
+	size_t i;
+
+	// the chaining vectors of each segment are read before the threads start, so the transform can be in-place
+	MemoryTools::COPY128(m_cbcState->IV, 0, tmpr, 0);
 
-	ParallelTools::ParallelFor(0, m_parallelProfile.ParallelMaxDegree(), [this, &Input, InOffset, &Output, OutOffset, &tmpv, SEGLEN, BLKCNT](size_t i)
+	for (i = 1; i < SEGCNT; ++i)
 	{
-		std::vector<uint8_t> thdv(BLOCK_SIZE);
+		MemoryTools::CopyRaw(Input + (i * SEGLEN) - BLOCK_SIZE, tmpr.data() + (i * BLOCK_SIZE), BLOCK_SIZE);
+	}
 
-		if (i != 0)
-		{
-			MemoryTools::COPY128(Input, (InOffset + (i * SEGLEN)) - BLOCK_SIZE, thdv, 0);
-		}
-		else
-		{
-			MemoryTools::COPY128(m_cbcState->IV, 0, thdv, 0);
-		}
+	ParallelTools::ParallelFor(m_parallelProfile, Output, 0, SEGCNT, [this, Input, Output, &tmpr, &tmpv, SEGLEN, BLKCNT, SEGCNT](size_t i)
+	{
+		std::vector<uint8_t> thdv(BLOCK_SIZE);
 
-		this->DecryptSegment(Input, InOffset + i * SEGLEN, Output, OutOffset + i * SEGLEN, thdv, BLKCNT);
+		MemoryTools::COPY128(tmpr, i * BLOCK_SIZE, thdv, 0);
+		this->DecryptSegment(Input + (i * SEGLEN), Output + (i * SEGLEN), thdv, BLKCNT);
 
-		if (i == m_parallelProfile.ParallelMaxDegree() - 1)
+		if (i == SEGCNT - 1)
 		{
 			MemoryTools::COPY128(thdv, 0, tmpv, 0);
 		}
 	});
 
 	MemoryTools::COPY128(tmpv, 0, m_cbcState->IV, 0);
+	MemoryTools::Clear(tmpr, 0, tmpr.size());
 }
 
-void CBC::DecryptSegment(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, std::vector<uint8_t> &Iv, size_t BlockCount)
+void CBC::DecryptSegment(const uint8_t* Input, uint8_t* Output, std::vector<uint8_t> &Iv, size_t BlockCount)
 {
 	size_t bctr;
-	size_t rctr;
 
 	bctr = BlockCount;
 
-#if defined(CEX_HAS_AVX512)
 	if (bctr > 15)
 	{
-		// 512bit avx512
-		const size_t AVX512BLK = 256;
-		rctr = (bctr / 16);
-		std::vector<uint8_t> tmpv(AVX512BLK);
-		std::vector<uint8_t> tmpn(AVX512BLK);
-		const size_t BLKOFT = AVX512BLK - Iv.size();
-
-		// build wide iv
-		MemoryTools::COPY128(Iv, 0, tmpv, 0);
-		MemoryTools::Copy(Input, InOffset, tmpv, BLOCK_SIZE, BLKOFT);
-
-		while (rctr != 0)
-		{
-			const size_t INPOFT = InOffset + BLKOFT;
-			// store next iv
-			MemoryTools::Copy(Input, INPOFT, tmpn, 0, (Input.size() - INPOFT >= AVX512BLK) ? AVX512BLK : Input.size() - INPOFT);
-			// transform 8 blocks
-			m_blockCipher->Transform2048(Input, InOffset, Output, OutOffset);
-			// xor the set
-			MemoryTools::XOR1024(tmpv, 0, Output, OutOffset);
-			MemoryTools::XOR1024(tmpv, 128, Output, OutOffset + 128);
-			// swap iv
-			MemoryTools::Copy(tmpn, 0, tmpv, 0, AVX512BLK);
-			InOffset += AVX512BLK;
-			OutOffset += AVX512BLK;
-			bctr -= 16;
-			--rctr;
-		}
+		// 16 blocks; the cipher selects its widest simd kernel at run-time
+		const size_t WIDBLK = 256;
+		std::vector<uint8_t> tmpc(WIDBLK);
+		std::vector<uint8_t> tmpp(WIDBLK);
+		std::vector<uint8_t> tmpv(WIDBLK);
 
-		MemoryTools::COPY128(tmpn, 0, Iv, 0);
-	}
-#elif defined(CEX_HAS_AVX2)
-	if (bctr > 7)
-	{
-		// 256bit avx2
-		const size_t AVX2BLK = 128;
-		rctr = (bctr / 8);
-		std::vector<uint8_t> tmpv(AVX2BLK);
-		std::vector<uint8_t> tmpn(AVX2BLK);
-		const size_t BLKOFT = AVX2BLK - Iv.size();
-
-		// build wide iv
 		MemoryTools::COPY128(Iv, 0, tmpv, 0);
-		MemoryTools::Copy(Input, InOffset, tmpv, BLOCK_SIZE, BLKOFT);
 
-		while (rctr != 0)
+		while (bctr > 15)
 		{
-			const size_t INPOFT = InOffset + BLKOFT;
-			// store next iv
-			MemoryTools::Copy(Input, INPOFT, tmpn, 0, (Input.size() - INPOFT >= AVX2BLK) ? AVX2BLK: Input.size() - INPOFT);
-			// transform 8 blocks
-			m_blockCipher->Transform1024(Input, InOffset, Output, OutOffset);
-			// xor the set
-			MemoryTools::XOR1024(tmpv, 0, Output, OutOffset);
-			// swap iv
-			MemoryTools::Copy(tmpn, 0, tmpv, 0, AVX2BLK);
-			InOffset += AVX2BLK;
-			OutOffset += AVX2BLK;
-			bctr -= 8;
-			--rctr;
-		}
-
-		MemoryTools::COPY128(tmpn, 0, Iv, 0);
-	}
-#elif defined(CEX_HAS_AVX)
-	if (bctr > 3)
-	{
-		// 128bit avx
-		const size_t AVXBLK = 64;
-		rctr = (bctr / 4);
-		std::vector<uint8_t> tmpv(AVXBLK);
-		std::vector<uint8_t> tmpn(AVXBLK);
-		const size_t BLKOFT = AVXBLK - Iv.size();
-
-		MemoryTools::COPY128(Iv, 0, tmpv, 0);
-		MemoryTools::Copy(Input, InOffset, tmpv, BLOCK_SIZE, BLKOFT);
-
-		while (rctr != 0)
-		{
-			const size_t INPOFT = InOffset + BLKOFT;
-			MemoryTools::Copy(Input, INPOFT, tmpn, 0, (Input.size() - INPOFT >= AVXBLK) ? AVXBLK : Input.size() - INPOFT);
-			m_blockCipher->Transform512(Input, InOffset, Output, OutOffset);
-			MemoryTools::XOR512(tmpv, 0, Output, OutOffset);
-			MemoryTools::Copy(tmpn, 0, tmpv, 0, AVXBLK);
-			InOffset += AVXBLK;
-			OutOffset += AVXBLK;
-			bctr -= 4;
-			--rctr;
+			// the cipher-text of the set is read before the output is written, and is the chaining vector of the following block
+			MemoryTools::CopyRaw(Input, tmpc.data(), WIDBLK);
+			MemoryTools::CopyRaw(tmpc.data(), tmpv.data() + BLOCK_SIZE, WIDBLK - BLOCK_SIZE);
+			// transform 16 blocks
+			m_blockCipher->Transform2048(tmpc, 0, tmpp, 0, BlockCount * BLOCK_SIZE);
+			// xor the set with the chaining vectors into the output
+			MemoryTools::XorRaw(tmpv.data(), tmpp.data(), Output, WIDBLK);
+			MemoryTools::COPY128(tmpc, WIDBLK - BLOCK_SIZE, tmpv, 0);
+			Input += WIDBLK;
+			Output += WIDBLK;
+			bctr -= 16;
 		}
 
-		MemoryTools::COPY128(tmpn, 0, Iv, 0);
+		MemoryTools::COPY128(tmpv, 0, Iv, 0);
+		MemoryTools::Clear(tmpp, 0, tmpp.size());
 	}
-#endif
 
 	if (bctr != 0)
 	{
-		std::vector<uint8_t> tmpi(BLOCK_SIZE);
+		std::array<uint8_t, BLOCK_SIZE> tmpi;
 
 		while (bctr != 0)
 		{
-			MemoryTools::COPY128(Input, InOffset, tmpi, 0);
-			m_blockCipher->DecryptBlock(Input, InOffset, Output, OutOffset);
-			MemoryTools::XOR128(Iv, 0, Output, OutOffset);
-			MemoryTools::COPY128(tmpi, 0, Iv, 0);
-			InOffset += BLOCK_SIZE;
-			OutOffset += BLOCK_SIZE;
+			MemoryTools::CopyRaw(Input, tmpi.data(), BLOCK_SIZE);
+			m_blockCipher->DecryptBlock(Input, Output);
+			MemoryTools::XorRaw(Iv.data(), Output, BLOCK_SIZE);
+			MemoryTools::CopyRaw(tmpi.data(), Iv.data(), BLOCK_SIZE);
+			Input += BLOCK_SIZE;
+			Output += BLOCK_SIZE;
 			--bctr;
 		}
 	}
 }
 
-void CBC::Encrypt128(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset)
+void CBC::Encrypt128(const uint8_t* Input, uint8_t* Output)
 {
-	CEXASSERT(IntegerTools::Min(Input.size() - InOffset, Output.size() - OutOffset) >= BLOCK_SIZE, "The data arrays are smaller than the block-size!");
-
-	MemoryTools::XOR128(Input, InOffset, m_cbcState->IV, 0);
-	m_blockCipher->EncryptBlock(m_cbcState->IV, 0, Output, OutOffset);
-	MemoryTools::COPY128(Output, OutOffset, m_cbcState->IV, 0);
+	MemoryTools::XorRaw(Input, m_cbcState->IV.data(), BLOCK_SIZE);
+	m_blockCipher->EncryptBlock(m_cbcState->IV.data(), Output);
+	MemoryTools::CopyRaw(Output, m_cbcState->IV.data(), BLOCK_SIZE);
 }
 
-void CBC::Process(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length)
+void CBC::Process(const uint8_t* Input, uint8_t* Output, size_t Length)
 {
-	CEXASSERT(IntegerTools::Min(Input.size() - InOffset, Output.size() - OutOffset) >= Length, "The data arrays are smaller than the block-size!");
 	CEXASSERT(Length % m_blockCipher->BlockSize() == 0, "The length must be evenly divisible by the block ciphers block-size!");
 
 	size_t bctr;
@@ -417,7 +482,7 @@ void CBC::Process(const std::vector<uint8_t> &Input, size_t InOffset, std::vecto
 	{
 		for (i = 0; i < bctr; ++i)
 		{
-			Encrypt128(Input, (i * BLOCK_SIZE) + InOffset, Output, (i * BLOCK_SIZE) + OutOffset);
+			Encrypt128(Input + (i * BLOCK_SIZE), Output + (i * BLOCK_SIZE));
 		}
 	}
 	else
@@ -428,7 +493,7 @@ void CBC::Process(const std::vector<uint8_t> &Input, size_t InOffset, std::vecto
 
 			for (i = 0; i < PRBCNT; ++i)
 			{
-				DecryptParallel(Input, (i * m_parallelProfile.ParallelBlockSize()) + InOffset, Output, (i * m_parallelProfile.ParallelBlockSize()) + OutOffset);
+				DecryptParallel(Input + (i * m_parallelProfile.ParallelBlockSize()), Output + (i * m_parallelProfile.ParallelBlockSize()));
 			}
 
 			const size_t PRCBLK = (m_parallelProfile.ParallelBlockSize() / BLOCK_SIZE) * PRBCNT;
@@ -436,14 +501,14 @@ void CBC::Process(const std::vector<uint8_t> &Input, size_t InOffset, std::vecto
 
 			for (i = 0; i < bctr; ++i)
 			{
-				Decrypt128(Input, ((i + PRCBLK) * BLOCK_SIZE) + InOffset, Output, ((i + PRCBLK) * BLOCK_SIZE) + OutOffset);
+				Decrypt128(Input + ((i + PRCBLK) * BLOCK_SIZE), Output + ((i + PRCBLK) * BLOCK_SIZE));
 			}
 		}
 		else
 		{
 			for (i = 0; i < bctr; ++i)
 			{
-				Decrypt128(Input, (i * BLOCK_SIZE) + InOffset, Output, (i * BLOCK_SIZE) + OutOffset);
+				Decrypt128(Input + (i * BLOCK_SIZE), Output + (i * BLOCK_SIZE));
 			}
 		}
 	}
@@ -76,6 +76,7 @@ NAMESPACE_MODE
 /// <item><description>The DecryptBlock, Decrypt512, Decrypt1024  EncryptBlock, Encrypt512, Encrypt1024 functions can be accessed through the class instance.</description></item>
 /// <item><description>The transformation methods can not be called until the Initialize(bool, ISymmetricKey) function has been called.</description></item>
 /// <item><description>In CBC mode, only the decryption function can be processed in parallel.</description></item>
+/// <item><description>Many independent CBC messages can be encrypted together with the static EncryptStreams function; with AES, the streams are advanced in lockstep, eight at a time.</description></item>
 /// <item><description>The ParallelThreadsMax() property is used as the thread count in the parallel loop; this must be an even number no greater than the number of processer cores on the system.</description></item>
 /// <item><description>Parallel processing is enabled on decryption by passing an input block of at least ParallelBlockSize() to the transform; this can be disabled by setting IsParallel() to false in the ParallelProfile() accessor.</description></item>
 /// <item><description>ParallelBlockSize() is calculated automatically based on the processor(s) L1 data cache size, this property can be user defined, and must be evenly divisible by ParallelMinimumSize().</description></item>
@@ -92,6 +93,8 @@ class CBC final : public ICipherMode
 private:
 
 	static const size_t BLOCK_SIZE = 16;
+	// the number of streams advanced together by EncryptStreams
+	static const size_t STREAM_LANES = 8;
 
 	class CbcState;
 	std::unique_ptr<CbcState> m_cbcState;
@@ -229,6 +232,16 @@ public:
 	/// <param name="OutOffset">Starting offset within the output vector</param>
 	void DecryptBlock(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset) override;
 
+	/// <summary>
+	/// Decrypt a block of bytes in the callers memory.
+	/// <para>Decrypts one block of bytes without copying it to a vector; Input and Output may be the same address.
+	/// Initialize(bool, ISymmetricKey) must be called before this method can be used.</para>
+	/// </summary>
+	/// 
+	/// <param name="Input">A pointer to the block of cipher-text bytes</param>
+	/// <param name="Output">A pointer to the block of plain-text bytes</param>
+	void DecryptBlock(const uint8_t* Input, uint8_t* Output) override;
+
 	/// <summary>
 	/// Encrypt a single block of bytes. 
 	/// <para>Encrypts one block of bytes beginning at a zero index.
@@ -251,6 +264,32 @@ public:
 	/// <param name="OutOffset">Starting offset within the output vector</param>
 	void EncryptBlock(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset) override;
 
+	/// <summary>
+	/// Encrypt a block of bytes in the callers memory.
+	/// <para>Encrypts one block of bytes without copying it to a vector; Input and Output may be the same address.
+	/// Initialize(bool, ISymmetricKey) must be called before this method can be used.</para>
+	/// </summary>
+	/// 
+	/// <param name="Input">A pointer to the block of plain-text bytes</param>
+	/// <param name="Output">A pointer to the block of cipher-text bytes</param>
+	void EncryptBlock(const uint8_t* Input, uint8_t* Output) override;
+
+	/// <summary>
+	/// Encrypt many independent CBC messages, each with its own initialized cipher mode instance.
+	/// <para>CBC encryption is serial within a message, so a single stream is bound by the latency of the block cipher. 
+	/// When every instance wraps the AES (RHX) cipher, this function advances up to eight streams in lockstep, one block per stream per step, 
+	/// so the AES-NI latency of one stream is hidden by the others; when a stream completes, the next pending stream takes its place. 
+	/// The output, and the IV state left in each instance, are the same as calling Transform on each instance in turn, 
+	/// which is what the function does for other block ciphers.</para>
+	/// </summary>
+	/// 
+	/// <param name="Streams">The cipher mode instances, each initialized for encryption with its own key and IV</param>
+	/// <param name="Input">The plain-text message of each stream; each length must be a multiple of the block size</param>
+	/// <param name="Output">Receives the cipher-text of each stream; each array must be at least the size of its input</param>
+	///
+	/// <exception cref="CryptoCipherModeException">Thrown if the array counts differ, a message is not block aligned, an output is too small, or an instance is not initialized for encryption</exception>
+	static void EncryptStreams(std::vector<CBC*> &Streams, const std::vector<std::vector<uint8_t>> &Input, std::vector<std::vector<uint8_t>> &Output);
+
 	/// <summary>
 	/// Initialize the cipher-mode instance
 	/// </summary>
@@ -288,13 +327,26 @@ public:
 	/// <param name="Length">The number of bytes to transform</param>
 	void Transform(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length) override;
 
+	/// <summary>
+	/// Transform a length of bytes in the callers memory. 
+	/// <para>The pointer form of Transform, for buffers that are not held in a vector, such as pooled, mapped or scatter-gather memory.
+	/// Each segment is staged through a working buffer of ParallelBlockSize() bytes and processed by the vector transform, so the message is never copied in full;
+	/// Input and Output may be the same address for an in-place transform, but must not otherwise overlap.
+	/// Initialize(bool, ISymmetricKey) must be called before this method can be used.</para>
+	/// </summary>
+	/// 
+	/// <param name="Input">A pointer to the bytes to transform</param>
+	/// <param name="Output">A pointer to the transformed bytes</param>
+	/// <param name="Length">The number of bytes to transform</param>
+	void Transform(const uint8_t* Input, uint8_t* Output, size_t Length) override;
+
 private:
 
-	void Decrypt128(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset);
-	void DecryptParallel(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset);
-	void DecryptSegment(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, std::vector<uint8_t> &Iv, size_t BlockCount);
-	void Encrypt128(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset);
-	void Process(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length);
+	void Decrypt128(const uint8_t* Input, uint8_t* Output);
+	void DecryptParallel(const uint8_t* Input, uint8_t* Output);
+	void DecryptSegment(const uint8_t* Input, uint8_t* Output, std::vector<uint8_t> &Iv, size_t BlockCount);
+	void Encrypt128(const uint8_t* Input, uint8_t* Output);
+	void Process(const uint8_t* Input, uint8_t* Output, size_t Length);
 };
 
 NAMESPACE_MODEEND
@@ -57,6 +57,7 @@ CFB::CFB(BlockCiphers CipherType, size_t RegisterSize)
 		throw CryptoCipherModeException(CipherModeConvert::ToName(CipherModes::CFB), std::string("Constructor"), std::string("The cipher type can not be none!"), ErrorCodes::InvalidParam)),
 	m_parallelProfile(m_blockCipher->BlockSize(), false, m_blockCipher->StateCacheSize(), true)
 {
+	m_parallelProfile.SetAlgorithm(Name());
 }
 
 CFB::CFB(IBlockCipher* Cipher, size_t RegisterSize)
@@ -67,6 +68,7 @@ CFB::CFB(IBlockCipher* Cipher, size_t RegisterSize)
 		throw CryptoCipherModeException(CipherModeConvert::ToName(CipherModes::CFB), std::string("Constructor"), std::string("The cipher type can not be null!"), ErrorCodes::IllegalOperation)),
 	m_parallelProfile(m_blockCipher->BlockSize(), false, m_blockCipher->StateCacheSize(), true)
 {
+	m_parallelProfile.SetAlgorithm(Name());
 }
 
 CFB::~CFB()
@@ -155,7 +157,7 @@ void CFB::DecryptBlock(const std::vector<uint8_t> &Input, std::vector<uint8_t> &
 	CEXASSERT(IsInitialized(), "The cipher mode has not been initialized!");
 	CEXASSERT(!IsEncryption(), "The cipher mode has been initialized for encryption!");
 
-	Decrypt128(Input, 0, Output, 0);
+	Decrypt128(Input.data(), Output.data());
 }
 
 void CFB::DecryptBlock(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset)
@@ -163,7 +165,15 @@ void CFB::DecryptBlock(const std::vector<uint8_t> &Input, size_t InOffset, std::
 	CEXASSERT(IsInitialized(), "The cipher mode has not been initialized!");
 	CEXASSERT(!IsEncryption(), "The cipher mode has been initialized for encryption!");
 
-	Decrypt128(Input, InOffset, Output, OutOffset);
+	Decrypt128(Input.data() + InOffset, Output.data() + OutOffset);
+}
+
+void CFB::DecryptBlock(const uint8_t* Input, uint8_t* Output)
+{
+	CEXASSERT(IsInitialized(), "The cipher mode has not been initialized!");
+	CEXASSERT(!IsEncryption(), "The cipher mode has been initialized for encryption!");
+
+	Decrypt128(Input, Output);
 }
 
 void CFB::EncryptBlock(const std::vector<uint8_t> &Input, std::vector<uint8_t> &Output)
@@ -171,7 +181,7 @@ void CFB::EncryptBlock(const std::vector<uint8_t> &Input, std::vector<uint8_t> &
 	CEXASSERT(IsInitialized(), "The cipher mode has not been initialized!");
 	CEXASSERT(IsEncryption(), "The cipher mode has been initialized for decryption!");
 
-	Encrypt128(Input, 0, Output, 0);
+	Encrypt128(Input.data(), Output.data());
 }
 
 void CFB::EncryptBlock(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset)
@@ -179,7 +189,15 @@ void CFB::EncryptBlock(const std::vector<uint8_t> &Input, size_t InOffset, std::
 	CEXASSERT(IsInitialized(), "The cipher mode has not been initialized!");
 	CEXASSERT(IsEncryption(), "The cipher mode has been initialized for decryption!");
 
-	Encrypt128(Input, InOffset, Output, OutOffset);
+	Encrypt128(Input.data() + InOffset, Output.data() + OutOffset);
+}
+
+void CFB::EncryptBlock(const uint8_t* Input, uint8_t* Output)
+{
+	CEXASSERT(IsInitialized(), "The cipher mode has not been initialized!");
+	CEXASSERT(IsEncryption(), "The cipher mode has been initialized for decryption!");
+
+	Encrypt128(Input, Output);
 }
 
 void CFB::Initialize(bool Encryption, ISymmetricKey &Parameters)
@@ -225,21 +243,29 @@ void CFB::ParallelMaxDegree(size_t Degree)
 }
 
 void CFB::Transform(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length)
+{
+	CEXASSERT(IsInitialized(), "The cipher mode has not been initialized!");
+	CEXASSERT(IntegerTools::Min(Input.size() - InOffset, Output.size() - OutOffset) >= Length, "The data arrays are smaller than the length!");
+
+	Process(Input.data() + InOffset, Output.data() + OutOffset, Length);
+}
+
+void CFB::Transform(const uint8_t* Input, uint8_t* Output, size_t Length)
 {
 	CEXASSERT(IsInitialized(), "The cipher mode has not been initialized!");
 
-	Process(Input, InOffset, Output, OutOffset, Length);
+	// the register chains directly on the callers memory
+	Process(Input, Output, Length);
 }
 
 //~~~Private Functions~~~//
 
-void CFB::Decrypt128(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset)
+void CFB::Decrypt128(const uint8_t* Input, uint8_t* Output)
 {
-	std::vector<uint8_t> tmpr(BLOCK_SIZE);
+	std::array<uint8_t, BLOCK_SIZE> tmpr;
 	size_t i;
 
-	m_blockCipher->Transform(m_cfbState->IV, 0, tmpr, 0);
-	MemoryTools::Copy(tmpr, 0, Output, OutOffset, m_cfbState->RegisterSize);
+	m_blockCipher->EncryptBlock(m_cfbState->IV.data(), tmpr.data());
 
 	// left shift the register
 	if (m_cfbState->IV.size() - m_cfbState->RegisterSize > 0)
@@ -248,53 +274,60 @@ void CFB::Decrypt128(const std::vector<uint8_t> &Input, size_t InOffset, std::ve
 	}
 
 	// copy ciphertext to register
-	MemoryTools::Copy(Input, InOffset, m_cfbState->IV, m_cfbState->IV.size() - m_cfbState->RegisterSize, m_cfbState->RegisterSize);
+	MemoryTools::CopyRaw(Input, m_cfbState->IV.data() + (m_cfbState->IV.size() - m_cfbState->RegisterSize), m_cfbState->RegisterSize);
 
 	// xor the iv with the ciphertext producing the plaintext
 	for (i = 0; i < m_cfbState->RegisterSize; i++)
 	{
-		Output[OutOffset + i] ^= Input[InOffset + i];
+		Output[i] = tmpr[i] ^ Input[i];
 	}
+
+	MemoryTools::Clear(tmpr, 0, tmpr.size());
 }
 
-void CFB::DecryptParallel(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset)
+void CFB::DecryptParallel(const uint8_t* Input, uint8_t* Output)
 {
-	const size_t SEGLEN = m_parallelProfile.ParallelBlockSize() / m_parallelProfile.ParallelMaxDegree();
+	const size_t SEGCNT = m_parallelProfile.ParallelSegmentCount();
+	const size_t SEGLEN = m_parallelProfile.ParallelBlockSize() / SEGCNT;
 	const size_t BLKCNT = (SEGLEN / BLOCK_SIZE);
+	std::vector<uint8_t> tmpr(SEGCNT * BLOCK_SIZE);
 	std::vector<uint8_t> tmpv(BLOCK_SIZE);
+	size_t i;
 
-	ParallelTools::ParallelFor(0, m_parallelProfile.ParallelMaxDegree(), [this, &Input, InOffset, &Output, OutOffset, &tmpv, SEGLEN, BLKCNT](size_t i)
+	// the registers of each segment are read before the threads start, so the transform can be in-place
+	MemoryTools::Copy(m_cfbState->IV, 0, tmpr, 0, m_cfbState->RegisterSize);
+
+	for (i = 1; i < SEGCNT; ++i)
 	{
-		std::vector<uint8_t> thdv(BLOCK_SIZE);
+		MemoryTools::CopyRaw(Input + (i * SEGLEN) - m_cfbState->RegisterSize, tmpr.data() + (i * BLOCK_SIZE), m_cfbState->RegisterSize);
+	}
 
-		if (i != 0)
-		{
-			MemoryTools::Copy(Input, (InOffset + (i * SEGLEN)) - m_cfbState->RegisterSize, thdv, 0, m_cfbState->RegisterSize);
-		}
-		else
-		{
-			MemoryTools::Copy(m_cfbState->IV, 0, thdv, 0, m_cfbState->RegisterSize);
-		}
+	ParallelTools::ParallelFor(m_parallelProfile, Output, 0, SEGCNT, [this, Input, Output, &tmpr, &tmpv, SEGLEN, BLKCNT, SEGCNT](size_t i)
+	{
+		std::vector<uint8_t> thdv(BLOCK_SIZE);
 
-		this->DecryptSegment(Input, InOffset + i * SEGLEN, Output, OutOffset + i * SEGLEN, thdv, BLKCNT);
+		MemoryTools::Copy(tmpr, i * BLOCK_SIZE, thdv, 0, m_cfbState->RegisterSize);
+		this->DecryptSegment(Input + (i * SEGLEN), Output + (i * SEGLEN), thdv, BLKCNT);
 
-		if (i == m_parallelProfile.ParallelMaxDegree() - 1)
+		if (i == SEGCNT - 1)
 		{
 			MemoryTools::Copy(thdv, 0, tmpv, 0, m_cfbState->RegisterSize);
 		}
 	});
 
 	MemoryTools::Copy(tmpv, 0, m_cfbState->IV, 0, m_cfbState->RegisterSize);
+	MemoryTools::Clear(tmpr, 0, tmpr.size());
 }
 
-void CFB::DecryptSegment(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, std::vector<uint8_t> &Iv, size_t BlockCount)
+void CFB::DecryptSegment(const uint8_t* Input, uint8_t* Output, std::vector<uint8_t> &Iv, size_t BlockCount)
 {
+	std::array<uint8_t, BLOCK_SIZE> tmpr;
 	size_t i;
 	size_t j;
 
 	for (i = 0; i < BlockCount; i++)
 	{ 
-		m_blockCipher->Transform(Iv, 0, Output, OutOffset);
+		m_blockCipher->EncryptBlock(Iv.data(), tmpr.data());
 
 		// left shift the register
 		if (Iv.size() - m_cfbState->RegisterSize > 0)
@@ -303,32 +336,33 @@ void CFB::DecryptSegment(const std::vector<uint8_t> &Input, size_t InOffset, std
 		}
 
 		// copy ciphertext to register
-		MemoryTools::Copy(Input, InOffset, Iv, Iv.size() - m_cfbState->RegisterSize, m_cfbState->RegisterSize);
+		MemoryTools::CopyRaw(Input, Iv.data() + (Iv.size() - m_cfbState->RegisterSize), m_cfbState->RegisterSize);
 
 		// xor the iv with the ciphertext producing the plaintext
 		for (j = 0; j < m_cfbState->RegisterSize; j++)
 		{
-			Output[OutOffset + j] ^= Input[InOffset + j];
+			Output[j] = tmpr[j] ^ Input[j];
 		}
 
-		InOffset += BLOCK_SIZE;
-		OutOffset += BLOCK_SIZE;
+		Input += BLOCK_SIZE;
+		Output += BLOCK_SIZE;
 	}
+
+	MemoryTools::Clear(tmpr, 0, tmpr.size());
 }
 
-void CFB::Encrypt128(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset)
+void CFB::Encrypt128(const uint8_t* Input, uint8_t* Output)
 {
-	std::vector<uint8_t> tmpr(BLOCK_SIZE);
+	std::array<uint8_t, BLOCK_SIZE> tmpr;
 	size_t i;
 
 	// encrypt the register
-	m_blockCipher->Transform(m_cfbState->IV, 0, tmpr, 0);
-	MemoryTools::Copy(tmpr, 0, Output, OutOffset, m_cfbState->RegisterSize);
+	m_blockCipher->EncryptBlock(m_cfbState->IV.data(), tmpr.data());
 
 	// xor the ciphertext with the plaintext by block size bytes
 	for (i = 0; i < m_cfbState->RegisterSize; i++)
 	{
-		Output[OutOffset + i] ^= Input[InOffset + i];
+		Output[i] = tmpr[i] ^ Input[i];
 	}
 
 	// left shift the register
@@ -338,10 +372,11 @@ void CFB::Encrypt128(const std::vector<uint8_t> &Input, size_t InOffset, std::ve
 	}
 
 	// copy cipher text to the register
-	MemoryTools::Copy(Output, OutOffset, m_cfbState->IV, m_cfbState->IV.size() - m_cfbState->RegisterSize, m_cfbState->RegisterSize);
+	MemoryTools::CopyRaw(Output, m_cfbState->IV.data() + (m_cfbState->IV.size() - m_cfbState->RegisterSize), m_cfbState->RegisterSize);
+	MemoryTools::Clear(tmpr, 0, tmpr.size());
 }
 
-void CFB::Process(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length)
+void CFB::Process(const uint8_t* Input, uint8_t* Output, size_t Length)
 {
 	CEXASSERT(IsInitialized(), "The cipher mode has not been initialized!");
 
@@ -354,7 +389,7 @@ void CFB::Process(const std::vector<uint8_t> &Input, size_t InOffset, std::vecto
 	{
 		for (i = 0; i < bctr; ++i)
 		{
-			Encrypt128(Input, (i * m_cfbState->RegisterSize) + InOffset, Output, (i * m_cfbState->RegisterSize) + OutOffset);
+			Encrypt128(Input + (i * m_cfbState->RegisterSize), Output + (i * m_cfbState->RegisterSize));
 		}
 	}
 	else
@@ -365,7 +400,7 @@ void CFB::Process(const std::vector<uint8_t> &Input, size_t InOffset, std::vecto
 
 			for (i = 0; i < PRBCNT; ++i)
 			{
-				DecryptParallel(Input, (i * m_parallelProfile.ParallelBlockSize()) + InOffset, Output, (i * m_parallelProfile.ParallelBlockSize()) + OutOffset);
+				DecryptParallel(Input + (i * m_parallelProfile.ParallelBlockSize()), Output + (i * m_parallelProfile.ParallelBlockSize()));
 			}
 
 			const size_t PRCBLK = (m_parallelProfile.ParallelBlockSize() / BLOCK_SIZE) * PRBCNT;
@@ -373,14 +408,14 @@ void CFB::Process(const std::vector<uint8_t> &Input, size_t InOffset, std::vecto
 
 			for (i = 0; i < bctr; ++i)
 			{
-				Decrypt128(Input, ((i + PRCBLK) * BLOCK_SIZE) + InOffset, Output, ((i + PRCBLK) * BLOCK_SIZE) + OutOffset);
+				Decrypt128(Input + ((i + PRCBLK) * BLOCK_SIZE), Output + ((i + PRCBLK) * BLOCK_SIZE));
 			}
 		}
 		else
 		{
 			for (i = 0; i < bctr; ++i)
 			{
-				Decrypt128(Input, (i * m_cfbState->RegisterSize) + InOffset, Output, (i * m_cfbState->RegisterSize) + OutOffset);
+				Decrypt128(Input + (i * m_cfbState->RegisterSize), Output + (i * m_cfbState->RegisterSize));
 			}
 		}
 	}
@@ -245,6 +245,16 @@ public:
 	/// <param name="OutOffset">Starting offset within the output vector</param>
 	void DecryptBlock(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset) override;
 
+	/// <summary>
+	/// Decrypt a block of bytes in the callers memory.
+	/// <para>Decrypts one register of RegisterSize() bytes without copying it to a vector; Input and Output may be the same address.
+	/// Initialize(bool, ISymmetricKey) must be called before this method can be used.</para>
+	/// </summary>
+	/// 
+	/// <param name="Input">A pointer to the register of cipher-text bytes</param>
+	/// <param name="Output">A pointer to the register of plain-text bytes</param>
+	void DecryptBlock(const uint8_t* Input, uint8_t* Output) override;
+
 	/// <summary>
 	/// Encrypt a single block of bytes. 
 	/// <para>Encrypts one block of bytes beginning at a zero index.
@@ -267,6 +277,16 @@ public:
 	/// <param name="OutOffset">Starting offset within the output vector</param>
 	void EncryptBlock(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset) override;
 
+	/// <summary>
+	/// Encrypt a block of bytes in the callers memory.
+	/// <para>Encrypts one register of RegisterSize() bytes without copying it to a vector; Input and Output may be the same address.
+	/// Initialize(bool, ISymmetricKey) must be called before this method can be used.</para>
+	/// </summary>
+	/// 
+	/// <param name="Input">A pointer to the register of plain-text bytes</param>
+	/// <param name="Output">A pointer to the register of cipher-text bytes</param>
+	void EncryptBlock(const uint8_t* Input, uint8_t* Output) override;
+
 	/// <summary>
 	/// Initialize the cipher-mode instance
 	/// </summary>
@@ -304,13 +324,26 @@ public:
 	/// <param name="Length">The number of bytes to transform</param>
 	void Transform(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length) override;
 
+	/// <summary>
+	/// Transform a length of bytes in the callers memory. 
+	/// <para>The pointer form of Transform, for buffers that are not held in a vector, such as pooled, mapped or scatter-gather memory.
+	/// Each segment is staged through a working buffer of ParallelBlockSize() bytes, rounded down to a multiple of the register size and processed by the vector transform, so the message is never copied in full;
+	/// Input and Output may be the same address for an in-place transform, but must not otherwise overlap.
+	/// Initialize(bool, ISymmetricKey) must be called before this method can be used.</para>
+	/// </summary>
+	/// 
+	/// <param name="Input">A pointer to the bytes to transform</param>
+	/// <param name="Output">A pointer to the transformed bytes</param>
+	/// <param name="Length">The number of bytes to transform</param>
+	void Transform(const uint8_t* Input, uint8_t* Output, size_t Length) override;
+
 private:
 
-	void Decrypt128(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset);
-	void DecryptParallel(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset);
-	void DecryptSegment(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, std::vector<uint8_t> &Iv, size_t BlockCount);
-	void Encrypt128(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset);
-	void Process(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length);
+	void Decrypt128(const uint8_t* Input, uint8_t* Output);
+	void DecryptParallel(const uint8_t* Input, uint8_t* Output);
+	void DecryptSegment(const uint8_t* Input, uint8_t* Output, std::vector<uint8_t> &Iv, size_t BlockCount);
+	void Encrypt128(const uint8_t* Input, uint8_t* Output);
+	void Process(const uint8_t* Input, uint8_t* Output, size_t Length);
 };
 
 NAMESPACE_MODEEND
@@ -368,7 +368,7 @@ std::unique_ptr<CJP::JitterState> CJP::Prime()
 	state->RandomState = 0;
 	state->SecureCache = true;
 
-	CpuDetect dtc;
+	CpuDetect &dtc = CpuDetect::Instance();
 
 	if (dtc.L1CacheTotal() != 0)
 	{
@@ -1,6 +1,6 @@
 #include "CMUL.h"
 #include "IntegerTools.h"
-#if defined(CEX_HAS_AVX)
+#if defined(CEX_HAS_AESNI)
 #	include "Intrinsics.h"
 #endif
 
@@ -1110,7 +1110,7 @@ void CMUL::PermuteR128P128C(std::array<uint64_t, CMUL_STATE_SIZE> &State, std::a
 
 void CMUL::PermuteR128P128V(std::array<uint64_t, CMUL_STATE_SIZE> &State, std::array<uint8_t, CMUL_BLOCK_SIZE> &Output)
 {
-#if defined(CEX_HAS_AVX2)
+#if defined(CEX_HAS_AESNI)
 
 	const __m128i MASK = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
 	__m128i A;
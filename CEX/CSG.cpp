@@ -5,12 +5,6 @@
 #include "Keccak.h"
 #include "MemoryTools.h"
 #include "ProviderFromName.h"
-#if defined(CEX_HAS_AVX2)
-#	include "ULong256.h"
-#endif
-#if defined(CEX_HAS_AVX512)
-#	include "ULong512.h"
-#endif
 
 NAMESPACE_DRBG
 
@@ -21,12 +15,6 @@ using Digest::Keccak;
 using Tools::MemoryTools;
 using Enumeration::ProviderConvert;
 using Enumeration::ShakeModeConvert;
-#if defined(CEX_HAS_AVX2)
-	using Numeric::ULong256;
-#endif
-#if defined(CEX_HAS_AVX512)
-	using Numeric::ULong512;
-#endif
 
 const std::vector<char> CSG::CEX_PREFIX = { 0x43, 0x45, 0x58, 0x2D };
 
@@ -194,7 +182,7 @@ CSG::~CSG()
 
 const bool CSG::HasMultiLane()
 {
-	CpuDetect dtc;
+	CpuDetect &dtc = CpuDetect::Instance();
 	bool ret;
 
 	ret = (dtc.AVX2() || dtc.AVX512F()) ? true : false;
@@ -209,7 +197,7 @@ const bool CSG::IsInitialized()
 
 const size_t CSG::LaneCount()
 {
-	CpuDetect dtc;
+	CpuDetect &dtc = CpuDetect::Instance();
 	size_t lanes;
 
 	if (dtc.AVX512F())
@@ -1,16 +1,13 @@
 #include "CSX512.h"
 #include "ChaCha.h"
+#include "ChaChaKernels.h"
 #include "IntegerTools.h"
 #include "KMAC.h"
 #include "MemoryTools.h"
 #include "ParallelTools.h"
+#include "SegmentScratch.h"
 #include "SHAKE.h"
-
-#if defined(CEX_HAS_AVX2)
-#	include "UInt256.h"
-#elif defined(CEX_HAS_AVX)
-#	include "UInt128.h"
-#endif
+#include "SimdDispatch.h"
 
 NAMESPACE_STREAM
 
@@ -19,16 +16,21 @@ using Mac::KMAC;
 using Enumeration::KmacModes;
 using Tools::MemoryTools;
 using Tools::ParallelTools;
+using Tools::SegmentScratch;
+using Enumeration::SimdKernels;
+using Tools::SimdDispatch;
 
 class CSX512::CSX512State
 {
 public:
 
 	std::array<uint64_t, 2> Nonce = { 0 };
+	std::array<uint64_t, 2> Origin = { 0 };
 	std::array<uint64_t, 14> State = { 0 };
 	SecureVector<uint8_t> Custom;
 	SecureVector<uint8_t> MacKey;
 	SecureVector<uint8_t> MacTag;
+	SegmentScratch Segments;
 	std::vector<SymmetricKeySize> LegalKeySizes{
 			SymmetricKeySize(IK512_SIZE, NONCE_SIZE * sizeof(uint64_t), INFO_SIZE)};
 	uint64_t Counter = 0;
@@ -54,6 +56,7 @@ public:
 	{
 		LegalKeySizes.clear();
 		MemoryTools::Clear(Nonce, 0, Nonce.size() * sizeof(uint64_t));
+		MemoryTools::Clear(Origin, 0, Origin.size() * sizeof(uint64_t));
 		MemoryTools::Clear(State, 0, State.size() * sizeof(uint64_t));
 		MemoryTools::Clear(MacTag, 0, MacTag.size());
 		Counter = 0;
@@ -96,6 +99,10 @@ public:
 		MemoryTools::Copy(SecureState, soff, Nonce, 0, vlen);
 		soff += vlen;
 
+		vlen = static_cast<uint16_t>(Origin.size()) * sizeof(uint64_t);
+		MemoryTools::Copy(SecureState, soff, Origin, 0, vlen);
+		soff += vlen;
+
 		MemoryTools::CopyToObject(SecureState, soff, &Counter, sizeof(uint64_t));
 		soff += sizeof(uint64_t);
 		MemoryTools::CopyToObject(SecureState, soff, &IsAuthenticated, sizeof(bool));
@@ -108,8 +115,10 @@ public:
 	void Reset()
 	{
 		MemoryTools::Clear(Nonce, 0, Nonce.size() * sizeof(uint64_t));
+		MemoryTools::Clear(Origin, 0, Origin.size() * sizeof(uint64_t));
 		MemoryTools::Clear(State, 0, State.size() * sizeof(uint64_t));
 		MemoryTools::Clear(MacTag, 0, MacTag.size());
+		Segments.Clear();
 		Counter = 0;
 		IsEncryption = false;
 		IsInitialized = false;
@@ -117,7 +126,7 @@ public:
 
 	SecureVector<uint8_t> Serialize()
 	{
-		const size_t STALEN = ((State.size() * sizeof(uint64_t)) + Custom.size() + MacKey.size() + MacTag.size() + (Nonce.size() * sizeof(uint64_t)) + sizeof(uint64_t) + (3 * sizeof(uint16_t)) + (3 * sizeof(bool)));
+		const size_t STALEN = ((State.size() * sizeof(uint64_t)) + Custom.size() + MacKey.size() + MacTag.size() + (Nonce.size() * sizeof(uint64_t)) + (Origin.size() * sizeof(uint64_t)) + sizeof(uint64_t) + (3 * sizeof(uint16_t)) + (3 * sizeof(bool)));
 
 		size_t soff;
 		uint16_t vlen;
@@ -150,6 +159,10 @@ public:
 		MemoryTools::Copy(Nonce, 0, state, soff, vlen);
 		soff += vlen;
 
+		vlen = static_cast<uint16_t>(Origin.size()) * sizeof(uint64_t);
+		MemoryTools::Copy(Origin, 0, state, soff, vlen);
+		soff += vlen;
+
 		MemoryTools::CopyFromObject(&Counter, state, soff, sizeof(uint64_t));
 		soff += sizeof(uint64_t);
 		MemoryTools::CopyFromObject(&IsAuthenticated, state, soff, sizeof(bool));
@@ -175,6 +188,7 @@ CSX512::CSX512(bool Authenticate)
 	m_macAuthenticator(nullptr),
 	m_parallelProfile(BLOCK_SIZE, true, STATE_PRECACHED, true)
 {
+	m_parallelProfile.SetAlgorithm(Name());
 }
 
 CSX512::CSX512(SecureVector<uint8_t> &State)
@@ -192,6 +206,8 @@ CSX512::CSX512(SecureVector<uint8_t> &State)
 		SymmetricKey kpm(m_csx512State->MacKey);
 		m_macAuthenticator->Initialize(kpm);
 	}
+
+	m_parallelProfile.SetAlgorithm(Name());
 }
 
 CSX512::~CSX512()
@@ -408,6 +424,25 @@ SecureVector<uint8_t> CSX512::Serialize()
 	return tmps;
 }
 
+void CSX512::Seek(uint64_t Position)
+{
+	if (IsInitialized() == false)
+	{
+		throw CryptoSymmetricException(Name(), std::string("Seek"), std::string("The cipher has not been initialized!"), ErrorCodes::NotInitialized);
+	}
+	if (IsAuthenticator() == true)
+	{
+		throw CryptoSymmetricException(Name(), std::string("Seek"), std::string("The key-stream position can not be set in authentication mode!"), ErrorCodes::IllegalOperation);
+	}
+	if (Position % BLOCK_SIZE != 0)
+	{
+		throw CryptoSymmetricException(Name(), std::string("Seek"), std::string("The position must be aligned to the block size!"), ErrorCodes::InvalidParam);
+	}
+
+	// the counter is the initial nonce increased by the block index
+	IntegerTools::LeIncreaseW(m_csx512State->Origin, m_csx512State->Nonce, static_cast<size_t>(Position / BLOCK_SIZE));
+}
+
 void CSX512::SetAssociatedData(const std::vector<uint8_t> &Input, size_t Offset, size_t Length)
 {
 	if (IsInitialized() == false)
@@ -433,6 +468,31 @@ void CSX512::SetAssociatedData(const std::vector<uint8_t> &Input, size_t Offset,
 	}
 }
 
+void CSX512::SetAssociatedData(const uint8_t* Input, size_t Length)
+{
+	if (IsInitialized() == false)
+	{
+		throw CryptoSymmetricException(Name(), std::string("SetAssociatedData"), std::string("The cipher has not been initialized!"), ErrorCodes::NotInitialized);
+	}
+	if (IsAuthenticator() == false)
+	{
+		throw CryptoSymmetricException(Name(), std::string("SetAssociatedData"), std::string("The cipher has not been configured for authentication!"), ErrorCodes::IllegalOperation);
+	}
+	if (Length == 0)
+	{
+		throw CryptoSymmetricException(Name(), std::string("SetAssociatedData"), std::string("The additional data array can not be zero sized!"), ErrorCodes::InvalidSize);
+	}
+
+	if (IsAuthenticator() == true)
+	{
+		std::vector<uint8_t> code(sizeof(uint32_t));
+		// version 1.1a add AD and encoding to hash
+		static_cast<KMAC*>(m_macAuthenticator.get())->Update(Input, Length);
+		IntegerTools::Le32ToBytes(static_cast<uint32_t>(Length), code, 0);
+		m_macAuthenticator->Update(code, 0, code.size());
+	}
+}
+
 void CSX512::Transform(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length)
 {
 	if (IsEncryption() == true)
@@ -448,7 +508,7 @@ void CSX512::Transform(const std::vector<uint8_t> &Input, size_t InOffset, std::
 			m_macAuthenticator->Update(IntegerTools::Le64ToBytes<std::vector<uint8_t>>(m_csx512State->Nonce[0]), 0, sizeof(uint64_t));
 			m_macAuthenticator->Update(IntegerTools::Le64ToBytes<std::vector<uint8_t>>(m_csx512State->Nonce[1]), 0, sizeof(uint64_t));
 			// encrypt the stream
-			Process(Input, InOffset, Output, OutOffset, Length);
+			Process(Input.data(), InOffset, Output, OutOffset, Length);
 			// update the mac with the ciphertext
 			m_macAuthenticator->Update(Output, OutOffset, Length);
 			// update the mac counter
@@ -460,7 +520,7 @@ void CSX512::Transform(const std::vector<uint8_t> &Input, size_t InOffset, std::
 		else
 		{
 			// encrypt the stream
-			Process(Input, InOffset, Output, OutOffset, Length);
+			Process(Input.data(), InOffset, Output, OutOffset, Length);
 		}
 	}
 	else
@@ -484,7 +544,97 @@ void CSX512::Transform(const std::vector<uint8_t> &Input, size_t InOffset, std::
 		}
 
 		// decrypt the stream
-		Process(Input, InOffset, Output, OutOffset, Length);
+		Process(Input.data(), InOffset, Output, OutOffset, Length);
+	}
+}
+
+void CSX512::Transform(const uint8_t* Input, uint8_t* Output, size_t Length)
+{
+	// the key-stream is generated in segments, and combined with the callers memory in a single pass
+	auto gen = [this](std::vector<uint8_t> &Target, size_t Count)
+	{
+		Process(nullptr, 0, Target, 0, Count);
+	};
+
+	if (IsEncryption() == true)
+	{
+		if (IsAuthenticator() == true)
+		{
+			// add the starting position of the nonce
+			m_macAuthenticator->Update(IntegerTools::Le64ToBytes<std::vector<uint8_t>>(m_csx512State->Nonce[0]), 0, sizeof(uint64_t));
+			m_macAuthenticator->Update(IntegerTools::Le64ToBytes<std::vector<uint8_t>>(m_csx512State->Nonce[1]), 0, sizeof(uint64_t));
+			// encrypt the stream
+			m_csx512State->Segments.Keystream(Input, Output, Length, ParallelBlockSize(), gen);
+			// update the mac with the ciphertext
+			static_cast<KMAC*>(m_macAuthenticator.get())->Update(Output, Length);
+			// update the mac counter
+			m_csx512State->Counter += Length;
+			// finalize the mac and add the tag to the stream
+			Finalize(m_csx512State, m_macAuthenticator);
+			MemoryTools::CopyRaw(m_csx512State->MacTag.data(), Output + Length, m_csx512State->MacTag.size());
+		}
+		else
+		{
+			// encrypt the stream
+			m_csx512State->Segments.Keystream(Input, Output, Length, ParallelBlockSize(), gen);
+		}
+	}
+	else
+	{
+		if (IsAuthenticator() == true)
+		{
+			// add the starting position of the nonce
+			m_macAuthenticator->Update(IntegerTools::Le64ToBytes<std::vector<uint8_t>>(m_csx512State->Nonce[0]), 0, sizeof(uint64_t));
+			m_macAuthenticator->Update(IntegerTools::Le64ToBytes<std::vector<uint8_t>>(m_csx512State->Nonce[1]), 0, sizeof(uint64_t));
+			// update the mac with the ciphertext
+			static_cast<KMAC*>(m_macAuthenticator.get())->Update(Input, Length);
+			// update the mac counter
+			m_csx512State->Counter += Length;
+			// finalize the mac and verify
+			Finalize(m_csx512State, m_macAuthenticator);
+
+			if (IntegerTools::CompareRaw(Input + Length, m_csx512State->MacTag.data(), m_csx512State->MacTag.size()) == false)
+			{
+				throw CryptoAuthenticationFailure(Name(), std::string("Transform"), std::string("The authentication tag does not match!"), ErrorCodes::AuthenticationFailure);
+			}
+		}
+
+		// decrypt the stream
+		m_csx512State->Segments.Keystream(Input, Output, Length, ParallelBlockSize(), gen);
+	}
+}
+
+void CSX512::TransformAt(uint64_t Position, const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length)
+{
+	CEXASSERT(IntegerTools::Min(Input.size() - InOffset, Output.size() - OutOffset) >= Length, "The data arrays are smaller than the length!");
+
+	const size_t HDRLEN = static_cast<size_t>(Position % BLOCK_SIZE);
+	size_t i;
+	size_t prclen;
+
+	Seek(Position - HDRLEN);
+
+	if (HDRLEN != 0 && Length != 0)
+	{
+		// the position is inside a block; use the tail of that blocks key-stream
+		std::vector<uint8_t> otp(BLOCK_SIZE);
+		prclen = IntegerTools::Min(BLOCK_SIZE - HDRLEN, Length);
+		Generate(m_csx512State, otp, 0, m_csx512State->Nonce, BLOCK_SIZE);
+
+		for (i = 0; i < prclen; ++i)
+		{
+			Output[OutOffset + i] = Input[InOffset + i] ^ otp[HDRLEN + i];
+		}
+
+		MemoryTools::Clear(otp, 0, otp.size());
+		InOffset += prclen;
+		OutOffset += prclen;
+		Length -= prclen;
+	}
+
+	if (Length != 0)
+	{
+		Process(Input.data(), InOffset, Output, OutOffset, Length);
 	}
 }
 
@@ -506,15 +656,15 @@ void CSX512::Finalize(std::unique_ptr<CSX512State> &State, std::unique_ptr<IMac>
 
 void CSX512::Generate(std::unique_ptr<CSX512State> &State, std::vector<uint8_t> &Output, size_t OutOffset, std::array<uint64_t, 2> &Counter, size_t Length)
 {
+	const SimdProfiles SMDPRF = SimdDispatch::Instance().Select(ChaChaKernels::Compiled(), SimdKernels::ChaCha512, Length);
+	const size_t AVX512BLK = 8 * BLOCK_SIZE;
+	const size_t AVX2BLK = 4 * BLOCK_SIZE;
 	size_t ctr;
 
 	ctr = 0;
 
-#if defined(CEX_HAS_AVX512)
-
-	const size_t AVX512BLK = 8 * BLOCK_SIZE;
-
-	if (Length >= AVX512BLK)
+	// the widest kernel the host and the library both support, 256-bit below the wide threshold
+	if (SMDPRF == SimdProfiles::Simd512 && Length >= AVX512BLK)
 	{
 		const size_t SEGALN = Length - (Length % AVX512BLK);
 		std::array<uint64_t, 16> tmpc = { 0 };
@@ -546,16 +696,11 @@ void CSX512::Generate(std::unique_ptr<CSX512State> &State, std::vector<uint8_t>
 			MemoryTools::Copy(Counter, 0, tmpc, 7, 8);
 			MemoryTools::Copy(Counter, 1, tmpc, 15, 8);
 			IntegerTools::LeIncrementW(Counter);
-			ChaCha::PermuteP8x1024H(Output, OutOffset + ctr, tmpc, State->State, ROUND_COUNT);
+			ChaChaKernels::PermuteP8x1024H(Output.data() + OutOffset + ctr, tmpc.data(), State->State.data(), ROUND_COUNT);
 			ctr += AVX512BLK;
 		}
 	}
-
-#elif defined(CEX_HAS_AVX2)
-
-	const size_t AVX2BLK = 4 * BLOCK_SIZE;
-
-	if (Length >= AVX2BLK)
+	else if (SMDPRF == SimdProfiles::Simd256 && Length >= AVX2BLK)
 	{
 		const size_t SEGALN = Length - (Length % AVX2BLK);
 		std::array<uint64_t, 8> tmpc = { 0 };
@@ -575,12 +720,14 @@ void CSX512::Generate(std::unique_ptr<CSX512State> &State, std::vector<uint8_t>
 			MemoryTools::Copy(Counter, 0, tmpc, 3, 8);
 			MemoryTools::Copy(Counter, 1, tmpc, 7, 8);
 			IntegerTools::LeIncrementW(Counter);
-			ChaCha::PermuteP4x1024H(Output, OutOffset + ctr, tmpc, State->State, ROUND_COUNT);
+			ChaChaKernels::PermuteP4x1024H(Output.data() + OutOffset + ctr, tmpc.data(), State->State.data(), ROUND_COUNT);
 			ctr += AVX2BLK;
 		}
 	}
-
-#endif
+	else
+	{
+		// misra
+	}
 
 	const size_t ALNLEN = Length - (Length % BLOCK_SIZE);
 
@@ -593,7 +740,7 @@ void CSX512::Generate(std::unique_ptr<CSX512State> &State, std::vector<uint8_t>
 
 	if (ctr != Length)
 	{
-		std::vector<uint8_t> otp(BLOCK_SIZE, 0);
+		std::array<uint8_t, BLOCK_SIZE> otp = { 0 };
 		ChaCha::PermuteP1024C(otp, 0, Counter, State->State, ROUND_COUNT);
 		IntegerTools::LeIncrementW(Counter);
 		const size_t FNLLEN = Length % BLOCK_SIZE;
@@ -626,31 +773,26 @@ void CSX512::Load(const SecureVector<uint8_t> &Key, const SecureVector<uint8_t>
 	m_csx512State->Nonce[1] = IntegerTools::LeBytesTo64(Nonce, 8);
 
 #endif
+
+	// the initial counter is the base of the key-stream position
+	m_csx512State->Origin[0] = m_csx512State->Nonce[0];
+	m_csx512State->Origin[1] = m_csx512State->Nonce[1];
 }
 
-void CSX512::Process(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length)
+void CSX512::Process(const uint8_t* Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length)
 {
-	const size_t PRCLEN = (Length >= Input.size() - InOffset) && Length >= Output.size() - OutOffset ? IntegerTools::Min(Input.size() - InOffset, Output.size() - OutOffset) : Length;
+	// a null input writes the bare key-stream, which the pointer transform combines with the callers memory
+	const size_t PRCLEN = IntegerTools::Min(Output.size() - OutOffset, Length);
 
 	if (!m_parallelProfile.IsParallel() || PRCLEN < m_parallelProfile.ParallelMinimumSize())
 	{
 		// generate random
 		Generate(m_csx512State, Output, OutOffset, m_csx512State->Nonce, PRCLEN);
-		// output is input xor random
-		const size_t ALNLEN = PRCLEN - (PRCLEN % BLOCK_SIZE);
-
-		if (ALNLEN != 0)
-		{
-			MemoryTools::XOR(Input, InOffset, Output, OutOffset, ALNLEN);
-		}
 
-		// get the remaining bytes
-		if (ALNLEN != PRCLEN)
+		// output is input xor random
+		if (Input != nullptr && PRCLEN != 0)
 		{
-			for (size_t i = ALNLEN; i < PRCLEN; ++i)
-			{
-				Output[i + OutOffset] ^= Input[i + InOffset];
-			}
+			MemoryTools::XorRaw(Input + InOffset, Output.data() + OutOffset, PRCLEN);
 		}
 	}
 	else
@@ -659,9 +801,9 @@ void CSX512::Process(const std::vector<uint8_t> &Input, size_t InOffset, std::ve
 		const size_t CNKLEN = (PRCLEN / BLOCK_SIZE / m_parallelProfile.ParallelMaxDegree()) * BLOCK_SIZE;
 		const size_t RNDLEN = CNKLEN * m_parallelProfile.ParallelMaxDegree();
 		const size_t CTRLEN = (CNKLEN / BLOCK_SIZE);
-		std::vector<uint64_t> tmpCtr(NONCE_SIZE);
+		std::array<uint64_t, NONCE_SIZE> tmpCtr;
 
-		ParallelTools::ParallelFor(0, m_parallelProfile.ParallelMaxDegree(), [this, &Input, InOffset, &Output, OutOffset, &tmpCtr, CNKLEN, CTRLEN](size_t i)
+		ParallelTools::ParallelFor(m_parallelProfile, Output.data() + OutOffset, 0, m_parallelProfile.ParallelMaxDegree(), [this, Input, InOffset, &Output, OutOffset, &tmpCtr, CNKLEN, CTRLEN](size_t i)
 		{
 			// thread level counter
 			std::array<uint64_t, 2> thdCtr = { 0 };
@@ -670,8 +812,13 @@ void CSX512::Process(const std::vector<uint8_t> &Input, size_t InOffset, std::ve
 			const size_t STMPOS = i * CNKLEN;
 			// create random at offset position
 			this->Generate(m_csx512State, Output, OutOffset + STMPOS, thdCtr, CNKLEN);
+
 			// xor with input at offset
-			MemoryTools::XOR(Input, InOffset + STMPOS, Output, OutOffset + STMPOS, CNKLEN);
+			if (Input != nullptr)
+			{
+				MemoryTools::XorRaw(Input + InOffset + STMPOS, Output.data() + OutOffset + STMPOS, CNKLEN);
+			}
+
 			// store last counter
 			if (i == m_parallelProfile.ParallelMaxDegree() - 1)
 			{
@@ -686,11 +833,11 @@ void CSX512::Process(const std::vector<uint8_t> &Input, size_t InOffset, std::ve
 		if (RNDLEN < PRCLEN)
 		{
 			const size_t FNLLEN = PRCLEN % RNDLEN;
-			Generate(m_csx512State, Output, RNDLEN, m_csx512State->Nonce, FNLLEN);
+			Generate(m_csx512State, Output, OutOffset + RNDLEN, m_csx512State->Nonce, FNLLEN);
 
-			for (size_t i = 0; i < FNLLEN; ++i)
+			if (Input != nullptr)
 			{
-				Output[i + OutOffset + RNDLEN] ^= static_cast<uint8_t>(Input[i + InOffset + RNDLEN]);
+				MemoryTools::XorRaw(Input + InOffset + RNDLEN, Output.data() + OutOffset + RNDLEN, FNLLEN);
 			}
 		}
 	}
@@ -291,6 +291,18 @@ public:
 	/// <exception cref="CryptoCipherModeException">Thrown if the degree parameter is invalid</exception>
 	void ParallelMaxDegree(size_t Degree) override;
 
+	/// <summary>
+	/// Set the key-stream position to a byte offset from the start of the stream.
+	/// <para>The position is measured from the nonce the cipher was initialized with, and the next Transform call starts there.
+	/// The position must be a multiple of the block size; use TransformAt to start within a block.
+	/// Not available in authentication mode.</para>
+	/// </summary>
+	/// 
+	/// <param name="Position">The byte offset from the start of the key-stream</param>
+	///
+	/// <exception cref="CryptoSymmetricException">Thrown if the cipher is not initialized, authentication is enabled, or the position is not block aligned</exception>
+	void Seek(uint64_t Position) override;
+
 	/// <summary>
 	/// Saves the internal state of the cipher to a secure vector.
 	/// <para>The Serialize function can store the internal state of the cipher at the time it is invoked.
@@ -313,6 +325,18 @@ public:
 	/// <exception cref="CryptoSymmetricException">Thrown if the cipher is not initialized</exception>
 	void SetAssociatedData(const std::vector<uint8_t> &Input, size_t Offset, size_t Length) override;
 
+	/// <summary>
+	/// Add additional data in the callers memory to the message authentication code generator.  
+	/// <para>Must be called after Initialize(bool, ISymmetricKey), and can then be called before or after a stream segment has been processed.
+	/// The data is added to the MAC in segments of ParallelBlockSize(), and is not copied in full.</para>
+	/// </summary>
+	/// 
+	/// <param name="Input">A pointer to the bytes to process</param>
+	/// <param name="Length">The number of bytes to process</param>
+	///
+	/// <exception cref="CryptoSymmetricException">Thrown if the cipher is not initialized, or not configured for authentication</exception>
+	void SetAssociatedData(const uint8_t* Input, size_t Length) override;
+
 	/// <summary>
 	/// Encrypt/Decrypt a vector of bytes with offset and length parameters.
 	/// <para>Initialize(bool, ISymmetricKey) must be called before this method can be used.
@@ -329,12 +353,46 @@ public:
 	/// <exception cref="CryptoAuthenticationFailure">Thrown during decryption if the the ciphertext fails authentication</exception>
 	void Transform(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length) override;
 
+	/// <summary>
+	/// Encrypt/Decrypt a length of bytes in the callers memory.
+	/// <para>The pointer form of Transform, for buffers that are not held in a vector, such as pooled, mapped or scatter-gather memory.
+	/// The key-stream is generated in segments of ParallelBlockSize(), including the parallel and precomputed paths of the vector transform, and is xored directly into Output;
+	/// an in-place transform writes each message byte once. Input and Output may be the same address, but must not otherwise overlap.
+	/// In authenticated encryption mode, the MAC code is written after the cipher-text, so Output must have room for Length + TagSize() bytes; 
+	/// in decryption mode, the code following the Length bytes of cipher-text is checked before the stream is decrypted.
+	/// Initialize(bool, ISymmetricKey) must be called before this method can be used.</para>
+	/// </summary>
+	/// 
+	/// <param name="Input">A pointer to the bytes to transform</param>
+	/// <param name="Output">A pointer to the transformed bytes</param>
+	/// <param name="Length">The number of message bytes to transform</param>
+	///
+	/// <exception cref="CryptoAuthenticationFailure">Thrown before decryption if the the ciphertext fails authentication</exception>
+	void Transform(const uint8_t* Input, uint8_t* Output, size_t Length) override;
+
+	/// <summary>
+	/// Encrypt/Decrypt a vector of bytes starting at an absolute key-stream position.
+	/// <para>The counter is set directly from the position, so a window of a large stream can be decrypted without generating the key-stream before it.
+	/// The position can be any byte offset; a leading partial block is taken from the block containing the position.
+	/// Not available in authentication mode.</para>
+	/// </summary>
+	/// 
+	/// <param name="Position">The byte offset of the first input byte within the key-stream</param>
+	/// <param name="Input">The input vector of bytes to transform</param>
+	/// <param name="InOffset">The starting offset within the input vector</param>
+	/// <param name="Output">The output vector of transformed bytes</param>
+	/// <param name="OutOffset">The starting offset within the output vector</param>
+	/// <param name="Length">The number of bytes to process</param>
+	///
+	/// <exception cref="CryptoSymmetricException">Thrown if the cipher is not initialized, or authentication is enabled</exception>
+	void TransformAt(uint64_t Position, const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length) override;
+
 private:
 
 	static void Finalize(std::unique_ptr<CSX512State> &State, std::unique_ptr<IMac> &Authenticator);
 	static void Generate(std::unique_ptr<CSX512State> &State, std::vector<uint8_t> &Output, size_t OutOffset, std::array<uint64_t, 2> &Counter, size_t Length);
 	void Load(const SecureVector<uint8_t> &Key, const SecureVector<uint8_t> &Nonce, const SecureVector<uint8_t> &Code);
-	void Process(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length);
+	void Process(const uint8_t* Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length);
 	void Reset();
 };
 
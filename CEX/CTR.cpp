@@ -1,7 +1,10 @@
 #include "CTR.h"
 #include "BlockCipherFromName.h"
 #include "IntegerTools.h"
+#include "KeystreamCache.h"
+#include "ParallelScratch.h"
 #include "ParallelTools.h"
+#include "SegmentScratch.h"
 
 NAMESPACE_MODE
 
@@ -9,13 +12,19 @@ using Enumeration::BlockCipherConvert;
 using Enumeration::CipherModeConvert;
 using Tools::IntegerTools;
 using Tools::MemoryTools;
+using Tools::ParallelScratch;
 using Tools::ParallelTools;
+using Tools::SegmentScratch;
 
 class CTR::CtrState
 {
 public:
 
 	std::vector<uint8_t> Nonce;
+	std::vector<uint8_t> Origin;
+	ParallelScratch Cached;
+	ParallelScratch Scratch;
+	SegmentScratch Segments;
 	bool Destroyed;
 	bool Encryption;
 	bool Initialized;
@@ -23,6 +32,10 @@ public:
 	CtrState(bool IsDestroyed)
 		:
 		Nonce(BLOCK_SIZE, 0x00),
+		Origin(BLOCK_SIZE, 0x00),
+		Cached(),
+		Scratch(),
+		Segments(),
 		Destroyed(IsDestroyed),
 		Encryption(false),
 		Initialized(false)
@@ -37,6 +50,10 @@ public:
 	void Reset()
 	{
 		MemoryTools::Clear(Nonce, 0, Nonce.size());
+		MemoryTools::Clear(Origin, 0, Origin.size());
+		Cached.Clear();
+		Scratch.Clear();
+		Segments.Clear();
 		Destroyed = false;
 		Encryption = false;
 		Initialized = false;
@@ -51,8 +68,10 @@ CTR::CTR(BlockCiphers CipherType)
 	m_blockCipher(CipherType != BlockCiphers::None ? 
 		Helper::BlockCipherFromName::GetInstance(CipherType) :
 		throw CryptoCipherModeException(CipherModeConvert::ToName(CipherModes::CTR), std::string("Constructor"), std::string("The cipher type can not be none!"), ErrorCodes::InvalidParam)),
-	m_parallelProfile(BLOCK_SIZE, true, m_blockCipher->StateCacheSize(), true)
+	m_parallelProfile(BLOCK_SIZE, true, m_blockCipher->StateCacheSize(), true),
+	m_keystreamCache(nullptr)
 {
+	m_parallelProfile.SetAlgorithm(Name());
 }
 
 CTR::CTR(IBlockCipher* Cipher)
@@ -61,12 +80,20 @@ CTR::CTR(IBlockCipher* Cipher)
 	m_blockCipher(Cipher != nullptr ? 
 		Cipher : 
 		throw CryptoCipherModeException(CipherModeConvert::ToName(CipherModes::CTR), std::string("Constructor"), std::string("The cipher type can not be null!"), ErrorCodes::IllegalOperation)),
-	m_parallelProfile(BLOCK_SIZE, true, m_blockCipher->StateCacheSize(), true)
+	m_parallelProfile(BLOCK_SIZE, true, m_blockCipher->StateCacheSize(), true),
+	m_keystreamCache(nullptr)
 {
+	m_parallelProfile.SetAlgorithm(Name());
 }
 
 CTR::~CTR()
 {
+	// the cache worker reads the cipher, and is stopped first
+	if (m_keystreamCache != nullptr)
+	{
+		m_keystreamCache.reset(nullptr);
+	}
+
 	if (m_ctrState->Destroyed)
 	{
 		if (m_blockCipher != nullptr)
@@ -135,8 +162,14 @@ const std::string CTR::Name()
 }
 
 const std::vector<uint8_t> &CTR::Nonce()
-{ 
-	return m_ctrState->Nonce; 
+{
+	if (m_keystreamCache != nullptr && IsInitialized())
+	{
+		// short transforms advance the cache position instead of the counter
+		IntegerTools::BeIncrease8(m_ctrState->Origin, m_ctrState->Nonce, static_cast<uint64_t>(m_keystreamCache->Position() / BLOCK_SIZE));
+	}
+
+	return m_ctrState->Nonce;
 }
 
 const size_t CTR::ParallelBlockSize()
@@ -165,6 +198,13 @@ void CTR::DecryptBlock(const std::vector<uint8_t> &Input, size_t InOffset, std::
 	Encrypt(Input, InOffset, Output, OutOffset);
 }
 
+void CTR::DecryptBlock(const uint8_t* Input, uint8_t* Output)
+{
+	CEXASSERT(IsInitialized(), "The cipher mode has not been initialized!");
+
+	Encrypt(Input, Output);
+}
+
 void CTR::EncryptBlock(const std::vector<uint8_t> &Input, std::vector<uint8_t> &Output)
 {
 	CEXASSERT(IsInitialized(), "The cipher mode has not been initialized!");
@@ -179,6 +219,13 @@ void CTR::EncryptBlock(const std::vector<uint8_t> &Input, size_t InOffset, std::
 	Encrypt(Input, InOffset, Output, OutOffset);
 }
 
+void CTR::EncryptBlock(const uint8_t* Input, uint8_t* Output)
+{
+	CEXASSERT(IsInitialized(), "The cipher mode has not been initialized!");
+
+	Encrypt(Input, Output);
+}
+
 void CTR::Initialize(bool Encryption, ISymmetricKey &Parameters)
 {
 	if (!SymmetricKeySize::Contains(LegalKeySizes(), Parameters.KeySizes().KeySize()))
@@ -202,10 +249,30 @@ void CTR::Initialize(bool Encryption, ISymmetricKey &Parameters)
 		}
 	}
 
+	if (m_keystreamCache != nullptr)
+	{
+		// the worker must not read the key schedule while it changes
+		m_keystreamCache->Stop();
+	}
+
 	m_blockCipher->Initialize(true, Parameters);
 	MemoryTools::Copy(Parameters.IV(), 0, m_ctrState->Nonce, 0, m_ctrState->Nonce.size());
+	MemoryTools::Copy(Parameters.IV(), 0, m_ctrState->Origin, 0, m_ctrState->Origin.size());
 	m_ctrState->Encryption = Encryption;
 	m_ctrState->Initialized = true;
+
+	if (m_keystreamCache != nullptr)
+	{
+		m_keystreamCache->Start(0);
+	}
+}
+
+void CTR::Invalidate()
+{
+	if (m_keystreamCache != nullptr && IsInitialized())
+	{
+		m_keystreamCache->Start(m_keystreamCache->Position());
+	}
 }
 
 void CTR::ParallelMaxDegree(size_t Degree)
@@ -218,40 +285,141 @@ void CTR::ParallelMaxDegree(size_t Degree)
 	m_parallelProfile.SetMaxDegree(Degree);
 }
 
+void CTR::Precompute(size_t Capacity)
+{
+	if (Capacity % (4 * BLOCK_SIZE) != 0)
+	{
+		throw CryptoCipherModeException(Name(), std::string("Precompute"), std::string("The capacity must be a multiple of four blocks!"), ErrorCodes::InvalidSize);
+	}
+
+	if (m_keystreamCache != nullptr)
+	{
+		if (IsInitialized())
+		{
+			// the counter continues from the last byte taken from the cache
+			IntegerTools::BeIncrease8(m_ctrState->Origin, m_ctrState->Nonce, static_cast<uint64_t>(m_keystreamCache->Position() / BLOCK_SIZE));
+		}
+
+		m_keystreamCache.reset(nullptr);
+	}
+
+	if (Capacity != 0)
+	{
+		// the worker and an underrun on the calling thread each own a counter and buffer, allocated once here
+		m_ctrState->Cached.Reserve(KeystreamCache::LANE_COUNT, BLOCK_SIZE, SCRATCH_SIZE);
+		m_keystreamCache.reset(new KeystreamCache(BLOCK_SIZE, Capacity, [this](uint64_t Position, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length, size_t Lane)
+		{
+			this->Keystream(Position, Output, OutOffset, Length, Lane);
+		}));
+
+		if (IsInitialized())
+		{
+			m_keystreamCache->Start(StreamPosition());
+		}
+	}
+}
+
+void CTR::Seek(uint64_t Position)
+{
+	if (IsInitialized() == false)
+	{
+		throw CryptoCipherModeException(Name(), std::string("Seek"), std::string("The cipher mode has not been initialized!"), ErrorCodes::NotInitialized);
+	}
+	if (Position % BLOCK_SIZE != 0)
+	{
+		throw CryptoCipherModeException(Name(), std::string("Seek"), std::string("The position must be aligned to the block size!"), ErrorCodes::InvalidParam);
+	}
+
+	// the counter is the initial vector increased by the block index
+	IntegerTools::BeIncrease8(m_ctrState->Origin, m_ctrState->Nonce, static_cast<uint64_t>(Position / BLOCK_SIZE));
+
+	if (m_keystreamCache != nullptr)
+	{
+		m_keystreamCache->Reset(Position);
+	}
+}
+
 void CTR::Transform(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length)
 {
 	CEXASSERT(IsInitialized(), "The cipher mode has not been initialized!");
 	CEXASSERT(IntegerTools::Min(Input.size() - InOffset, Output.size() - OutOffset) >= Length, "The data arrays are smaller than the block-size!");
 
-	size_t i;
+	Process(Input.data(), InOffset, Output, OutOffset, Length);
+}
 
-	const size_t PRLBLK = m_parallelProfile.ParallelBlockSize();
+void CTR::Transform(const uint8_t* Input, uint8_t* Output, size_t Length)
+{
+	CEXASSERT(IsInitialized(), "The cipher mode has not been initialized!");
 
-	if (m_parallelProfile.IsParallel() && Length >= PRLBLK)
+	if (m_keystreamCache != nullptr && IsInitialized() && Length <= m_keystreamCache->Capacity())
 	{
-		const size_t BLKCNT = Length / PRLBLK;
-
-		for (i = 0; i < BLKCNT; ++i)
+		// short messages are combined with the precomputed key-stream directly
+		m_keystreamCache->Transform(Input, Output, Length);
+	}
+	else
+	{
+		// the key-stream is generated in segments, and combined with the callers memory in a single pass
+		m_ctrState->Segments.Keystream(Input, Output, Length, m_parallelProfile.ParallelBlockSize(), [this](std::vector<uint8_t> &Target, size_t Count)
 		{
-			ProcessParallel(Input, InOffset + (i * PRLBLK), Output, OutOffset + (i * PRLBLK), PRLBLK);
-		}
+			Process(nullptr, 0, Target, 0, Count);
+		});
+	}
+}
 
-		const size_t RMDLEN = Length - (PRLBLK * BLKCNT);
+void CTR::TransformAt(uint64_t Position, const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length)
+{
+	CEXASSERT(IntegerTools::Min(Input.size() - InOffset, Output.size() - OutOffset) >= Length, "The data arrays are smaller than the length!");
 
-		if (RMDLEN != 0)
+	const size_t HDRLEN = static_cast<size_t>(Position % BLOCK_SIZE);
+	size_t i;
+	size_t prclen;
+
+	Seek(Position - HDRLEN);
+
+	if (HDRLEN != 0 && Length != 0)
+	{
+		// the position is inside a block; use the tail of that blocks key-stream
+		std::vector<uint8_t> otp(BLOCK_SIZE);
+		prclen = IntegerTools::Min(BLOCK_SIZE - HDRLEN, Length);
+		m_blockCipher->EncryptBlock(m_ctrState->Nonce, 0, otp, 0);
+		// continue at the next block; this also moves the precompute cache
+		Seek(Position - HDRLEN + BLOCK_SIZE);
+
+		for (i = 0; i < prclen; ++i)
 		{
-			const size_t BLKOFT = (PRLBLK * BLKCNT);
-			ProcessSequential(Input, InOffset + BLKOFT, Output, OutOffset + BLKOFT, RMDLEN);
+			Output[OutOffset + i] = Input[InOffset + i] ^ otp[HDRLEN + i];
 		}
+
+		MemoryTools::Clear(otp, 0, otp.size());
+		InOffset += prclen;
+		OutOffset += prclen;
+		Length -= prclen;
 	}
-	else
+
+	if (Length != 0)
 	{
-		ProcessSequential(Input, InOffset, Output, OutOffset, Length);
+		Transform(Input, InOffset, Output, OutOffset, Length);
 	}
 }
 
 //~~~Private Functions~~~//
 
+void CTR::Encrypt(const uint8_t* Input, uint8_t* Output)
+{
+	std::array<uint8_t, BLOCK_SIZE> otp;
+
+	m_blockCipher->EncryptBlock(m_ctrState->Nonce.data(), otp.data());
+	IntegerTools::BeIncrement8(m_ctrState->Nonce);
+
+	if (Input != Output)
+	{
+		MemoryTools::CopyRaw(Input, Output, BLOCK_SIZE);
+	}
+
+	MemoryTools::XorRaw(otp.data(), Output, BLOCK_SIZE);
+	MemoryTools::Clear(otp, 0, otp.size());
+}
+
 void CTR::Encrypt(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset)
 {
 	CEXASSERT(IsInitialized(), "The cipher mode has not been initialized!");
@@ -262,109 +430,54 @@ void CTR::Encrypt(const std::vector<uint8_t> &Input, size_t InOffset, std::vecto
 	MemoryTools::XOR128(Input, InOffset, Output, OutOffset);
 }
 
-void CTR::Generate(std::vector<uint8_t> &Output, size_t OutOffset, size_t Length, std::vector<uint8_t> &Counter)
+void CTR::Generate(std::vector<uint8_t> &Output, size_t OutOffset, size_t Length, std::vector<uint8_t> &Counter, std::vector<uint8_t> &Buffer)
 {
 	size_t bctr = 0;
 
-#if defined(CEX_HAS_AVX512)
-	const size_t AVX512BLK = 16 * BLOCK_SIZE;
-	if (Length >= AVX512BLK)
+	const size_t WIDBLK = 16 * BLOCK_SIZE;
+	if (Length >= WIDBLK)
 	{
-		const size_t PBKALN = Length - (Length % AVX512BLK);
-		std::vector<uint8_t> tmpc(AVX512BLK);
+		const size_t PBKALN = Length - (Length % WIDBLK);
 
-		// stagger counters and process 8 blocks with avx512
+		// stagger counters and process 16 blocks; the cipher selects its widest kernel at run-time
 		while (bctr != PBKALN)
 		{
-			MemoryTools::COPY128(Counter, 0, tmpc, 0);
+			MemoryTools::COPY128(Counter, 0, Buffer, 0);
 			IntegerTools::BeIncrement8(Counter);
-			MemoryTools::COPY128(Counter, 0, tmpc, 16);
+			MemoryTools::COPY128(Counter, 0, Buffer, 16);
 			IntegerTools::BeIncrement8(Counter);
-			MemoryTools::COPY128(Counter, 0, tmpc, 32);
+			MemoryTools::COPY128(Counter, 0, Buffer, 32);
 			IntegerTools::BeIncrement8(Counter);
-			MemoryTools::COPY128(Counter, 0, tmpc, 48);
+			MemoryTools::COPY128(Counter, 0, Buffer, 48);
 			IntegerTools::BeIncrement8(Counter);
-			MemoryTools::COPY128(Counter, 0, tmpc, 64);
+			MemoryTools::COPY128(Counter, 0, Buffer, 64);
 			IntegerTools::BeIncrement8(Counter);
-			MemoryTools::COPY128(Counter, 0, tmpc, 80);
+			MemoryTools::COPY128(Counter, 0, Buffer, 80);
 			IntegerTools::BeIncrement8(Counter);
-			MemoryTools::COPY128(Counter, 0, tmpc, 96);
+			MemoryTools::COPY128(Counter, 0, Buffer, 96);
 			IntegerTools::BeIncrement8(Counter);
-			MemoryTools::COPY128(Counter, 0, tmpc, 112);
+			MemoryTools::COPY128(Counter, 0, Buffer, 112);
 			IntegerTools::BeIncrement8(Counter);
-			MemoryTools::COPY128(Counter, 0, tmpc, 128);
+			MemoryTools::COPY128(Counter, 0, Buffer, 128);
 			IntegerTools::BeIncrement8(Counter);
-			MemoryTools::COPY128(Counter, 0, tmpc, 144);
+			MemoryTools::COPY128(Counter, 0, Buffer, 144);
 			IntegerTools::BeIncrement8(Counter);
-			MemoryTools::COPY128(Counter, 0, tmpc, 160);
+			MemoryTools::COPY128(Counter, 0, Buffer, 160);
 			IntegerTools::BeIncrement8(Counter);
-			MemoryTools::COPY128(Counter, 0, tmpc, 176);
+			MemoryTools::COPY128(Counter, 0, Buffer, 176);
 			IntegerTools::BeIncrement8(Counter);
-			MemoryTools::COPY128(Counter, 0, tmpc, 192);
+			MemoryTools::COPY128(Counter, 0, Buffer, 192);
 			IntegerTools::BeIncrement8(Counter);
-			MemoryTools::COPY128(Counter, 0, tmpc, 208);
+			MemoryTools::COPY128(Counter, 0, Buffer, 208);
 			IntegerTools::BeIncrement8(Counter);
-			MemoryTools::COPY128(Counter, 0, tmpc, 224);
+			MemoryTools::COPY128(Counter, 0, Buffer, 224);
 			IntegerTools::BeIncrement8(Counter);
-			MemoryTools::COPY128(Counter, 0, tmpc, 240);
+			MemoryTools::COPY128(Counter, 0, Buffer, 240);
 			IntegerTools::BeIncrement8(Counter);
-			m_blockCipher->Transform2048(tmpc, 0, Output, OutOffset + bctr);
-			bctr += AVX512BLK;
+			m_blockCipher->Transform2048(Buffer, 0, Output, OutOffset + bctr, Length);
+			bctr += WIDBLK;
 		}
 	}
-#elif defined(CEX_HAS_AVX2)
-	const size_t AVX2BLK = 8 * BLOCK_SIZE;
-	if (Length >= AVX2BLK)
-	{
-		const size_t PBKALN = Length - (Length % AVX2BLK);
-		std::vector<uint8_t> tmpc(AVX2BLK);
-		
-		// stagger counters and process 8 blocks with avx2
-		while (bctr != PBKALN)
-		{
-			MemoryTools::COPY128(Counter, 0, tmpc, 0);
-			IntegerTools::BeIncrement8(Counter);
-			MemoryTools::COPY128(Counter, 0, tmpc, 16);
-			IntegerTools::BeIncrement8(Counter);
-			MemoryTools::COPY128(Counter, 0, tmpc, 32);
-			IntegerTools::BeIncrement8(Counter);
-			MemoryTools::COPY128(Counter, 0, tmpc, 48);
-			IntegerTools::BeIncrement8(Counter);
-			MemoryTools::COPY128(Counter, 0, tmpc, 64);
-			IntegerTools::BeIncrement8(Counter);
-			MemoryTools::COPY128(Counter, 0, tmpc, 80);
-			IntegerTools::BeIncrement8(Counter);
-			MemoryTools::COPY128(Counter, 0, tmpc, 96);
-			IntegerTools::BeIncrement8(Counter);
-			MemoryTools::COPY128(Counter, 0, tmpc, 112);
-			IntegerTools::BeIncrement8(Counter);
-			m_blockCipher->Transform1024(tmpc, 0, Output, OutOffset + bctr);
-			bctr += AVX2BLK;
-		}
-	}
-#elif defined(CEX_HAS_AVX)
-	const size_t AVXBLK = 4 * BLOCK_SIZE;
-	if (Length >= AVXBLK)
-	{
-		const size_t PBKALN = Length - (Length % AVXBLK);
-		std::vector<uint8_t> tmpc(AVXBLK);
-
-		// 4 blocks with avx
-		while (bctr != PBKALN)
-		{
-			MemoryTools::COPY128(Counter, 0, tmpc, 0);
-			IntegerTools::BeIncrement8(Counter);
-			MemoryTools::COPY128(Counter, 0, tmpc, 16);
-			IntegerTools::BeIncrement8(Counter);
-			MemoryTools::COPY128(Counter, 0, tmpc, 32);
-			IntegerTools::BeIncrement8(Counter);
-			MemoryTools::COPY128(Counter, 0, tmpc, 48);
-			IntegerTools::BeIncrement8(Counter);
-			m_blockCipher->Transform512(tmpc, 0, Output, OutOffset + bctr);
-			bctr += AVXBLK;
-		}
-	}
-#endif
 
 	const size_t BLKALN = Length - (Length % BLOCK_SIZE);
 	while (bctr != BLKALN)
@@ -376,43 +489,100 @@ void CTR::Generate(std::vector<uint8_t> &Output, size_t OutOffset, size_t Length
 
 	if (bctr != Length)
 	{
-		std::vector<uint8_t> otp(BLOCK_SIZE);
-		m_blockCipher->EncryptBlock(Counter, otp);
+		m_blockCipher->EncryptBlock(Counter, 0, Buffer, 0);
 		IntegerTools::BeIncrement8(Counter);
 		const size_t RMDLEN = Length % BLOCK_SIZE;
-		MemoryTools::Copy(otp, 0, Output, OutOffset + (Length - RMDLEN), RMDLEN);
+		MemoryTools::Copy(Buffer, 0, Output, OutOffset + (Length - RMDLEN), RMDLEN);
 	}
 }
 
-void CTR::ProcessParallel(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length)
+void CTR::Keystream(uint64_t Position, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length, size_t Lane)
+{
+	// the lanes can run concurrently; each uses its own counter and buffer, and the block-cipher is only read
+	std::vector<uint8_t> &ctr = m_ctrState->Cached.Counter(Lane);
+
+	IntegerTools::BeIncrease8(m_ctrState->Origin, ctr, static_cast<uint64_t>(Position / BLOCK_SIZE));
+	Generate(Output, OutOffset, Length, ctr, m_ctrState->Cached.Buffer(Lane));
+}
+
+void CTR::Process(const uint8_t* Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length)
+{
+	// a null input writes the bare key-stream, which the pointer transform combines with the callers memory
+	const bool PRECMP = m_keystreamCache != nullptr && IsInitialized();
+	size_t i;
+
+	if (PRECMP && Length <= m_keystreamCache->Capacity())
+	{
+		// short messages are an xor with the precomputed key-stream
+		m_keystreamCache->Transform((Input != nullptr) ? Input + InOffset : nullptr, Output.data() + OutOffset, Length);
+	}
+	else
+	{
+		if (PRECMP)
+		{
+			// long messages are processed directly, and the cache continues after the last block
+			const uint64_t STMPOS = m_keystreamCache->Position();
+			const uint64_t BLKCNT = static_cast<uint64_t>((Length + BLOCK_SIZE - 1) / BLOCK_SIZE);
+			IntegerTools::BeIncrease8(m_ctrState->Origin, m_ctrState->Nonce, STMPOS / BLOCK_SIZE);
+			m_keystreamCache->Reset(STMPOS + (BLKCNT * BLOCK_SIZE));
+		}
+
+		const size_t PRLBLK = m_parallelProfile.ParallelBlockSize();
+
+		if (m_parallelProfile.IsParallel() && Length >= PRLBLK)
+		{
+			const size_t BLKCNT = Length / PRLBLK;
+
+			for (i = 0; i < BLKCNT; ++i)
+			{
+				ProcessParallel(Input, InOffset + (i * PRLBLK), Output, OutOffset + (i * PRLBLK), PRLBLK);
+			}
+
+			const size_t RMDLEN = Length - (PRLBLK * BLKCNT);
+
+			if (RMDLEN != 0)
+			{
+				const size_t BLKOFT = (PRLBLK * BLKCNT);
+				ProcessSequential(Input, InOffset + BLKOFT, Output, OutOffset + BLKOFT, RMDLEN);
+			}
+		}
+		else
+		{
+			ProcessSequential(Input, InOffset, Output, OutOffset, Length);
+		}
+	}
+}
+
+void CTR::ProcessParallel(const uint8_t* Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length)
 {
 	const size_t OUTLEN = Output.size() - OutOffset < Length ? Output.size() - OutOffset : Length;
-	const size_t CNKLEN = m_parallelProfile.ParallelBlockSize() / m_parallelProfile.ParallelMaxDegree();
-	const size_t ALNLEN = CNKLEN * m_parallelProfile.ParallelMaxDegree();
+	const size_t SEGCNT = m_parallelProfile.ParallelSegmentCount();
+	const size_t CNKLEN = m_parallelProfile.ParallelBlockSize() / SEGCNT;
+	const size_t ALNLEN = CNKLEN * SEGCNT;
 	const size_t CTRLEN = (CNKLEN / BLOCK_SIZE);
-	std::vector<uint8_t> tmpc(m_ctrState->Nonce.size());
 
-	ParallelTools::ParallelFor(0, m_parallelProfile.ParallelMaxDegree(), [this, &Input, InOffset, &Output, OutOffset, &tmpc, CNKLEN, CTRLEN](size_t i)
+	// the per-worker counters are kept by the instance, and are allocated only on first use
+	m_ctrState->Scratch.Reserve(SEGCNT, BLOCK_SIZE, SCRATCH_SIZE);
+
+	ParallelTools::ParallelFor(m_parallelProfile, Output.data() + OutOffset, 0, SEGCNT, [this, Input, InOffset, &Output, OutOffset, CNKLEN, CTRLEN](size_t i)
 	{
 		// thread level counter
-		std::vector<uint8_t> thdc(BLOCK_SIZE);
+		std::vector<uint8_t> &thdc = m_ctrState->Scratch.Counter(i);
 		// offset counter by chunk size / block size  
 		IntegerTools::BeIncrease8(m_ctrState->Nonce, thdc, static_cast<uint32_t>(CTRLEN * i));
 		const size_t STMPOS = i * CNKLEN;
 		// generate random at output offset
-		this->Generate(Output, OutOffset + STMPOS, CNKLEN, thdc);
-		// xor with input at offsets
-		MemoryTools::XOR(Input, InOffset + STMPOS, Output, OutOffset + STMPOS, CNKLEN);
+		this->Generate(Output, OutOffset + STMPOS, CNKLEN, thdc, m_ctrState->Scratch.Buffer(i));
 
-		// store last counter
-		if (i == m_parallelProfile.ParallelMaxDegree() - 1)
+		// xor with input at offsets
+		if (Input != nullptr)
 		{
-			MemoryTools::COPY128(thdc, 0, tmpc, 0);
+			MemoryTools::XorRaw(Input + InOffset + STMPOS, Output.data() + OutOffset + STMPOS, CNKLEN);
 		}
 	});
 
 	// copy last counter to class variable
-	MemoryTools::COPY128(tmpc, 0, m_ctrState->Nonce, 0);
+	MemoryTools::COPY128(m_ctrState->Scratch.Counter(SEGCNT - 1), 0, m_ctrState->Nonce, 0);
 
 	// last block processing
 
@@ -422,37 +592,32 @@ void CTR::ProcessParallel(const std::vector<uint8_t> &Input, size_t InOffset, st
 		InOffset += ALNLEN;
 		OutOffset += ALNLEN;
 
-		Generate(Output, OutOffset, FNLLEN, m_ctrState->Nonce);
+		Generate(Output, OutOffset, FNLLEN, m_ctrState->Nonce, m_ctrState->Scratch.Buffer(0));
 
-		for (size_t i = 0; i < FNLLEN; ++i)
+		if (Input != nullptr)
 		{
-			Output[OutOffset + i] ^= Input[InOffset + i];
+			MemoryTools::XorRaw(Input + InOffset, Output.data() + OutOffset, FNLLEN);
 		}
 	}
 }
 
-void CTR::ProcessSequential(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length)
+void CTR::ProcessSequential(const uint8_t* Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length)
 {
-	// get block aligned
-	const size_t ALNLEN = Length - (Length % BLOCK_SIZE);
-	size_t i;
-
+	m_ctrState->Scratch.Reserve(1, BLOCK_SIZE, SCRATCH_SIZE);
 	// generate random
-	Generate(Output, OutOffset, Length, m_ctrState->Nonce);
+	Generate(Output, OutOffset, Length, m_ctrState->Nonce, m_ctrState->Scratch.Buffer(0));
 
-	if (ALNLEN != 0)
+	// output is input xor random
+	if (Input != nullptr && Length != 0)
 	{
-		MemoryTools::XOR(Input, InOffset, Output, OutOffset, ALNLEN);
+		MemoryTools::XorRaw(Input + InOffset, Output.data() + OutOffset, Length);
 	}
+}
 
-	// get the remaining bytes
-	if (ALNLEN != Length)
-	{
-		for (i = ALNLEN; i < Length; ++i)
-		{
-			Output[i + OutOffset] ^= Input[i + InOffset];
-		}
-	}
+uint64_t CTR::StreamPosition()
+{
+	// the low 64 bits of the counter difference is the block index
+	return (IntegerTools::BeBytesTo64(m_ctrState->Nonce, 8) - IntegerTools::BeBytesTo64(m_ctrState->Origin, 8)) * BLOCK_SIZE;
 }
 
 NAMESPACE_MODEEND
@@ -446,6 +446,12 @@
 #		define CEX_HAS_AVX
 #	endif
 #endif
+// the vaes extension; msvc exposes the intrinsics without a code generation flag
+#if defined(__VAES__)
+#	define CEX_HAS_VAES
+#elif defined(CEX_COMPILER_MSC) && defined(CEX_HAS_AVX2)
+#	define CEX_HAS_VAES
+#endif
 #if defined(CEX_HAS_AVX)
 #	if (!defined(CEX_HAS_SSE4))
 #		define CEX_HAS_SSE4
@@ -482,6 +488,24 @@
 #	endif
 #endif
 
+/// <summary>
+/// The x86 extensions compiled into the baseline build: AES-NI with PCLMULQDQ and SSE4.1, SHA-NI, and RDRAND with RDSEED.
+/// The library is built for SSE hosts, and the AVX macros are only defined inside the instruction set kernel units.
+/// MSVC exposes these intrinsics without a code generation flag, GCC and Clang require the matching -m flags.
+/// Code in this group must test the CpuDetect feature bit before executing the instructions.
+/// </summary>
+#if defined(CEX_ARCH_X86_X64)
+#	if defined(CEX_COMPILER_MSC) || (defined(__AES__) && defined(__PCLMUL__) && defined(__SSE4_1__))
+#		define CEX_HAS_AESNI
+#	endif
+#	if defined(CEX_COMPILER_MSC) || (defined(__SHA__) && defined(__SSE4_1__))
+#		define CEX_HAS_SHANI
+#	endif
+#	if defined(CEX_COMPILER_MSC) || (defined(__RDRND__) && defined(__RDSEED__))
+#		define CEX_HAS_RDRAND
+#	endif
+#endif
+
 /// <summary>
 /// AVX minimum version support
 /// </summary>
@@ -654,7 +678,7 @@
 #define CEX_PREFETCH_BASE 2048
 
 /// <summary>
-/// Pre-loads tables in rhx and thx into L1 for performance and as a timing attack counter measure
+/// Pre-loads the s-box table of the rws software transform into L1 for performance and as a timing attack counter measure
 /// </summary>
 #define CEX_PREFETCH_RIJNDAEL_TABLES
 
@@ -23,155 +23,22 @@
 #include "IntegerTools.h"
 #include "MemoryTools.h"
 
-#if defined(CEX_HAS_AVX512)
-#	include "UInt512.h"
-#	include "ULong512.h"
-#elif defined(CEX_HAS_AVX2)
-#	include "UInt256.h"
-#	include "ULong256.h"
-#elif defined(CEX_HAS_AVX)
-#	include "UInt128.h"
-#	include "ULong512.h"
-#endif
-
 NAMESPACE_STREAM
 
 using Tools::IntegerTools;
 using Tools::MemoryTools;
 
-#if defined(CEX_HAS_AVX512)
-	using Numeric::UInt512;
-	using Numeric::ULong512;
-#elif defined(CEX_HAS_AVX2)
-	using Numeric::UInt256;
-	using Numeric::ULong256;
-#elif defined(CEX_HAS_AVX)
-	using Numeric::UInt128;
-#endif
-
 /// <summary>
 /// Contains the ChaCha permutation functions.
 /// <para>The function names are in the format; Permute-bits-suffix, ex. PermuteP512C, variable rounds, permutes 512 bits, using the compact form of the function. \n
 /// The compact forms of the permutations have the suffix C, and are optimized for performance and low memory consumption 
 /// (enabled in the cipher functions by adding the CEX_CIPHER_COMPACT to the CexConfig file). \n
 /// The Unrolled forms are optimized for speed and timing neutrality (suffix U). \n
-/// The H suffix denotes functions that take an SIMD wrapper class (UIntXXX) to process state in SIMD parallel blocks.</para>
-/// <para>This class contains wide forms of the functions; PermuteP4x512H and PermuteP8x512H, which use the AVX and AVX2 instruction sets. \n
-/// An experimental function using AVX512 instructions is also implemented; PermuteP16x512H. \n
-/// These functions are not visible until run-time on some compiler platforms unless the compiler flag (CEX_HAS_AVX, CEX_HAS_AVX2 or CEX_HAS_AVX512) is explicitly declared.</para>
+/// The wide forms of the permutations, which process 4, 8 or 16 blocks with AVX, AVX2 or AVX512 instructions, are implemented by ChaChaKernels, 
+/// each in a self-contained translation unit built for its instruction set, and are selected at run-time.</para>
 /// </summary>
 class ChaCha
 {
-private:
-
-#if defined(CEX_HAS_AVX512)
-
-	template<typename T>
-	static void Store16xUL512(std::array<T, 16> &State, std::vector<uint8_t> &Output, size_t OutOffset)
-	{
-		std::array<uint32_t, 16> tmp;
-		size_t i;
-
-		for (i = 0; i < 16; ++i)
-		{
-			State[i].Store(tmp, 0);
-			IntegerTools::Le32ToBytes(tmp[0], Output, OutOffset + (i * 4));
-			IntegerTools::Le32ToBytes(tmp[1], Output, OutOffset + (i * 4) + 64);
-			IntegerTools::Le32ToBytes(tmp[2], Output, OutOffset + (i * 4) + 128);
-			IntegerTools::Le32ToBytes(tmp[3], Output, OutOffset + (i * 4) + 192);
-			IntegerTools::Le32ToBytes(tmp[4], Output, OutOffset + (i * 4) + 256);
-			IntegerTools::Le32ToBytes(tmp[5], Output, OutOffset + (i * 4) + 320);
-			IntegerTools::Le32ToBytes(tmp[6], Output, OutOffset + (i * 4) + 384);
-			IntegerTools::Le32ToBytes(tmp[7], Output, OutOffset + (i * 4) + 448);
-			IntegerTools::Le32ToBytes(tmp[8], Output, OutOffset + (i * 4) + 512);
-			IntegerTools::Le32ToBytes(tmp[9], Output, OutOffset + (i * 4) + 576);
-			IntegerTools::Le32ToBytes(tmp[10], Output, OutOffset + (i * 4) + 640);
-			IntegerTools::Le32ToBytes(tmp[11], Output, OutOffset + (i * 4) + 704);
-			IntegerTools::Le32ToBytes(tmp[12], Output, OutOffset + (i * 4) + 768);
-			IntegerTools::Le32ToBytes(tmp[13], Output, OutOffset + (i * 4) + 832);
-			IntegerTools::Le32ToBytes(tmp[14], Output, OutOffset + (i * 4) + 896);
-			IntegerTools::Le32ToBytes(tmp[15], Output, OutOffset + (i * 4) + 960);
-		}
-	}
-
-	template<typename T>
-	static void Store8xULL1024(std::array<T, 16> &State, std::vector<uint8_t> &Output, size_t OutOffset)
-	{
-		std::array<uint64_t, 8> tmp;
-		size_t i;
-
-		for (i = 0; i < 16; ++i)
-		{
-			State[i].Store(tmp, 0);
-			IntegerTools::Le64ToBytes(tmp[0], Output, OutOffset + (i * 8));
-			IntegerTools::Le64ToBytes(tmp[1], Output, OutOffset + (i * 8) + 128);
-			IntegerTools::Le64ToBytes(tmp[2], Output, OutOffset + (i * 8) + 256);
-			IntegerTools::Le64ToBytes(tmp[3], Output, OutOffset + (i * 8) + 384);
-			IntegerTools::Le64ToBytes(tmp[4], Output, OutOffset + (i * 8) + 512);
-			IntegerTools::Le64ToBytes(tmp[5], Output, OutOffset + (i * 8) + 640);
-			IntegerTools::Le64ToBytes(tmp[6], Output, OutOffset + (i * 8) + 768);
-			IntegerTools::Le64ToBytes(tmp[7], Output, OutOffset + (i * 8) + 896);
-		}
-	}
-
-#elif defined(CEX_HAS_AVX2)
-
-	template<typename T>
-	static void Store8xUL512(std::array<T, 16> &State, std::vector<uint8_t> &Output, size_t OutOffset)
-	{
-		std::array<uint32_t, 8> tmp;
-		size_t i;
-
-		for (i = 0; i < 16; ++i)
-		{
-			State[i].Store(tmp, 0);
-			IntegerTools::Le32ToBytes(tmp[0], Output, OutOffset + (i * 4));
-			IntegerTools::Le32ToBytes(tmp[1], Output, OutOffset + (i * 4) + 64);
-			IntegerTools::Le32ToBytes(tmp[2], Output, OutOffset + (i * 4) + 128);
-			IntegerTools::Le32ToBytes(tmp[3], Output, OutOffset + (i * 4) + 192);
-			IntegerTools::Le32ToBytes(tmp[4], Output, OutOffset + (i * 4) + 256);
-			IntegerTools::Le32ToBytes(tmp[5], Output, OutOffset + (i * 4) + 320);
-			IntegerTools::Le32ToBytes(tmp[6], Output, OutOffset + (i * 4) + 384);
-			IntegerTools::Le32ToBytes(tmp[7], Output, OutOffset + (i * 4) + 448);
-		}
-	}
-
-	template<typename T>
-	static void Store4xULL1024(std::array<T, 16> &State, std::vector<uint8_t> &Output, size_t OutOffset)
-	{
-		std::array<uint64_t, 4> tmp;
-		size_t i;
-
-		for (i = 0; i < 16; ++i)
-		{
-			State[i].Store(tmp, 0);
-			IntegerTools::Le64ToBytes(tmp[0], Output, OutOffset + (i * 8));
-			IntegerTools::Le64ToBytes(tmp[1], Output, OutOffset + (i * 8) + 128);
-			IntegerTools::Le64ToBytes(tmp[2], Output, OutOffset + (i * 8) + 256);
-			IntegerTools::Le64ToBytes(tmp[3], Output, OutOffset + (i * 8) + 384);
-		}
-	}
-
-#elif defined(CEX_HAS_AVX)
-
-	template<typename T>
-	static void Store4xUL512(std::array<T, 16> &State, std::vector<uint8_t> &Output, size_t OutOffset)
-	{
-		std::array<uint32_t, 4> tmp;
-		size_t i;
-
-		for (i = 0; i < 16; ++i)
-		{
-			State[i].Store(tmp, 0);
-			IntegerTools::Le32ToBytes(tmp[0], Output, OutOffset + (i * 4));
-			IntegerTools::Le32ToBytes(tmp[1], Output, OutOffset + (i * 4) + 64);
-			IntegerTools::Le32ToBytes(tmp[2], Output, OutOffset + (i * 4) + 128);
-			IntegerTools::Le32ToBytes(tmp[3], Output, OutOffset + (i * 4) + 192);
-		}
-	}
-
-#endif
-
 public:
 
 	/// <summary>
@@ -1097,575 +964,6 @@ public:
 		IntegerTools::Le64ToBytes(X[14] + State[12], Output, OutOffset + 112);
 		IntegerTools::Le64ToBytes(X[15] + State[13], Output, OutOffset + 120);
 	}
-
-#if defined(CEX_HAS_AVX512)
-
-	/// <summary>
-	/// The horizontally vectorized form of the ChaCha permutation function.
-	/// <para>This function processes 16*64 blocks of input in parallel using AVX512 instructions.</para>
-	/// </summary>
-	/// 
-	/// <param name="Output">The output message array</param>
-	/// <param name="OutOffset">The starting offset within the Output array</param>
-	/// <param name="Counter">The cipher counter array</param>
-	/// <param name="State">The permutations state array</param>
-	/// <param name="Rounds">The number of mixing rounds; the default is 20</param>
-	template<typename ArrayU8, typename Array32xU32, typename Array14xU32>
-	static void PermuteP16x512H(ArrayU8 &Output, size_t OutOffset, Array32xU32 &Counter, Array14xU32 &State, size_t Rounds)
-	{
-		std::array<UInt512, 16> X{ UInt512(State[0]), UInt512(State[1]), UInt512(State[2]), UInt512(State[3]),
-			UInt512(State[4]), UInt512(State[5]), UInt512(State[6]), UInt512(State[7]),
-			UInt512(State[8]), UInt512(State[9]), UInt512(State[10]), UInt512(State[11]),
-			UInt512(Counter, 0), UInt512(Counter, 16), UInt512(State[12]), UInt512(State[13]) };
-
-		while (Rounds != 0)
-		{
-			X[0] += X[4];
-			X[12] = UInt512::RotL32(X[12] ^ X[0], 16);
-			X[8] += X[12];
-			X[4] = UInt512::RotL32(X[4] ^ X[8], 12);
-			X[0] += X[4];
-			X[12] = UInt512::RotL32(X[12] ^ X[0], 8);
-			X[8] += X[12];
-			X[4] = UInt512::RotL32(X[4] ^ X[8], 7);
-			X[1] += X[5];
-			X[13] = UInt512::RotL32(X[13] ^ X[1], 16);
-			X[9] += X[13];
-			X[5] = UInt512::RotL32(X[5] ^ X[9], 12);
-			X[1] += X[5];
-			X[13] = UInt512::RotL32(X[13] ^ X[1], 8);
-			X[9] += X[13];
-			X[5] = UInt512::RotL32(X[5] ^ X[9], 7);
-			X[2] += X[6];
-			X[14] = UInt512::RotL32(X[14] ^ X[2], 16);
-			X[10] += X[14];
-			X[6] = UInt512::RotL32(X[6] ^ X[10], 12);
-			X[2] += X[6];
-			X[14] = UInt512::RotL32(X[14] ^ X[2], 8);
-			X[10] += X[14];
-			X[6] = UInt512::RotL32(X[6] ^ X[10], 7);
-			X[3] += X[7];
-			X[15] = UInt512::RotL32(X[15] ^ X[3], 16);
-			X[11] += X[15];
-			X[7] = UInt512::RotL32(X[7] ^ X[11], 12);
-			X[3] += X[7];
-			X[15] = UInt512::RotL32(X[15] ^ X[3], 8);
-			X[11] += X[15];
-			X[7] = UInt512::RotL32(X[7] ^ X[11], 7);
-			X[0] += X[5];
-			X[15] = UInt512::RotL32(X[15] ^ X[0], 16);
-			X[10] += X[15];
-			X[5] = UInt512::RotL32(X[5] ^ X[10], 12);
-			X[0] += X[5];
-			X[15] = UInt512::RotL32(X[15] ^ X[0], 8);
-			X[10] += X[15];
-			X[5] = UInt512::RotL32(X[5] ^ X[10], 7);
-			X[1] += X[6];
-			X[12] = UInt512::RotL32(X[12] ^ X[1], 16);
-			X[11] += X[12];
-			X[6] = UInt512::RotL32(X[6] ^ X[11], 12);
-			X[1] += X[6];
-			X[12] = UInt512::RotL32(X[12] ^ X[1], 8);
-			X[11] += X[12];
-			X[6] = UInt512::RotL32(X[6] ^ X[11], 7);
-			X[2] += X[7];
-			X[13] = UInt512::RotL32(X[13] ^ X[2], 16);
-			X[8] += X[13];
-			X[7] = UInt512::RotL32(X[7] ^ X[8], 12);
-			X[2] += X[7];
-			X[13] = UInt512::RotL32(X[13] ^ X[2], 8);
-			X[8] += X[13];
-			X[7] = UInt512::RotL32(X[7] ^ X[8], 7);
-			X[3] += X[4];
-			X[14] = UInt512::RotL32(X[14] ^ X[3], 16);
-			X[9] += X[14];
-			X[4] = UInt512::RotL32(X[4] ^ X[9], 12);
-			X[3] += X[4];
-			X[14] = UInt512::RotL32(X[14] ^ X[3], 8);
-			X[9] += X[14];
-			X[4] = UInt512::RotL32(X[4] ^ X[9], 7);
-			Rounds -= 2;
-		}
-
-		// last round
-		X[0] += UInt512(State[0]);
-		X[1] += UInt512(State[1]);
-		X[2] += UInt512(State[2]);
-		X[3] += UInt512(State[3]);
-		X[4] += UInt512(State[4]);
-		X[5] += UInt512(State[5]);
-		X[6] += UInt512(State[6]);
-		X[7] += UInt512(State[7]);
-		X[8] += UInt512(State[8]);
-		X[9] += UInt512(State[9]);
-		X[10] += UInt512(State[10]);
-		X[11] += UInt512(State[11]);
-		X[12] += UInt512(Counter, 0);
-		X[13] += UInt512(Counter, 16);
-		X[14] += UInt512(State[12]);
-		X[15] += UInt512(State[13]);
-
-		Store16xUL512(X, Output, OutOffset);
-	}
-
-	/// <summary>
-	/// The horizontally vectorized form of the CSX-512 (based on ChaCha) permutation function.
-	/// <para>This function processes 4*128 blocks of input in parallel using AVX2 instructions.</para>
-	/// </summary>
-	/// 
-	/// <param name="Output">The output message array</param>
-	/// <param name="OutOffset">The starting offset within the Output array</param>
-	/// <param name="Counter">The cipher counter array</param>
-	/// <param name="State">The permutations state array</param>
-	/// <param name="Rounds">The number of mixing rounds; the default is 20</param>
-	template<typename ArrayU8, typename Array16xU64, typename Array14xU64>
-	static void PermuteP8x1024H(ArrayU8 &Output, size_t OutOffset, Array16xU64 &Counter, Array14xU64 &State, size_t Rounds)
-	{
-		std::array<ULong512, 16> X{ ULong512(State[0]), ULong512(State[1]), ULong512(State[2]), ULong512(State[3]),
-			ULong512(State[4]), ULong512(State[5]), ULong512(State[6]), ULong512(State[7]), 
-			ULong512(State[8]), ULong512(State[9]), ULong512(State[10]), ULong512(State[11]), 
-			ULong512(Counter, 0), ULong512(Counter, 8), ULong512(State[12]), ULong512(State[13]) };
-
-		// new rotational constants = 
-		// 38,19,10,55 
-		// 33,4,51,13 
-		// 16,34,56,51 
-		// 4,53,42,41 
-		// 34,41,59,17 
-		// 23,31,37,20 
-		// 31,44,47,46 
-		// 12,47,44,30 
-
-		while (Rounds != 0)
-		{
-			// round n
-			X[0] += X[4];
-			X[12] = ULong512::RotL64(X[12] ^ X[0], 38);
-			X[8] += X[12];
-			X[4] = ULong512::RotL64(X[4] ^ X[8], 19);
-			X[0] += X[4];
-			X[12] = ULong512::RotL64(X[12] ^ X[0], 10);
-			X[8] += X[12];
-			X[4] = ULong512::RotL64(X[4] ^ X[8], 55);
-			X[1] += X[5];
-			X[13] = ULong512::RotL64(X[13] ^ X[1], 33);
-			X[9] += X[13];
-			X[5] = ULong512::RotL64(X[5] ^ X[9], 4);
-			X[1] += X[5];
-			X[13] = ULong512::RotL64(X[13] ^ X[1], 51);
-			X[9] += X[13];
-			X[5] = ULong512::RotL64(X[5] ^ X[9], 13);
-			X[2] += X[6];
-			X[14] = ULong512::RotL64(X[14] ^ X[2], 16);
-			X[10] += X[14];
-			X[6] = ULong512::RotL64(X[6] ^ X[10], 34);
-			X[2] += X[6];
-			X[14] = ULong512::RotL64(X[14] ^ X[2], 56);
-			X[10] += X[14];
-			X[6] = ULong512::RotL64(X[6] ^ X[10], 51);
-			X[3] += X[7];
-			X[15] = ULong512::RotL64(X[15] ^ X[3], 4);
-			X[11] += X[15];
-			X[7] = ULong512::RotL64(X[7] ^ X[11], 53);
-			X[3] += X[7];
-			X[15] = ULong512::RotL64(X[15] ^ X[3], 42);
-			X[11] += X[15];
-			X[7] = ULong512::RotL64(X[7] ^ X[11], 41);
-			X[0] += X[5];
-			// round n+1
-			X[15] = ULong512::RotL64(X[15] ^ X[0], 34);
-			X[10] += X[15];
-			X[5] = ULong512::RotL64(X[5] ^ X[10], 41);
-			X[0] += X[5];
-			X[15] = ULong512::RotL64(X[15] ^ X[0], 59);
-			X[10] += X[15];
-			X[5] = ULong512::RotL64(X[5] ^ X[10], 17);
-			X[1] += X[6];
-			X[12] = ULong512::RotL64(X[12] ^ X[1], 23);
-			X[11] += X[12];
-			X[6] = ULong512::RotL64(X[6] ^ X[11], 31);
-			X[1] += X[6];
-			X[12] = ULong512::RotL64(X[12] ^ X[1], 37);
-			X[11] += X[12];
-			X[6] = ULong512::RotL64(X[6] ^ X[11], 20);
-			X[2] += X[7];
-			X[13] = ULong512::RotL64(X[13] ^ X[2], 31);
-			X[8] += X[13];
-			X[7] = ULong512::RotL64(X[7] ^ X[8], 44);
-			X[2] += X[7];
-			X[13] = ULong512::RotL64(X[13] ^ X[2], 47);
-			X[8] += X[13];
-			X[7] = ULong512::RotL64(X[7] ^ X[8], 46);
-			X[3] += X[4];
-			X[14] = ULong512::RotL64(X[14] ^ X[3], 12);
-			X[9] += X[14];
-			X[4] = ULong512::RotL64(X[4] ^ X[9], 47);
-			X[3] += X[4];
-			X[14] = ULong512::RotL64(X[14] ^ X[3], 44);
-			X[9] += X[14];
-			X[4] = ULong512::RotL64(X[4] ^ X[9], 30);
-			Rounds -= 2;
-		}
-
-		X[0] += ULong512(State[0]);
-		X[1] += ULong512(State[1]);
-		X[2] += ULong512(State[2]);
-		X[3] += ULong512(State[3]);
-		X[4] += ULong512(State[4]);
-		X[5] += ULong512(State[5]);
-		X[6] += ULong512(State[6]);
-		X[7] += ULong512(State[7]);
-		X[8] += ULong512(State[8]);
-		X[9] += ULong512(State[9]);
-		X[10] += ULong512(State[10]);
-		X[11] += ULong512(State[11]);
-		X[12] += ULong512(Counter, 0);
-		X[13] += ULong512(Counter, 8);
-		X[14] += ULong512(State[12]);
-		X[15] += ULong512(State[13]);
-
-		Store8xULL1024(X, Output, OutOffset);
-	}
-
-#elif defined(CEX_HAS_AVX2)
-
-	/// <summary>
-	/// The horizontally vectorized form of the ChaCha permutation function.
-	/// <para>This function processes 8*64 blocks of input in parallel using AVX2 instructions.</para>
-	/// </summary>
-	/// 
-	/// <param name="Output">The output message array</param>
-	/// <param name="OutOffset">The starting offset within the Output array</param>
-	/// <param name="Counter">The cipher counter array</param>
-	/// <param name="State">The permutations state array</param>
-	/// <param name="Rounds">The number of mixing rounds; the default is 20</param>
-	template<typename ArrayU8, typename Array16xU32, typename Array14xU32>
-	static void PermuteP8x512H(ArrayU8 &Output, size_t OutOffset, Array16xU32 &Counter, Array14xU32 &State, size_t Rounds)
-	{
-		std::array<UInt256, 16> X{ UInt256(State[0]), UInt256(State[1]), UInt256(State[2]), UInt256(State[3]),
-			UInt256(State[4]), UInt256(State[5]), UInt256(State[6]), UInt256(State[7]),
-			UInt256(State[8]), UInt256(State[9]), UInt256(State[10]), UInt256(State[11]),
-			UInt256(Counter, 0), UInt256(Counter, 8), UInt256(State[12]), UInt256(State[13]) };
-
-		while (Rounds != 0)
-		{
-			X[0] += X[4];
-			X[12] = UInt256::RotL32(X[12] ^ X[0], 16);
-			X[8] += X[12];
-			X[4] = UInt256::RotL32(X[4] ^ X[8], 12);
-			X[0] += X[4];
-			X[12] = UInt256::RotL32(X[12] ^ X[0], 8);
-			X[8] += X[12];
-			X[4] = UInt256::RotL32(X[4] ^ X[8], 7);
-			X[1] += X[5];
-			X[13] = UInt256::RotL32(X[13] ^ X[1], 16);
-			X[9] += X[13];
-			X[5] = UInt256::RotL32(X[5] ^ X[9], 12);
-			X[1] += X[5];
-			X[13] = UInt256::RotL32(X[13] ^ X[1], 8);
-			X[9] += X[13];
-			X[5] = UInt256::RotL32(X[5] ^ X[9], 7);
-			X[2] += X[6];
-			X[14] = UInt256::RotL32(X[14] ^ X[2], 16);
-			X[10] += X[14];
-			X[6] = UInt256::RotL32(X[6] ^ X[10], 12);
-			X[2] += X[6];
-			X[14] = UInt256::RotL32(X[14] ^ X[2], 8);
-			X[10] += X[14];
-			X[6] = UInt256::RotL32(X[6] ^ X[10], 7);
-			X[3] += X[7];
-			X[15] = UInt256::RotL32(X[15] ^ X[3], 16);
-			X[11] += X[15];
-			X[7] = UInt256::RotL32(X[7] ^ X[11], 12);
-			X[3] += X[7];
-			X[15] = UInt256::RotL32(X[15] ^ X[3], 8);
-			X[11] += X[15];
-			X[7] = UInt256::RotL32(X[7] ^ X[11], 7);
-			X[0] += X[5];
-			X[15] = UInt256::RotL32(X[15] ^ X[0], 16);
-			X[10] += X[15];
-			X[5] = UInt256::RotL32(X[5] ^ X[10], 12);
-			X[0] += X[5];
-			X[15] = UInt256::RotL32(X[15] ^ X[0], 8);
-			X[10] += X[15];
-			X[5] = UInt256::RotL32(X[5] ^ X[10], 7);
-			X[1] += X[6];
-			X[12] = UInt256::RotL32(X[12] ^ X[1], 16);
-			X[11] += X[12];
-			X[6] = UInt256::RotL32(X[6] ^ X[11], 12);
-			X[1] += X[6];
-			X[12] = UInt256::RotL32(X[12] ^ X[1], 8);
-			X[11] += X[12];
-			X[6] = UInt256::RotL32(X[6] ^ X[11], 7);
-			X[2] += X[7];
-			X[13] = UInt256::RotL32(X[13] ^ X[2], 16);
-			X[8] += X[13];
-			X[7] = UInt256::RotL32(X[7] ^ X[8], 12);
-			X[2] += X[7];
-			X[13] = UInt256::RotL32(X[13] ^ X[2], 8);
-			X[8] += X[13];
-			X[7] = UInt256::RotL32(X[7] ^ X[8], 7);
-			X[3] += X[4];
-			X[14] = UInt256::RotL32(X[14] ^ X[3], 16);
-			X[9] += X[14];
-			X[4] = UInt256::RotL32(X[4] ^ X[9], 12);
-			X[3] += X[4];
-			X[14] = UInt256::RotL32(X[14] ^ X[3], 8);
-			X[9] += X[14];
-			X[4] = UInt256::RotL32(X[4] ^ X[9], 7);
-			Rounds -= 2;
-		}
-
-		X[0] += UInt256(State[0]);
-		X[1] += UInt256(State[1]);
-		X[2] += UInt256(State[2]);
-		X[3] += UInt256(State[3]);
-		X[4] += UInt256(State[4]);
-		X[5] += UInt256(State[5]);
-		X[6] += UInt256(State[6]);
-		X[7] += UInt256(State[7]);
-		X[8] += UInt256(State[8]);
-		X[9] += UInt256(State[9]);
-		X[10] += UInt256(State[10]);
-		X[11] += UInt256(State[11]);
-		X[12] += UInt256(Counter, 0);
-		X[13] += UInt256(Counter, 8);
-		X[14] += UInt256(State[12]);
-		X[15] += UInt256(State[13]);
-
-		Store8xUL512(X, Output, OutOffset);
-	}
-
-	/// <summary>
-	/// The horizontally vectorized form of the CSX-512 (based on ChaCha) permutation function.
-	/// <para>This function processes 4*128 blocks of input in parallel using AVX2 instructions.</para>
-	/// </summary>
-	/// 
-	/// <param name="Output">The output message array</param>
-	/// <param name="OutOffset">The starting offset within the Output array</param>
-	/// <param name="Counter">The cipher counter array</param>
-	/// <param name="State">The permutations state array</param>
-	/// <param name="Rounds">The number of mixing rounds; the default is 20</param>
-	template<typename ArrayU8, typename Array8xU64, typename Array14xU64>
-	static void PermuteP4x1024H(ArrayU8 &Output, size_t OutOffset, Array8xU64 &Counter, Array14xU64 &State, size_t Rounds)
-	{
-		std::array<ULong256, 16> X{ ULong256(State[0]), ULong256(State[1]), ULong256(State[2]), ULong256(State[3]),
-			ULong256(State[4]), ULong256(State[5]), ULong256(State[6]), ULong256(State[7]), 
-			ULong256(State[8]), ULong256(State[9]), ULong256(State[10]), ULong256(State[11]), 
-			ULong256(Counter, 0), ULong256(Counter, 4), ULong256(State[12]), ULong256(State[13]) };
-
-		// new rotational constants = 
-		// 38,19,10,55 
-		// 33,4,51,13 
-		// 16,34,56,51 
-		// 4,53,42,41 
-		// 34,41,59,17 
-		// 23,31,37,20 
-		// 31,44,47,46 
-		// 12,47,44,30 
-
-		while (Rounds != 0)
-		{
-			// round n
-			X[0] += X[4];
-			X[12] = ULong256::RotL64(X[12] ^ X[0], 38);
-			X[8] += X[12];
-			X[4] = ULong256::RotL64(X[4] ^ X[8], 19);
-			X[0] += X[4];
-			X[12] = ULong256::RotL64(X[12] ^ X[0], 10);
-			X[8] += X[12];
-			X[4] = ULong256::RotL64(X[4] ^ X[8], 55);
-			X[1] += X[5];
-			X[13] = ULong256::RotL64(X[13] ^ X[1], 33);
-			X[9] += X[13];
-			X[5] = ULong256::RotL64(X[5] ^ X[9], 4);
-			X[1] += X[5];
-			X[13] = ULong256::RotL64(X[13] ^ X[1], 51);
-			X[9] += X[13];
-			X[5] = ULong256::RotL64(X[5] ^ X[9], 13);
-			X[2] += X[6];
-			X[14] = ULong256::RotL64(X[14] ^ X[2], 16);
-			X[10] += X[14];
-			X[6] = ULong256::RotL64(X[6] ^ X[10], 34);
-			X[2] += X[6];
-			X[14] = ULong256::RotL64(X[14] ^ X[2], 56);
-			X[10] += X[14];
-			X[6] = ULong256::RotL64(X[6] ^ X[10], 51);
-			X[3] += X[7];
-			X[15] = ULong256::RotL64(X[15] ^ X[3], 4);
-			X[11] += X[15];
-			X[7] = ULong256::RotL64(X[7] ^ X[11], 53);
-			X[3] += X[7];
-			X[15] = ULong256::RotL64(X[15] ^ X[3], 42);
-			X[11] += X[15];
-			X[7] = ULong256::RotL64(X[7] ^ X[11], 41);
-			// round n+1
-			X[0] += X[5];
-			X[15] = ULong256::RotL64(X[15] ^ X[0], 34);
-			X[10] += X[15];
-			X[5] = ULong256::RotL64(X[5] ^ X[10], 41);
-			X[0] += X[5];
-			X[15] = ULong256::RotL64(X[15] ^ X[0], 59);
-			X[10] += X[15];
-			X[5] = ULong256::RotL64(X[5] ^ X[10], 17);
-			X[1] += X[6];
-			X[12] = ULong256::RotL64(X[12] ^ X[1], 23);
-			X[11] += X[12];
-			X[6] = ULong256::RotL64(X[6] ^ X[11], 31);
-			X[1] += X[6];
-			X[12] = ULong256::RotL64(X[12] ^ X[1], 37);
-			X[11] += X[12];
-			X[6] = ULong256::RotL64(X[6] ^ X[11], 20);
-			X[2] += X[7];
-			X[13] = ULong256::RotL64(X[13] ^ X[2], 31);
-			X[8] += X[13];
-			X[7] = ULong256::RotL64(X[7] ^ X[8], 44);
-			X[2] += X[7];
-			X[13] = ULong256::RotL64(X[13] ^ X[2], 47);
-			X[8] += X[13];
-			X[7] = ULong256::RotL64(X[7] ^ X[8], 46);
-			X[3] += X[4];
-			X[14] = ULong256::RotL64(X[14] ^ X[3], 12);
-			X[9] += X[14];
-			X[4] = ULong256::RotL64(X[4] ^ X[9], 47);
-			X[3] += X[4];
-			X[14] = ULong256::RotL64(X[14] ^ X[3], 44);
-			X[9] += X[14];
-			X[4] = ULong256::RotL64(X[4] ^ X[9], 30);
-			Rounds -= 2;
-		}
-
-		X[0] += ULong256(State[0]);
-		X[1] += ULong256(State[1]);
-		X[2] += ULong256(State[2]);
-		X[3] += ULong256(State[3]);
-		X[4] += ULong256(State[4]);
-		X[5] += ULong256(State[5]);
-		X[6] += ULong256(State[6]);
-		X[7] += ULong256(State[7]);
-		X[8] += ULong256(State[8]);
-		X[9] += ULong256(State[9]);
-		X[10] += ULong256(State[10]);
-		X[11] += ULong256(State[11]);
-		X[12] += ULong256(Counter, 0);
-		X[13] += ULong256(Counter, 4);
-		X[14] += ULong256(State[12]);
-		X[15] += ULong256(State[13]);
-
-		Store4xULL1024(X, Output, OutOffset);
-	}
-
-#elif defined(CEX_HAS_AVX)
-
-	/// <summary>
-	/// The horizontally vectorized form of the ChaCha permutation function.
-	/// <para>This function processes 4*64 blocks of input in parallel using AVX instructions.</para>
-	/// </summary>
-	/// 
-	/// <param name="Output">The output message array</param>
-	/// <param name="OutOffset">The starting offset within the Output array</param>
-	/// <param name="Counter">The cipher counter array</param>
-	/// <param name="State">The permutations state array</param>
-	/// <param name="Rounds">The number of mixing rounds; the default is 20</param>
-	template<typename ArrayU8, typename Array8xU32, typename Array14xU32>
-	static void PermuteP4x512H(ArrayU8 &Output, size_t OutOffset, Array8xU32 &Counter, Array14xU32 &State, size_t Rounds)
-	{
-		std::array<UInt128, 16> X{ UInt128(State[0]), UInt128(State[1]), UInt128(State[2]), UInt128(State[3]),
-			UInt128(State[4]), UInt128(State[5]), UInt128(State[6]), UInt128(State[7]),
-			UInt128(State[8]), UInt128(State[9]), UInt128(State[10]), UInt128(State[11]),
-			UInt128(Counter, 0), UInt128(Counter, 4), UInt128(State[12]), UInt128(State[13]) };
-
-		while (Rounds != 0)
-		{
-			X[0] += X[4];
-			X[12] = UInt128::RotL32(X[12] ^ X[0], 16);
-			X[8] += X[12];
-			X[4] = UInt128::RotL32(X[4] ^ X[8], 12);
-			X[0] += X[4];
-			X[12] = UInt128::RotL32(X[12] ^ X[0], 8);
-			X[8] += X[12];
-			X[4] = UInt128::RotL32(X[4] ^ X[8], 7);
-			X[1] += X[5];
-			X[13] = UInt128::RotL32(X[13] ^ X[1], 16);
-			X[9] += X[13];
-			X[5] = UInt128::RotL32(X[5] ^ X[9], 12);
-			X[1] += X[5];
-			X[13] = UInt128::RotL32(X[13] ^ X[1], 8);
-			X[9] += X[13];
-			X[5] = UInt128::RotL32(X[5] ^ X[9], 7);
-			X[2] += X[6];
-			X[14] = UInt128::RotL32(X[14] ^ X[2], 16);
-			X[10] += X[14];
-			X[6] = UInt128::RotL32(X[6] ^ X[10], 12);
-			X[2] += X[6];
-			X[14] = UInt128::RotL32(X[14] ^ X[2], 8);
-			X[10] += X[14];
-			X[6] = UInt128::RotL32(X[6] ^ X[10], 7);
-			X[3] += X[7];
-			X[15] = UInt128::RotL32(X[15] ^ X[3], 16);
-			X[11] += X[15];
-			X[7] = UInt128::RotL32(X[7] ^ X[11], 12);
-			X[3] += X[7];
-			X[15] = UInt128::RotL32(X[15] ^ X[3], 8);
-			X[11] += X[15];
-			X[7] = UInt128::RotL32(X[7] ^ X[11], 7);
-			X[0] += X[5];
-			X[15] = UInt128::RotL32(X[15] ^ X[0], 16);
-			X[10] += X[15];
-			X[5] = UInt128::RotL32(X[5] ^ X[10], 12);
-			X[0] += X[5];
-			X[15] = UInt128::RotL32(X[15] ^ X[0], 8);
-			X[10] += X[15];
-			X[5] = UInt128::RotL32(X[5] ^ X[10], 7);
-			X[1] += X[6];
-			X[12] = UInt128::RotL32(X[12] ^ X[1], 16);
-			X[11] += X[12];
-			X[6] = UInt128::RotL32(X[6] ^ X[11], 12);
-			X[1] += X[6];
-			X[12] = UInt128::RotL32(X[12] ^ X[1], 8);
-			X[11] += X[12];
-			X[6] = UInt128::RotL32(X[6] ^ X[11], 7);
-			X[2] += X[7];
-			X[13] = UInt128::RotL32(X[13] ^ X[2], 16);
-			X[8] += X[13];
-			X[7] = UInt128::RotL32(X[7] ^ X[8], 12);
-			X[2] += X[7];
-			X[13] = UInt128::RotL32(X[13] ^ X[2], 8);
-			X[8] += X[13];
-			X[7] = UInt128::RotL32(X[7] ^ X[8], 7);
-			X[3] += X[4];
-			X[14] = UInt128::RotL32(X[14] ^ X[3], 16);
-			X[9] += X[14];
-			X[4] = UInt128::RotL32(X[4] ^ X[9], 12);
-			X[3] += X[4];
-			X[14] = UInt128::RotL32(X[14] ^ X[3], 8);
-			X[9] += X[14];
-			X[4] = UInt128::RotL32(X[4] ^ X[9], 7);
-			Rounds -= 2;
-		}
-
-		X[0] += UInt128(State[0]);
-		X[1] += UInt128(State[1]);
-		X[2] += UInt128(State[2]);
-		X[3] += UInt128(State[3]);
-		X[4] += UInt128(State[4]);
-		X[5] += UInt128(State[5]);
-		X[6] += UInt128(State[6]);
-		X[7] += UInt128(State[7]);
-		X[8] += UInt128(State[8]);
-		X[9] += UInt128(State[9]);
-		X[10] += UInt128(State[10]);
-		X[11] += UInt128(State[11]);
-		X[12] += UInt128(Counter, 0);
-		X[13] += UInt128(Counter, 4);
-		X[14] += UInt128(State[12]);
-		X[15] += UInt128(State[13]);
-
-		Store4xUL512(X, Output, OutOffset);
-	}
-
-#endif
-
 };
 
 NAMESPACE_STREAMEND
@@ -0,0 +1,165 @@
+#include "ChaChaKernels.h"
+#if defined(CEX_HAS_AVX)
+#	include "UInt128.h"
+#	include <cstring>
+#else
+#	include "CryptoSymmetricException.h"
+#endif
+
+NAMESPACE_STREAM
+
+// this unit is compiled with the AVX code generation flag; it includes no shared header with instruction set branches,
+// and the permutations and the SIMD wrappers they use have internal linkage, so no inline code compiled here can be linked into another unit
+
+#if defined(CEX_HAS_AVX)
+namespace
+{
+	using Numeric::UInt128;
+
+	// write the 16 state rows, each lane holds one block; the words are little endian on every x86 target
+	void Store4xUL512(const std::array<UInt128, 16> &State, uint8_t* Output)
+	{
+		uint32_t tmp[4];
+		size_t i;
+		size_t j;
+
+		for (i = 0; i < 16; ++i)
+		{
+			State[i].Store(tmp, 0);
+
+			for (j = 0; j < 4; ++j)
+			{
+				std::memcpy(Output + (i * 4) + (j * 64), &tmp[j], sizeof(uint32_t));
+			}
+		}
+	}
+
+	// the ChaCha-256 permutation of 4 blocks, one block in each 32-bit lane
+	void PermuteP4x512(uint8_t* Output, const uint32_t* Counter, const uint32_t* State, size_t Rounds)
+	{
+		std::array<UInt128, 16> X{ UInt128(State[0]), UInt128(State[1]), UInt128(State[2]), UInt128(State[3]),
+			UInt128(State[4]), UInt128(State[5]), UInt128(State[6]), UInt128(State[7]),
+			UInt128(State[8]), UInt128(State[9]), UInt128(State[10]), UInt128(State[11]),
+			UInt128(Counter, 0), UInt128(Counter, 4), UInt128(State[12]), UInt128(State[13]) };
+
+		while (Rounds != 0)
+		{
+			X[0] += X[4];
+			X[12] = UInt128::RotL32(X[12] ^ X[0], 16);
+			X[8] += X[12];
+			X[4] = UInt128::RotL32(X[4] ^ X[8], 12);
+			X[0] += X[4];
+			X[12] = UInt128::RotL32(X[12] ^ X[0], 8);
+			X[8] += X[12];
+			X[4] = UInt128::RotL32(X[4] ^ X[8], 7);
+			X[1] += X[5];
+			X[13] = UInt128::RotL32(X[13] ^ X[1], 16);
+			X[9] += X[13];
+			X[5] = UInt128::RotL32(X[5] ^ X[9], 12);
+			X[1] += X[5];
+			X[13] = UInt128::RotL32(X[13] ^ X[1], 8);
+			X[9] += X[13];
+			X[5] = UInt128::RotL32(X[5] ^ X[9], 7);
+			X[2] += X[6];
+			X[14] = UInt128::RotL32(X[14] ^ X[2], 16);
+			X[10] += X[14];
+			X[6] = UInt128::RotL32(X[6] ^ X[10], 12);
+			X[2] += X[6];
+			X[14] = UInt128::RotL32(X[14] ^ X[2], 8);
+			X[10] += X[14];
+			X[6] = UInt128::RotL32(X[6] ^ X[10], 7);
+			X[3] += X[7];
+			X[15] = UInt128::RotL32(X[15] ^ X[3], 16);
+			X[11] += X[15];
+			X[7] = UInt128::RotL32(X[7] ^ X[11], 12);
+			X[3] += X[7];
+			X[15] = UInt128::RotL32(X[15] ^ X[3], 8);
+			X[11] += X[15];
+			X[7] = UInt128::RotL32(X[7] ^ X[11], 7);
+			X[0] += X[5];
+			X[15] = UInt128::RotL32(X[15] ^ X[0], 16);
+			X[10] += X[15];
+			X[5] = UInt128::RotL32(X[5] ^ X[10], 12);
+			X[0] += X[5];
+			X[15] = UInt128::RotL32(X[15] ^ X[0], 8);
+			X[10] += X[15];
+			X[5] = UInt128::RotL32(X[5] ^ X[10], 7);
+			X[1] += X[6];
+			X[12] = UInt128::RotL32(X[12] ^ X[1], 16);
+			X[11] += X[12];
+			X[6] = UInt128::RotL32(X[6] ^ X[11], 12);
+			X[1] += X[6];
+			X[12] = UInt128::RotL32(X[12] ^ X[1], 8);
+			X[11] += X[12];
+			X[6] = UInt128::RotL32(X[6] ^ X[11], 7);
+			X[2] += X[7];
+			X[13] = UInt128::RotL32(X[13] ^ X[2], 16);
+			X[8] += X[13];
+			X[7] = UInt128::RotL32(X[7] ^ X[8], 12);
+			X[2] += X[7];
+			X[13] = UInt128::RotL32(X[13] ^ X[2], 8);
+			X[8] += X[13];
+			X[7] = UInt128::RotL32(X[7] ^ X[8], 7);
+			X[3] += X[4];
+			X[14] = UInt128::RotL32(X[14] ^ X[3], 16);
+			X[9] += X[14];
+			X[4] = UInt128::RotL32(X[4] ^ X[9], 12);
+			X[3] += X[4];
+			X[14] = UInt128::RotL32(X[14] ^ X[3], 8);
+			X[9] += X[14];
+			X[4] = UInt128::RotL32(X[4] ^ X[9], 7);
+			Rounds -= 2;
+		}
+
+		X[0] += UInt128(State[0]);
+		X[1] += UInt128(State[1]);
+		X[2] += UInt128(State[2]);
+		X[3] += UInt128(State[3]);
+		X[4] += UInt128(State[4]);
+		X[5] += UInt128(State[5]);
+		X[6] += UInt128(State[6]);
+		X[7] += UInt128(State[7]);
+		X[8] += UInt128(State[8]);
+		X[9] += UInt128(State[9]);
+		X[10] += UInt128(State[10]);
+		X[11] += UInt128(State[11]);
+		X[12] += UInt128(Counter, 0);
+		X[13] += UInt128(Counter, 4);
+		X[14] += UInt128(State[12]);
+		X[15] += UInt128(State[13]);
+
+		Store4xUL512(X, Output);
+	}
+}
+#else
+using Exception::CryptoSymmetricException;
+using Enumeration::ErrorCodes;
+#endif
+
+SimdProfiles ChaChaKernels::Compiled()
+{
+	return HasAvx512() ? SimdProfiles::Simd512 :
+		HasAvx2() ? SimdProfiles::Simd256 :
+		HasAvx() ? SimdProfiles::Simd128 :
+		SimdProfiles::None;
+}
+
+bool ChaChaKernels::HasAvx()
+{
+#if defined(CEX_HAS_AVX)
+	return true;
+#else
+	return false;
+#endif
+}
+
+void ChaChaKernels::PermuteP4x512H(uint8_t* Output, const uint32_t* Counter, const uint32_t* State, size_t Rounds)
+{
+#if defined(CEX_HAS_AVX)
+	PermuteP4x512(Output, Counter, State, Rounds);
+#else
+	throw CryptoSymmetricException(std::string("ChaChaKernels"), std::string("PermuteP4x512H"), std::string("The AVX kernel was not compiled!"), ErrorCodes::NotSupported);
+#endif
+}
+
+NAMESPACE_STREAMEND
@@ -0,0 +1,295 @@
+#include "ChaChaKernels.h"
+#if defined(CEX_HAS_AVX2)
+#	include "UInt256.h"
+#	include "ULong256.h"
+#	include <cstring>
+#else
+#	include "CryptoSymmetricException.h"
+#endif
+
+NAMESPACE_STREAM
+
+// this unit is compiled with the AVX2 code generation flag; it includes no shared header with instruction set branches,
+// and the permutations and the SIMD wrappers they use have internal linkage, so no inline code compiled here can be linked into another unit
+
+#if defined(CEX_HAS_AVX2)
+namespace
+{
+	using Numeric::UInt256;
+	using Numeric::ULong256;
+
+	// write the 16 state rows, each lane holds one block; the words are little endian on every x86 target
+	void Store8xUL512(const std::array<UInt256, 16> &State, uint8_t* Output)
+	{
+		uint32_t tmp[8];
+		size_t i;
+		size_t j;
+
+		for (i = 0; i < 16; ++i)
+		{
+			State[i].Store(tmp, 0);
+
+			for (j = 0; j < 8; ++j)
+			{
+				std::memcpy(Output + (i * 4) + (j * 64), &tmp[j], sizeof(uint32_t));
+			}
+		}
+	}
+
+	// write the 16 state rows, each lane holds one block; the words are little endian on every x86 target
+	void Store4xULL1024(const std::array<ULong256, 16> &State, uint8_t* Output)
+	{
+		uint64_t tmp[4];
+		size_t i;
+		size_t j;
+
+		for (i = 0; i < 16; ++i)
+		{
+			State[i].Store(tmp, 0);
+
+			for (j = 0; j < 4; ++j)
+			{
+				std::memcpy(Output + (i * 8) + (j * 128), &tmp[j], sizeof(uint64_t));
+			}
+		}
+	}
+
+	// the ChaCha-256 permutation of 8 blocks, one block in each 32-bit lane
+	void PermuteP8x512(uint8_t* Output, const uint32_t* Counter, const uint32_t* State, size_t Rounds)
+	{
+		std::array<UInt256, 16> X{ UInt256(State[0]), UInt256(State[1]), UInt256(State[2]), UInt256(State[3]),
+			UInt256(State[4]), UInt256(State[5]), UInt256(State[6]), UInt256(State[7]),
+			UInt256(State[8]), UInt256(State[9]), UInt256(State[10]), UInt256(State[11]),
+			UInt256(Counter, 0), UInt256(Counter, 8), UInt256(State[12]), UInt256(State[13]) };
+
+		while (Rounds != 0)
+		{
+			X[0] += X[4];
+			X[12] = UInt256::RotL32(X[12] ^ X[0], 16);
+			X[8] += X[12];
+			X[4] = UInt256::RotL32(X[4] ^ X[8], 12);
+			X[0] += X[4];
+			X[12] = UInt256::RotL32(X[12] ^ X[0], 8);
+			X[8] += X[12];
+			X[4] = UInt256::RotL32(X[4] ^ X[8], 7);
+			X[1] += X[5];
+			X[13] = UInt256::RotL32(X[13] ^ X[1], 16);
+			X[9] += X[13];
+			X[5] = UInt256::RotL32(X[5] ^ X[9], 12);
+			X[1] += X[5];
+			X[13] = UInt256::RotL32(X[13] ^ X[1], 8);
+			X[9] += X[13];
+			X[5] = UInt256::RotL32(X[5] ^ X[9], 7);
+			X[2] += X[6];
+			X[14] = UInt256::RotL32(X[14] ^ X[2], 16);
+			X[10] += X[14];
+			X[6] = UInt256::RotL32(X[6] ^ X[10], 12);
+			X[2] += X[6];
+			X[14] = UInt256::RotL32(X[14] ^ X[2], 8);
+			X[10] += X[14];
+			X[6] = UInt256::RotL32(X[6] ^ X[10], 7);
+			X[3] += X[7];
+			X[15] = UInt256::RotL32(X[15] ^ X[3], 16);
+			X[11] += X[15];
+			X[7] = UInt256::RotL32(X[7] ^ X[11], 12);
+			X[3] += X[7];
+			X[15] = UInt256::RotL32(X[15] ^ X[3], 8);
+			X[11] += X[15];
+			X[7] = UInt256::RotL32(X[7] ^ X[11], 7);
+			X[0] += X[5];
+			X[15] = UInt256::RotL32(X[15] ^ X[0], 16);
+			X[10] += X[15];
+			X[5] = UInt256::RotL32(X[5] ^ X[10], 12);
+			X[0] += X[5];
+			X[15] = UInt256::RotL32(X[15] ^ X[0], 8);
+			X[10] += X[15];
+			X[5] = UInt256::RotL32(X[5] ^ X[10], 7);
+			X[1] += X[6];
+			X[12] = UInt256::RotL32(X[12] ^ X[1], 16);
+			X[11] += X[12];
+			X[6] = UInt256::RotL32(X[6] ^ X[11], 12);
+			X[1] += X[6];
+			X[12] = UInt256::RotL32(X[12] ^ X[1], 8);
+			X[11] += X[12];
+			X[6] = UInt256::RotL32(X[6] ^ X[11], 7);
+			X[2] += X[7];
+			X[13] = UInt256::RotL32(X[13] ^ X[2], 16);
+			X[8] += X[13];
+			X[7] = UInt256::RotL32(X[7] ^ X[8], 12);
+			X[2] += X[7];
+			X[13] = UInt256::RotL32(X[13] ^ X[2], 8);
+			X[8] += X[13];
+			X[7] = UInt256::RotL32(X[7] ^ X[8], 7);
+			X[3] += X[4];
+			X[14] = UInt256::RotL32(X[14] ^ X[3], 16);
+			X[9] += X[14];
+			X[4] = UInt256::RotL32(X[4] ^ X[9], 12);
+			X[3] += X[4];
+			X[14] = UInt256::RotL32(X[14] ^ X[3], 8);
+			X[9] += X[14];
+			X[4] = UInt256::RotL32(X[4] ^ X[9], 7);
+			Rounds -= 2;
+		}
+
+		X[0] += UInt256(State[0]);
+		X[1] += UInt256(State[1]);
+		X[2] += UInt256(State[2]);
+		X[3] += UInt256(State[3]);
+		X[4] += UInt256(State[4]);
+		X[5] += UInt256(State[5]);
+		X[6] += UInt256(State[6]);
+		X[7] += UInt256(State[7]);
+		X[8] += UInt256(State[8]);
+		X[9] += UInt256(State[9]);
+		X[10] += UInt256(State[10]);
+		X[11] += UInt256(State[11]);
+		X[12] += UInt256(Counter, 0);
+		X[13] += UInt256(Counter, 8);
+		X[14] += UInt256(State[12]);
+		X[15] += UInt256(State[13]);
+
+		Store8xUL512(X, Output);
+	}
+
+	// the ChaCha-512 permutation of 4 blocks, one block in each 64-bit lane
+	void PermuteP4x1024(uint8_t* Output, const uint64_t* Counter, const uint64_t* State, size_t Rounds)
+	{
+		std::array<ULong256, 16> X{ ULong256(State[0]), ULong256(State[1]), ULong256(State[2]), ULong256(State[3]),
+			ULong256(State[4]), ULong256(State[5]), ULong256(State[6]), ULong256(State[7]), 
+			ULong256(State[8]), ULong256(State[9]), ULong256(State[10]), ULong256(State[11]), 
+			ULong256(Counter, 0), ULong256(Counter, 4), ULong256(State[12]), ULong256(State[13]) };
+
+		// new rotational constants = 
+		// 38,19,10,55 
+		// 33,4,51,13 
+		// 16,34,56,51 
+		// 4,53,42,41 
+		// 34,41,59,17 
+		// 23,31,37,20 
+		// 31,44,47,46 
+		// 12,47,44,30 
+
+		while (Rounds != 0)
+		{
+			// round n
+			X[0] += X[4];
+			X[12] = ULong256::RotL64(X[12] ^ X[0], 38);
+			X[8] += X[12];
+			X[4] = ULong256::RotL64(X[4] ^ X[8], 19);
+			X[0] += X[4];
+			X[12] = ULong256::RotL64(X[12] ^ X[0], 10);
+			X[8] += X[12];
+			X[4] = ULong256::RotL64(X[4] ^ X[8], 55);
+			X[1] += X[5];
+			X[13] = ULong256::RotL64(X[13] ^ X[1], 33);
+			X[9] += X[13];
+			X[5] = ULong256::RotL64(X[5] ^ X[9], 4);
+			X[1] += X[5];
+			X[13] = ULong256::RotL64(X[13] ^ X[1], 51);
+			X[9] += X[13];
+			X[5] = ULong256::RotL64(X[5] ^ X[9], 13);
+			X[2] += X[6];
+			X[14] = ULong256::RotL64(X[14] ^ X[2], 16);
+			X[10] += X[14];
+			X[6] = ULong256::RotL64(X[6] ^ X[10], 34);
+			X[2] += X[6];
+			X[14] = ULong256::RotL64(X[14] ^ X[2], 56);
+			X[10] += X[14];
+			X[6] = ULong256::RotL64(X[6] ^ X[10], 51);
+			X[3] += X[7];
+			X[15] = ULong256::RotL64(X[15] ^ X[3], 4);
+			X[11] += X[15];
+			X[7] = ULong256::RotL64(X[7] ^ X[11], 53);
+			X[3] += X[7];
+			X[15] = ULong256::RotL64(X[15] ^ X[3], 42);
+			X[11] += X[15];
+			X[7] = ULong256::RotL64(X[7] ^ X[11], 41);
+			// round n+1
+			X[0] += X[5];
+			X[15] = ULong256::RotL64(X[15] ^ X[0], 34);
+			X[10] += X[15];
+			X[5] = ULong256::RotL64(X[5] ^ X[10], 41);
+			X[0] += X[5];
+			X[15] = ULong256::RotL64(X[15] ^ X[0], 59);
+			X[10] += X[15];
+			X[5] = ULong256::RotL64(X[5] ^ X[10], 17);
+			X[1] += X[6];
+			X[12] = ULong256::RotL64(X[12] ^ X[1], 23);
+			X[11] += X[12];
+			X[6] = ULong256::RotL64(X[6] ^ X[11], 31);
+			X[1] += X[6];
+			X[12] = ULong256::RotL64(X[12] ^ X[1], 37);
+			X[11] += X[12];
+			X[6] = ULong256::RotL64(X[6] ^ X[11], 20);
+			X[2] += X[7];
+			X[13] = ULong256::RotL64(X[13] ^ X[2], 31);
+			X[8] += X[13];
+			X[7] = ULong256::RotL64(X[7] ^ X[8], 44);
+			X[2] += X[7];
+			X[13] = ULong256::RotL64(X[13] ^ X[2], 47);
+			X[8] += X[13];
+			X[7] = ULong256::RotL64(X[7] ^ X[8], 46);
+			X[3] += X[4];
+			X[14] = ULong256::RotL64(X[14] ^ X[3], 12);
+			X[9] += X[14];
+			X[4] = ULong256::RotL64(X[4] ^ X[9], 47);
+			X[3] += X[4];
+			X[14] = ULong256::RotL64(X[14] ^ X[3], 44);
+			X[9] += X[14];
+			X[4] = ULong256::RotL64(X[4] ^ X[9], 30);
+			Rounds -= 2;
+		}
+
+		X[0] += ULong256(State[0]);
+		X[1] += ULong256(State[1]);
+		X[2] += ULong256(State[2]);
+		X[3] += ULong256(State[3]);
+		X[4] += ULong256(State[4]);
+		X[5] += ULong256(State[5]);
+		X[6] += ULong256(State[6]);
+		X[7] += ULong256(State[7]);
+		X[8] += ULong256(State[8]);
+		X[9] += ULong256(State[9]);
+		X[10] += ULong256(State[10]);
+		X[11] += ULong256(State[11]);
+		X[12] += ULong256(Counter, 0);
+		X[13] += ULong256(Counter, 4);
+		X[14] += ULong256(State[12]);
+		X[15] += ULong256(State[13]);
+
+		Store4xULL1024(X, Output);
+	}
+}
+#else
+using Exception::CryptoSymmetricException;
+using Enumeration::ErrorCodes;
+#endif
+
+bool ChaChaKernels::HasAvx2()
+{
+#if defined(CEX_HAS_AVX2)
+	return true;
+#else
+	return false;
+#endif
+}
+
+void ChaChaKernels::PermuteP8x512H(uint8_t* Output, const uint32_t* Counter, const uint32_t* State, size_t Rounds)
+{
+#if defined(CEX_HAS_AVX2)
+	PermuteP8x512(Output, Counter, State, Rounds);
+#else
+	throw CryptoSymmetricException(std::string("ChaChaKernels"), std::string("PermuteP8x512H"), std::string("The AVX2 kernel was not compiled!"), ErrorCodes::NotSupported);
+#endif
+}
+
+void ChaChaKernels::PermuteP4x1024H(uint8_t* Output, const uint64_t* Counter, const uint64_t* State, size_t Rounds)
+{
+#if defined(CEX_HAS_AVX2)
+	PermuteP4x1024(Output, Counter, State, Rounds);
+#else
+	throw CryptoSymmetricException(std::string("ChaChaKernels"), std::string("PermuteP4x1024H"), std::string("The AVX2 kernel was not compiled!"), ErrorCodes::NotSupported);
+#endif
+}
+
+NAMESPACE_STREAMEND
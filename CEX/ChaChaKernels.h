@@ -0,0 +1,76 @@
+#ifndef CEX_CHACHAKERNELS_H
+#define CEX_CHACHAKERNELS_H
+
+#include "CexDomain.h"
+#include "SimdProfiles.h"
+
+NAMESPACE_STREAM
+
+using Enumeration::SimdProfiles;
+
+/// cond private
+
+/// <summary>
+/// Internal class: the wide ChaCha permutations, each built in its own instruction set translation unit.
+/// <para>ChaChaAvx.cpp, ChaChaAvx2.cpp and ChaChaAvx512.cpp are compiled with the AVX, AVX2 and AVX512 code generation flags respectively, and each holds its own permutations. 
+/// The units are self-contained: the permutations, and the SIMD wrappers they are written with, have internal linkage, and the units include no shared header with instruction set branches, 
+/// so the linker can never substitute code compiled for a wider instruction set into the rest of the library. 
+/// The functions take the output, counter and state as pointers, so no container code shared with the rest of the library is instantiated in a kernel unit; 
+/// Output receives one block for each lane, Counter holds the low counter word of every lane followed by the high words, and State holds the 14 key and nonce words. 
+/// A unit compiled without its instruction set reports the variant as absent, and its functions throw if called. 
+/// The ciphers select a variant at run-time with SimdDispatch::Select(Compiled(), SimdKernels, Length).</para>
+/// </summary>
+class ChaChaKernels final
+{
+public:
+
+	/// <summary>
+	/// The widest kernel variant compiled into the library
+	/// </summary>
+	static SimdProfiles Compiled();
+
+	/// <summary>
+	/// The AVX kernels were compiled
+	/// </summary>
+	static bool HasAvx();
+
+	/// <summary>
+	/// The AVX2 kernels were compiled
+	/// </summary>
+	static bool HasAvx2();
+
+	/// <summary>
+	/// The AVX512 kernels were compiled
+	/// </summary>
+	static bool HasAvx512();
+
+	/// <summary>
+	/// The ChaCha-256 permutation of 4 blocks using AVX instructions
+	/// </summary>
+	static void PermuteP4x512H(uint8_t* Output, const uint32_t* Counter, const uint32_t* State, size_t Rounds);
+
+	/// <summary>
+	/// The ChaCha-256 permutation of 8 blocks using AVX2 instructions
+	/// </summary>
+	static void PermuteP8x512H(uint8_t* Output, const uint32_t* Counter, const uint32_t* State, size_t Rounds);
+
+	/// <summary>
+	/// The ChaCha-256 permutation of 16 blocks using AVX512 instructions
+	/// </summary>
+	static void PermuteP16x512H(uint8_t* Output, const uint32_t* Counter, const uint32_t* State, size_t Rounds);
+
+	/// <summary>
+	/// The ChaCha-512 permutation of 4 blocks using AVX2 instructions
+	/// </summary>
+	static void PermuteP4x1024H(uint8_t* Output, const uint64_t* Counter, const uint64_t* State, size_t Rounds);
+
+	/// <summary>
+	/// The ChaCha-512 permutation of 8 blocks using AVX512 instructions
+	/// </summary>
+	static void PermuteP8x1024H(uint8_t* Output, const uint64_t* Counter, const uint64_t* State, size_t Rounds);
+};
+
+/// endcond
+
+NAMESPACE_STREAMEND
+#endif
@@ -1,16 +1,14 @@
 #include "ChaChaP20.h"
 #include "ChaCha.h"
+#include "ChaChaKernels.h"
 #include "IntegerTools.h"
+#include "KeystreamCache.h"
 #include "KMAC.h"
 #include "MemoryTools.h"
 #include "ParallelTools.h"
+#include "SegmentScratch.h"
 #include "SHAKE.h"
-
-#if defined(CEX_HAS_AVX2)
-#	include "UInt256.h"
-#elif defined(CEX_HAS_AVX)
-#	include "UInt128.h"
-#endif
+#include "SimdDispatch.h"
 
 NAMESPACE_STREAM
 
@@ -19,7 +17,10 @@ using Mac::KMAC;
 using Enumeration::KmacModes;
 using Tools::MemoryTools;
 using Tools::ParallelTools;
+using Tools::SegmentScratch;
 using Kdf::SHAKE;
+using Enumeration::SimdKernels;
+using Tools::SimdDispatch;
 
 const std::string ChaChaP20::CLASS_NAME("ChaChaP20");
 const std::vector<uint8_t> ChaChaP20::SIGMA_INFO = { 0x65, 0x78, 0x70, 0x61, 0x6E, 0x64, 0x20, 0x33, 0x32, 0x2D, 0x62, 0x79, 0x74, 0x65, 0x20, 0x6B };
@@ -33,6 +34,7 @@ public:
 	SecureVector<uint8_t> Custom;
 	SecureVector<uint8_t> MacKey;
 	SecureVector<uint8_t> MacTag;
+	SegmentScratch Segments;
 	std::vector<SymmetricKeySize> LegalKeySizes{
 			SymmetricKeySize(IK256_SIZE, NONCE_SIZE * sizeof(uint32_t), INFO_SIZE)};
 	uint64_t Counter = 0;
@@ -122,6 +124,7 @@ public:
 		MemoryTools::Clear(Nonce, 0, Nonce.size() * sizeof(uint32_t));
 		MemoryTools::Clear(State, 0, State.size() * sizeof(uint32_t));
 		MemoryTools::Clear(MacTag, 0, MacTag.size());
+		Segments.Clear();
 		Counter = 0;
 		IsEncryption = false;
 		IsInitialized = false;
@@ -180,8 +183,10 @@ ChaChaP20::ChaChaP20(bool Authenticate)
 	:
 	m_csx256State(new CSX256State(Authenticate)),
 	m_macAuthenticator(nullptr),
-	m_parallelProfile(BLOCK_SIZE, true, STATE_PRECACHED, true)
+	m_parallelProfile(BLOCK_SIZE, true, STATE_PRECACHED, true),
+	m_keystreamCache(nullptr)
 {
+	m_parallelProfile.SetAlgorithm(Name());
 }
 
 ChaChaP20::ChaChaP20(SecureVector<uint8_t> &State)
@@ -191,7 +196,8 @@ ChaChaP20::ChaChaP20(SecureVector<uint8_t> &State)
 	m_macAuthenticator(m_csx256State->IsAuthenticated == false ?
 		nullptr :
 		new KMAC(KmacModes::KMAC256)),
-	m_parallelProfile(BLOCK_SIZE, true, STATE_PRECACHED, true)
+	m_parallelProfile(BLOCK_SIZE, true, STATE_PRECACHED, true),
+	m_keystreamCache(nullptr)
 {
 	if (m_csx256State->IsAuthenticated == true)
 	{
@@ -199,10 +205,18 @@ ChaChaP20::ChaChaP20(SecureVector<uint8_t> &State)
 		SymmetricKey kpm(m_csx256State->MacKey);
 		m_macAuthenticator->Initialize(kpm);
 	}
+
+	m_parallelProfile.SetAlgorithm(Name());
 }
 
 ChaChaP20::~ChaChaP20()
 {
+	// the cache worker reads the cipher state, and is stopped first
+	if (m_keystreamCache != nullptr)
+	{
+		m_keystreamCache.reset(nullptr);
+	}
+
 	if (m_csx256State != nullptr)
 	{
 		m_csx256State.reset(nullptr);
@@ -270,6 +284,8 @@ const std::vector<uint8_t> ChaChaP20::Nonce()
 {
 	std::vector<uint8_t> tmpn(2 * sizeof(uint32_t));
 
+	Synchronize();
+
 	IntegerTools::Le32ToBytes(m_csx256State->Nonce[0], tmpn, 0);
 	IntegerTools::Le32ToBytes(m_csx256State->Nonce[1], tmpn, sizeof(uint32_t));
 
@@ -339,6 +355,12 @@ void ChaChaP20::Initialize(bool Encryption, ISymmetricKey &Parameters)
 		}
 	}
 
+	if (m_keystreamCache != nullptr)
+	{
+		// the worker must not read the state while it changes
+		m_keystreamCache->Stop();
+	}
+
 	// reset the counter and mac
 	if (IsInitialized() == true)
 	{
@@ -402,6 +424,19 @@ void ChaChaP20::Initialize(bool Encryption, ISymmetricKey &Parameters)
 
 	m_csx256State->IsEncryption = Encryption;
 	m_csx256State->IsInitialized = true;
+
+	if (m_keystreamCache != nullptr)
+	{
+		m_keystreamCache->Start(0);
+	}
+}
+
+void ChaChaP20::Invalidate()
+{
+	if (m_keystreamCache != nullptr && IsInitialized())
+	{
+		m_keystreamCache->Start(m_keystreamCache->Position());
+	}
 }
 
 void ChaChaP20::ParallelMaxDegree(size_t Degree)
@@ -414,13 +449,73 @@ void ChaChaP20::ParallelMaxDegree(size_t Degree)
 	m_parallelProfile.SetMaxDegree(Degree);
 }
 
+void ChaChaP20::Precompute(size_t Capacity)
+{
+	if (IsAuthenticator() == true)
+	{
+		throw CryptoSymmetricException(Name(), std::string("Precompute"), std::string("The key-stream can not be precomputed in authentication mode!"), ErrorCodes::IllegalOperation);
+	}
+	if (Capacity % (4 * BLOCK_SIZE) != 0)
+	{
+		throw CryptoSymmetricException(Name(), std::string("Precompute"), std::string("The capacity must be a multiple of four blocks!"), ErrorCodes::InvalidSize);
+	}
+
+	if (m_keystreamCache != nullptr)
+	{
+		// the counter continues from the last byte taken from the cache
+		Synchronize();
+		m_keystreamCache.reset(nullptr);
+	}
+
+	if (Capacity != 0)
+	{
+		m_keystreamCache.reset(new KeystreamCache(BLOCK_SIZE, Capacity, [this](uint64_t Position, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length, size_t)
+		{
+			// the counter is local to the call, so both lanes share the generator
+			this->Keystream(Position, Output, OutOffset, Length);
+		}));
+
+		if (IsInitialized())
+		{
+			m_keystreamCache->Start(((static_cast<uint64_t>(m_csx256State->Nonce[1]) << 32) | m_csx256State->Nonce[0]) * BLOCK_SIZE);
+		}
+	}
+}
+
 SecureVector<uint8_t> ChaChaP20::Serialize()
 {
+	Synchronize();
+
 	SecureVector<uint8_t> tmps = m_csx256State->Serialize();
 
 	return tmps;
 }
 
+void ChaChaP20::Seek(uint64_t Position)
+{
+	if (IsInitialized() == false)
+	{
+		throw CryptoSymmetricException(Name(), std::string("Seek"), std::string("The cipher has not been initialized!"), ErrorCodes::NotInitialized);
+	}
+	if (IsAuthenticator() == true)
+	{
+		throw CryptoSymmetricException(Name(), std::string("Seek"), std::string("The key-stream position can not be set in authentication mode!"), ErrorCodes::IllegalOperation);
+	}
+	if (Position % BLOCK_SIZE != 0)
+	{
+		throw CryptoSymmetricException(Name(), std::string("Seek"), std::string("The position must be aligned to the block size!"), ErrorCodes::InvalidParam);
+	}
+
+	// the block counter starts at zero, the nonce is held in the cipher state
+	m_csx256State->Nonce[0] = static_cast<uint32_t>(Position / BLOCK_SIZE);
+	m_csx256State->Nonce[1] = static_cast<uint32_t>((Position / BLOCK_SIZE) >> 32);
+
+	if (m_keystreamCache != nullptr)
+	{
+		m_keystreamCache->Reset(Position);
+	}
+}
+
 void ChaChaP20::SetAssociatedData(const std::vector<uint8_t> &Input, size_t Offset, size_t Length)
 {
 	if (IsInitialized() == false)
@@ -436,6 +531,21 @@ void ChaChaP20::SetAssociatedData(const std::vector<uint8_t> &Input, size_t Offs
 	m_macAuthenticator->Update(Input, Offset, Length);
 }
 
+void ChaChaP20::SetAssociatedData(const uint8_t* Input, size_t Length)
+{
+	if (IsInitialized() == false)
+	{
+		throw CryptoSymmetricException(Name(), std::string("SetAssociatedData"), std::string("The cipher has not been initialized!"), ErrorCodes::NotInitialized);
+	}
+	if (IsAuthenticator() == false)
+	{
+		throw CryptoSymmetricException(Name(), std::string("SetAssociatedData"), std::string("The cipher has not been configured for authentication!"), ErrorCodes::IllegalOperation);
+	}
+
+	// update the authenticator in segments
+	static_cast<KMAC*>(m_macAuthenticator.get())->Update(Input, Length);
+}
+
 void ChaChaP20::Transform(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length)
 {
 	if (IsEncryption() == true)
@@ -451,7 +561,7 @@ void ChaChaP20::Transform(const std::vector<uint8_t> &Input, size_t InOffset, st
 			m_macAuthenticator->Update(IntegerTools::Le32ToBytes<std::vector<uint8_t>>(m_csx256State->Nonce[0]), 0, sizeof(uint32_t));
 			m_macAuthenticator->Update(IntegerTools::Le32ToBytes<std::vector<uint8_t>>(m_csx256State->Nonce[1]), 0, sizeof(uint32_t));
 			// encrypt the stream
-			Process(Input, InOffset, Output, OutOffset, Length);
+			Process(Input.data(), InOffset, Output, OutOffset, Length);
 			// update the mac with the ciphertext
 			m_macAuthenticator->Update(Output, OutOffset, Length);
 			// update the mac counter
@@ -463,7 +573,7 @@ void ChaChaP20::Transform(const std::vector<uint8_t> &Input, size_t InOffset, st
 		else
 		{
 			// encrypt the stream
-			Process(Input, InOffset, Output, OutOffset, Length);
+			Process(Input.data(), InOffset, Output, OutOffset, Length);
 		}
 	}
 	else
@@ -487,7 +597,99 @@ void ChaChaP20::Transform(const std::vector<uint8_t> &Input, size_t InOffset, st
 		}
 
 		// decrypt the stream
-		Process(Input, InOffset, Output, OutOffset, Length);
+		Process(Input.data(), InOffset, Output, OutOffset, Length);
+	}
+}
+
+void ChaChaP20::Transform(const uint8_t* Input, uint8_t* Output, size_t Length)
+{
+	// the key-stream is generated in segments, and combined with the callers memory in a single pass
+	auto gen = [this](std::vector<uint8_t> &Target, size_t Count)
+	{
+		Process(nullptr, 0, Target, 0, Count);
+	};
+
+	if (IsEncryption() == true)
+	{
+		if (IsAuthenticator() == true)
+		{
+			// add the starting position of the nonce
+			m_macAuthenticator->Update(IntegerTools::Le32ToBytes<std::vector<uint8_t>>(m_csx256State->Nonce[0]), 0, sizeof(uint32_t));
+			m_macAuthenticator->Update(IntegerTools::Le32ToBytes<std::vector<uint8_t>>(m_csx256State->Nonce[1]), 0, sizeof(uint32_t));
+			// encrypt the stream
+			m_csx256State->Segments.Keystream(Input, Output, Length, ParallelBlockSize(), gen);
+			// update the mac with the ciphertext
+			static_cast<KMAC*>(m_macAuthenticator.get())->Update(Output, Length);
+			// update the mac counter
+			m_csx256State->Counter += Length;
+			// finalize the mac and add the tag to the stream
+			Finalize(m_csx256State, m_macAuthenticator);
+			MemoryTools::CopyRaw(m_csx256State->MacTag.data(), Output + Length, m_csx256State->MacTag.size());
+		}
+		else
+		{
+			// encrypt the stream
+			m_csx256State->Segments.Keystream(Input, Output, Length, ParallelBlockSize(), gen);
+		}
+	}
+	else
+	{
+		if (IsAuthenticator() == true)
+		{
+			// add the starting position of the nonce
+			m_macAuthenticator->Update(IntegerTools::Le32ToBytes<std::vector<uint8_t>>(m_csx256State->Nonce[0]), 0, sizeof(uint32_t));
+			m_macAuthenticator->Update(IntegerTools::Le32ToBytes<std::vector<uint8_t>>(m_csx256State->Nonce[1]), 0, sizeof(uint32_t));
+			// update the mac with the ciphertext
+			static_cast<KMAC*>(m_macAuthenticator.get())->Update(Input, Length);
+			// update the mac counter
+			m_csx256State->Counter += Length;
+			// finalize the mac and verify
+			Finalize(m_csx256State, m_macAuthenticator);
+
+			if (IntegerTools::CompareRaw(Input + Length, m_csx256State->MacTag.data(), m_csx256State->MacTag.size()) == false)
+			{
+				throw CryptoAuthenticationFailure(Name(), std::string("Transform"), std::string("The authentication tag does not match!"), ErrorCodes::AuthenticationFailure);
+			}
+		}
+
+		// decrypt the stream
+		m_csx256State->Segments.Keystream(Input, Output, Length, ParallelBlockSize(), gen);
+	}
+}
+
+void ChaChaP20::TransformAt(uint64_t Position, const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length)
+{
+	CEXASSERT(IntegerTools::Min(Input.size() - InOffset, Output.size() - OutOffset) >= Length, "The data arrays are smaller than the length!");
+
+	const size_t HDRLEN = static_cast<size_t>(Position % BLOCK_SIZE);
+	size_t i;
+	size_t prclen;
+
+	Seek(Position - HDRLEN);
+
+	if (HDRLEN != 0 && Length != 0)
+	{
+		// the position is inside a block; use the tail of that blocks key-stream
+		std::vector<uint8_t> otp(BLOCK_SIZE);
+		prclen = IntegerTools::Min(BLOCK_SIZE - HDRLEN, Length);
+		Generate(m_csx256State, m_csx256State->Nonce, otp, 0, BLOCK_SIZE);
+		// continue at the next block; this also moves the precompute cache
+		Seek(Position - HDRLEN + BLOCK_SIZE);
+
+		for (i = 0; i < prclen; ++i)
+		{
+			Output[OutOffset + i] = Input[InOffset + i] ^ otp[HDRLEN + i];
+		}
+
+		MemoryTools::Clear(otp, 0, otp.size());
+		InOffset += prclen;
+		OutOffset += prclen;
+		Length -= prclen;
+	}
+
+	if (Length != 0)
+	{
+		Process(Input.data(), InOffset, Output, OutOffset, Length);
 	}
 }
 
@@ -509,15 +711,16 @@ void ChaChaP20::Finalize(std::unique_ptr<CSX256State> &State, std::unique_ptr<IM
 
 void ChaChaP20::Generate(std::unique_ptr<CSX256State> &State, std::array<uint32_t, 2> &Counter, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length)
 {
+	const SimdProfiles SMDPRF = SimdDispatch::Instance().Select(ChaChaKernels::Compiled(), SimdKernels::ChaCha256, Length);
+	const size_t AVX512BLK = 16 * BLOCK_SIZE;
+	const size_t AVX2BLK = 8 * BLOCK_SIZE;
+	const size_t AVXBLK = 4 * BLOCK_SIZE;
 	size_t ctr;
 
 	ctr = 0;
 
-#if defined(CEX_HAS_AVX512)
-
-	const size_t AVX512BLK = 16 * BLOCK_SIZE;
-
-	if (Length >= AVX512BLK)
+	// the widest kernel the host and the library both support, 256-bit below the wide threshold
+	if (SMDPRF == SimdProfiles::Simd512 && Length >= AVX512BLK)
 	{
 		const size_t SEGALN = Length - (Length % AVX512BLK);
 		std::array<uint32_t, 32> tmpc = { 0 };
@@ -573,14 +776,11 @@ void ChaChaP20::Generate(std::unique_ptr<CSX256State> &State, std::array<uint32_
 			MemoryTools::Copy(Counter, 0, tmpc, 15, 4);
 			MemoryTools::Copy(Counter, 1, tmpc, 31, 4);
 			IntegerTools::LeIncrementW(Counter);
-			ChaCha::PermuteP16x512H(Output, OutOffset + ctr, tmpc, State->State, ROUND_COUNT);
+			ChaChaKernels::PermuteP16x512H(Output.data() + OutOffset + ctr, tmpc.data(), State->State.data(), ROUND_COUNT);
 			ctr += AVX512BLK;
 		}
 	}
-#elif defined(CEX_HAS_AVX2)
-	const size_t AVX2BLK = 8 * BLOCK_SIZE;
-
-	if (Length >= AVX2BLK)
+	else if (SMDPRF == SimdProfiles::Simd256 && Length >= AVX2BLK)
 	{
 		const size_t SEGALN = Length - (Length % AVX2BLK);
 		std::array<uint32_t, 16> tmpc = { 0 };
@@ -612,14 +812,11 @@ void ChaChaP20::Generate(std::unique_ptr<CSX256State> &State, std::array<uint32_
 			MemoryTools::Copy(Counter, 0, tmpc, 7, 4);
 			MemoryTools::Copy(Counter, 1, tmpc, 15, 4);
 			IntegerTools::LeIncrementW(Counter);
-			ChaCha::PermuteP8x512H(Output, OutOffset + ctr, tmpc, State->State, ROUND_COUNT);
+			ChaChaKernels::PermuteP8x512H(Output.data() + OutOffset + ctr, tmpc.data(), State->State.data(), ROUND_COUNT);
 			ctr += AVX2BLK;
 		}
 	}
-#elif defined(CEX_HAS_AVX)
-	const size_t AVXBLK = 4 * BLOCK_SIZE;
-
-	if (Length >= AVXBLK)
+	else if (SMDPRF == SimdProfiles::Simd128 && Length >= AVXBLK)
 	{
 		const size_t SEGALN = Length - (Length % AVXBLK);
 		std::array<uint32_t, 8> tmpc = { 0 };
@@ -639,11 +836,14 @@ void ChaChaP20::Generate(std::unique_ptr<CSX256State> &State, std::array<uint32_
 			MemoryTools::Copy(Counter, 0, tmpc, 3, 4);
 			MemoryTools::Copy(Counter, 1, tmpc, 7, 4);
 			IntegerTools::LeIncrementW(Counter);
-			ChaCha::PermuteP4x512H(Output, OutOffset + ctr, tmpc, State->State, ROUND_COUNT);
+			ChaChaKernels::PermuteP4x512H(Output.data() + OutOffset + ctr, tmpc.data(), State->State.data(), ROUND_COUNT);
 			ctr += AVXBLK;
 		}
 	}
-#endif
+	else
+	{
+		// misra
+	}
 
 	const size_t ALNLEN = Length - (Length % BLOCK_SIZE);
 
@@ -660,7 +860,7 @@ void ChaChaP20::Generate(std::unique_ptr<CSX256State> &State, std::array<uint32_
 
 	if (ctr != Length)
 	{
-		std::vector<uint8_t> otp(BLOCK_SIZE, 0);
+		std::array<uint8_t, BLOCK_SIZE> otp = { 0 };
 #if defined(CEX_CIPHER_COMPACT)
 		ChaCha::PermuteP512C(otp, 0, Counter, State->State, ROUND_COUNT);
 #else
@@ -672,6 +872,14 @@ void ChaChaP20::Generate(std::unique_ptr<CSX256State> &State, std::array<uint32_
 	}
 }
 
+void ChaChaP20::Keystream(uint64_t Position, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length)
+{
+	// called by the cache worker; the counter is local, and the cipher state is only read
+	std::array<uint32_t, NONCE_SIZE> ctr = { static_cast<uint32_t>(Position / BLOCK_SIZE), static_cast<uint32_t>((Position / BLOCK_SIZE) >> 32) };
+
+	Generate(m_csx256State, ctr, Output, OutOffset, Length);
+}
+
 void ChaChaP20::Load(const SecureVector<uint8_t> &Key, const SecureVector<uint8_t> &Nonce, const SecureVector<uint8_t> &Code)
 {
 	m_csx256State->State[0] = IntegerTools::LeBytesTo32(Code, 0);
@@ -690,69 +898,83 @@ void ChaChaP20::Load(const SecureVector<uint8_t> &Key, const SecureVector<uint8_
 	m_csx256State->State[13] = IntegerTools::LeBytesTo32(Nonce, 4);
 }
 
-void ChaChaP20::Process(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length)
+void ChaChaP20::Process(const uint8_t* Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length)
 {
-	const size_t PRCLEN = (Length >= Input.size() - InOffset) && Length >= Output.size() - OutOffset ? IntegerTools::Min(Input.size() - InOffset, Output.size() - OutOffset) : Length;
-
-	if (!m_parallelProfile.IsParallel() || PRCLEN < m_parallelProfile.ParallelMinimumSize())
+	// a null input writes the bare key-stream, which the pointer transform combines with the callers memory
+	if (m_keystreamCache != nullptr && IsInitialized() && Length <= m_keystreamCache->Capacity())
 	{
-		// generate random
-		Generate(m_csx256State, m_csx256State->Nonce, Output, OutOffset, PRCLEN);
-		// output is input xor random
-		const size_t ALNLEN = PRCLEN - (PRCLEN % BLOCK_SIZE);
-
-		if (ALNLEN != 0)
-		{
-			MemoryTools::XOR(Input, InOffset, Output, OutOffset, ALNLEN);
-		}
-
-		// get the remaining bytes
-		if (ALNLEN != PRCLEN)
-		{
-			for (size_t i = ALNLEN; i < PRCLEN; ++i)
-			{
-				Output[i + OutOffset] ^= Input[i + InOffset];
-			}
-		}
+		// short messages are an xor with the precomputed key-stream
+		m_keystreamCache->Transform((Input != nullptr) ? Input + InOffset : nullptr, Output.data() + OutOffset, Length);
 	}
 	else
 	{
-		// parallel CTR processing
-		const size_t CNKLEN = (PRCLEN / BLOCK_SIZE / m_parallelProfile.ParallelMaxDegree()) * BLOCK_SIZE;
-		const size_t RNDLEN = CNKLEN * m_parallelProfile.ParallelMaxDegree();
-		const size_t CTRLEN = (CNKLEN / BLOCK_SIZE);
-		std::vector<uint32_t> tmpCtr(NONCE_SIZE);
+		if (m_keystreamCache != nullptr && IsInitialized())
+		{
+			// long messages are processed directly, and the cache continues after the last block
+			const uint64_t STMPOS = m_keystreamCache->Position();
+			const uint64_t BLKCNT = static_cast<uint64_t>((Length + BLOCK_SIZE - 1) / BLOCK_SIZE);
+			m_csx256State->Nonce[0] = static_cast<uint32_t>(STMPOS / BLOCK_SIZE);
+			m_csx256State->Nonce[1] = static_cast<uint32_t>((STMPOS / BLOCK_SIZE) >> 32);
+			m_keystreamCache->Reset(STMPOS + (BLKCNT * BLOCK_SIZE));
+		}
+
+		const size_t PRCLEN = IntegerTools::Min(Output.size() - OutOffset, Length);
 
-		ParallelTools::ParallelFor(0, m_parallelProfile.ParallelMaxDegree(), [this, &Input, InOffset, &Output, OutOffset, &tmpCtr, CNKLEN, CTRLEN](size_t i)
+		if (!m_parallelProfile.IsParallel() || PRCLEN < m_parallelProfile.ParallelMinimumSize())
 		{
-			// thread level counter
-			std::array<uint32_t, 2> thdCtr = { 0 };
-			// offset counter by chunk size / block size
-			IntegerTools::LeIncreaseW(m_csx256State->Nonce, thdCtr, CTRLEN * i);
-			const size_t STMPOS = i * CNKLEN;
-			// create random at offset position
-			this->Generate(m_csx256State, thdCtr, Output, OutOffset + STMPOS, CNKLEN);
-			// xor with input at offset
-			MemoryTools::XOR(Input, InOffset + STMPOS, Output, OutOffset + STMPOS, CNKLEN);
-			// store last counter
-			if (i == m_parallelProfile.ParallelMaxDegree() - 1)
+			// generate random
+			Generate(m_csx256State, m_csx256State->Nonce, Output, OutOffset, PRCLEN);
+
+			// output is input xor random
+			if (Input != nullptr && PRCLEN != 0)
 			{
-				MemoryTools::Copy(thdCtr, 0, tmpCtr, 0, NONCE_SIZE * sizeof(uint32_t));
+				MemoryTools::XorRaw(Input + InOffset, Output.data() + OutOffset, PRCLEN);
 			}
-		});
-
-		// copy last counter to class variable
-		MemoryTools::Copy(tmpCtr, 0, m_csx256State->Nonce, 0, NONCE_SIZE * sizeof(uint32_t));
-
-		// last block processing
-		if (RNDLEN < PRCLEN)
+		}
+		else
 		{
-			const size_t FNLLEN = PRCLEN % RNDLEN;
-			Generate(m_csx256State, m_csx256State->Nonce, Output, RNDLEN, FNLLEN);
+			// parallel CTR processing
+			const size_t CNKLEN = (PRCLEN / BLOCK_SIZE / m_parallelProfile.ParallelMaxDegree()) * BLOCK_SIZE;
+			const size_t RNDLEN = CNKLEN * m_parallelProfile.ParallelMaxDegree();
+			const size_t CTRLEN = (CNKLEN / BLOCK_SIZE);
+			std::array<uint32_t, NONCE_SIZE> tmpCtr;
 
-			for (size_t i = 0; i < FNLLEN; ++i)
+			ParallelTools::ParallelFor(m_parallelProfile, Output.data() + OutOffset, 0, m_parallelProfile.ParallelMaxDegree(), [this, Input, InOffset, &Output, OutOffset, &tmpCtr, CNKLEN, CTRLEN](size_t i)
 			{
-				Output[i + OutOffset + RNDLEN] ^= static_cast<uint8_t>(Input[i + InOffset + RNDLEN]);
+				// thread level counter
+				std::array<uint32_t, 2> thdCtr = { 0 };
+				// offset counter by chunk size / block size
+				IntegerTools::LeIncreaseW(m_csx256State->Nonce, thdCtr, CTRLEN * i);
+				const size_t STMPOS = i * CNKLEN;
+				// create random at offset position
+				this->Generate(m_csx256State, thdCtr, Output, OutOffset + STMPOS, CNKLEN);
+
+				// xor with input at offset
+				if (Input != nullptr)
+				{
+					MemoryTools::XorRaw(Input + InOffset + STMPOS, Output.data() + OutOffset + STMPOS, CNKLEN);
+				}
+
+				// store last counter
+				if (i == m_parallelProfile.ParallelMaxDegree() - 1)
+				{
+					MemoryTools::Copy(thdCtr, 0, tmpCtr, 0, NONCE_SIZE * sizeof(uint32_t));
+				}
+			});
+
+			// copy last counter to class variable
+			MemoryTools::Copy(tmpCtr, 0, m_csx256State->Nonce, 0, NONCE_SIZE * sizeof(uint32_t));
+
+			// last block processing
+			if (RNDLEN < PRCLEN)
+			{
+				const size_t FNLLEN = PRCLEN % RNDLEN;
+				Generate(m_csx256State, m_csx256State->Nonce, Output, OutOffset + RNDLEN, FNLLEN);
+
+				if (Input != nullptr)
+				{
+					MemoryTools::XorRaw(Input + InOffset + RNDLEN, Output.data() + OutOffset + RNDLEN, FNLLEN);
+				}
 			}
 		}
 	}
@@ -768,4 +990,15 @@ void ChaChaP20::Reset()
 	}
 }
 
+void ChaChaP20::Synchronize()
+{
+	if (m_keystreamCache != nullptr && IsInitialized())
+	{
+		// short transforms advance the cache position instead of the counter
+		const uint64_t BLKCTR = m_keystreamCache->Position() / BLOCK_SIZE;
+		m_csx256State->Nonce[0] = static_cast<uint32_t>(BLKCTR);
+		m_csx256State->Nonce[1] = static_cast<uint32_t>(BLKCTR >> 32);
+	}
+}
+
 NAMESPACE_STREAMEND
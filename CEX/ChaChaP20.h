@@ -34,11 +34,13 @@
 #define CEX_CSX256_H
 
 #include "IStreamCipher.h"
+#include "KeystreamCache.h"
 #include "ShakeModes.h"
 
 NAMESPACE_STREAM
 
 using Enumeration::ShakeModes;
+using Tools::KeystreamCache;
 
 /// <summary>
 /// A parallelized and vectorized ChaCha-256 20-round stream cipher [ChaChaP20] implementation.
@@ -111,6 +113,7 @@ using Enumeration::ShakeModes;
 /// <item><description>The ParallelProfile().ParallelThreadsMax() property is used as the thread count in the parallel loop; it defaults to the maximum number of available virtual cores, but is user-assignable, and must be an even number no greater than the number of processer cores on the system.</description></item>
 /// <item><description>ParallelProfile().ParallelBlockSize() is calculated automatically based on processor(s) cache size but can be user defined, but must be evenly divisible by ParallelProfile().ParallelMinimumSize().</description></item>
 /// <item><description>The ParallelBlockSize(), IsParallel(), and ParallelThreadsMax() accessors, can be changed through the ParallelProfile() property, the initial size is calculated automatically based on the systems capabilities, and modifying this vale is not recommended</description></item>
+/// <item><description>Precompute(size_t) starts a worker thread that generates key-stream ahead of use; a transform no longer than the cache is then an XOR with the cached key-stream, which removes the permutation from the latency of short messages.</description></item>
 /// </list>
 /// 
 /// <description>Guiding Publications:</description>
@@ -145,6 +148,7 @@ private:
 	std::unique_ptr<CSX256State> m_csx256State;
 	std::unique_ptr<IMac> m_macAuthenticator;
 	ParallelOptions m_parallelProfile;
+	std::unique_ptr<KeystreamCache> m_keystreamCache;
 
 public:
 
@@ -278,6 +282,12 @@ public:
 	/// <exception cref="CryptoSymmetricException">Thrown if a null or invalid key is used</exception>
 	void Initialize(bool Encryption, ISymmetricKey &Parameters) override;
 
+	/// <summary>
+	/// Discard the precomputed key-stream, and restart the background generation at the current position.
+	/// <para>Initialize(bool, ISymmetricKey) invalidates the cache automatically. Has no effect if precomputation is not enabled.</para>
+	/// </summary>
+	void Invalidate();
+
 	/// <summary>
 	/// Set the maximum number of threads allocated when using multi-threaded processing.
 	/// <para>When set to zero, thread count is set automatically. If set to 1, sets IsParallel() to false and runs in sequential mode. 
@@ -289,6 +299,31 @@ public:
 	/// <exception cref="CryptoCipherModeException">Thrown if the degree parameter is invalid</exception>
 	void ParallelMaxDegree(size_t Degree) override;
 
+	/// <summary>
+	/// Enable or disable background key-stream precomputation.
+	/// <para>A worker thread fills a ring of Capacity bytes with the key-stream that follows the current position, and refills it as it is consumed.
+	/// A Transform call no longer than the capacity XORs the message with the cached key-stream; a longer message is processed directly, and the cache resumes after it.
+	/// The output is identical to the output without the cache. Rekeying, Seek, and TransformAt reposition the cache; a capacity of zero stops the worker and releases the cache.
+	/// Not available in authentication mode.</para>
+	/// </summary>
+	///
+	/// <param name="Capacity">The cache size in bytes; a multiple of four blocks, or zero to disable precomputation</param>
+	/// 
+	/// <exception cref="CryptoSymmetricException">Thrown if authentication is enabled, or the capacity is not a multiple of four blocks</exception>
+	void Precompute(size_t Capacity);
+
+	/// <summary>
+	/// Set the key-stream position to a byte offset from the start of the stream.
+	/// <para>The position is measured from the nonce the cipher was initialized with, and the next Transform call starts there.
+	/// The position must be a multiple of the block size; use TransformAt to start within a block.
+	/// Not available in authentication mode.</para>
+	/// </summary>
+	/// 
+	/// <param name="Position">The byte offset from the start of the key-stream</param>
+	///
+	/// <exception cref="CryptoSymmetricException">Thrown if the cipher is not initialized, authentication is enabled, or the position is not block aligned</exception>
+	void Seek(uint64_t Position) override;
+
 	/// <summary>
 	/// Saves the internal state of the cipher to a secure vector.
 	/// <para>The Serialize function can store the internal state of the cipher at the time it is invoked.
@@ -311,6 +346,18 @@ public:
 	/// <exception cref="CryptoSymmetricException">Thrown if the cipher is not initialized</exception>
 	void SetAssociatedData(const std::vector<uint8_t> &Input, size_t Offset, size_t Length) override;
 
+	/// <summary>
+	/// Add additional data in the callers memory to the message authentication code generator.  
+	/// <para>Must be called after Initialize(bool, ISymmetricKey), and can then be called before or after a stream segment has been processed.
+	/// The data is added to the MAC in segments of ParallelBlockSize(), and is not copied in full.</para>
+	/// </summary>
+	/// 
+	/// <param name="Input">A pointer to the bytes to process</param>
+	/// <param name="Length">The number of bytes to process</param>
+	///
+	/// <exception cref="CryptoSymmetricException">Thrown if the cipher is not initialized, or not configured for authentication</exception>
+	void SetAssociatedData(const uint8_t* Input, size_t Length) override;
+
 	/// <summary>
 	/// Encrypt/Decrypt a vector of bytes with offset and length parameters.
 	/// <para>Initialize(bool, ISymmetricKey) must be called before this method can be used.
@@ -327,13 +374,49 @@ public:
 	/// <exception cref="CryptoAuthenticationFailure">Thrown during decryption if the the ciphertext fails authentication</exception>
 	void Transform(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length) override;
 
+	/// <summary>
+	/// Encrypt/Decrypt a length of bytes in the callers memory.
+	/// <para>The pointer form of Transform, for buffers that are not held in a vector, such as pooled, mapped or scatter-gather memory.
+	/// The key-stream is generated in segments of ParallelBlockSize(), including the parallel and precomputed paths of the vector transform, and is xored directly into Output;
+	/// an in-place transform writes each message byte once. Input and Output may be the same address, but must not otherwise overlap.
+	/// In authenticated encryption mode, the MAC code is written after the cipher-text, so Output must have room for Length + TagSize() bytes; 
+	/// in decryption mode, the code following the Length bytes of cipher-text is checked before the stream is decrypted.
+	/// Initialize(bool, ISymmetricKey) must be called before this method can be used.</para>
+	/// </summary>
+	/// 
+	/// <param name="Input">A pointer to the bytes to transform</param>
+	/// <param name="Output">A pointer to the transformed bytes</param>
+	/// <param name="Length">The number of message bytes to transform</param>
+	///
+	/// <exception cref="CryptoAuthenticationFailure">Thrown before decryption if the the ciphertext fails authentication</exception>
+	void Transform(const uint8_t* Input, uint8_t* Output, size_t Length) override;
+
+	/// <summary>
+	/// Encrypt/Decrypt a vector of bytes starting at an absolute key-stream position.
+	/// <para>The counter is set directly from the position, so a window of a large stream can be decrypted without generating the key-stream before it.
+	/// The position can be any byte offset; a leading partial block is taken from the block containing the position.
+	/// Not available in authentication mode.</para>
+	/// </summary>
+	/// 
+	/// <param name="Position">The byte offset of the first input byte within the key-stream</param>
+	/// <param name="Input">The input vector of bytes to transform</param>
+	/// <param name="InOffset">The starting offset within the input vector</param>
+	/// <param name="Output">The output vector of transformed bytes</param>
+	/// <param name="OutOffset">The starting offset within the output vector</param>
+	/// <param name="Length">The number of bytes to process</param>
+	///
+	/// <exception cref="CryptoSymmetricException">Thrown if the cipher is not initialized, or authentication is enabled</exception>
+	void TransformAt(uint64_t Position, const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length) override;
+
 private:
 
 	static void Finalize(std::unique_ptr<CSX256State> &State, std::unique_ptr<IMac> &Authenticator);
 	static void Generate(std::unique_ptr<CSX256State> &State, std::array<uint32_t, NONCE_SIZE> &Counter, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length);
+	void Keystream(uint64_t Position, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length);
 	void Load(const SecureVector<uint8_t> &Key, const SecureVector<uint8_t> &Nonce, const SecureVector<uint8_t> &Code);
-	void Process(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length);
+	void Process(const uint8_t* Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length);
 	void Reset();
+	void Synchronize();
 };
 
 NAMESPACE_STREAMEND
@@ -26,6 +26,9 @@ std::string CipherModeConvert::ToName(CipherModes Enumeral)
 	case CipherModes::GCM:
 		name = std::string("GCM");
 		break;
+	case CipherModes::GCMSIV:
+		name = std::string("GCMSIV");
+		break;
 	case CipherModes::HBA:
 		name = std::string("HBA");
 		break;
@@ -47,6 +50,9 @@ std::string CipherModeConvert::ToName(CipherModes Enumeral)
 	case CipherModes::OFB:
 		name = std::string("OFB");
 		break;
+	case CipherModes::XTS:
+		name = std::string("XTS");
+		break;
 	default:
 		name = std::string("None");
 		break;
@@ -83,6 +89,10 @@ CipherModes CipherModeConvert::FromName(std::string &Name)
 	{
 		tname = CipherModes::GCM;
 	}
+	else if (Name == std::string("GCMSIV"))
+	{
+		tname = CipherModes::GCMSIV;
+	}
 	else if (Name == std::string("HBA"))
 	{
 		tname = CipherModes::HBA;
@@ -111,6 +121,10 @@ CipherModes CipherModeConvert::FromName(std::string &Name)
 	{
 		tname = CipherModes::OFB;
 	}
+	else if (Name == std::string("XTS"))
+	{
+		tname = CipherModes::XTS;
+	}
 	else
 	{
 		tname = CipherModes::None;
@@ -65,7 +65,15 @@ enum class CipherModes : uint8_t
 	/// <summary>
 	/// Output FeedBack Mode
 	/// </summary>
-	OFB = 13
+	OFB = 13,
+	/// <summary>
+	/// XEX-based Tweaked CodeBook mode with ciphertext Stealing
+	/// </summary>
+	XTS = 14,
+	/// <summary>
+	/// Galois Counter Synthetic IV Mode; nonce misuse-resistant counter mode encryption with POLYVAL authentication
+	/// </summary>
+	GCMSIV = 15
 };
 
 class CipherModeConvert
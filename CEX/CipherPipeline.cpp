@@ -0,0 +1,504 @@
+#include "CipherPipeline.h"
+#include "CipherModes.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+NAMESPACE_PROCESSING
+
+using Enumeration::CipherModes;
+using Enumeration::ErrorCodes;
+
+const std::string CipherPipeline::CLASS_NAME("CipherPipeline");
+
+/// <summary>
+/// A bounded ring of chunk indices linking two pipeline stages
+/// </summary>
+class CipherPipeline::ChunkQueue
+{
+private:
+
+	std::vector<size_t> m_queueRing;
+	std::condition_variable m_queueSignal;
+	std::mutex m_queueMutex;
+	size_t m_queueCount;
+	size_t m_queueHead;
+	bool m_isClosed;
+
+public:
+
+	explicit ChunkQueue(size_t Capacity)
+		:
+		m_queueRing(Capacity),
+		m_queueSignal(),
+		m_queueMutex(),
+		m_queueCount(0),
+		m_queueHead(0),
+		m_isClosed(false)
+	{
+	}
+
+	void Close()
+	{
+		std::lock_guard<std::mutex> lock(m_queueMutex);
+
+		m_isClosed = true;
+		m_queueSignal.notify_all();
+	}
+
+	bool Pop(size_t &Index, uint64_t &StallTime)
+	{
+		std::unique_lock<std::mutex> lock(m_queueMutex);
+		std::chrono::steady_clock::time_point start;
+		bool res;
+
+		if (m_queueCount == 0 && !m_isClosed)
+		{
+			start = std::chrono::steady_clock::now();
+			m_queueSignal.wait(lock, [this]() { return m_queueCount != 0 || m_isClosed; });
+			StallTime += static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+		}
+
+		res = !m_isClosed;
+
+		if (res)
+		{
+			Index = m_queueRing[m_queueHead];
+			m_queueHead = (m_queueHead + 1) % m_queueRing.size();
+			--m_queueCount;
+			m_queueSignal.notify_all();
+		}
+
+		return res;
+	}
+
+	bool Push(size_t Index)
+	{
+		std::unique_lock<std::mutex> lock(m_queueMutex);
+		bool res;
+
+		m_queueSignal.wait(lock, [this]() { return m_queueCount != m_queueRing.size() || m_isClosed; });
+		res = !m_isClosed;
+
+		if (res)
+		{
+			m_queueRing[(m_queueHead + m_queueCount) % m_queueRing.size()] = Index;
+			++m_queueCount;
+			m_queueSignal.notify_all();
+		}
+
+		return res;
+	}
+};
+
+class CipherPipeline::PipelineState
+{
+public:
+
+	struct Chunk
+	{
+		std::vector<uint8_t> Data;
+		std::vector<uint8_t> Work;
+		size_t Length;
+	};
+
+	std::vector<Chunk> Chunks;
+	std::vector<uint8_t> Code;
+	std::array<PipelineStatistics, STAGE_COUNT> Statistics;
+	std::exception_ptr Error;
+	std::mutex ErrorMutex;
+	IDigest* Digest;
+	IMac* Mac;
+	ICipherMode* Mode;
+	IStreamCipher* Stream;
+	size_t ChunkSize;
+	size_t QueueDepth;
+	size_t RunChunkSize;
+	bool TapInput;
+
+	PipelineState(size_t Size, size_t Depth)
+		:
+		Chunks(0),
+		Code(0),
+		Statistics(),
+		Error(nullptr),
+		ErrorMutex(),
+		Digest(nullptr),
+		Mac(nullptr),
+		Mode(nullptr),
+		Stream(nullptr),
+		ChunkSize(Size),
+		QueueDepth(Depth),
+		RunChunkSize(Size),
+		TapInput(false)
+	{
+	}
+
+	~PipelineState()
+	{
+		Chunks.clear();
+		Code.clear();
+		Digest = nullptr;
+		Mac = nullptr;
+		Mode = nullptr;
+		Stream = nullptr;
+		ChunkSize = 0;
+		QueueDepth = 0;
+		RunChunkSize = 0;
+		TapInput = false;
+	}
+};
+
+//~~~Constructor~~~//
+
+CipherPipeline::CipherPipeline(size_t ChunkSize, size_t QueueDepth)
+	:
+	m_pipelineState(QueueDepth >= 2 ? new PipelineState(ChunkSize, QueueDepth) :
+		throw CryptoProcessingException(CLASS_NAME, std::string("Constructor"), std::string("The queue depth must be at least 2!"), ErrorCodes::InvalidParam))
+{
+}
+
+CipherPipeline::~CipherPipeline()
+{
+}
+
+//~~~Accessors~~~//
+
+size_t CipherPipeline::ChunkSize()
+{
+	return m_pipelineState->RunChunkSize;
+}
+
+const std::vector<uint8_t> &CipherPipeline::Code()
+{
+	return m_pipelineState->Code;
+}
+
+size_t CipherPipeline::QueueDepth()
+{
+	return m_pipelineState->QueueDepth;
+}
+
+//~~~Public Functions~~~//
+
+void CipherPipeline::Authenticate(IDigest* Digest, bool TapInput)
+{
+	m_pipelineState->Digest = Digest;
+	m_pipelineState->Mac = nullptr;
+	m_pipelineState->TapInput = TapInput;
+}
+
+void CipherPipeline::Authenticate(IMac* Mac, bool TapInput)
+{
+	m_pipelineState->Digest = nullptr;
+	m_pipelineState->Mac = Mac;
+	m_pipelineState->TapInput = TapInput;
+}
+
+void CipherPipeline::Run(IByteStream* Source, IByteStream* Sink)
+{
+	typedef PipelineState::Chunk Chunk;
+
+	// the end of stream marker passed down the stages
+	const size_t ENDCHK = static_cast<size_t>(~0ULL);
+	PipelineState* stt = m_pipelineState.get();
+	std::vector<std::function<void(Chunk &)>> prc(0);
+	std::vector<PipelineStages> stg(0);
+	std::vector<std::unique_ptr<ChunkQueue>> qus(0);
+	std::vector<std::thread> thd(0);
+	std::atomic<bool> abt(false);
+	size_t blen;
+	size_t clen;
+	size_t i;
+
+	if (Source == nullptr)
+	{
+		throw CryptoProcessingException(CLASS_NAME, std::string("Run"), std::string("The source stream can not be null!"), ErrorCodes::IllegalOperation);
+	}
+
+	blen = (stt->Mode != nullptr) ? stt->Mode->ParallelProfile().BlockSize() : (stt->Stream != nullptr) ? stt->Stream->ParallelProfile().BlockSize() : 1;
+	clen = (stt->ChunkSize != 0) ? stt->ChunkSize : (stt->Mode != nullptr) ? stt->Mode->ParallelBlockSize() : (stt->Stream != nullptr) ? stt->Stream->ParallelBlockSize() : DEF_CHUNKSIZE;
+
+	if (clen == 0 || clen % blen != 0)
+	{
+		throw CryptoProcessingException(CLASS_NAME, std::string("Run"), std::string("The chunk size must be a multiple of the cipher block size!"), ErrorCodes::InvalidSize);
+	}
+
+	// the chunks are kept between runs with the same chunk size
+	if (stt->RunChunkSize != clen || stt->Chunks.size() != stt->QueueDepth)
+	{
+		stt->Chunks.resize(stt->QueueDepth);
+
+		for (i = 0; i < stt->Chunks.size(); ++i)
+		{
+			stt->Chunks[i].Data.resize(clen);
+			stt->Chunks[i].Work.resize((stt->Mode != nullptr || stt->Stream != nullptr) ? clen : 0);
+			stt->Chunks[i].Length = 0;
+		}
+
+		stt->RunChunkSize = clen;
+	}
+
+	stt->Code.clear();
+	stt->Error = nullptr;
+	stt->Statistics.fill(PipelineStatistics());
+
+	// the stage order: [input tap] -> transform -> [output tap] -> sink
+	if ((stt->Digest != nullptr || stt->Mac != nullptr) && stt->TapInput)
+	{
+		stg.push_back(PipelineStages::Authenticate);
+	}
+
+	if (stt->Mode != nullptr || stt->Stream != nullptr)
+	{
+		stg.push_back(PipelineStages::Transform);
+	}
+
+	if ((stt->Digest != nullptr || stt->Mac != nullptr) && !stt->TapInput)
+	{
+		stg.push_back(PipelineStages::Authenticate);
+	}
+
+	if (Sink != nullptr)
+	{
+		stg.push_back(PipelineStages::Sink);
+	}
+
+	for (i = 0; i < stg.size(); ++i)
+	{
+		switch (stg[i])
+		{
+			case PipelineStages::Authenticate:
+			{
+				if (stt->Digest != nullptr)
+				{
+					prc.push_back([stt](Chunk &C) { stt->Digest->Update(C.Data, 0, C.Length); });
+				}
+				else
+				{
+					prc.push_back([stt](Chunk &C) { stt->Mac->Update(C.Data, 0, C.Length); });
+				}
+				break;
+			}
+			case PipelineStages::Transform:
+			{
+				if (stt->Mode != nullptr)
+				{
+					const bool CTRMOD = (stt->Mode->Enumeral() == CipherModes::CTR || stt->Mode->Enumeral() == CipherModes::ICM);
+
+					prc.push_back([stt, blen, CTRMOD](Chunk &C)
+					{
+						if (!CTRMOD && C.Length % blen != 0)
+						{
+							throw CryptoProcessingException(CLASS_NAME, std::string("Run"), std::string("The stream length must be a multiple of the block size!"), ErrorCodes::InvalidSize);
+						}
+
+						stt->Mode->Transform(C.Data, 0, C.Work, 0, C.Length);
+						C.Data.swap(C.Work);
+					});
+				}
+				else
+				{
+					prc.push_back([stt](Chunk &C)
+					{
+						stt->Stream->Transform(C.Data, 0, C.Work, 0, C.Length);
+						C.Data.swap(C.Work);
+					});
+				}
+				break;
+			}
+			default:
+			{
+				prc.push_back([Sink](Chunk &C) { Sink->Write(C.Data, 0, C.Length); });
+			}
+		}
+	}
+
+	// queue 0 holds the free chunks, queue n feeds stage n
+	for (i = 0; i <= stg.size(); ++i)
+	{
+		qus.push_back(std::unique_ptr<ChunkQueue>(new ChunkQueue(stt->QueueDepth + 1)));
+	}
+
+	for (i = 0; i < stt->QueueDepth; ++i)
+	{
+		qus[0]->Push(i);
+	}
+
+	std::function<void(std::exception_ptr)> fail = [stt, &abt, &qus](std::exception_ptr Error)
+	{
+		std::lock_guard<std::mutex> lock(stt->ErrorMutex);
+
+		if (!abt)
+		{
+			stt->Error = Error;
+			abt = true;
+
+			for (size_t j = 0; j < qus.size(); ++j)
+			{
+				qus[j]->Close();
+			}
+		}
+	};
+
+	try
+	{
+		// the source stage fills free chunks until the stream is exhausted
+		thd.push_back(std::thread([stt, Source, clen, ENDCHK, &qus, &fail, &stg]()
+		{
+			PipelineStatistics &sts = stt->Statistics[static_cast<size_t>(PipelineStages::Source)];
+			std::chrono::steady_clock::time_point start;
+			ChunkQueue* nxt = (stg.size() != 0) ? qus[1].get() : qus[0].get();
+			size_t idx;
+			size_t pread;
+			bool eos;
+
+			try
+			{
+				eos = false;
+
+				while (!eos && qus[0]->Pop(idx, sts.StallTime))
+				{
+					Chunk &chk = stt->Chunks[idx];
+					start = std::chrono::steady_clock::now();
+					chk.Length = 0;
+
+					do
+					{
+						pread = Source->Read(chk.Data, chk.Length, clen - chk.Length);
+						chk.Length += pread;
+					}
+					while (pread != 0 && chk.Length != clen);
+
+					eos = (pread == 0);
+					sts.ActiveTime += static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+
+					if (chk.Length != 0)
+					{
+						sts.Bytes += chk.Length;
+						++sts.Chunks;
+						nxt->Push(idx);
+					}
+					else
+					{
+						qus[0]->Push(idx);
+					}
+				}
+
+				if (stg.size() != 0)
+				{
+					nxt->Push(ENDCHK);
+				}
+			}
+			catch (...)
+			{
+				fail(std::current_exception());
+			}
+		}));
+
+		for (i = 0; i < stg.size(); ++i)
+		{
+			thd.push_back(std::thread([stt, i, ENDCHK, &qus, &fail, &stg, &prc]()
+			{
+				PipelineStatistics &sts = stt->Statistics[static_cast<size_t>(stg[i])];
+				std::chrono::steady_clock::time_point start;
+				ChunkQueue* nxt = (i + 1 < stg.size()) ? qus[i + 2].get() : nullptr;
+				size_t idx;
+
+				try
+				{
+					while (qus[i + 1]->Pop(idx, sts.StallTime))
+					{
+						if (idx == ENDCHK)
+						{
+							if (nxt != nullptr)
+							{
+								nxt->Push(ENDCHK);
+							}
+
+							break;
+						}
+
+						Chunk &chk = stt->Chunks[idx];
+						start = std::chrono::steady_clock::now();
+						prc[i](chk);
+						sts.ActiveTime += static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+						sts.Bytes += chk.Length;
+						++sts.Chunks;
+
+						// the last stage returns the chunk to the free queue
+						if (nxt != nullptr)
+						{
+							nxt->Push(idx);
+						}
+						else
+						{
+							qus[0]->Push(idx);
+						}
+					}
+				}
+				catch (...)
+				{
+					fail(std::current_exception());
+				}
+			}));
+		}
+	}
+	catch (...)
+	{
+		fail(std::current_exception());
+	}
+
+	for (i = 0; i < thd.size(); ++i)
+	{
+		thd[i].join();
+	}
+
+	if (stt->Error != nullptr)
+	{
+		std::rethrow_exception(stt->Error);
+	}
+
+	if (stt->Digest != nullptr)
+	{
+		stt->Code.resize(stt->Digest->DigestSize());
+		stt->Digest->Finalize(stt->Code, 0);
+	}
+	else if (stt->Mac != nullptr)
+	{
+		stt->Code.resize(stt->Mac->TagSize());
+		stt->Mac->Finalize(stt->Code, 0);
+	}
+	else
+	{
+		// misra
+	}
+}
+
+PipelineStatistics CipherPipeline::Statistics(PipelineStages Stage)
+{
+	return m_pipelineState->Statistics[static_cast<size_t>(Stage)];
+}
+
+void CipherPipeline::Transform(ICipherMode* Cipher)
+{
+	m_pipelineState->Mode = Cipher;
+	m_pipelineState->Stream = nullptr;
+}
+
+void CipherPipeline::Transform(IStreamCipher* Cipher)
+{
+	if (Cipher != nullptr && Cipher->IsAuthenticator())
+	{
+		throw CryptoProcessingException(CLASS_NAME, std::string("Transform"), std::string("Authenticated stream ciphers are not supported; use the authentication stage!"), ErrorCodes::NotSupported);
+	}
+
+	m_pipelineState->Mode = nullptr;
+	m_pipelineState->Stream = Cipher;
+}
+
+NAMESPACE_PROCESSINGEND
@@ -0,0 +1,235 @@
+// The GPL version 3 License (GPLv3)
+//
+// Copyright (c) 2023 QSCS.ca
+// This file is part of the CEX Cryptographic library.
+//
+// This program is free software : you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef CEX_CIPHERPIPELINE_H
+#define CEX_CIPHERPIPELINE_H
+
+#include "CexDomain.h"
+#include "CryptoProcessingException.h"
+#include "IByteStream.h"
+#include "ICipherMode.h"
+#include "IDigest.h"
+#include "IMac.h"
+#include "IStreamCipher.h"
+#include "PipelineStages.h"
+#include <array>
+#include <memory>
+
+NAMESPACE_PROCESSING
+
+using Exception::CryptoProcessingException;
+using Cipher::Block::Mode::ICipherMode;
+using Digest::IDigest;
+using IO::IByteStream;
+using Mac::IMac;
+using Enumeration::PipelineStages;
+using Cipher::Stream::IStreamCipher;
+
+/// <summary>
+/// The throughput counters of one CipherPipeline stage, measured during the last Run()
+/// </summary>
+struct PipelineStatistics
+{
+	/// <summary>
+	/// The time the stage spent processing chunks, in nanoseconds
+	/// </summary>
+	uint64_t ActiveTime;
+	/// <summary>
+	/// The number of bytes processed by the stage
+	/// </summary>
+	uint64_t Bytes;
+	/// <summary>
+	/// The number of chunks processed by the stage
+	/// </summary>
+	uint64_t Chunks;
+	/// <summary>
+	/// The time the stage spent waiting for a chunk from the previous stage, or for a free chunk, in nanoseconds
+	/// </summary>
+	uint64_t StallTime;
+
+	PipelineStatistics()
+		:
+		ActiveTime(0),
+		Bytes(0),
+		Chunks(0),
+		StallTime(0)
+	{
+	}
+
+	/// <summary>
+	/// The stage throughput while active, in megabytes per second
+	/// </summary>
+	double Throughput() const
+	{
+		return (ActiveTime == 0) ? 0.0 : (static_cast<double>(Bytes) * 1000.0) / static_cast<double>(ActiveTime);
+	}
+};
+
+/// <summary>
+/// A multi-stage streaming pipeline; source, transform, authenticate and sink stages each run on their own thread, linked by bounded queues of recycled chunks.
+/// <para>The source stage reads a stream into fixed size chunks, the transform stage encrypts or decrypts each chunk with a cipher mode or stream cipher, 
+/// the authentication stage updates a digest or MAC with either the input or the output of the transform, and the sink stage writes the chunks to the output stream. 
+/// One pass over a large file or socket stream keeps the storage device, the cipher and the MAC busy at the same time. \n
+/// The pipeline owns a fixed set of QueueDepth() chunks that circulate between the stages; when every chunk is in use the source stage waits, 
+/// so a slow stage applies backpressure to the reader, and memory use is bounded by ChunkSize() * QueueDepth() regardless of the stream length.</para>
+/// </summary>
+///
+/// <example>
+/// <description>Encrypt-then-MAC a file in one pass:</description>
+/// <code>
+/// CTR cpr(BlockCiphers::AES);
+/// HMAC mac(SHA2Digests::SHA2256);
+/// cpr.Initialize(true, kp);
+/// mac.Initialize(mkp);
+///
+/// CipherPipeline ppl;
+/// ppl.Transform(&amp;cpr);
+/// ppl.Authenticate(&amp;mac);
+/// ppl.Run(&amp;fIn, &amp;fOut);
+/// std::vector&lt;uint8_t&gt; code = ppl.Code();
+/// </code>
+/// </example>
+///
+/// <remarks>
+/// <description>Implementation Notes:</description>
+/// <list type="bullet">
+/// <item><description>Every stage except the source is optional; a pipeline with only an authenticator computes the code of a stream, and a pipeline without a sink discards the output.</description></item>
+/// <item><description>The cipher and authenticator instances are not owned by the pipeline; they must be initialized before Run() and must not be used by another thread while it runs.</description></item>
+/// <item><description>If ChunkSize() is zero, the chunk size is the ParallelBlockSize() of the transform, so the transform stage also runs multi-threaded when the cipher is parallel.</description></item>
+/// <item><description>The block cipher modes other than CTR and ICM require the stream length to be a multiple of the block size; use CipherStream for a padded stream.</description></item>
+/// <item><description>Authenticated stream ciphers finalize a tag on every transform call, and are not supported; use an unauthenticated cipher with the authentication stage.</description></item>
+/// <item><description>An exception thrown by any stage stops the pipeline, and is re-thrown by Run().</description></item>
+/// </list>
+/// </remarks>
+class CipherPipeline final
+{
+private:
+
+	static const std::string CLASS_NAME;
+	static const size_t DEF_CHUNKSIZE = 65536;
+	static const size_t DEF_QUEUEDEPTH = 4;
+	static const size_t STAGE_COUNT = 4;
+
+	class ChunkQueue;
+	class PipelineState;
+	std::unique_ptr<PipelineState> m_pipelineState;
+
+public:
+
+	//~~~Constructor~~~//
+
+	/// <summary>
+	/// Copy constructor: copy is restricted, this function has been deleted
+	/// </summary>
+	CipherPipeline(const CipherPipeline&) = delete;
+
+	/// <summary>
+	/// Copy operator: copy is restricted, this function has been deleted
+	/// </summary>
+	CipherPipeline& operator=(const CipherPipeline&) = delete;
+
+	/// <summary>
+	/// Initialize the pipeline
+	/// </summary>
+	///
+	/// <param name="ChunkSize">The size of each chunk in bytes; zero selects the ParallelBlockSize() of the transform, or 64KB without a transform</param>
+	/// <param name="QueueDepth">The number of chunks circulating between the stages; at least 2</param>
+	///
+	/// <exception cref="CryptoProcessingException">Thrown if the queue depth is less than 2</exception>
+	explicit CipherPipeline(size_t ChunkSize = 0, size_t QueueDepth = DEF_QUEUEDEPTH);
+
+	/// <summary>
+	/// Destructor: finalize this class
+	/// </summary>
+	~CipherPipeline();
+
+	//~~~Accessors~~~//
+
+	/// <summary>
+	/// Read Only: The chunk size used by the last Run(), or the requested chunk size
+	/// </summary>
+	size_t ChunkSize();
+
+	/// <summary>
+	/// Read Only: The digest or MAC code computed by the last Run(); empty if the pipeline has no authenticator
+	/// </summary>
+	const std::vector<uint8_t> &Code();
+
+	/// <summary>
+	/// Read Only: The number of chunks circulating between the stages
+	/// </summary>
+	size_t QueueDepth();
+
+	//~~~Public Functions~~~//
+
+	/// <summary>
+	/// Set a digest as the authentication stage
+	/// </summary>
+	///
+	/// <param name="Digest">The digest instance, or nullptr to remove the stage</param>
+	/// <param name="TapInput">Hash the transform input instead of its output, i.e. the ciphertext when decrypting</param>
+	void Authenticate(IDigest* Digest, bool TapInput = false);
+
+	/// <summary>
+	/// Set an initialized MAC as the authentication stage
+	/// </summary>
+	///
+	/// <param name="Mac">The MAC instance, or nullptr to remove the stage</param>
+	/// <param name="TapInput">Authenticate the transform input instead of its output, i.e. the ciphertext when decrypting</param>
+	void Authenticate(IMac* Mac, bool TapInput = false);
+
+	/// <summary>
+	/// Process the source stream through the pipeline stages, and write the result to the sink stream.
+	/// <para>The source is read from its current position until a read returns no data.</para>
+	/// </summary>
+	///
+	/// <param name="Source">The source stream</param>
+	/// <param name="Sink">The sink stream, or nullptr to discard the output</param>
+	///
+	/// <exception cref="CryptoProcessingException">Thrown if the source is null, the chunk size is not aligned to the cipher block size, or a block mode receives a partial block</exception>
+	void Run(IByteStream* Source, IByteStream* Sink);
+
+	/// <summary>
+	/// Get the counters of a stage, measured during the last Run()
+	/// </summary>
+	///
+	/// <param name="Stage">The pipeline stage</param>
+	///
+	/// <returns>The stage counters; all zero if the stage was not used</returns>
+	PipelineStatistics Statistics(PipelineStages Stage);
+
+	/// <summary>
+	/// Set an initialized cipher mode as the transform stage
+	/// </summary>
+	///
+	/// <param name="Cipher">The cipher mode instance, or nullptr to remove the stage</param>
+	void Transform(ICipherMode* Cipher);
+
+	/// <summary>
+	/// Set an initialized stream cipher as the transform stage
+	/// </summary>
+	///
+	/// <param name="Cipher">The stream cipher instance, or nullptr to remove the stage</param>
+	///
+	/// <exception cref="CryptoProcessingException">Thrown if the stream cipher is an authenticator</exception>
+	void Transform(IStreamCipher* Cipher);
+};
+
+NAMESPACE_PROCESSINGEND
+#endif
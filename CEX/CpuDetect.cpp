@@ -335,6 +335,11 @@ const bool CpuDetect::SSE42()
 	return HasFeature(CpuidFlags::CPUID_SSE42); 
 }
 
+const bool CpuDetect::VAES()
+{
+	return HasFeature(CpuidFlags::CPUID_VAES);
+}
+
 CpuDetect::CpuVendors CpuDetect::Vendor()
 { 
 	return m_cpuVendor; 
@@ -379,6 +384,28 @@ bool CpuDetect::Avx2Enabled()
 	return status;
 }
 
+bool CpuDetect::Avx512Enabled()
+{
+	std::array<uint32_t, 4> cpuInfo = { 0 };
+	Cpuid(1, cpuInfo);
+	bool status = false;
+
+	// the xmm, ymm, opmask and both zmm register groups must all be enabled
+	if (((cpuInfo[2] & (1UL << 27)) != 0) && (cpuInfo[2] & (1UL << 28)) != 0)
+	{
+		status = (_xgetbv(_XCR_XFEATURE_ENABLED_MASK) & 0xE6) == 0xE6;
+	}
+
+	return status;
+}
+
+CpuDetect &CpuDetect::Instance()
+{
+	static CpuDetect dtc;
+
+	return dtc;
+}
+
 //~~~Private Functions~~~//
 
 void CpuDetect::BusInfo()
@@ -402,7 +429,7 @@ void CpuDetect::Cpuid(int32_t Flag, std::array<uint32_t, 4> &Output)
 #	if defined(CEX_COMPILER_MSC)
 	__cpuid(reinterpret_cast<int32_t*>(Output.data()), Flag);
 #	elif defined(CEX_COMPILER_GCC) || defined(CEX_COMPILER_CLANG)
-	__get_cpuid(Flag, Output[0], Output[1], Output[2], Output[3]);
+	__get_cpuid(Flag, &Output[0], &Output[1], &Output[2], &Output[3]);
 #	endif
 #endif
 }
@@ -571,6 +598,7 @@ void CpuDetect::PrintCpuStats()
 	std::cout << "SSE4A: " << BoolStr(SSE4A()) << std::endl;
 	std::cout << "SSE41: " << BoolStr(SSE41()) << std::endl;
 	std::cout << "SSE42: " << BoolStr(SSE42()) << std::endl;
+	std::cout << "VAES: " << BoolStr(VAES()) << std::endl;
 	std::cout << "Vendor: " << ((Vendor() == CpuVendors::UNKNOWN) ? "Unknown" : ((Vendor() == CpuVendors::AMD) ? "AMD" : "Intel")) << std::endl;
 	std::cout << "VirtualCores: " << VirtualCores() << std::endl;
 	std::cout << "XOP: " << BoolStr(XOP()) << std::endl;
@@ -68,6 +68,7 @@ private:
 		CPUID_SMAP = 64 + 20, // ebx 20
 		CPUID_SHA = 64 + 29, // ebx 29
 		CPUID_PREFETCH = 64 + 32, // ebx 32 -index 2, 3
+		CPUID_VAES = 96 + 9, // ecx 9
 		// EAX=80000001
 		CPUID_ABM = 128 + 5, // ecx 5
 		CPUID_SSE4A = 128 + 6, // ecx 6
@@ -422,6 +423,13 @@ public:
 	/// <returns>Returns true if the feature is available</returns>
 	const bool SSE42();
 
+	/// <summary>
+	/// Vector AES instructions available; the AES round instructions on 256 and 512-bit registers
+	/// </summary>
+	///
+	/// <returns>Returns true if the feature is available</returns>
+	const bool VAES();
+
 	/// <summary>
 	/// Returns the cpu vendors enumeration value
 	/// </summary>
@@ -457,6 +465,22 @@ public:
 	/// <returns>Returns true if the feature is available</returns>
 	static bool Avx2Enabled();
 
+	/// <summary>
+	/// Returns true if the operating system saves the AVX512 opmask and zmm register state
+	/// </summary>
+	///
+	/// <returns>Returns true if the state is enabled</returns>
+	static bool Avx512Enabled();
+
+	/// <summary>
+	/// Get the process-wide detection snapshot.
+	/// <para>CPUID, cache and core detection run once, on the first call, and are thread-safe; the instance is shared and must be treated as read-only.
+	/// Use this in place of constructing a CpuDetect in code that runs per object or per call.</para>
+	/// </summary>
+	///
+	/// <returns>Returns the shared CpuDetect instance</returns>
+	static CpuDetect &Instance();
+
 private:
 
 
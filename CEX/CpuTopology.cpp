@@ -0,0 +1,515 @@
+#include "CpuTopology.h"
+#include <fstream>
+#include <sstream>
+
+#if defined(CEX_OS_WINDOWS)
+#	include <Windows.h>
+#elif defined(CEX_OS_LINUX)
+#	include <pthread.h>
+#	include <sched.h>
+#	include <sys/syscall.h>
+#	include <unistd.h>
+#endif
+
+NAMESPACE_ROOT
+
+namespace
+{
+	// processors are hybrid when the slowest core is below this percentage of the fastest core
+	const size_t HYBRID_THRESHOLD = 90;
+	// the largest node number enumerated from the Windows node masks
+	const size_t MAX_NODES = 1024;
+#if defined(CEX_OS_LINUX)
+	// get_mempolicy flags: return the node of the page at the address
+	const int32_t MPOL_FLAG_NODE = 1;
+	const int32_t MPOL_FLAG_ADDR = 2;
+#endif
+}
+
+//~~~ Constructor~~~//
+
+CpuTopology::CpuTopology()
+	:
+	m_nodeIds(0),
+	m_nodeIndex(0),
+	m_nodeProcessors(0),
+	m_processorCapacity(0),
+	m_processorNodes(0)
+{
+	Initialize();
+	InitializeCapacity();
+}
+
+CpuTopology::~CpuTopology()
+{
+	m_nodeIds.clear();
+	m_nodeIndex.clear();
+	m_nodeProcessors.clear();
+	m_processorCapacity.clear();
+	m_processorNodes.clear();
+}
+
+//~~~ Properties~~~//
+
+const bool CpuTopology::IsHybrid()
+{
+	size_t i;
+	size_t maxc;
+	size_t minc;
+
+	maxc = 0;
+	minc = 0;
+
+	for (i = 0; i < m_processorCapacity.size(); ++i)
+	{
+		if (m_processorCapacity[i] != 0)
+		{
+			maxc = (m_processorCapacity[i] > maxc) ? m_processorCapacity[i] : maxc;
+			minc = (minc == 0 || m_processorCapacity[i] < minc) ? m_processorCapacity[i] : minc;
+		}
+	}
+
+	return (minc != 0 && minc * 100 < maxc * HYBRID_THRESHOLD);
+}
+
+const size_t CpuTopology::NodeCount()
+{
+	return m_nodeProcessors.size();
+}
+
+const int32_t CpuTopology::NodeId(size_t Node)
+{
+	int32_t res;
+
+	res = -1;
+
+	if (Node < m_nodeIds.size())
+	{
+		res = static_cast<int32_t>(m_nodeIds[Node]);
+	}
+
+	return res;
+}
+
+const int32_t CpuTopology::NodeIndex(int32_t NodeId)
+{
+	int32_t res;
+
+	res = -1;
+
+	if (NodeId >= 0 && static_cast<size_t>(NodeId) < m_nodeIndex.size())
+	{
+		res = m_nodeIndex[NodeId];
+	}
+
+	return res;
+}
+
+const std::vector<size_t> CpuTopology::NodeProcessors(size_t Node)
+{
+	std::vector<size_t> res(0);
+
+	if (Node < m_nodeProcessors.size())
+	{
+		res = m_nodeProcessors[Node];
+	}
+
+	return res;
+}
+
+const size_t CpuTopology::ProcessorCapacity(size_t Processor)
+{
+	size_t res;
+
+	res = 0;
+
+	if (Processor < m_processorCapacity.size())
+	{
+		res = m_processorCapacity[Processor];
+	}
+
+	return res;
+}
+
+const size_t CpuTopology::ProcessorCount()
+{
+	return m_processorNodes.size();
+}
+
+const int32_t CpuTopology::ProcessorNode(size_t Processor)
+{
+	int32_t res;
+
+	res = -1;
+
+	if (Processor < m_processorNodes.size())
+	{
+		res = m_processorNodes[Processor];
+	}
+
+	return res;
+}
+
+std::vector<size_t> CpuTopology::ScatterOrder()
+{
+	std::vector<size_t> res(0);
+	size_t i;
+	size_t j;
+	bool more;
+
+	more = true;
+
+	for (i = 0; more == true; ++i)
+	{
+		more = false;
+
+		for (j = 0; j < m_nodeProcessors.size(); ++j)
+		{
+			if (i < m_nodeProcessors[j].size())
+			{
+				res.push_back(m_nodeProcessors[j][i]);
+				more = true;
+			}
+		}
+	}
+
+	return res;
+}
+
+//~~~ Static Functions~~~//
+
+CpuTopology &CpuTopology::Instance()
+{
+	static CpuTopology topo;
+
+	return topo;
+}
+
+int32_t CpuTopology::CurrentNode()
+{
+	int32_t res;
+
+	res = -1;
+
+#if defined(CEX_OS_WINDOWS)
+	PROCESSOR_NUMBER pnum;
+	USHORT node;
+
+	GetCurrentProcessorNumberEx(&pnum);
+
+	if (GetNumaProcessorNodeEx(&pnum, &node) != 0 && node != 0xFFFF)
+	{
+		res = static_cast<int32_t>(node);
+	}
+#elif defined(CEX_OS_LINUX)
+	uint32_t cpu;
+	uint32_t node;
+
+	if (syscall(SYS_getcpu, &cpu, &node, nullptr) == 0)
+	{
+		res = static_cast<int32_t>(node);
+	}
+#endif
+
+	return res;
+}
+
+int32_t CpuTopology::MemoryNode(const void* Address)
+{
+	int32_t res;
+
+	res = -1;
+
+#if defined(CEX_OS_LINUX)
+	int32_t node;
+
+	node = -1;
+
+	if (Address != nullptr && syscall(SYS_get_mempolicy, &node, nullptr, 0, Address, MPOL_FLAG_NODE | MPOL_FLAG_ADDR) == 0)
+	{
+		res = node;
+	}
+#else
+	static_cast<void>(Address);
+#endif
+
+	return res;
+}
+
+bool CpuTopology::PinThread(std::thread &Thread, size_t Processor)
+{
+	bool res;
+
+	res = false;
+
+#if defined(CEX_OS_WINDOWS)
+	if (Processor < sizeof(DWORD_PTR) * 8)
+	{
+		res = (SetThreadAffinityMask(static_cast<HANDLE>(Thread.native_handle()), static_cast<DWORD_PTR>(1) << Processor) != 0);
+	}
+#elif defined(CEX_OS_LINUX)
+	cpu_set_t cset;
+
+	if (Processor < CPU_SETSIZE)
+	{
+		CPU_ZERO(&cset);
+		CPU_SET(Processor, &cset);
+		res = (pthread_setaffinity_np(Thread.native_handle(), sizeof(cpu_set_t), &cset) == 0);
+	}
+#else
+	static_cast<void>(Thread);
+	static_cast<void>(Processor);
+#endif
+
+	return res;
+}
+
+//~~~Private Functions~~~//
+
+void CpuTopology::Initialize()
+{
+	const size_t PRCCNT = static_cast<size_t>(std::thread::hardware_concurrency());
+	std::vector<size_t> prcs;
+	size_t i;
+	size_t j;
+
+#if defined(CEX_OS_WINDOWS)
+	ULONG hnode;
+	ULONGLONG mask;
+
+	if (GetNumaHighestNodeNumber(&hnode) != 0)
+	{
+		for (i = 0; i <= static_cast<size_t>(hnode) && i < MAX_NODES; ++i)
+		{
+			mask = 0;
+			prcs.clear();
+
+			if (GetNumaNodeProcessorMask(static_cast<UCHAR>(i), &mask) != 0)
+			{
+				for (j = 0; j < sizeof(mask) * 8; ++j)
+				{
+					if ((mask & (1ULL << j)) != 0)
+					{
+						prcs.push_back(j);
+					}
+				}
+			}
+
+			if (prcs.size() != 0)
+			{
+				m_nodeIds.push_back(i);
+				m_nodeProcessors.push_back(prcs);
+			}
+		}
+	}
+#elif defined(CEX_OS_LINUX)
+	std::vector<std::vector<size_t>> dsts;
+	std::vector<size_t> onln;
+	std::string list;
+	size_t dst;
+	size_t k;
+
+	// the online node list names the nodes that exist; node numbers can be sparse
+	std::ifstream fol("/sys/devices/system/node/online");
+
+	if (fol.is_open() && std::getline(fol, list))
+	{
+		onln = ParseList(list);
+	}
+
+	for (i = 0; i < onln.size(); ++i)
+	{
+		const std::string NPTH = "/sys/devices/system/node/node" + std::to_string(onln[i]);
+		std::vector<size_t> dstv(0);
+		std::ifstream fcl(NPTH + "/cpulist");
+		std::ifstream fds(NPTH + "/distance");
+
+		prcs.clear();
+
+		if (fcl.is_open() && std::getline(fcl, list))
+		{
+			prcs = ParseList(list);
+		}
+
+		// the distances to each online node, in online list order
+		while (fds.is_open() && (fds >> dst))
+		{
+			dstv.push_back(dst);
+		}
+
+		dsts.push_back(dstv);
+
+		if (prcs.size() != 0)
+		{
+			m_nodeIds.push_back(onln[i]);
+			m_nodeProcessors.push_back(prcs);
+		}
+	}
+#endif
+
+	// no topology available; a single node holding every processor
+	if (m_nodeProcessors.size() == 0)
+	{
+		prcs.clear();
+
+		for (i = 0; i < ((PRCCNT != 0) ? PRCCNT : 1); ++i)
+		{
+			prcs.push_back(i);
+		}
+
+		m_nodeIds.clear();
+		m_nodeIds.push_back(0);
+		m_nodeProcessors.push_back(prcs);
+	}
+
+	for (i = 0; i < m_nodeProcessors.size(); ++i)
+	{
+		if (m_nodeIds[i] >= m_nodeIndex.size())
+		{
+			m_nodeIndex.resize(m_nodeIds[i] + 1, -1);
+		}
+
+		m_nodeIndex[m_nodeIds[i]] = static_cast<int32_t>(i);
+
+		for (j = 0; j < m_nodeProcessors[i].size(); ++j)
+		{
+			if (m_nodeProcessors[i][j] >= m_processorNodes.size())
+			{
+				m_processorNodes.resize(m_nodeProcessors[i][j] + 1, -1);
+			}
+
+			m_processorNodes[m_nodeProcessors[i][j]] = static_cast<int32_t>(i);
+		}
+	}
+
+#if defined(CEX_OS_LINUX)
+	// a node with memory but no processors (memory expansion or a memoryless socket) maps to its nearest node with processors
+	for (i = 0; i < onln.size(); ++i)
+	{
+		if (onln[i] >= m_nodeIndex.size())
+		{
+			m_nodeIndex.resize(onln[i] + 1, -1);
+		}
+
+		if (m_nodeIndex[onln[i]] < 0)
+		{
+			dst = 0;
+
+			for (j = 0; j < dsts[i].size() && j < onln.size(); ++j)
+			{
+				k = onln[j];
+
+				if (k < m_nodeIndex.size() && m_nodeIndex[k] >= 0 && (dst == 0 || dsts[i][j] < dst))
+				{
+					dst = dsts[i][j];
+					m_nodeIndex[onln[i]] = m_nodeIndex[k];
+				}
+			}
+		}
+	}
+#endif
+}
+
+void CpuTopology::InitializeCapacity()
+{
+	size_t i;
+
+	m_processorCapacity.resize(m_processorNodes.size(), 0);
+
+#if defined(CEX_OS_WINDOWS)
+	std::vector<uint8_t> buf;
+	SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX* inf;
+	DWORD len;
+	size_t pos;
+
+	len = 0;
+	GetLogicalProcessorInformationEx(RelationProcessorCore, nullptr, &len);
+
+	if (len != 0)
+	{
+		buf.resize(len);
+
+		if (GetLogicalProcessorInformationEx(RelationProcessorCore, reinterpret_cast<SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*>(buf.data()), &len) != 0)
+		{
+			for (pos = 0; pos < len; pos += inf->Size)
+			{
+				inf = reinterpret_cast<SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*>(buf.data() + pos);
+
+				// the efficiency class is zero on homogeneous processors, higher classes are the faster cores
+				for (i = 0; i < sizeof(KAFFINITY) * 8; ++i)
+				{
+					if (inf->Processor.GroupMask[0].Group == 0 && (inf->Processor.GroupMask[0].Mask & (static_cast<KAFFINITY>(1) << i)) != 0 && i < m_processorCapacity.size())
+					{
+						m_processorCapacity[i] = static_cast<size_t>(inf->Processor.EfficiencyClass) + 1;
+					}
+				}
+			}
+		}
+	}
+#elif defined(CEX_OS_LINUX)
+	std::string cpth;
+	size_t cap;
+
+	for (i = 0; i < m_processorCapacity.size(); ++i)
+	{
+		cap = 0;
+		cpth = "/sys/devices/system/cpu/cpu" + std::to_string(i);
+
+		// cpu_capacity is the scheduler's normalized core capacity, the maximum frequency is the fallback
+		std::ifstream fcap(cpth + "/cpu_capacity");
+
+		if (fcap.is_open() == false || !(fcap >> cap))
+		{
+			std::ifstream ffrq(cpth + "/cpufreq/cpuinfo_max_freq");
+
+			if (ffrq.is_open() == false || !(ffrq >> cap))
+			{
+				cap = 0;
+			}
+		}
+
+		m_processorCapacity[i] = cap;
+	}
+#else
+	static_cast<void>(i);
+#endif
+}
+
+std::vector<size_t> CpuTopology::ParseList(const std::string &List)
+{
+	// sysfs cpu lists are comma separated ranges, i.e. 0-3,8-11
+	std::vector<size_t> res(0);
+	std::stringstream ss(List);
+	std::string tok;
+	size_t dash;
+	size_t first;
+	size_t last;
+	size_t i;
+
+	while (std::getline(ss, tok, ','))
+	{
+		if (tok.size() != 0 && tok.find_first_of("0123456789") != std::string::npos)
+		{
+			dash = tok.find('-');
+
+			try
+			{
+				first = static_cast<size_t>(std::stoul(tok.substr(0, dash)));
+				last = (dash != std::string::npos) ? static_cast<size_t>(std::stoul(tok.substr(dash + 1))) : first;
+
+				for (i = first; i <= last; ++i)
+				{
+					res.push_back(i);
+				}
+			}
+			catch (std::exception&)
+			{
+				// misra
+			}
+		}
+	}
+
+	return res;
+}
+
+NAMESPACE_ROOTEND
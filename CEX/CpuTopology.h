@@ -0,0 +1,171 @@
+#ifndef CEX_CPUTOPOLOGY_H
+#define CEX_CPUTOPOLOGY_H
+
+#include "CexDomain.h"
+#include <thread>
+
+NAMESPACE_ROOT
+
+/// <summary>
+/// Detects the processor and NUMA node topology of the system.
+/// <para>On Linux the node layout is read from sysfs (/sys/devices/system/node), on Windows from the NUMA processor masks.
+/// The nodes that contain processors are numbered consecutively from zero; the operating system node numbers, which can be sparse, are mapped to those indices with NodeIndex.
+/// A node that has memory but no processors maps to its nearest node that has them. \n
+/// When the topology can not be read, the system is reported as a single node containing every logical processor.
+/// The relative capacity of each processor is read from the Linux cpu_capacity (or cpufreq maximum frequency) entries, or the Windows core efficiency class, 
+/// and is used to detect hybrid processors that combine performance and efficiency cores.</para>
+/// </summary>
+class CpuTopology
+{
+private:
+
+	std::vector<size_t> m_nodeIds;
+	std::vector<int32_t> m_nodeIndex;
+	std::vector<std::vector<size_t>> m_nodeProcessors;
+	std::vector<size_t> m_processorCapacity;
+	std::vector<int32_t> m_processorNodes;
+
+public:
+
+	//~~~ Constructor~~~//
+
+	/// <summary>
+	/// Copy constructor: copy is restricted, this function has been deleted
+	/// </summary>
+	CpuTopology(const CpuTopology&) = delete;
+
+	/// <summary>
+	/// Copy operator: copy is restricted, this function has been deleted
+	/// </summary>
+	CpuTopology& operator=(const CpuTopology&) = delete;
+
+	/// <summary>
+	/// Initialization: reads the processor and node topology
+	/// </summary>
+	CpuTopology();
+
+	/// <summary>
+	/// Finalize this class and clear resources
+	/// </summary>
+	~CpuTopology();
+
+	//~~~ Properties~~~//
+
+	/// <summary>
+	/// The processor has cores of more than one performance class, i.e. performance and efficiency cores
+	/// </summary>
+	///
+	/// <returns>Returns true if the processor capacities differ by more than the hybrid threshold</returns>
+	const bool IsHybrid();
+
+	/// <summary>
+	/// The number of NUMA nodes that contain processors
+	/// </summary>
+	///
+	/// <returns>Returns the node count, a minimum of one</returns>
+	const size_t NodeCount();
+
+	/// <summary>
+	/// The operating system number of a NUMA node
+	/// </summary>
+	///
+	/// <param name="Node">The node index</param>
+	///
+	/// <returns>Returns the operating system node number, or -1 if the node does not exist</returns>
+	const int32_t NodeId(size_t Node);
+
+	/// <summary>
+	/// The node index of an operating system NUMA node number, as returned by CurrentNode or MemoryNode.
+	/// <para>A node without processors returns the index of its nearest node with processors.</para>
+	/// </summary>
+	///
+	/// <param name="NodeId">The operating system node number</param>
+	///
+	/// <returns>Returns the node index, or -1 if the node is unknown</returns>
+	const int32_t NodeIndex(int32_t NodeId);
+
+	/// <summary>
+	/// The logical processor indices belonging to a NUMA node
+	/// </summary>
+	///
+	/// <param name="Node">The node index</param>
+	///
+	/// <returns>Returns the nodes processor list; empty if the node does not exist</returns>
+	const std::vector<size_t> NodeProcessors(size_t Node);
+
+	/// <summary>
+	/// The relative performance capacity of a logical processor; a larger value is a faster core
+	/// </summary>
+	///
+	/// <param name="Processor">The logical processor index</param>
+	///
+	/// <returns>Returns the processor capacity, or zero if it can not be determined</returns>
+	const size_t ProcessorCapacity(size_t Processor);
+
+	/// <summary>
+	/// The total number of logical processors in the topology
+	/// </summary>
+	///
+	/// <returns>Returns the logical processor count</returns>
+	const size_t ProcessorCount();
+
+	/// <summary>
+	/// The NUMA node a logical processor belongs to
+	/// </summary>
+	///
+	/// <param name="Processor">The logical processor index</param>
+	///
+	/// <returns>Returns the node index, or -1 if the processor is unknown</returns>
+	const int32_t ProcessorNode(size_t Processor);
+
+	/// <summary>
+	/// The logical processors ordered so that consecutive entries alternate between NUMA nodes
+	/// </summary>
+	///
+	/// <returns>Returns the interleaved processor list</returns>
+	std::vector<size_t> ScatterOrder();
+
+	//~~~ Static Functions~~~//
+
+	/// <summary>
+	/// Get the process-wide topology snapshot.
+	/// <para>The topology is read once, on first use; the instance is shared and must be treated as read-only.</para>
+	/// </summary>
+	static CpuTopology &Instance();
+
+	/// <summary>
+	/// The NUMA node of the processor running the calling thread
+	/// </summary>
+	///
+	/// <returns>Returns the operating system node number, or -1 if it can not be determined</returns>
+	static int32_t CurrentNode();
+
+	/// <summary>
+	/// The NUMA node that owns the memory page containing an address.
+	/// <para>A page that has not been touched yet has no owning node.</para>
+	/// </summary>
+	///
+	/// <param name="Address">The memory address</param>
+	///
+	/// <returns>Returns the operating system node number, or -1 if it can not be determined</returns>
+	static int32_t MemoryNode(const void* Address);
+
+	/// <summary>
+	/// Restrict a thread to run on a single logical processor
+	/// </summary>
+	///
+	/// <param name="Thread">The thread to pin</param>
+	/// <param name="Processor">The logical processor index</param>
+	///
+	/// <returns>Returns true if the affinity was set</returns>
+	static bool PinThread(std::thread &Thread, size_t Processor);
+
+private:
+
+	void Initialize();
+	void InitializeCapacity();
+	static std::vector<size_t> ParseList(const std::string &List);
+};
+
+NAMESPACE_ROOTEND
+#endif
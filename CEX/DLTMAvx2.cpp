@@ -0,0 +1,607 @@
+#include "DLTMKernels.h"
+#if defined(CEX_HAS_AVX2)
+#	include "Intrinsics.h"
+#else
+#	include "CryptoAsymmetricException.h"
+#endif
+
+NAMESPACE_DILITHIUM
+
+// this unit is compiled with the AVX2 code generation flag; it includes no shared header with instruction set branches,
+// and the polynomial routines have internal linkage, so no inline code compiled here can be linked into another unit
+
+#if defined(CEX_HAS_AVX2)
+namespace
+{
+	const size_t DILITHIUM_N = 256;
+	const int32_t DILITHIUM_Q = 8380417;
+	const int32_t DILITHIUM_D = 13;
+
+	const uint8_t RejIdx[256][8] =
+	{
+		{ 0,  0,  0,  0,  0,  0,  0,  0}, { 0,  0,  0,  0,  0,  0,  0,  0}, { 1,  0,  0,  0,  0,  0,  0,  0}, { 0,  1,  0,  0,  0,  0,  0,  0},
+		{ 2,  0,  0,  0,  0,  0,  0,  0}, { 0,  2,  0,  0,  0,  0,  0,  0}, { 1,  2,  0,  0,  0,  0,  0,  0}, { 0,  1,  2,  0,  0,  0,  0,  0},
+		{ 3,  0,  0,  0,  0,  0,  0,  0}, { 0,  3,  0,  0,  0,  0,  0,  0}, { 1,  3,  0,  0,  0,  0,  0,  0}, { 0,  1,  3,  0,  0,  0,  0,  0},
+		{ 2,  3,  0,  0,  0,  0,  0,  0}, { 0,  2,  3,  0,  0,  0,  0,  0}, { 1,  2,  3,  0,  0,  0,  0,  0}, { 0,  1,  2,  3,  0,  0,  0,  0},
+		{ 4,  0,  0,  0,  0,  0,  0,  0}, { 0,  4,  0,  0,  0,  0,  0,  0}, { 1,  4,  0,  0,  0,  0,  0,  0}, { 0,  1,  4,  0,  0,  0,  0,  0},
+		{ 2,  4,  0,  0,  0,  0,  0,  0}, { 0,  2,  4,  0,  0,  0,  0,  0}, { 1,  2,  4,  0,  0,  0,  0,  0}, { 0,  1,  2,  4,  0,  0,  0,  0},
+		{ 3,  4,  0,  0,  0,  0,  0,  0}, { 0,  3,  4,  0,  0,  0,  0,  0}, { 1,  3,  4,  0,  0,  0,  0,  0}, { 0,  1,  3,  4,  0,  0,  0,  0},
+		{ 2,  3,  4,  0,  0,  0,  0,  0}, { 0,  2,  3,  4,  0,  0,  0,  0}, { 1,  2,  3,  4,  0,  0,  0,  0}, { 0,  1,  2,  3,  4,  0,  0,  0},
+		{ 5,  0,  0,  0,  0,  0,  0,  0}, { 0,  5,  0,  0,  0,  0,  0,  0}, { 1,  5,  0,  0,  0,  0,  0,  0}, { 0,  1,  5,  0,  0,  0,  0,  0},
+		{ 2,  5,  0,  0,  0,  0,  0,  0}, { 0,  2,  5,  0,  0,  0,  0,  0}, { 1,  2,  5,  0,  0,  0,  0,  0}, { 0,  1,  2,  5,  0,  0,  0,  0},
+		{ 3,  5,  0,  0,  0,  0,  0,  0}, { 0,  3,  5,  0,  0,  0,  0,  0}, { 1,  3,  5,  0,  0,  0,  0,  0}, { 0,  1,  3,  5,  0,  0,  0,  0},
+		{ 2,  3,  5,  0,  0,  0,  0,  0}, { 0,  2,  3,  5,  0,  0,  0,  0}, { 1,  2,  3,  5,  0,  0,  0,  0}, { 0,  1,  2,  3,  5,  0,  0,  0},
+		{ 4,  5,  0,  0,  0,  0,  0,  0}, { 0,  4,  5,  0,  0,  0,  0,  0}, { 1,  4,  5,  0,  0,  0,  0,  0}, { 0,  1,  4,  5,  0,  0,  0,  0},
+		{ 2,  4,  5,  0,  0,  0,  0,  0}, { 0,  2,  4,  5,  0,  0,  0,  0}, { 1,  2,  4,  5,  0,  0,  0,  0}, { 0,  1,  2,  4,  5,  0,  0,  0},
+		{ 3,  4,  5,  0,  0,  0,  0,  0}, { 0,  3,  4,  5,  0,  0,  0,  0}, { 1,  3,  4,  5,  0,  0,  0,  0}, { 0,  1,  3,  4,  5,  0,  0,  0},
+		{ 2,  3,  4,  5,  0,  0,  0,  0}, { 0,  2,  3,  4,  5,  0,  0,  0}, { 1,  2,  3,  4,  5,  0,  0,  0}, { 0,  1,  2,  3,  4,  5,  0,  0},
+		{ 6,  0,  0,  0,  0,  0,  0,  0}, { 0,  6,  0,  0,  0,  0,  0,  0}, { 1,  6,  0,  0,  0,  0,  0,  0}, { 0,  1,  6,  0,  0,  0,  0,  0},
+		{ 2,  6,  0,  0,  0,  0,  0,  0}, { 0,  2,  6,  0,  0,  0,  0,  0}, { 1,  2,  6,  0,  0,  0,  0,  0}, { 0,  1,  2,  6,  0,  0,  0,  0},
+		{ 3,  6,  0,  0,  0,  0,  0,  0}, { 0,  3,  6,  0,  0,  0,  0,  0}, { 1,  3,  6,  0,  0,  0,  0,  0}, { 0,  1,  3,  6,  0,  0,  0,  0},
+		{ 2,  3,  6,  0,  0,  0,  0,  0}, { 0,  2,  3,  6,  0,  0,  0,  0}, { 1,  2,  3,  6,  0,  0,  0,  0}, { 0,  1,  2,  3,  6,  0,  0,  0},
+		{ 4,  6,  0,  0,  0,  0,  0,  0}, { 0,  4,  6,  0,  0,  0,  0,  0}, { 1,  4,  6,  0,  0,  0,  0,  0}, { 0,  1,  4,  6,  0,  0,  0,  0},
+		{ 2,  4,  6,  0,  0,  0,  0,  0}, { 0,  2,  4,  6,  0,  0,  0,  0}, { 1,  2,  4,  6,  0,  0,  0,  0}, { 0,  1,  2,  4,  6,  0,  0,  0},
+		{ 3,  4,  6,  0,  0,  0,  0,  0}, { 0,  3,  4,  6,  0,  0,  0,  0}, { 1,  3,  4,  6,  0,  0,  0,  0}, { 0,  1,  3,  4,  6,  0,  0,  0},
+		{ 2,  3,  4,  6,  0,  0,  0,  0}, { 0,  2,  3,  4,  6,  0,  0,  0}, { 1,  2,  3,  4,  6,  0,  0,  0}, { 0,  1,  2,  3,  4,  6,  0,  0},
+		{ 5,  6,  0,  0,  0,  0,  0,  0}, { 0,  5,  6,  0,  0,  0,  0,  0}, { 1,  5,  6,  0,  0,  0,  0,  0}, { 0,  1,  5,  6,  0,  0,  0,  0},
+		{ 2,  5,  6,  0,  0,  0,  0,  0}, { 0,  2,  5,  6,  0,  0,  0,  0}, { 1,  2,  5,  6,  0,  0,  0,  0}, { 0,  1,  2,  5,  6,  0,  0,  0},
+		{ 3,  5,  6,  0,  0,  0,  0,  0}, { 0,  3,  5,  6,  0,  0,  0,  0}, { 1,  3,  5,  6,  0,  0,  0,  0}, { 0,  1,  3,  5,  6,  0,  0,  0},
+		{ 2,  3,  5,  6,  0,  0,  0,  0}, { 0,  2,  3,  5,  6,  0,  0,  0}, { 1,  2,  3,  5,  6,  0,  0,  0}, { 0,  1,  2,  3,  5,  6,  0,  0},
+		{ 4,  5,  6,  0,  0,  0,  0,  0}, { 0,  4,  5,  6,  0,  0,  0,  0}, { 1,  4,  5,  6,  0,  0,  0,  0}, { 0,  1,  4,  5,  6,  0,  0,  0},
+		{ 2,  4,  5,  6,  0,  0,  0,  0}, { 0,  2,  4,  5,  6,  0,  0,  0}, { 1,  2,  4,  5,  6,  0,  0,  0}, { 0,  1,  2,  4,  5,  6,  0,  0},
+		{ 3,  4,  5,  6,  0,  0,  0,  0}, { 0,  3,  4,  5,  6,  0,  0,  0}, { 1,  3,  4,  5,  6,  0,  0,  0}, { 0,  1,  3,  4,  5,  6,  0,  0},
+		{ 2,  3,  4,  5,  6,  0,  0,  0}, { 0,  2,  3,  4,  5,  6,  0,  0}, { 1,  2,  3,  4,  5,  6,  0,  0}, { 0,  1,  2,  3,  4,  5,  6,  0},
+		{ 7,  0,  0,  0,  0,  0,  0,  0}, { 0,  7,  0,  0,  0,  0,  0,  0}, { 1,  7,  0,  0,  0,  0,  0,  0}, { 0,  1,  7,  0,  0,  0,  0,  0},
+		{ 2,  7,  0,  0,  0,  0,  0,  0}, { 0,  2,  7,  0,  0,  0,  0,  0}, { 1,  2,  7,  0,  0,  0,  0,  0}, { 0,  1,  2,  7,  0,  0,  0,  0},
+		{ 3,  7,  0,  0,  0,  0,  0,  0}, { 0,  3,  7,  0,  0,  0,  0,  0}, { 1,  3,  7,  0,  0,  0,  0,  0}, { 0,  1,  3,  7,  0,  0,  0,  0},
+		{ 2,  3,  7,  0,  0,  0,  0,  0}, { 0,  2,  3,  7,  0,  0,  0,  0}, { 1,  2,  3,  7,  0,  0,  0,  0}, { 0,  1,  2,  3,  7,  0,  0,  0},
+		{ 4,  7,  0,  0,  0,  0,  0,  0}, { 0,  4,  7,  0,  0,  0,  0,  0}, { 1,  4,  7,  0,  0,  0,  0,  0}, { 0,  1,  4,  7,  0,  0,  0,  0},
+		{ 2,  4,  7,  0,  0,  0,  0,  0}, { 0,  2,  4,  7,  0,  0,  0,  0}, { 1,  2,  4,  7,  0,  0,  0,  0}, { 0,  1,  2,  4,  7,  0,  0,  0},
+		{ 3,  4,  7,  0,  0,  0,  0,  0}, { 0,  3,  4,  7,  0,  0,  0,  0}, { 1,  3,  4,  7,  0,  0,  0,  0}, { 0,  1,  3,  4,  7,  0,  0,  0},
+		{ 2,  3,  4,  7,  0,  0,  0,  0}, { 0,  2,  3,  4,  7,  0,  0,  0}, { 1,  2,  3,  4,  7,  0,  0,  0}, { 0,  1,  2,  3,  4,  7,  0,  0},
+		{ 5,  7,  0,  0,  0,  0,  0,  0}, { 0,  5,  7,  0,  0,  0,  0,  0}, { 1,  5,  7,  0,  0,  0,  0,  0}, { 0,  1,  5,  7,  0,  0,  0,  0},
+		{ 2,  5,  7,  0,  0,  0,  0,  0}, { 0,  2,  5,  7,  0,  0,  0,  0}, { 1,  2,  5,  7,  0,  0,  0,  0}, { 0,  1,  2,  5,  7,  0,  0,  0},
+		{ 3,  5,  7,  0,  0,  0,  0,  0}, { 0,  3,  5,  7,  0,  0,  0,  0}, { 1,  3,  5,  7,  0,  0,  0,  0}, { 0,  1,  3,  5,  7,  0,  0,  0},
+		{ 2,  3,  5,  7,  0,  0,  0,  0}, { 0,  2,  3,  5,  7,  0,  0,  0}, { 1,  2,  3,  5,  7,  0,  0,  0}, { 0,  1,  2,  3,  5,  7,  0,  0},
+		{ 4,  5,  7,  0,  0,  0,  0,  0}, { 0,  4,  5,  7,  0,  0,  0,  0}, { 1,  4,  5,  7,  0,  0,  0,  0}, { 0,  1,  4,  5,  7,  0,  0,  0},
+		{ 2,  4,  5,  7,  0,  0,  0,  0}, { 0,  2,  4,  5,  7,  0,  0,  0}, { 1,  2,  4,  5,  7,  0,  0,  0}, { 0,  1,  2,  4,  5,  7,  0,  0},
+		{ 3,  4,  5,  7,  0,  0,  0,  0}, { 0,  3,  4,  5,  7,  0,  0,  0}, { 1,  3,  4,  5,  7,  0,  0,  0}, { 0,  1,  3,  4,  5,  7,  0,  0},
+		{ 2,  3,  4,  5,  7,  0,  0,  0}, { 0,  2,  3,  4,  5,  7,  0,  0}, { 1,  2,  3,  4,  5,  7,  0,  0}, { 0,  1,  2,  3,  4,  5,  7,  0},
+		{ 6,  7,  0,  0,  0,  0,  0,  0}, { 0,  6,  7,  0,  0,  0,  0,  0}, { 1,  6,  7,  0,  0,  0,  0,  0}, { 0,  1,  6,  7,  0,  0,  0,  0},
+		{ 2,  6,  7,  0,  0,  0,  0,  0}, { 0,  2,  6,  7,  0,  0,  0,  0}, { 1,  2,  6,  7,  0,  0,  0,  0}, { 0,  1,  2,  6,  7,  0,  0,  0},
+		{ 3,  6,  7,  0,  0,  0,  0,  0}, { 0,  3,  6,  7,  0,  0,  0,  0}, { 1,  3,  6,  7,  0,  0,  0,  0}, { 0,  1,  3,  6,  7,  0,  0,  0},
+		{ 2,  3,  6,  7,  0,  0,  0,  0}, { 0,  2,  3,  6,  7,  0,  0,  0}, { 1,  2,  3,  6,  7,  0,  0,  0}, { 0,  1,  2,  3,  6,  7,  0,  0},
+		{ 4,  6,  7,  0,  0,  0,  0,  0}, { 0,  4,  6,  7,  0,  0,  0,  0}, { 1,  4,  6,  7,  0,  0,  0,  0}, { 0,  1,  4,  6,  7,  0,  0,  0},
+		{ 2,  4,  6,  7,  0,  0,  0,  0}, { 0,  2,  4,  6,  7,  0,  0,  0}, { 1,  2,  4,  6,  7,  0,  0,  0}, { 0,  1,  2,  4,  6,  7,  0,  0},
+		{ 3,  4,  6,  7,  0,  0,  0,  0}, { 0,  3,  4,  6,  7,  0,  0,  0}, { 1,  3,  4,  6,  7,  0,  0,  0}, { 0,  1,  3,  4,  6,  7,  0,  0},
+		{ 2,  3,  4,  6,  7,  0,  0,  0}, { 0,  2,  3,  4,  6,  7,  0,  0}, { 1,  2,  3,  4,  6,  7,  0,  0}, { 0,  1,  2,  3,  4,  6,  7,  0},
+		{ 5,  6,  7,  0,  0,  0,  0,  0}, { 0,  5,  6,  7,  0,  0,  0,  0}, { 1,  5,  6,  7,  0,  0,  0,  0}, { 0,  1,  5,  6,  7,  0,  0,  0},
+		{ 2,  5,  6,  7,  0,  0,  0,  0}, { 0,  2,  5,  6,  7,  0,  0,  0}, { 1,  2,  5,  6,  7,  0,  0,  0}, { 0,  1,  2,  5,  6,  7,  0,  0},
+		{ 3,  5,  6,  7,  0,  0,  0,  0}, { 0,  3,  5,  6,  7,  0,  0,  0}, { 1,  3,  5,  6,  7,  0,  0,  0}, { 0,  1,  3,  5,  6,  7,  0,  0},
+		{ 2,  3,  5,  6,  7,  0,  0,  0}, { 0,  2,  3,  5,  6,  7,  0,  0}, { 1,  2,  3,  5,  6,  7,  0,  0}, { 0,  1,  2,  3,  5,  6,  7,  0},
+		{ 4,  5,  6,  7,  0,  0,  0,  0}, { 0,  4,  5,  6,  7,  0,  0,  0}, { 1,  4,  5,  6,  7,  0,  0,  0}, { 0,  1,  4,  5,  6,  7,  0,  0},
+		{ 2,  4,  5,  6,  7,  0,  0,  0}, { 0,  2,  4,  5,  6,  7,  0,  0}, { 1,  2,  4,  5,  6,  7,  0,  0}, { 0,  1,  2,  4,  5,  6,  7,  0},
+		{ 3,  4,  5,  6,  7,  0,  0,  0}, { 0,  3,  4,  5,  6,  7,  0,  0}, { 1,  3,  4,  5,  6,  7,  0,  0}, { 0,  1,  3,  4,  5,  6,  7,  0},
+		{ 2,  3,  4,  5,  6,  7,  0,  0}, { 0,  2,  3,  4,  5,  6,  7,  0}, { 1,  2,  3,  4,  5,  6,  7,  0}, { 0,  1,  2,  3,  4,  5,  6,  7}
+	};
+
+	inline __m256i BlendV32(__m256i A, __m256i B, __m256i Mask)
+	{
+		return _mm256_castps_si256(_mm256_blendv_ps(_mm256_castsi256_ps(A), _mm256_castsi256_ps(B), _mm256_castsi256_ps(Mask)));
+	}
+
+	void PolyAdd(int32_t* C, const int32_t* A, const int32_t* B)
+	{
+		__m256i vec0;
+		__m256i vec1;
+
+		for (size_t i = 0; i < DILITHIUM_N; i += 8)
+		{
+			vec0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&A[i]));
+			vec1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&B[i]));
+			vec0 = _mm256_add_epi32(vec0, vec1);
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(&C[i]), vec0);
+		}
+	}
+
+	void PolyCaddQ(int32_t* A)
+	{
+		const __m256i q = _mm256_set1_epi32(DILITHIUM_Q);
+		const __m256i zero = _mm256_setzero_si256();
+		__m256i f;
+		__m256i g;
+
+		for (size_t i = 0; i < DILITHIUM_N; i += 8)
+		{
+			f = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&A[i]));
+			g = BlendV32(zero, q, f);
+			f = _mm256_add_epi32(f, g);
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(&A[i]), f);
+		}
+	}
+
+	int32_t PolyChkNorm(const int32_t* A, uint32_t B)
+	{
+		const __m256i bound = _mm256_set1_epi32(B - 1);
+		__m256i f;
+		__m256i t;
+		int32_t r;
+
+		if (B > (DILITHIUM_Q - 1) / 8)
+		{
+			r = 1;
+		}
+		else
+		{
+			t = _mm256_setzero_si256();
+
+			for (size_t i = 0; i < DILITHIUM_N; i += 8)
+			{
+				f = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&A[i]));
+				f = _mm256_abs_epi32(f);
+				f = _mm256_cmpgt_epi32(f, bound);
+				t = _mm256_or_si256(t, f);
+			}
+
+			r = _mm256_testz_si256(t, t) == 0 ? 1 : 0;
+		}
+
+		return r;
+	}
+
+	void PolyDecompose(int32_t* A1, int32_t* A0, const int32_t* A, uint32_t Gamma2)
+	{
+		const __m256i q = _mm256_set1_epi32(DILITHIUM_Q);
+		const __m256i hq = _mm256_srli_epi32(q, 1);
+		const __m256i alpha = _mm256_set1_epi32(2 * Gamma2);
+		const __m256i off = _mm256_set1_epi32(127);
+		__m256i f;
+		__m256i f0;
+		__m256i f1;
+		__m256i t;
+
+		if (Gamma2 == (DILITHIUM_Q - 1) / 32)
+		{
+			const __m256i v = _mm256_set1_epi32(1025);
+			const __m256i shift = _mm256_set1_epi32(512);
+			const __m256i mask = _mm256_set1_epi32(15);
+
+			for (size_t i = 0; i < DILITHIUM_N; i += 8)
+			{
+				f = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&A[i]));
+				f1 = _mm256_add_epi32(f, off);
+				f1 = _mm256_srli_epi32(f1, 7);
+				f1 = _mm256_mulhi_epu16(f1, v);
+				f1 = _mm256_mulhrs_epi16(f1, shift);
+				f1 = _mm256_and_si256(f1, mask);
+				f0 = _mm256_mullo_epi32(f1, alpha);
+				f0 = _mm256_sub_epi32(f, f0);
+				f = _mm256_cmpgt_epi32(f0, hq);
+				f = _mm256_and_si256(f, q);
+				f0 = _mm256_sub_epi32(f0, f);
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(&A1[i]), f1);
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(&A0[i]), f0);
+			}
+		}
+		else if (Gamma2 == (DILITHIUM_Q - 1) / 88)
+		{
+			const __m256i v = _mm256_set1_epi32(11275);
+			const __m256i shift = _mm256_set1_epi32(128);
+			const __m256i max = _mm256_set1_epi32(43);
+			const __m256i zero = _mm256_setzero_si256();
+
+			for (size_t i = 0; i < DILITHIUM_N; i += 8)
+			{
+				f = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&A[i]));
+				f1 = _mm256_add_epi32(f, off);
+				f1 = _mm256_srli_epi32(f1, 7);
+				f1 = _mm256_mulhi_epu16(f1, v);
+				f1 = _mm256_mulhrs_epi16(f1, shift);
+				t = _mm256_cmpgt_epi32(f1, max);
+				f1 = _mm256_blendv_epi8(f1, zero, t);
+				f0 = _mm256_mullo_epi32(f1, alpha);
+				f0 = _mm256_sub_epi32(f, f0);
+				f = _mm256_cmpgt_epi32(f0, hq);
+				f = _mm256_and_si256(f, q);
+				f0 = _mm256_sub_epi32(f0, f);
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(&A1[i]), f1);
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(&A0[i]), f0);
+			}
+		}
+	}
+
+	uint32_t PolyMakeHint(int32_t* H, const int32_t* A0, const int32_t* A1, uint32_t Gamma2)
+	{
+		const __m256i blo = _mm256_set1_epi32(Gamma2 + 1);
+		const __m256i bhi = _mm256_set1_epi32(DILITHIUM_Q - Gamma2);
+		const __m256i zero = _mm256_setzero_si256();
+		const __m256i one = _mm256_set1_epi32(1);
+		__m256i f0;
+		__m256i f1;
+		__m256i g0;
+		__m256i g1;
+		uint32_t r;
+
+		r = 0;
+
+		for (size_t i = 0; i < DILITHIUM_N; i += 8)
+		{
+			f0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&A0[i]));
+			f1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&A1[i]));
+
+			g0 = _mm256_cmpgt_epi32(blo, f0);
+			g1 = _mm256_cmpgt_epi32(f0, bhi);
+			g0 = _mm256_or_si256(g0, g1);
+			g1 = _mm256_cmpeq_epi32(f0, bhi);
+			f1 = _mm256_cmpeq_epi32(f1, zero);
+			g1 = _mm256_and_si256(g1, f1);
+			g0 = _mm256_or_si256(g0, g1);
+
+			r += _mm_popcnt_u32(_mm256_movemask_ps(_mm256_castsi256_ps(g0)));
+			g0 = _mm256_add_epi32(g0, one);
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(&H[i]), g0);
+		}
+
+		return DILITHIUM_N - r;
+	}
+
+	void PolyPower2Round(int32_t* A1, int32_t* A0, const int32_t* A)
+	{
+		const __m256i mask = _mm256_set1_epi32(-static_cast<int32_t>(1U << DILITHIUM_D));
+		const __m256i half = _mm256_set1_epi32((1U << (DILITHIUM_D - 1)) - 1);
+		__m256i f;
+		__m256i f0;
+		__m256i f1;
+
+		for (size_t i = 0; i < DILITHIUM_N; i += 8)
+		{
+			f = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&A[i]));
+			f1 = _mm256_add_epi32(f, half);
+			f0 = _mm256_and_si256(f1, mask);
+			f1 = _mm256_srli_epi32(f1, DILITHIUM_D);
+			f0 = _mm256_sub_epi32(f, f0);
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(&A1[i]), f1);
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(&A0[i]), f0);
+		}
+	}
+
+	void PolyReduce(int32_t* A)
+	{
+		const __m256i q = _mm256_set1_epi32(DILITHIUM_Q);
+		const __m256i off = _mm256_set1_epi32(1 << 22);
+		__m256i f;
+		__m256i g;
+
+		for (size_t i = 0; i < DILITHIUM_N; i += 8)
+		{
+			f = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&A[i]));
+			g = _mm256_add_epi32(f, off);
+			g = _mm256_srai_epi32(g, 23);
+			g = _mm256_mullo_epi32(g, q);
+			f = _mm256_sub_epi32(f, g);
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(&A[i]), f);
+		}
+	}
+
+	void PolyShiftL(int32_t* A)
+	{
+		__m256i vec;
+
+		for (size_t i = 0; i < DILITHIUM_N; i += 8)
+		{
+			vec = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&A[i]));
+			vec = _mm256_slli_epi32(vec, DILITHIUM_D);
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(&A[i]), vec);
+		}
+	}
+
+	void PolySub(int32_t* C, const int32_t* A, const int32_t* B)
+	{
+		__m256i vec0;
+		__m256i vec1;
+
+		for (size_t i = 0; i < DILITHIUM_N; i += 8)
+		{
+			vec0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&A[i]));
+			vec1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&B[i]));
+			vec0 = _mm256_sub_epi32(vec0, vec1);
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(&C[i]), vec0);
+		}
+	}
+
+	void PolyUseHint(int32_t* B, const int32_t* A, const int32_t* H, uint32_t Gamma2)
+	{
+		const __m256i zero = _mm256_setzero_si256();
+		int32_t a0[DILITHIUM_N];
+		__m256i f;
+		__m256i g;
+		__m256i h;
+		__m256i t;
+
+		if (Gamma2 == (DILITHIUM_Q - 1) / 32)
+		{
+			const __m256i mask = _mm256_set1_epi32(15);
+			PolyDecompose(B, a0, A, Gamma2);
+
+			for (size_t i = 0; i < DILITHIUM_N; i += 8)
+			{
+				f = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&a0[i]));
+				g = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&B[i]));
+				h = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&H[i]));
+				t = BlendV32(zero, h, f);
+				t = _mm256_slli_epi32(t, 1);
+				h = _mm256_sub_epi32(h, t);
+				g = _mm256_add_epi32(g, h);
+				g = _mm256_and_si256(g, mask);
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(&B[i]), g);
+			}
+		}
+		else if (Gamma2 == (DILITHIUM_Q - 1) / 88)
+		{
+			const __m256i max = _mm256_set1_epi32(43);
+			PolyDecompose(B, a0, A, Gamma2);
+
+			for (size_t i = 0; i < DILITHIUM_N; i += 8)
+			{
+				f = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&a0[i]));
+				g = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&B[i]));
+				h = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&H[i]));
+				t = BlendV32(zero, h, f);
+				t = _mm256_slli_epi32(t, 1);
+				h = _mm256_sub_epi32(h, t);
+				g = _mm256_add_epi32(g, h);
+				g = BlendV32(g, max, g);
+				f = _mm256_cmpgt_epi32(g, max);
+				g = BlendV32(g, zero, f);
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(&B[i]), g);
+			}
+		}
+	}
+
+	void PolyW1Pack(uint8_t* R, const int32_t* A)
+	{
+		const __m256i mask = _mm256_set1_epi64x(0xFF00FF00FF00FF00);
+		const __m256i low4 = _mm256_set1_epi32(15);
+		const __m256i idx = _mm256_set_epi8(15, 13, 14, 12, 11, 9, 10, 8, 7, 5, 6, 4, 3, 1, 2, 0,
+			15, 13, 14, 12, 11, 9, 10, 8, 7, 5, 6, 4, 3, 1, 2, 0);
+		__m256i f0;
+		__m256i f1;
+		__m256i f2;
+		__m256i f3;
+		__m256i f4;
+		__m256i f5;
+		__m256i f6;
+		__m256i f7;
+
+		for (size_t i = 0; i < DILITHIUM_N / 64; ++i)
+		{
+			f0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&A[64 * i]));
+			f1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&A[(64 * i) + 8]));
+			f2 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&A[(64 * i) + 16]));
+			f3 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&A[(64 * i) + 24]));
+
+			f0 = _mm256_and_si256(f0, low4);
+			f1 = _mm256_and_si256(f1, low4);
+			f2 = _mm256_and_si256(f2, low4);
+			f3 = _mm256_and_si256(f3, low4);
+
+			f0 = _mm256_packus_epi32(f0, f1);
+			f4 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&A[(64 * i) + 32]));
+			f5 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&A[(64 * i) + 40]));
+
+			f1 = _mm256_packus_epi32(f2, f3);
+			f6 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&A[(64 * i) + 48]));
+			f7 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&A[(64 * i) + 56]));
+
+			f4 = _mm256_and_si256(f4, low4);
+			f5 = _mm256_and_si256(f5, low4);
+			f6 = _mm256_and_si256(f6, low4);
+			f7 = _mm256_and_si256(f7, low4);
+
+			f2 = _mm256_packus_epi32(f4, f5);
+			f3 = _mm256_packus_epi32(f6, f7);
+			f0 = _mm256_packus_epi16(f0, f1);
+			f1 = _mm256_packus_epi16(f2, f3);
+			f2 = _mm256_permute2x128_si256(f0, f1, 0x20);	// ABCD
+			f3 = _mm256_permute2x128_si256(f0, f1, 0x31);	// EFGH
+
+			f4 = _mm256_srli_epi16(f2, 8);					// B0D0
+			f5 = _mm256_slli_epi16(f3, 8);					// 0E0G
+			f0 = _mm256_blendv_epi8(f2, f5, mask);			// AECG
+			f1 = _mm256_blendv_epi8(f4, f3, mask);			// BFDH
+
+			f1 = _mm256_slli_epi16(f1, 4);
+			f0 = _mm256_add_epi16(f0, f1);
+
+			f0 = _mm256_shuffle_epi8(f0, idx);
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(&R[32 * i]), f0);
+		}
+	}
+
+	size_t RejUniform(int32_t* R, const uint8_t* Buffer, size_t BufLength)
+	{
+		const __m256i bound = _mm256_set1_epi32(DILITHIUM_Q);
+		const __m256i mask = _mm256_set1_epi32(0x7FFFFF);
+		const __m256i idx8 = _mm256_set_epi8(-1, 15, 14, 13, -1, 12, 11, 10, -1, 9, 8, 7, -1, 6, 5, 4,
+			-1, 11, 10, 9, -1, 8, 7, 6, -1, 5, 4, 3, -1, 2, 1, 0);
+		__m256i d;
+		__m256i tmp;
+		size_t ctr;
+		size_t pos;
+		uint32_t good;
+		uint32_t t;
+
+		ctr = 0;
+		pos = 0;
+
+		// each 32 byte load consumes 24 bytes, the last load reads 8 bytes past the sampled bytes
+		while (pos + 24 <= BufLength)
+		{
+			d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&Buffer[pos]));
+			d = _mm256_permute4x64_epi64(d, 0x94);
+			d = _mm256_shuffle_epi8(d, idx8);
+			d = _mm256_and_si256(d, mask);
+			pos += 24;
+
+			tmp = _mm256_sub_epi32(d, bound);
+			good = _mm256_movemask_ps(_mm256_castsi256_ps(tmp));
+			tmp = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(&RejIdx[good][0])));
+			d = _mm256_permutevar8x32_epi32(d, tmp);
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(&R[ctr]), d);
+			ctr += _mm_popcnt_u32(good);
+
+			if (ctr > DILITHIUM_N - 8)
+			{
+				break;
+			}
+		}
+
+		while (ctr < DILITHIUM_N && pos + 3 <= BufLength)
+		{
+			t = Buffer[pos];
+			++pos;
+			t |= static_cast<uint32_t>(Buffer[pos]) << 8;
+			++pos;
+			t |= static_cast<uint32_t>(Buffer[pos]) << 16;
+			++pos;
+			t &= 0x7FFFFF;
+
+			if (t < DILITHIUM_Q)
+			{
+				R[ctr] = t;
+				++ctr;
+			}
+		}
+
+		return ctr;
+	}
+}
+#else
+using Exception::CryptoAsymmetricException;
+using Enumeration::ErrorCodes;
+#endif
+
+SimdProfiles DLTMKernels::Compiled()
+{
+	return HasAvx2() ? SimdProfiles::Simd256 :
+		SimdProfiles::None;
+}
+
+bool DLTMKernels::HasAvx2()
+{
+#if defined(CEX_HAS_AVX2)
+	return true;
+#else
+	return false;
+#endif
+}
+
+void DLTMKernels::PolyAddAvx2(int32_t* C, const int32_t* A, const int32_t* B)
+{
+#if defined(CEX_HAS_AVX2)
+	PolyAdd(C, A, B);
+#else
+	throw CryptoAsymmetricException(std::string("DLTMKernels"), std::string("PolyAddAvx2"), std::string("The AVX2 kernel was not compiled!"), ErrorCodes::NotSupported);
+#endif
+}
+
+void DLTMKernels::PolyCaddQAvx2(int32_t* A)
+{
+#if defined(CEX_HAS_AVX2)
+	PolyCaddQ(A);
+#else
+	throw CryptoAsymmetricException(std::string("DLTMKernels"), std::string("PolyCaddQAvx2"), std::string("The AVX2 kernel was not compiled!"), ErrorCodes::NotSupported);
+#endif
+}
+
+int32_t DLTMKernels::PolyChkNormAvx2(const int32_t* A, uint32_t B)
+{
+#if defined(CEX_HAS_AVX2)
+	return PolyChkNorm(A, B);
+#else
+	throw CryptoAsymmetricException(std::string("DLTMKernels"), std::string("PolyChkNormAvx2"), std::string("The AVX2 kernel was not compiled!"), ErrorCodes::NotSupported);
+#endif
+}
+
+void DLTMKernels::PolyDecomposeAvx2(int32_t* A1, int32_t* A0, const int32_t* A, uint32_t Gamma2)
+{
+#if defined(CEX_HAS_AVX2)
+	PolyDecompose(A1, A0, A, Gamma2);
+#else
+	throw CryptoAsymmetricException(std::string("DLTMKernels"), std::string("PolyDecomposeAvx2"), std::string("The AVX2 kernel was not compiled!"), ErrorCodes::NotSupported);
+#endif
+}
+
+uint32_t DLTMKernels::PolyMakeHintAvx2(int32_t* H, const int32_t* A0, const int32_t* A1, uint32_t Gamma2)
+{
+#if defined(CEX_HAS_AVX2)
+	return PolyMakeHint(H, A0, A1, Gamma2);
+#else
+	throw CryptoAsymmetricException(std::string("DLTMKernels"), std::string("PolyMakeHintAvx2"), std::string("The AVX2 kernel was not compiled!"), ErrorCodes::NotSupported);
+#endif
+}
+
+void DLTMKernels::PolyPower2RoundAvx2(int32_t* A1, int32_t* A0, const int32_t* A)
+{
+#if defined(CEX_HAS_AVX2)
+	PolyPower2Round(A1, A0, A);
+#else
+	throw CryptoAsymmetricException(std::string("DLTMKernels"), std::string("PolyPower2RoundAvx2"), std::string("The AVX2 kernel was not compiled!"), ErrorCodes::NotSupported);
+#endif
+}
+
+void DLTMKernels::PolyReduceAvx2(int32_t* A)
+{
+#if defined(CEX_HAS_AVX2)
+	PolyReduce(A);
+#else
+	throw CryptoAsymmetricException(std::string("DLTMKernels"), std::string("PolyReduceAvx2"), std::string("The AVX2 kernel was not compiled!"), ErrorCodes::NotSupported);
+#endif
+}
+
+void DLTMKernels::PolyShiftLAvx2(int32_t* A)
+{
+#if defined(CEX_HAS_AVX2)
+	PolyShiftL(A);
+#else
+	throw CryptoAsymmetricException(std::string("DLTMKernels"), std::string("PolyShiftLAvx2"), std::string("The AVX2 kernel was not compiled!"), ErrorCodes::NotSupported);
+#endif
+}
+
+void DLTMKernels::PolySubAvx2(int32_t* C, const int32_t* A, const int32_t* B)
+{
+#if defined(CEX_HAS_AVX2)
+	PolySub(C, A, B);
+#else
+	throw CryptoAsymmetricException(std::string("DLTMKernels"), std::string("PolySubAvx2"), std::string("The AVX2 kernel was not compiled!"), ErrorCodes::NotSupported);
+#endif
+}
+
+void DLTMKernels::PolyUseHintAvx2(int32_t* B, const int32_t* A, const int32_t* H, uint32_t Gamma2)
+{
+#if defined(CEX_HAS_AVX2)
+	PolyUseHint(B, A, H, Gamma2);
+#else
+	throw CryptoAsymmetricException(std::string("DLTMKernels"), std::string("PolyUseHintAvx2"), std::string("The AVX2 kernel was not compiled!"), ErrorCodes::NotSupported);
+#endif
+}
+
+void DLTMKernels::PolyW1PackAvx2(uint8_t* R, const int32_t* A)
+{
+#if defined(CEX_HAS_AVX2)
+	PolyW1Pack(R, A);
+#else
+	throw CryptoAsymmetricException(std::string("DLTMKernels"), std::string("PolyW1PackAvx2"), std::string("The AVX2 kernel was not compiled!"), ErrorCodes::NotSupported);
+#endif
+}
+
+size_t DLTMKernels::RejUniformAvx2(int32_t* R, const uint8_t* Buffer, size_t BufLength)
+{
+#if defined(CEX_HAS_AVX2)
+	return RejUniform(R, Buffer, BufLength);
+#else
+	throw CryptoAsymmetricException(std::string("DLTMKernels"), std::string("RejUniformAvx2"), std::string("The AVX2 kernel was not compiled!"), ErrorCodes::NotSupported);
+#endif
+}
+
+NAMESPACE_DILITHIUMEND
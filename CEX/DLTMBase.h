@@ -5,6 +5,7 @@
 #include "DLTMPolyMath.h"
 #include "IPrng.h"
 #include "Keccak.h"
+#include "KeccakKernels.h"
 #include "IntegerTools.h"
 #include "MemoryTools.h"
 
@@ -12,6 +13,7 @@ NAMESPACE_DILITHIUM
 
 using DLTM::DLTMPolyMath;
 using Digest::Keccak;
+using Digest::KeccakKernels;
 using Prng::IPrng;
 using Tools::IntegerTools;
 using Tools::MemoryTools;
@@ -120,9 +122,72 @@ public:
 	/// <param name="PublicKey">The output public key vector</param>
 	/// <param name="PrivateKey">The output private key vector</param>
 	/// <param name="Rng">The initialized PRNG used by the function</param>
-#if defined(CEX_HAS_AVX2)
 	template<typename T>
 	static void Generate(T &Params, std::vector<uint8_t> &PublicKey, std::vector<uint8_t> &PrivateKey, std::unique_ptr<Prng::IPrng> &Rng)
+	{
+		if (DLTMPolyMath::HasAvx2() == true && KeccakKernels::HasAvx2() == true)
+		{
+			GenerateAvx2(Params, PublicKey, PrivateKey, Rng);
+		}
+		else
+		{
+			GenerateRef(Params, PublicKey, PrivateKey, Rng);
+		}
+	}
+	
+	/// <summary>
+	/// Sign a message using the private key
+	/// </summary>
+	/// 
+	/// <param name="Params">The implementation parameter set</param>
+	/// <param name="Signature">The output signed message</param>
+	/// <param name="Message">The message to sign</param>
+	/// <param name="PrivateKey">The private key</param>
+	/// <param name="Rng">The initialized PRNG used by the function</param>
+	template<typename T>
+	static void Sign(T &Params, std::vector<uint8_t> &Signature, const std::vector<uint8_t> &Message, const std::vector<uint8_t> &PrivateKey, std::unique_ptr<Prng::IPrng> &Rng)
+	{
+		if (DLTMPolyMath::HasAvx2() == true && KeccakKernels::HasAvx2() == true)
+		{
+			SignAvx2(Params, Signature, Message, PrivateKey, Rng);
+		}
+		else
+		{
+			SignRef(Params, Signature, Message, PrivateKey, Rng);
+		}
+	}
+
+	/// <summary>
+	/// Verify a signed message
+	/// </summary>
+	/// 
+	/// <param name="Params">The implementation parameter set</param>
+	/// <param name="Message">The output message</param>
+	/// <param name="Signature">The input signed message</param>
+	/// <param name="PublicKey">The public key</param>
+	/// 
+	/// <returns>Returns true on success</returns>
+	template<typename T>
+	static bool Verify(T &Params, std::vector<uint8_t> &Message, const std::vector<uint8_t> &Signature, const std::vector<uint8_t> &PublicKey)
+	{
+		bool res;
+
+		if (DLTMPolyMath::HasAvx2() == true && KeccakKernels::HasAvx2() == true)
+		{
+			res = VerifyAvx2(Params, Message, Signature, PublicKey);
+		}
+		else
+		{
+			res = VerifyRef(Params, Message, Signature, PublicKey);
+		}
+
+		return res;
+	}
+
+private:
+
+	template<typename T>
+	static void GenerateAvx2(T &Params, std::vector<uint8_t> &PublicKey, std::vector<uint8_t> &PrivateKey, std::unique_ptr<Prng::IPrng> &Rng)
 	{
 		std::vector<std::vector<std::array<int32_t, DILITHIUM_N>>> mat(T::DILITHIUM_K, std::vector<std::array<int32_t, DILITHIUM_N>>(T::DILITHIUM_L));
 		std::vector<std::array<int32_t, DILITHIUM_N>> s1(T::DILITHIUM_L);
@@ -207,9 +272,9 @@ public:
 		Keccak::XOFP1600(PublicKey, 0, T::DILITHIUM_PUBLICKEY_SIZE, tr, 0, tr.size(), Keccak::KECCAK256_RATE_SIZE);
 		MemoryTools::Copy(tr, 0, PrivateKey, 2 * DILITHIUM_SEED_SIZE, DILITHIUM_CRH_SIZE);
 	}
-#else
+
 	template<typename T>
-	static void Generate(T &Params, std::vector<uint8_t> &PublicKey, std::vector<uint8_t> &PrivateKey, std::unique_ptr<Prng::IPrng> &Rng)
+	static void GenerateRef(T &Params, std::vector<uint8_t> &PublicKey, std::vector<uint8_t> &PrivateKey, std::unique_ptr<Prng::IPrng> &Rng)
 	{
 		std::vector<std::vector<std::array<int32_t, DILITHIUM_N>>> mat(T::DILITHIUM_K, std::vector<std::array<int32_t, DILITHIUM_N>>(T::DILITHIUM_L));
 		std::vector<std::array<int32_t, DILITHIUM_N>> s1(T::DILITHIUM_L);
@@ -275,20 +340,9 @@ public:
 		Keccak::XOFP1600(PublicKey, 0, T::DILITHIUM_PUBLICKEY_SIZE, tr, 0, tr.size(), Keccak::KECCAK256_RATE_SIZE);
 		DLTMPolyMath::PackSk(PrivateKey, rho, key, tr, s1, s2, t0, T::DILITHIUM_ETA, T::DILITHIUM_POLYETA_PACKED_SIZE, DILITHIUM_POLT0_SIZE_PACKED);
 	}
-#endif
-	
-	/// <summary>
-	/// Sign a message using the private key
-	/// </summary>
-	/// 
-	/// <param name="Params">The implementation parameter set</param>
-	/// <param name="Signature">The output signed message</param>
-	/// <param name="Message">The message to sign</param>
-	/// <param name="PrivateKey">The private key</param>
-	/// <param name="Rng">The initialized PRNG used by the function</param>
-#if defined(CEX_HAS_AVX2)
+
 	template<typename T>
-	static void Sign(T &Params, std::vector<uint8_t> &Signature, const std::vector<uint8_t> &Message, const std::vector<uint8_t> &PrivateKey, std::unique_ptr<Prng::IPrng> &Rng)
+	static void SignAvx2(T &Params, std::vector<uint8_t> &Signature, const std::vector<uint8_t> &Message, const std::vector<uint8_t> &PrivateKey, std::unique_ptr<Prng::IPrng> &Rng)
 	{
 		std::vector<std::vector<std::array<int32_t, DILITHIUM_N>>> mat(T::DILITHIUM_K, std::vector<std::array<int32_t, DILITHIUM_N>>(T::DILITHIUM_L));
 		std::vector<std::array<int32_t, DILITHIUM_N>> s1(T::DILITHIUM_L);
@@ -472,9 +526,9 @@ public:
 
 		MemoryTools::Copy(Message, 0, Signature, T::DILITHIUM_SIGNATURE_SIZE, Message.size());
 	}
-#else
+
 	template<typename T>
-	static void Sign(T &Params, std::vector<uint8_t> &Signature, const std::vector<uint8_t> &Message, const std::vector<uint8_t> &PrivateKey, std::unique_ptr<Prng::IPrng> &Rng)
+	static void SignRef(T &Params, std::vector<uint8_t> &Signature, const std::vector<uint8_t> &Message, const std::vector<uint8_t> &PrivateKey, std::unique_ptr<Prng::IPrng> &Rng)
 	{
 		std::vector<std::vector<std::array<int32_t, DILITHIUM_N>>> mat(T::DILITHIUM_K, std::vector<std::array<int32_t, DILITHIUM_N>>(T::DILITHIUM_L));
 		std::vector<std::array<int32_t, DILITHIUM_N>> s1(T::DILITHIUM_L);
@@ -516,40 +570,16 @@ public:
 	#endif
 
 		// expand matrix and transform vectors 
-#if defined(CEX_HAS_AVX2)
-		DLTMPolyMath::PolyVecMatrixExpandAvx2(mat, rho, T::DILITHIUM_K, T::DILITHIUM_L);
-#else
 		DLTMPolyMath::ExpandMat(mat, rho);
-#endif
 		DLTMPolyMath::PolyVecNtt(s1);
 		DLTMPolyMath::PolyVecNtt(s2);
 		DLTMPolyMath::PolyVecNtt(t0);
 
 		while (true)
 		{
-#if defined(CEX_HAS_AVX2)
-			if (T::DILITHIUM_L == 4)
-			{
-				DLTMPolyMath::PolyUniformGamma1x4(y[0], y[1], y[2], y[3], rhoprime, nonce, nonce + 1, nonce + 2, nonce + 3, T::DILITHIUM_GAMMA1);
-				nonce += 4;
-			}
-			else if (T::DILITHIUM_L == 5)
-			{
-				DLTMPolyMath::PolyUniformGamma1x4(y[0], y[1], y[2], y[3], rhoprime, nonce, nonce + 1, nonce + 2, nonce + 3, T::DILITHIUM_GAMMA1);
-				DLTMPolyMath::PolyUniformGamma1M1(y[4], rhoprime, nonce + 4, T::DILITHIUM_GAMMA1);
-				nonce += 5;
-			}
-			else if (T::DILITHIUM_L == 7)
-			{
-				DLTMPolyMath::PolyUniformGamma1x4(y[0], y[1], y[2], y[3], rhoprime, nonce, nonce + 1, nonce + 2, nonce + 3, T::DILITHIUM_GAMMA1);
-				DLTMPolyMath::PolyUniformGamma1x4(y[4], y[5], y[6], h[0], rhoprime, nonce + 4, nonce + 5, nonce + 6, 0, T::DILITHIUM_GAMMA1);
-				nonce += 7;
-			}
-#else
 			// sample intermediate vector y 
 			DLTMPolyMath::PolyVecUniformGamma1M1(y, rhoprime, nonce, T::DILITHIUM_GAMMA1);
 			++nonce;
-#endif
 
 			// matrix-vector multiplication 
 			z = y;
@@ -620,21 +650,9 @@ public:
 		DLTMPolyMath::PackSig(Signature, Signature, z, h, T::DILITHIUM_K, T::DILITHIUM_OMEGA, T::DILITHIUM_POLYZ_PACKED_SIZE, T::DILITHIUM_GAMMA1);
 		MemoryTools::Copy(Message, 0, Signature, T::DILITHIUM_SIGNATURE_SIZE, Message.size());
 	}
-#endif
 
-	/// <summary>
-	/// Verify a signed message
-	/// </summary>
-	/// 
-	/// <param name="Params">The implementation parameter set</param>
-	/// <param name="Message">The output message</param>
-	/// <param name="Signature">The input signed message</param>
-	/// <param name="PublicKey">The public key</param>
-	/// 
-	/// <returns>Returns true on success</returns>
-#if defined(CEX_HAS_AVX2)
 	template<typename T>
-	static bool Verify(T &Params, std::vector<uint8_t> &Message, const std::vector<uint8_t> &Signature, const std::vector<uint8_t> &PublicKey)
+	static bool VerifyAvx2(T &Params, std::vector<uint8_t> &Message, const std::vector<uint8_t> &Signature, const std::vector<uint8_t> &PublicKey)
 	{
 		std::vector<std::vector<std::array<int32_t, DILITHIUM_N>>> mat(T::DILITHIUM_K, std::vector<std::array<int32_t, DILITHIUM_N>>(T::DILITHIUM_L));
 		std::vector<std::array<int32_t, DILITHIUM_N>> z(T::DILITHIUM_L);
@@ -762,9 +780,9 @@ public:
 
 		return res;
 	}
-#else
+
 	template<typename T>
-	static bool Verify(T &Params, std::vector<uint8_t> &Message, const std::vector<uint8_t> &Signature, const std::vector<uint8_t> &PublicKey)
+	static bool VerifyRef(T &Params, std::vector<uint8_t> &Message, const std::vector<uint8_t> &Signature, const std::vector<uint8_t> &PublicKey)
 	{
 		std::vector<std::vector<std::array<int32_t, DILITHIUM_N>>> mat(T::DILITHIUM_K, std::vector<std::array<int32_t, DILITHIUM_N>>(T::DILITHIUM_L));
 		std::vector<std::array<int32_t, DILITHIUM_N>> z(T::DILITHIUM_L);
@@ -847,7 +865,6 @@ public:
 
 		return res;
 	}
-#endif
 };
 
 NAMESPACE_DILITHIUMEND
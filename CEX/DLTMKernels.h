@@ -0,0 +1,100 @@
+#ifndef CEX_DLTMKERNELS_H
+#define CEX_DLTMKERNELS_H
+
+#include "CexDomain.h"
+#include "SimdProfiles.h"
+
+NAMESPACE_DILITHIUM
+
+using Enumeration::SimdProfiles;
+
+/// cond private
+
+/// <summary>
+/// Internal class: the AVX2 Dilithium polynomial routines, built in their own instruction set translation unit.
+/// <para>DLTMAvx2.cpp is compiled with the AVX2 code generation flag and holds the vectorized rounding, hint, packing and arithmetic routines.
+/// The unit is self-contained: the routines have internal linkage, and the unit includes no shared header with instruction set branches.
+/// Polynomials are passed as pointers to 256 coefficients, and all vectors are read and written unaligned.
+/// RejUniformAvx2 reads up to 8 bytes past its stated buffer length, the sampler buffer must be padded by that amount.
+/// A unit compiled without AVX2 reports the variant as absent, and its functions throw if called.
+/// DLTMPolyMath selects the routines at run-time with SimdDispatch::Select(Compiled()).</para>
+/// </summary>
+class DLTMKernels final
+{
+public:
+
+	/// <summary>
+	/// The widest kernel variant compiled into the library
+	/// </summary>
+	static SimdProfiles Compiled();
+
+	/// <summary>
+	/// The AVX2 kernels were compiled
+	/// </summary>
+	static bool HasAvx2();
+
+	/// <summary>
+	/// Add two polynomials
+	/// </summary>
+	static void PolyAddAvx2(int32_t* C, const int32_t* A, const int32_t* B);
+
+	/// <summary>
+	/// Add Q to each negative coefficient
+	/// </summary>
+	static void PolyCaddQAvx2(int32_t* A);
+
+	/// <summary>
+	/// Check the infinity norm of a polynomial against the bound B, returns 0 if within the bound, 1 otherwise
+	/// </summary>
+	static int32_t PolyChkNormAvx2(const int32_t* A, uint32_t B);
+
+	/// <summary>
+	/// Decompose the coefficients into high bits A1 and low bits A0, Gamma2 is (Q-1)/32 or (Q-1)/88
+	/// </summary>
+	static void PolyDecomposeAvx2(int32_t* A1, int32_t* A0, const int32_t* A, uint32_t Gamma2);
+
+	/// <summary>
+	/// Compute the hint polynomial, returns the number of hint bits set
+	/// </summary>
+	static uint32_t PolyMakeHintAvx2(int32_t* H, const int32_t* A0, const int32_t* A1, uint32_t Gamma2);
+
+	/// <summary>
+	/// Split the coefficients into high bits A1 and low bits A0 by the power of two rounding
+	/// </summary>
+	static void PolyPower2RoundAvx2(int32_t* A1, int32_t* A0, const int32_t* A);
+
+	/// <summary>
+	/// Reduce the coefficients to a representative in the range -6283009 to 6283007
+	/// </summary>
+	static void PolyReduceAvx2(int32_t* A);
+
+	/// <summary>
+	/// Multiply the coefficients by 2^D
+	/// </summary>
+	static void PolyShiftLAvx2(int32_t* A);
+
+	/// <summary>
+	/// Subtract polynomial B from A
+	/// </summary>
+	static void PolySubAvx2(int32_t* C, const int32_t* A, const int32_t* B);
+
+	/// <summary>
+	/// Correct the high bits of A with the hint polynomial H, Gamma2 is (Q-1)/32 or (Q-1)/88
+	/// </summary>
+	static void PolyUseHintAvx2(int32_t* B, const int32_t* A, const int32_t* H, uint32_t Gamma2);
+
+	/// <summary>
+	/// Pack a w1 polynomial with 4 bits per coefficient, Gamma2 (Q-1)/32, 128 output bytes
+	/// </summary>
+	static void PolyW1PackAvx2(uint8_t* R, const int32_t* A);
+
+	/// <summary>
+	/// Rejection sample uniform coefficients from the sampler output, returns the number of coefficients written
+	/// </summary>
+	static size_t RejUniformAvx2(int32_t* R, const uint8_t* Buffer, size_t BufLength);
+};
+
+/// endcond
+
+NAMESPACE_DILITHIUMEND
+#endif
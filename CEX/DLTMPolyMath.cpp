@@ -1,11 +1,17 @@
 #include "DLTMPolyMath.h"
+#include "DLTMKernels.h"
 #include "Keccak.h"
+#include "KeccakKernels.h"
 #include "MemoryTools.h"
+#include "SimdDispatch.h"
 
 NAMESPACE_DILITHIUM
 
 using Digest::Keccak;
+using Digest::KeccakKernels;
+using Enumeration::SimdProfiles;
 using Tools::MemoryTools;
+using Tools::SimdDispatch;
 
 const uint32_t DLTMPolyMath::Zetas[DILITHIUM_N] =
 {
@@ -43,642 +49,337 @@ const uint32_t DLTMPolyMath::Zetas[DILITHIUM_N] =
 	0xFFF78A50L, 0x003BCF2CL, 0xFFFF434EL, 0xFFEB36DFL, 0x003C15CAL, 0x00155E68L, 0xFFF316B6L, 0x001E29CEL
 };
 
-#if defined(CEX_HAS_AVX2)
-
-CEX_ALIGN(64) static const uint8_t RejAvx2[256][8] = 
-{
-	{ 0,  0,  0,  0,  0,  0,  0,  0}, { 0,  0,  0,  0,  0,  0,  0,  0}, { 1,  0,  0,  0,  0,  0,  0,  0}, { 0,  1,  0,  0,  0,  0,  0,  0},
-	{ 2,  0,  0,  0,  0,  0,  0,  0}, { 0,  2,  0,  0,  0,  0,  0,  0}, { 1,  2,  0,  0,  0,  0,  0,  0}, { 0,  1,  2,  0,  0,  0,  0,  0},
-	{ 3,  0,  0,  0,  0,  0,  0,  0}, { 0,  3,  0,  0,  0,  0,  0,  0}, { 1,  3,  0,  0,  0,  0,  0,  0}, { 0,  1,  3,  0,  0,  0,  0,  0},
-	{ 2,  3,  0,  0,  0,  0,  0,  0}, { 0,  2,  3,  0,  0,  0,  0,  0}, { 1,  2,  3,  0,  0,  0,  0,  0}, { 0,  1,  2,  3,  0,  0,  0,  0},
-	{ 4,  0,  0,  0,  0,  0,  0,  0}, { 0,  4,  0,  0,  0,  0,  0,  0}, { 1,  4,  0,  0,  0,  0,  0,  0}, { 0,  1,  4,  0,  0,  0,  0,  0},
-	{ 2,  4,  0,  0,  0,  0,  0,  0}, { 0,  2,  4,  0,  0,  0,  0,  0}, { 1,  2,  4,  0,  0,  0,  0,  0}, { 0,  1,  2,  4,  0,  0,  0,  0},
-	{ 3,  4,  0,  0,  0,  0,  0,  0}, { 0,  3,  4,  0,  0,  0,  0,  0}, { 1,  3,  4,  0,  0,  0,  0,  0}, { 0,  1,  3,  4,  0,  0,  0,  0},
-	{ 2,  3,  4,  0,  0,  0,  0,  0}, { 0,  2,  3,  4,  0,  0,  0,  0}, { 1,  2,  3,  4,  0,  0,  0,  0}, { 0,  1,  2,  3,  4,  0,  0,  0},
-	{ 5,  0,  0,  0,  0,  0,  0,  0}, { 0,  5,  0,  0,  0,  0,  0,  0}, { 1,  5,  0,  0,  0,  0,  0,  0}, { 0,  1,  5,  0,  0,  0,  0,  0},
-	{ 2,  5,  0,  0,  0,  0,  0,  0}, { 0,  2,  5,  0,  0,  0,  0,  0}, { 1,  2,  5,  0,  0,  0,  0,  0}, { 0,  1,  2,  5,  0,  0,  0,  0},
-	{ 3,  5,  0,  0,  0,  0,  0,  0}, { 0,  3,  5,  0,  0,  0,  0,  0}, { 1,  3,  5,  0,  0,  0,  0,  0}, { 0,  1,  3,  5,  0,  0,  0,  0},
-	{ 2,  3,  5,  0,  0,  0,  0,  0}, { 0,  2,  3,  5,  0,  0,  0,  0}, { 1,  2,  3,  5,  0,  0,  0,  0}, { 0,  1,  2,  3,  5,  0,  0,  0},
-	{ 4,  5,  0,  0,  0,  0,  0,  0}, { 0,  4,  5,  0,  0,  0,  0,  0}, { 1,  4,  5,  0,  0,  0,  0,  0}, { 0,  1,  4,  5,  0,  0,  0,  0},
-	{ 2,  4,  5,  0,  0,  0,  0,  0}, { 0,  2,  4,  5,  0,  0,  0,  0}, { 1,  2,  4,  5,  0,  0,  0,  0}, { 0,  1,  2,  4,  5,  0,  0,  0},
-	{ 3,  4,  5,  0,  0,  0,  0,  0}, { 0,  3,  4,  5,  0,  0,  0,  0}, { 1,  3,  4,  5,  0,  0,  0,  0}, { 0,  1,  3,  4,  5,  0,  0,  0},
-	{ 2,  3,  4,  5,  0,  0,  0,  0}, { 0,  2,  3,  4,  5,  0,  0,  0}, { 1,  2,  3,  4,  5,  0,  0,  0}, { 0,  1,  2,  3,  4,  5,  0,  0},
-	{ 6,  0,  0,  0,  0,  0,  0,  0}, { 0,  6,  0,  0,  0,  0,  0,  0}, { 1,  6,  0,  0,  0,  0,  0,  0}, { 0,  1,  6,  0,  0,  0,  0,  0},
-	{ 2,  6,  0,  0,  0,  0,  0,  0}, { 0,  2,  6,  0,  0,  0,  0,  0}, { 1,  2,  6,  0,  0,  0,  0,  0}, { 0,  1,  2,  6,  0,  0,  0,  0},
-	{ 3,  6,  0,  0,  0,  0,  0,  0}, { 0,  3,  6,  0,  0,  0,  0,  0}, { 1,  3,  6,  0,  0,  0,  0,  0}, { 0,  1,  3,  6,  0,  0,  0,  0},
-	{ 2,  3,  6,  0,  0,  0,  0,  0}, { 0,  2,  3,  6,  0,  0,  0,  0}, { 1,  2,  3,  6,  0,  0,  0,  0}, { 0,  1,  2,  3,  6,  0,  0,  0},
-	{ 4,  6,  0,  0,  0,  0,  0,  0}, { 0,  4,  6,  0,  0,  0,  0,  0}, { 1,  4,  6,  0,  0,  0,  0,  0}, { 0,  1,  4,  6,  0,  0,  0,  0},
-	{ 2,  4,  6,  0,  0,  0,  0,  0}, { 0,  2,  4,  6,  0,  0,  0,  0}, { 1,  2,  4,  6,  0,  0,  0,  0}, { 0,  1,  2,  4,  6,  0,  0,  0},
-	{ 3,  4,  6,  0,  0,  0,  0,  0}, { 0,  3,  4,  6,  0,  0,  0,  0}, { 1,  3,  4,  6,  0,  0,  0,  0}, { 0,  1,  3,  4,  6,  0,  0,  0},
-	{ 2,  3,  4,  6,  0,  0,  0,  0}, { 0,  2,  3,  4,  6,  0,  0,  0}, { 1,  2,  3,  4,  6,  0,  0,  0}, { 0,  1,  2,  3,  4,  6,  0,  0},
-	{ 5,  6,  0,  0,  0,  0,  0,  0}, { 0,  5,  6,  0,  0,  0,  0,  0}, { 1,  5,  6,  0,  0,  0,  0,  0}, { 0,  1,  5,  6,  0,  0,  0,  0},
-	{ 2,  5,  6,  0,  0,  0,  0,  0}, { 0,  2,  5,  6,  0,  0,  0,  0}, { 1,  2,  5,  6,  0,  0,  0,  0}, { 0,  1,  2,  5,  6,  0,  0,  0},
-	{ 3,  5,  6,  0,  0,  0,  0,  0}, { 0,  3,  5,  6,  0,  0,  0,  0}, { 1,  3,  5,  6,  0,  0,  0,  0}, { 0,  1,  3,  5,  6,  0,  0,  0},
-	{ 2,  3,  5,  6,  0,  0,  0,  0}, { 0,  2,  3,  5,  6,  0,  0,  0}, { 1,  2,  3,  5,  6,  0,  0,  0}, { 0,  1,  2,  3,  5,  6,  0,  0},
-	{ 4,  5,  6,  0,  0,  0,  0,  0}, { 0,  4,  5,  6,  0,  0,  0,  0}, { 1,  4,  5,  6,  0,  0,  0,  0}, { 0,  1,  4,  5,  6,  0,  0,  0},
-	{ 2,  4,  5,  6,  0,  0,  0,  0}, { 0,  2,  4,  5,  6,  0,  0,  0}, { 1,  2,  4,  5,  6,  0,  0,  0}, { 0,  1,  2,  4,  5,  6,  0,  0},
-	{ 3,  4,  5,  6,  0,  0,  0,  0}, { 0,  3,  4,  5,  6,  0,  0,  0}, { 1,  3,  4,  5,  6,  0,  0,  0}, { 0,  1,  3,  4,  5,  6,  0,  0},
-	{ 2,  3,  4,  5,  6,  0,  0,  0}, { 0,  2,  3,  4,  5,  6,  0,  0}, { 1,  2,  3,  4,  5,  6,  0,  0}, { 0,  1,  2,  3,  4,  5,  6,  0},
-	{ 7,  0,  0,  0,  0,  0,  0,  0}, { 0,  7,  0,  0,  0,  0,  0,  0}, { 1,  7,  0,  0,  0,  0,  0,  0}, { 0,  1,  7,  0,  0,  0,  0,  0},
-	{ 2,  7,  0,  0,  0,  0,  0,  0}, { 0,  2,  7,  0,  0,  0,  0,  0}, { 1,  2,  7,  0,  0,  0,  0,  0}, { 0,  1,  2,  7,  0,  0,  0,  0},
-	{ 3,  7,  0,  0,  0,  0,  0,  0}, { 0,  3,  7,  0,  0,  0,  0,  0}, { 1,  3,  7,  0,  0,  0,  0,  0}, { 0,  1,  3,  7,  0,  0,  0,  0},
-	{ 2,  3,  7,  0,  0,  0,  0,  0}, { 0,  2,  3,  7,  0,  0,  0,  0}, { 1,  2,  3,  7,  0,  0,  0,  0}, { 0,  1,  2,  3,  7,  0,  0,  0},
-	{ 4,  7,  0,  0,  0,  0,  0,  0}, { 0,  4,  7,  0,  0,  0,  0,  0}, { 1,  4,  7,  0,  0,  0,  0,  0}, { 0,  1,  4,  7,  0,  0,  0,  0},
-	{ 2,  4,  7,  0,  0,  0,  0,  0}, { 0,  2,  4,  7,  0,  0,  0,  0}, { 1,  2,  4,  7,  0,  0,  0,  0}, { 0,  1,  2,  4,  7,  0,  0,  0},
-	{ 3,  4,  7,  0,  0,  0,  0,  0}, { 0,  3,  4,  7,  0,  0,  0,  0}, { 1,  3,  4,  7,  0,  0,  0,  0}, { 0,  1,  3,  4,  7,  0,  0,  0},
-	{ 2,  3,  4,  7,  0,  0,  0,  0}, { 0,  2,  3,  4,  7,  0,  0,  0}, { 1,  2,  3,  4,  7,  0,  0,  0}, { 0,  1,  2,  3,  4,  7,  0,  0},
-	{ 5,  7,  0,  0,  0,  0,  0,  0}, { 0,  5,  7,  0,  0,  0,  0,  0}, { 1,  5,  7,  0,  0,  0,  0,  0}, { 0,  1,  5,  7,  0,  0,  0,  0},
-	{ 2,  5,  7,  0,  0,  0,  0,  0}, { 0,  2,  5,  7,  0,  0,  0,  0}, { 1,  2,  5,  7,  0,  0,  0,  0}, { 0,  1,  2,  5,  7,  0,  0,  0},
-	{ 3,  5,  7,  0,  0,  0,  0,  0}, { 0,  3,  5,  7,  0,  0,  0,  0}, { 1,  3,  5,  7,  0,  0,  0,  0}, { 0,  1,  3,  5,  7,  0,  0,  0},
-	{ 2,  3,  5,  7,  0,  0,  0,  0}, { 0,  2,  3,  5,  7,  0,  0,  0}, { 1,  2,  3,  5,  7,  0,  0,  0}, { 0,  1,  2,  3,  5,  7,  0,  0},
-	{ 4,  5,  7,  0,  0,  0,  0,  0}, { 0,  4,  5,  7,  0,  0,  0,  0}, { 1,  4,  5,  7,  0,  0,  0,  0}, { 0,  1,  4,  5,  7,  0,  0,  0},
-	{ 2,  4,  5,  7,  0,  0,  0,  0}, { 0,  2,  4,  5,  7,  0,  0,  0}, { 1,  2,  4,  5,  7,  0,  0,  0}, { 0,  1,  2,  4,  5,  7,  0,  0},
-	{ 3,  4,  5,  7,  0,  0,  0,  0}, { 0,  3,  4,  5,  7,  0,  0,  0}, { 1,  3,  4,  5,  7,  0,  0,  0}, { 0,  1,  3,  4,  5,  7,  0,  0},
-	{ 2,  3,  4,  5,  7,  0,  0,  0}, { 0,  2,  3,  4,  5,  7,  0,  0}, { 1,  2,  3,  4,  5,  7,  0,  0}, { 0,  1,  2,  3,  4,  5,  7,  0},
-	{ 6,  7,  0,  0,  0,  0,  0,  0}, { 0,  6,  7,  0,  0,  0,  0,  0}, { 1,  6,  7,  0,  0,  0,  0,  0}, { 0,  1,  6,  7,  0,  0,  0,  0},
-	{ 2,  6,  7,  0,  0,  0,  0,  0}, { 0,  2,  6,  7,  0,  0,  0,  0}, { 1,  2,  6,  7,  0,  0,  0,  0}, { 0,  1,  2,  6,  7,  0,  0,  0},
-	{ 3,  6,  7,  0,  0,  0,  0,  0}, { 0,  3,  6,  7,  0,  0,  0,  0}, { 1,  3,  6,  7,  0,  0,  0,  0}, { 0,  1,  3,  6,  7,  0,  0,  0},
-	{ 2,  3,  6,  7,  0,  0,  0,  0}, { 0,  2,  3,  6,  7,  0,  0,  0}, { 1,  2,  3,  6,  7,  0,  0,  0}, { 0,  1,  2,  3,  6,  7,  0,  0},
-	{ 4,  6,  7,  0,  0,  0,  0,  0}, { 0,  4,  6,  7,  0,  0,  0,  0}, { 1,  4,  6,  7,  0,  0,  0,  0}, { 0,  1,  4,  6,  7,  0,  0,  0},
-	{ 2,  4,  6,  7,  0,  0,  0,  0}, { 0,  2,  4,  6,  7,  0,  0,  0}, { 1,  2,  4,  6,  7,  0,  0,  0}, { 0,  1,  2,  4,  6,  7,  0,  0},
-	{ 3,  4,  6,  7,  0,  0,  0,  0}, { 0,  3,  4,  6,  7,  0,  0,  0}, { 1,  3,  4,  6,  7,  0,  0,  0}, { 0,  1,  3,  4,  6,  7,  0,  0},
-	{ 2,  3,  4,  6,  7,  0,  0,  0}, { 0,  2,  3,  4,  6,  7,  0,  0}, { 1,  2,  3,  4,  6,  7,  0,  0}, { 0,  1,  2,  3,  4,  6,  7,  0},
-	{ 5,  6,  7,  0,  0,  0,  0,  0}, { 0,  5,  6,  7,  0,  0,  0,  0}, { 1,  5,  6,  7,  0,  0,  0,  0}, { 0,  1,  5,  6,  7,  0,  0,  0},
-	{ 2,  5,  6,  7,  0,  0,  0,  0}, { 0,  2,  5,  6,  7,  0,  0,  0}, { 1,  2,  5,  6,  7,  0,  0,  0}, { 0,  1,  2,  5,  6,  7,  0,  0},
-	{ 3,  5,  6,  7,  0,  0,  0,  0}, { 0,  3,  5,  6,  7,  0,  0,  0}, { 1,  3,  5,  6,  7,  0,  0,  0}, { 0,  1,  3,  5,  6,  7,  0,  0},
-	{ 2,  3,  5,  6,  7,  0,  0,  0}, { 0,  2,  3,  5,  6,  7,  0,  0}, { 1,  2,  3,  5,  6,  7,  0,  0}, { 0,  1,  2,  3,  5,  6,  7,  0},
-	{ 4,  5,  6,  7,  0,  0,  0,  0}, { 0,  4,  5,  6,  7,  0,  0,  0}, { 1,  4,  5,  6,  7,  0,  0,  0}, { 0,  1,  4,  5,  6,  7,  0,  0},
-	{ 2,  4,  5,  6,  7,  0,  0,  0}, { 0,  2,  4,  5,  6,  7,  0,  0}, { 1,  2,  4,  5,  6,  7,  0,  0}, { 0,  1,  2,  4,  5,  6,  7,  0},
-	{ 3,  4,  5,  6,  7,  0,  0,  0}, { 0,  3,  4,  5,  6,  7,  0,  0}, { 1,  3,  4,  5,  6,  7,  0,  0}, { 0,  1,  3,  4,  5,  6,  7,  0},
-	{ 2,  3,  4,  5,  6,  7,  0,  0}, { 0,  2,  3,  4,  5,  6,  7,  0}, { 1,  2,  3,  4,  5,  6,  7,  0}, { 0,  1,  2,  3,  4,  5,  6,  7}
-};
-
-const int32_t DLTMPolyMath::Avx2Q[8] = { DILITHIUM_Q, DILITHIUM_Q, DILITHIUM_Q, DILITHIUM_Q,
-    DILITHIUM_Q, DILITHIUM_Q, DILITHIUM_Q, DILITHIUM_Q };
-const int32_t DLTMPolyMath::Avx2QINV[8] = { DILITHIUM_QINV, DILITHIUM_QINV, DILITHIUM_QINV, DILITHIUM_QINV,
-    DILITHIUM_QINV, DILITHIUM_QINV, DILITHIUM_QINV, DILITHIUM_Q };
-
-#define _mm256_blendv_epi32(a,b,mask) \
-  _mm256_castps_si256(_mm256_blendv_ps(_mm256_castsi256_ps(a), \
-                                       _mm256_castsi256_ps(b), \
-                                       _mm256_castsi256_ps(mask)))
+bool DLTMPolyMath::HasAvx2()
+{
+	return (SimdDispatch::Instance().Select(DLTMKernels::Compiled()) >= SimdProfiles::Simd256);
+}
 
 void DLTMPolyMath::PolyAdd(std::array<int32_t, 256> &C, const std::array<int32_t, 256> &A, const std::array<int32_t, 256> &B)
 {
-    __m256i vec0;
-    __m256i vec1;
-
-    for (size_t i = 0; i < DILITHIUM_N; i += 8)
-    {
-        vec0 = _mm256_load_si256((__m256i*)&A[i]);
-        vec1 = _mm256_load_si256((__m256i*)&B[i]);
-        vec0 = _mm256_add_epi32(vec0, vec1);
-        _mm256_store_si256((__m256i*)&C[i], vec0);
-    }
+	if (HasAvx2() == true)
+	{
+		DLTMKernels::PolyAddAvx2(C.data(), A.data(), B.data());
+	}
+	else
+	{
+		for (size_t i = 0; i < C.size(); ++i)
+		{
+			C[i] = A[i] + B[i];
+		}
+	}
 }
 
 void DLTMPolyMath::PolyCaddQ(std::array<int32_t, 256> &A)
 {
-    const __m256i q = _mm256_load_si256((__m256i*)&Avx2Q[0]);
-    const __m256i zero = _mm256_setzero_si256();
-    __m256i f;
-    __m256i g;
-
-    for (size_t i = 0; i < DILITHIUM_N / 8; ++i)
-    {
-        f = _mm256_load_si256((__m256i*)&A[8 * i]);
-        g = _mm256_blendv_epi32(zero, q, f);
-        f = _mm256_add_epi32(f, g);
-        _mm256_store_si256((__m256i*)&A[8 * i], f);
-    }
+	if (HasAvx2() == true)
+	{
+		DLTMKernels::PolyCaddQAvx2(A.data());
+	}
+	else
+	{
+		for (size_t i = 0; i < A.size(); ++i)
+		{
+			A[i] = CaddQ(A[i]);
+		}
+	}
 }
 
 int32_t DLTMPolyMath::PolyChkNorm(const std::array<int32_t, 256> &A, uint32_t B)
 {
-    const __m256i bound = _mm256_set1_epi32(B - 1);
-    __m256i f;
-    __m256i t;
-    int32_t r;
+	int32_t t;
+	int32_t res;
 
-    if (B > (DILITHIUM_Q - 1) / 8)
-    {
-        r = 1;
-    }
-    else
-    {
-        t = _mm256_setzero_si256();
+	res = 0;
 
-        for (size_t i = 0; i < DILITHIUM_N / 8; ++i)
-        {
-            f = _mm256_load_si256((__m256i*)&A[8 * i]);
-            f = _mm256_abs_epi32(f);
-            f = _mm256_cmpgt_epi32(f, bound);
-            t = _mm256_or_si256(t, f);
-        }
+	if (HasAvx2() == true)
+	{
+		res = DLTMKernels::PolyChkNormAvx2(A.data(), B);
+	}
+	else if (B > (DILITHIUM_Q - 1) / 8)
+	{
+		res = 1;
+	}
+	else
+	{
+		// It is ok to leak which coefficient violates the bound since
+		// the probability for each coefficient is independent of secret
+		// data but we must not leak the sign of the centralized representative.
+		for (size_t i = 0; i < DILITHIUM_N; ++i)
+		{
+			// absolute value
+			t = A[i] >> 31;
+			t = A[i] - (t & 2 * A[i]);
 
-        r = _mm256_testz_si256(t, t) == 0 ? 1 : 0;
-    }
+			if (t >= (int32_t)B)
+			{
+				res = 1;
+				break;
+			}
+		}
+	}
 
-    return r;
+	return res;
 }
 
 void DLTMPolyMath::PolyDecompose(std::array<int32_t, 256> &A1, std::array<int32_t, 256> &A0, const std::array<int32_t, 256> &A, uint32_t Gamma2)
 {
-	if (Gamma2 == (DILITHIUM_Q - 1) / 32)
+	if (HasAvx2() == true)
 	{
-		const __m256i q = _mm256_load_si256((__m256i*)&Avx2Q[0]);
-		const __m256i hq = _mm256_srli_epi32(q, 1);
-		const __m256i v = _mm256_set1_epi32(1025);
-		const __m256i alpha = _mm256_set1_epi32(2 * Gamma2);
-		const __m256i off = _mm256_set1_epi32(127);
-		const __m256i shift = _mm256_set1_epi32(512);
-		const __m256i mask = _mm256_set1_epi32(15);
-		__m256i f;
-		__m256i f0;
-		__m256i f1;
-
-		for (size_t i = 0; i < DILITHIUM_N / 8; ++i)
-		{
-			f = _mm256_load_si256((__m256i*)&A[8 * i]);
-			f1 = _mm256_add_epi32(f, off);
-			f1 = _mm256_srli_epi32(f1, 7);
-			f1 = _mm256_mulhi_epu16(f1, v);
-			f1 = _mm256_mulhrs_epi16(f1, shift);
-			f1 = _mm256_and_si256(f1, mask);
-			f0 = _mm256_mullo_epi32(f1, alpha);
-			f0 = _mm256_sub_epi32(f, f0);
-			f = _mm256_cmpgt_epi32(f0, hq);
-			f = _mm256_and_si256(f, q);
-			f0 = _mm256_sub_epi32(f0, f);
-			_mm256_store_si256((__m256i*)&A1[8 * i], f1);
-			_mm256_store_si256((__m256i*)&A0[8 * i], f0);
-		}
+		DLTMKernels::PolyDecomposeAvx2(A1.data(), A0.data(), A.data(), Gamma2);
 	}
-	else if (Gamma2 == (DILITHIUM_Q - 1) / 88)
+	else
 	{
-		const __m256i q = _mm256_load_si256((__m256i*)&Avx2Q[0]);
-		const __m256i hq = _mm256_srli_epi32(q, 1);
-		const __m256i v = _mm256_set1_epi32(11275);
-		const __m256i alpha = _mm256_set1_epi32(2 * Gamma2);
-		const __m256i off = _mm256_set1_epi32(127);
-		const __m256i shift = _mm256_set1_epi32(128);
-		const __m256i max = _mm256_set1_epi32(43);
-		const __m256i zero = _mm256_setzero_si256();
-		__m256i f;
-		__m256i f0;
-		__m256i f1;
-		__m256i t;
-
-		for (size_t i = 0; i < DILITHIUM_N / 8; ++i)
+		for (size_t i = 0; i < A1.size(); ++i)
 		{
-			f = _mm256_load_si256((__m256i*)&A[8 * i]);
-			f1 = _mm256_add_epi32(f, off);
-			f1 = _mm256_srli_epi32(f1, 7);
-			f1 = _mm256_mulhi_epu16(f1, v);
-			f1 = _mm256_mulhrs_epi16(f1, shift);
-			t = _mm256_cmpgt_epi32(f1, max);
-			f1 = _mm256_blendv_epi8(f1, zero, t);
-			f0 = _mm256_mullo_epi32(f1, alpha);
-			f0 = _mm256_sub_epi32(f, f0);
-			f = _mm256_cmpgt_epi32(f0, hq);
-			f = _mm256_and_si256(f, q);
-			f0 = _mm256_sub_epi32(f0, f);
-			_mm256_store_si256((__m256i*)&A1[8 * i], f1);
-			_mm256_store_si256((__m256i*)&A0[8 * i], f0);
+			A1[i] = Decompose(A0[i], A[i], Gamma2);
 		}
 	}
 }
 
 uint32_t DLTMPolyMath::PolyMakeHint(std::array<int32_t, 256> &H, const std::array<int32_t, 256> &A0, const std::array<int32_t, 256> &A1, uint32_t Gamma2)
 {
-    const __m256i blo = _mm256_set1_epi32(Gamma2 + 1);
-    const __m256i bhi = _mm256_set1_epi32(DILITHIUM_Q - Gamma2);
-    const __m256i zero = _mm256_setzero_si256();
-    const __m256i one = _mm256_set1_epi32(1);
-    __m256i f0;
-    __m256i f1;
-    __m256i g0;
-    __m256i g1;
-    uint32_t r;
+	uint32_t s;
 
-    r = 0;
+	s = 0;
 
-    for (size_t i = 0; i < DILITHIUM_N / 8; ++i)
-    {
-        f0 = _mm256_load_si256((__m256i*)&A0[8 * i]);
-        f1 = _mm256_load_si256((__m256i*)&A1[8 * i]);
-
-        g0 = _mm256_cmpgt_epi32(blo, f0);
-        g1 = _mm256_cmpgt_epi32(f0, bhi);
-        g0 = _mm256_or_si256(g0, g1);
-        g1 = _mm256_cmpeq_epi32(f0, bhi);
-        f1 = _mm256_cmpeq_epi32(f1, zero);
-        g1 = _mm256_and_si256(g1, f1);
-        g0 = _mm256_or_si256(g0, g1);
-
-        r += _mm_popcnt_u32(_mm256_movemask_ps(_mm256_castsi256_ps(g0)));
-        g0 = _mm256_add_epi32(g0, one);
-        _mm256_store_si256((__m256i*)&H[8 * i], g0);
-    }
+	if (HasAvx2() == true)
+	{
+		s = DLTMKernels::PolyMakeHintAvx2(H.data(), A0.data(), A1.data(), Gamma2);
+	}
+	else
+	{
+		for (size_t i = 0; i < H.size(); ++i)
+		{
+			H[i] = MakeHint(A0[i], A1[i], Gamma2);
+			s += H[i];
+		}
+	}
 
-    return DILITHIUM_N - r;
+	return s;
 }
 
 void DLTMPolyMath::PolyPower2Round(std::array<int32_t, 256> &A1, std::array<int32_t, 256> &A0, const std::array<int32_t, 256> &A)
 {
-	__m256i f;
-	__m256i f0;
-	__m256i f1;
-	const __m256i mask = _mm256_set1_epi32(-(int32_t)(1U << DILITHIUM_D));
-	const __m256i half = _mm256_set1_epi32((1U << (DILITHIUM_D - 1)) - 1);
-
-	for (size_t i = 0; i < DILITHIUM_N / 8; ++i)
+	if (HasAvx2() == true)
 	{
-		f = _mm256_load_si256((__m256i*)&A[8 * i]);
-		f1 = _mm256_add_epi32(f, half);
-		f0 = _mm256_and_si256(f1, mask);
-		f1 = _mm256_srli_epi32(f1, DILITHIUM_D);
-		f0 = _mm256_sub_epi32(f, f0);
-		_mm256_store_si256((__m256i*)&A1[8 * i], f1);
-		_mm256_store_si256((__m256i*)&A0[8 * i], f0);
+		DLTMKernels::PolyPower2RoundAvx2(A1.data(), A0.data(), A.data());
+	}
+	else
+	{
+		for (size_t i = 0; i < A1.size(); ++i)
+		{
+			A1[i] = Power2Round(A[i], A0[i]);
+		}
 	}
 }
 
 void DLTMPolyMath::PolyReduce(std::array<int32_t, 256> &A)
 {
-    const __m256i q = _mm256_load_si256((__m256i*)&Avx2Q[0]);
-    const __m256i off = _mm256_set1_epi32(1 << 22);
-    __m256i f;
-    __m256i g;
-
-    for (size_t i = 0; i < DILITHIUM_N / 8; ++i)
-    {
-        f = _mm256_load_si256((__m256i*)&A[8 * i]);
-        g = _mm256_add_epi32(f, off);
-        g = _mm256_srai_epi32(g, 23);
-        g = _mm256_mullo_epi32(g, q);
-        f = _mm256_sub_epi32(f, g);
-        _mm256_store_si256((__m256i*)&A[8 * i], f);
-    }
+	if (HasAvx2() == true)
+	{
+		DLTMKernels::PolyReduceAvx2(A.data());
+	}
+	else
+	{
+		for (size_t i = 0; i < A.size(); ++i)
+		{
+			A[i] = Reduce32(A[i]);
+		}
+	}
 }
 
 void DLTMPolyMath::PolyShiftL(std::array<int32_t, 256> &A)
 {
-    __m256i vec;
-
-    for (size_t i = 0; i < DILITHIUM_N; i += 8)
-    {
-        vec = _mm256_load_si256((__m256i*)&A[i]);
-        vec = _mm256_slli_epi32(vec, DILITHIUM_D);
-        _mm256_store_si256((__m256i*)&A[i], vec);
-    }
+	if (HasAvx2() == true)
+	{
+		DLTMKernels::PolyShiftLAvx2(A.data());
+	}
+	else
+	{
+		for (size_t i = 0; i < A.size(); ++i)
+		{
+			A[i] <<= DILITHIUM_D;
+		}
+	}
 }
 
 void DLTMPolyMath::PolySub(std::array<int32_t, 256> &C, const std::array<int32_t, 256> &A, const std::array<int32_t, 256> &B)
 {
-    __m256i vec0;
-    __m256i vec1;
-
-    for (size_t i = 0; i < DILITHIUM_N; i += 8)
-    {
-        vec0 = _mm256_load_si256((__m256i*)&A[i]);
-        vec1 = _mm256_load_si256((__m256i*)&B[i]);
-        vec0 = _mm256_sub_epi32(vec0, vec1);
-        _mm256_store_si256((__m256i*)&C[i], vec0);
-    }
+	if (HasAvx2() == true)
+	{
+		DLTMKernels::PolySubAvx2(C.data(), A.data(), B.data());
+	}
+	else
+	{
+		for (size_t i = 0; i < C.size(); ++i)
+		{
+			C[i] = A[i] - B[i];
+		}
+	}
 }
 
 void DLTMPolyMath::PolyUseHint(std::array<int32_t, 256> &B, const std::array<int32_t, 256> &A, const std::array<int32_t, 256> &H, uint32_t Gamma2)
 {
-    CEX_ALIGN(32) std::array<int32_t, DILITHIUM_N> a0;
-    __m256i f;
-    __m256i g;
-    __m256i h;
-    __m256i t;
-    const __m256i zero = _mm256_setzero_si256();
-
-	if (Gamma2 == (DILITHIUM_Q - 1) / 32)
+	if (HasAvx2() == true)
 	{
-		const __m256i mask = _mm256_set1_epi32(15);
-		PolyDecompose(B, a0, A, Gamma2);
-
-		for (size_t i = 0; i < DILITHIUM_N / 8; i++)
-		{
-			f = _mm256_load_si256((__m256i*)&a0[8 * i]);
-			g = _mm256_load_si256((__m256i*)&B[8 * i]);
-			h = _mm256_load_si256((__m256i*)&H[8 * i]);
-			t = _mm256_blendv_epi32(zero, h, f);
-			t = _mm256_slli_epi32(t, 1);
-			h = _mm256_sub_epi32(h, t);
-			g = _mm256_add_epi32(g, h);
-			g = _mm256_and_si256(g, mask);
-			_mm256_store_si256((__m256i*) & B[8 * i], g);
-		}
+		DLTMKernels::PolyUseHintAvx2(B.data(), A.data(), H.data(), Gamma2);
 	}
-	else if (Gamma2 == (DILITHIUM_Q - 1) / 88)
+	else
 	{
-		const __m256i max = _mm256_set1_epi32(43);
-		PolyDecompose(B, a0, A, Gamma2);
-
-		for (size_t i = 0; i < DILITHIUM_N / 8; i++)
+		for (size_t i = 0; i < DILITHIUM_N; ++i)
 		{
-			f = _mm256_load_si256((__m256i*)&a0[8 * i]);
-			g = _mm256_load_si256((__m256i*)&B[8 * i]);
-			h = _mm256_load_si256((__m256i*)&H[8 * i]);
-			t = _mm256_blendv_epi32(zero, h, f);
-			t = _mm256_slli_epi32(t, 1);
-			h = _mm256_sub_epi32(h, t);
-			g = _mm256_add_epi32(g, h);
-			g = _mm256_blendv_epi32(g, max, g);
-			f = _mm256_cmpgt_epi32(g, max);
-			g = _mm256_blendv_epi32(g, zero, f);
-			_mm256_store_si256((__m256i*)&B[8 * i], g);
+			B[i] = UseHint(A[i], H[i], Gamma2);
 		}
 	}
 }
 
-size_t DLTMPolyMath::RejUniformAvx2(std::array<int32_t, 256> &R, size_t ROffset, size_t RLength, const std::vector<uint8_t> &Buffer, size_t BufLength)
-{
-    const __m256i bound = _mm256_set1_epi32(DILITHIUM_Q);
-    const __m256i mask = _mm256_set1_epi32(0x7FFFFF);
-    const __m256i idx8 = _mm256_set_epi8(-1, 15, 14, 13, -1, 12, 11, 10, -1, 9, 8, 7, -1, 6, 5, 4,
-        -1, 11, 10, 9, -1, 8, 7, 6, -1, 5, 4, 3, -1, 2, 1, 0);
-    __m256i d;
-    __m256i tmp;
-    size_t pos;
-    uint32_t ctr;
-    uint32_t good;
-    uint32_t t;
-
-    ctr = 0;
-    pos = 0;
-
-    while (pos <= BufLength - 24)
-    {
-        d = _mm256_loadu_si256((__m256i*)&Buffer[pos]);
-        d = _mm256_permute4x64_epi64(d, 0x94);
-        d = _mm256_shuffle_epi8(d, idx8);
-        d = _mm256_and_si256(d, mask);
-        pos += 24;
-
-        tmp = _mm256_sub_epi32(d, bound);
-        good = _mm256_movemask_ps(_mm256_castsi256_ps(tmp));
-        tmp = _mm256_cvtepu8_epi32(_mm_loadl_epi64((__m128i*)&RejAvx2[good]));
-        d = _mm256_permutevar8x32_epi32(d, tmp);
-        _mm256_storeu_si256((__m256i*)&R[ROffset + ctr], d);
-        ctr += _mm_popcnt_u32(good);
-
-        if (ctr > DILITHIUM_N - 8)
-        {
-            break;
-        }
-    }
-
-    while (ctr < DILITHIUM_N && pos <= BufLength - 3)
-    {
-        t = Buffer[pos];
-        ++pos;
-        t |= (uint32_t)Buffer[pos] << 8;
-        ++pos;
-        t |= (uint32_t)Buffer[pos] << 16;
-        ++pos;
-        t &= 0x7FFFFF;
-
-        if (t < DILITHIUM_Q)
-        {
-            R[ROffset + ctr] = t;
-            ++ctr;
-        }
-    }
-
-    return ctr;
-}
-
 void DLTMPolyMath::PolyUniform4x(std::array<int32_t, 256> &A0, std::array<int32_t, 256> &A1, std::array<int32_t, 256> &A2, std::array<int32_t, 256> &A3,
-    const std::vector<uint8_t> &Seed, uint16_t Nonce0, uint16_t Nonce1, uint16_t Nonce2, uint16_t Nonce3)
-{
-    std::vector<__m256i> ksi(Keccak::KECCAK_STATE_SIZE);
-	std::vector<std::vector<uint8_t>> buf(4);
-    __m256i f;
-    size_t ctr0;
-    size_t ctr1;
-    size_t ctr2;
-    size_t ctr3;
-	
-	buf[0].resize(864);
-	buf[1].resize(864);
-	buf[2].resize(864);
-	buf[3].resize(864);
-
-    f = _mm256_loadu_si256((__m256i*)Seed.data());
-    _mm256_store_si256((__m256i*)buf[0].data(), f);
-    _mm256_store_si256((__m256i*)buf[1].data(), f);
-    _mm256_store_si256((__m256i*)buf[2].data(), f);
-    _mm256_store_si256((__m256i*)buf[3].data(), f);
-
-    buf[0][DILITHIUM_SEED_SIZE] = (uint8_t)Nonce0;
-    buf[0][DILITHIUM_SEED_SIZE + 1] = (uint8_t)(Nonce0 >> 8);
-    buf[1][DILITHIUM_SEED_SIZE] = (uint8_t)Nonce1;
-    buf[1][DILITHIUM_SEED_SIZE + 1] = (uint8_t)(Nonce1 >> 8);
-    buf[2][DILITHIUM_SEED_SIZE] = (uint8_t)Nonce2;
-    buf[2][DILITHIUM_SEED_SIZE + 1] = (uint8_t)(Nonce2 >> 8);
-    buf[3][DILITHIUM_SEED_SIZE] = (uint8_t)Nonce3;
-    buf[3][DILITHIUM_SEED_SIZE + 1] = (uint8_t)(Nonce3 >> 8);
-
-    Keccak::AbsorbR24x1600H(ksi, Keccak::KECCAK128_RATE_SIZE, buf[0], buf[1], buf[2], buf[3], DILITHIUM_SEED_SIZE + 2, Keccak::KECCAK_SHAKE_DOMAIN);
-    Keccak::SqueezeBlocksR24x1600H(ksi, Keccak::KECCAK128_RATE_SIZE, buf[0], buf[1], buf[2], buf[3], 5);
-
-    ctr0 = RejUniformAvx2(A0, 0, A0.size(), buf[0], buf[0].size());
-    ctr1 = RejUniformAvx2(A1, 0, A1.size(), buf[1], buf[1].size());
-    ctr2 = RejUniformAvx2(A2, 0, A2.size(), buf[2], buf[2].size());
-    ctr3 = RejUniformAvx2(A3, 0, A3.size(), buf[3], buf[3].size());
-
-    while (ctr0 < DILITHIUM_N || ctr1 < DILITHIUM_N || ctr2 < DILITHIUM_N || ctr3 < DILITHIUM_N)
-    {
-        Keccak::SqueezeBlocksR24x1600H(ksi, Keccak::KECCAK128_RATE_SIZE, buf[0], buf[1], buf[2], buf[3], 1);
+	const std::vector<uint8_t> &Seed, uint16_t Nonce0, uint16_t Nonce1, uint16_t Nonce2, uint16_t Nonce3)
+{
+	// five squeezed blocks, and padding for the 8 byte overread of the vectorized sampler
+	const size_t BUFLEN = 5 * Keccak::KECCAK128_RATE_SIZE;
+	std::array<uint64_t, 4 * Keccak::KECCAK_STATE_SIZE> ksi = { 0 };
+	std::vector<std::vector<uint8_t>> buf(4, std::vector<uint8_t>(BUFLEN + 8));
+	size_t ctr0;
+	size_t ctr1;
+	size_t ctr2;
+	size_t ctr3;
+
+	MemoryTools::Copy(Seed, 0, buf[0], 0, DILITHIUM_SEED_SIZE);
+	MemoryTools::Copy(Seed, 0, buf[1], 0, DILITHIUM_SEED_SIZE);
+	MemoryTools::Copy(Seed, 0, buf[2], 0, DILITHIUM_SEED_SIZE);
+	MemoryTools::Copy(Seed, 0, buf[3], 0, DILITHIUM_SEED_SIZE);
+
+	buf[0][DILITHIUM_SEED_SIZE] = (uint8_t)Nonce0;
+	buf[0][DILITHIUM_SEED_SIZE + 1] = (uint8_t)(Nonce0 >> 8);
+	buf[1][DILITHIUM_SEED_SIZE] = (uint8_t)Nonce1;
+	buf[1][DILITHIUM_SEED_SIZE + 1] = (uint8_t)(Nonce1 >> 8);
+	buf[2][DILITHIUM_SEED_SIZE] = (uint8_t)Nonce2;
+	buf[2][DILITHIUM_SEED_SIZE + 1] = (uint8_t)(Nonce2 >> 8);
+	buf[3][DILITHIUM_SEED_SIZE] = (uint8_t)Nonce3;
+	buf[3][DILITHIUM_SEED_SIZE + 1] = (uint8_t)(Nonce3 >> 8);
+
+	KeccakKernels::AbsorbR24x1600H(ksi.data(), Keccak::KECCAK128_RATE_SIZE, buf[0].data(), buf[1].data(), buf[2].data(), buf[3].data(), DILITHIUM_SEED_SIZE + 2, Keccak::KECCAK_SHAKE_DOMAIN);
+	KeccakKernels::SqueezeBlocksR24x1600H(ksi.data(), Keccak::KECCAK128_RATE_SIZE, buf[0].data(), buf[1].data(), buf[2].data(), buf[3].data(), 5);
+
+	ctr0 = DLTMKernels::RejUniformAvx2(A0.data(), buf[0].data(), BUFLEN);
+	ctr1 = DLTMKernels::RejUniformAvx2(A1.data(), buf[1].data(), BUFLEN);
+	ctr2 = DLTMKernels::RejUniformAvx2(A2.data(), buf[2].data(), BUFLEN);
+	ctr3 = DLTMKernels::RejUniformAvx2(A3.data(), buf[3].data(), BUFLEN);
+
+	while (ctr0 < DILITHIUM_N || ctr1 < DILITHIUM_N || ctr2 < DILITHIUM_N || ctr3 < DILITHIUM_N)
+	{
+		KeccakKernels::SqueezeBlocksR24x1600H(ksi.data(), Keccak::KECCAK128_RATE_SIZE, buf[0].data(), buf[1].data(), buf[2].data(), buf[3].data(), 1);
 
-        ctr0 += RejUniform(A0, ctr0, DILITHIUM_N - ctr0, buf[0], Keccak::KECCAK128_RATE_SIZE);
-        ctr1 += RejUniform(A1, ctr1, DILITHIUM_N - ctr1, buf[1], Keccak::KECCAK128_RATE_SIZE);
-        ctr2 += RejUniform(A2, ctr2, DILITHIUM_N - ctr2, buf[2], Keccak::KECCAK128_RATE_SIZE);
-        ctr3 += RejUniform(A3, ctr3, DILITHIUM_N - ctr3, buf[3], Keccak::KECCAK128_RATE_SIZE);
-    }
+		ctr0 += RejUniform(A0, ctr0, DILITHIUM_N - ctr0, buf[0], Keccak::KECCAK128_RATE_SIZE);
+		ctr1 += RejUniform(A1, ctr1, DILITHIUM_N - ctr1, buf[1], Keccak::KECCAK128_RATE_SIZE);
+		ctr2 += RejUniform(A2, ctr2, DILITHIUM_N - ctr2, buf[2], Keccak::KECCAK128_RATE_SIZE);
+		ctr3 += RejUniform(A3, ctr3, DILITHIUM_N - ctr3, buf[3], Keccak::KECCAK128_RATE_SIZE);
+	}
 }
 
 void DLTMPolyMath::PolyUniformEta4x(std::array<int32_t, 256> &A0, std::array<int32_t, 256> &A1, std::array<int32_t, 256> &A2, std::array<int32_t, 256> &A3,
-    const std::vector<uint8_t> &Seed, uint16_t Nonce0, uint16_t Nonce1, uint16_t Nonce2, uint16_t Nonce3, size_t Blocks, uint32_t Eta)
-{
-    std::vector<__m256i> ksi(Keccak::KECCAK_STATE_SIZE);
-	std::vector<std::vector<uint8_t>> buf(4);
-    __m256i f;
-    size_t ctr0;
-    size_t ctr1;
-    size_t ctr2;
-    size_t ctr3;
-
-	if (Eta == 2)
-	{
-		buf[0].resize(192);
-		buf[1].resize(192);
-		buf[2].resize(192);
-		buf[3].resize(192);
-	}
-	else
+	const std::vector<uint8_t> &Seed, uint16_t Nonce0, uint16_t Nonce1, uint16_t Nonce2, uint16_t Nonce3, size_t Blocks, uint32_t Eta)
+{
+	std::array<uint64_t, 4 * Keccak::KECCAK_STATE_SIZE> ksi = { 0 };
+	std::vector<std::vector<uint8_t>> buf(4, std::vector<uint8_t>(Eta == 2 ? 192 : 352));
+	size_t ctr0;
+	size_t ctr1;
+	size_t ctr2;
+	size_t ctr3;
+
+	MemoryTools::Copy(Seed, 0, buf[0], 0, DILITHIUM_SEED_SIZE);
+	MemoryTools::Copy(Seed, 0, buf[1], 0, DILITHIUM_SEED_SIZE);
+	MemoryTools::Copy(Seed, 0, buf[2], 0, DILITHIUM_SEED_SIZE);
+	MemoryTools::Copy(Seed, 0, buf[3], 0, DILITHIUM_SEED_SIZE);
+
+	buf[0][DILITHIUM_SEED_SIZE] = (uint8_t)Nonce0;
+	buf[0][DILITHIUM_SEED_SIZE + 1] = (uint8_t)(Nonce0 >> 8);
+	buf[1][DILITHIUM_SEED_SIZE] = (uint8_t)Nonce1;
+	buf[1][DILITHIUM_SEED_SIZE + 1] = (uint8_t)(Nonce1 >> 8);
+	buf[2][DILITHIUM_SEED_SIZE] = (uint8_t)Nonce2;
+	buf[2][DILITHIUM_SEED_SIZE + 1] = (uint8_t)(Nonce2 >> 8);
+	buf[3][DILITHIUM_SEED_SIZE] = (uint8_t)Nonce3;
+	buf[3][DILITHIUM_SEED_SIZE + 1] = (uint8_t)(Nonce3 >> 8);
+
+	KeccakKernels::AbsorbR24x1600H(ksi.data(), Keccak::KECCAK128_RATE_SIZE, buf[0].data(), buf[1].data(), buf[2].data(), buf[3].data(), DILITHIUM_SEED_SIZE + 2, Keccak::KECCAK_SHAKE_DOMAIN);
+	KeccakKernels::SqueezeBlocksR24x1600H(ksi.data(), Keccak::KECCAK128_RATE_SIZE, buf[0].data(), buf[1].data(), buf[2].data(), buf[3].data(), Blocks);
+
+	ctr0 = RejEta(A0, 0, DILITHIUM_N, buf[0], Blocks * Keccak::KECCAK128_RATE_SIZE, Eta);
+	ctr1 = RejEta(A1, 0, DILITHIUM_N, buf[1], Blocks * Keccak::KECCAK128_RATE_SIZE, Eta);
+	ctr2 = RejEta(A2, 0, DILITHIUM_N, buf[2], Blocks * Keccak::KECCAK128_RATE_SIZE, Eta);
+	ctr3 = RejEta(A3, 0, DILITHIUM_N, buf[3], Blocks * Keccak::KECCAK128_RATE_SIZE, Eta);
+
+	while (ctr0 < DILITHIUM_N || ctr1 < DILITHIUM_N || ctr2 < DILITHIUM_N || ctr3 < DILITHIUM_N)
 	{
-		buf[0].resize(352);
-		buf[1].resize(352);
-		buf[2].resize(352);
-		buf[3].resize(352);
-	}
-
-    f = _mm256_load_si256((__m256i*)Seed.data());
-    _mm256_store_si256((__m256i*)buf[0].data(), f);
-    _mm256_store_si256((__m256i*)buf[1].data(), f);
-    _mm256_store_si256((__m256i*)buf[2].data(), f);
-    _mm256_store_si256((__m256i*)buf[3].data(), f);
+		KeccakKernels::SqueezeBlocksR24x1600H(ksi.data(), Keccak::KECCAK128_RATE_SIZE, buf[0].data(), buf[1].data(), buf[2].data(), buf[3].data(), 1);
 
-    buf[0][DILITHIUM_SEED_SIZE] = (uint8_t)Nonce0;
-    buf[0][DILITHIUM_SEED_SIZE + 1] = (uint8_t)(Nonce0 >> 8);
-    buf[1][DILITHIUM_SEED_SIZE] = (uint8_t)Nonce1;
-    buf[1][DILITHIUM_SEED_SIZE + 1] = (uint8_t)(Nonce1 >> 8);
-    buf[2][DILITHIUM_SEED_SIZE] = (uint8_t)Nonce2;
-    buf[2][DILITHIUM_SEED_SIZE + 1] = (uint8_t)(Nonce2 >> 8);
-    buf[3][DILITHIUM_SEED_SIZE] = (uint8_t)Nonce3;
-    buf[3][DILITHIUM_SEED_SIZE + 1] = (uint8_t)(Nonce3 >> 8);
+		ctr0 += RejEta(A0, ctr0, DILITHIUM_N - ctr0, buf[0], Keccak::KECCAK128_RATE_SIZE, Eta);
+		ctr1 += RejEta(A1, ctr1, DILITHIUM_N - ctr1, buf[1], Keccak::KECCAK128_RATE_SIZE, Eta);
+		ctr2 += RejEta(A2, ctr2, DILITHIUM_N - ctr2, buf[2], Keccak::KECCAK128_RATE_SIZE, Eta);
+		ctr3 += RejEta(A3, ctr3, DILITHIUM_N - ctr3, buf[3], Keccak::KECCAK128_RATE_SIZE, Eta);
+	}
+}
 
-    Keccak::AbsorbR24x1600H(ksi, Keccak::KECCAK128_RATE_SIZE, buf[0], buf[1], buf[2], buf[3], Seed.size() + 2, Keccak::KECCAK_SHAKE_DOMAIN);
-    Keccak::SqueezeBlocksR24x1600H(ksi, Keccak::KECCAK128_RATE_SIZE, buf[0], buf[1], buf[2], buf[3], Blocks);
+void DLTMPolyMath::PolyUniformGamma1x4(std::array<int32_t, 256> &A0, std::array<int32_t, 256> &A1, std::array<int32_t, 256> &A2, std::array<int32_t, 256> &A3,
+	const std::vector<uint8_t> &Seed, uint16_t Nonce0, uint16_t Nonce1, uint16_t Nonce2, uint16_t Nonce3, uint32_t Gamma1)
+{
+	std::array<uint64_t, 4 * Keccak::KECCAK_STATE_SIZE> ksi = { 0 };
+	std::vector<std::vector<uint8_t>> buf(4, std::vector<uint8_t>(704));
 
-    ctr0 = RejEta(A0, 0, DILITHIUM_N, buf[0], Blocks * Keccak::KECCAK128_RATE_SIZE, Eta);
-    ctr1 = RejEta(A1, 0, DILITHIUM_N, buf[1], Blocks * Keccak::KECCAK128_RATE_SIZE, Eta);
-    ctr2 = RejEta(A2, 0, DILITHIUM_N, buf[2], Blocks * Keccak::KECCAK128_RATE_SIZE, Eta);
-    ctr3 = RejEta(A3, 0, DILITHIUM_N, buf[3], Blocks * Keccak::KECCAK128_RATE_SIZE, Eta);
+	MemoryTools::Copy(Seed, 0, buf[0], 0, DILITHIUM_CRH_SIZE);
+	MemoryTools::Copy(Seed, 0, buf[1], 0, DILITHIUM_CRH_SIZE);
+	MemoryTools::Copy(Seed, 0, buf[2], 0, DILITHIUM_CRH_SIZE);
+	MemoryTools::Copy(Seed, 0, buf[3], 0, DILITHIUM_CRH_SIZE);
 
-    while (ctr0 < DILITHIUM_N || ctr1 < DILITHIUM_N || ctr2 < DILITHIUM_N || ctr3 < DILITHIUM_N)
-    {
-        Keccak::SqueezeBlocksR24x1600H(ksi, Keccak::KECCAK128_RATE_SIZE, buf[0], buf[1], buf[2], buf[3], 1);
+	buf[0][DILITHIUM_CRH_SIZE] = (uint8_t)Nonce0;
+	buf[0][DILITHIUM_CRH_SIZE + 1] = (uint8_t)(Nonce0 >> 8);
+	buf[1][DILITHIUM_CRH_SIZE] = (uint8_t)Nonce1;
+	buf[1][DILITHIUM_CRH_SIZE + 1] = (uint8_t)(Nonce1 >> 8);
+	buf[2][DILITHIUM_CRH_SIZE] = (uint8_t)Nonce2;
+	buf[2][DILITHIUM_CRH_SIZE + 1] = (uint8_t)(Nonce2 >> 8);
+	buf[3][DILITHIUM_CRH_SIZE] = (uint8_t)Nonce3;
+	buf[3][DILITHIUM_CRH_SIZE + 1] = (uint8_t)(Nonce3 >> 8);
 
-        ctr0 += RejEta(A0, ctr0, DILITHIUM_N - ctr0, buf[0], Keccak::KECCAK128_RATE_SIZE, Eta);
-        ctr1 += RejEta(A1, ctr1, DILITHIUM_N - ctr1, buf[1], Keccak::KECCAK128_RATE_SIZE, Eta);
-        ctr2 += RejEta(A2, ctr2, DILITHIUM_N - ctr2, buf[2], Keccak::KECCAK128_RATE_SIZE, Eta);
-        ctr3 += RejEta(A3, ctr3, DILITHIUM_N - ctr3, buf[3], Keccak::KECCAK128_RATE_SIZE, Eta);
-    }
-}
+	KeccakKernels::AbsorbR24x1600H(ksi.data(), Keccak::KECCAK256_RATE_SIZE, buf[0].data(), buf[1].data(), buf[2].data(), buf[3].data(), DILITHIUM_CRH_SIZE + 2, Keccak::KECCAK_SHAKE_DOMAIN);
+	KeccakKernels::SqueezeBlocksR24x1600H(ksi.data(), Keccak::KECCAK256_RATE_SIZE, buf[0].data(), buf[1].data(), buf[2].data(), buf[3].data(), 5);
 
-void DLTMPolyMath::PolyUniformGamma1x4(std::array<int32_t, 256> &A0, std::array<int32_t, 256> &A1, std::array<int32_t, 256> &A2, std::array<int32_t, 256> &A3,
-    const std::vector<uint8_t> &Seed, uint16_t Nonce0, uint16_t Nonce1, uint16_t Nonce2, uint16_t Nonce3, uint32_t Gamma1)
-{
-    std::vector<__m256i> ksi(Keccak::KECCAK_STATE_SIZE);
-	std::vector<std::vector<uint8_t>> buf(4);
-    __m256i f;
-    __m128i g;
-
-	buf[0].resize(704);
-	buf[1].resize(704);
-	buf[2].resize(704);
-	buf[3].resize(704);
-
-    f = _mm256_load_si256((__m256i*)Seed.data());
-    _mm256_store_si256((__m256i*)buf[0].data(), f);
-    _mm256_store_si256((__m256i*)buf[1].data(), f);
-    _mm256_store_si256((__m256i*)buf[2].data(), f);
-    _mm256_store_si256((__m256i*)buf[3].data(), f);
-    g = _mm_load_si128((__m128i*)&Seed[32]);
-    _mm_store_si128((__m128i*)&buf[0][32], g);
-    _mm_store_si128((__m128i*)&buf[1][32], g);
-    _mm_store_si128((__m128i*)&buf[2][32], g);
-    _mm_store_si128((__m128i*)&buf[3][32], g);
-
-    buf[0][DILITHIUM_CRH_SIZE] = (uint8_t)Nonce0;
-    buf[0][DILITHIUM_CRH_SIZE + 1] = (uint8_t)(Nonce0 >> 8);
-    buf[1][DILITHIUM_CRH_SIZE] = (uint8_t)Nonce1;
-    buf[1][DILITHIUM_CRH_SIZE + 1] = (uint8_t)(Nonce1 >> 8);
-    buf[2][DILITHIUM_CRH_SIZE] = (uint8_t)Nonce2;
-    buf[2][DILITHIUM_CRH_SIZE + 1] = (uint8_t)(Nonce2 >> 8);
-    buf[3][DILITHIUM_CRH_SIZE] = (uint8_t)Nonce3;
-    buf[3][DILITHIUM_CRH_SIZE + 1] = (uint8_t)(Nonce3 >> 8);
-
-    Keccak::AbsorbR24x1600H(ksi, Keccak::KECCAK256_RATE_SIZE, buf[0], buf[1], buf[2], buf[3], DILITHIUM_CRH_SIZE + 2, Keccak::KECCAK_SHAKE_DOMAIN);
-    Keccak::SqueezeBlocksR24x1600H(ksi, Keccak::KECCAK256_RATE_SIZE, buf[0], buf[1], buf[2], buf[3], 5);
-
-    PolyZUnpack(A0, buf[0], 0, Gamma1);
-    PolyZUnpack(A1, buf[1], 0, Gamma1);
-    PolyZUnpack(A2, buf[2], 0, Gamma1);
-    PolyZUnpack(A3, buf[3], 0, Gamma1);
+	PolyZUnpack(A0, buf[0], 0, Gamma1);
+	PolyZUnpack(A1, buf[1], 0, Gamma1);
+	PolyZUnpack(A2, buf[2], 0, Gamma1);
+	PolyZUnpack(A3, buf[3], 0, Gamma1);
 }
 
 void DLTMPolyMath::PolyW1Pack(std::vector<uint8_t> &R, size_t ROffset, const std::array<int32_t, 256> &A, uint32_t Gamma2)
 {
+	size_t i;
+
 	if (Gamma2 == (DILITHIUM_Q - 1) / 88)
 	{
-		for (size_t i = 0; i < DILITHIUM_N / 4; ++i)
+		for (i = 0; i < DILITHIUM_N / 4; ++i)
 		{
-			R[ROffset + (3 * i)] = A[4 * i];
-			R[ROffset + (3 * i)] |= A[4 * i + 1] << 6;
-			R[ROffset + (3 * i) + 1] = A[4 * i + 1] >> 2;
-			R[ROffset + (3 * i) + 1] |= A[4 * i + 2] << 4;
-			R[ROffset + (3 * i) + 2] = A[4 * i + 2] >> 4;
-			R[ROffset + (3 * i) + 2] |= A[4 * i + 3] << 2;
+			R[ROffset + 3 * i] = (uint8_t)A[4 * i];
+			R[ROffset + 3 * i] |= (uint8_t)(A[(4 * i) + 1] << 6);
+			R[ROffset + (3 * i) + 1] = (uint8_t)(A[(4 * i) + 1] >> 2);
+			R[ROffset + (3 * i) + 1] |= (uint8_t)(A[(4 * i) + 2] << 4);
+			R[ROffset + (3 * i) + 2] = (uint8_t)(A[(4 * i) + 2] >> 4);
+			R[ROffset + (3 * i) + 2] |= (uint8_t)(A[(4 * i) + 3] << 2);
 		}
 	}
 	else if (Gamma2 == (DILITHIUM_Q - 1) / 32)
 	{
-		const __m256i mask = _mm256_set1_epi64x(0xFF00FF00FF00FF00);
-		const __m256i idx = _mm256_set_epi8(15, 13, 14, 12, 11, 9, 10, 8, 7, 5, 6, 4, 3, 1, 2, 0,
-			15, 13, 14, 12, 11, 9, 10, 8, 7, 5, 6, 4, 3, 1, 2, 0);
-		__m256i f0;
-		__m256i f1;
-		__m256i f2;
-		__m256i f3;
-		__m256i f4;
-		__m256i f5;
-		__m256i f6;
-		__m256i f7;
-		size_t i;
-
-		for (i = 0; i < DILITHIUM_N / 64; ++i)
+		if (HasAvx2() == true)
 		{
-			f0 = _mm256_load_si256((__m256i*)&A[64 * i]);
-			f1 = _mm256_load_si256((__m256i*)&A[64 * i + 8]);
-			f2 = _mm256_load_si256((__m256i*)&A[64 * i + 16]);
-			f3 = _mm256_load_si256((__m256i*)&A[64 * i + 24]);
-
-			f0 = _mm256_and_si256(f0, _mm256_set1_epi32(15));
-			f1 = _mm256_and_si256(f1, _mm256_set1_epi32(15));
-			f2 = _mm256_and_si256(f2, _mm256_set1_epi32(15));
-			f3 = _mm256_and_si256(f3, _mm256_set1_epi32(15));
-
-			f0 = _mm256_packus_epi32(f0, f1);
-			f4 = _mm256_load_si256((__m256i*)&A[64 * i + 32]);
-			f5 = _mm256_load_si256((__m256i*)&A[64 * i + 40]);
-
-			f1 = _mm256_packus_epi32(f2, f3);
-			f6 = _mm256_load_si256((__m256i*)&A[64 * i + 48]);
-			f7 = _mm256_load_si256((__m256i*)&A[64 * i + 56]);
-
-			f4 = _mm256_and_si256(f4, _mm256_set1_epi32(15));
-			f5 = _mm256_and_si256(f5, _mm256_set1_epi32(15));
-			f6 = _mm256_and_si256(f6, _mm256_set1_epi32(15));
-			f7 = _mm256_and_si256(f7, _mm256_set1_epi32(15));
-
-			f2 = _mm256_packus_epi32(f4, f5);
-			f3 = _mm256_packus_epi32(f6, f7);
-			f0 = _mm256_packus_epi16(f0, f1);
-			f1 = _mm256_packus_epi16(f2, f3);
-			f2 = _mm256_permute2x128_si256(f0, f1, 0x20);	// ABCD
-			f3 = _mm256_permute2x128_si256(f0, f1, 0x31);	// EFGH
-
-			f4 = _mm256_srli_epi16(f2, 8);					// B0D0
-			f5 = _mm256_slli_epi16(f3, 8);					// 0E0G
-			f0 = _mm256_blendv_epi8(f2, f5, mask);			// AECG
-			f1 = _mm256_blendv_epi8(f4, f3, mask);			// BFDH
-
-			f1 = _mm256_slli_epi16(f1, 4);
-			f0 = _mm256_add_epi16(f0, f1);
-
-			f0 = _mm256_shuffle_epi8(f0, idx);
-			_mm256_storeu_si256((__m256i*)&R[ROffset + (32 * i)], f0);
+			DLTMKernels::PolyW1PackAvx2(R.data() + ROffset, A.data());
 		}
-    }
+		else
+		{
+			for (i = 0; i < DILITHIUM_N / 2; ++i)
+			{
+				R[ROffset + i] = (uint8_t)(A[2 * i] | (A[(2 * i) + 1] << 4));
+			}
+		}
+	}
 }
 
 void DLTMPolyMath::PolyVecMatrixExpandAvx2(std::vector<std::vector<std::array<int32_t, 256>>> &Matrix, const std::vector<uint8_t> &Rho, uint32_t K, uint32_t L)
@@ -818,158 +519,6 @@ void DLTMPolyMath::PolyVecMatrixExpandRow(std::vector<std::vector<std::array<int
 	}
 }
 
-#else
-
-void DLTMPolyMath::PolyAdd(std::array<int32_t, 256> &C, const std::array<int32_t, 256> &A, const std::array<int32_t, 256> &B)
-{
-	for (size_t i = 0; i < C.size(); ++i)
-	{
-		C[i] = A[i] + B[i];
-	}
-}
-
-void DLTMPolyMath::PolyCaddQ(std::array<int32_t, 256> &A)
-{
-    for (size_t i = 0; i < A.size(); ++i)
-    {
-        A[i] = CaddQ(A[i]);
-    }
-}
-
-int32_t DLTMPolyMath::PolyChkNorm(const std::array<int32_t, 256> &A, uint32_t B)
-{
-	int32_t t;
-    int32_t res;
-
-    res = 0;
-
-    if (B > (DILITHIUM_Q - 1) / 8)
-    {
-        res = 1;
-    }
-    else
-    {
-        // It is ok to leak which coefficient violates the bound since
-        // the probability for each coefficient is independent of secret
-        // data but we must not leak the sign of the centralized representative.
-        for (size_t i = 0; i < DILITHIUM_N; ++i)
-        {
-            // absolute value
-            t = A[i] >> 31;
-            t = A[i] - (t & 2 * A[i]);
-
-            if (t >= (int32_t)B)
-            {
-                res = 1;
-                break;
-            }
-        }
-    }
-
-    return res;
-}
-
-
-void DLTMPolyMath::PolyDecompose(std::array<int32_t, 256> &A1, std::array<int32_t, 256> &A0, const std::array<int32_t, 256> &A, uint32_t Gamma2)
-{
-	size_t i;
-
-	for (i = 0; i < A1.size(); ++i)
-	{
-		A1[i] = Decompose(A0[i], A[i], Gamma2);
-	}
-}
-
-uint32_t DLTMPolyMath::PolyMakeHint(std::array<int32_t, 256> &H, const std::array<int32_t, 256> &A0, const std::array<int32_t, 256> &A1, uint32_t Gamma2)
-{
-    uint32_t s;
-
-    s = 0;
-
-    for (size_t i = 0; i < H.size(); ++i)
-    {
-        H[i] = MakeHint(A0[i], A1[i], Gamma2);
-        s += H[i];
-    }
-
-    return s;
-}
-
-void DLTMPolyMath::PolyPower2Round(std::array<int32_t, 256> &A1, std::array<int32_t, 256> &A0, const std::array<int32_t, 256> &A)
-{
-	size_t i;
-
-	for (i = 0; i < A1.size(); ++i)
-	{
-		A1[i] = Power2Round(A[i], A0[i]);
-	}
-}
-
-void DLTMPolyMath::PolyReduce(std::array<int32_t, 256> &A)
-{
-	size_t i;
-
-	for (i = 0; i < A.size(); ++i)
-	{
-		A[i] = Reduce32(A[i]);
-	}
-}
-
-void DLTMPolyMath::PolyShiftL(std::array<int32_t, 256> &A)
-{
-	size_t i;
-
-	for (i = 0; i < A.size(); ++i)
-	{
-		A[i] <<= DILITHIUM_D;
-	}
-}
-
-void DLTMPolyMath::PolySub(std::array<int32_t, 256> &C, const std::array<int32_t, 256> &A, const std::array<int32_t, 256> &B)
-{
-	size_t i;
-
-	for (i = 0; i < C.size(); ++i)
-	{
-		C[i] = A[i] - B[i];
-	}
-}
-
-void DLTMPolyMath::PolyUseHint(std::array<int32_t, 256> &B, const std::array<int32_t, 256> &A, const std::array<int32_t, 256> &H, uint32_t Gamma2)
-{
-	size_t i;
-
-    for (i = 0; i < DILITHIUM_N; ++i)
-    {
-        B[i] = UseHint(A[i], H[i], Gamma2);
-    }
-}
-
-void DLTMPolyMath::PolyW1Pack(std::vector<uint8_t> &R, size_t ROffset, const std::array<int32_t, 256> &A, uint32_t Gamma2)
-{
-	size_t i;
-
-	if (Gamma2 == (DILITHIUM_Q - 1) / 88)
-	{
-		for (i = 0; i < DILITHIUM_N / 4; ++i)
-		{
-			R[ROffset + 3 * i] = (uint8_t)A[4 * i];
-			R[ROffset + 3 * i] |= (uint8_t)(A[(4 * i) + 1] << 6);
-			R[ROffset + (3 * i) + 1] = (uint8_t)(A[(4 * i) + 1] >> 2);
-			R[ROffset + (3 * i) + 1] |= (uint8_t)(A[(4 * i) + 2] << 4);
-			R[ROffset + (3 * i) + 2] = (uint8_t)(A[(4 * i) + 2] >> 4);
-			R[ROffset + (3 * i) + 2] |= (uint8_t)(A[(4 * i) + 3] << 2);
-		}
-	}
-	else if (Gamma2 == (DILITHIUM_Q - 1) / 32)
-	{
-		for (i = 0; i < DILITHIUM_N / 2; ++i)
-		{
-			R[ROffset + i] = (uint8_t)(A[2 * i] | (A[(2 * i) + 1] << 4));
-		}
-	}
-}
-
 void DLTMPolyMath::PolyVecPackW1(std::vector<uint8_t> &R, const std::vector<std::array<int32_t, 256>> &W1, size_t W1PackedSize, uint32_t Gamma2)
 {
     for (size_t i = 0; i < W1.size(); ++i)
@@ -978,8 +527,6 @@ void DLTMPolyMath::PolyVecPackW1(std::vector<uint8_t> &R, const std::vector<std:
     }
 }
 
-#endif
-
 // ntt.c //
 
 void DLTMPolyMath::InvNttToMont(std::array<int32_t, 256> &A)
@@ -53,8 +53,6 @@ private:
 	static const size_t DILITHIUM_POLW1_SIZE_PACKED = ((DILITHIUM_N * 4) / 8);
 	// roots of unity in order needed by forward ntt
 	static const uint32_t Zetas[DILITHIUM_N];
-	static const int32_t Avx2Q[8];
-	static const int32_t Avx2QINV[8];
 
 public:
 
@@ -130,14 +128,13 @@ public:
 	// sign.c //
 	static void ExpandMat(std::vector<std::vector<std::array<int32_t, 256>>> &Matrix, const std::vector<uint8_t> &Rho);
 
-#if defined(CEX_HAS_AVX2)
-	static size_t RejUniformAvx2(std::array<int32_t, 256> &A, size_t AOffset, size_t ALength, const std::vector<uint8_t> &Buffer, size_t BufLength);
+	// avx2 //
+	static bool HasAvx2();
 	static void PolyUniform4x(std::array<int32_t, 256> &A0, std::array<int32_t, 256> &A1, std::array<int32_t, 256> &A2, std::array<int32_t, 256> &A3, const std::vector<uint8_t> &Seed, uint16_t Nonce0, uint16_t Nonce1, uint16_t Nonce2, uint16_t Nonce3);
 	static void PolyUniformEta4x(std::array<int32_t, 256> &A0, std::array<int32_t, 256> &A1, std::array<int32_t, 256> &A2, std::array<int32_t, 256> &A3, const std::vector<uint8_t> &Seed, uint16_t Nonce0, uint16_t Nonce1, uint16_t Nonce2, uint16_t Nonce3, size_t Blocks, uint32_t Eta);
 	static void PolyUniformGamma1x4(std::array<int32_t, 256> &A0, std::array<int32_t, 256> &A1, std::array<int32_t, 256> &A2, std::array<int32_t, 256> &A3, const std::vector<uint8_t> &Seed, uint16_t Nonce0, uint16_t Nonce1, uint16_t Nonce2, uint16_t Nonce3, uint32_t Gamma1);
 	static void PolyVecMatrixExpandAvx2(std::vector<std::vector<std::array<int32_t, 256>>> &Matrix, const std::vector<uint8_t> &Rho, uint32_t K, uint32_t L);
 	static void PolyVecMatrixExpandRow(std::vector<std::vector<std::array<int32_t, 256>>> &Matrix, const std::vector<uint8_t> &Rho, uint32_t K, uint32_t L, size_t Index);
-#endif
 
 };
 
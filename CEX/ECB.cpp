@@ -2,6 +2,7 @@
 #include "BlockCipherFromName.h"
 #include "IntegerTools.h"
 #include "ParallelTools.h"
+#include "SegmentScratch.h"
 
 NAMESPACE_MODE
 
@@ -9,22 +10,23 @@ using Enumeration::BlockCipherConvert;
 using Enumeration::CipherModeConvert;
 using Tools::IntegerTools;
 using Tools::ParallelTools;
+using Tools::SegmentScratch;
 
 class ECB::EcbState
 {
 public:
 
+	SegmentScratch Segments;
 	bool Destroyed;
 	bool Encryption;
 	bool Initialized;
-	bool IsRijndael;
 
 	EcbState(bool IsDestroyed)
 		:
+		Segments(),
 		Destroyed(IsDestroyed),
 		Encryption(false),
-		Initialized(false),
-		IsRijndael(false)
+		Initialized(false)
 	{
 	}
 
@@ -35,10 +37,10 @@ public:
 
 	void Reset()
 	{
+		Segments.Clear();
 		Destroyed = false;
 		Encryption = false;
 		Initialized = false;
-		IsRijndael = false;
 	}
 };
 
@@ -53,6 +55,7 @@ ECB::ECB(BlockCiphers CipherType)
 		throw CryptoCipherModeException(CipherModeConvert::ToName(CipherModes::ECB), std::string("Constructor"), std::string("The cipher type can not be none!"), ErrorCodes::InvalidParam)),
 	m_parallelProfile(BLOCK_SIZE, true, m_blockCipher->StateCacheSize(), true)
 {
+	m_parallelProfile.SetAlgorithm(Name());
 }
 
 ECB::ECB(IBlockCipher* Cipher)
@@ -63,6 +66,7 @@ ECB::ECB(IBlockCipher* Cipher)
 		throw CryptoCipherModeException(CipherModeConvert::ToName(CipherModes::ECB), std::string("Constructor"), std::string("The cipher type can not be null!"), ErrorCodes::IllegalOperation)),
 	m_parallelProfile(BLOCK_SIZE, true, m_blockCipher->StateCacheSize(), true)
 {
+	m_parallelProfile.SetAlgorithm(Name());
 }
 
 ECB::~ECB()
@@ -160,6 +164,13 @@ void ECB::DecryptBlock(const std::vector<uint8_t> &Input, size_t InOffset, std::
 	Decrypt128(Input, InOffset, Output, OutOffset);
 }
 
+void ECB::DecryptBlock(const uint8_t* Input, uint8_t* Output)
+{
+	CEXASSERT(IsInitialized(), "The cipher mode has not been initialized!");
+
+	m_blockCipher->DecryptBlock(Input, Output);
+}
+
 void ECB::EncryptBlock(const std::vector<uint8_t> &Input, std::vector<uint8_t> &Output)
 {
 	CEXASSERT(IsInitialized(), "The cipher mode has not been initialized!");
@@ -174,6 +185,13 @@ void ECB::EncryptBlock(const std::vector<uint8_t> &Input, size_t InOffset, std::
 	Encrypt128(Input, InOffset, Output, OutOffset);
 }
 
+void ECB::EncryptBlock(const uint8_t* Input, uint8_t* Output)
+{
+	CEXASSERT(IsInitialized(), "The cipher mode has not been initialized!");
+
+	m_blockCipher->EncryptBlock(Input, Output);
+}
+
 void ECB::Initialize(bool Encryption, ISymmetricKey &Parameters)
 {
 	if (!SymmetricKeySize::Contains(LegalKeySizes(), Parameters.KeySizes().KeySize()))
@@ -194,7 +212,6 @@ void ECB::Initialize(bool Encryption, ISymmetricKey &Parameters)
 	}
 
 
-	m_ecbState->IsRijndael = IsRijndael();
 	m_blockCipher->Initialize(Encryption, Parameters);
 	m_ecbState->Encryption = Encryption;
 	m_ecbState->Initialized = true;
@@ -242,6 +259,17 @@ void ECB::Transform(const std::vector<uint8_t> &Input, size_t InOffset, std::vec
 	}
 }
 
+void ECB::Transform(const uint8_t* Input, uint8_t* Output, size_t Length)
+{
+	CEXASSERT(IsInitialized(), "The cipher mode has not been initialized!");
+
+	// each segment is processed by the vector transform, retaining its parallel and wide block paths
+	m_ecbState->Segments.Stage(Input, Output, Length, m_parallelProfile.ParallelBlockSize(), [this](const std::vector<uint8_t> &Source, std::vector<uint8_t> &Target, size_t Count)
+	{
+		Transform(Source, 0, Target, 0, Count);
+	});
+}
+
 //~~~Private Functions~~~//
 
 void ECB::Decrypt128(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset)
@@ -267,80 +295,21 @@ void ECB::Generate(const std::vector<uint8_t> &Input, size_t InOffset, std::vect
 
 	bctr = BlockCount;
 
-#if defined(CEX_HAS_AVX512)
-	if (m_ecbState->IsRijndael)
-	{
-		if (bctr > 4)
-		{
-			// 512bit avx
-			const size_t AVX512BLK = 64;
-			rctr = (bctr / 4);
-
-			while (rctr != 0)
-			{
-				// transform 16 blocks
-				m_blockCipher->Transform512(Input, InOffset, Output, OutOffset);
-				InOffset += AVX512BLK;
-				OutOffset += AVX512BLK;
-				bctr -= 4;
-				--rctr;
-			}
-		}
-	}
-	else
-	{
-		if (bctr > 15)
-		{
-			// serpent: uses a larger block
-			const size_t AVX512BLK = 256;
-			rctr = (bctr / 16);
-
-			while (rctr != 0)
-			{
-				// transform 16 blocks
-				m_blockCipher->Transform2048(Input, InOffset, Output, OutOffset);
-				InOffset += AVX512BLK;
-				OutOffset += AVX512BLK;
-				bctr -= 16;
-				--rctr;
-			}
-		}
-	}
-#elif defined(CEX_HAS_AVX2)
-	if (bctr > 7)
-	{
-		// 256bit avx
-		const size_t AVX2BLK = 128;
-		rctr = (bctr / 8);
-
-		while (rctr != 0)
-		{
-			// 8 blocks
-			m_blockCipher->Transform1024(Input, InOffset, Output, OutOffset);
-			InOffset += AVX2BLK;
-			OutOffset += AVX2BLK;
-			bctr -= 8;
-			--rctr;
-		}
-	}
-#elif defined(CEX_HAS_AVX)
-	if (bctr > 3)
+	if (bctr > 15)
 	{
-		// 128bit sse3
-		const size_t AVXBLK = 64;
-		rctr = (bctr / 4);
+		// 16 blocks; the cipher selects its widest kernel at run-time
+		const size_t WIDBLK = 256;
+		rctr = (bctr / 16);
 
 		while (rctr != 0)
 		{
-			// 4 blocks
-			m_blockCipher->Transform512(Input, InOffset, Output, OutOffset);
-			InOffset += AVXBLK;
-			OutOffset += AVXBLK;
-			bctr -= 4;
+			m_blockCipher->Transform2048(Input, InOffset, Output, OutOffset, BlockCount * BLOCK_SIZE);
+			InOffset += WIDBLK;
+			OutOffset += WIDBLK;
+			bctr -= 16;
 			--rctr;
 		}
 	}
-#endif
 
 	while (bctr != 0)
 	{
@@ -351,36 +320,13 @@ void ECB::Generate(const std::vector<uint8_t> &Input, size_t InOffset, std::vect
 	}
 }
 
-bool ECB::IsRijndael()
-{
-	bool res;
-
-	switch (m_blockCipher->Enumeral())
-	{
-		case BlockCiphers::AES:
-		case BlockCiphers::RHXH256:
-		case BlockCiphers::RHXH512:
-		case BlockCiphers::RHXS256:
-		case BlockCiphers::RHXS512:
-		{
-			res = true;
-			break;
-		}
-		default:
-		{
-			res = false;
-		}
-	}
-
-	return res;
-}
-
 void ECB::ProcessParallel(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset)
 {
-	const size_t SEGLEN = m_parallelProfile.ParallelBlockSize() / m_parallelProfile.ParallelMaxDegree();
+	const size_t SEGCNT = m_parallelProfile.ParallelSegmentCount();
+	const size_t SEGLEN = m_parallelProfile.ParallelBlockSize() / SEGCNT;
 	const size_t BLKCNT = (SEGLEN / BLOCK_SIZE);
 
-	ParallelTools::ParallelFor(0, m_parallelProfile.ParallelMaxDegree(), [this, &Input, InOffset, &Output, OutOffset, SEGLEN, BLKCNT](size_t i)
+	ParallelTools::ParallelFor(m_parallelProfile, Output.data() + OutOffset, 0, SEGCNT, [this, &Input, InOffset, &Output, OutOffset, SEGLEN, BLKCNT](size_t i)
 	{
 		this->Generate(Input, InOffset + (i * SEGLEN), Output, OutOffset + (i * SEGLEN), BLKCNT);
 	});
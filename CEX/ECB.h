@@ -235,6 +235,16 @@ public:
 	/// <param name="OutOffset">Starting offset within the output vector</param>
 	void DecryptBlock(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset) override;
 
+	/// <summary>
+	/// Decrypt a block of bytes in the callers memory.
+	/// <para>Decrypts one block of bytes without copying it to a vector; Input and Output may be the same address.
+	/// Initialize(bool, ISymmetricKey) must be called before this method can be used.</para>
+	/// </summary>
+	/// 
+	/// <param name="Input">A pointer to the block of cipher-text bytes</param>
+	/// <param name="Output">A pointer to the block of plain-text bytes</param>
+	void DecryptBlock(const uint8_t* Input, uint8_t* Output) override;
+
 	/// <summary>
 	/// Encrypt a single block of bytes. 
 	/// <para>Encrypts one block of bytes beginning at a zero index.
@@ -257,6 +267,16 @@ public:
 	/// <param name="OutOffset">Starting offset within the output vector</param>
 	void EncryptBlock(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset) override;
 
+	/// <summary>
+	/// Encrypt a block of bytes in the callers memory.
+	/// <para>Encrypts one block of bytes without copying it to a vector; Input and Output may be the same address.
+	/// Initialize(bool, ISymmetricKey) must be called before this method can be used.</para>
+	/// </summary>
+	/// 
+	/// <param name="Input">A pointer to the block of plain-text bytes</param>
+	/// <param name="Output">A pointer to the block of cipher-text bytes</param>
+	void EncryptBlock(const uint8_t* Input, uint8_t* Output) override;
+
 	/// <summary>
 	/// Initialize the Cipher instance
 	/// </summary>
@@ -293,12 +313,24 @@ public:
 	/// <param name="Length">The number of bytes to transform</param>
 	void Transform(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length) override;
 
+	/// <summary>
+	/// Transform a length of bytes in the callers memory. 
+	/// <para>The pointer form of Transform, for buffers that are not held in a vector, such as pooled, mapped or scatter-gather memory.
+	/// Each segment is staged through a working buffer of ParallelBlockSize() bytes and processed by the vector transform, so the message is never copied in full;
+	/// Input and Output may be the same address for an in-place transform, but must not otherwise overlap.
+	/// Initialize(bool, ISymmetricKey) must be called before this method can be used.</para>
+	/// </summary>
+	/// 
+	/// <param name="Input">A pointer to the bytes to transform</param>
+	/// <param name="Output">A pointer to the transformed bytes</param>
+	/// <param name="Length">The number of bytes to transform</param>
+	void Transform(const uint8_t* Input, uint8_t* Output, size_t Length) override;
+
 private:
 
 	void Decrypt128(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset);
 	void Encrypt128(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset);
 	void Generate(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t BlockCount);
-	bool IsRijndael();
 	void ProcessParallel(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset);
 	void ProcessSequential(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length);
 };
@@ -414,7 +414,7 @@ std::vector<uint8_t> ECP::ProcessInfo()
 std::vector<uint8_t> ECP::ProcessorInfo()
 {
 	std::vector<uint8_t> state(0);
-	CpuDetect dtc;
+	CpuDetect &dtc = CpuDetect::Instance();
 
 	ArrayTools::AppendValue(dtc.BusRefFrequency(), state);
 	ArrayTools::AppendValue(dtc.FrequencyBase(), state);
@@ -1,6 +1,8 @@
 #include "GCM.h"
 #include "IntegerTools.h"
 #include "MemoryTools.h"
+#include "ParallelTools.h"
+#include "RHX.h"
 
 NAMESPACE_MODE
 
@@ -8,6 +10,8 @@ using Enumeration::BlockCipherConvert;
 using Enumeration::AeadModeConvert;
 using Tools::IntegerTools;
 using Tools::MemoryTools;
+using Tools::ParallelTools;
+using Block::RHX;
 
 class GCM::GcmState
 {
@@ -15,27 +19,33 @@ public:
 
 	std::vector<uint8_t> AAD;
 	SecureVector<uint8_t> Buffer;
+	std::vector<uint8_t> CounterBlock;
 	SecureVector<uint8_t> Key;
 	std::vector<uint8_t> Nonce;
+	std::vector<std::vector<uint8_t>> Partials;
 	std::vector<uint8_t> Tag;
 	size_t Counter;
 	bool Destroyed;
 	bool Encryption;
 	bool Finalized;
 	bool Initialized;
+	bool Stitched;
 
 	GcmState(bool IsDestroyed)
 		:
 		AAD(0),
 		Buffer(0),
+		CounterBlock(BLOCK_SIZE, 0x00),
 		Key(0),
 		Nonce(BLOCK_SIZE, 0x00),
+		Partials(0),
 		Tag(BLOCK_SIZE, 0x00),
 		Counter(0),
 		Destroyed(IsDestroyed),
 		Encryption(false),
 		Finalized(false),
-		Initialized(false)
+		Initialized(false),
+		Stitched(false)
 	{
 	}
 
@@ -48,14 +58,22 @@ public:
 	{
 		MemoryTools::Clear(AAD, 0, AAD.size());
 		MemoryTools::Clear(Buffer, 0, Buffer.size());
+		MemoryTools::Clear(CounterBlock, 0, CounterBlock.size());
 		MemoryTools::Clear(Key, 0, Key.size());
 		MemoryTools::Clear(Nonce, 0, Nonce.size());
+
+		for (size_t i = 0; i < Partials.size(); ++i)
+		{
+			MemoryTools::Clear(Partials[i], 0, Partials[i].size());
+		}
+
 		MemoryTools::Clear(Tag, 0, Tag.size());
 		Counter = 0;
 		Destroyed = false;
 		Encryption = false;
 		Finalized = false;
 		Initialized = false;
+		Stitched = false;
 	}
 };
 
@@ -80,6 +98,7 @@ GCM::GCM(BlockCiphers CipherType)
 	m_parallelProfile(BLOCK_SIZE, m_cipherMode->ParallelProfile().IsParallel(), m_cipherMode->ParallelProfile().ParallelBlockSize(),
 		m_cipherMode->ParallelProfile().ParallelMaxDegree(), true, m_cipherMode->Engine()->StateCacheSize(), true)
 {
+	m_parallelProfile.SetAlgorithm(Name());
 }
 
 GCM::GCM(IBlockCipher* Cipher)
@@ -100,6 +119,7 @@ GCM::GCM(IBlockCipher* Cipher)
 	m_parallelProfile(BLOCK_SIZE, m_cipherMode->ParallelProfile().IsParallel(), m_cipherMode->ParallelProfile().ParallelBlockSize(),
 		m_cipherMode->ParallelProfile().ParallelMaxDegree(), true, m_cipherMode->Engine()->StateCacheSize(), true)
 {
+	m_parallelProfile.SetAlgorithm(Name());
 }
 
 GCM::~GCM()
@@ -269,10 +289,23 @@ void GCM::Initialize(bool Encryption, ISymmetricKey &Parameters)
 	m_cipherMode->Initialize(true, ckp);
 	m_cipherMode->ParallelProfile().Calculate(m_parallelProfile.IsParallel(), m_parallelProfile.ParallelBlockSize(), m_parallelProfile.ParallelMaxDegree());
 
+	// the first message counter follows the nonce block
+	MemoryTools::COPY128(m_gcmState->Nonce, 0, m_gcmState->CounterBlock, 0);
+	IntegerTools::BeIncrement8(m_gcmState->CounterBlock);
+
 	// permute the nonce for ghash
 	std::vector<uint8_t> tmpn(BLOCK_SIZE);
 	m_cipherMode->Transform(tmpn, 0, m_gcmState->Nonce, 0, BLOCK_SIZE);
 
+#if defined(CEX_HAS_AESNI)
+	// the AES-NI schedule of any rijndael variant can be stitched with the carry-less multiply hash,
+	// a rijndael instance running the bitsliced fallback has no AES-NI schedule
+	const BlockCiphers CTYPE = m_cipherMode->CipherType();
+	m_gcmState->Stitched = Digest::GHASH::HasGmul() && (CTYPE == BlockCiphers::AES || CTYPE == BlockCiphers::RHXH256 ||
+		CTYPE == BlockCiphers::RHXH512 || CTYPE == BlockCiphers::RHXS256 || CTYPE == BlockCiphers::RHXS512) &&
+		static_cast<RHX*>(m_cipherMode->Engine())->HasAesni();
+#endif
+
 	// reset the initialization and finalization state
 	m_gcmState->Finalized = false;
 	m_gcmState->Initialized = true;
@@ -320,6 +353,21 @@ void GCM::SetAssociatedData(const SecureVector<uint8_t> &Input, size_t Offset, s
 	m_macAuthenticator->Multiply(m_gcmState->AAD, m_gcmState->Tag, Length);
 }
 
+void GCM::SetAssociatedData(const uint8_t* Input, size_t Length)
+{
+	if (IsInitialized() == false)
+	{
+		throw CryptoCipherModeException(Name(), std::string("SetAssociatedData"), std::string("The cipher mode has not been initialized!"), ErrorCodes::NotInitialized);
+	}
+	if (m_gcmState->AAD.size() != 0)
+	{
+		throw CryptoCipherModeException(Name(), std::string("SetAssociatedData"), std::string("The associated data has already been set!"), ErrorCodes::IllegalOperation);
+	}
+
+	m_gcmState->AAD.assign(Input, Input + Length);
+	m_macAuthenticator->Multiply(m_gcmState->AAD, m_gcmState->Tag, Length);
+}
+
 void GCM::Transform(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length)
 {
 	CEXASSERT(IsInitialized(), "The cipher mode has not been initialized!");
@@ -329,17 +377,29 @@ void GCM::Transform(const std::vector<uint8_t> &Input, size_t InOffset, std::vec
 
 	if (IsEncryption() == true)
 	{
-		// encrypt plain-text
-		m_cipherMode->Transform(Input, InOffset, Output, OutOffset, Length);
-		// process the cipher-text
-		m_macAuthenticator->Update(Output, OutOffset, m_gcmState->Tag, Length);
+#if defined(CEX_HAS_AESNI)
+		if (m_gcmState->Stitched && (!IsParallel() || Length < ParallelBlockSize()))
+		{
+			// encrypt and hash the cipher-text in a single pass
+			m_macAuthenticator->Encrypt(static_cast<RHX*>(m_cipherMode->Engine())->RoundKeys(), m_gcmState->CounterBlock, Input, InOffset, Output, OutOffset, Length, m_gcmState->Tag);
+		}
+		else
+#endif
+		{
+			// encrypt plain-text
+			m_cipherMode->Transform(Input, InOffset, Output, OutOffset, Length);
+
+			// process the cipher-text
+			Hash(Output.data() + OutOffset, Length);
+		}
+
 		// append the tag to the cipher-text
 		Finalize(Output, OutOffset + Length, TagSize());
 	}
 	else
 	{
 		// process the cipher-text
-		m_macAuthenticator->Update(Input, InOffset, m_gcmState->Tag, Length);
+		Hash(Input.data() + InOffset, Length);
 
 		// compare the MAC code appended to the ciphertext with the one generated, if they do not match, throw exception bybassing decryption
 		if (!Verify(Input, InOffset + Length, TagSize()))
@@ -351,6 +411,42 @@ void GCM::Transform(const std::vector<uint8_t> &Input, size_t InOffset, std::vec
 	}
 }
 
+void GCM::Transform(const uint8_t* Input, uint8_t* Output, size_t Length)
+{
+	CEXASSERT(IsInitialized(), "The cipher mode has not been initialized!");
+
+	m_gcmState->Counter += Length;
+
+	if (IsEncryption() == true)
+	{
+		std::vector<uint8_t> code(TagSize());
+
+		// encrypt the plain-text in place, then hash the cipher-text
+		m_cipherMode->Transform(Input, Output, Length);
+		Hash(Output, Length);
+
+		// append the tag to the cipher-text
+		Finalize(code, 0, code.size());
+		MemoryTools::CopyRaw(code.data(), Output + Length, code.size());
+	}
+	else
+	{
+		std::vector<uint8_t> code(TagSize());
+
+		// the received tag is copied before an in-place decryption can overwrite it
+		MemoryTools::CopyRaw(Input + Length, code.data(), code.size());
+		Hash(Input, Length);
+
+		// compare the MAC code appended to the ciphertext with the one generated, if they do not match, throw exception bybassing decryption
+		if (!Verify(code, 0, code.size()))
+		{
+			throw CryptoAuthenticationFailure(Name(), std::string("Transform"), std::string("The authentication tag does not match!"), ErrorCodes::AuthenticationFailure);
+		}
+
+		m_cipherMode->Transform(Input, Output, Length);
+	}
+}
+
 //~~~Private Functions~~~//
 
 void GCM::Finalize(std::vector<uint8_t> &Output, size_t OutOffset, size_t Length)
@@ -384,6 +480,46 @@ void GCM::Finalize(std::vector<uint8_t> &Output, size_t OutOffset, size_t Length
 	m_gcmState->Initialized = false;
 }
 
+void GCM::Hash(const uint8_t* Input, size_t Length)
+{
+	if (IsParallel() && Length >= ParallelBlockSize())
+	{
+		HashParallel(Input, Length);
+	}
+	else
+	{
+		m_macAuthenticator->Update(Input, m_gcmState->Tag, Length);
+	}
+}
+
+void GCM::HashParallel(const uint8_t* Input, size_t Length)
+{
+	const size_t SEGCNT = m_parallelProfile.ParallelSegmentCount();
+	const size_t SEGLEN = ((Length / SEGCNT) / BLOCK_SIZE) * BLOCK_SIZE;
+	size_t j;
+
+	// the segment hashes are kept by the instance, and are allocated only on first use
+	if (m_gcmState->Partials.size() < SEGCNT)
+	{
+		m_gcmState->Partials.resize(SEGCNT, std::vector<uint8_t>(BLOCK_SIZE, 0x00));
+	}
+
+	// each segment is hashed from a zero state; the last segment includes the remainder
+	ParallelTools::ParallelFor(m_parallelProfile, Input, 0, SEGCNT, [this, Input, Length, SEGCNT, SEGLEN](size_t i)
+	{
+		const size_t SEGOFF = i * SEGLEN;
+		m_macAuthenticator->Partial(Input + SEGOFF, (i == SEGCNT - 1) ? Length - SEGOFF : SEGLEN, m_gcmState->Partials[i]);
+	});
+
+	// join the segment hashes in message order: Y = Y * H^n ^ Yi
+	for (j = 0; j < SEGCNT - 1; ++j)
+	{
+		m_macAuthenticator->Combine(m_gcmState->Partials[j], SEGLEN / BLOCK_SIZE, m_gcmState->Tag);
+	}
+
+	m_macAuthenticator->Combine(m_gcmState->Partials[SEGCNT - 1], ((Length - (SEGLEN * (SEGCNT - 1))) + BLOCK_SIZE - 1) / BLOCK_SIZE, m_gcmState->Tag);
+}
+
 bool GCM::Verify(const std::vector<uint8_t> &Input, size_t Offset, size_t Length)
 {
 	std::vector<uint8_t> code(TagSize());
@@ -103,7 +103,10 @@ NAMESPACE_MODE
 /// The GCM parallel mode also leverages SIMD instructions to 'double parallelize' those segments. \n
 /// An input block assigned to a thread uses SIMD instructions to decrypt/encrypt 4, 8, or 16 blocks in parallel per cycle, depending on which framework is runtime available, AVX, AVX2, or AVX512 instructions. \n
 /// Input blocks equal to, or divisble by the ParallelBlockSize() are processed in parallel on supported systems, this can be disabled through the ParallelProfile accessor function. \n
-/// The cipher transform is parallelizable, however the authentication pass, (GMAC), is processed sequentially.</para>
+/// The authentication pass, (GMAC), is also multi-threaded for inputs of ParallelBlockSize() or larger; the cipher-text is divided into contiguous segments that are hashed concurrently, 
+/// and the segment hashes are joined in order by multiplying the running hash with the power of H equal to the block length of the next segment. \n
+/// When a Rijndael cipher is used on a processor with AES-NI and carry-less multiply instructions, an input that is not processed in parallel is encrypted and hashed in a single pass;
+/// the counter-mode rounds of 8 blocks are interleaved with the hash multiplies of the previous 8 blocks, which are reduced once using the powers H^1..H^8.</para>
 ///
 /// <description>Implementation Notes:</description>
 /// <list type="bullet">
@@ -324,6 +327,18 @@ public:
 	/// <exception cref="CryptoCipherModeException">Thrown if state has been processed</exception>
 	void SetAssociatedData(const SecureVector<uint8_t> &Input, size_t Offset, size_t Length) override;
 
+	/// <summary>
+	/// Add additional data in the callers memory to the message authentication code generator.  
+	/// <para>Must be called after Initialize(bool, ISymmetricKey), and before any processing of plaintext or ciphertext input. 
+	/// This function can only be called once per each initialization/finalization cycle.</para>
+	/// </summary>
+	/// 
+	/// <param name="Input">A pointer to the bytes to process</param>
+	/// <param name="Length">The number of bytes to process</param>
+	///
+	/// <exception cref="CryptoCipherModeException">Thrown if state has been processed</exception>
+	void SetAssociatedData(const uint8_t* Input, size_t Length) override;
+
 	/// <summary>
 	/// Transform a length of bytes with offset and length parameters. 
 	/// <para>This method processes a specified length of bytes, utilizing offsets incremented by the caller.
@@ -339,10 +354,28 @@ public:
 	/// <param name="Length">The number of bytes to transform</param>
 	void Transform(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length) override;
 
+	/// <summary>
+	/// Transform a length of bytes in the callers memory. 
+	/// <para>The pointer form of Transform, for buffers that are not held in a vector, such as pooled, mapped or scatter-gather memory.
+	/// Encryption writes the MAC tag after the cipher-text, so Output must have room for Length + TagSize() bytes; decryption reads the tag following the Length bytes of cipher-text.
+	/// The counter-mode pass xors the key-stream directly into Output, and the cipher-text is hashed in segments of ParallelBlockSize(); the stitched single-pass kernel is not used by this form.
+	/// Input and Output may be the same address for an in-place transform, but must not otherwise overlap.
+	/// Initialize(bool, ISymmetricKey) must be called before this method can be used.</para>
+	/// </summary>
+	/// 
+	/// <param name="Input">A pointer to the bytes to transform</param>
+	/// <param name="Output">A pointer to the transformed bytes</param>
+	/// <param name="Length">The number of message bytes to transform, not including the tag</param>
+	///
+	/// <exception cref="CryptoAuthenticationFailure">Thrown during decryption if the authentication tag does not match</exception>
+	void Transform(const uint8_t* Input, uint8_t* Output, size_t Length) override;
+
 private:
 
 	void Compute(const std::vector<uint8_t> &Input, size_t Offset, size_t Length);
 	void Finalize(std::vector<uint8_t> &Output, size_t OutOffset, size_t Length);
+	void Hash(const uint8_t* Input, size_t Length);
+	void HashParallel(const uint8_t* Input, size_t Length);
 	bool Verify(const std::vector<uint8_t> &Input, size_t Offset, size_t Length);
 };
 
@@ -0,0 +1,548 @@
+#include "GCMSIV.h"
+#include "BlockCipherFromName.h"
+#include "IntegerTools.h"
+#include "MemoryTools.h"
+#include "ParallelScratch.h"
+#include "ParallelTools.h"
+#include "SymmetricKey.h"
+
+NAMESPACE_MODE
+
+using Enumeration::AeadModeConvert;
+using Enumeration::BlockCipherConvert;
+using Tools::IntegerTools;
+using Tools::MemoryTools;
+using Tools::ParallelScratch;
+using Tools::ParallelTools;
+
+class GCMSIV::GcmSivState
+{
+public:
+
+	std::vector<uint8_t> Hash;
+	SecureVector<uint8_t> Key;
+	std::vector<uint8_t> Nonce;
+	ParallelScratch Scratch;
+	std::vector<uint8_t> Tag;
+	size_t AADLength;
+	bool Associated;
+	bool Destroyed;
+	bool Encryption;
+	bool Initialized;
+
+	GcmSivState(bool IsDestroyed)
+		:
+		Hash(BLOCK_SIZE, 0x00),
+		Key(0),
+		Nonce(NONCE_SIZE, 0x00),
+		Scratch(),
+		Tag(TAG_SIZE, 0x00),
+		AADLength(0),
+		Associated(false),
+		Destroyed(IsDestroyed),
+		Encryption(false),
+		Initialized(false)
+	{
+	}
+
+	~GcmSivState()
+	{
+		Reset();
+	}
+
+	void Reset()
+	{
+		MemoryTools::Clear(Hash, 0, Hash.size());
+		MemoryTools::Clear(Key, 0, Key.size());
+		MemoryTools::Clear(Nonce, 0, Nonce.size());
+		Scratch.Clear();
+		MemoryTools::Clear(Tag, 0, Tag.size());
+		AADLength = 0;
+		Associated = false;
+		Destroyed = false;
+		Encryption = false;
+		Initialized = false;
+	}
+};
+
+//~~~Constructor~~~//
+
+GCMSIV::GCMSIV(BlockCiphers CipherType)
+	:
+	m_gcmSivState(new GcmSivState(true)),
+	m_blockCipher((CipherType == BlockCiphers::AES || CipherType == BlockCiphers::Serpent) ?
+		Helper::BlockCipherFromName::GetInstance(CipherType) :
+		throw CryptoCipherModeException(AeadModeConvert::ToName(AeadModes::GCMSIV), std::string("Constructor"), std::string("The block cipher type must be AES or Serpent!"), ErrorCodes::InvalidParam)), //-V2571
+	m_macAuthenticator(new Digest::POLYVAL()),
+	m_legalKeySizes {
+		SymmetricKeySize(16, NONCE_SIZE, 0),
+		SymmetricKeySize(32, NONCE_SIZE, 0) },
+	m_parallelProfile(BLOCK_SIZE, true, m_blockCipher->StateCacheSize(), true)
+{
+	m_parallelProfile.SetAlgorithm(Name());
+}
+
+GCMSIV::GCMSIV(IBlockCipher* Cipher)
+	:
+	m_gcmSivState(new GcmSivState(false)),
+	m_blockCipher((Cipher != nullptr && (Cipher->Enumeral() == BlockCiphers::AES || Cipher->Enumeral() == BlockCiphers::Serpent)) ?
+		Cipher :
+		throw CryptoCipherModeException(AeadModeConvert::ToName(AeadModes::GCMSIV), std::string("Constructor"), std::string("The block cipher must be an AES or Serpent instance, and can not be null!"), ErrorCodes::IllegalOperation)), //-V2571
+	m_macAuthenticator(new Digest::POLYVAL()),
+	m_legalKeySizes {
+		SymmetricKeySize(16, NONCE_SIZE, 0),
+		SymmetricKeySize(32, NONCE_SIZE, 0) },
+	m_parallelProfile(BLOCK_SIZE, true, m_blockCipher->StateCacheSize(), true)
+{
+	m_parallelProfile.SetAlgorithm(Name());
+}
+
+GCMSIV::~GCMSIV()
+{
+	if (m_macAuthenticator)
+	{
+		m_macAuthenticator->Reset();
+		m_macAuthenticator.reset(nullptr);
+	}
+
+	if (m_gcmSivState->Destroyed)
+	{
+		if (m_blockCipher != nullptr)
+		{
+			m_blockCipher.reset(nullptr);
+		}
+	}
+	else
+	{
+		if (m_blockCipher != nullptr)
+		{
+			m_blockCipher.release();
+		}
+	}
+}
+
+//~~~Accessors~~~//
+
+const AeadModes GCMSIV::Enumeral()
+{
+	return AeadModes::GCMSIV;
+}
+
+const bool GCMSIV::IsEncryption()
+{
+	return m_gcmSivState->Encryption;
+}
+
+const bool GCMSIV::IsInitialized()
+{
+	return m_gcmSivState->Initialized;
+}
+
+const bool GCMSIV::IsParallel()
+{
+	return m_parallelProfile.IsParallel();
+}
+
+const std::vector<SymmetricKeySize> &GCMSIV::LegalKeySizes()
+{
+	return m_legalKeySizes;
+}
+
+const std::string GCMSIV::Name()
+{
+	std::string tmpn;
+
+	tmpn = AeadModeConvert::ToName(Enumeral()) + std::string("-") + BlockCipherConvert::ToName(m_blockCipher->Enumeral());
+
+	return tmpn;
+}
+
+const size_t GCMSIV::ParallelBlockSize()
+{
+	return m_parallelProfile.ParallelBlockSize();
+}
+
+ParallelOptions &GCMSIV::ParallelProfile()
+{
+	return m_parallelProfile;
+}
+
+const std::vector<uint8_t> GCMSIV::Tag()
+{
+	return m_gcmSivState->Tag;
+}
+
+const void GCMSIV::Tag(SecureVector<uint8_t> &Output)
+{
+	SecureInsert(m_gcmSivState->Tag, 0, Output, 0, m_gcmSivState->Tag.size());
+}
+
+const size_t GCMSIV::TagSize()
+{
+	return TAG_SIZE;
+}
+
+//~~~Public Functions~~~//
+
+void GCMSIV::Initialize(bool Encryption, ISymmetricKey &Parameters)
+{
+	if (Parameters.KeySizes().KeySize() != 0 && !SymmetricKeySize::Contains(LegalKeySizes(), Parameters.KeySizes().KeySize()))
+	{
+		throw CryptoCipherModeException(Name(), std::string("Initialize"), std::string("Invalid key size; key must be one of the LegalKeySizes in length!"), ErrorCodes::InvalidKey);
+	}
+	if (Parameters.KeySizes().IVSize() != NONCE_SIZE)
+	{
+		throw CryptoCipherModeException(Name(), std::string("Initialize"), std::string("Requires a nonce of 12 bytes in length!"), ErrorCodes::InvalidNonce);
+	}
+	if (Parameters.KeySizes().KeySize() == 0 && m_gcmSivState->Key.size() == 0)
+	{
+		throw CryptoCipherModeException(Name(), std::string("Initialize"), std::string("First initialization requires a key and nonce!"), ErrorCodes::IllegalOperation);
+	}
+
+	if (m_parallelProfile.IsParallel())
+	{
+		if (m_parallelProfile.IsParallel() && m_parallelProfile.ParallelBlockSize() < m_parallelProfile.ParallelMinimumSize() || m_parallelProfile.ParallelBlockSize() > m_parallelProfile.ParallelMaximumSize())
+		{
+			throw CryptoCipherModeException(Name(), std::string("Initialize"), std::string("The parallel block size is out of bounds!"), ErrorCodes::InvalidSize);
+		}
+		if (m_parallelProfile.IsParallel() && m_parallelProfile.ParallelBlockSize() % m_parallelProfile.ParallelMinimumSize() != 0)
+		{
+			throw CryptoCipherModeException(Name(), std::string("Initialize"), std::string("The parallel block size must be evenly aligned to the ParallelMinimumSize!"), ErrorCodes::InvalidParam);
+		}
+	}
+
+	if (Parameters.KeySizes().KeySize() != 0)
+	{
+		// store the key-generating key in a secure-vector
+		m_gcmSivState->Key.resize(Parameters.KeySizes().KeySize());
+		MemoryTools::Copy(Parameters.SecureKey(), 0, m_gcmSivState->Key, 0, m_gcmSivState->Key.size());
+	}
+
+	MemoryTools::Copy(Parameters.IV(), 0, m_gcmSivState->Nonce, 0, NONCE_SIZE);
+
+	// derive the per-nonce keys: the first half of E(LE32(i) || N), two blocks for the hash key, and two or four for the encryption key
+	const size_t KEYLEN = m_gcmSivState->Key.size();
+	const size_t DRVCNT = 2 + (KEYLEN / 8);
+	std::vector<uint8_t> tmpc(BLOCK_SIZE);
+	std::vector<uint8_t> tmpo(BLOCK_SIZE);
+	SecureVector<uint8_t> tmpk(BLOCK_SIZE + KEYLEN);
+	size_t i;
+
+	SymmetricKey kgk(m_gcmSivState->Key);
+	m_blockCipher->Initialize(true, kgk);
+	MemoryTools::Copy(m_gcmSivState->Nonce, 0, tmpc, 4, NONCE_SIZE);
+
+	for (i = 0; i < DRVCNT; ++i)
+	{
+		IntegerTools::Le32ToBytes(static_cast<uint32_t>(i), tmpc, 0);
+		m_blockCipher->EncryptBlock(tmpc, 0, tmpo, 0);
+		MemoryTools::Copy(tmpo, 0, tmpk, i * 8, 8);
+	}
+
+	// key the polyval function with the authentication key
+	std::vector<uint8_t> tmph(BLOCK_SIZE);
+	MemoryTools::Copy(tmpk, 0, tmph, 0, BLOCK_SIZE);
+	m_macAuthenticator->Initialize(tmph);
+
+	// key the cipher with the message encryption key
+	SecureVector<uint8_t> tmpe(KEYLEN);
+	MemoryTools::Copy(tmpk, BLOCK_SIZE, tmpe, 0, KEYLEN);
+	SymmetricKey ekp(tmpe);
+	m_blockCipher->Initialize(true, ekp);
+
+	MemoryTools::Clear(tmpe, 0, tmpe.size());
+	MemoryTools::Clear(tmph, 0, tmph.size());
+	MemoryTools::Clear(tmpk, 0, tmpk.size());
+	MemoryTools::Clear(tmpo, 0, tmpo.size());
+
+	// reset the message state
+	MemoryTools::Clear(m_gcmSivState->Hash, 0, m_gcmSivState->Hash.size());
+	MemoryTools::Clear(m_gcmSivState->Tag, 0, m_gcmSivState->Tag.size());
+	m_gcmSivState->AADLength = 0;
+	m_gcmSivState->Associated = false;
+	m_gcmSivState->Encryption = Encryption;
+	m_gcmSivState->Initialized = true;
+}
+
+void GCMSIV::ParallelMaxDegree(size_t Degree)
+{
+	if (Degree == 0 || Degree % 2 != 0 || Degree > m_parallelProfile.ProcessorCount())
+	{
+		throw CryptoCipherModeException(Name(), std::string("ParallelMaxDegree"), std::string("Degree setting is invalid!"), ErrorCodes::NotSupported);
+	}
+
+	m_parallelProfile.SetMaxDegree(Degree);
+}
+
+void GCMSIV::SetAssociatedData(const std::vector<uint8_t> &Input, size_t Offset, size_t Length)
+{
+	if (IsInitialized() == false)
+	{
+		throw CryptoCipherModeException(Name(), std::string("SetAssociatedData"), std::string("The cipher mode has not been initialized!"), ErrorCodes::NotInitialized);
+	}
+	if (m_gcmSivState->Associated)
+	{
+		throw CryptoCipherModeException(Name(), std::string("SetAssociatedData"), std::string("The associated data has already been set!"), ErrorCodes::IllegalOperation);
+	}
+	if (static_cast<uint64_t>(Length) > MAX_MSGLEN)
+	{
+		throw CryptoCipherModeException(Name(), std::string("SetAssociatedData"), std::string("The associated data can not exceed 2^36 bytes!"), ErrorCodes::InvalidSize);
+	}
+
+	// the associated data is absorbed immediately, and padded to the block boundary
+	m_macAuthenticator->Update(Input, Offset, m_gcmSivState->Hash, Length);
+	m_gcmSivState->AADLength = Length;
+	m_gcmSivState->Associated = true;
+}
+
+void GCMSIV::SetAssociatedData(const SecureVector<uint8_t> &Input, size_t Offset, size_t Length)
+{
+	std::vector<uint8_t> tmpa(Length);
+
+	MemoryTools::Copy(Input, Offset, tmpa, 0, Length);
+	SetAssociatedData(tmpa, 0, Length);
+	MemoryTools::Clear(tmpa, 0, tmpa.size());
+}
+
+void GCMSIV::SetAssociatedData(const uint8_t* Input, size_t Length)
+{
+	if (IsInitialized() == false)
+	{
+		throw CryptoCipherModeException(Name(), std::string("SetAssociatedData"), std::string("The cipher mode has not been initialized!"), ErrorCodes::NotInitialized);
+	}
+	if (m_gcmSivState->Associated)
+	{
+		throw CryptoCipherModeException(Name(), std::string("SetAssociatedData"), std::string("The associated data has already been set!"), ErrorCodes::IllegalOperation);
+	}
+	if (static_cast<uint64_t>(Length) > MAX_MSGLEN)
+	{
+		throw CryptoCipherModeException(Name(), std::string("SetAssociatedData"), std::string("The associated data can not exceed 2^36 bytes!"), ErrorCodes::InvalidSize);
+	}
+
+	// only the last segment can end on a partial block, so the padding is the same as a single update
+	m_macAuthenticator->Update(Input, m_gcmSivState->Hash, Length);
+
+	m_gcmSivState->AADLength = Length;
+	m_gcmSivState->Associated = true;
+}
+
+void GCMSIV::Transform(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length)
+{
+	if (IsInitialized() == false)
+	{
+		throw CryptoCipherModeException(Name(), std::string("Transform"), std::string("The cipher mode has not been initialized!"), ErrorCodes::NotInitialized);
+	}
+	if (static_cast<uint64_t>(Length) > MAX_MSGLEN)
+	{
+		throw CryptoCipherModeException(Name(), std::string("Transform"), std::string("The message can not exceed 2^36 bytes!"), ErrorCodes::InvalidSize);
+	}
+
+	if (IsEncryption() == true)
+	{
+		if (Output.size() < OutOffset + Length + TAG_SIZE)
+		{
+			throw CryptoCipherModeException(Name(), std::string("Transform"), std::string("The output array is smaller than the cipher-text and tag!"), ErrorCodes::InvalidSize);
+		}
+
+		// the tag is computed over the plain-text, and is the initial counter of the encryption
+		m_macAuthenticator->Update(Input, InOffset, m_gcmSivState->Hash, Length);
+		ComputeTag(Length);
+		Process(Input.data() + InOffset, Output.data() + OutOffset, Length, m_gcmSivState->Tag);
+		MemoryTools::Copy(m_gcmSivState->Tag, 0, Output, OutOffset + Length, TAG_SIZE);
+		m_gcmSivState->Initialized = false;
+	}
+	else
+	{
+		if (Input.size() < InOffset + Length + TAG_SIZE || Output.size() < OutOffset + Length)
+		{
+			throw CryptoCipherModeException(Name(), std::string("Transform"), std::string("The input array is smaller than the cipher-text and tag!"), ErrorCodes::InvalidSize);
+		}
+
+		// the received tag is copied before an in-place decryption can overwrite it
+		std::vector<uint8_t> code(TAG_SIZE);
+		MemoryTools::Copy(Input, InOffset + Length, code, 0, TAG_SIZE);
+
+		Process(Input.data() + InOffset, Output.data() + OutOffset, Length, code);
+		m_macAuthenticator->Update(Output, OutOffset, m_gcmSivState->Hash, Length);
+		ComputeTag(Length);
+		m_gcmSivState->Initialized = false;
+
+		// constant-time comparison of the received tag and the tag computed over the plain-text
+		if (!IntegerTools::Compare(code, 0, m_gcmSivState->Tag, 0, TAG_SIZE))
+		{
+			// the unauthenticated plain-text is not released
+			if (Length != 0)
+			{
+				MemoryTools::Clear(Output, OutOffset, Length);
+			}
+
+			MemoryTools::Clear(m_gcmSivState->Tag, 0, m_gcmSivState->Tag.size());
+			throw CryptoAuthenticationFailure(Name(), std::string("Transform"), std::string("The authentication tag does not match!"), ErrorCodes::AuthenticationFailure);
+		}
+	}
+}
+
+void GCMSIV::Transform(const uint8_t* Input, uint8_t* Output, size_t Length)
+{
+	if (IsInitialized() == false)
+	{
+		throw CryptoCipherModeException(Name(), std::string("Transform"), std::string("The cipher mode has not been initialized!"), ErrorCodes::NotInitialized);
+	}
+	if (static_cast<uint64_t>(Length) > MAX_MSGLEN)
+	{
+		throw CryptoCipherModeException(Name(), std::string("Transform"), std::string("The message can not exceed 2^36 bytes!"), ErrorCodes::InvalidSize);
+	}
+
+	if (IsEncryption() == true)
+	{
+		// the tag is computed over the plain-text, and is the initial counter of the encryption
+		m_macAuthenticator->Update(Input, m_gcmSivState->Hash, Length);
+		ComputeTag(Length);
+		Process(Input, Output, Length, m_gcmSivState->Tag);
+		MemoryTools::CopyRaw(m_gcmSivState->Tag.data(), Output + Length, TAG_SIZE);
+		m_gcmSivState->Initialized = false;
+	}
+	else
+	{
+		// the received tag is copied before an in-place decryption can overwrite it
+		std::vector<uint8_t> code(TAG_SIZE);
+		MemoryTools::CopyRaw(Input + Length, code.data(), TAG_SIZE);
+
+		Process(Input, Output, Length, code);
+		m_macAuthenticator->Update(Output, m_gcmSivState->Hash, Length);
+		ComputeTag(Length);
+		m_gcmSivState->Initialized = false;
+
+		// constant-time comparison of the received tag and the tag computed over the plain-text
+		if (!IntegerTools::Compare(code, 0, m_gcmSivState->Tag, 0, TAG_SIZE))
+		{
+			// the unauthenticated plain-text is not released
+			if (Length != 0)
+			{
+				MemoryTools::ClearRaw(Output, Length);
+			}
+
+			MemoryTools::Clear(m_gcmSivState->Tag, 0, m_gcmSivState->Tag.size());
+			throw CryptoAuthenticationFailure(Name(), std::string("Transform"), std::string("The authentication tag does not match!"), ErrorCodes::AuthenticationFailure);
+		}
+	}
+}
+
+//~~~Private Functions~~~//
+
+void GCMSIV::ComputeTag(size_t Length)
+{
+	size_t i;
+
+	// S = POLYVAL(..) ^ (N || 0), with the top bit cleared; T = E(S)
+	m_macAuthenticator->Finalize(m_gcmSivState->Hash, m_gcmSivState->AADLength, Length);
+
+	for (i = 0; i < NONCE_SIZE; ++i)
+	{
+		m_gcmSivState->Hash[i] ^= m_gcmSivState->Nonce[i];
+	}
+
+	m_gcmSivState->Hash[BLOCK_SIZE - 1] &= 0x7F;
+	m_blockCipher->EncryptBlock(m_gcmSivState->Hash, 0, m_gcmSivState->Tag, 0);
+
+	MemoryTools::Clear(m_gcmSivState->Hash, 0, m_gcmSivState->Hash.size());
+	m_gcmSivState->AADLength = 0;
+	m_gcmSivState->Associated = false;
+}
+
+void GCMSIV::Generate(const uint8_t* Input, uint8_t* Output, size_t Length, std::vector<uint8_t> &Counter, std::vector<uint8_t> &Buffer)
+{
+	// the key-stream is written after the counter blocks, so that the input and output can overlap
+	const size_t KSTOFF = WIDE_BLOCKS * BLOCK_SIZE;
+	size_t bctr;
+	size_t blen;
+	size_t i;
+
+	bctr = 0;
+
+	const size_t WIDBLK = 16 * BLOCK_SIZE;
+
+	// 16 blocks; the cipher selects its widest kernel at run-time
+	while (Length - bctr >= WIDBLK)
+	{
+		for (i = 0; i < 16; ++i)
+		{
+			MemoryTools::COPY128(Counter, 0, Buffer, i * BLOCK_SIZE);
+			Increase32(Counter, Counter, 1);
+		}
+
+		m_blockCipher->Transform2048(Buffer, 0, Buffer, KSTOFF, Length);
+		MemoryTools::XorRaw(Input + bctr, Buffer.data() + KSTOFF, Output + bctr, WIDBLK);
+		bctr += WIDBLK;
+	}
+
+	// the remaining blocks, and a partial last block
+	while (bctr != Length)
+	{
+		blen = IntegerTools::Min(Length - bctr, BLOCK_SIZE);
+		m_blockCipher->EncryptBlock(Counter, 0, Buffer, KSTOFF);
+		Increase32(Counter, Counter, 1);
+		MemoryTools::XorRaw(Input + bctr, Buffer.data() + KSTOFF, Output + bctr, blen);
+		bctr += blen;
+	}
+}
+
+void GCMSIV::Increase32(const std::vector<uint8_t> &Counter, std::vector<uint8_t> &Output, uint32_t Value)
+{
+	// the counter is the first 32 bits as a little-endian integer, and wraps without a carry into the remaining bytes
+	const uint32_t CTR32 = IntegerTools::LeBytesTo32(Counter, 0) + Value;
+
+	if (&Output != &Counter)
+	{
+		MemoryTools::COPY128(Counter, 0, Output, 0);
+	}
+
+	IntegerTools::Le32ToBytes(CTR32, Output, 0);
+}
+
+void GCMSIV::Process(const uint8_t* Input, uint8_t* Output, size_t Length, const std::vector<uint8_t> &Tag)
+{
+	std::vector<uint8_t> ctr(BLOCK_SIZE);
+
+	if (Length != 0)
+	{
+		// the initial counter is the tag with the top bit set
+		MemoryTools::COPY128(Tag, 0, ctr, 0);
+		ctr[BLOCK_SIZE - 1] |= 0x80;
+
+		if (IsParallel() && Length >= ParallelBlockSize())
+		{
+			const size_t SEGCNT = m_parallelProfile.ParallelSegmentCount();
+			const size_t SEGLEN = ((Length / SEGCNT) / BLOCK_SIZE) * BLOCK_SIZE;
+			const size_t ALNLEN = SEGCNT * SEGLEN;
+
+			// the per-worker counters are kept by the instance, and are allocated only on first use
+			m_gcmSivState->Scratch.Reserve(SEGCNT, BLOCK_SIZE, SCRATCH_SIZE);
+
+			ParallelTools::ParallelFor(m_parallelProfile, Output, 0, SEGCNT, [this, Input, Output, SEGLEN, &ctr](size_t i)
+			{
+				std::vector<uint8_t> &thdc = m_gcmSivState->Scratch.Counter(i);
+				// offset the counter by the segment position in blocks
+				Increase32(ctr, thdc, static_cast<uint32_t>((i * SEGLEN) / BLOCK_SIZE));
+				this->Generate(Input + (i * SEGLEN), Output + (i * SEGLEN), SEGLEN, thdc, m_gcmSivState->Scratch.Buffer(i));
+			});
+
+			// the remainder that does not divide between the segments
+			if (ALNLEN != Length)
+			{
+				std::vector<uint8_t> &thdc = m_gcmSivState->Scratch.Counter(0);
+				Increase32(ctr, thdc, static_cast<uint32_t>(ALNLEN / BLOCK_SIZE));
+				Generate(Input + ALNLEN, Output + ALNLEN, Length - ALNLEN, thdc, m_gcmSivState->Scratch.Buffer(0));
+			}
+		}
+		else
+		{
+			m_gcmSivState->Scratch.Reserve(1, BLOCK_SIZE, SCRATCH_SIZE);
+			Generate(Input, Output, Length, ctr, m_gcmSivState->Scratch.Buffer(0));
+		}
+
+		MemoryTools::Clear(ctr, 0, ctr.size());
+	}
+}
+
+NAMESPACE_MODEEND
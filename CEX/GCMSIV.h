@@ -0,0 +1,344 @@
+// The GPL version 3 License (GPLv3)
+//
+// Copyright (c) 2023 QSCS.ca
+// This file is part of the CEX Cryptographic library.
+//
+// This program is free software : you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+//
+// Implementation Details:
+// An implementation of the nonce misuse-resistant Galois/Counter Synthetic IV authenticated mode (GCM-SIV).
+
+#ifndef CEX_GCMSIV_H
+#define CEX_GCMSIV_H
+
+#include "IAeadMode.h"
+#include "POLYVAL.h"
+
+NAMESPACE_MODE
+
+/// <summary>
+/// GCM-SIV: A nonce misuse-resistant Galois/Counter Synthetic IV authenticated block cipher mode (RFC 8452)
+/// </summary>
+///
+/// <example>
+/// <description>Encrypting a single block of bytes:</description>
+/// <code>
+/// GCMSIV cipher(BlockCiphers::AES);
+/// // initialize for encryption
+/// cipher.Initialize(true, SymmetricKey(Key, Nonce));
+/// // encrypt 1kb, the 16 byte tag is appended to the cipher-text
+/// cipher.Transform(Input, 0, Output, 0, 1024);
+/// </code>
+/// </example>
+///
+/// <example>
+/// <description>Decrypting a block of bytes:</description>
+/// <code>
+/// GCMSIV cipher(BlockCiphers::AES);
+/// // initialize for decryption
+/// cipher.Initialize(false, SymmetricKey(Key, Nonce));
+///
+/// // decrypt 1024 bytes, if the authentication fails a CryptoAuthenticationFailure exception is thrown
+/// try
+/// {
+///		cipher.Transform(Input, 0, Output, 0, 1024);
+/// }
+/// catch (CryptoAuthenticationFailure const &ex)
+/// {
+///		// authentication has failed, do something..
+/// }
+/// </code>
+/// </example>
+///
+/// <remarks>
+/// <description><B>Overview:</B></description>
+/// <para>GCM-SIV is an Authenticate Encrypt and Additional Data (AEAD) mode that remains secure when a nonce is repeated;
+/// a repeated nonce reveals only whether the same message and associated data were encrypted, and not the exclusive-or of the messages as it would with GCM. \n
+/// The tag is a synthetic IV; it is computed over the associated data and the plain-text, and is then used as the initial counter of the counter-mode encryption. \n
+/// Each nonce derives a new authentication key and a new encryption key from the key-generating key, so a key can be used with more messages than GCM allows. \n
+/// The mode is two pass; encryption hashes the plain-text before it is encrypted, and decryption decrypts the cipher-text before the plain-text is hashed and the tag is compared.
+/// If the authentication fails, the output is erased and a CryptoAuthenticationFailure exception is generated.</para>
+///
+/// <description><B>Description:</B></description>
+/// <para><EM>Legend:</EM> \n
+/// <B>K</B>=key-generating key, <B>N</B>=nonce, <B>E</B>=encrypt, <B>A</B>=associated data, <B>P</B>=plain-text, <B>C</B>=cipher-text, <B>T</B>=tag, <B>||</B>=concatenate, <B>^</B>=XOR</para>
+/// <para><EM>Key Derivation</EM> \n
+/// 1) for i = 0...(Kn / 8) + 1, Bi = first 8 bytes of E<sub>K</sub>(LE32(i) || N). \n
+/// 2) Ka = B0 || B1, Ke = B2 || ... || B(Kn/8)+1. \n</para>
+/// <para><EM>Encryption</EM> \n
+/// 1) S = POLYVAL(Ka, A || 0 pad || P || 0 pad || LE64(len(A)) || LE64(len(P))). \n
+/// 2) S = S ^ (N || 0<sup>32</sup>), with the most significant bit of the last byte cleared. \n
+/// 3) T = E<sub>Ke</sub>(S). \n
+/// 4) C = CTR(Ke, T with the most significant bit of the last byte set, P), with a 32-bit little-endian counter in the first four bytes. \n
+/// 5) Output C || T. \n</para>
+///
+/// <description><B>Multi-Threading:</B></description>
+/// <para>The counter-mode pass of GCM-SIV can be multi-threaded. Input blocks equal to, or larger than the ParallelBlockSize() are divided into contiguous segments,
+/// and each thread generates the key-stream of its segment from the initial counter offset by the segment position. \n
+/// The key-stream is generated with the widest block cipher function that is available; 16 blocks with AVX2/AVX512, or 4 blocks with AVX. \n
+/// POLYVAL is processed sequentially, with the GHASH carry-less multiply and aggregated reduction kernels; the byte reversed blocks are absorbed 8 at a time with a single reduction.</para>
+///
+/// <description>Implementation Notes:</description>
+/// <list type="bullet">
+/// <item><description>GCM-SIV requires a block cipher with a 16 byte block and a 16 or 32 byte key; AES (RHX in standard mode) or Serpent.</description></item>
+/// <item><description>The nonce is 12 bytes, and the tag is 16 bytes.</description></item>
+/// <item><description>Additional data can be added using the SetAssociatedData(Input, Offset, Length) call, once per message, after Initialize and before the Transform call.</description></item>
+/// <item><description>The tag is computed each time the Transform function is called; a message is processed in a single call, and the mode must be initialized again before the next message.</description></item>
+/// <item><description>The key can be omitted (a zero sized key) on later calls to Initialize, in which case the previous key-generating key is used with the new nonce.</description></item>
+/// <item><description>Decryption can be performed in-place; the cipher-text and plain-text can be the same array and offset.</description></item>
+/// <item><description>The ParallelBlockSize(), IsParallel(), and ParallelThreadsMax() accessors, can be changed through the ParallelProfile() property, this value can be user defined, but must be evenly divisible by ParallelMinimumSize().</description></item>
+/// </list>
+///
+/// <description>Guiding Publications:</description>
+/// <list type="number">
+/// <item><description>RFC 8452: <a href="https://tools.ietf.org/html/rfc8452">AES-GCM-SIV: Nonce Misuse-Resistant Authenticated Encryption</a>.</description></item>
+/// <item><description>Gueron, Langley, Lindell: <a href="https://eprint.iacr.org/2017/168.pdf">AES-GCM-SIV: Specification and Analysis</a>.</description></item>
+/// <item><description>The <a href="http://csrc.nist.gov/groups/ST/toolkit/BCM/documents/proposedmodes/gcm/gcm-spec.pdf">Galois/Counter Mode</a> of Operation (GCM).</description></item>
+/// </list>
+/// </remarks>
+class GCMSIV final : public IAeadMode
+{
+private:
+
+	static const size_t BLOCK_SIZE = 16;
+	// the maximum plain-text and associated data lengths, 2^36 bytes
+	static const uint64_t MAX_MSGLEN = 68719476736ULL;
+	static const size_t NONCE_SIZE = 12;
+	static const size_t TAG_SIZE = 16;
+	// the number of blocks transformed together by the widest block cipher function
+	static const size_t WIDE_BLOCKS = 16;
+	// the counter blocks of one wide transform, followed by their key-stream
+	static const size_t SCRATCH_SIZE = 2 * WIDE_BLOCKS * BLOCK_SIZE;
+
+	class GcmSivState;
+	std::unique_ptr<GcmSivState> m_gcmSivState;
+	std::unique_ptr<IBlockCipher> m_blockCipher;
+	std::unique_ptr<Digest::POLYVAL> m_macAuthenticator;
+	std::vector<SymmetricKeySize> m_legalKeySizes;
+	ParallelOptions m_parallelProfile;
+
+public:
+
+	//~~~Constructor~~~//
+
+	/// <summary>
+	/// Copy constructor: copy is restricted, this function has been deleted
+	/// </summary>
+	GCMSIV(const GCMSIV&) = delete;
+
+	/// <summary>
+	/// Copy operator: copy is restricted, this function has been deleted
+	/// </summary>
+	GCMSIV& operator=(const GCMSIV&) = delete;
+
+	/// <summary>
+	/// Default constructor: default is restricted, this function has been deleted
+	/// </summary>
+	GCMSIV() = delete;
+
+	/// <summary>
+	/// Initialize the Cipher Mode using a block cipher type name.
+	/// <para>The cipher instance is created and destroyed automatically.</para>
+	/// </summary>
+	///
+	/// <param name="CipherType">The enumeration name of the block cipher; AES or Serpent</param>
+	///
+	/// <exception cref="CryptoCipherModeException">Thrown if an invalid block cipher type is selected</exception>
+	explicit GCMSIV(BlockCiphers CipherType);
+
+	/// <summary>
+	/// Initialize the Cipher Mode using a block cipher instance
+	/// </summary>
+	///
+	/// <param name="Cipher">An uninitialized AES or Serpent Block Cipher instance; can not be null</param>
+	///
+	/// <exception cref="CryptoCipherModeException">Thrown if a null or unsupported block cipher is used</exception>
+	explicit GCMSIV(IBlockCipher* Cipher);
+
+	/// <summary>
+	/// Destructor: finalize this class
+	/// </summary>
+	~GCMSIV() override;
+
+	//~~~Accessors~~~//
+
+	/// <summary>
+	/// Read Only: The Cipher Modes enumeration type name
+	/// </summary>
+	const AeadModes Enumeral() override;
+
+	/// <summary>
+	/// Read Only: True if initialized for encryption, False for decryption
+	/// </summary>
+	const bool IsEncryption() override;
+
+	/// <summary>
+	/// Read Only: The Block Cipher is ready to transform data
+	/// </summary>
+	const bool IsInitialized() override;
+
+	/// <summary>
+	/// Read Only: Processor parallelization availability.
+	/// <para>Indicates whether parallel processing is available with this mode.
+	/// If parallel capable, input/output data arrays passed to the transform must be ParallelBlockSize in bytes to trigger parallelization.</para>
+	/// </summary>
+	const bool IsParallel() override;
+
+	/// <summary>
+	/// Read Only: Array of allowed cipher input key uint8_t-sizes
+	/// </summary>
+	const std::vector<SymmetricKeySize> &LegalKeySizes() override;
+
+	/// <summary>
+	/// Read Only: The mode and cipher name
+	/// </summary>
+	const std::string Name() override;
+
+	/// <summary>
+	/// Read Only: Parallel block size; the uint8_t-size of the input/output data arrays passed to a transform that trigger parallel processing.
+	/// <para>This value can be changed through the ParallelProfile class.</para>
+	/// </summary>
+	const size_t ParallelBlockSize() override;
+
+	/// <summary>
+	/// Read/Write: Parallel and SIMD capability flags and sizes
+	/// <para>The maximum number of threads allocated when using multi-threaded processing can be set with the ParallelMaxDegree() property.
+	/// The ParallelBlockSize() property is auto-calculated, but can be changed; the value must be evenly divisible by ParallelMinimumSize().
+	/// Changes to these values must be made before the <see cref="Initialize(SymmetricKey)"/> function is called.</para>
+	/// </summary>
+	ParallelOptions &ParallelProfile() override;
+
+	/// <summary>
+	/// Read Only: The current standard-vector MAC tag value
+	/// </summary>
+	const std::vector<uint8_t> Tag() override;
+
+	/// <summary>
+	/// Copies the internal MAC tag to a secure-vector
+	/// </summary>
+	///
+	/// <param name="Output">The secure-vector receiving the MAC code</param>
+	const void Tag(SecureVector<uint8_t> &Output) override;
+
+	/// <summary>
+	/// Read Only: The MAC code length in bytes
+	/// </summary>
+	const size_t TagSize() override;
+
+	//~~~Public Functions~~~//
+
+	/// <summary>
+	/// Initialize the Cipher instance.
+	/// <para>The legal symmetric key and nonce sizes are contained in the LegalKeySizes() property.
+	/// The message authentication and encryption keys are derived from the key and nonce.
+	/// If the key size is zero, the key-generating key of the previous initialization is used with the new nonce.</para>
+	/// </summary>
+	///
+	/// <param name="Encryption">Set to true if cipher is used for encryption, false for decryption operation mode</param>
+	/// <param name="Parameters">SymmetricKey containing the key-generating Key and the 12 byte Nonce</param>
+	///
+	/// <exception cref="CryptoCipherModeException">Thrown if a null or invalid Key/Nonce is used</exception>
+	void Initialize(bool Encryption, ISymmetricKey &Parameters) override;
+
+	/// <summary>
+	/// Set the maximum number of threads allocated when using multi-threaded processing.
+	/// <para>When set to zero, thread count is set automatically. If set to 1, sets IsParallel() to false and runs in sequential mode.
+	/// Thread count must be an even number, and not exceed the number of processor cores.</para>
+	/// </summary>
+	///
+	/// <param name="Degree">The number of threads to allocate</param>
+	///
+	/// <exception cref="CryptoCipherModeException">Thrown if the degree parameter is invalid</exception>
+	void ParallelMaxDegree(size_t Degree) override;
+
+	/// <summary>
+	/// Add additional data to the message authentication code generator.
+	/// <para>Must be called after Initialize(bool, ISymmetricKey), and before any processing of plaintext or ciphertext input.
+	/// This function can only be called once per each initialization/finalization cycle.</para>
+	/// </summary>
+	///
+	/// <param name="Input">The input standard-vector of bytes to process</param>
+	/// <param name="Offset">The starting offset within the input vector</param>
+	/// <param name="Length">The number of bytes to process</param>
+	///
+	/// <exception cref="CryptoCipherModeException">Thrown if state has been processed</exception>
+	void SetAssociatedData(const std::vector<uint8_t> &Input, size_t Offset, size_t Length) override;
+
+	/// <summary>
+	/// Add additional data to the message authentication code generator using a memory-locked vector.
+	/// <para>Must be called after Initialize(bool, ISymmetricKey), and before any processing of plaintext or ciphertext input.
+	/// This function can only be called once per each initialization/finalization cycle.</para>
+	/// </summary>
+	///
+	/// <param name="Input">The input secure-vector of bytes to process</param>
+	/// <param name="Offset">The starting offset within the input vector</param>
+	/// <param name="Length">The number of bytes to process</param>
+	///
+	/// <exception cref="CryptoCipherModeException">Thrown if state has been processed</exception>
+	void SetAssociatedData(const SecureVector<uint8_t> &Input, size_t Offset, size_t Length) override;
+
+	/// <summary>
+	/// Add additional data in the callers memory to the message authentication code generator.  
+	/// <para>Must be called after Initialize(bool, ISymmetricKey), and before the message is transformed. 
+	/// This function can only be called once per each initialization/finalization cycle.</para>
+	/// </summary>
+	/// 
+	/// <param name="Input">A pointer to the bytes to process</param>
+	/// <param name="Length">The number of bytes to process</param>
+	///
+	/// <exception cref="CryptoCipherModeException">Thrown if state has been processed</exception>
+	void SetAssociatedData(const uint8_t* Input, size_t Length) override;
+
+	/// <summary>
+	/// Transform a length of bytes with offset and length parameters.
+	/// <para>Encryption writes the cipher-text followed by the 16 byte tag to the output array; decryption reads the tag that follows the cipher-text in the input array.
+	/// If IsParallel() is set to true, and the length is at least ParallelBlockSize(), the counter-mode pass is run in parallel processing mode.
+	/// Initialize(bool, ISymmetricKey) must be called before this method can be used.</para>
+	/// </summary>
+	///
+	/// <param name="Input">The input vector of bytes to transform</param>
+	/// <param name="InOffset">The starting offset within the input vector</param>
+	/// <param name="Output">The output vector of transformed bytes</param>
+	/// <param name="OutOffset">The starting offset within the output vector</param>
+	/// <param name="Length">The number of bytes to transform, not including the tag</param>
+	///
+	/// <exception cref="CryptoAuthenticationFailure">Thrown during decryption if the tag does not match</exception>
+	void Transform(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length) override;
+
+	/// <summary>
+	/// Transform a length of bytes in the callers memory. 
+	/// <para>The pointer form of Transform, for buffers that are not held in a vector, such as pooled, mapped or scatter-gather memory.
+	/// Encryption writes the MAC tag after the cipher-text, so Output must have room for Length + TagSize() bytes; decryption reads the tag following the Length bytes of cipher-text.
+	/// The message is hashed in segments of ParallelBlockSize(), and the counter-mode pass xors the key-stream directly into Output.
+	/// Input and Output may be the same address for an in-place transform, but must not otherwise overlap.
+	/// Initialize(bool, ISymmetricKey) must be called before this method can be used.</para>
+	/// </summary>
+	/// 
+	/// <param name="Input">A pointer to the bytes to transform</param>
+	/// <param name="Output">A pointer to the transformed bytes</param>
+	/// <param name="Length">The number of message bytes to transform, not including the tag</param>
+	///
+	/// <exception cref="CryptoAuthenticationFailure">Thrown during decryption if the authentication tag does not match</exception>
+	void Transform(const uint8_t* Input, uint8_t* Output, size_t Length) override;
+
+private:
+
+	void ComputeTag(size_t Length);
+	void Generate(const uint8_t* Input, uint8_t* Output, size_t Length, std::vector<uint8_t> &Counter, std::vector<uint8_t> &Buffer);
+	static void Increase32(const std::vector<uint8_t> &Counter, std::vector<uint8_t> &Output, uint32_t Value);
+	void Process(const uint8_t* Input, uint8_t* Output, size_t Length, const std::vector<uint8_t> &Tag);
+};
+
+NAMESPACE_MODEEND
+#endif
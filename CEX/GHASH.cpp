@@ -1,7 +1,7 @@
 #include "GHASH.h"
 #include "CpuDetect.h"
 #include "IntegerTools.h"
-#if defined(CEX_HAS_AVX2)
+#if defined(CEX_HAS_AESNI)
 #	include "Intrinsics.h"
 #	include <wmmintrin.h>
 #endif
@@ -17,6 +17,11 @@ class GHASH::GhashState
 {
 public:
 
+#if defined(CEX_HAS_AESNI)
+	// H^1..H^8 in the byte-reflected form, and the xor of each halves for the karatsuba middle product
+	std::array<__m128i, AGGREGATE_BLOCKS> Karatsuba;
+	std::array<__m128i, AGGREGATE_BLOCKS> Powers;
+#endif
 	std::array<uint64_t, CMUL::CMUL_STATE_SIZE> State = { 0 };
 	std::array<uint8_t, CMUL::CMUL_BLOCK_SIZE> Buffer = { 0 };
 	size_t Position = 0;
@@ -35,6 +40,10 @@ public:
 		Position = 0;
 		MemoryTools::Clear(Buffer, 0, Buffer.size());
 		MemoryTools::Clear(State, 0, State.size() * sizeof(uint64_t));
+#if defined(CEX_HAS_AESNI)
+		MemoryTools::Clear(Karatsuba, 0, Karatsuba.size() * sizeof(__m128i));
+		MemoryTools::Clear(Powers, 0, Powers.size() * sizeof(__m128i));
+#endif
 	}
 };
 
@@ -61,6 +70,184 @@ void GHASH::Clear()
 	m_dgtState->Position = 0;
 }
 
+void GHASH::Combine(const std::vector<uint8_t> &Partial, size_t Blocks, std::vector<uint8_t> &Tag)
+{
+	std::array<uint64_t, CMUL::CMUL_STATE_SIZE> tmps;
+	std::vector<uint8_t> tmph(CMUL::CMUL_BLOCK_SIZE);
+	std::vector<uint8_t> tmpp(CMUL::CMUL_BLOCK_SIZE);
+
+	// multiply by H^Blocks with the square and multiply method; H^(2^k) is carried in tmph
+	tmps = m_dgtState->State;
+	IntegerTools::Be64ToBytes(tmps[0], tmph, 0);
+	IntegerTools::Be64ToBytes(tmps[1], tmph, 8);
+
+	while (Blocks != 0)
+	{
+		if ((Blocks & 1) != 0)
+		{
+			Permute(tmps, Tag);
+		}
+
+		Blocks >>= 1;
+
+		if (Blocks != 0)
+		{
+			MemoryTools::COPY128(tmph, 0, tmpp, 0);
+			Permute(tmps, tmpp);
+			MemoryTools::COPY128(tmpp, 0, tmph, 0);
+			tmps[0] = IntegerTools::BeBytesTo64(tmph, 0);
+			tmps[1] = IntegerTools::BeBytesTo64(tmph, 8);
+		}
+	}
+
+	MemoryTools::XOR128(Partial, 0, Tag, 0);
+	MemoryTools::Clear(tmph, 0, tmph.size());
+	MemoryTools::Clear(tmpp, 0, tmpp.size());
+	MemoryTools::Clear(tmps, 0, tmps.size() * sizeof(uint64_t));
+}
+
+#if defined(CEX_HAS_AESNI)
+void GHASH::Encrypt(const std::vector<__m128i> &RoundKeys, std::vector<uint8_t> &Counter, const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length, std::vector<uint8_t> &Tag)
+{
+	CEXASSERT(HAS_CMUL, "The processor does not support the carry-less multiply instructions!");
+	CEXASSERT(m_dgtState->Position == 0, "The message buffer is not empty!");
+
+	const size_t AGGLEN = AGGREGATE_BLOCKS * CMUL::CMUL_BLOCK_SIZE;
+	const size_t RNDCNT = RoundKeys.size() - 1;
+	const __m128i MASK = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+	std::array<__m128i, AGGREGATE_BLOCKS> c;
+	std::array<__m128i, AGGREGATE_BLOCKS> p;
+	std::vector<uint8_t> tmpk(CMUL::CMUL_BLOCK_SIZE);
+	__m128i hi;
+	__m128i lo;
+	__m128i md;
+	__m128i y;
+	uint64_t chi;
+	uint64_t clo;
+	size_t blen;
+	size_t i;
+	size_t j;
+	size_t poff;
+	bool prv;
+
+	chi = IntegerTools::BeBytesTo64(Counter, 0);
+	clo = IntegerTools::BeBytesTo64(Counter, 8);
+	y = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(Tag.data())), MASK);
+	hi = _mm_setzero_si128();
+	lo = _mm_setzero_si128();
+	md = _mm_setzero_si128();
+	poff = 0;
+	prv = false;
+
+	// the cipher-text of each 8 block chunk is absorbed while the next chunk is encrypted
+	for (i = 0; i + AGGLEN <= Length; i += AGGLEN)
+	{
+		for (j = 0; j < AGGREGATE_BLOCKS; ++j)
+		{
+			c[j] = _mm_xor_si128(_mm_shuffle_epi8(_mm_set_epi64x(chi, clo), MASK), RoundKeys[0]);
+			++clo;
+			chi += (clo == 0) ? 1 : 0;
+		}
+
+		if (prv)
+		{
+			hi = _mm_setzero_si128();
+			lo = _mm_setzero_si128();
+			md = _mm_setzero_si128();
+		}
+
+		for (j = 1; j < RNDCNT; ++j)
+		{
+			c[0] = _mm_aesenc_si128(c[0], RoundKeys[j]);
+			c[1] = _mm_aesenc_si128(c[1], RoundKeys[j]);
+			c[2] = _mm_aesenc_si128(c[2], RoundKeys[j]);
+			c[3] = _mm_aesenc_si128(c[3], RoundKeys[j]);
+			c[4] = _mm_aesenc_si128(c[4], RoundKeys[j]);
+			c[5] = _mm_aesenc_si128(c[5], RoundKeys[j]);
+			c[6] = _mm_aesenc_si128(c[6], RoundKeys[j]);
+			c[7] = _mm_aesenc_si128(c[7], RoundKeys[j]);
+
+			// one karatsuba multiply of the previous chunk per round; the first block takes the highest power
+			if (prv && j <= AGGREGATE_BLOCKS)
+			{
+				const __m128i H = m_dgtState->Powers[AGGREGATE_BLOCKS - j];
+				const __m128i X = p[j - 1];
+
+				lo = _mm_xor_si128(lo, _mm_clmulepi64_si128(X, H, 0x00));
+				hi = _mm_xor_si128(hi, _mm_clmulepi64_si128(X, H, 0x11));
+				md = _mm_xor_si128(md, _mm_clmulepi64_si128(_mm_xor_si128(X, _mm_shuffle_epi32(X, 0x4E)), m_dgtState->Karatsuba[AGGREGATE_BLOCKS - j], 0x00));
+			}
+		}
+
+		if (prv)
+		{
+			md = _mm_xor_si128(md, _mm_xor_si128(lo, hi));
+			y = Reduce(_mm_xor_si128(lo, _mm_slli_si128(md, 8)), _mm_xor_si128(hi, _mm_srli_si128(md, 8)));
+		}
+
+		for (j = 0; j < AGGREGATE_BLOCKS; ++j)
+		{
+			c[j] = _mm_aesenclast_si128(c[j], RoundKeys[RNDCNT]);
+			c[j] = _mm_xor_si128(c[j], _mm_loadu_si128(reinterpret_cast<const __m128i*>(&Input[InOffset + i + (j * CMUL::CMUL_BLOCK_SIZE)])));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(&Output[OutOffset + i + (j * CMUL::CMUL_BLOCK_SIZE)]), c[j]);
+			p[j] = _mm_shuffle_epi8(c[j], MASK);
+		}
+
+		// the hash state is folded into the first block of the chunk
+		p[0] = _mm_xor_si128(p[0], y);
+		prv = true;
+		poff = i + AGGLEN;
+	}
+
+	if (prv)
+	{
+		hi = _mm_setzero_si128();
+		lo = _mm_setzero_si128();
+		md = _mm_setzero_si128();
+
+		for (j = 0; j < AGGREGATE_BLOCKS; ++j)
+		{
+			lo = _mm_xor_si128(lo, _mm_clmulepi64_si128(p[j], m_dgtState->Powers[AGGREGATE_BLOCKS - 1 - j], 0x00));
+			hi = _mm_xor_si128(hi, _mm_clmulepi64_si128(p[j], m_dgtState->Powers[AGGREGATE_BLOCKS - 1 - j], 0x11));
+			md = _mm_xor_si128(md, _mm_clmulepi64_si128(_mm_xor_si128(p[j], _mm_shuffle_epi32(p[j], 0x4E)), m_dgtState->Karatsuba[AGGREGATE_BLOCKS - 1 - j], 0x00));
+		}
+
+		md = _mm_xor_si128(md, _mm_xor_si128(lo, hi));
+		y = Reduce(_mm_xor_si128(lo, _mm_slli_si128(md, 8)), _mm_xor_si128(hi, _mm_srli_si128(md, 8)));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(Tag.data()), _mm_shuffle_epi8(y, MASK));
+	}
+
+	// the remaining blocks are encrypted singly, and absorbed by the buffered update
+	for (i = poff; i < Length; i += blen)
+	{
+		blen = IntegerTools::Min(Length - i, CMUL::CMUL_BLOCK_SIZE);
+		c[0] = _mm_xor_si128(_mm_shuffle_epi8(_mm_set_epi64x(chi, clo), MASK), RoundKeys[0]);
+		++clo;
+		chi += (clo == 0) ? 1 : 0;
+
+		for (j = 1; j < RNDCNT; ++j)
+		{
+			c[0] = _mm_aesenc_si128(c[0], RoundKeys[j]);
+		}
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(tmpk.data()), _mm_aesenclast_si128(c[0], RoundKeys[RNDCNT]));
+		MemoryTools::XOR(Input, InOffset + i, tmpk, 0, blen);
+		MemoryTools::Copy(tmpk, 0, Output, OutOffset + i, blen);
+	}
+
+	if (poff != Length)
+	{
+		Update(Output, OutOffset + poff, Tag, Length - poff);
+	}
+
+	IntegerTools::Be64ToBytes(chi, Counter, 0);
+	IntegerTools::Be64ToBytes(clo, Counter, 8);
+	MemoryTools::Clear(tmpk, 0, tmpk.size());
+	MemoryTools::Clear(c, 0, c.size() * sizeof(__m128i));
+	MemoryTools::Clear(p, 0, p.size() * sizeof(__m128i));
+}
+#endif
+
 void GHASH::Finalize(std::vector<uint8_t> &Output, size_t ADLength, size_t TxtLength)
 {
 	if (m_dgtState->Position != 0)
@@ -85,6 +272,32 @@ void GHASH::Finalize(std::vector<uint8_t> &Output, size_t ADLength, size_t TxtLe
 void GHASH::Initialize(const std::vector<uint64_t> &Key)
 {
 	MemoryTools::Copy(Key, 0, m_dgtState->State, 0, Key.size() * sizeof(uint64_t));
+
+#if defined(CEX_HAS_AESNI)
+	if (HAS_CMUL)
+	{
+		const __m128i MASK = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+		__m128i h;
+		size_t i;
+
+		// the powers of H used by the aggregated reduction
+		h = _mm_loadu_si128(reinterpret_cast<const __m128i*>(m_dgtState->State.data()));
+		h = _mm_shuffle_epi8(h, _mm_set_epi8(8, 9, 10, 11, 12, 13, 14, 15, 0, 1, 2, 3, 4, 5, 6, 7));
+		m_dgtState->Powers[0] = _mm_shuffle_epi8(h, MASK);
+
+		for (i = 1; i < AGGREGATE_BLOCKS; ++i)
+		{
+			m_dgtState->Powers[i] = Multiply128(m_dgtState->Powers[i - 1], m_dgtState->Powers[0]);
+		}
+
+		for (i = 0; i < AGGREGATE_BLOCKS; ++i)
+		{
+			m_dgtState->Karatsuba[i] = _mm_xor_si128(m_dgtState->Powers[i], _mm_shuffle_epi32(m_dgtState->Powers[i], 0x4E));
+		}
+
+		h = _mm_setzero_si128();
+	}
+#endif
 }
 
 void GHASH::Multiply(const std::vector<uint8_t> &Input, std::vector<uint8_t> &Output, size_t Length)
@@ -103,6 +316,53 @@ void GHASH::Multiply(const std::vector<uint8_t> &Input, std::vector<uint8_t> &Ou
 	}
 }
 
+void GHASH::Partial(const std::vector<uint8_t> &Input, size_t InOffset, size_t Length, std::vector<uint8_t> &Output)
+{
+	CEXASSERT(Input.size() - InOffset >= Length, "The input array is too small");
+
+	Partial(Input.data() + InOffset, Length, Output);
+}
+
+void GHASH::Partial(const uint8_t* Input, size_t Length, std::vector<uint8_t> &Output)
+{
+	std::array<uint64_t, CMUL::CMUL_STATE_SIZE> tmps;
+	std::vector<uint8_t> tmpb(CMUL::CMUL_BLOCK_SIZE);
+
+	// the key state is copied so that concurrent callers do not share it
+	tmps = m_dgtState->State;
+	MemoryTools::Clear(Output, 0, CMUL::CMUL_BLOCK_SIZE);
+
+#if defined(CEX_HAS_AESNI)
+	if (HAS_CMUL)
+	{
+		while (Length >= AGGREGATE_BLOCKS * CMUL::CMUL_BLOCK_SIZE)
+		{
+			Aggregate(Input, Output);
+			Length -= AGGREGATE_BLOCKS * CMUL::CMUL_BLOCK_SIZE;
+			Input += AGGREGATE_BLOCKS * CMUL::CMUL_BLOCK_SIZE;
+		}
+	}
+#endif
+
+	while (Length >= CMUL::CMUL_BLOCK_SIZE)
+	{
+		MemoryTools::XorRaw(Input, Output.data(), CMUL::CMUL_BLOCK_SIZE);
+		Permute(tmps, Output);
+		Length -= CMUL::CMUL_BLOCK_SIZE;
+		Input += CMUL::CMUL_BLOCK_SIZE;
+	}
+
+	if (Length != 0)
+	{
+		MemoryTools::CopyRaw(Input, tmpb.data(), Length);
+		MemoryTools::XOR128(tmpb, 0, Output, 0);
+		Permute(tmps, Output);
+		MemoryTools::Clear(tmpb, 0, tmpb.size());
+	}
+
+	MemoryTools::Clear(tmps, 0, tmps.size() * sizeof(uint64_t));
+}
+
 void GHASH::Reset()
 {
 	m_dgtState->Reset();
@@ -113,6 +373,13 @@ const size_t GHASH::TagSize()
 }
 
 void GHASH::Update(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t Length)
+{
+	CEXASSERT(Input.size() - InOffset >= Length, "The input array is too small");
+
+	Update(Input.data() + InOffset, Output, Length);
+}
+
+void GHASH::Update(const uint8_t* Input, std::vector<uint8_t> &Output, size_t Length)
 {
 	if (Length != 0)
 	{
@@ -127,30 +394,129 @@ void GHASH::Update(const std::vector<uint8_t> &Input, size_t InOffset, std::vect
 
 		if (Length > RMDLEN)
 		{
-			MemoryTools::Copy(Input, InOffset, m_dgtState->Buffer, m_dgtState->Position, RMDLEN);
+			MemoryTools::CopyRaw(Input, m_dgtState->Buffer.data() + m_dgtState->Position, RMDLEN);
 			MemoryTools::XOR128(m_dgtState->Buffer, 0, Output, 0);
 			Permute(m_dgtState->State, Output);
 			m_dgtState->Position = 0;
 			Length -= RMDLEN;
-			InOffset += RMDLEN;
+			Input += RMDLEN;
+
+#if defined(CEX_HAS_AESNI)
+			if (HAS_CMUL)
+			{
+				while (Length > AGGREGATE_BLOCKS * CMUL::CMUL_BLOCK_SIZE)
+				{
+					Aggregate(Input, Output);
+					Length -= AGGREGATE_BLOCKS * CMUL::CMUL_BLOCK_SIZE;
+					Input += AGGREGATE_BLOCKS * CMUL::CMUL_BLOCK_SIZE;
+				}
+			}
+#endif
 
 			while (Length > CMUL::CMUL_BLOCK_SIZE)
 			{
-				MemoryTools::XOR128(Input, InOffset, Output, 0);
+				MemoryTools::XorRaw(Input, Output.data(), CMUL::CMUL_BLOCK_SIZE);
 				Permute(m_dgtState->State, Output);
 				Length -= CMUL::CMUL_BLOCK_SIZE;
-				InOffset += CMUL::CMUL_BLOCK_SIZE;
+				Input += CMUL::CMUL_BLOCK_SIZE;
 			}
 		}
 
 		if (Length > 0)
 		{
-			MemoryTools::Copy(Input, InOffset, m_dgtState->Buffer, m_dgtState->Position, Length);
+			MemoryTools::CopyRaw(Input, m_dgtState->Buffer.data() + m_dgtState->Position, Length);
 			m_dgtState->Position += Length;
 		}
 	}
 }
 
+#if defined(CEX_HAS_AESNI)
+void GHASH::Aggregate(const uint8_t* Input, std::vector<uint8_t> &Output)
+{
+	const __m128i MASK = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+	__m128i hi;
+	__m128i lo;
+	__m128i md;
+	__m128i x;
+	size_t i;
+
+	hi = _mm_setzero_si128();
+	lo = _mm_setzero_si128();
+	md = _mm_setzero_si128();
+
+	// (Y ^ X1)H^8 ^ X2H^7 ^ .. ^ X8H, with the products summed before a single reduction
+	for (i = 0; i < AGGREGATE_BLOCKS; ++i)
+	{
+		x = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(Input + (i * CMUL::CMUL_BLOCK_SIZE))), MASK);
+
+		if (i == 0)
+		{
+			x = _mm_xor_si128(x, _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(Output.data())), MASK));
+		}
+
+		lo = _mm_xor_si128(lo, _mm_clmulepi64_si128(x, m_dgtState->Powers[AGGREGATE_BLOCKS - 1 - i], 0x00));
+		hi = _mm_xor_si128(hi, _mm_clmulepi64_si128(x, m_dgtState->Powers[AGGREGATE_BLOCKS - 1 - i], 0x11));
+		md = _mm_xor_si128(md, _mm_clmulepi64_si128(_mm_xor_si128(x, _mm_shuffle_epi32(x, 0x4E)), m_dgtState->Karatsuba[AGGREGATE_BLOCKS - 1 - i], 0x00));
+	}
+
+	md = _mm_xor_si128(md, _mm_xor_si128(lo, hi));
+	x = Reduce(_mm_xor_si128(lo, _mm_slli_si128(md, 8)), _mm_xor_si128(hi, _mm_srli_si128(md, 8)));
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(Output.data()), _mm_shuffle_epi8(x, MASK));
+}
+
+__m128i GHASH::Multiply128(__m128i A, __m128i B)
+{
+	__m128i T0;
+	__m128i T1;
+	__m128i T3;
+
+	T0 = _mm_clmulepi64_si128(A, B, 0x00);
+	T1 = _mm_xor_si128(_mm_clmulepi64_si128(A, B, 0x01), _mm_clmulepi64_si128(A, B, 0x10));
+	T3 = _mm_clmulepi64_si128(A, B, 0x11);
+	T0 = _mm_xor_si128(T0, _mm_slli_si128(T1, 8));
+	T3 = _mm_xor_si128(T3, _mm_srli_si128(T1, 8));
+
+	return Reduce(T0, T3);
+}
+
+__m128i GHASH::Reduce(__m128i Low, __m128i High)
+{
+	__m128i T2;
+	__m128i T4;
+	__m128i T5;
+
+	// shift the 256-bit product left by one for the reflected operands, then reduce modulo x^128 + x^7 + x^2 + x + 1
+	T4 = _mm_srli_epi32(Low, 31);
+	Low = _mm_slli_epi32(Low, 1);
+	T5 = _mm_srli_epi32(High, 31);
+	High = _mm_slli_epi32(High, 1);
+	T2 = _mm_srli_si128(T4, 12);
+	T5 = _mm_slli_si128(T5, 4);
+	T4 = _mm_slli_si128(T4, 4);
+	Low = _mm_or_si128(Low, T4);
+	High = _mm_or_si128(High, T5);
+	High = _mm_or_si128(High, T2);
+	T4 = _mm_slli_epi32(Low, 31);
+	T5 = _mm_slli_epi32(Low, 30);
+	T2 = _mm_slli_epi32(Low, 25);
+	T4 = _mm_xor_si128(T4, T5);
+	T4 = _mm_xor_si128(T4, T2);
+	T5 = _mm_srli_si128(T4, 4);
+	High = _mm_xor_si128(High, T5);
+	T4 = _mm_slli_si128(T4, 12);
+	Low = _mm_xor_si128(Low, T4);
+	High = _mm_xor_si128(High, Low);
+	T4 = _mm_srli_epi32(Low, 1);
+	T5 = _mm_srli_epi32(Low, 2);
+	T2 = _mm_srli_epi32(Low, 7);
+	High = _mm_xor_si128(High, T5);
+	High = _mm_xor_si128(High, T2);
+	High = _mm_xor_si128(High, T4);
+
+	return High;
+}
+#endif
+
 void GHASH::Permute(std::array<uint64_t, CMUL::CMUL_STATE_SIZE> &State, std::vector<uint8_t> &Output)
 {
 	std::array<uint8_t, 16> tmp = { 0 };
@@ -175,9 +541,10 @@ void GHASH::Permute(std::array<uint64_t, CMUL::CMUL_STATE_SIZE> &State, std::vec
 
 bool GHASH::HasGmul()
 {
-	CpuDetect dtc;
+	CpuDetect &dtc = CpuDetect::Instance();
 
-	return dtc.CMUL() && dtc.AVX();
+	// the multiply and reduction use the ssse3 shuffles, which every sse4.1 processor supports
+	return dtc.CMUL() && dtc.SSE41();
 }
 
 NAMESPACE_DIGESTEND
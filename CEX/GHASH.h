@@ -3,6 +3,9 @@
 
 #include "CexDomain.h"
 #include "CMUL.h"
+#if defined(CEX_HAS_AESNI)
+#	include "Intrinsics.h"
+#endif
 
 NAMESPACE_DIGEST
 
@@ -22,6 +25,8 @@ private:
 	static const std::string CLASS_NAME;
 	static const bool HAS_CMUL;
 	static const size_t TAG_SIZE = 16;
+	// the number of blocks absorbed per reduction by the aggregated functions
+	static const size_t AGGREGATE_BLOCKS = 8;
 
 	class GhashState;
 	std::unique_ptr<GhashState> m_dgtState;
@@ -57,6 +62,36 @@ public:
 	/// </summary>
 	void Clear();
 
+#if defined(CEX_HAS_AESNI)
+	/// <summary>
+	/// Encrypt with AES in counter mode and absorb the cipher-text, in a single pass over the data (stitched AES-GCM).
+	/// <para>Eight counter blocks are encrypted at a time, and their AES rounds are interleaved with the carry-less multiplies of the previous 
+	/// eight cipher-text blocks against the precomputed powers H^8..H^1, with one reduction per eight blocks.
+	/// The counter is a 128-bit big-endian integer, incremented as the CTR mode does, and is advanced past the blocks used.
+	/// Requires HasGmul(), an initialized hash key, and an empty message buffer.</para>
+	/// </summary>
+	///
+	/// <param name="RoundKeys">The AES-NI round-key schedule of the cipher</param>
+	/// <param name="Counter">The counter block; receives the next counter value</param>
+	/// <param name="Input">The plain-text input array</param>
+	/// <param name="InOffset">The offset within the input array</param>
+	/// <param name="Output">The cipher-text output array</param>
+	/// <param name="OutOffset">The offset within the output array</param>
+	/// <param name="Length">The number of bytes to process</param>
+	/// <param name="Tag">The hash state array</param>
+	void Encrypt(const std::vector<__m128i> &RoundKeys, std::vector<uint8_t> &Counter, const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length, std::vector<uint8_t> &Tag);
+#endif
+
+	/// <summary>
+	/// Combine the hash of a following message segment with the hash state: Tag = Tag * H^Blocks ^ Partial.
+	/// <para>Used to join the segment hashes computed by Partial(Input, InOffset, Length, Output), in message order.</para>
+	/// </summary>
+	///
+	/// <param name="Partial">The hash of the following segment</param>
+	/// <param name="Blocks">The number of 16 byte blocks in the segment, including a zero-padded partial block</param>
+	/// <param name="Tag">The hash state array</param>
+	void Combine(const std::vector<uint8_t> &Partial, size_t Blocks, std::vector<uint8_t> &Tag);
+
 	/// <summary>
 	/// Finalize the GHASH block
 	/// </summary>
@@ -66,6 +101,11 @@ public:
 	/// <param name="TxtLength">The plain text size</param>
 	void Finalize(std::vector<uint8_t> &Output, size_t ADLength, size_t TxtLength);
 
+	/// <summary>
+	/// Test the processor for the PCLMULQDQ and AVX instructions used by the vectorized and aggregated functions
+	/// </summary>
+	static bool HasGmul();
+
 	/// <summary>
 	/// Initialize the hash key
 	/// </summary>
@@ -82,6 +122,27 @@ public:
 	/// <param name="Length">The number of input bytes to process</param>
 	void Multiply(const std::vector<uint8_t> &Input, std::vector<uint8_t> &Output, size_t Length);
 
+	/// <summary>
+	/// Hash one segment of a message from a zero state, without changing the message buffer.
+	/// <para>A partial last block is zero-padded. The function only reads the key state, 
+	/// so the segments of a message can be hashed concurrently, and joined with Combine(Partial, Blocks, Tag).</para>
+	/// </summary>
+	///
+	/// <param name="Input">The source array</param>
+	/// <param name="InOffset">The offset within the source array</param>
+	/// <param name="Length">The number of bytes to process</param>
+	/// <param name="Output">The 16 byte segment hash array</param>
+	void Partial(const std::vector<uint8_t> &Input, size_t InOffset, size_t Length, std::vector<uint8_t> &Output);
+
+	/// <summary>
+	/// Hash one segment of a message from a zero state, reading the message directly from caller memory
+	/// </summary>
+	///
+	/// <param name="Input">A pointer to the first byte of the segment</param>
+	/// <param name="Length">The number of bytes to process</param>
+	/// <param name="Output">The 16 byte segment hash array</param>
+	void Partial(const uint8_t* Input, size_t Length, std::vector<uint8_t> &Output);
+
 	/// <summary>
 	/// Reset the hash function
 	/// </summary>
@@ -102,10 +163,23 @@ public:
 	/// <param name="Length">The number of bytes to process</param>
 	void Update(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t Length);
 
+	/// <summary>
+	/// Update the hash function, reading the message directly from caller memory
+	/// </summary>
+	///
+	/// <param name="Input">A pointer to the first input byte</param>
+	/// <param name="Output">The output array</param>
+	/// <param name="Length">The number of bytes to process</param>
+	void Update(const uint8_t* Input, std::vector<uint8_t> &Output, size_t Length);
+
 private:
 
+#if defined(CEX_HAS_AESNI)
+	void Aggregate(const uint8_t* Input, std::vector<uint8_t> &Output);
+	static __m128i Multiply128(__m128i A, __m128i B);
+	static __m128i Reduce(__m128i Low, __m128i High);
+#endif
 	static void Permute(std::array<uint64_t, CMUL::CMUL_STATE_SIZE> &State, std::vector<uint8_t> &Output);
-	static bool HasGmul();
 };
 
 NAMESPACE_DIGESTEND
@@ -335,7 +335,7 @@ void GMAC::Absorb(const std::vector<uint8_t> &Input, size_t InOffset, size_t Len
 
 bool GMAC::HasCMUL()
 {
-	CpuDetect dtc;
+	CpuDetect &dtc = CpuDetect::Instance();
 
 	return dtc.CMUL() && dtc.AVX();
 }
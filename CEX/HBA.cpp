@@ -3,8 +3,10 @@
 #include "IntegerTools.h"
 #include "ParallelTools.h"
 #include "IntegerTools.h"
+#include "KMAC.h"
 #include "MacFromName.h"
 #include "MemoryTools.h"
+#include "SegmentScratch.h"
 #include "SHAKE.h"
 
 NAMESPACE_MODE
@@ -13,7 +15,9 @@ using Enumeration::AeadModeConvert;
 using Enumeration::BlockCipherConvert;
 using Enumeration::Digests;
 using Tools::IntegerTools;
+using Mac::KMAC;
 using Tools::MemoryTools;
+using Tools::SegmentScratch;
 using Enumeration::SHA2Digests;
 using Kdf::SHAKE;
 using Enumeration::ShakeModes;
@@ -28,6 +32,7 @@ public:
 	SecureVector<uint8_t> MacKey;
 	SecureVector<uint8_t> MacTag;
 	SecureVector<uint8_t> Name;
+	SegmentScratch Segments;
 	uint64_t Counter;
 	StreamAuthenticators Authenticator;
 	SHA2Digests Digest;
@@ -43,6 +48,7 @@ public:
 		MacKey(0),
 		MacTag(0),
 		Name(0),
+		Segments(),
 		Counter(0),
 		Authenticator(StreamAuthenticators::None),
 		Mode(ShakeModes::None),
@@ -68,6 +74,7 @@ public:
 		MacKey.clear();
 		MacTag.clear();
 		Name.clear();
+		Segments.Clear();
 		Counter = 0;
 		Encryption = false;
 		Initialized = false;
@@ -385,6 +392,25 @@ void HBA::SetAssociatedData(const SecureVector<uint8_t> &Input, size_t Offset, s
 	}
 }
 
+void HBA::SetAssociatedData(const uint8_t* Input, size_t Length)
+{
+	if (IsInitialized() == false)
+	{
+		throw CryptoCipherModeException(Name(), std::string("SetAssociatedData"), std::string("The cipher has not been initialized!"), ErrorCodes::NotInitialized);
+	}
+
+	// add the additional data
+	if (Length != 0)
+	{
+		std::vector<uint8_t> actr(sizeof(uint32_t));
+		Absorb(Input, Length);
+		// seperate encoding for associated data v1.1a
+		IntegerTools::Le32ToBytes(static_cast<uint32_t>(Length), actr, 0);
+		// the counter terminates the mac update stream
+		m_macAuthenticator->Update(actr, 0, actr.size());
+	}
+}
+
 void HBA::Transform(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length)
 {
 	if (IsInitialized() == false)
@@ -434,8 +460,71 @@ void HBA::Transform(const std::vector<uint8_t> &Input, size_t InOffset, std::vec
 	}
 }
 
+void HBA::Transform(const uint8_t* Input, uint8_t* Output, size_t Length)
+{
+	if (IsInitialized() == false)
+	{
+		throw CryptoCipherModeException(Name(), std::string("Transform"), std::string("The cipher mode has not been initialized!"), ErrorCodes::NotInitialized);
+	}
+
+	// add the starting position of the nonce to the mac
+	m_macAuthenticator->Update(m_cipherMode->Nonce(), 0, m_cipherMode->Nonce().size());
+
+	if (IsEncryption() == true)
+	{
+		std::vector<uint8_t> code(m_macAuthenticator->TagSize());
+
+		// encrypt the plain-text
+		m_cipherMode->Transform(Input, Output, Length);
+		// update the MAC with the cipher-text
+		Absorb(Output, Length);
+		// update the mac counter
+		m_hbaState->Counter += Length;
+
+		// finalize and write the MAC code to the end of the output
+		Finalize(code, 0, code.size());
+		MemoryTools::CopyRaw(code.data(), Output + Length, code.size());
+	}
+	else
+	{
+		std::vector<uint8_t> code(m_macAuthenticator->TagSize());
+
+		// the received tag is copied before an in-place decryption can overwrite it
+		MemoryTools::CopyRaw(Input + Length, code.data(), code.size());
+		// update the MAC with the input cipher-text
+		Absorb(Input, Length);
+		// update the mac counter
+		m_hbaState->Counter += Length;
+
+		// compare the MAC code appended to the ciphertext with the one generated, if they do not match, throw exception bybassing decryption
+		if (!Verify(code, 0, code.size()))
+		{
+			throw CryptoAuthenticationFailure(Name(), std::string("Transform"), std::string("The authentication tag does not match!"), ErrorCodes::AuthenticationFailure);
+		}
+
+		m_cipherMode->Transform(Input, Output, Length);
+	}
+}
+
 //~~~Private Functions~~~//
 
+void HBA::Absorb(const uint8_t* Input, size_t Length)
+{
+	if (m_hbaState->Authenticator == StreamAuthenticators::KMAC256 || m_hbaState->Authenticator == StreamAuthenticators::KMAC512)
+	{
+		// kmac absorbs the callers memory directly
+		static_cast<KMAC*>(m_macAuthenticator.get())->Update(Input, Length);
+	}
+	else
+	{
+		// the hmac generators have only a vector interface, and are updated through the segment buffer
+		m_hbaState->Segments.Absorb(Input, Length, ParallelBlockSize(), [this](const std::vector<uint8_t> &Source, size_t Count)
+		{
+			m_macAuthenticator->Update(Source, 0, Count);
+		});
+	}
+}
+
 void HBA::Finalize(std::vector<uint8_t> &Output, size_t OutOffset, size_t Length)
 {
 	std::vector<uint8_t> pctr(sizeof(uint64_t));
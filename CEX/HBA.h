@@ -320,6 +320,18 @@ public:
 	/// <exception cref="CryptoCipherModeException">Thrown if state has been processed</exception>
 	void SetAssociatedData(const SecureVector<uint8_t> &Input, size_t Offset, size_t Length) override;
 
+	/// <summary>
+	/// Add additional data in the callers memory to the message authentication code generator.  
+	/// <para>Must be called after Initialize(bool, ISymmetricKey), and before any processing of plaintext or ciphertext input. 
+	/// This function can only be called once per each initialization/finalization cycle.</para>
+	/// </summary>
+	/// 
+	/// <param name="Input">A pointer to the bytes to process</param>
+	/// <param name="Length">The number of bytes to process</param>
+	///
+	/// <exception cref="CryptoCipherModeException">Thrown if state has been processed</exception>
+	void SetAssociatedData(const uint8_t* Input, size_t Length) override;
+
 	/// <summary>
 	/// Transform a length of bytes with offset and length parameters. 
 	/// <para>This method processes a specified length of bytes, utilizing offsets incremented by the caller.
@@ -339,10 +351,27 @@ public:
 	/// <param name="Length">The number of bytes to transform</param>
 	void Transform(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length) override;
 
+	/// <summary>
+	/// Transform a length of bytes in the callers memory. 
+	/// <para>The pointer form of Transform, for buffers that are not held in a vector, such as pooled, mapped or scatter-gather memory.
+	/// Encryption writes the MAC tag after the cipher-text, so Output must have room for Length + TagSize() bytes; decryption reads the tag following the Length bytes of cipher-text.
+	/// The counter-mode pass xors the key-stream directly into Output, and the cipher-text is added to the MAC in segments of ParallelBlockSize().
+	/// Input and Output may be the same address for an in-place transform, but must not otherwise overlap.
+	/// Initialize(bool, ISymmetricKey) must be called before this method can be used.</para>
+	/// </summary>
+	/// 
+	/// <param name="Input">A pointer to the bytes to transform</param>
+	/// <param name="Output">A pointer to the transformed bytes</param>
+	/// <param name="Length">The number of message bytes to transform, not including the tag</param>
+	///
+	/// <exception cref="CryptoAuthenticationFailure">Thrown during decryption if the authentication tag does not match</exception>
+	void Transform(const uint8_t* Input, uint8_t* Output, size_t Length) override;
+
 	//~~~Private Functions~~~//
 
 private:
 
+	void Absorb(const uint8_t* Input, size_t Length);
 	void Finalize(std::vector<uint8_t> &Output, size_t OutOffset, size_t Length);
 	bool Verify(const std::vector<uint8_t> &Input, size_t InOffset, size_t Length);
 };
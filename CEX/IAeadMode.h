@@ -28,6 +28,7 @@
 #include "ParallelOptions.h"
 #include "SecureVector.h"
 #include "SymmetricKeySize.h"
+#include "TransformHandle.h"
 
 NAMESPACE_MODE
 
@@ -186,6 +187,18 @@ public:
 	/// <exception cref="CryptoCipherModeException">Thrown if state has been processed</exception>
 	virtual void SetAssociatedData(const SecureVector<uint8_t> &Input, size_t Offset, size_t Length) = 0;
 
+	/// <summary>
+	/// Add additional data in the callers memory to the message authentication code generator.  
+	/// <para>Must be called after Initialize(bool, ISymmetricKey), and before any processing of plaintext or ciphertext input. 
+	/// This function can only be called once per each initialization/finalization cycle.</para>
+	/// </summary>
+	/// 
+	/// <param name="Input">A pointer to the bytes to process</param>
+	/// <param name="Length">The number of bytes to process</param>
+	///
+	/// <exception cref="CryptoCipherModeException">Thrown if state has been processed</exception>
+	virtual void SetAssociatedData(const uint8_t* Input, size_t Length) = 0;
+
 	/// <summary>
 	/// Transform a length of bytes with offset parameters. 
 	/// <para>This method processes a specified length of bytes, utilizing offsets incremented by the caller.
@@ -200,6 +213,44 @@ public:
 	/// <param name="OutOffset">Starting offset within the output vector</param>
 	/// <param name="Length">The number of bytes to transform</param>
 	virtual void Transform(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length) = 0;
+
+	/// <summary>
+	/// Transform a length of bytes in the callers memory. 
+	/// <para>The pointer form of Transform, for buffers that are not held in a vector, such as pooled, mapped or scatter-gather memory.
+	/// Encryption writes the MAC tag after the cipher-text, so Output must have room for Length + TagSize() bytes; decryption reads the tag following the Length bytes of cipher-text.
+	/// Input and Output may be the same address for an in-place transform, but must not otherwise overlap.
+	/// Initialize(bool, ISymmetricKey) must be called before this method can be used.</para>
+	/// </summary>
+	/// 
+	/// <param name="Input">A pointer to the bytes to transform</param>
+	/// <param name="Output">A pointer to the transformed bytes</param>
+	/// <param name="Length">The number of message bytes to transform</param>
+	///
+	/// <exception cref="CryptoAuthenticationFailure">Thrown during decryption if the authentication tag does not match</exception>
+	virtual void Transform(const uint8_t* Input, uint8_t* Output, size_t Length) = 0;
+
+	/// <summary>
+	/// Start an asynchronous Encrypt/Decrypt of a vector of bytes with offset and length parameters, and return its completion handle.
+	/// <para>Initialize(bool, ISymmetricKey) must be called before this method can be used. 
+	/// The transform runs on the parallel runtime and the function returns immediately; see TransformHandle for the lifetime and cancellation rules. 
+	/// The message and its tag are processed in a single call, so the transform can only be cancelled before it starts.</para>
+	/// </summary>
+	/// 
+	/// <param name="Input">The input vector of bytes to transform</param>
+	/// <param name="InOffset">The starting offset within the input vector</param>
+	/// <param name="Output">The output vector of transformed bytes</param>
+	/// <param name="OutOffset">The starting offset within the output vector</param>
+	/// <param name="Length">The uint8_t length of data to process</param>
+	/// <param name="Completion">The optional completion callback, called on the worker thread when the handle is ready</param>
+	/// 
+	/// <returns>The transform completion handle</returns>
+	TransformHandle TransformAsync(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length, const std::function<void(TransformHandle &)> &Completion = nullptr)
+	{
+		return TransformHandle::Start(ParallelProfile(), Length, 0, [this, &Input, InOffset, &Output, OutOffset](size_t Offset, size_t Count)
+		{
+			Transform(Input, InOffset + Offset, Output, OutOffset + Offset, Count);
+		}, Completion);
+	}
 };
 
 NAMESPACE_MODEEND
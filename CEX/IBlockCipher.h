@@ -142,6 +142,16 @@ public:
 	/// <param name="OutOffset">Starting offset within the output array</param>
 	virtual void DecryptBlock(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset) = 0;
 
+	/// <summary>
+	/// Decrypt a block of bytes in the callers memory.
+	/// <para><see cref="Initialize(bool, ISymmetricKey)"/> must be called with the Encryption flag set to <c>false</c> before this method can be used.
+	/// Input and Output must point to at least <see cref="BlockSize"/> bytes, and may be the same address.</para>
+	/// </summary>
+	/// 
+	/// <param name="Input">A pointer to the encrypted bytes</param>
+	/// <param name="Output">A pointer to the decrypted bytes</param>
+	virtual void DecryptBlock(const uint8_t* Input, uint8_t* Output) = 0;
+
 	/// <summary>
 	/// Encrypt a block of bytes.
 	/// <para><see cref="Initialize(bool, ISymmetricKey)"/> must be called with the Encryption flag set to <c>true</c> before this method can be used.
@@ -164,6 +174,16 @@ public:
 	/// <param name="OutOffset">Starting offset within the output array</param>
 	virtual void EncryptBlock(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset) = 0;
 
+	/// <summary>
+	/// Encrypt a block of bytes in the callers memory.
+	/// <para><see cref="Initialize(bool, ISymmetricKey)"/> must be called with the Encryption flag set to <c>true</c> before this method can be used.
+	/// Input and Output must point to at least <see cref="BlockSize"/> bytes, and may be the same address.</para>
+	/// </summary>
+	/// 
+	/// <param name="Input">A pointer to the bytes to transform</param>
+	/// <param name="Output">A pointer to the transformed bytes</param>
+	virtual void EncryptBlock(const uint8_t* Input, uint8_t* Output) = 0;
+
 	/// <summary>
 	/// Initialize the cipher
 	/// </summary>
@@ -244,6 +264,20 @@ public:
 	/// <param name="Output">The output array of transformed bytes</param>
 	/// <param name="OutOffset">Starting offset in the output array</param>
 	virtual void Transform2048(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset) = 0;
+
+	/// <summary>
+	/// Transform 16 blocks of bytes, as part of a longer message.
+	/// <para><see cref="Initialize(bool, ISymmetricKey)"/> must be called before this method can be used.
+	/// Input and Output array lengths must be at least 16 * <see cref="BlockSize"/> in length.
+	/// The message length selects the kernel width; the 512-bit kernels are only used when it reaches the wide threshold set in SimdDispatch.</para>
+	/// </summary>
+	/// 
+	/// <param name="Input">The input array of bytes to transform</param>
+	/// <param name="InOffset">Starting offset in the Input array</param>
+	/// <param name="Output">The output array of transformed bytes</param>
+	/// <param name="OutOffset">Starting offset in the output array</param>
+	/// <param name="Length">The number of bytes in the message being transformed by the caller</param>
+	virtual void Transform2048(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length) = 0;
 };
 
 NAMESPACE_BLOCKEND
@@ -1,7 +1,10 @@
 #include "ICM.h"
 #include "BlockCipherFromName.h"
 #include "IntegerTools.h"
+#include "KeystreamCache.h"
+#include "ParallelScratch.h"
 #include "ParallelTools.h"
+#include "SegmentScratch.h"
 
 NAMESPACE_MODE
 
@@ -9,13 +12,19 @@ using Enumeration::BlockCipherConvert;
 using Enumeration::CipherModeConvert;
 using Tools::IntegerTools;
 using Tools::MemoryTools;
+using Tools::ParallelScratch;
 using Tools::ParallelTools;
+using Tools::SegmentScratch;
 
 class ICM::IcmState
 {
 public:
 
 	std::vector<uint8_t> Nonce;
+	std::vector<uint8_t> Origin;
+	ParallelScratch Cached;
+	ParallelScratch Scratch;
+	SegmentScratch Segments;
 	bool Destroyed;
 	bool Encryption;
 	bool Initialized;
@@ -23,6 +32,10 @@ public:
 	IcmState(bool IsDestroyed)
 		:
 		Nonce(BLOCK_SIZE, 0x0ULL),
+		Origin(BLOCK_SIZE, 0x00),
+		Cached(),
+		Scratch(),
+		Segments(),
 		Destroyed(IsDestroyed),
 		Encryption(false),
 		Initialized(false)
@@ -37,6 +50,10 @@ public:
 	void Reset()
 	{
 		MemoryTools::Clear(Nonce, 0, Nonce.size());
+		MemoryTools::Clear(Origin, 0, Origin.size());
+		Cached.Clear();
+		Scratch.Clear();
+		Segments.Clear();
 		Destroyed = false;
 		Encryption = false;
 		Initialized = false;
@@ -51,8 +68,10 @@ ICM::ICM(BlockCiphers CipherType)
 	m_blockCipher(CipherType != BlockCiphers::None ? 
 		Helper::BlockCipherFromName::GetInstance(CipherType) :
 		throw CryptoCipherModeException(CipherModeConvert::ToName(CipherModes::ICM), std::string("Constructor"), std::string("The cipher type can not be none!"), ErrorCodes::InvalidParam)),
-	m_parallelProfile(BLOCK_SIZE, true, m_blockCipher->StateCacheSize(), true)
+	m_parallelProfile(BLOCK_SIZE, true, m_blockCipher->StateCacheSize(), true),
+	m_keystreamCache(nullptr)
 {
+	m_parallelProfile.SetAlgorithm(Name());
 }
 
 ICM::ICM(IBlockCipher* Cipher)
@@ -61,12 +80,20 @@ ICM::ICM(IBlockCipher* Cipher)
 	m_blockCipher(Cipher != nullptr ? 
 		Cipher : 
 		throw CryptoCipherModeException(CipherModeConvert::ToName(CipherModes::ICM), std::string("Constructor"), std::string("The cipher type can not be null!"), ErrorCodes::IllegalOperation)),
-	m_parallelProfile(BLOCK_SIZE, true, m_blockCipher->StateCacheSize(), true)
+	m_parallelProfile(BLOCK_SIZE, true, m_blockCipher->StateCacheSize(), true),
+	m_keystreamCache(nullptr)
 {
+	m_parallelProfile.SetAlgorithm(Name());
 }
 
 ICM::~ICM()
 {
+	// the cache worker reads the cipher, and is stopped first
+	if (m_keystreamCache != nullptr)
+	{
+		m_keystreamCache.reset(nullptr);
+	}
+
 	if (m_icmState->Destroyed)
 	{
 		if (m_blockCipher != nullptr)
@@ -136,6 +163,12 @@ const std::string ICM::Name()
 
 const std::vector<uint8_t> &ICM::Nonce()
 {
+	if (m_keystreamCache != nullptr && IsInitialized())
+	{
+		// short transforms advance the cache position instead of the counter
+		IntegerTools::LeIncrease8(m_icmState->Origin, m_icmState->Nonce, static_cast<uint64_t>(m_keystreamCache->Position() / BLOCK_SIZE));
+	}
+
 	return m_icmState->Nonce;
 }
 
@@ -165,6 +198,13 @@ void ICM::DecryptBlock(const std::vector<uint8_t> &Input, size_t InOffset, std::
 	Encrypt128(Input, InOffset, Output, OutOffset);
 }
 
+void ICM::DecryptBlock(const uint8_t* Input, uint8_t* Output)
+{
+	CEXASSERT(IsInitialized(), "The cipher mode has not been initialized!");
+
+	Encrypt128(Input, Output);
+}
+
 void ICM::EncryptBlock(const std::vector<uint8_t> &Input, std::vector<uint8_t> &Output)
 {
 	CEXASSERT(IsInitialized(), "The cipher mode has not been initialized!");
@@ -179,6 +219,13 @@ void ICM::EncryptBlock(const std::vector<uint8_t> &Input, size_t InOffset, std::
 	Encrypt128(Input, InOffset, Output, OutOffset);
 }
 
+void ICM::EncryptBlock(const uint8_t* Input, uint8_t* Output)
+{
+	CEXASSERT(IsInitialized(), "The cipher mode has not been initialized!");
+
+	Encrypt128(Input, Output);
+}
+
 void ICM::Initialize(bool Encryption, ISymmetricKey &Parameters)
 {
 	if (!SymmetricKeySize::Contains(LegalKeySizes(), Parameters.KeySizes().KeySize()))
@@ -202,10 +249,30 @@ void ICM::Initialize(bool Encryption, ISymmetricKey &Parameters)
 		}
 	}
 
+	if (m_keystreamCache != nullptr)
+	{
+		// the worker must not read the key schedule while it changes
+		m_keystreamCache->Stop();
+	}
+
 	m_blockCipher->Initialize(true, Parameters);
 	MemoryTools::COPY128(Parameters.IV(), 0, m_icmState->Nonce, 0);
+	MemoryTools::COPY128(Parameters.IV(), 0, m_icmState->Origin, 0);
 	m_icmState->Encryption = Encryption;
 	m_icmState->Initialized = true;
+
+	if (m_keystreamCache != nullptr)
+	{
+		m_keystreamCache->Start(0);
+	}
+}
+
+void ICM::Invalidate()
+{
+	if (m_keystreamCache != nullptr && IsInitialized())
+	{
+		m_keystreamCache->Start(m_keystreamCache->Position());
+	}
 }
 
 void ICM::ParallelMaxDegree(size_t Degree)
@@ -218,246 +285,341 @@ void ICM::ParallelMaxDegree(size_t Degree)
 	m_parallelProfile.SetMaxDegree(Degree);
 }
 
+void ICM::Precompute(size_t Capacity)
+{
+	if (Capacity % (4 * BLOCK_SIZE) != 0)
+	{
+		throw CryptoCipherModeException(Name(), std::string("Precompute"), std::string("The capacity must be a multiple of four blocks!"), ErrorCodes::InvalidSize);
+	}
+
+	if (m_keystreamCache != nullptr)
+	{
+		if (IsInitialized())
+		{
+			// the counter continues from the last byte taken from the cache
+			IntegerTools::LeIncrease8(m_icmState->Origin, m_icmState->Nonce, static_cast<uint64_t>(m_keystreamCache->Position() / BLOCK_SIZE));
+		}
+
+		m_keystreamCache.reset(nullptr);
+	}
+
+	if (Capacity != 0)
+	{
+		// the worker and an underrun on the calling thread each own a counter and buffer, allocated once here
+		m_icmState->Cached.Reserve(KeystreamCache::LANE_COUNT, BLOCK_SIZE, SCRATCH_SIZE);
+		m_keystreamCache.reset(new KeystreamCache(BLOCK_SIZE, Capacity, [this](uint64_t Position, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length, size_t Lane)
+		{
+			this->Keystream(Position, Output, OutOffset, Length, Lane);
+		}));
+
+		if (IsInitialized())
+		{
+			m_keystreamCache->Start(StreamPosition());
+		}
+	}
+}
+
+void ICM::Seek(uint64_t Position)
+{
+	if (IsInitialized() == false)
+	{
+		throw CryptoCipherModeException(Name(), std::string("Seek"), std::string("The cipher mode has not been initialized!"), ErrorCodes::NotInitialized);
+	}
+	if (Position % BLOCK_SIZE != 0)
+	{
+		throw CryptoCipherModeException(Name(), std::string("Seek"), std::string("The position must be aligned to the block size!"), ErrorCodes::InvalidParam);
+	}
+
+	// the counter is the initial vector increased by the block index
+	IntegerTools::LeIncrease8(m_icmState->Origin, m_icmState->Nonce, static_cast<uint64_t>(Position / BLOCK_SIZE));
+
+	if (m_keystreamCache != nullptr)
+	{
+		m_keystreamCache->Reset(Position);
+	}
+}
+
 void ICM::Transform(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length)
 {
 	CEXASSERT(IsInitialized(), "The cipher mode has not been initialized!");
 	CEXASSERT(IntegerTools::Min(Input.size() - InOffset, Output.size() - OutOffset) >= Length, "The data arrays are smaller than the length!");
 
-	size_t i;
+	Process(Input.data(), InOffset, Output, OutOffset, Length);
+}
 
-	const size_t PRLBLK = m_parallelProfile.ParallelBlockSize();
+void ICM::Transform(const uint8_t* Input, uint8_t* Output, size_t Length)
+{
+	CEXASSERT(IsInitialized(), "The cipher mode has not been initialized!");
 
-	if (m_parallelProfile.IsParallel() && Length >= PRLBLK)
+	if (m_keystreamCache != nullptr && IsInitialized() && Length <= m_keystreamCache->Capacity())
 	{
-		const size_t BLKCNT = Length / PRLBLK;
-
-		for (i = 0; i < BLKCNT; ++i)
+		// short messages are combined with the precomputed key-stream directly
+		m_keystreamCache->Transform(Input, Output, Length);
+	}
+	else
+	{
+		// the key-stream is generated in segments, and combined with the callers memory in a single pass
+		m_icmState->Segments.Keystream(Input, Output, Length, m_parallelProfile.ParallelBlockSize(), [this](std::vector<uint8_t> &Target, size_t Count)
 		{
-			ProcessParallel(Input, InOffset + (i * PRLBLK), Output, OutOffset + (i * PRLBLK), PRLBLK);
-		}
+			Process(nullptr, 0, Target, 0, Count);
+		});
+	}
+}
 
-		const size_t RMDLEN = Length - (PRLBLK * BLKCNT);
+void ICM::TransformAt(uint64_t Position, const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length)
+{
+	CEXASSERT(IntegerTools::Min(Input.size() - InOffset, Output.size() - OutOffset) >= Length, "The data arrays are smaller than the length!");
 
-		if (RMDLEN != 0)
+	const size_t HDRLEN = static_cast<size_t>(Position % BLOCK_SIZE);
+	size_t i;
+	size_t prclen;
+
+	Seek(Position - HDRLEN);
+
+	if (HDRLEN != 0 && Length != 0)
+	{
+		// the position is inside a block; use the tail of that blocks key-stream
+		std::vector<uint8_t> otp(BLOCK_SIZE);
+		prclen = IntegerTools::Min(BLOCK_SIZE - HDRLEN, Length);
+		m_blockCipher->EncryptBlock(m_icmState->Nonce, 0, otp, 0);
+		// continue at the next block; this also moves the precompute cache
+		Seek(Position - HDRLEN + BLOCK_SIZE);
+
+		for (i = 0; i < prclen; ++i)
 		{
-			const size_t BLKOFT = (PRLBLK * BLKCNT);
-			ProcessSequential(Input, InOffset + BLKOFT, Output, OutOffset + BLKOFT, RMDLEN);
+			Output[OutOffset + i] = Input[InOffset + i] ^ otp[HDRLEN + i];
 		}
+
+		MemoryTools::Clear(otp, 0, otp.size());
+		InOffset += prclen;
+		OutOffset += prclen;
+		Length -= prclen;
 	}
-	else
+
+	if (Length != 0)
 	{
-		ProcessSequential(Input, InOffset, Output, OutOffset, Length);
+		Transform(Input, InOffset, Output, OutOffset, Length);
 	}
 }
 
 //~~~Private Functions~~~//
 
+void ICM::Encrypt128(const uint8_t* Input, uint8_t* Output)
+{
+	std::array<uint8_t, BLOCK_SIZE> otp;
+
+	m_blockCipher->EncryptBlock(m_icmState->Nonce.data(), otp.data());
+	IntegerTools::LeIncrement(m_icmState->Nonce);
+
+	if (Input != Output)
+	{
+		MemoryTools::CopyRaw(Input, Output, BLOCK_SIZE);
+	}
+
+	MemoryTools::XorRaw(otp.data(), Output, BLOCK_SIZE);
+	MemoryTools::Clear(otp, 0, otp.size());
+}
+
 void ICM::Encrypt128(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset)
 {
 	CEXASSERT(IsInitialized(), "The cipher mode has not been initialized!");
 	CEXASSERT(IntegerTools::Min(Input.size() - InOffset, Output.size() - OutOffset) >= BLOCK_SIZE, "The data arrays are smaller than the block-size!");
 
-	std::vector<uint8_t> tmpc(BLOCK_SIZE);
-	MemoryTools::COPY128(m_icmState->Nonce, 0, tmpc, 0);
-	m_blockCipher->EncryptBlock(tmpc, 0, Output, OutOffset);
+	m_blockCipher->EncryptBlock(m_icmState->Nonce, 0, Output, OutOffset);
 	IntegerTools::LeIncrement(m_icmState->Nonce);
 	MemoryTools::XOR128(Input, InOffset, Output, OutOffset);
 }
 
-void ICM::Generate(std::vector<uint8_t> &Output, size_t OutOffset, size_t Length, std::vector<uint8_t> &Counter)
+void ICM::Generate(std::vector<uint8_t> &Output, size_t OutOffset, size_t Length, std::vector<uint8_t> &Counter, std::vector<uint8_t> &Buffer)
 {
 	size_t bctr;
 
 	bctr = 0;
 
-#if defined(CEX_HAS_AVX512)
-	const size_t AVX512BLK = 16 * BLOCK_SIZE;
-	if (Length >= AVX512BLK)
+	const size_t WIDBLK = 16 * BLOCK_SIZE;
+	if (Length >= WIDBLK)
 	{
-		const size_t PBKALN = Length - (Length % AVX512BLK);
-		std::vector<uint8_t> cblk(AVX512BLK);
+		const size_t PBKALN = Length - (Length % WIDBLK);
 
-		// stagger counters and process 8 blocks with avx
+		// stagger counters and process 16 blocks; the cipher selects its widest kernel at run-time
 		while (bctr != PBKALN)
 		{
-
-			MemoryTools::COPY128(Counter, 0, cblk, 0);
+			MemoryTools::COPY128(Counter, 0, Buffer, 0);
 			IntegerTools::LeIncrement(Counter);
-			MemoryTools::COPY128(Counter, 0, cblk, 16);
+			MemoryTools::COPY128(Counter, 0, Buffer, 16);
 			IntegerTools::LeIncrement(Counter);
-			MemoryTools::COPY128(Counter, 0, cblk, 32);
+			MemoryTools::COPY128(Counter, 0, Buffer, 32);
 			IntegerTools::LeIncrement(Counter);
-			MemoryTools::COPY128(Counter, 0, cblk, 48);
+			MemoryTools::COPY128(Counter, 0, Buffer, 48);
 			IntegerTools::LeIncrement(Counter);
-			MemoryTools::COPY128(Counter, 0, cblk, 64);
+			MemoryTools::COPY128(Counter, 0, Buffer, 64);
 			IntegerTools::LeIncrement(Counter);
-			MemoryTools::COPY128(Counter, 0, cblk, 80);
+			MemoryTools::COPY128(Counter, 0, Buffer, 80);
 			IntegerTools::LeIncrement(Counter);
-			MemoryTools::COPY128(Counter, 0, cblk, 96);
+			MemoryTools::COPY128(Counter, 0, Buffer, 96);
 			IntegerTools::LeIncrement(Counter);
-			MemoryTools::COPY128(Counter, 0, cblk, 112);
+			MemoryTools::COPY128(Counter, 0, Buffer, 112);
 			IntegerTools::LeIncrement(Counter);
-			MemoryTools::COPY128(Counter, 0, cblk, 128);
+			MemoryTools::COPY128(Counter, 0, Buffer, 128);
 			IntegerTools::LeIncrement(Counter);
-			MemoryTools::COPY128(Counter, 0, cblk, 144);
+			MemoryTools::COPY128(Counter, 0, Buffer, 144);
 			IntegerTools::LeIncrement(Counter);
-			MemoryTools::COPY128(Counter, 0, cblk, 160);
+			MemoryTools::COPY128(Counter, 0, Buffer, 160);
 			IntegerTools::LeIncrement(Counter);
-			MemoryTools::COPY128(Counter, 0, cblk, 176);
+			MemoryTools::COPY128(Counter, 0, Buffer, 176);
 			IntegerTools::LeIncrement(Counter);
-			MemoryTools::COPY128(Counter, 0, cblk, 192);
+			MemoryTools::COPY128(Counter, 0, Buffer, 192);
 			IntegerTools::LeIncrement(Counter);
-			MemoryTools::COPY128(Counter, 0, cblk, 208);
+			MemoryTools::COPY128(Counter, 0, Buffer, 208);
 			IntegerTools::LeIncrement(Counter);
-			MemoryTools::COPY128(Counter, 0, cblk, 224);
+			MemoryTools::COPY128(Counter, 0, Buffer, 224);
 			IntegerTools::LeIncrement(Counter);
-			MemoryTools::COPY128(Counter, 0, cblk, 240);
+			MemoryTools::COPY128(Counter, 0, Buffer, 240);
 			IntegerTools::LeIncrement(Counter);
-			m_blockCipher->Transform2048(cblk, 0, Output, OutOffset + bctr);
-			bctr += AVX512BLK;
+			m_blockCipher->Transform2048(Buffer, 0, Output, OutOffset + bctr, Length);
+			bctr += WIDBLK;
 		}
 	}
-#elif defined(CEX_HAS_AVX2)
-	const size_t AVX2BLK = 8 * BLOCK_SIZE;
-	if (Length >= AVX2BLK)
-	{
-		const size_t PBKALN = Length - (Length % AVX2BLK);
-		std::vector<uint8_t> cblk(AVX2BLK);
-
-		// stagger counters and process 8 blocks with avx
-		while (bctr != PBKALN)
-		{
-			MemoryTools::COPY128(Counter, 0, cblk, 0);
-			IntegerTools::LeIncrement(Counter);
-			MemoryTools::COPY128(Counter, 0, cblk, 16);
-			IntegerTools::LeIncrement(Counter);
-			MemoryTools::COPY128(Counter, 0, cblk, 32);
-			IntegerTools::LeIncrement(Counter);
-			MemoryTools::COPY128(Counter, 0, cblk, 48);
-			IntegerTools::LeIncrement(Counter);
-			MemoryTools::COPY128(Counter, 0, cblk, 64);
-			IntegerTools::LeIncrement(Counter);
-			MemoryTools::COPY128(Counter, 0, cblk, 80);
-			IntegerTools::LeIncrement(Counter);
-			MemoryTools::COPY128(Counter, 0, cblk, 96);
-			IntegerTools::LeIncrement(Counter);
-			MemoryTools::COPY128(Counter, 0, cblk, 112);
-			IntegerTools::LeIncrement(Counter);
-			m_blockCipher->Transform1024(cblk, 0, Output, OutOffset + bctr);
-			bctr += AVX2BLK;
-		}
-	}
-#elif defined(CEX_HAS_AVX)
-	const size_t AVXBLK = 4 * BLOCK_SIZE;
-	if (Length >= AVXBLK)
-	{
-		const size_t PBKALN = Length - (Length % AVXBLK);
-		std::vector<uint8_t> cblk(AVXBLK);
-
-		// 4 blocks with sse
-		while (bctr != PBKALN)
-		{
-			MemoryTools::COPY128(Counter, 0, cblk, 0);
-			IntegerTools::LeIncrement(Counter);
-			MemoryTools::COPY128(Counter, 0, cblk, 16);
-			IntegerTools::LeIncrement(Counter);
-			MemoryTools::COPY128(Counter, 0, cblk, 32);
-			IntegerTools::LeIncrement(Counter);
-			MemoryTools::COPY128(Counter, 0, cblk, 48);
-			IntegerTools::LeIncrement(Counter);
-			m_blockCipher->Transform512(cblk, 0, Output, OutOffset + bctr);
-			bctr += AVXBLK;
-		}
-	}
-#endif
 
 	const size_t ALNBLK = Length - (Length % BLOCK_SIZE);
-	std::vector<uint8_t> tmpc(BLOCK_SIZE);
 
 	while (bctr != ALNBLK)
 	{
-		MemoryTools::COPY128(Counter, 0, tmpc, 0);
-		m_blockCipher->EncryptBlock(tmpc, 0, Output, OutOffset + bctr);
+		m_blockCipher->EncryptBlock(Counter, 0, Output, OutOffset + bctr);
 		IntegerTools::LeIncrement(Counter);
 		bctr += BLOCK_SIZE;
 	}
 
 	if (bctr != Length)
 	{
-		std::vector<uint8_t> tmpr(BLOCK_SIZE);
-		MemoryTools::COPY128(Counter, 0, tmpc, 0);
-		m_blockCipher->EncryptBlock(tmpc, 0, tmpr, 0);
+		m_blockCipher->EncryptBlock(Counter, 0, Buffer, 0);
 		const size_t FNLLEN = Length % BLOCK_SIZE;
-		MemoryTools::Copy(tmpr, 0, Output, OutOffset + (Length - FNLLEN), FNLLEN);
+		MemoryTools::Copy(Buffer, 0, Output, OutOffset + (Length - FNLLEN), FNLLEN);
 		IntegerTools::LeIncrement(Counter);
 	}
 }
 
-void ICM::ProcessParallel(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length)
+void ICM::Keystream(uint64_t Position, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length, size_t Lane)
+{
+	// the lanes can run concurrently; each uses its own counter and buffer, and the block-cipher is only read
+	std::vector<uint8_t> &ctr = m_icmState->Cached.Counter(Lane);
+
+	IntegerTools::LeIncrease8(m_icmState->Origin, ctr, static_cast<uint64_t>(Position / BLOCK_SIZE));
+	Generate(Output, OutOffset, Length, ctr, m_icmState->Cached.Buffer(Lane));
+}
+
+void ICM::Process(const uint8_t* Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length)
+{
+	// a null input writes the bare key-stream, which the pointer transform combines with the callers memory
+	const bool PRECMP = m_keystreamCache != nullptr && IsInitialized();
+	size_t i;
+
+	if (PRECMP && Length <= m_keystreamCache->Capacity())
+	{
+		// short messages are an xor with the precomputed key-stream
+		m_keystreamCache->Transform((Input != nullptr) ? Input + InOffset : nullptr, Output.data() + OutOffset, Length);
+	}
+	else
+	{
+		if (PRECMP)
+		{
+			// long messages are processed directly, and the cache continues after the last block
+			const uint64_t STMPOS = m_keystreamCache->Position();
+			const uint64_t BLKCNT = static_cast<uint64_t>((Length + BLOCK_SIZE - 1) / BLOCK_SIZE);
+			IntegerTools::LeIncrease8(m_icmState->Origin, m_icmState->Nonce, STMPOS / BLOCK_SIZE);
+			m_keystreamCache->Reset(STMPOS + (BLKCNT * BLOCK_SIZE));
+		}
+
+		const size_t PRLBLK = m_parallelProfile.ParallelBlockSize();
+
+		if (m_parallelProfile.IsParallel() && Length >= PRLBLK)
+		{
+			const size_t BLKCNT = Length / PRLBLK;
+
+			for (i = 0; i < BLKCNT; ++i)
+			{
+				ProcessParallel(Input, InOffset + (i * PRLBLK), Output, OutOffset + (i * PRLBLK), PRLBLK);
+			}
+
+			const size_t RMDLEN = Length - (PRLBLK * BLKCNT);
+
+			if (RMDLEN != 0)
+			{
+				const size_t BLKOFT = (PRLBLK * BLKCNT);
+				ProcessSequential(Input, InOffset + BLKOFT, Output, OutOffset + BLKOFT, RMDLEN);
+			}
+		}
+		else
+		{
+			ProcessSequential(Input, InOffset, Output, OutOffset, Length);
+		}
+	}
+}
+
+void ICM::ProcessParallel(const uint8_t* Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length)
 {
 	const size_t OUTLEN = Output.size() - OutOffset < Length ? Output.size() - OutOffset : Length;
-	const size_t CNKLEN = m_parallelProfile.ParallelBlockSize() / m_parallelProfile.ParallelMaxDegree();
+	const size_t SEGCNT = m_parallelProfile.ParallelSegmentCount();
+	const size_t CNKLEN = m_parallelProfile.ParallelBlockSize() / SEGCNT;
 	const size_t CTRLEN = (CNKLEN / BLOCK_SIZE);
-	std::vector<uint8_t> tmpc(m_icmState->Nonce.size());
 
-	ParallelTools::ParallelFor(0, m_parallelProfile.ParallelMaxDegree(), [this, &Input, InOffset, &Output, OutOffset, &tmpc, CNKLEN, CTRLEN](size_t i)
+	// the per-worker counters are kept by the instance, and are allocated only on first use
+	m_icmState->Scratch.Reserve(SEGCNT, BLOCK_SIZE, SCRATCH_SIZE);
+
+	ParallelTools::ParallelFor(m_parallelProfile, Output.data() + OutOffset, 0, SEGCNT, [this, Input, InOffset, &Output, OutOffset, CNKLEN, CTRLEN](size_t i)
 	{
 		// thread level counter
-		std::vector<uint8_t> thdc(BLOCK_SIZE, 0);
+		std::vector<uint8_t> &thdc = m_icmState->Scratch.Counter(i);
 		// offset counter by chunk size / block size  
 		IntegerTools::LeIncrease8(m_icmState->Nonce, thdc, CTRLEN * i);
 		const size_t STMPOS = i * CNKLEN;
 		// generate random at output array offset
-		this->Generate(Output, OutOffset + STMPOS, CNKLEN, thdc);
-		// xor with input at offsets
-		MemoryTools::XOR(Input, InOffset + STMPOS, Output, OutOffset + STMPOS, CNKLEN);
+		this->Generate(Output, OutOffset + STMPOS, CNKLEN, thdc, m_icmState->Scratch.Buffer(i));
 
-		// store last counter
-		if (i == m_parallelProfile.ParallelMaxDegree() - 1)
+		// xor with input at offsets
+		if (Input != nullptr)
 		{
-			MemoryTools::COPY128(thdc, 0, tmpc, 0);
+			MemoryTools::XorRaw(Input + InOffset + STMPOS, Output.data() + OutOffset + STMPOS, CNKLEN);
 		}
 	});
 
 	// copy last counter to class variable
-	MemoryTools::COPY128(tmpc, 0, m_icmState->Nonce, 0);
+	MemoryTools::COPY128(m_icmState->Scratch.Counter(SEGCNT - 1), 0, m_icmState->Nonce, 0);
 
 	// last block processing
-	const size_t ALNLEN = CNKLEN * m_parallelProfile.ParallelMaxDegree();
+	const size_t ALNLEN = CNKLEN * SEGCNT;
 	if (ALNLEN < OUTLEN)
 	{
-		const size_t FNLLEN = (Output.size() - OutOffset) % ALNLEN;
-		Generate(Output, ALNLEN, FNLLEN, m_icmState->Nonce);
+		const size_t FNLLEN = OUTLEN - ALNLEN;
+		InOffset += ALNLEN;
+		OutOffset += ALNLEN;
 
-		for (size_t i = ALNLEN; i < OUTLEN; i++)
+		Generate(Output, OutOffset, FNLLEN, m_icmState->Nonce, m_icmState->Scratch.Buffer(0));
+
+		if (Input != nullptr)
 		{
-			Output[i] ^= Input[i];
+			MemoryTools::XorRaw(Input + InOffset, Output.data() + OutOffset, FNLLEN);
 		}
 	}
 }
 
-void ICM::ProcessSequential(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length)
+void ICM::ProcessSequential(const uint8_t* Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length)
 {
-	size_t i;
-
+	m_icmState->Scratch.Reserve(1, BLOCK_SIZE, SCRATCH_SIZE);
 	// generate random
-	Generate(Output, OutOffset, Length, m_icmState->Nonce);
-	// get block aligned
-	size_t ALNLEN = Length - (Length % m_blockCipher->BlockSize());
+	Generate(Output, OutOffset, Length, m_icmState->Nonce, m_icmState->Scratch.Buffer(0));
 
-	if (ALNLEN != 0)
+	// output is input xor random
+	if (Input != nullptr && Length != 0)
 	{
-		MemoryTools::XOR(Input, InOffset, Output, OutOffset, ALNLEN);
+		MemoryTools::XorRaw(Input + InOffset, Output.data() + OutOffset, Length);
 	}
+}
 
-	// get the remaining bytes
-	if (ALNLEN != Length)
-	{
-		for (i = ALNLEN; i < Length; ++i)
-		{
-			Output[i + OutOffset] ^= Input[i + InOffset];
-		}
-	}
+uint64_t ICM::StreamPosition()
+{
+	// the low 64 bits of the counter difference is the block index
+	return (IntegerTools::LeBytesTo64(m_icmState->Nonce, 0) - IntegerTools::LeBytesTo64(m_icmState->Origin, 0)) * BLOCK_SIZE;
 }
 
 NAMESPACE_MODEEND
@@ -30,9 +30,12 @@
 #define CEX_ICM_H
 
 #include "ICipherMode.h"
+#include "KeystreamCache.h"
 
 NAMESPACE_MODE
 
+using Tools::KeystreamCache;
+
 /// <summary>
 /// ICM: An implementation of a Little-Endian Integer Counter Mode
 /// </summary> 
@@ -93,6 +96,7 @@ NAMESPACE_MODE
 /// <item><description>The ParallelThreadsMax() property is used as the thread count in the parallel loop; this must be an even number no greater than the number of processer cores on the system.</description></item>
 /// <item><description>ParallelBlockSize() is calculated automatically based on the processor(s) L1 data cache size, this property can be user defined, and must be evenly divisible by ParallelMinimumSize().</description></item>
 /// <item><description>The ParallelBlockSize(), IsParallel(), and ParallelThreadsMax() accessors, can be changed through the ParallelProfile() property; parallel processing can be disabled by setting IsParallel() to false in the ParallelProfile() accessor.</description></item>
+/// <item><description>Precompute(size_t) starts a worker thread that generates key-stream ahead of use; a transform no longer than the cache is then an XOR with the cached key-stream, which removes the cipher from the latency of short messages.</description></item>
 /// </list>
 /// 
 /// <description>Guiding Publications:</description>
@@ -107,11 +111,14 @@ class ICM final : public ICipherMode
 private:
 
 	static const size_t BLOCK_SIZE = 16;
+	// the widest counter block; 16 blocks with AVX2 and AVX512
+	static const size_t SCRATCH_SIZE = 16 * BLOCK_SIZE;
 
 	class IcmState;
 	std::unique_ptr<IcmState> m_icmState;
 	std::unique_ptr<IBlockCipher> m_blockCipher;
 	ParallelOptions m_parallelProfile;
+	std::unique_ptr<KeystreamCache> m_keystreamCache;
 
 public:
 
@@ -244,6 +251,16 @@ public:
 	/// <param name="OutOffset">Starting offset within the output vector</param>
 	void DecryptBlock(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset) override;
 
+	/// <summary>
+	/// Decrypt a block of bytes in the callers memory.
+	/// <para>Decrypts one block of bytes without copying it to a vector; Input and Output may be the same address.
+	/// Initialize(bool, ISymmetricKey) must be called before this method can be used.</para>
+	/// </summary>
+	/// 
+	/// <param name="Input">A pointer to the block of cipher-text bytes</param>
+	/// <param name="Output">A pointer to the block of plain-text bytes</param>
+	void DecryptBlock(const uint8_t* Input, uint8_t* Output) override;
+
 	/// <summary>
 	/// Encrypt a single block of bytes. 
 	/// <para>Encrypts one block of bytes beginning at a zero index.
@@ -266,6 +283,16 @@ public:
 	/// <param name="OutOffset">Starting offset within the output vector</param>
 	void EncryptBlock(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset) override;
 
+	/// <summary>
+	/// Encrypt a block of bytes in the callers memory.
+	/// <para>Encrypts one block of bytes without copying it to a vector; Input and Output may be the same address.
+	/// Initialize(bool, ISymmetricKey) must be called before this method can be used.</para>
+	/// </summary>
+	/// 
+	/// <param name="Input">A pointer to the block of plain-text bytes</param>
+	/// <param name="Output">A pointer to the block of cipher-text bytes</param>
+	void EncryptBlock(const uint8_t* Input, uint8_t* Output) override;
+
 	/// <summary>
 	/// Initialize the cipher-mode instance
 	/// </summary>
@@ -276,6 +303,13 @@ public:
 	/// <exception cref="CryptoCipherModeException">Thrown if an invalid key or nonce is used</exception>
 	void Initialize(bool Encryption, ISymmetricKey &Parameters) override;
 
+	/// <summary>
+	/// Discard the precomputed key-stream, and restart the background generation at the current position.
+	/// <para>Initialize(bool, ISymmetricKey) invalidates the cache automatically; call this after changing the key of the underlying block-cipher instance directly.
+	/// Has no effect if precomputation is not enabled.</para>
+	/// </summary>
+	void Invalidate();
+
 	/// <summary>
 	/// Set the maximum number of threads allocated when using multi-threaded processing.
 	/// <para>When set to zero, thread count is set automatically. If set to 1, sets IsParallel() to false and runs in sequential mode. 
@@ -287,6 +321,29 @@ public:
 	/// <exception cref="CryptoCipherModeException">Thrown if the degree parameter is invalid</exception>
 	void ParallelMaxDegree(size_t Degree) override;
 
+	/// <summary>
+	/// Enable or disable background key-stream precomputation.
+	/// <para>A worker thread fills a ring of Capacity bytes with the key-stream that follows the current position, and refills it as it is consumed.
+	/// A Transform call no longer than the capacity XORs the message with the cached key-stream; a longer message is processed directly, and the cache resumes after it.
+	/// The output is identical to the output without the cache. Rekeying, Seek, and TransformAt reposition the cache; a capacity of zero stops the worker and releases the cache.</para>
+	/// </summary>
+	///
+	/// <param name="Capacity">The cache size in bytes; a multiple of four blocks, or zero to disable precomputation</param>
+	/// 
+	/// <exception cref="CryptoCipherModeException">Thrown if the capacity is not a multiple of four blocks</exception>
+	void Precompute(size_t Capacity);
+
+	/// <summary>
+	/// Set the key-stream position to a byte offset from the start of the stream.
+	/// <para>The counter is set to the initialization vector plus the block index of the position, and the next Transform call starts there.
+	/// The position must be a multiple of the block size; use TransformAt to start within a block.</para>
+	/// </summary>
+	///
+	/// <param name="Position">The byte offset from the start of the key-stream</param>
+	/// 
+	/// <exception cref="CryptoCipherModeException">Thrown if the mode is not initialized, or the position is not block aligned</exception>
+	void Seek(uint64_t Position);
+
 	/// <summary>
 	/// Transform a length of bytes with offset parameters. 
 	/// <para>This method processes a specified length of bytes, utilizing offsets incremented by the caller.
@@ -302,12 +359,46 @@ public:
 	/// <param name="Length">The number of bytes to transform</param>
 	void Transform(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length) override;
 
+	/// <summary>
+	/// Transform a length of bytes in the callers memory. 
+	/// <para>The pointer form of Transform, for buffers that are not held in a vector, such as pooled, mapped or scatter-gather memory.
+	/// The key-stream is generated in segments of ParallelBlockSize() by the vector transform, including its parallel and precomputed paths, and is xored directly into Output;
+	/// Input and Output may be the same address for an in-place transform, but must not otherwise overlap.
+	/// Initialize(bool, ISymmetricKey) must be called before this method can be used.</para>
+	/// </summary>
+	/// 
+	/// <param name="Input">A pointer to the bytes to transform</param>
+	/// <param name="Output">A pointer to the transformed bytes</param>
+	/// <param name="Length">The number of bytes to transform</param>
+	void Transform(const uint8_t* Input, uint8_t* Output, size_t Length) override;
+
+	/// <summary>
+	/// Transform a length of bytes starting at an absolute key-stream position.
+	/// <para>The counter is set directly from the position, so a window of a large message can be decrypted without generating the key-stream before it,
+	/// and separate instances initialized with the same key and nonce can transform disjoint ranges of one stream.
+	/// The position can be any byte offset; a leading partial block is taken from the block containing the position.</para>
+	/// </summary>
+	/// 
+	/// <param name="Position">The byte offset of the first input byte within the key-stream</param>
+	/// <param name="Input">The input vector of bytes to transform</param>
+	/// <param name="InOffset">Starting offset within the input vector</param>
+	/// <param name="Output">The output vector of transformed bytes</param>
+	/// <param name="OutOffset">Starting offset within the output vector</param>
+	/// <param name="Length">The number of bytes to transform</param>
+	/// 
+	/// <exception cref="CryptoCipherModeException">Thrown if the mode is not initialized</exception>
+	void TransformAt(uint64_t Position, const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length);
+
 private:
 
+	void Encrypt128(const uint8_t* Input, uint8_t* Output);
 	void Encrypt128(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset);
-	void Generate(std::vector<uint8_t> &Output, size_t OutOffset, size_t Length, std::vector<uint8_t> &Counter);
-	void ProcessParallel(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length);
-	void ProcessSequential(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length);
+	void Generate(std::vector<uint8_t> &Output, size_t OutOffset, size_t Length, std::vector<uint8_t> &Counter, std::vector<uint8_t> &Buffer);
+	void Keystream(uint64_t Position, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length, size_t Lane);
+	void Process(const uint8_t* Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length);
+	void ProcessParallel(const uint8_t* Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length);
+	void ProcessSequential(const uint8_t* Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length);
+	uint64_t StreamPosition();
 };
 
 NAMESPACE_MODEEND
@@ -27,6 +27,7 @@
 #include "IBlockCipher.h"
 #include "ParallelOptions.h"
 #include "SymmetricKeySize.h"
+#include "TransformHandle.h"
 
 NAMESPACE_MODE
 
@@ -160,6 +161,16 @@ public:
 	/// <param name="OutOffset">Starting offset within the output vector</param>
 	virtual void DecryptBlock(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset) = 0;
 
+	/// <summary>
+	/// Decrypt a block of bytes in the callers memory.
+	/// <para>Decrypts one block of bytes without copying it to a vector; Input and Output may be the same address.
+	/// Initialize(bool, ISymmetricKey) must be called before this method can be used.</para>
+	/// </summary>
+	/// 
+	/// <param name="Input">A pointer to the block of cipher-text bytes</param>
+	/// <param name="Output">A pointer to the block of plain-text bytes</param>
+	virtual void DecryptBlock(const uint8_t* Input, uint8_t* Output) = 0;
+
 	/// <summary>
 	/// Encrypt a single block of bytes. 
 	/// <para>Encrypts one block of bytes beginning at a zero index.
@@ -182,6 +193,16 @@ public:
 	/// <param name="OutOffset">Starting offset within the output vector</param>
 	virtual void EncryptBlock(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset) = 0;
 
+	/// <summary>
+	/// Encrypt a block of bytes in the callers memory.
+	/// <para>Encrypts one block of bytes without copying it to a vector; Input and Output may be the same address.
+	/// Initialize(bool, ISymmetricKey) must be called before this method can be used.</para>
+	/// </summary>
+	/// 
+	/// <param name="Input">A pointer to the block of plain-text bytes</param>
+	/// <param name="Output">A pointer to the block of cipher-text bytes</param>
+	virtual void EncryptBlock(const uint8_t* Input, uint8_t* Output) = 0;
+
 	/// <summary>
 	/// Initialize the Cipher instance
 	/// </summary>
@@ -217,6 +238,41 @@ public:
 	/// <param name="OutOffset">Starting offset within the output vector</param>
 	/// <param name="Length">The number of bytes to transform</param>
 	virtual void Transform(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length) = 0;
+
+	/// <summary>
+	/// Transform a length of bytes in the callers memory. 
+	/// <para>The pointer form of Transform, for buffers that are not held in a vector, such as pooled, mapped or scatter-gather memory.
+	/// The message is processed in segments of ParallelBlockSize() and is never copied in full; Input and Output may be the same address for an in-place transform, but must not otherwise overlap.
+	/// Initialize(bool, ISymmetricKey) must be called before this method can be used.</para>
+	/// </summary>
+	/// 
+	/// <param name="Input">A pointer to the bytes to transform</param>
+	/// <param name="Output">A pointer to the transformed bytes</param>
+	/// <param name="Length">The number of bytes to transform</param>
+	virtual void Transform(const uint8_t* Input, uint8_t* Output, size_t Length) = 0;
+
+	/// <summary>
+	/// Start an asynchronous Encrypt/Decrypt of a vector of bytes with offset and length parameters, and return its completion handle.
+	/// <para>Initialize(bool, ISymmetricKey) must be called before this method can be used. 
+	/// The transform runs on the parallel runtime and the function returns immediately; see TransformHandle for the lifetime and cancellation rules. 
+	/// The input is processed in ParallelBlockSize() chunks, and the transform can be cancelled between chunks; the output is the same as a single Transform call.</para>
+	/// </summary>
+	/// 
+	/// <param name="Input">The input vector of bytes to transform</param>
+	/// <param name="InOffset">The starting offset within the input vector</param>
+	/// <param name="Output">The output vector of transformed bytes</param>
+	/// <param name="OutOffset">The starting offset within the output vector</param>
+	/// <param name="Length">The uint8_t length of data to process</param>
+	/// <param name="Completion">The optional completion callback, called on the worker thread when the handle is ready</param>
+	/// 
+	/// <returns>The transform completion handle</returns>
+	TransformHandle TransformAsync(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length, const std::function<void(TransformHandle &)> &Completion = nullptr)
+	{
+		return TransformHandle::Start(ParallelProfile(), Length, ParallelBlockSize(), [this, &Input, InOffset, &Output, OutOffset](size_t Offset, size_t Count)
+		{
+			Transform(Input, InOffset + Offset, Output, OutOffset + Offset, Count);
+		}, Completion);
+	}
 };
 
 NAMESPACE_MODEEND
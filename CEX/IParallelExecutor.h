@@ -0,0 +1,107 @@
+// The GPL version 3 License (GPLv3)
+//
+// Copyright (c) 2023 QSCS.ca
+// This file is part of the CEX Cryptographic library.
+//
+// This program is free software : you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef CEX_IPARALLELEXECUTOR_H
+#define CEX_IPARALLELEXECUTOR_H
+
+#include "CexDomain.h"
+#include <functional>
+
+NAMESPACE_ROOT
+
+/// <summary>
+/// The parallel executor virtual interface class.
+/// <para>Implement this interface to run the library's multi-threaded cipher and digest loops on a host application's own thread pool.
+/// An executor can be installed process-wide with ParallelTools::SetExecutor(IParallelExecutor*), or on a single algorithm instance through ParallelOptions::SetExecutor(IParallelExecutor*).
+/// The library does not take ownership of an installed executor; it must outlive every algorithm that uses it.</para>
+/// </summary>
+///
+/// <example>
+/// <description>Running a CTR instance on a host thread pool:</description>
+/// <code>
+/// HostExecutor exec(hostPool);	// implements IParallelExecutor
+/// CTR cipher(BlockCiphers::AES);
+/// cipher.ParallelProfile().SetExecutor(&amp;exec);
+/// cipher.Initialize(true, kp);
+/// cipher.Transform(Input, 0, Output, 0, Input.size());
+/// </code>
+/// </example>
+class IParallelExecutor
+{
+public:
+
+	//~~~Constructor~~~//
+
+	/// <summary>
+	/// Copy constructor: copy is restricted, this function has been deleted
+	/// </summary>
+	IParallelExecutor(const IParallelExecutor&) = delete;
+
+	/// <summary>
+	/// Copy operator: copy is restricted, this function has been deleted
+	/// </summary>
+	IParallelExecutor& operator=(const IParallelExecutor&) = delete;
+
+	/// <summary>
+	/// Initialize the IParallelExecutor virtual interface class
+	/// </summary>
+	IParallelExecutor()
+	{
+	}
+
+	/// <summary>
+	/// Destructor: finalize this class
+	/// </summary>
+	virtual ~IParallelExecutor() noexcept
+	{
+	}
+
+	//~~~Accessors~~~//
+
+	/// <summary>
+	/// Read Only: The number of threads the executor can run concurrently
+	/// </summary>
+	virtual const size_t Concurrency() = 0;
+
+	//~~~Public Functions~~~//
+
+	/// <summary>
+	/// Run a loop function over the range [From, To), and block until every iteration has completed.
+	/// <para>The iterations are independent and may run in any order, on any thread; an exception thrown by an iteration must be re-thrown to the caller.</para>
+	/// </summary>
+	///
+	/// <param name="From">The inclusive starting position</param>
+	/// <param name="To">The exclusive ending position</param>
+	/// <param name="F">The loop function delegate</param>
+	virtual void BulkRun(size_t From, size_t To, const std::function<void(size_t)> &F) = 0;
+
+	/// <summary>
+	/// Queue a function for asynchronous execution and return immediately
+	/// </summary>
+	///
+	/// <param name="F">The function delegate</param>
+	virtual void Submit(const std::function<void()> &F) = 0;
+
+	/// <summary>
+	/// Block until every function queued with Submit(std::function) has completed
+	/// </summary>
+	virtual void Wait() = 0;
+};
+
+NAMESPACE_ROOTEND
+#endif
@@ -31,6 +31,7 @@
 #include "StreamCiphers.h"
 #include "SymmetricKey.h"
 #include "SymmetricKeySize.h"
+#include "TransformHandle.h"
 
 NAMESPACE_STREAM
 
@@ -179,6 +180,18 @@ public:
 	/// <exception cref="CryptoSymmetricException">Thrown if an invalid degree setting is used</exception>
 	virtual void ParallelMaxDegree(size_t Degree) = 0;
 
+	/// <summary>
+	/// Set the key-stream position to a byte offset from the start of the stream.
+	/// <para>The position is measured from the nonce the cipher was initialized with, and the next Transform call starts at that position.
+	/// The position must be a multiple of the cipher block size; use TransformAt to start within a block.
+	/// Not available in authentication mode, where the MAC covers the stream in order.</para>
+	/// </summary>
+	/// 
+	/// <param name="Position">The byte offset from the start of the key-stream</param>
+	///
+	/// <exception cref="CryptoSymmetricException">Thrown if the cipher is not initialized, authentication is enabled, or the position is not block aligned</exception>
+	virtual void Seek(uint64_t Position) = 0;
+
 	/// <summary>
 	/// Add additional data to the message authentication code generator.  
 	/// <para>Must be called after Initialize(bool, ISymmetricKey), and can then be called before or after a stream segment has been processed.</para>
@@ -191,6 +204,17 @@ public:
 	/// <exception cref="CryptoSymmetricException">Thrown if state has been processed</exception>
 	virtual void SetAssociatedData(const std::vector<uint8_t> &Input, size_t Offset, size_t Length) = 0;
 
+	/// <summary>
+	/// Add additional data in the callers memory to the message authentication code generator.  
+	/// <para>Must be called after Initialize(bool, ISymmetricKey), and can then be called before or after a stream segment has been processed.</para>
+	/// </summary>
+	/// 
+	/// <param name="Input">A pointer to the bytes to process</param>
+	/// <param name="Length">The number of bytes to process</param>
+	///
+	/// <exception cref="CryptoSymmetricException">Thrown if state has been processed</exception>
+	virtual void SetAssociatedData(const uint8_t* Input, size_t Length) = 0;
+
 	/// <summary>
 	/// Encrypt/Decrypt a vector of bytes with offset and length parameters.
 	/// <para>Initialize(bool, ISymmetricKey) must be called before this method can be used.</para>
@@ -202,6 +226,64 @@ public:
 	/// <param name="OutOffset">The starting offset within the output vector</param>
 	/// <param name="Length">The uint8_t length of data to process</param>
 	virtual void Transform(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length) = 0;
+
+	/// <summary>
+	/// Encrypt/Decrypt a length of bytes in the callers memory.
+	/// <para>The pointer form of Transform, for buffers that are not held in a vector, such as pooled, mapped or scatter-gather memory.
+	/// The key-stream is generated in segments and xored into Output, so an in-place transform writes each message byte once; Input and Output must not otherwise overlap.
+	/// In authentication mode, encryption writes the MAC tag after the cipher-text, so Output must have room for Length + TagSize() bytes; decryption reads the tag following the Length bytes of cipher-text.
+	/// Initialize(bool, ISymmetricKey) must be called before this method can be used.</para>
+	/// </summary>
+	/// 
+	/// <param name="Input">A pointer to the bytes to transform</param>
+	/// <param name="Output">A pointer to the transformed bytes</param>
+	/// <param name="Length">The number of message bytes to transform</param>
+	///
+	/// <exception cref="CryptoAuthenticationFailure">Thrown during decryption if the authentication tag does not match</exception>
+	virtual void Transform(const uint8_t* Input, uint8_t* Output, size_t Length) = 0;
+
+	/// <summary>
+	/// Encrypt/Decrypt a vector of bytes starting at an absolute key-stream position.
+	/// <para>The counter is set directly from the position, so a range can be decrypted without generating the key-stream before it, 
+	/// and separate instances initialized with the same key and nonce can transform disjoint ranges of one stream.
+	/// The position can be any byte offset; a leading partial block is taken from the block containing the position.
+	/// Not available in authentication mode.</para>
+	/// </summary>
+	/// 
+	/// <param name="Position">The byte offset of the first input byte within the key-stream</param>
+	/// <param name="Input">The input vector of bytes to transform</param>
+	/// <param name="InOffset">The starting offset within the input vector</param>
+	/// <param name="Output">The output vector of transformed bytes</param>
+	/// <param name="OutOffset">The starting offset within the output vector</param>
+	/// <param name="Length">The uint8_t length of data to process</param>
+	///
+	/// <exception cref="CryptoSymmetricException">Thrown if the cipher is not initialized, or authentication is enabled</exception>
+	virtual void TransformAt(uint64_t Position, const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length) = 0;
+
+	/// <summary>
+	/// Start an asynchronous Encrypt/Decrypt of a vector of bytes with offset and length parameters, and return its completion handle.
+	/// <para>Initialize(bool, ISymmetricKey) must be called before this method can be used. 
+	/// The transform runs on the parallel runtime and the function returns immediately; see TransformHandle for the lifetime and cancellation rules. 
+	/// Without an authenticator the input is processed in ParallelBlockSize() chunks, and the transform can be cancelled between chunks; 
+	/// with an authenticator the message and its tag are processed in a single call.</para>
+	/// </summary>
+	/// 
+	/// <param name="Input">The input vector of bytes to transform</param>
+	/// <param name="InOffset">The starting offset within the input vector</param>
+	/// <param name="Output">The output vector of transformed bytes</param>
+	/// <param name="OutOffset">The starting offset within the output vector</param>
+	/// <param name="Length">The uint8_t length of data to process</param>
+	/// <param name="Completion">The optional completion callback, called on the worker thread when the handle is ready</param>
+	/// 
+	/// <returns>The transform completion handle</returns>
+	TransformHandle TransformAsync(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length, const std::function<void(TransformHandle &)> &Completion = nullptr)
+	{
+		// an authenticated message is processed in one call, so the tag covers all of it
+		return TransformHandle::Start(ParallelProfile(), Length, IsAuthenticator() ? 0 : ParallelBlockSize(), [this, &Input, InOffset, &Output, OutOffset](size_t Offset, size_t Count)
+		{
+			Transform(Input, InOffset + Offset, Output, OutOffset + Offset, Count);
+		}, Completion);
+	}
 };
 
 NAMESPACE_STREAMEND
@@ -1022,7 +1022,7 @@ public:
 			odst = Output[lctr];
 			osrc = ((MAXPOS - lctr) < cinc.size()) ? cinc[MAXPOS - lctr] : 0x00;
 			ndst = odst + osrc + carry;
-			carry = ndst < odst ? 1 : 0;
+			carry = (ndst < odst || (ndst == odst && osrc != 0)) ? 1 : 0;
 			Output[lctr] = ndst;
 		}
 	}
@@ -1071,7 +1071,7 @@ public:
 			odst = Output[lctr];
 			osrc = ((MAXPOS - lctr) < cinc.size()) ? cinc[MAXPOS - lctr] : 0x00;
 			ndst = static_cast<uint8_t>(odst + osrc + carry);
-			carry = ndst < odst ? 1 : 0;
+			carry = (ndst < odst || (ndst == odst && osrc != 0)) ? 1 : 0;
 			Output[lctr] = ndst;
 		}
 	}
@@ -1119,7 +1119,7 @@ public:
 			odst = Output[lctr];
 			osrc = ((MAXPOS - lctr) < cinc.size()) ? cinc[MAXPOS - lctr] : 0x00;
 			ndst = static_cast<uint8_t>(odst + osrc + carry);
-			carry = ndst < odst ? 1 : 0;
+			carry = (ndst < odst || (ndst == odst && osrc != 0)) ? 1 : 0;
 			Output[lctr] = ndst;
 		}
 	}
@@ -1168,7 +1168,7 @@ public:
 			odst = Output[lctr];
 			osrc = ((MAXPOS - lctr) < cinc.size()) ? cinc[MAXPOS - lctr] : 0x00;
 			ndst = static_cast<uint8_t>(odst + osrc + carry);
-			carry = ndst < odst ? 1 : 0;
+			carry = (ndst < odst || (ndst == odst && osrc != 0)) ? 1 : 0;
 			Output[lctr] = ndst;
 		}
 	}
@@ -1960,7 +1960,7 @@ public:
 			odst = Output[lctr];
 			osrc = (lctr < cinc.size() ? cinc[lctr] : 0x00);
 			ndst = static_cast<uint8_t>(odst + osrc + carry);
-			carry = ndst < odst ? 1 : 0;
+			carry = (ndst < odst || (ndst == odst && osrc != 0)) ? 1 : 0;
 			Output[lctr] = ndst;
 			++lctr;
 		}
@@ -2008,7 +2008,7 @@ public:
 			odst = Output[lctr];
 			osrc = (lctr < cinc.size() ? cinc[lctr] : 0x00);
 			ndst = static_cast<uint8_t>(odst + osrc + carry);
-			carry = ndst < odst ? 1 : 0;
+			carry = (ndst < odst || (ndst == odst && osrc != 0)) ? 1 : 0;
 			Output[lctr] = ndst;
 			++lctr;
 		}
@@ -2054,7 +2054,7 @@ public:
 			odst = Output[lctr];
 			osrc = ((lctr - OutOffset < cinc.size()) ? cinc[lctr - OutOffset] : 0x00);
 			ndst = odst + osrc + carry;
-			carry = ndst < odst ? 1 : 0;
+			carry = (ndst < odst || (ndst == odst && osrc != 0)) ? 1 : 0;
 			Output[lctr] = ndst;
 			++lctr;
 		}
@@ -2101,7 +2101,7 @@ public:
 			odst = Output[lctr];
 			osrc = ((lctr - OutOffset < cinc.size()) ? cinc[lctr - OutOffset] : 0x00);
 			ndst = odst + osrc + carry;
-			carry = ndst < odst ? 1 : 0;
+			carry = (ndst < odst || (ndst == odst && osrc != 0)) ? 1 : 0;
 			Output[lctr] = ndst;
 			++lctr;
 		}
@@ -2283,6 +2283,30 @@ public:
 		return static_cast<bool>(delta == 0);
 	}
 
+	/// <summary>
+	/// Constant time: value comparison between two byte arrays
+	/// </summary>
+	///
+	/// <param name="A">The first byte array to compare</param>
+	/// <param name="B">The second byte array to compare</param>
+	/// <param name="Length">The number of bytes to compare</param>
+	///
+	/// <returns>True if arrays are equivalant</returns>
+	inline static bool CompareRaw(const uint8_t* A, const uint8_t* B, size_t Length)
+	{
+		uint8_t delta;
+		size_t i;
+
+		delta = 0;
+
+		for (i = 0; i < Length; ++i)
+		{
+			delta |= (A[i] ^ B[i]);
+		}
+
+		return static_cast<bool>(delta == 0);
+	}
+
 	/// <summary>
 	/// Constant time: conditional bit copy
 	/// </summary>
@@ -228,15 +228,21 @@ void KMAC::Reset()
 
 void KMAC::Update(const std::vector<uint8_t> &Input, size_t InOffset, size_t Length)
 {
-	if (IsInitialized() == false)
-	{
-		throw CryptoMacException(Name(), std::string("Update"), std::string("The MAC has not been initialized!"), ErrorCodes::NotInitialized);
-	}
 	if ((Input.size() - InOffset) < Length)
 	{
 		throw CryptoMacException(Name(), std::string("Update"), std::string("The Input buffer is too int16_t!"), ErrorCodes::InvalidSize);
 	}
 
+	Update(Input.data() + InOffset, Length);
+}
+
+void KMAC::Update(const uint8_t* Input, size_t Length)
+{
+	if (IsInitialized() == false)
+	{
+		throw CryptoMacException(Name(), std::string("Update"), std::string("The MAC has not been initialized!"), ErrorCodes::NotInitialized);
+	}
+
 	if (Length != 0)
 	{
 		// update partially filled block
@@ -245,29 +251,29 @@ void KMAC::Update(const std::vector<uint8_t> &Input, size_t InOffset, size_t Len
 			const size_t RMDLEN = m_kmacState->Rate - m_kmacState->Position;
 			if (RMDLEN != 0)
 			{
-				MemoryTools::Copy(Input, InOffset, m_kmacState->Buffer, m_kmacState->Position, RMDLEN);
+				MemoryTools::CopyRaw(Input, m_kmacState->Buffer.data() + m_kmacState->Position, RMDLEN);
 			}
 
 			Keccak::FastAbsorb(m_kmacState->Buffer, 0, m_kmacState->Rate, m_kmacState->State);
 			Permute(m_kmacState);
 			m_kmacState->Position = 0;
-			InOffset += RMDLEN;
+			Input += RMDLEN;
 			Length -= RMDLEN;
 		}
 
 		// sequential loop through remaining blocks
 		while (Length >= m_kmacState->Rate)
 		{
-			Keccak::FastAbsorb(Input, InOffset, m_kmacState->Rate, m_kmacState->State);
+			Keccak::FastAbsorbRaw(Input, m_kmacState->Rate, m_kmacState->State);
 			Permute(m_kmacState);
-			InOffset += m_kmacState->Rate;
+			Input += m_kmacState->Rate;
 			Length -= m_kmacState->Rate;
 		}
 
 		// store unaligned bytes
 		if (Length != 0)
 		{
-			MemoryTools::Copy(Input, InOffset, m_kmacState->Buffer, m_kmacState->Position, Length);
+			MemoryTools::CopyRaw(Input, m_kmacState->Buffer.data() + m_kmacState->Position, Length);
 			m_kmacState->Position += Length;
 		}
 	}
@@ -198,6 +198,17 @@ public:
 	/// <exception cref="CryptoMacException">Thrown if the mac is not initialized or the input array is too small</exception>
 	void Update(const std::vector<uint8_t> &Input, size_t InOffset, size_t Length) override;
 
+	/// <summary>
+	/// Update the Mac with a length of bytes read directly from caller memory.
+	/// <para>The pointer core behind Update(Input, InOffset, Length); the caller is responsible for the bounds of the input.</para>
+	/// </summary>
+	/// 
+	/// <param name="Input">A pointer to the first input byte</param>
+	/// <param name="Length">The length of data to process in bytes</param>
+	/// 
+	/// <exception cref="CryptoMacException">Thrown if the mac is not initialized</exception>
+	void Update(const uint8_t* Input, size_t Length);
+
 private:
 
 	static void LoadKey(const SecureVector<uint8_t> &Key, std::unique_ptr<KmacState> &State);
@@ -1,12 +1,9 @@
 #include "KPA.h"
 #include "IntegerTools.h"
 #include "Keccak.h"
+#include "KeccakKernels.h"
 #include "MemoryTools.h"
-#if defined(CEX_HAS_AVX512)
-#	include "ULong512.h"
-#elif defined(CEX_HAS_AVX2)
-#	include "ULong256.h"
-#endif
+#include "SimdDispatch.h"
 
 NAMESPACE_MAC
 
@@ -15,23 +12,18 @@ using Digest::Keccak;
 using Enumeration::MacConvert;
 using Tools::MemoryTools;
 using Enumeration::KbaModeConvert;
-#if defined(CEX_HAS_AVX512)
-	using Numeric::ULong512;
-#elif defined(CEX_HAS_AVX2)
-	using Numeric::ULong256;
-#endif
+using Enumeration::SimdProfiles;
+using Digest::KeccakKernels;
+using Tools::SimdDispatch;
 
 class KPA::KpaState
 {
 public:
 
-#if defined(CEX_HAS_AVX512)
-	std::array<ULong512, Keccak::KECCAK_STATE_SIZE> StateW;
-#elif defined(CEX_HAS_AVX2)
-	std::vector<std::array<ULong256, Keccak::KECCAK_STATE_SIZE>> StateW;
-#endif
+	std::array<uint64_t, KPA_PARALLELISM * Keccak::KECCAK_STATE_SIZE> StateW;
 	std::vector<std::array<uint64_t, Keccak::KECCAK_STATE_SIZE>> State;
 	std::vector<uint8_t> Buffer;
+	size_t Lanes;
 	size_t Rate;
 	size_t MacSize;
 	size_t Position;
@@ -41,11 +33,10 @@ public:
 
 	KpaState(size_t InputSize, size_t OutputSize, KpaModes Mode)
 		:
-#if defined(CEX_HAS_AVX2)  && !defined(CEX_HAS_AVX512)
-		StateW(2),
-#endif
+		StateW{ 0 },
 		State(8),
 		Buffer(KPA_PARALLELISM * Keccak::KECCAK_STATE_SIZE * sizeof(uint64_t)),
+		Lanes(0),
 		Rate(InputSize),
 		MacSize(OutputSize),
 		Position(0),
@@ -62,13 +53,9 @@ public:
 		Position = 0;
 		Processed = 0;
 		KmacMode = KpaModes::None;
+		Lanes = 0;
 
-#if defined(CEX_HAS_AVX512)
-		MemoryTools::Clear(StateW, 0, StateW.size() * sizeof(ULong512));
-#elif defined(CEX_HAS_AVX2)
-		MemoryTools::Clear(StateW[0], 0, StateW[0].size() * sizeof(ULong256));
-		MemoryTools::Clear(StateW[1], 0, StateW[1].size() * sizeof(ULong256));
-#endif
+		MemoryTools::Clear(StateW, 0, StateW.size() * sizeof(uint64_t));
 
 		for (size_t i = 0; i < State.size(); ++i)
 		{
@@ -83,12 +70,7 @@ public:
 		Position = 0;
 		Processed = 0;
 
-#if defined(CEX_HAS_AVX512)
-		MemoryTools::Clear(StateW, 0, StateW.size() * sizeof(ULong512));
-#elif defined(CEX_HAS_AVX2)
-		MemoryTools::Clear(StateW[0], 0, StateW[0].size() * sizeof(ULong256));
-		MemoryTools::Clear(StateW[1], 0, StateW[1].size() * sizeof(ULong256));
-#endif
+		MemoryTools::Clear(StateW, 0, StateW.size() * sizeof(uint64_t));
 
 		for (size_t i = 0; i < State.size(); ++i)
 		{
@@ -97,6 +79,12 @@ public:
 
 		MemoryTools::Clear(Buffer, 0, Buffer.size());
 	}
+
+	// the word Index of leaf Leaf in the interleaved state; each group of Lanes leaves is stored as one wide kernel state
+	uint64_t &Word(size_t Leaf, size_t Index)
+	{
+		return StateW[((Leaf / Lanes) * Keccak::KECCAK_STATE_SIZE * Lanes) + (Index * Lanes) + (Leaf % Lanes)];
+	}
 };
 
 //~~~Constructor~~~//
@@ -216,9 +204,10 @@ KPA::KPA(KpaModes KbaModeType)
 		// set processed counter to final position
 		m_kbaState->Processed += m_kbaState->Position;
 
-#if defined(CEX_KPA_AVX_PARALLEL)
-		KpaStoreState(m_kbaState);
-#endif
+		if (m_kbaState->Lanes != 0)
+		{
+			KpaStoreState(m_kbaState);
+		}
 
 		// collect leaf node hashes
 		for (i = 0; i < KPA_PARALLELISM; ++i)
@@ -385,67 +374,28 @@ KPA::KPA(KpaModes KbaModeType)
 
 		// stage 3: copy state to leaf nodes, and add leaf-unique name string
 
-
-#if defined(CEX_HAS_AVX512)
-
-		std::vector<uint64_t> tmpi(8);
-
-		for (i = 1; i < Keccak::KECCAK_STATE_SIZE; ++i)
-		{
-			m_kbaState->StateW[i] = ULong512(tmps[i]);
-		}
-
-		for (i = 0; i < KPA_PARALLELISM; ++i)
-		{
-			// store the state index to the algorithm name
-			IntegerTools::Be16ToBytes((static_cast<uint16_t>(i) + 1), algb, 0);
-			// copy the name to a 64-bit integer
-			algn = IntegerTools::BeBytesTo64(algb, 0);
-			// absorb the leafs unique index name
-			tmpi[i] = tmps[0] ^ algn;
-		}
-
-		m_kbaState->StateW[0] = ULong512(tmpi, 0);
-
-#elif defined(CEX_HAS_AVX2)
-
-		std::vector<uint64_t> tmpi(8);
-
-		for (i = 1; i < Keccak::KECCAK_STATE_SIZE; ++i)
-		{
-			m_kbaState->StateW[0][i] = ULong256(tmps[i]);
-			m_kbaState->StateW[1][i] = ULong256(tmps[i]);
-		}
-
 		for (i = 0; i < KPA_PARALLELISM; ++i)
 		{
 			// store the state index to the algorithm name
 			IntegerTools::Be16ToBytes((static_cast<uint16_t>(i) + 1), algb, 0);
 			// copy the name to a 64-bit integer
 			algn = IntegerTools::BeBytesTo64(algb, 0);
+			// copy the state to each leaf node
+			MemoryTools::Copy(tmps, 0, m_kbaState->State[i], 0, sizeof(tmps));
 			// absorb the leafs unique index name
-			tmpi[i] = tmps[0] ^ algn;
+			m_kbaState->State[i][0] ^= algn;
 		}
 
-		m_kbaState->StateW[0][0] = ULong256(tmpi, 0);
-		m_kbaState->StateW[1][0] = ULong256(tmpi, 4);
+		// the leaves are permuted together by the widest Keccak kernel the host supports, or one at a time
+		const SimdProfiles SMDPRF = SimdDispatch::Instance().Select(KeccakKernels::Compiled());
 
-#else
+		m_kbaState->Lanes = (SMDPRF == SimdProfiles::Simd512) ? 8 : (SMDPRF == SimdProfiles::Simd256) ? 4 : 0;
 
-		for (i = 0; i < KPA_PARALLELISM; ++i)
+		if (m_kbaState->Lanes != 0)
 		{
-			// store the state index to the algorithm name
-			IntegerTools::Be16ToBytes((static_cast<uint16_t>(i) + 1), algb, 0);
-			// copy the name to a 64-bit integer
-			algn = IntegerTools::BeBytesTo64(algb, 0);
-			// copy the state to each leaf node
-			MemoryTools::Copy(tmps, 0, m_kbaState->State[i], 0, sizeof(tmps));
-			// absorb the leafs unique index name
-			m_kbaState->State[i][0] ^= algn;
+			KpaLoadState(m_kbaState);
 		}
 
-#endif
-
 		// permute leaf nodes
 		KpaPermutex8(m_kbaState);
 		m_kbaState->IsInitialized = true;
@@ -514,64 +464,30 @@ KPA::KPA(KpaModes KbaModeType)
 	{
 		size_t i;
 
-#if defined(CEX_HAS_AVX512)
-
-		const size_t ROFT = Ctx->Rate;
-		__m512i idx;
-		ULong512 wbuf;
-		size_t pos;
-
-		idx = _mm512_set_epi64((int64_t)&Input[InOffset + (7 * ROFT)], (int64_t)&Input[InOffset + (6 * ROFT)], 
-			(int64_t)&Input[InOffset + (5 * ROFT)], (int64_t)&Input[InOffset + (4 * ROFT)], 
-			(int64_t)&Input[InOffset + (3 * ROFT)], (int64_t)&Input[InOffset + (2 * ROFT)], 
-			(int64_t)&Input[InOffset + (ROFT)], (int64_t)&Input[InOffset]);
-
-		pos = 0;
-
-		for (i = 0; i < Ctx->Rate / sizeof(uint64_t); ++i)
+		if (Ctx->Lanes != 0)
 		{
-			wbuf = ULong512(_mm512_i64gather_epi64(idx, (int64_t*)pos, 1));
-			pos += sizeof(uint64_t);
-			Ctx->StateW[i] ^= wbuf;
-		}
-
-#elif defined(CEX_HAS_AVX2)
-
-		const size_t ROFT = Ctx->Rate;
-		std::vector<uint64_t> tmp(4);
-
-		for (i = 0; i < Ctx->Rate / sizeof(uint64_t); ++i)
-		{
-			tmp[0] = IntegerTools::LeBytesTo64(Input, InOffset);
-			tmp[1] = IntegerTools::LeBytesTo64(Input, InOffset + ROFT);
-			tmp[2] = IntegerTools::LeBytesTo64(Input, InOffset + (2 * ROFT));
-			tmp[3] = IntegerTools::LeBytesTo64(Input, InOffset + (3 * ROFT));
-			ULong256 x1(tmp, 0);
-			Ctx->StateW[0][i] ^= x1;
-
-			tmp[0] = IntegerTools::LeBytesTo64(Input, InOffset + (4 * ROFT));
-			tmp[1] = IntegerTools::LeBytesTo64(Input, InOffset + (5 * ROFT));
-			tmp[2] = IntegerTools::LeBytesTo64(Input, InOffset + (6 * ROFT));
-			tmp[3] = IntegerTools::LeBytesTo64(Input, InOffset + (7 * ROFT));
-			ULong256 x2(tmp, 0);
-			Ctx->StateW[1][i] ^= x2;
-			InOffset += sizeof(uint64_t);
+			for (i = 0; i < KPA_PARALLELISM; ++i)
+			{
+				for (size_t j = 0; j < Ctx->Rate / sizeof(uint64_t); ++j)
+				{
+					Ctx->Word(i, j) ^= IntegerTools::LeBytesTo64(Input, InOffset + (i * Ctx->Rate) + (j * sizeof(uint64_t)));
+				}
+			}
 		}
-
-#else
-
-		for (i = 0; i < KPA_PARALLELISM; ++i)
+		else
 		{
+			for (i = 0; i < KPA_PARALLELISM; ++i)
+			{
 #if defined(CEX_IS_LITTLE_ENDIAN)
-			MemoryTools::XOR(Input, InOffset + (i * Ctx->Rate), Ctx->State[i], 0, Ctx->Rate);
+				MemoryTools::XOR(Input, InOffset + (i * Ctx->Rate), Ctx->State[i], 0, Ctx->Rate);
 #else
-			for (size_t j = 0; j < Ctx->Rate / sizeof(uint64_t); ++j)
-			{
-				Ctx->State[i][j] ^= IntegerTools::LeBytesTo64(Input, InOffset + (i * Ctx->Rate) + (j * sizeof(uint64_t)));
-			}
+				for (size_t j = 0; j < Ctx->Rate / sizeof(uint64_t); ++j)
+				{
+					Ctx->State[i][j] ^= IntegerTools::LeBytesTo64(Input, InOffset + (i * Ctx->Rate) + (j * sizeof(uint64_t)));
+				}
 #endif
+			}
 		}
-#endif
 	}
 
 	void KPA::KpaAbsorbLeaves(std::vector<uint64_t> &State, size_t Rate, const std::vector<uint8_t> &Input, size_t InOffset, size_t Length)
@@ -608,55 +524,33 @@ KPA::KPA(KpaModes KbaModeType)
 
 	void KPA::KpaLoadState(std::unique_ptr<KpaState> &Ctx)
 	{
-#if defined(CEX_HAS_AVX512)
-
-		__m512i idx;
-		size_t pos;
-
-		idx = _mm512_set_epi64((int64_t)&Ctx->State[7][0], (int64_t)&Ctx->State[6][0], (int64_t)&Ctx->State[5][0], (int64_t)&Ctx->State[4][0],
-			(int64_t)&Ctx->State[3][0], (int64_t)&Ctx->State[2][0], (int64_t)&Ctx->State[1][0], (int64_t)&Ctx->State[0][0]);
-
-		pos = 0;
-
-		for (size_t i = 0; i < Keccak::KECCAK_STATE_SIZE; ++i)
-		{
-			Ctx->StateW[i] = ULong512(_mm512_i64gather_epi64(idx, (int64_t*)pos, 1));
-			pos += sizeof(uint64_t);
-		}
-
-#elif defined(CEX_HAS_AVX2)
-
-		uint64_t tmp[4] = { 0 };
-
-		for (size_t i = 0; i < Keccak::KECCAK_STATE_SIZE; ++i)
+		for (size_t i = 0; i < KPA_PARALLELISM; ++i)
 		{
-			tmp[0] = Ctx->State[0][i];
-			tmp[1] = Ctx->State[1][i];
-			tmp[2] = Ctx->State[2][i];
-			tmp[3] = Ctx->State[3][i];
-			Ctx->StateW[0][i] = ULong256(tmp, 0);
-			tmp[0] = Ctx->State[4][i];
-			tmp[1] = Ctx->State[5][i];
-			tmp[2] = Ctx->State[6][i];
-			tmp[3] = Ctx->State[7][i];
-			Ctx->StateW[1][i] = ULong256(tmp, 4);
+			for (size_t j = 0; j < Keccak::KECCAK_STATE_SIZE; ++j)
+			{
+				Ctx->Word(i, j) = Ctx->State[i][j];
+			}
 		}
-#endif
 	}
 
 	void KPA::KpaPermutex8(std::unique_ptr<KpaState> &Ctx)
 	{
-#if defined(CEX_HAS_AVX512)
-		Keccak::PermuteR24P8x1600H(Ctx->StateW, KPA_ROUNDS);
-#elif defined(CEX_HAS_AVX2)
-		Keccak::PermuteR24P4x1600H(Ctx->StateW[0], KPA_ROUNDS);
-		Keccak::PermuteR24P4x1600H(Ctx->StateW[1], KPA_ROUNDS);
-#else
-		for (size_t i = 0; i < KPA_PARALLELISM; ++i)
+		if (Ctx->Lanes == 8)
 		{
-			Keccak::Permute(Ctx->State[i], Keccak::PermutationRounds::RX12);
+			KeccakKernels::PermuteR24P8x1600H(Ctx->StateW.data(), KPA_ROUNDS);
+		}
+		else if (Ctx->Lanes == 4)
+		{
+			KeccakKernels::PermuteR24P4x1600H(Ctx->StateW.data(), KPA_ROUNDS);
+			KeccakKernels::PermuteR24P4x1600H(Ctx->StateW.data() + (4 * Keccak::KECCAK_STATE_SIZE), KPA_ROUNDS);
+		}
+		else
+		{
+			for (size_t i = 0; i < KPA_PARALLELISM; ++i)
+			{
+				Keccak::Permute(Ctx->State[i], Keccak::PermutationRounds::RX12);
+			}
 		}
-#endif
 	}
 
 	void KPA::KpaSqueezeBlocks(std::vector<uint64_t> &State, std::vector<uint8_t> &Output, size_t BlockCount, size_t Rate)
@@ -684,42 +578,13 @@ KPA::KPA(KpaModes KbaModeType)
 
 	void KPA::KpaStoreState(std::unique_ptr<KpaState> &Ctx)
 	{
-#if defined(CEX_HAS_AVX512)
-
-		std::vector<uint64_t> tmp(8);
-
-		for (size_t i = 0; i < Keccak::KECCAK_STATE_SIZE; ++i)
-		{
-			Ctx->StateW[i].Store(tmp, 0);
-			Ctx->State[0][i] = tmp[0];
-			Ctx->State[1][i] = tmp[1];
-			Ctx->State[2][i] = tmp[2];
-			Ctx->State[3][i] = tmp[3];
-			Ctx->State[4][i] = tmp[4];
-			Ctx->State[5][i] = tmp[5];
-			Ctx->State[6][i] = tmp[6];
-			Ctx->State[7][i] = tmp[7];
-		}
-
-#elif defined(CEX_HAS_AVX2)
-
-		std::vector<uint64_t> tmp(4);
-
-		for (size_t i = 0; i < Keccak::KECCAK_STATE_SIZE; ++i)
+		for (size_t i = 0; i < KPA_PARALLELISM; ++i)
 		{
-			Ctx->StateW[0][i].Store(tmp, 0);
-			Ctx->State[0][i] = tmp[0];
-			Ctx->State[1][i] = tmp[1];
-			Ctx->State[2][i] = tmp[2];
-			Ctx->State[3][i] = tmp[3];
-			Ctx->StateW[1][i].Store(tmp, 0);
-			Ctx->State[4][i] = tmp[0];
-			Ctx->State[5][i] = tmp[1];
-			Ctx->State[6][i] = tmp[2];
-			Ctx->State[7][i] = tmp[3];
+			for (size_t j = 0; j < Keccak::KECCAK_STATE_SIZE; ++j)
+			{
+				Ctx->State[i][j] = Ctx->Word(i, j);
+			}
 		}
-
-#endif
 	}
 
 	NAMESPACE_MACEND
@@ -33,10 +33,6 @@ NAMESPACE_MAC
 
 using Enumeration::KpaModes;
 
-#if defined(CEX_HAS_AVX512) || defined(CEX_HAS_AVX2)
-#	define CEX_KPA_AVX_PARALLEL
-#endif
-
 /// <summary>
 /// An implementation of the Keccak based Message Authentication Code generator: KPA
 /// </summary>
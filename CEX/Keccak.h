@@ -23,23 +23,11 @@
 #include "IntegerTools.h"
 #include "MemoryTools.h"
 
-#if defined(CEX_HAS_AVX512)
-#	include "ULong512.h"
-#elif defined(CEX_HAS_AVX2)
-#	include "ULong256.h"
-#endif
-
 NAMESPACE_DIGEST
 
 using Tools::IntegerTools;
 using Tools::MemoryTools;
 
-#if defined(CEX_HAS_AVX512)
-	using Numeric::ULong512;
-#elif defined(CEX_HAS_AVX2)
-	using Numeric::ULong256;
-#endif
-
 /// <summary>
 /// Internal static class containing the 24 and 48 round Keccak permutation functions.
 /// <para>The function names are in the format; Permute-rounds-bits-suffix, ex. PermuteR24P1600C, 24 rounds, permutes 1600 bits, using the compact form of the function. \n
@@ -49,10 +37,8 @@ using Tools::MemoryTools;
 /// <para>The compact forms of the permutations have the suffix C, and are optimized for low memory consumption 
 /// (enabled in the hash function by adding the CEX_DIGEST_COMPACT to the CexConfig file). \n
 /// The Unrolled forms are optimized for speed and timing neutrality have the U suffix. \n
-/// The H suffix denotes functions that take an SIMD wrapper class as the state values, and process message blocks in SIMD parallel blocks.</para>
-/// <para>This class contains wide forms of the functions; PermuteR24P4x1600H and PermuteR48P4x1600H use AVX2. \n
-/// Experimental functions using AVX512 instructions are also implemented; PermuteR24P8x1600H and PermuteR48P8x1600H. \n
-/// These extended functions are only visible at run-time on some development platforms (VS..), if the __AVX2__ or __AVX512__ compiler flags are declared explicitly.</para>
+/// <para>The wide forms of the permutation, which process four or eight interleaved states with AVX2 or AVX512 instructions, are implemented by the KeccakKernels class, 
+/// each in its own instruction set translation unit, and are selected at run-time.</para>
 /// </summary>
 class Keccak
 {
@@ -471,6 +457,29 @@ public:
 #endif
 	}
 
+	/// <summary>
+	/// The fast absorb function; XOR bytes read directly from caller memory with the state array, no other processing is performed.
+	/// <para>Input length must be 64-bit aligned.</para>
+	/// </summary>
+	/// 
+	/// <param name="Input">A pointer to the first input byte</param>
+	/// <param name="InLength">The number of bytes to process; must be 64-bit aligned</param>
+	/// <param name="State">The permutations uint64 state array</param>
+	template<typename ArrayU64x25>
+	static void FastAbsorbRaw(const uint8_t* Input, size_t InLength, ArrayU64x25 &State)
+	{
+		CEXASSERT(InLength % sizeof(uint64_t) == 0, "The input length is not 64-bit aligned");
+
+#if defined(CEX_IS_LITTLE_ENDIAN)
+		MemoryTools::XorRaw(Input, reinterpret_cast<uint8_t*>(State.data()), InLength);
+#else
+		for (size_t i = 0; i < InLength / sizeof(uint64_t); ++i)
+		{
+			State[i] ^= IntegerTools::LeBytesTo64Raw(Input + (i * sizeof(uint64_t)));
+		}
+#endif
+	}
+
 	/// <summary>
 	/// Finalize the state and generate the output.
 	/// </summary>
@@ -7351,1075 +7360,6 @@ public:
 		State[24] = Asu;
 	}
 
-#if defined(CEX_HAS_AVX512)
-
-#define _mm512_extract_epi64x(b, i) ( \
-        _mm_extract_epi64(_mm512_extracti64x2_epi64(b, i / 2), i % 2))
-
-	template<typename ArrayU512>
-	static void AbsorbR28x1600H(ArrayU512 &State,
-		size_t Rate,
-		const std::vector<uint8_t> &Input0, 
-		const std::vector<uint8_t> &Input1, 
-		const std::vector<uint8_t> &Input2, 
-		const std::vector<uint8_t> &Input3, 
-		const std::vector<uint8_t> &Input4,
-		const std::vector<uint8_t> &Input5,
-		const std::vector<uint8_t> &Input6,
-		const std::vector<uint8_t> &Input7,
-		size_t InputLength, 
-		uint8_t Domain)
-	{
-		__m512i t;
-		__m512i idx;
-		int64_t p0;
-		int64_t p1;
-		int64_t p2;
-		int64_t p3;
-		int64_t p4;
-		int64_t p5;
-		int64_t p6;
-		int64_t p7;
-		size_t i;
-		size_t pos;
-
-		pos = 0;
-		p0 = (int64_t)Input0.data();
-		p1 = (int64_t)Input1.data();
-		p2 = (int64_t)Input2.data();
-		p3 = (int64_t)Input3.data();
-		p4 = (int64_t)Input4.data();
-		p5 = (int64_t)Input5.data();
-		p6 = (int64_t)Input6.data();
-		p7 = (int64_t)Input7.data();
-
-		idx = _mm512_set_epi64(p7, p6, p5, p4, p3, p2, p1, p0);
-
-		while (InputLength >= (size_t)rate)
-		{
-			for (i = 0; i < (size_t)Rate / sizeof(uint64_t); ++i)
-			{
-				t = _mm512_i64gather_epi64(idx, (int64_t*)pos, 1);
-				State[i] = _mm512_xor_si512(State[i], t);
-				pos += sizeof(uint64_t);
-			}
-
-			PermuteR24P8x1600H(State);
-			InputLength -= rate;
-		}
-
-		i = 0;
-
-		while (InputLength >= sizeof(uint64_t))
-		{
-			t = _mm512_i64gather_epi64(idx, (int64_t*)pos, 1);
-			State[i] = _mm512_xor_si512(State[i], t);
-
-			i++;
-			pos += sizeof(uint64_t);
-			InputLength -= sizeof(uint64_t);
-		}
-
-		if (InputLength != 0)
-		{
-			t = _mm512_i64gather_epi64(idx, (int64_t*)pos, 1);
-			idx = _mm512_set1_epi64((1ULL << (sizeof(uint64_t) * InputLength)) - 1);
-			t = _mm512_and_si512(t, idx);
-			State[i] = _mm512_xor_si512(State[i], t);
-		}
-
-		t = _mm512_set1_epi64((int64_t)Domain << (sizeof(uint64_t) * InputLength));
-		State[i] = _mm512_xor_si512(State[i], t);
-		t = _mm512_set1_epi64(1ULL << 63);
-		State[(rate / sizeof(uint64_t)) - 1] = _mm512_xor_si512(State[(rate / sizeof(uint64_t)) - 1], t);
-	}
-
-	template<typename ArrayU512>
-	static void SqueezeBlocksR28x1600H(ArrayU512 &State,
-		size_t Rate,
-		std::vector<uint8_t> &Output0,
-		std::vector<uint8_t> &Output1,
-		std::vector<uint8_t> &Output2,
-		std::vector<uint8_t> &Output3,
-		std::vector<uint8_t> &Output4,
-		std::vector<uint8_t> &Output5,
-		std::vector<uint8_t> &Output6,
-		std::vector<uint8_t> &Output7,
-		size_t Blocks)
-	{
-		__m128i x;
-		uint64_t f0;
-		uint64_t f1;
-		uint64_t f2;
-		uint64_t f3;
-		uint64_t f4;
-		uint64_t f5;
-		uint64_t f6;
-		uint64_t f7;
-		size_t i;
-		size_t idx;
-
-		while (Blocks > 0)
-		{
-			PermuteR24P8x1600H(State);
-			idx = 0
-
-			for (i = 0; i < (size_t)rate / sizeof(uint64_t); ++i)
-			{
-#if defined(CEX_OS_WINDOWS)
-				x = _mm512_extracti64x2_epi64(State[i], 0);
-				f0 = _mm_extract_epi64(x, 0);
-				f0 = (uint64_t)(uint32_t)_mm_extract_epi32(x, 0) | (uint64_t)(uint32_t)_mm_extract_epi32(x, 1) << 32;
-				f1 = _mm_extract_epi64(x, 1);
-				x = _mm512_extracti64x2_epi64(State[i], 1);
-				f2 = _mm_extract_epi64(x, 0);
-				f3 = _mm_extract_epi64(x, 1);
-				x = _mm512_extracti64x2_epi64(State[i], 2);
-				f4 = _mm_extract_epi64(x, 0);
-				f5 = _mm_extract_epi64(x, 1);
-				x = _mm512_extracti64x2_epi64(State[i], 3);
-				f6 = _mm_extract_epi64(x, 0);
-				f7 = _mm_extract_epi64(x, 1);
-#else
-				x = _mm512_extracti64x2_epi64(State[i], 0);
-				f0 = (uint64_t)(uint32_t)_mm_extract_epi32(x, 0) | (uint64_t)(uint32_t)_mm_extract_epi32(x, 1) << 32;
-				f1 = (uint64_t)(uint32_t)_mm_extract_epi32(x, 2) | (uint64_t)(uint32_t)_mm_extract_epi32(x, 3) << 32;
-				x = _mm512_extracti64x2_epi64(State[i], 1);
-				f2 = (uint64_t)(uint32_t)_mm_extract_epi32(x, 0) | (uint64_t)(uint32_t)_mm_extract_epi32(x, 1) << 32;
-				f3 = (uint64_t)(uint32_t)_mm_extract_epi32(x, 2) | (uint64_t)(uint32_t)_mm_extract_epi32(x, 3) << 32;
-				x = _mm512_extracti64x2_epi64(State[i], 2);
-				f4 = (uint64_t)(uint32_t)_mm_extract_epi32(x, 0) | (uint64_t)(uint32_t)_mm_extract_epi32(x, 1) << 32;
-				f5 = (uint64_t)(uint32_t)_mm_extract_epi32(x, 2) | (uint64_t)(uint32_t)_mm_extract_epi32(x, 3) << 32;
-				x = _mm512_extracti64x2_epi64(State[i], 3);
-				f6 = (uint64_t)(uint32_t)_mm_extract_epi32(x, 0) | (uint64_t)(uint32_t)_mm_extract_epi32(x, 1) << 32;
-				f7 = (uint64_t)(uint32_t)_mm_extract_epi32(x, 2) | (uint64_t)(uint32_t)_mm_extract_epi32(x, 3) << 32;
-#endif
-				IntegerTools::Le64ToBytes(f0, Output0, idx);
-				IntegerTools::Le64ToBytes(f1, Output1, idx);
-				IntegerTools::Le64ToBytes(f2, Output2, idx);
-				IntegerTools::Le64ToBytes(f3, Output3, idx);
-				IntegerTools::Le64ToBytes(f4, Output4, idx);
-				IntegerTools::Le64ToBytes(f5, Output5, idx);
-				IntegerTools::Le64ToBytes(f6, Output6, idx);
-				IntegerTools::Le64ToBytes(f7, Output7, idx);
-
-				idx += sizeof(uint64_t);
-			}
-
-			--Blocks;
-		}
-	}
-
-	/// <summary>
-	/// The horizontally vectorized 24 round (standard) form of the SHA3 permutation function.
-	/// <para>This function processes 8*25 blocks of state in parallel using AVX512 instructions.</para>
-	/// </summary>
-	/// 
-	/// <param name="State">The permutations ULong512 state array</param>
-	/// <param name="Rounds">The number of permutations rounds; defaults at 24</param>
-	template<typename ArrayU512>
-	static void PermuteR24P8x1600H(ArrayU512 &State, size_t Rounds = 24)
-	{
-		std::array<ULong512, 25> A;
-		std::array<ULong512, 5> C;
-		std::array<ULong512, 5> D;
-		std::array<ULong512, 25> E;
-		size_t i;
-
-		MemoryTools::Copy(State, 0, A, 0, A.size() * sizeof(ULong512));
-
-		for (i = 0; i < Rounds; i += 2)
-		{
-			// round n
-			C[0] = A[0] ^ A[5] ^ A[10] ^ A[15] ^ A[20];
-			C[1] = A[1] ^ A[6] ^ A[11] ^ A[16] ^ A[21];
-			C[2] = A[2] ^ A[7] ^ A[12] ^ A[17] ^ A[22];
-			C[3] = A[3] ^ A[8] ^ A[13] ^ A[18] ^ A[23];
-			C[4] = A[4] ^ A[9] ^ A[14] ^ A[19] ^ A[24];
-			D[0] = C[4] ^ ULong512::RotL64(C[1], 1);
-			D[1] = C[0] ^ ULong512::RotL64(C[2], 1);
-			D[2] = C[1] ^ ULong512::RotL64(C[3], 1);
-			D[3] = C[2] ^ ULong512::RotL64(C[4], 1);
-			D[4] = C[3] ^ ULong512::RotL64(C[0], 1);
-			A[0] ^= D[0];
-			C[0] = A[0];
-			A[6] ^= D[1];
-			C[1] = ULong512::RotL64(A[6], 44);
-			A[12] ^= D[2];
-			C[2] = ULong512::RotL64(A[12], 43);
-			A[18] ^= D[3];
-			C[3] = ULong512::RotL64(A[18], 21);
-			A[24] ^= D[4];
-			C[4] = ULong512::RotL64(A[24], 14);
-			E[0] = C[0] ^ ((~C[1]) & C[2]);
-			E[0] ^= ULong512(KECCAK_RC24[i]);
-			E[1] = C[1] ^ ((~C[2]) & C[3]);
-			E[2] = C[2] ^ ((~C[3]) & C[4]);
-			E[3] = C[3] ^ ((~C[4]) & C[0]);
-			E[4] = C[4] ^ ((~C[0]) & C[1]);
-			A[3] ^= D[3];
-			C[0] = ULong512::RotL64(A[3], 28);
-			A[9] ^= D[4];
-			C[1] = ULong512::RotL64(A[9], 20);
-			A[10] ^= D[0];
-			C[2] = ULong512::RotL64(A[10], 3);
-			A[16] ^= D[1];
-			C[3] = ULong512::RotL64(A[16], 45);
-			A[22] ^= D[2];
-			C[4] = ULong512::RotL64(A[22], 61);
-			E[5] = C[0] ^ ((~C[1]) & C[2]);
-			E[6] = C[1] ^ ((~C[2]) & C[3]);
-			E[7] = C[2] ^ ((~C[3]) & C[4]);
-			E[8] = C[3] ^ ((~C[4]) & C[0]);
-			E[9] = C[4] ^ ((~C[0]) & C[1]);
-			A[1] ^= D[1];
-			C[0] = ULong512::RotL64(A[1], 1);
-			A[7] ^= D[2];
-			C[1] = ULong512::RotL64(A[7], 6);
-			A[13] ^= D[3];
-			C[2] = ULong512::RotL64(A[13], 25);
-			A[19] ^= D[4];
-			C[3] = ULong512::RotL64(A[19], 8);
-			A[20] ^= D[0];
-			C[4] = ULong512::RotL64(A[20], 18);
-			E[10] = C[0] ^ ((~C[1]) & C[2]);
-			E[11] = C[1] ^ ((~C[2]) & C[3]);
-			E[12] = C[2] ^ ((~C[3]) & C[4]);
-			E[13] = C[3] ^ ((~C[4]) & C[0]);
-			E[14] = C[4] ^ ((~C[0]) & C[1]);
-			A[4] ^= D[4];
-			C[0] = ULong512::RotL64(A[4], 27);
-			A[5] ^= D[0];
-			C[1] = ULong512::RotL64(A[5], 36);
-			A[11] ^= D[1];
-			C[2] = ULong512::RotL64(A[11], 10);
-			A[17] ^= D[2];
-			C[3] = ULong512::RotL64(A[17], 15);
-			A[23] ^= D[3];
-			C[4] = ULong512::RotL64(A[23], 56);
-			E[15] = C[0] ^ ((~C[1]) & C[2]);
-			E[16] = C[1] ^ ((~C[2]) & C[3]);
-			E[17] = C[2] ^ ((~C[3]) & C[4]);
-			E[18] = C[3] ^ ((~C[4]) & C[0]);
-			E[19] = C[4] ^ ((~C[0]) & C[1]);
-			A[2] ^= D[2];
-			C[0] = ULong512::RotL64(A[2], 62);
-			A[8] ^= D[3];
-			C[1] = ULong512::RotL64(A[8], 55);
-			A[14] ^= D[4];
-			C[2] = ULong512::RotL64(A[14], 39);
-			A[15] ^= D[0];
-			C[3] = ULong512::RotL64(A[15], 41);
-			A[21] ^= D[1];
-			C[4] = ULong512::RotL64(A[21], 2);
-			E[20] = C[0] ^ ((~C[1]) & C[2]);
-			E[21] = C[1] ^ ((~C[2]) & C[3]);
-			E[22] = C[2] ^ ((~C[3]) & C[4]);
-			E[23] = C[3] ^ ((~C[4]) & C[0]);
-			E[24] = C[4] ^ ((~C[0]) & C[1]);
-			// round n + 1
-			C[0] = E[0] ^ E[5] ^ E[10] ^ E[15] ^ E[20];
-			C[1] = E[1] ^ E[6] ^ E[11] ^ E[16] ^ E[21];
-			C[2] = E[2] ^ E[7] ^ E[12] ^ E[17] ^ E[22];
-			C[3] = E[3] ^ E[8] ^ E[13] ^ E[18] ^ E[23];
-			C[4] = E[4] ^ E[9] ^ E[14] ^ E[19] ^ E[24];
-			D[0] = C[4] ^ ULong512::RotL64(C[1], 1);
-			D[1] = C[0] ^ ULong512::RotL64(C[2], 1);
-			D[2] = C[1] ^ ULong512::RotL64(C[3], 1);
-			D[3] = C[2] ^ ULong512::RotL64(C[4], 1);
-			D[4] = C[3] ^ ULong512::RotL64(C[0], 1);
-			E[0] ^= D[0];
-			C[0] = E[0];
-			E[6] ^= D[1];
-			C[1] = ULong512::RotL64(E[6], 44);
-			E[12] ^= D[2];
-			C[2] = ULong512::RotL64(E[12], 43);
-			E[18] ^= D[3];
-			C[3] = ULong512::RotL64(E[18], 21);
-			E[24] ^= D[4];
-			C[4] = ULong512::RotL64(E[24], 14);
-			A[0] = C[0] ^ ((~C[1]) & C[2]);
-			A[0] ^= ULong512(KECCAK_RC24[i + 1]);
-			A[1] = C[1] ^ ((~C[2]) & C[3]);
-			A[2] = C[2] ^ ((~C[3]) & C[4]);
-			A[3] = C[3] ^ ((~C[4]) & C[0]);
-			A[4] = C[4] ^ ((~C[0]) & C[1]);
-			E[3] ^= D[3];
-			C[0] = ULong512::RotL64(E[3], 28);
-			E[9] ^= D[4];
-			C[1] = ULong512::RotL64(E[9], 20);
-			E[10] ^= D[0];
-			C[2] = ULong512::RotL64(E[10], 3);
-			E[16] ^= D[1];
-			C[3] = ULong512::RotL64(E[16], 45);
-			E[22] ^= D[2];
-			C[4] = ULong512::RotL64(E[22], 61);
-			A[5] = C[0] ^ ((~C[1]) & C[2]);
-			A[6] = C[1] ^ ((~C[2]) & C[3]);
-			A[7] = C[2] ^ ((~C[3]) & C[4]);
-			A[8] = C[3] ^ ((~C[4]) & C[0]);
-			A[9] = C[4] ^ ((~C[0]) & C[1]);
-			E[1] ^= D[1];
-			C[0] = ULong512::RotL64(E[1], 1);
-			E[7] ^= D[2];
-			C[1] = ULong512::RotL64(E[7], 6);
-			E[13] ^= D[3];
-			C[2] = ULong512::RotL64(E[13], 25);
-			E[19] ^= D[4];
-			C[3] = ULong512::RotL64(E[19], 8);
-			E[20] ^= D[0];
-			C[4] = ULong512::RotL64(E[20], 18);
-			A[10] = C[0] ^ ((~C[1]) & C[2]);
-			A[11] = C[1] ^ ((~C[2]) & C[3]);
-			A[12] = C[2] ^ ((~C[3]) & C[4]);
-			A[13] = C[3] ^ ((~C[4]) & C[0]);
-			A[14] = C[4] ^ ((~C[0]) & C[1]);
-			E[4] ^= D[4];
-			C[0] = ULong512::RotL64(E[4], 27);
-			E[5] ^= D[0];
-			C[1] = ULong512::RotL64(E[5], 36);
-			E[11] ^= D[1];
-			C[2] = ULong512::RotL64(E[11], 10);
-			E[17] ^= D[2];
-			C[3] = ULong512::RotL64(E[17], 15);
-			E[23] ^= D[3];
-			C[4] = ULong512::RotL64(E[23], 56);
-			A[15] = C[0] ^ ((~C[1]) & C[2]);
-			A[16] = C[1] ^ ((~C[2]) & C[3]);
-			A[17] = C[2] ^ ((~C[3]) & C[4]);
-			A[18] = C[3] ^ ((~C[4]) & C[0]);
-			A[19] = C[4] ^ ((~C[0]) & C[1]);
-			E[2] ^= D[2];
-			C[0] = ULong512::RotL64(E[2], 62);
-			E[8] ^= D[3];
-			C[1] = ULong512::RotL64(E[8], 55);
-			E[14] ^= D[4];
-			C[2] = ULong512::RotL64(E[14], 39);
-			E[15] ^= D[0];
-			C[3] = ULong512::RotL64(E[15], 41);
-			E[21] ^= D[1];
-			C[4] = ULong512::RotL64(E[21], 2);
-			A[20] = C[0] ^ ((~C[1]) & C[2]);
-			A[21] = C[1] ^ ((~C[2]) & C[3]);
-			A[22] = C[2] ^ ((~C[3]) & C[4]);
-			A[23] = C[3] ^ ((~C[4]) & C[0]);
-			A[24] = C[4] ^ ((~C[0]) & C[1]);
-		}
-
-		MemoryTools::Copy(A, 0, State, 0, A.size() * sizeof(ULong512));
-	}
-
-	/// <summary>
-	/// The horizontally vectorized 48 round (extended) form of the SHA3 permutation function.
-	/// <para>This function processes 8*25 blocks of state in parallel using AVX512 instructions.</para>
-	/// </summary>
-	/// 
-	/// <param name="State">The permutations ULong512 state array</param>
-	template<typename ArrayU512>
-	static void PermuteR48P8x1600H(ArrayU512 &State)
-	{
-		std::array<ULong512, 25> A;
-		std::array<ULong512, 5> C;
-		std::array<ULong512, 5> D;
-		std::array<ULong512, 25> E;
-		size_t i;
-
-		MemoryTools::Copy(State, 0, A, 0, A.size() * sizeof(ULong512));
-
-		for (i = 0; i < 48; i += 2)
-		{
-			// round n
-			C[0] = A[0] ^ A[5] ^ A[10] ^ A[15] ^ A[20];
-			C[1] = A[1] ^ A[6] ^ A[11] ^ A[16] ^ A[21];
-			C[2] = A[2] ^ A[7] ^ A[12] ^ A[17] ^ A[22];
-			C[3] = A[3] ^ A[8] ^ A[13] ^ A[18] ^ A[23];
-			C[4] = A[4] ^ A[9] ^ A[14] ^ A[19] ^ A[24];
-			D[0] = C[4] ^ ULong512::RotL64(C[1], 1);
-			D[1] = C[0] ^ ULong512::RotL64(C[2], 1);
-			D[2] = C[1] ^ ULong512::RotL64(C[3], 1);
-			D[3] = C[2] ^ ULong512::RotL64(C[4], 1);
-			D[4] = C[3] ^ ULong512::RotL64(C[0], 1);
-			A[0] ^= D[0];
-			C[0] = A[0];
-			A[6] ^= D[1];
-			C[1] = ULong512::RotL64(A[6], 44);
-			A[12] ^= D[2];
-			C[2] = ULong512::RotL64(A[12], 43);
-			A[18] ^= D[3];
-			C[3] = ULong512::RotL64(A[18], 21);
-			A[24] ^= D[4];
-			C[4] = ULong512::RotL64(A[24], 14);
-			E[0] = C[0] ^ ((~C[1]) & C[2]);
-			E[0] ^= ULong512(KECCAK_RC48[i]);
-			E[1] = C[1] ^ ((~C[2]) & C[3]);
-			E[2] = C[2] ^ ((~C[3]) & C[4]);
-			E[3] = C[3] ^ ((~C[4]) & C[0]);
-			E[4] = C[4] ^ ((~C[0]) & C[1]);
-			A[3] ^= D[3];
-			C[0] = ULong512::RotL64(A[3], 28);
-			A[9] ^= D[4];
-			C[1] = ULong512::RotL64(A[9], 20);
-			A[10] ^= D[0];
-			C[2] = ULong512::RotL64(A[10], 3);
-			A[16] ^= D[1];
-			C[3] = ULong512::RotL64(A[16], 45);
-			A[22] ^= D[2];
-			C[4] = ULong512::RotL64(A[22], 61);
-			E[5] = C[0] ^ ((~C[1]) & C[2]);
-			E[6] = C[1] ^ ((~C[2]) & C[3]);
-			E[7] = C[2] ^ ((~C[3]) & C[4]);
-			E[8] = C[3] ^ ((~C[4]) & C[0]);
-			E[9] = C[4] ^ ((~C[0]) & C[1]);
-			A[1] ^= D[1];
-			C[0] = ULong512::RotL64(A[1], 1);
-			A[7] ^= D[2];
-			C[1] = ULong512::RotL64(A[7], 6);
-			A[13] ^= D[3];
-			C[2] = ULong512::RotL64(A[13], 25);
-			A[19] ^= D[4];
-			C[3] = ULong512::RotL64(A[19], 8);
-			A[20] ^= D[0];
-			C[4] = ULong512::RotL64(A[20], 18);
-			E[10] = C[0] ^ ((~C[1]) & C[2]);
-			E[11] = C[1] ^ ((~C[2]) & C[3]);
-			E[12] = C[2] ^ ((~C[3]) & C[4]);
-			E[13] = C[3] ^ ((~C[4]) & C[0]);
-			E[14] = C[4] ^ ((~C[0]) & C[1]);
-			A[4] ^= D[4];
-			C[0] = ULong512::RotL64(A[4], 27);
-			A[5] ^= D[0];
-			C[1] = ULong512::RotL64(A[5], 36);
-			A[11] ^= D[1];
-			C[2] = ULong512::RotL64(A[11], 10);
-			A[17] ^= D[2];
-			C[3] = ULong512::RotL64(A[17], 15);
-			A[23] ^= D[3];
-			C[4] = ULong512::RotL64(A[23], 56);
-			E[15] = C[0] ^ ((~C[1]) & C[2]);
-			E[16] = C[1] ^ ((~C[2]) & C[3]);
-			E[17] = C[2] ^ ((~C[3]) & C[4]);
-			E[18] = C[3] ^ ((~C[4]) & C[0]);
-			E[19] = C[4] ^ ((~C[0]) & C[1]);
-			A[2] ^= D[2];
-			C[0] = ULong512::RotL64(A[2], 62);
-			A[8] ^= D[3];
-			C[1] = ULong512::RotL64(A[8], 55);
-			A[14] ^= D[4];
-			C[2] = ULong512::RotL64(A[14], 39);
-			A[15] ^= D[0];
-			C[3] = ULong512::RotL64(A[15], 41);
-			A[21] ^= D[1];
-			C[4] = ULong512::RotL64(A[21], 2);
-			E[20] = C[0] ^ ((~C[1]) & C[2]);
-			E[21] = C[1] ^ ((~C[2]) & C[3]);
-			E[22] = C[2] ^ ((~C[3]) & C[4]);
-			E[23] = C[3] ^ ((~C[4]) & C[0]);
-			E[24] = C[4] ^ ((~C[0]) & C[1]);
-			// round n + 1
-			C[0] = E[0] ^ E[5] ^ E[10] ^ E[15] ^ E[20];
-			C[1] = E[1] ^ E[6] ^ E[11] ^ E[16] ^ E[21];
-			C[2] = E[2] ^ E[7] ^ E[12] ^ E[17] ^ E[22];
-			C[3] = E[3] ^ E[8] ^ E[13] ^ E[18] ^ E[23];
-			C[4] = E[4] ^ E[9] ^ E[14] ^ E[19] ^ E[24];
-			D[0] = C[4] ^ ULong512::RotL64(C[1], 1);
-			D[1] = C[0] ^ ULong512::RotL64(C[2], 1);
-			D[2] = C[1] ^ ULong512::RotL64(C[3], 1);
-			D[3] = C[2] ^ ULong512::RotL64(C[4], 1);
-			D[4] = C[3] ^ ULong512::RotL64(C[0], 1);
-			E[0] ^= D[0];
-			C[0] = E[0];
-			E[6] ^= D[1];
-			C[1] = ULong512::RotL64(E[6], 44);
-			E[12] ^= D[2];
-			C[2] = ULong512::RotL64(E[12], 43);
-			E[18] ^= D[3];
-			C[3] = ULong512::RotL64(E[18], 21);
-			E[24] ^= D[4];
-			C[4] = ULong512::RotL64(E[24], 14);
-			A[0] = C[0] ^ ((~C[1]) & C[2]);
-			A[0] ^= ULong512(KECCAK_RC48[i + 1]);
-			A[1] = C[1] ^ ((~C[2]) & C[3]);
-			A[2] = C[2] ^ ((~C[3]) & C[4]);
-			A[3] = C[3] ^ ((~C[4]) & C[0]);
-			A[4] = C[4] ^ ((~C[0]) & C[1]);
-			E[3] ^= D[3];
-			C[0] = ULong512::RotL64(E[3], 28);
-			E[9] ^= D[4];
-			C[1] = ULong512::RotL64(E[9], 20);
-			E[10] ^= D[0];
-			C[2] = ULong512::RotL64(E[10], 3);
-			E[16] ^= D[1];
-			C[3] = ULong512::RotL64(E[16], 45);
-			E[22] ^= D[2];
-			C[4] = ULong512::RotL64(E[22], 61);
-			A[5] = C[0] ^ ((~C[1]) & C[2]);
-			A[6] = C[1] ^ ((~C[2]) & C[3]);
-			A[7] = C[2] ^ ((~C[3]) & C[4]);
-			A[8] = C[3] ^ ((~C[4]) & C[0]);
-			A[9] = C[4] ^ ((~C[0]) & C[1]);
-			E[1] ^= D[1];
-			C[0] = ULong512::RotL64(E[1], 1);
-			E[7] ^= D[2];
-			C[1] = ULong512::RotL64(E[7], 6);
-			E[13] ^= D[3];
-			C[2] = ULong512::RotL64(E[13], 25);
-			E[19] ^= D[4];
-			C[3] = ULong512::RotL64(E[19], 8);
-			E[20] ^= D[0];
-			C[4] = ULong512::RotL64(E[20], 18);
-			A[10] = C[0] ^ ((~C[1]) & C[2]);
-			A[11] = C[1] ^ ((~C[2]) & C[3]);
-			A[12] = C[2] ^ ((~C[3]) & C[4]);
-			A[13] = C[3] ^ ((~C[4]) & C[0]);
-			A[14] = C[4] ^ ((~C[0]) & C[1]);
-			E[4] ^= D[4];
-			C[0] = ULong512::RotL64(E[4], 27);
-			E[5] ^= D[0];
-			C[1] = ULong512::RotL64(E[5], 36);
-			E[11] ^= D[1];
-			C[2] = ULong512::RotL64(E[11], 10);
-			E[17] ^= D[2];
-			C[3] = ULong512::RotL64(E[17], 15);
-			E[23] ^= D[3];
-			C[4] = ULong512::RotL64(E[23], 56);
-			A[15] = C[0] ^ ((~C[1]) & C[2]);
-			A[16] = C[1] ^ ((~C[2]) & C[3]);
-			A[17] = C[2] ^ ((~C[3]) & C[4]);
-			A[18] = C[3] ^ ((~C[4]) & C[0]);
-			A[19] = C[4] ^ ((~C[0]) & C[1]);
-			E[2] ^= D[2];
-			C[0] = ULong512::RotL64(E[2], 62);
-			E[8] ^= D[3];
-			C[1] = ULong512::RotL64(E[8], 55);
-			E[14] ^= D[4];
-			C[2] = ULong512::RotL64(E[14], 39);
-			E[15] ^= D[0];
-			C[3] = ULong512::RotL64(E[15], 41);
-			E[21] ^= D[1];
-			C[4] = ULong512::RotL64(E[21], 2);
-			A[20] = C[0] ^ ((~C[1]) & C[2]);
-			A[21] = C[1] ^ ((~C[2]) & C[3]);
-			A[22] = C[2] ^ ((~C[3]) & C[4]);
-			A[23] = C[3] ^ ((~C[4]) & C[0]);
-			A[24] = C[4] ^ ((~C[0]) & C[1]);
-		}
-
-		MemoryTools::Copy(A, 0, State, 0, A.size() * sizeof(ULong512));
-	}
-
-#elif defined(CEX_HAS_AVX2)
-
-	template<typename ArrayU256>
-	static void AbsorbR24x1600H(ArrayU256 &State,
-		size_t Rate,
-		const std::vector<uint8_t> &Input0, 
-		const std::vector<uint8_t> &Input1, 
-		const std::vector<uint8_t> &Input2, 
-		const std::vector<uint8_t> &Input3, 
-		size_t InputLength, 
-		uint8_t Domain)
-	{
-		CEX_ALIGN(32) __m256i t;
-		CEX_ALIGN(32) __m256i idx = { 0 };
-		int64_t p0;
-		int64_t p1;
-		int64_t p2;
-		int64_t p3;
-		int64_t pos;
-		size_t i;
-
-		pos = 0;
-		p0 = (int64_t)Input0.data();
-		p1 = (int64_t)Input1.data();
-		p2 = (int64_t)Input2.data();
-		p3 = (int64_t)Input3.data();
-
-		idx = _mm256_set_epi64x(p3, p2, p1, p0);
-
-		while (InputLength >= Rate)
-		{
-			for (i = 0; i < Rate / sizeof(uint64_t); ++i)
-			{
-				t = _mm256_i64gather_epi64((int64_t*)pos, idx, 1);
-				State[i] = _mm256_xor_si256(State[i], t);
-				pos += sizeof(uint64_t);
-			}
-
-			PermuteR24P4x1600H(State);
-			InputLength -= Rate;
-		}
-
-		i = 0;
-
-		while (InputLength >= sizeof(uint64_t))
-		{
-			t = _mm256_i64gather_epi64((int64_t*)pos, idx, 1);
-			State[i] = _mm256_xor_si256(State[i], t);
-
-			i++;
-			pos += sizeof(uint64_t);
-			InputLength -= sizeof(uint64_t);
-		}
-
-		if (InputLength != 0)
-		{
-			t = _mm256_i64gather_epi64((int64_t*)pos, idx, 1);
-			idx = _mm256_set1_epi64x((1ULL << (sizeof(uint64_t) * InputLength)) - 1);
-			t = _mm256_and_si256(t, idx);
-			State[i] = _mm256_xor_si256(State[i], t);
-		}
-
-		t = _mm256_set1_epi64x((int64_t)Domain << (sizeof(uint64_t) * InputLength));
-		State[i] = _mm256_xor_si256(State[i], t);
-		t = _mm256_set1_epi64x(1ULL << 63);
-		State[(Rate / sizeof(uint64_t)) - 1] = _mm256_xor_si256(State[(Rate / sizeof(uint64_t)) - 1], t);
-	}
-
-	template<typename ArrayU256>
-	static void SqueezeBlocksR24x1600H(ArrayU256 &State,
-		size_t Rate, 
-		std::vector<uint8_t> &Output0, 
-		std::vector<uint8_t> &Output1, 
-		std::vector<uint8_t> &Output2, 
-		std::vector<uint8_t> &Output3, 
-		size_t Blocks)
-	{
-		uint64_t f0;
-		uint64_t f1;
-		uint64_t f2;
-		uint64_t f3;
-		size_t idx;
-
-		idx = 0;
-
-		while (Blocks > 0)
-		{
-			PermuteR24P4x1600H(State);
-
-			for (size_t i = 0; i < (size_t)Rate / sizeof(uint64_t); ++i)
-			{
-	#if defined(CEX_OS_WINDOWS)
-				f0 = _mm256_extract_epi64(State[i], 0);
-				f1 = _mm256_extract_epi64(State[i], 1);
-				f2 = _mm256_extract_epi64(State[i], 2);
-				f3 = _mm256_extract_epi64(State[i], 3);
-	#else
-				f0 = (uint64_t)(uint32_t)_mm256_extract_epi32(State[i], 0) | ((uint64_t)(uint32_t)_mm256_extract_epi32(State[i], 1) << 32);
-				f1 = (uint64_t)(uint32_t)_mm256_extract_epi32(State[i], 2) | ((uint64_t)(uint32_t)_mm256_extract_epi32(State[i], 3) << 32);
-				f2 = (uint64_t)(uint32_t)_mm256_extract_epi32(State[i], 4) | ((uint64_t)(uint32_t)_mm256_extract_epi32(State[i], 5) << 32);
-				f3 = (uint64_t)(uint32_t)_mm256_extract_epi32(State[i], 6) | ((uint64_t)(uint32_t)_mm256_extract_epi32(State[i], 7) << 32);
-	#endif
-				IntegerTools::Le64ToBytes(f0, Output0, idx);
-				IntegerTools::Le64ToBytes(f1, Output1, idx);
-				IntegerTools::Le64ToBytes(f2, Output2, idx);
-				IntegerTools::Le64ToBytes(f3, Output3, idx);
-
-				idx += sizeof(uint64_t);
-			}
-
-			--Blocks;
-		}
-	}
-
-	/// <summary>
-	/// The horizontally vectorized 24 round (standard) form of the SHA3 permutation function.
-	/// <para>This function processes 4*25 blocks of state in parallel using AVX2 instructions.</para>
-	/// </summary>
-	/// 
-	/// <param name="State">The permutations ULong256 state array</param>
-	/// <param name="Rounds">The number of permutations rounds; defaults at 24</param>
-	template<typename ArrayU256>
-	static void PermuteR24P4x1600H(ArrayU256 &State, size_t Rounds = 24)
-	{
-		std::array<ULong256, 25> A;
-		std::array<ULong256, 5> C;
-		std::array<ULong256, 5> D;
-		std::array<ULong256, 25> E;
-		size_t i;
-
-		MemoryTools::Copy(State, 0, A, 0, A.size() * sizeof(ULong256));
-
-		for (i = 0; i < Rounds; i += 2)
-		{
-			// round n
-			C[0] = A[0] ^ A[5] ^ A[10] ^ A[15] ^ A[20];
-			C[1] = A[1] ^ A[6] ^ A[11] ^ A[16] ^ A[21];
-			C[2] = A[2] ^ A[7] ^ A[12] ^ A[17] ^ A[22];
-			C[3] = A[3] ^ A[8] ^ A[13] ^ A[18] ^ A[23];
-			C[4] = A[4] ^ A[9] ^ A[14] ^ A[19] ^ A[24];
-			D[0] = C[4] ^ ULong256::RotL64(C[1], 1);
-			D[1] = C[0] ^ ULong256::RotL64(C[2], 1);
-			D[2] = C[1] ^ ULong256::RotL64(C[3], 1);
-			D[3] = C[2] ^ ULong256::RotL64(C[4], 1);
-			D[4] = C[3] ^ ULong256::RotL64(C[0], 1);
-			A[0] ^= D[0];
-			C[0] = A[0];
-			A[6] ^= D[1];
-			C[1] = ULong256::RotL64(A[6], 44);
-			A[12] ^= D[2];
-			C[2] = ULong256::RotL64(A[12], 43);
-			A[18] ^= D[3];
-			C[3] = ULong256::RotL64(A[18], 21);
-			A[24] ^= D[4];
-			C[4] = ULong256::RotL64(A[24], 14);
-			E[0] = C[0] ^ ((~C[1]) & C[2]);
-			E[0] ^= ULong256(KECCAK_RC24[i]);
-			E[1] = C[1] ^ ((~C[2]) & C[3]);
-			E[2] = C[2] ^ ((~C[3]) & C[4]);
-			E[3] = C[3] ^ ((~C[4]) & C[0]);
-			E[4] = C[4] ^ ((~C[0]) & C[1]);
-			A[3] ^= D[3];
-			C[0] = ULong256::RotL64(A[3], 28);
-			A[9] ^= D[4];
-			C[1] = ULong256::RotL64(A[9], 20);
-			A[10] ^= D[0];
-			C[2] = ULong256::RotL64(A[10], 3);
-			A[16] ^= D[1];
-			C[3] = ULong256::RotL64(A[16], 45);
-			A[22] ^= D[2];
-			C[4] = ULong256::RotL64(A[22], 61);
-			E[5] = C[0] ^ ((~C[1]) & C[2]);
-			E[6] = C[1] ^ ((~C[2]) & C[3]);
-			E[7] = C[2] ^ ((~C[3]) & C[4]);
-			E[8] = C[3] ^ ((~C[4]) & C[0]);
-			E[9] = C[4] ^ ((~C[0]) & C[1]);
-			A[1] ^= D[1];
-			C[0] = ULong256::RotL64(A[1], 1);
-			A[7] ^= D[2];
-			C[1] = ULong256::RotL64(A[7], 6);
-			A[13] ^= D[3];
-			C[2] = ULong256::RotL64(A[13], 25);
-			A[19] ^= D[4];
-			C[3] = ULong256::RotL64(A[19], 8);
-			A[20] ^= D[0];
-			C[4] = ULong256::RotL64(A[20], 18);
-			E[10] = C[0] ^ ((~C[1]) & C[2]);
-			E[11] = C[1] ^ ((~C[2]) & C[3]);
-			E[12] = C[2] ^ ((~C[3]) & C[4]);
-			E[13] = C[3] ^ ((~C[4]) & C[0]);
-			E[14] = C[4] ^ ((~C[0]) & C[1]);
-			A[4] ^= D[4];
-			C[0] = ULong256::RotL64(A[4], 27);
-			A[5] ^= D[0];
-			C[1] = ULong256::RotL64(A[5], 36);
-			A[11] ^= D[1];
-			C[2] = ULong256::RotL64(A[11], 10);
-			A[17] ^= D[2];
-			C[3] = ULong256::RotL64(A[17], 15);
-			A[23] ^= D[3];
-			C[4] = ULong256::RotL64(A[23], 56);
-			E[15] = C[0] ^ ((~C[1]) & C[2]);
-			E[16] = C[1] ^ ((~C[2]) & C[3]);
-			E[17] = C[2] ^ ((~C[3]) & C[4]);
-			E[18] = C[3] ^ ((~C[4]) & C[0]);
-			E[19] = C[4] ^ ((~C[0]) & C[1]);
-			A[2] ^= D[2];
-			C[0] = ULong256::RotL64(A[2], 62);
-			A[8] ^= D[3];
-			C[1] = ULong256::RotL64(A[8], 55);
-			A[14] ^= D[4];
-			C[2] = ULong256::RotL64(A[14], 39);
-			A[15] ^= D[0];
-			C[3] = ULong256::RotL64(A[15], 41);
-			A[21] ^= D[1];
-			C[4] = ULong256::RotL64(A[21], 2);
-			E[20] = C[0] ^ ((~C[1]) & C[2]);
-			E[21] = C[1] ^ ((~C[2]) & C[3]);
-			E[22] = C[2] ^ ((~C[3]) & C[4]);
-			E[23] = C[3] ^ ((~C[4]) & C[0]);
-			E[24] = C[4] ^ ((~C[0]) & C[1]);
-			// round n + 1
-			C[0] = E[0] ^ E[5] ^ E[10] ^ E[15] ^ E[20];
-			C[1] = E[1] ^ E[6] ^ E[11] ^ E[16] ^ E[21];
-			C[2] = E[2] ^ E[7] ^ E[12] ^ E[17] ^ E[22];
-			C[3] = E[3] ^ E[8] ^ E[13] ^ E[18] ^ E[23];
-			C[4] = E[4] ^ E[9] ^ E[14] ^ E[19] ^ E[24];
-			D[0] = C[4] ^ ULong256::RotL64(C[1], 1);
-			D[1] = C[0] ^ ULong256::RotL64(C[2], 1);
-			D[2] = C[1] ^ ULong256::RotL64(C[3], 1);
-			D[3] = C[2] ^ ULong256::RotL64(C[4], 1);
-			D[4] = C[3] ^ ULong256::RotL64(C[0], 1);
-			E[0] ^= D[0];
-			C[0] = E[0];
-			E[6] ^= D[1];
-			C[1] = ULong256::RotL64(E[6], 44);
-			E[12] ^= D[2];
-			C[2] = ULong256::RotL64(E[12], 43);
-			E[18] ^= D[3];
-			C[3] = ULong256::RotL64(E[18], 21);
-			E[24] ^= D[4];
-			C[4] = ULong256::RotL64(E[24], 14);
-			A[0] = C[0] ^ ((~C[1]) & C[2]);
-			A[0] ^= ULong256(KECCAK_RC24[i + 1]);
-			A[1] = C[1] ^ ((~C[2]) & C[3]);
-			A[2] = C[2] ^ ((~C[3]) & C[4]);
-			A[3] = C[3] ^ ((~C[4]) & C[0]);
-			A[4] = C[4] ^ ((~C[0]) & C[1]);
-			E[3] ^= D[3];
-			C[0] = ULong256::RotL64(E[3], 28);
-			E[9] ^= D[4];
-			C[1] = ULong256::RotL64(E[9], 20);
-			E[10] ^= D[0];
-			C[2] = ULong256::RotL64(E[10], 3);
-			E[16] ^= D[1];
-			C[3] = ULong256::RotL64(E[16], 45);
-			E[22] ^= D[2];
-			C[4] = ULong256::RotL64(E[22], 61);
-			A[5] = C[0] ^ ((~C[1]) & C[2]);
-			A[6] = C[1] ^ ((~C[2]) & C[3]);
-			A[7] = C[2] ^ ((~C[3]) & C[4]);
-			A[8] = C[3] ^ ((~C[4]) & C[0]);
-			A[9] = C[4] ^ ((~C[0]) & C[1]);
-			E[1] ^= D[1];
-			C[0] = ULong256::RotL64(E[1], 1);
-			E[7] ^= D[2];
-			C[1] = ULong256::RotL64(E[7], 6);
-			E[13] ^= D[3];
-			C[2] = ULong256::RotL64(E[13], 25);
-			E[19] ^= D[4];
-			C[3] = ULong256::RotL64(E[19], 8);
-			E[20] ^= D[0];
-			C[4] = ULong256::RotL64(E[20], 18);
-			A[10] = C[0] ^ ((~C[1]) & C[2]);
-			A[11] = C[1] ^ ((~C[2]) & C[3]);
-			A[12] = C[2] ^ ((~C[3]) & C[4]);
-			A[13] = C[3] ^ ((~C[4]) & C[0]);
-			A[14] = C[4] ^ ((~C[0]) & C[1]);
-			E[4] ^= D[4];
-			C[0] = ULong256::RotL64(E[4], 27);
-			E[5] ^= D[0];
-			C[1] = ULong256::RotL64(E[5], 36);
-			E[11] ^= D[1];
-			C[2] = ULong256::RotL64(E[11], 10);
-			E[17] ^= D[2];
-			C[3] = ULong256::RotL64(E[17], 15);
-			E[23] ^= D[3];
-			C[4] = ULong256::RotL64(E[23], 56);
-			A[15] = C[0] ^ ((~C[1]) & C[2]);
-			A[16] = C[1] ^ ((~C[2]) & C[3]);
-			A[17] = C[2] ^ ((~C[3]) & C[4]);
-			A[18] = C[3] ^ ((~C[4]) & C[0]);
-			A[19] = C[4] ^ ((~C[0]) & C[1]);
-			E[2] ^= D[2];
-			C[0] = ULong256::RotL64(E[2], 62);
-			E[8] ^= D[3];
-			C[1] = ULong256::RotL64(E[8], 55);
-			E[14] ^= D[4];
-			C[2] = ULong256::RotL64(E[14], 39);
-			E[15] ^= D[0];
-			C[3] = ULong256::RotL64(E[15], 41);
-			E[21] ^= D[1];
-			C[4] = ULong256::RotL64(E[21], 2);
-			A[20] = C[0] ^ ((~C[1]) & C[2]);
-			A[21] = C[1] ^ ((~C[2]) & C[3]);
-			A[22] = C[2] ^ ((~C[3]) & C[4]);
-			A[23] = C[3] ^ ((~C[4]) & C[0]);
-			A[24] = C[4] ^ ((~C[0]) & C[1]);
-		}
-
-		MemoryTools::Copy(A, 0, State, 0, A.size() * sizeof(ULong256));
-	}
-
-	/// <summary>
-	/// The horizontally vectorized 48 round form (extended) of the SHA3 permutation function.
-	/// <para>This function processes 4*25 blocks of state in parallel using AVX2 instructions.</para>
-	/// </summary>
-	/// 
-	/// <param name="State">The permutations ULong256 state array</param>
-	template<typename ArrayU256>
-	static void PermuteR48P4x1600H(ArrayU256 &State)
-	{
-		std::array<ULong256, 25> A;
-		std::array<ULong256, 5> C;
-		std::array<ULong256, 5> D;
-		std::array<ULong256, 25> E;
-		size_t i;
-
-		MemoryTools::Copy(State, 0, A, 0, A.size() * sizeof(ULong256));
-
-		for (i = 0; i < 48; i += 2)
-		{
-			// round n
-			C[0] = A[0] ^ A[5] ^ A[10] ^ A[15] ^ A[20];
-			C[1] = A[1] ^ A[6] ^ A[11] ^ A[16] ^ A[21];
-			C[2] = A[2] ^ A[7] ^ A[12] ^ A[17] ^ A[22];
-			C[3] = A[3] ^ A[8] ^ A[13] ^ A[18] ^ A[23];
-			C[4] = A[4] ^ A[9] ^ A[14] ^ A[19] ^ A[24];
-			D[0] = C[4] ^ ULong256::RotL64(C[1], 1);
-			D[1] = C[0] ^ ULong256::RotL64(C[2], 1);
-			D[2] = C[1] ^ ULong256::RotL64(C[3], 1);
-			D[3] = C[2] ^ ULong256::RotL64(C[4], 1);
-			D[4] = C[3] ^ ULong256::RotL64(C[0], 1);
-			A[0] ^= D[0];
-			C[0] = A[0];
-			A[6] ^= D[1];
-			C[1] = ULong256::RotL64(A[6], 44);
-			A[12] ^= D[2];
-			C[2] = ULong256::RotL64(A[12], 43);
-			A[18] ^= D[3];
-			C[3] = ULong256::RotL64(A[18], 21);
-			A[24] ^= D[4];
-			C[4] = ULong256::RotL64(A[24], 14);
-			E[0] = C[0] ^ ((~C[1]) & C[2]);
-			E[0] ^= ULong256(KECCAK_RC48[i]);
-			E[1] = C[1] ^ ((~C[2]) & C[3]);
-			E[2] = C[2] ^ ((~C[3]) & C[4]);
-			E[3] = C[3] ^ ((~C[4]) & C[0]);
-			E[4] = C[4] ^ ((~C[0]) & C[1]);
-			A[3] ^= D[3];
-			C[0] = ULong256::RotL64(A[3], 28);
-			A[9] ^= D[4];
-			C[1] = ULong256::RotL64(A[9], 20);
-			A[10] ^= D[0];
-			C[2] = ULong256::RotL64(A[10], 3);
-			A[16] ^= D[1];
-			C[3] = ULong256::RotL64(A[16], 45);
-			A[22] ^= D[2];
-			C[4] = ULong256::RotL64(A[22], 61);
-			E[5] = C[0] ^ ((~C[1]) & C[2]);
-			E[6] = C[1] ^ ((~C[2]) & C[3]);
-			E[7] = C[2] ^ ((~C[3]) & C[4]);
-			E[8] = C[3] ^ ((~C[4]) & C[0]);
-			E[9] = C[4] ^ ((~C[0]) & C[1]);
-			A[1] ^= D[1];
-			C[0] = ULong256::RotL64(A[1], 1);
-			A[7] ^= D[2];
-			C[1] = ULong256::RotL64(A[7], 6);
-			A[13] ^= D[3];
-			C[2] = ULong256::RotL64(A[13], 25);
-			A[19] ^= D[4];
-			C[3] = ULong256::RotL64(A[19], 8);
-			A[20] ^= D[0];
-			C[4] = ULong256::RotL64(A[20], 18);
-			E[10] = C[0] ^ ((~C[1]) & C[2]);
-			E[11] = C[1] ^ ((~C[2]) & C[3]);
-			E[12] = C[2] ^ ((~C[3]) & C[4]);
-			E[13] = C[3] ^ ((~C[4]) & C[0]);
-			E[14] = C[4] ^ ((~C[0]) & C[1]);
-			A[4] ^= D[4];
-			C[0] = ULong256::RotL64(A[4], 27);
-			A[5] ^= D[0];
-			C[1] = ULong256::RotL64(A[5], 36);
-			A[11] ^= D[1];
-			C[2] = ULong256::RotL64(A[11], 10);
-			A[17] ^= D[2];
-			C[3] = ULong256::RotL64(A[17], 15);
-			A[23] ^= D[3];
-			C[4] = ULong256::RotL64(A[23], 56);
-			E[15] = C[0] ^ ((~C[1]) & C[2]);
-			E[16] = C[1] ^ ((~C[2]) & C[3]);
-			E[17] = C[2] ^ ((~C[3]) & C[4]);
-			E[18] = C[3] ^ ((~C[4]) & C[0]);
-			E[19] = C[4] ^ ((~C[0]) & C[1]);
-			A[2] ^= D[2];
-			C[0] = ULong256::RotL64(A[2], 62);
-			A[8] ^= D[3];
-			C[1] = ULong256::RotL64(A[8], 55);
-			A[14] ^= D[4];
-			C[2] = ULong256::RotL64(A[14], 39);
-			A[15] ^= D[0];
-			C[3] = ULong256::RotL64(A[15], 41);
-			A[21] ^= D[1];
-			C[4] = ULong256::RotL64(A[21], 2);
-			E[20] = C[0] ^ ((~C[1]) & C[2]);
-			E[21] = C[1] ^ ((~C[2]) & C[3]);
-			E[22] = C[2] ^ ((~C[3]) & C[4]);
-			E[23] = C[3] ^ ((~C[4]) & C[0]);
-			E[24] = C[4] ^ ((~C[0]) & C[1]);
-			// round n + 1
-			C[0] = E[0] ^ E[5] ^ E[10] ^ E[15] ^ E[20];
-			C[1] = E[1] ^ E[6] ^ E[11] ^ E[16] ^ E[21];
-			C[2] = E[2] ^ E[7] ^ E[12] ^ E[17] ^ E[22];
-			C[3] = E[3] ^ E[8] ^ E[13] ^ E[18] ^ E[23];
-			C[4] = E[4] ^ E[9] ^ E[14] ^ E[19] ^ E[24];
-			D[0] = C[4] ^ ULong256::RotL64(C[1], 1);
-			D[1] = C[0] ^ ULong256::RotL64(C[2], 1);
-			D[2] = C[1] ^ ULong256::RotL64(C[3], 1);
-			D[3] = C[2] ^ ULong256::RotL64(C[4], 1);
-			D[4] = C[3] ^ ULong256::RotL64(C[0], 1);
-			E[0] ^= D[0];
-			C[0] = E[0];
-			E[6] ^= D[1];
-			C[1] = ULong256::RotL64(E[6], 44);
-			E[12] ^= D[2];
-			C[2] = ULong256::RotL64(E[12], 43);
-			E[18] ^= D[3];
-			C[3] = ULong256::RotL64(E[18], 21);
-			E[24] ^= D[4];
-			C[4] = ULong256::RotL64(E[24], 14);
-			A[0] = C[0] ^ ((~C[1]) & C[2]);
-			A[0] ^= ULong256(KECCAK_RC48[i + 1]);
-			A[1] = C[1] ^ ((~C[2]) & C[3]);
-			A[2] = C[2] ^ ((~C[3]) & C[4]);
-			A[3] = C[3] ^ ((~C[4]) & C[0]);
-			A[4] = C[4] ^ ((~C[0]) & C[1]);
-			E[3] ^= D[3];
-			C[0] = ULong256::RotL64(E[3], 28);
-			E[9] ^= D[4];
-			C[1] = ULong256::RotL64(E[9], 20);
-			E[10] ^= D[0];
-			C[2] = ULong256::RotL64(E[10], 3);
-			E[16] ^= D[1];
-			C[3] = ULong256::RotL64(E[16], 45);
-			E[22] ^= D[2];
-			C[4] = ULong256::RotL64(E[22], 61);
-			A[5] = C[0] ^ ((~C[1]) & C[2]);
-			A[6] = C[1] ^ ((~C[2]) & C[3]);
-			A[7] = C[2] ^ ((~C[3]) & C[4]);
-			A[8] = C[3] ^ ((~C[4]) & C[0]);
-			A[9] = C[4] ^ ((~C[0]) & C[1]);
-			E[1] ^= D[1];
-			C[0] = ULong256::RotL64(E[1], 1);
-			E[7] ^= D[2];
-			C[1] = ULong256::RotL64(E[7], 6);
-			E[13] ^= D[3];
-			C[2] = ULong256::RotL64(E[13], 25);
-			E[19] ^= D[4];
-			C[3] = ULong256::RotL64(E[19], 8);
-			E[20] ^= D[0];
-			C[4] = ULong256::RotL64(E[20], 18);
-			A[10] = C[0] ^ ((~C[1]) & C[2]);
-			A[11] = C[1] ^ ((~C[2]) & C[3]);
-			A[12] = C[2] ^ ((~C[3]) & C[4]);
-			A[13] = C[3] ^ ((~C[4]) & C[0]);
-			A[14] = C[4] ^ ((~C[0]) & C[1]);
-			E[4] ^= D[4];
-			C[0] = ULong256::RotL64(E[4], 27);
-			E[5] ^= D[0];
-			C[1] = ULong256::RotL64(E[5], 36);
-			E[11] ^= D[1];
-			C[2] = ULong256::RotL64(E[11], 10);
-			E[17] ^= D[2];
-			C[3] = ULong256::RotL64(E[17], 15);
-			E[23] ^= D[3];
-			C[4] = ULong256::RotL64(E[23], 56);
-			A[15] = C[0] ^ ((~C[1]) & C[2]);
-			A[16] = C[1] ^ ((~C[2]) & C[3]);
-			A[17] = C[2] ^ ((~C[3]) & C[4]);
-			A[18] = C[3] ^ ((~C[4]) & C[0]);
-			A[19] = C[4] ^ ((~C[0]) & C[1]);
-			E[2] ^= D[2];
-			C[0] = ULong256::RotL64(E[2], 62);
-			E[8] ^= D[3];
-			C[1] = ULong256::RotL64(E[8], 55);
-			E[14] ^= D[4];
-			C[2] = ULong256::RotL64(E[14], 39);
-			E[15] ^= D[0];
-			C[3] = ULong256::RotL64(E[15], 41);
-			E[21] ^= D[1];
-			C[4] = ULong256::RotL64(E[21], 2);
-			A[20] = C[0] ^ ((~C[1]) & C[2]);
-			A[21] = C[1] ^ ((~C[2]) & C[3]);
-			A[22] = C[2] ^ ((~C[3]) & C[4]);
-			A[23] = C[3] ^ ((~C[4]) & C[0]);
-			A[24] = C[4] ^ ((~C[0]) & C[1]);
-		}
-
-		MemoryTools::Copy(A, 0, State, 0, A.size() * sizeof(ULong256));
-	}
-
-#endif
-
 	/// <summary>
 	/// The Keccak 24-round extraction function; extract blocks of state to an output 8-bit array
 	/// </summary>
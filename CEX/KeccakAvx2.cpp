@@ -0,0 +1,577 @@
+#include "KeccakKernels.h"
+#if defined(CEX_HAS_AVX2)
+#	include "ULong256.h"
+#	include <cstring>
+#else
+#	include "CryptoDigestException.h"
+#endif
+
+NAMESPACE_DIGEST
+
+// this unit is compiled with the AVX2 code generation flag; it includes no shared header with instruction set branches,
+// and the permutations and the SIMD wrapper they use have internal linkage, so no inline code compiled here can be linked into another unit
+
+#if defined(CEX_HAS_AVX2)
+namespace
+{
+	using Numeric::ULong256;
+
+	// the first 24 constants are the standard round constants, the next 24 extend the permutation to 48 rounds
+	const uint64_t KECCAK_RC48[48] =
+	{
+		0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808AULL, 0x8000000080008000ULL,
+		0x000000000000808BULL, 0x0000000080000001ULL, 0x8000000080008081ULL, 0x8000000000008009ULL,
+		0x000000000000008AULL, 0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000AULL,
+		0x000000008000808BULL, 0x800000000000008BULL, 0x8000000000008089ULL, 0x8000000000008003ULL,
+		0x8000000000008002ULL, 0x8000000000000080ULL, 0x000000000000800AULL, 0x800000008000000AULL,
+		0x8000000080008081ULL, 0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL,
+		0x8000000080008082ULL, 0x800000008000800AULL, 0x8000000000000003ULL, 0x8000000080000009ULL,
+		0x8000000000008082ULL, 0x0000000000008009ULL, 0x8000000000000080ULL, 0x0000000000008083ULL,
+		0x8000000000000081ULL, 0x0000000000000001ULL, 0x000000000000800BULL, 0x8000000080008001ULL,
+		0x0000000000000080ULL, 0x8000000000008000ULL, 0x8000000080008001ULL, 0x0000000000000009ULL,
+		0x800000008000808BULL, 0x0000000000000081ULL, 0x8000000000000082ULL, 0x000000008000008BULL,
+		0x8000000080008009ULL, 0x8000000080000000ULL, 0x0000000080000080ULL, 0x0000000080008003ULL
+	};
+
+	// the 24 round (standard) permutation of four interleaved states
+	void PermuteR24P4x1600(uint64_t* State, size_t Rounds)
+	{
+		std::array<ULong256, 25> A;
+		std::array<ULong256, 5> C;
+		std::array<ULong256, 5> D;
+		std::array<ULong256, 25> E;
+		size_t i;
+
+		for (i = 0; i < 25; ++i)
+		{
+			A[i] = ULong256(State, i * 4);
+		}
+
+		for (i = 0; i < Rounds; i += 2)
+		{
+			// round n
+			C[0] = A[0] ^ A[5] ^ A[10] ^ A[15] ^ A[20];
+			C[1] = A[1] ^ A[6] ^ A[11] ^ A[16] ^ A[21];
+			C[2] = A[2] ^ A[7] ^ A[12] ^ A[17] ^ A[22];
+			C[3] = A[3] ^ A[8] ^ A[13] ^ A[18] ^ A[23];
+			C[4] = A[4] ^ A[9] ^ A[14] ^ A[19] ^ A[24];
+			D[0] = C[4] ^ ULong256::RotL64(C[1], 1);
+			D[1] = C[0] ^ ULong256::RotL64(C[2], 1);
+			D[2] = C[1] ^ ULong256::RotL64(C[3], 1);
+			D[3] = C[2] ^ ULong256::RotL64(C[4], 1);
+			D[4] = C[3] ^ ULong256::RotL64(C[0], 1);
+			A[0] ^= D[0];
+			C[0] = A[0];
+			A[6] ^= D[1];
+			C[1] = ULong256::RotL64(A[6], 44);
+			A[12] ^= D[2];
+			C[2] = ULong256::RotL64(A[12], 43);
+			A[18] ^= D[3];
+			C[3] = ULong256::RotL64(A[18], 21);
+			A[24] ^= D[4];
+			C[4] = ULong256::RotL64(A[24], 14);
+			E[0] = C[0] ^ ((~C[1]) & C[2]);
+			E[0] ^= ULong256(KECCAK_RC48[i]);
+			E[1] = C[1] ^ ((~C[2]) & C[3]);
+			E[2] = C[2] ^ ((~C[3]) & C[4]);
+			E[3] = C[3] ^ ((~C[4]) & C[0]);
+			E[4] = C[4] ^ ((~C[0]) & C[1]);
+			A[3] ^= D[3];
+			C[0] = ULong256::RotL64(A[3], 28);
+			A[9] ^= D[4];
+			C[1] = ULong256::RotL64(A[9], 20);
+			A[10] ^= D[0];
+			C[2] = ULong256::RotL64(A[10], 3);
+			A[16] ^= D[1];
+			C[3] = ULong256::RotL64(A[16], 45);
+			A[22] ^= D[2];
+			C[4] = ULong256::RotL64(A[22], 61);
+			E[5] = C[0] ^ ((~C[1]) & C[2]);
+			E[6] = C[1] ^ ((~C[2]) & C[3]);
+			E[7] = C[2] ^ ((~C[3]) & C[4]);
+			E[8] = C[3] ^ ((~C[4]) & C[0]);
+			E[9] = C[4] ^ ((~C[0]) & C[1]);
+			A[1] ^= D[1];
+			C[0] = ULong256::RotL64(A[1], 1);
+			A[7] ^= D[2];
+			C[1] = ULong256::RotL64(A[7], 6);
+			A[13] ^= D[3];
+			C[2] = ULong256::RotL64(A[13], 25);
+			A[19] ^= D[4];
+			C[3] = ULong256::RotL64(A[19], 8);
+			A[20] ^= D[0];
+			C[4] = ULong256::RotL64(A[20], 18);
+			E[10] = C[0] ^ ((~C[1]) & C[2]);
+			E[11] = C[1] ^ ((~C[2]) & C[3]);
+			E[12] = C[2] ^ ((~C[3]) & C[4]);
+			E[13] = C[3] ^ ((~C[4]) & C[0]);
+			E[14] = C[4] ^ ((~C[0]) & C[1]);
+			A[4] ^= D[4];
+			C[0] = ULong256::RotL64(A[4], 27);
+			A[5] ^= D[0];
+			C[1] = ULong256::RotL64(A[5], 36);
+			A[11] ^= D[1];
+			C[2] = ULong256::RotL64(A[11], 10);
+			A[17] ^= D[2];
+			C[3] = ULong256::RotL64(A[17], 15);
+			A[23] ^= D[3];
+			C[4] = ULong256::RotL64(A[23], 56);
+			E[15] = C[0] ^ ((~C[1]) & C[2]);
+			E[16] = C[1] ^ ((~C[2]) & C[3]);
+			E[17] = C[2] ^ ((~C[3]) & C[4]);
+			E[18] = C[3] ^ ((~C[4]) & C[0]);
+			E[19] = C[4] ^ ((~C[0]) & C[1]);
+			A[2] ^= D[2];
+			C[0] = ULong256::RotL64(A[2], 62);
+			A[8] ^= D[3];
+			C[1] = ULong256::RotL64(A[8], 55);
+			A[14] ^= D[4];
+			C[2] = ULong256::RotL64(A[14], 39);
+			A[15] ^= D[0];
+			C[3] = ULong256::RotL64(A[15], 41);
+			A[21] ^= D[1];
+			C[4] = ULong256::RotL64(A[21], 2);
+			E[20] = C[0] ^ ((~C[1]) & C[2]);
+			E[21] = C[1] ^ ((~C[2]) & C[3]);
+			E[22] = C[2] ^ ((~C[3]) & C[4]);
+			E[23] = C[3] ^ ((~C[4]) & C[0]);
+			E[24] = C[4] ^ ((~C[0]) & C[1]);
+			// round n + 1
+			C[0] = E[0] ^ E[5] ^ E[10] ^ E[15] ^ E[20];
+			C[1] = E[1] ^ E[6] ^ E[11] ^ E[16] ^ E[21];
+			C[2] = E[2] ^ E[7] ^ E[12] ^ E[17] ^ E[22];
+			C[3] = E[3] ^ E[8] ^ E[13] ^ E[18] ^ E[23];
+			C[4] = E[4] ^ E[9] ^ E[14] ^ E[19] ^ E[24];
+			D[0] = C[4] ^ ULong256::RotL64(C[1], 1);
+			D[1] = C[0] ^ ULong256::RotL64(C[2], 1);
+			D[2] = C[1] ^ ULong256::RotL64(C[3], 1);
+			D[3] = C[2] ^ ULong256::RotL64(C[4], 1);
+			D[4] = C[3] ^ ULong256::RotL64(C[0], 1);
+			E[0] ^= D[0];
+			C[0] = E[0];
+			E[6] ^= D[1];
+			C[1] = ULong256::RotL64(E[6], 44);
+			E[12] ^= D[2];
+			C[2] = ULong256::RotL64(E[12], 43);
+			E[18] ^= D[3];
+			C[3] = ULong256::RotL64(E[18], 21);
+			E[24] ^= D[4];
+			C[4] = ULong256::RotL64(E[24], 14);
+			A[0] = C[0] ^ ((~C[1]) & C[2]);
+			A[0] ^= ULong256(KECCAK_RC48[i + 1]);
+			A[1] = C[1] ^ ((~C[2]) & C[3]);
+			A[2] = C[2] ^ ((~C[3]) & C[4]);
+			A[3] = C[3] ^ ((~C[4]) & C[0]);
+			A[4] = C[4] ^ ((~C[0]) & C[1]);
+			E[3] ^= D[3];
+			C[0] = ULong256::RotL64(E[3], 28);
+			E[9] ^= D[4];
+			C[1] = ULong256::RotL64(E[9], 20);
+			E[10] ^= D[0];
+			C[2] = ULong256::RotL64(E[10], 3);
+			E[16] ^= D[1];
+			C[3] = ULong256::RotL64(E[16], 45);
+			E[22] ^= D[2];
+			C[4] = ULong256::RotL64(E[22], 61);
+			A[5] = C[0] ^ ((~C[1]) & C[2]);
+			A[6] = C[1] ^ ((~C[2]) & C[3]);
+			A[7] = C[2] ^ ((~C[3]) & C[4]);
+			A[8] = C[3] ^ ((~C[4]) & C[0]);
+			A[9] = C[4] ^ ((~C[0]) & C[1]);
+			E[1] ^= D[1];
+			C[0] = ULong256::RotL64(E[1], 1);
+			E[7] ^= D[2];
+			C[1] = ULong256::RotL64(E[7], 6);
+			E[13] ^= D[3];
+			C[2] = ULong256::RotL64(E[13], 25);
+			E[19] ^= D[4];
+			C[3] = ULong256::RotL64(E[19], 8);
+			E[20] ^= D[0];
+			C[4] = ULong256::RotL64(E[20], 18);
+			A[10] = C[0] ^ ((~C[1]) & C[2]);
+			A[11] = C[1] ^ ((~C[2]) & C[3]);
+			A[12] = C[2] ^ ((~C[3]) & C[4]);
+			A[13] = C[3] ^ ((~C[4]) & C[0]);
+			A[14] = C[4] ^ ((~C[0]) & C[1]);
+			E[4] ^= D[4];
+			C[0] = ULong256::RotL64(E[4], 27);
+			E[5] ^= D[0];
+			C[1] = ULong256::RotL64(E[5], 36);
+			E[11] ^= D[1];
+			C[2] = ULong256::RotL64(E[11], 10);
+			E[17] ^= D[2];
+			C[3] = ULong256::RotL64(E[17], 15);
+			E[23] ^= D[3];
+			C[4] = ULong256::RotL64(E[23], 56);
+			A[15] = C[0] ^ ((~C[1]) & C[2]);
+			A[16] = C[1] ^ ((~C[2]) & C[3]);
+			A[17] = C[2] ^ ((~C[3]) & C[4]);
+			A[18] = C[3] ^ ((~C[4]) & C[0]);
+			A[19] = C[4] ^ ((~C[0]) & C[1]);
+			E[2] ^= D[2];
+			C[0] = ULong256::RotL64(E[2], 62);
+			E[8] ^= D[3];
+			C[1] = ULong256::RotL64(E[8], 55);
+			E[14] ^= D[4];
+			C[2] = ULong256::RotL64(E[14], 39);
+			E[15] ^= D[0];
+			C[3] = ULong256::RotL64(E[15], 41);
+			E[21] ^= D[1];
+			C[4] = ULong256::RotL64(E[21], 2);
+			A[20] = C[0] ^ ((~C[1]) & C[2]);
+			A[21] = C[1] ^ ((~C[2]) & C[3]);
+			A[22] = C[2] ^ ((~C[3]) & C[4]);
+			A[23] = C[3] ^ ((~C[4]) & C[0]);
+			A[24] = C[4] ^ ((~C[0]) & C[1]);
+		}
+
+		for (i = 0; i < 25; ++i)
+		{
+			A[i].Store(State, i * 4);
+		}
+	}
+
+	// the 48 round (extended) permutation of four interleaved states
+	void PermuteR48P4x1600(uint64_t* State)
+	{
+		std::array<ULong256, 25> A;
+		std::array<ULong256, 5> C;
+		std::array<ULong256, 5> D;
+		std::array<ULong256, 25> E;
+		size_t i;
+
+		for (i = 0; i < 25; ++i)
+		{
+			A[i] = ULong256(State, i * 4);
+		}
+
+		for (i = 0; i < 48; i += 2)
+		{
+			// round n
+			C[0] = A[0] ^ A[5] ^ A[10] ^ A[15] ^ A[20];
+			C[1] = A[1] ^ A[6] ^ A[11] ^ A[16] ^ A[21];
+			C[2] = A[2] ^ A[7] ^ A[12] ^ A[17] ^ A[22];
+			C[3] = A[3] ^ A[8] ^ A[13] ^ A[18] ^ A[23];
+			C[4] = A[4] ^ A[9] ^ A[14] ^ A[19] ^ A[24];
+			D[0] = C[4] ^ ULong256::RotL64(C[1], 1);
+			D[1] = C[0] ^ ULong256::RotL64(C[2], 1);
+			D[2] = C[1] ^ ULong256::RotL64(C[3], 1);
+			D[3] = C[2] ^ ULong256::RotL64(C[4], 1);
+			D[4] = C[3] ^ ULong256::RotL64(C[0], 1);
+			A[0] ^= D[0];
+			C[0] = A[0];
+			A[6] ^= D[1];
+			C[1] = ULong256::RotL64(A[6], 44);
+			A[12] ^= D[2];
+			C[2] = ULong256::RotL64(A[12], 43);
+			A[18] ^= D[3];
+			C[3] = ULong256::RotL64(A[18], 21);
+			A[24] ^= D[4];
+			C[4] = ULong256::RotL64(A[24], 14);
+			E[0] = C[0] ^ ((~C[1]) & C[2]);
+			E[0] ^= ULong256(KECCAK_RC48[i]);
+			E[1] = C[1] ^ ((~C[2]) & C[3]);
+			E[2] = C[2] ^ ((~C[3]) & C[4]);
+			E[3] = C[3] ^ ((~C[4]) & C[0]);
+			E[4] = C[4] ^ ((~C[0]) & C[1]);
+			A[3] ^= D[3];
+			C[0] = ULong256::RotL64(A[3], 28);
+			A[9] ^= D[4];
+			C[1] = ULong256::RotL64(A[9], 20);
+			A[10] ^= D[0];
+			C[2] = ULong256::RotL64(A[10], 3);
+			A[16] ^= D[1];
+			C[3] = ULong256::RotL64(A[16], 45);
+			A[22] ^= D[2];
+			C[4] = ULong256::RotL64(A[22], 61);
+			E[5] = C[0] ^ ((~C[1]) & C[2]);
+			E[6] = C[1] ^ ((~C[2]) & C[3]);
+			E[7] = C[2] ^ ((~C[3]) & C[4]);
+			E[8] = C[3] ^ ((~C[4]) & C[0]);
+			E[9] = C[4] ^ ((~C[0]) & C[1]);
+			A[1] ^= D[1];
+			C[0] = ULong256::RotL64(A[1], 1);
+			A[7] ^= D[2];
+			C[1] = ULong256::RotL64(A[7], 6);
+			A[13] ^= D[3];
+			C[2] = ULong256::RotL64(A[13], 25);
+			A[19] ^= D[4];
+			C[3] = ULong256::RotL64(A[19], 8);
+			A[20] ^= D[0];
+			C[4] = ULong256::RotL64(A[20], 18);
+			E[10] = C[0] ^ ((~C[1]) & C[2]);
+			E[11] = C[1] ^ ((~C[2]) & C[3]);
+			E[12] = C[2] ^ ((~C[3]) & C[4]);
+			E[13] = C[3] ^ ((~C[4]) & C[0]);
+			E[14] = C[4] ^ ((~C[0]) & C[1]);
+			A[4] ^= D[4];
+			C[0] = ULong256::RotL64(A[4], 27);
+			A[5] ^= D[0];
+			C[1] = ULong256::RotL64(A[5], 36);
+			A[11] ^= D[1];
+			C[2] = ULong256::RotL64(A[11], 10);
+			A[17] ^= D[2];
+			C[3] = ULong256::RotL64(A[17], 15);
+			A[23] ^= D[3];
+			C[4] = ULong256::RotL64(A[23], 56);
+			E[15] = C[0] ^ ((~C[1]) & C[2]);
+			E[16] = C[1] ^ ((~C[2]) & C[3]);
+			E[17] = C[2] ^ ((~C[3]) & C[4]);
+			E[18] = C[3] ^ ((~C[4]) & C[0]);
+			E[19] = C[4] ^ ((~C[0]) & C[1]);
+			A[2] ^= D[2];
+			C[0] = ULong256::RotL64(A[2], 62);
+			A[8] ^= D[3];
+			C[1] = ULong256::RotL64(A[8], 55);
+			A[14] ^= D[4];
+			C[2] = ULong256::RotL64(A[14], 39);
+			A[15] ^= D[0];
+			C[3] = ULong256::RotL64(A[15], 41);
+			A[21] ^= D[1];
+			C[4] = ULong256::RotL64(A[21], 2);
+			E[20] = C[0] ^ ((~C[1]) & C[2]);
+			E[21] = C[1] ^ ((~C[2]) & C[3]);
+			E[22] = C[2] ^ ((~C[3]) & C[4]);
+			E[23] = C[3] ^ ((~C[4]) & C[0]);
+			E[24] = C[4] ^ ((~C[0]) & C[1]);
+			// round n + 1
+			C[0] = E[0] ^ E[5] ^ E[10] ^ E[15] ^ E[20];
+			C[1] = E[1] ^ E[6] ^ E[11] ^ E[16] ^ E[21];
+			C[2] = E[2] ^ E[7] ^ E[12] ^ E[17] ^ E[22];
+			C[3] = E[3] ^ E[8] ^ E[13] ^ E[18] ^ E[23];
+			C[4] = E[4] ^ E[9] ^ E[14] ^ E[19] ^ E[24];
+			D[0] = C[4] ^ ULong256::RotL64(C[1], 1);
+			D[1] = C[0] ^ ULong256::RotL64(C[2], 1);
+			D[2] = C[1] ^ ULong256::RotL64(C[3], 1);
+			D[3] = C[2] ^ ULong256::RotL64(C[4], 1);
+			D[4] = C[3] ^ ULong256::RotL64(C[0], 1);
+			E[0] ^= D[0];
+			C[0] = E[0];
+			E[6] ^= D[1];
+			C[1] = ULong256::RotL64(E[6], 44);
+			E[12] ^= D[2];
+			C[2] = ULong256::RotL64(E[12], 43);
+			E[18] ^= D[3];
+			C[3] = ULong256::RotL64(E[18], 21);
+			E[24] ^= D[4];
+			C[4] = ULong256::RotL64(E[24], 14);
+			A[0] = C[0] ^ ((~C[1]) & C[2]);
+			A[0] ^= ULong256(KECCAK_RC48[i + 1]);
+			A[1] = C[1] ^ ((~C[2]) & C[3]);
+			A[2] = C[2] ^ ((~C[3]) & C[4]);
+			A[3] = C[3] ^ ((~C[4]) & C[0]);
+			A[4] = C[4] ^ ((~C[0]) & C[1]);
+			E[3] ^= D[3];
+			C[0] = ULong256::RotL64(E[3], 28);
+			E[9] ^= D[4];
+			C[1] = ULong256::RotL64(E[9], 20);
+			E[10] ^= D[0];
+			C[2] = ULong256::RotL64(E[10], 3);
+			E[16] ^= D[1];
+			C[3] = ULong256::RotL64(E[16], 45);
+			E[22] ^= D[2];
+			C[4] = ULong256::RotL64(E[22], 61);
+			A[5] = C[0] ^ ((~C[1]) & C[2]);
+			A[6] = C[1] ^ ((~C[2]) & C[3]);
+			A[7] = C[2] ^ ((~C[3]) & C[4]);
+			A[8] = C[3] ^ ((~C[4]) & C[0]);
+			A[9] = C[4] ^ ((~C[0]) & C[1]);
+			E[1] ^= D[1];
+			C[0] = ULong256::RotL64(E[1], 1);
+			E[7] ^= D[2];
+			C[1] = ULong256::RotL64(E[7], 6);
+			E[13] ^= D[3];
+			C[2] = ULong256::RotL64(E[13], 25);
+			E[19] ^= D[4];
+			C[3] = ULong256::RotL64(E[19], 8);
+			E[20] ^= D[0];
+			C[4] = ULong256::RotL64(E[20], 18);
+			A[10] = C[0] ^ ((~C[1]) & C[2]);
+			A[11] = C[1] ^ ((~C[2]) & C[3]);
+			A[12] = C[2] ^ ((~C[3]) & C[4]);
+			A[13] = C[3] ^ ((~C[4]) & C[0]);
+			A[14] = C[4] ^ ((~C[0]) & C[1]);
+			E[4] ^= D[4];
+			C[0] = ULong256::RotL64(E[4], 27);
+			E[5] ^= D[0];
+			C[1] = ULong256::RotL64(E[5], 36);
+			E[11] ^= D[1];
+			C[2] = ULong256::RotL64(E[11], 10);
+			E[17] ^= D[2];
+			C[3] = ULong256::RotL64(E[17], 15);
+			E[23] ^= D[3];
+			C[4] = ULong256::RotL64(E[23], 56);
+			A[15] = C[0] ^ ((~C[1]) & C[2]);
+			A[16] = C[1] ^ ((~C[2]) & C[3]);
+			A[17] = C[2] ^ ((~C[3]) & C[4]);
+			A[18] = C[3] ^ ((~C[4]) & C[0]);
+			A[19] = C[4] ^ ((~C[0]) & C[1]);
+			E[2] ^= D[2];
+			C[0] = ULong256::RotL64(E[2], 62);
+			E[8] ^= D[3];
+			C[1] = ULong256::RotL64(E[8], 55);
+			E[14] ^= D[4];
+			C[2] = ULong256::RotL64(E[14], 39);
+			E[15] ^= D[0];
+			C[3] = ULong256::RotL64(E[15], 41);
+			E[21] ^= D[1];
+			C[4] = ULong256::RotL64(E[21], 2);
+			A[20] = C[0] ^ ((~C[1]) & C[2]);
+			A[21] = C[1] ^ ((~C[2]) & C[3]);
+			A[22] = C[2] ^ ((~C[3]) & C[4]);
+			A[23] = C[3] ^ ((~C[4]) & C[0]);
+			A[24] = C[4] ^ ((~C[0]) & C[1]);
+		}
+
+		for (i = 0; i < 25; ++i)
+		{
+			A[i].Store(State, i * 4);
+		}
+	}
+
+	// absorb four equal length messages into four interleaved states, and add the padding
+	void AbsorbR24x1600(uint64_t* State, size_t Rate, const uint8_t* const* Input, size_t InputLength, uint8_t Domain)
+	{
+		uint64_t t;
+		size_t i;
+		size_t j;
+		size_t pos;
+
+		pos = 0;
+
+		while (InputLength >= Rate)
+		{
+			for (i = 0; i < Rate / sizeof(uint64_t); ++i)
+			{
+				for (j = 0; j < 4; ++j)
+				{
+					std::memcpy(&t, Input[j] + pos, sizeof(uint64_t));
+					State[(i * 4) + j] ^= t;
+				}
+
+				pos += sizeof(uint64_t);
+			}
+
+			PermuteR24P4x1600(State, 24);
+			InputLength -= Rate;
+		}
+
+		i = 0;
+
+		while (InputLength >= sizeof(uint64_t))
+		{
+			for (j = 0; j < 4; ++j)
+			{
+				std::memcpy(&t, Input[j] + pos, sizeof(uint64_t));
+				State[(i * 4) + j] ^= t;
+			}
+
+			++i;
+			pos += sizeof(uint64_t);
+			InputLength -= sizeof(uint64_t);
+		}
+
+		// the final partial word is read without touching the bytes past the end of each message
+		for (j = 0; j < 4; ++j)
+		{
+			t = 0;
+
+			if (InputLength != 0)
+			{
+				std::memcpy(&t, Input[j] + pos, InputLength);
+			}
+
+			State[(i * 4) + j] ^= t ^ (static_cast<uint64_t>(Domain) << (8 * InputLength));
+			State[(((Rate / sizeof(uint64_t)) - 1) * 4) + j] ^= 1ULL << 63;
+		}
+	}
+
+	// permute the four interleaved states and copy one rate block from each to the outputs
+	void SqueezeBlocksR24x1600(uint64_t* State, size_t Rate, uint8_t* const* Output, size_t Blocks)
+	{
+		size_t i;
+		size_t idx;
+		size_t j;
+
+		idx = 0;
+
+		while (Blocks > 0)
+		{
+			PermuteR24P4x1600(State, 24);
+
+			for (i = 0; i < Rate / sizeof(uint64_t); ++i)
+			{
+				for (j = 0; j < 4; ++j)
+				{
+					std::memcpy(Output[j] + idx, &State[(i * 4) + j], sizeof(uint64_t));
+				}
+
+				idx += sizeof(uint64_t);
+			}
+
+			--Blocks;
+		}
+	}
+}
+#else
+using Exception::CryptoDigestException;
+using Enumeration::ErrorCodes;
+#endif
+
+SimdProfiles KeccakKernels::Compiled()
+{
+	return HasAvx512() ? SimdProfiles::Simd512 :
+		HasAvx2() ? SimdProfiles::Simd256 :
+		SimdProfiles::None;
+}
+
+bool KeccakKernels::HasAvx2()
+{
+#if defined(CEX_HAS_AVX2)
+	return true;
+#else
+	return false;
+#endif
+}
+
+void KeccakKernels::AbsorbR24x1600H(uint64_t* State, size_t Rate, const uint8_t* Input0, const uint8_t* Input1, const uint8_t* Input2, const uint8_t* Input3, size_t InputLength, uint8_t Domain)
+{
+#if defined(CEX_HAS_AVX2)
+	const uint8_t* const INP[4] = { Input0, Input1, Input2, Input3 };
+
+	AbsorbR24x1600(State, Rate, INP, InputLength, Domain);
+#else
+	throw CryptoDigestException(std::string("KeccakKernels"), std::string("AbsorbR24x1600H"), std::string("The AVX2 kernel was not compiled!"), ErrorCodes::NotSupported);
+#endif
+}
+
+void KeccakKernels::PermuteR24P4x1600H(uint64_t* State, size_t Rounds)
+{
+#if defined(CEX_HAS_AVX2)
+	PermuteR24P4x1600(State, Rounds);
+#else
+	throw CryptoDigestException(std::string("KeccakKernels"), std::string("PermuteR24P4x1600H"), std::string("The AVX2 kernel was not compiled!"), ErrorCodes::NotSupported);
+#endif
+}
+
+void KeccakKernels::PermuteR48P4x1600H(uint64_t* State)
+{
+#if defined(CEX_HAS_AVX2)
+	PermuteR48P4x1600(State);
+#else
+	throw CryptoDigestException(std::string("KeccakKernels"), std::string("PermuteR48P4x1600H"), std::string("The AVX2 kernel was not compiled!"), ErrorCodes::NotSupported);
+#endif
+}
+
+void KeccakKernels::SqueezeBlocksR24x1600H(uint64_t* State, size_t Rate, uint8_t* Output0, uint8_t* Output1, uint8_t* Output2, uint8_t* Output3, size_t Blocks)
+{
+#if defined(CEX_HAS_AVX2)
+	uint8_t* const OTP[4] = { Output0, Output1, Output2, Output3 };
+
+	SqueezeBlocksR24x1600(State, Rate, OTP, Blocks);
+#else
+	throw CryptoDigestException(std::string("KeccakKernels"), std::string("SqueezeBlocksR24x1600H"), std::string("The AVX2 kernel was not compiled!"), ErrorCodes::NotSupported);
+#endif
+}
+
+NAMESPACE_DIGESTEND
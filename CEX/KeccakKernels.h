@@ -0,0 +1,74 @@
+#ifndef CEX_KECCAKKERNELS_H
+#define CEX_KECCAKKERNELS_H
+
+#include "CexDomain.h"
+#include "SimdProfiles.h"
+
+NAMESPACE_DIGEST
+
+using Enumeration::SimdProfiles;
+
+/// cond private
+
+/// <summary>
+/// Internal class: the wide Keccak permutations, each built in its own instruction set translation unit.
+/// <para>KeccakAvx2.cpp and KeccakAvx512.cpp are compiled with the AVX2 and AVX512 code generation flags respectively, and each holds its own permutations.
+/// The units are self-contained: the permutations, and the SIMD wrapper they are written with, have internal linkage, and the units include no shared header with instruction set branches.
+/// The states are interleaved 64-bit word arrays; word i of lane j is at State[(i * lanes) + j], so the four lane functions take 100 words and the eight lane functions take 200 words.
+/// A unit compiled without its instruction set reports the variant as absent, and its functions throw if called.
+/// Callers select a variant at run-time with SimdDispatch::Select(Compiled()).</para>
+/// </summary>
+class KeccakKernels final
+{
+public:
+
+	/// <summary>
+	/// The widest kernel variant compiled into the library
+	/// </summary>
+	static SimdProfiles Compiled();
+
+	/// <summary>
+	/// The AVX2 kernels were compiled
+	/// </summary>
+	static bool HasAvx2();
+
+	/// <summary>
+	/// The AVX512 kernels were compiled
+	/// </summary>
+	static bool HasAvx512();
+
+	/// <summary>
+	/// Absorb four equal length messages into four interleaved states, add the domain and final padding, using AVX2 instructions
+	/// </summary>
+	static void AbsorbR24x1600H(uint64_t* State, size_t Rate, const uint8_t* Input0, const uint8_t* Input1, const uint8_t* Input2, const uint8_t* Input3, size_t InputLength, uint8_t Domain);
+
+	/// <summary>
+	/// The 24 round (standard) permutation of four interleaved states using AVX2 instructions
+	/// </summary>
+	static void PermuteR24P4x1600H(uint64_t* State, size_t Rounds);
+
+	/// <summary>
+	/// The 48 round (extended) permutation of four interleaved states using AVX2 instructions
+	/// </summary>
+	static void PermuteR48P4x1600H(uint64_t* State);
+
+	/// <summary>
+	/// The 24 round (standard) permutation of eight interleaved states using AVX512 instructions
+	/// </summary>
+	static void PermuteR24P8x1600H(uint64_t* State, size_t Rounds);
+
+	/// <summary>
+	/// The 48 round (extended) permutation of eight interleaved states using AVX512 instructions
+	/// </summary>
+	static void PermuteR48P8x1600H(uint64_t* State);
+
+	/// <summary>
+	/// Permute four interleaved states and squeeze Blocks rate sized blocks into each output, using AVX2 instructions
+	/// </summary>
+	static void SqueezeBlocksR24x1600H(uint64_t* State, size_t Rate, uint8_t* Output0, uint8_t* Output1, uint8_t* Output2, uint8_t* Output3, size_t Blocks);
+};
+
+/// endcond
+
+NAMESPACE_DIGESTEND
+#endif
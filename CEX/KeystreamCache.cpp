@@ -0,0 +1,286 @@
+#include "KeystreamCache.h"
+#include "IntegerTools.h"
+#include "MemoryTools.h"
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+NAMESPACE_TOOLS
+
+class KeystreamCache::CacheState
+{
+public:
+
+	std::function<void(uint64_t, std::vector<uint8_t>&, size_t, size_t, size_t)> Generator;
+	std::vector<uint8_t> Ring;
+	std::vector<uint8_t> Scratch;
+	std::condition_variable Signal;
+	std::mutex Mutex;
+	std::thread Worker;
+	uint64_t Generation;
+	uint64_t Position;
+	size_t BlockSize;
+	size_t ChunkSize;
+	size_t Count;
+	size_t Head;
+	bool Running;
+
+	CacheState(size_t BlockLength, size_t Capacity, const std::function<void(uint64_t, std::vector<uint8_t>&, size_t, size_t, size_t)> &Function)
+		:
+		Generator(Function),
+		Ring(Capacity, 0x00),
+		Scratch(Capacity, 0x00),
+		Signal(),
+		Mutex(),
+		Worker(),
+		Generation(0),
+		Position(0),
+		BlockSize(BlockLength),
+		ChunkSize(Capacity / CHUNK_COUNT),
+		Count(0),
+		Head(0),
+		Running(false)
+	{
+	}
+
+	~CacheState()
+	{
+		MemoryTools::Clear(Ring, 0, Ring.size());
+		MemoryTools::Clear(Scratch, 0, Scratch.size());
+		Generation = 0;
+		Position = 0;
+		BlockSize = 0;
+		ChunkSize = 0;
+		Count = 0;
+		Head = 0;
+		Running = false;
+	}
+};
+
+//~~~Constructor~~~//
+
+KeystreamCache::KeystreamCache(size_t BlockSize, size_t Capacity, const std::function<void(uint64_t Position, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length, size_t Lane)> &Generator)
+	:
+	m_cacheState(new CacheState(BlockSize, Capacity, Generator))
+{
+	CEXASSERT(BlockSize != 0, "The block size can not be zero");
+	CEXASSERT(Capacity != 0 && Capacity % (CHUNK_COUNT * BlockSize) == 0, "The capacity must be a multiple of four blocks");
+}
+
+KeystreamCache::~KeystreamCache()
+{
+	Stop();
+}
+
+//~~~Accessors~~~//
+
+size_t KeystreamCache::Available()
+{
+	std::lock_guard<std::mutex> lock(m_cacheState->Mutex);
+
+	return m_cacheState->Count;
+}
+
+size_t KeystreamCache::Capacity() const
+{
+	return m_cacheState->Ring.size();
+}
+
+bool KeystreamCache::IsRunning()
+{
+	std::lock_guard<std::mutex> lock(m_cacheState->Mutex);
+
+	return m_cacheState->Running;
+}
+
+uint64_t KeystreamCache::Position()
+{
+	std::lock_guard<std::mutex> lock(m_cacheState->Mutex);
+
+	return m_cacheState->Position;
+}
+
+//~~~Public Functions~~~//
+
+void KeystreamCache::Reset(uint64_t Position)
+{
+	CEXASSERT(Position % m_cacheState->BlockSize == 0, "The position must be block aligned");
+
+	std::lock_guard<std::mutex> lock(m_cacheState->Mutex);
+	const size_t FSTLEN = IntegerTools::Min(m_cacheState->Count, m_cacheState->Ring.size() - m_cacheState->Head);
+
+	// erase the cached bytes; a chunk being generated for the old position is discarded by the worker
+	++m_cacheState->Generation;
+	MemoryTools::Clear(m_cacheState->Ring, m_cacheState->Head, FSTLEN);
+
+	if (m_cacheState->Count != FSTLEN)
+	{
+		MemoryTools::Clear(m_cacheState->Ring, 0, m_cacheState->Count - FSTLEN);
+	}
+
+	m_cacheState->Position = Position;
+	m_cacheState->Count = 0;
+	m_cacheState->Head = 0;
+	m_cacheState->Signal.notify_all();
+}
+
+void KeystreamCache::Start(uint64_t Position)
+{
+	Stop();
+	Reset(Position);
+
+	{
+		std::lock_guard<std::mutex> lock(m_cacheState->Mutex);
+		m_cacheState->Running = true;
+	}
+
+	m_cacheState->Worker = std::thread([this]() { this->Worker(); });
+}
+
+void KeystreamCache::Stop()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_cacheState->Mutex);
+		m_cacheState->Running = false;
+		m_cacheState->Signal.notify_all();
+	}
+
+	if (m_cacheState->Worker.joinable())
+	{
+		m_cacheState->Worker.join();
+	}
+
+	std::lock_guard<std::mutex> lock(m_cacheState->Mutex);
+	MemoryTools::Clear(m_cacheState->Ring, 0, m_cacheState->Ring.size());
+	m_cacheState->Count = 0;
+	m_cacheState->Head = 0;
+}
+
+void KeystreamCache::Transform(const uint8_t* Input, uint8_t* Output, size_t Length)
+{
+	const size_t RNGLEN = m_cacheState->Ring.size();
+	uint64_t stmpos;
+	size_t oft;
+	size_t prclen;
+	size_t rmdlen;
+	size_t xorlen;
+
+	// the message is combined with the key-stream in one pass; a null input writes the bare key-stream
+	auto apply = [Input, Output](const uint8_t* Key, size_t Offset, size_t Count)
+	{
+		if (Input != nullptr)
+		{
+			MemoryTools::XorRaw(Input + Offset, Key, Output + Offset, Count);
+		}
+		else
+		{
+			MemoryTools::CopyRaw(Key, Output + Offset, Count);
+		}
+	};
+
+	if (Length != 0)
+	{
+		std::unique_lock<std::mutex> lock(m_cacheState->Mutex);
+
+		// whole blocks are consumed; the tail of a partial last block is discarded
+		rmdlen = Length + ((m_cacheState->BlockSize - (Length % m_cacheState->BlockSize)) % m_cacheState->BlockSize);
+		oft = 0;
+
+		while (rmdlen != 0)
+		{
+			CEXASSERT(m_cacheState->Running, "The cache worker is not running");
+
+			if (m_cacheState->Count == 0)
+			{
+				// on an underrun the remainder is generated on the callers thread rather than waiting on the worker;
+				// the span is claimed here, the worker chunk in progress is discarded, and generation resumes after this message
+				++m_cacheState->Generation;
+				m_cacheState->Head = 0;
+				break;
+			}
+			else
+			{
+				// the cached bytes wrap at the end of the ring
+				prclen = IntegerTools::Min(IntegerTools::Min(m_cacheState->Count, rmdlen), RNGLEN - m_cacheState->Head);
+				xorlen = IntegerTools::Min(prclen, Length - oft);
+
+				if (xorlen != 0)
+				{
+					apply(m_cacheState->Ring.data() + m_cacheState->Head, oft, xorlen);
+				}
+
+				MemoryTools::Clear(m_cacheState->Ring, m_cacheState->Head, prclen);
+				m_cacheState->Head = (m_cacheState->Head + prclen) % RNGLEN;
+				m_cacheState->Count -= prclen;
+				m_cacheState->Position += prclen;
+				oft += xorlen;
+				rmdlen -= prclen;
+			}
+		}
+
+		stmpos = m_cacheState->Position;
+		m_cacheState->Position += rmdlen;
+		m_cacheState->Signal.notify_all();
+		lock.unlock();
+
+		// the claimed span is generated outside the lock, so the worker refills the ring from the new position meanwhile
+		if (rmdlen != 0)
+		{
+			const size_t SCRLEN = m_cacheState->Scratch.size();
+			const size_t CLRLEN = IntegerTools::Min(SCRLEN, rmdlen);
+
+			while (rmdlen != 0)
+			{
+				prclen = IntegerTools::Min(SCRLEN, rmdlen);
+				xorlen = IntegerTools::Min(prclen, Length - oft);
+				m_cacheState->Generator(stmpos, m_cacheState->Scratch, 0, prclen, 1);
+
+				if (xorlen != 0)
+				{
+					apply(m_cacheState->Scratch.data(), oft, xorlen);
+				}
+
+				stmpos += prclen;
+				oft += xorlen;
+				rmdlen -= prclen;
+			}
+
+			MemoryTools::Clear(m_cacheState->Scratch, 0, CLRLEN);
+		}
+	}
+}
+
+//~~~Private Functions~~~//
+
+void KeystreamCache::Worker()
+{
+	const size_t RNGLEN = m_cacheState->Ring.size();
+	std::unique_lock<std::mutex> lock(m_cacheState->Mutex);
+
+	while (m_cacheState->Running)
+	{
+		m_cacheState->Signal.wait(lock, [this, RNGLEN]() { return !m_cacheState->Running || RNGLEN - m_cacheState->Count >= m_cacheState->ChunkSize; });
+
+		if (!m_cacheState->Running)
+		{
+			break;
+		}
+
+		// the free region after the cached bytes is chunk aligned, and is not read until the chunk is committed
+		const uint64_t GENCTR = m_cacheState->Generation;
+		const uint64_t STMPOS = m_cacheState->Position + m_cacheState->Count;
+		const size_t RNGOFT = (m_cacheState->Head + m_cacheState->Count) % RNGLEN;
+
+		lock.unlock();
+		m_cacheState->Generator(STMPOS, m_cacheState->Ring, RNGOFT, m_cacheState->ChunkSize, 0);
+		lock.lock();
+
+		if (GENCTR == m_cacheState->Generation)
+		{
+			m_cacheState->Count += m_cacheState->ChunkSize;
+			m_cacheState->Signal.notify_all();
+		}
+	}
+}
+
+NAMESPACE_TOOLSEND
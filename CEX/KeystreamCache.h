@@ -0,0 +1,132 @@
+#ifndef CEX_KEYSTREAMCACHE_H
+#define CEX_KEYSTREAMCACHE_H
+
+#include "CexDomain.h"
+#include <functional>
+
+NAMESPACE_TOOLS
+
+/// cond private
+
+/// <summary>
+/// Internal class: a bounded ring of precomputed key-stream, filled ahead of use by a background worker thread.
+/// <para>The owning cipher supplies a generator that writes the key-stream at an absolute, block aligned stream position.
+/// The worker fills the ring in chunks of a quarter of its capacity while there is room, and a Transform call XORs the message with the oldest cached bytes;
+/// the key-stream of a short message is then read from memory instead of being generated on the callers thread. \n
+/// The ring is consumed in whole blocks, so a message that is not block aligned discards the remainder of its last block, as the cipher transform does.
+/// If the cache runs dry, the rest of the message key-stream is generated on the callers thread rather than waiting on the worker;
+/// it is written to a scratch buffer allocated with the ring, after the lock is released, so the worker refills the ring at the same time. \n
+/// Consumed key-stream is erased from the ring. Reset discards the contents and restarts generation at a new position;
+/// Stop joins the worker, and must be called before the cipher key or state used by the generator is changed.</para>
+/// </summary>
+class KeystreamCache final
+{
+private:
+
+	static const size_t CHUNK_COUNT = 4;
+
+	class CacheState;
+	std::unique_ptr<CacheState> m_cacheState;
+
+public:
+
+	/// <summary>
+	/// The number of threads that may call the generator at once; the worker is lane 0, and the thread calling Transform is lane 1
+	/// </summary>
+	static const size_t LANE_COUNT = 2;
+
+	//~~~Constructor~~~//
+
+	/// <summary>
+	/// Copy constructor: copy is restricted, this function has been deleted
+	/// </summary>
+	KeystreamCache(const KeystreamCache&) = delete;
+
+	/// <summary>
+	/// Copy operator: copy is restricted, this function has been deleted
+	/// </summary>
+	KeystreamCache& operator=(const KeystreamCache&) = delete;
+
+	/// <summary>
+	/// Default constructor: default is restricted, this function has been deleted
+	/// </summary>
+	KeystreamCache() = delete;
+
+	/// <summary>
+	/// Constructor: instantiate a stopped cache
+	/// </summary>
+	///
+	/// <param name="BlockSize">The cipher block size in bytes</param>
+	/// <param name="Capacity">The ring size in bytes; a multiple of four blocks</param>
+	/// <param name="Generator">Writes Length bytes of key-stream, starting at the block aligned stream position, to the output vector at the offset.
+	/// The two lanes can run concurrently, so any scratch state the generator keeps must be held per lane.</param>
+	KeystreamCache(size_t BlockSize, size_t Capacity, const std::function<void(uint64_t Position, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length, size_t Lane)> &Generator);
+
+	/// <summary>
+	/// Destructor: stop the worker and erase the ring
+	/// </summary>
+	~KeystreamCache();
+
+	//~~~Accessors~~~//
+
+	/// <summary>
+	/// The number of cached key-stream bytes ready for use
+	/// </summary>
+	size_t Available();
+
+	/// <summary>
+	/// The ring size in bytes
+	/// </summary>
+	size_t Capacity() const;
+
+	/// <summary>
+	/// The background worker is running
+	/// </summary>
+	bool IsRunning();
+
+	/// <summary>
+	/// The stream position of the next key-stream byte to be consumed
+	/// </summary>
+	uint64_t Position();
+
+	//~~~Public Functions~~~//
+
+	/// <summary>
+	/// Discard the cached key-stream and continue generation from a new block aligned position
+	/// </summary>
+	///
+	/// <param name="Position">The stream position of the next key-stream byte</param>
+	void Reset(uint64_t Position);
+
+	/// <summary>
+	/// Start the background worker at a block aligned position; a running worker is stopped first
+	/// </summary>
+	///
+	/// <param name="Position">The stream position of the first key-stream byte</param>
+	void Start(uint64_t Position);
+
+	/// <summary>
+	/// Stop the background worker and erase the ring; the position is retained
+	/// </summary>
+	void Stop();
+
+	/// <summary>
+	/// XOR a message with the cached key-stream; if the cache runs dry, the remainder is generated on the calling thread.
+	/// <para>The worker must be running. The key-stream consumed is the length rounded up to the block size.
+	/// Output is written as Input ^ key-stream in a single pass, and may be the same address as Input; a null Input writes the bare key-stream.</para>
+	/// </summary>
+	///
+	/// <param name="Input">The input bytes, or null</param>
+	/// <param name="Output">The output bytes</param>
+	/// <param name="Length">The number of bytes to transform</param>
+	void Transform(const uint8_t* Input, uint8_t* Output, size_t Length);
+
+private:
+
+	void Worker();
+};
+
+/// endcond
+
+NAMESPACE_TOOLSEND
+#endif
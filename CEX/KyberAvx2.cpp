@@ -0,0 +1,892 @@
+#include "KyberKernels.h"
+#if defined(CEX_HAS_AVX2)
+#	include "Intrinsics.h"
+#else
+#	include "CryptoAsymmetricException.h"
+#endif
+
+NAMESPACE_KYBER
+
+// this unit is compiled with the AVX2 code generation flag; it includes no shared header with instruction set branches,
+// and the polynomial routines have internal linkage, so no inline code compiled here can be linked into another unit
+
+#if defined(CEX_HAS_AVX2)
+namespace
+{
+	const size_t KYBER_N = 256;
+	const int32_t KYBER_Q = 3329;
+	const int32_t AVX_REJ_UNIFORM_BUFLEN = 504;
+
+	void Cbd2(int16_t* R, const uint8_t* Buf)
+	{
+		__m256i f0;
+		__m256i f1;
+		__m256i f2;
+		__m256i f3;
+		const __m256i mask55 = _mm256_set1_epi32(0x55555555);
+		const __m256i mask33 = _mm256_set1_epi32(0x33333333);
+		const __m256i mask03 = _mm256_set1_epi32(0x03030303);
+		const __m256i mask0F = _mm256_set1_epi32(0x0F0F0F0F);
+
+		for (size_t i = 0; i < KYBER_N / 64; ++i)
+		{
+			f0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&Buf[32 * i]));
+
+			f1 = _mm256_srli_epi16(f0, 1);
+			f0 = _mm256_and_si256(mask55, f0);
+			f1 = _mm256_and_si256(mask55, f1);
+			f0 = _mm256_add_epi8(f0, f1);
+
+			f1 = _mm256_srli_epi16(f0, 2);
+			f0 = _mm256_and_si256(mask33, f0);
+			f1 = _mm256_and_si256(mask33, f1);
+			f0 = _mm256_add_epi8(f0, mask33);
+			f0 = _mm256_sub_epi8(f0, f1);
+
+			f1 = _mm256_srli_epi16(f0, 4);
+			f0 = _mm256_and_si256(mask0F, f0);
+			f1 = _mm256_and_si256(mask0F, f1);
+			f0 = _mm256_sub_epi8(f0, mask03);
+			f1 = _mm256_sub_epi8(f1, mask03);
+
+			f2 = _mm256_unpacklo_epi8(f0, f1);
+			f3 = _mm256_unpackhi_epi8(f0, f1);
+
+			f0 = _mm256_cvtepi8_epi16(_mm256_castsi256_si128(f2));
+			f1 = _mm256_cvtepi8_epi16(_mm256_extracti128_si256(f2, 1));
+			f2 = _mm256_cvtepi8_epi16(_mm256_castsi256_si128(f3));
+			f3 = _mm256_cvtepi8_epi16(_mm256_extracti128_si256(f3, 1));
+
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(&R[64 * i]), f0);
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(&R[(64 * i) + 16]), f2);
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(&R[(64 * i) + 32]), f1);
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(&R[(64 * i) + 48]), f3);
+		}
+	}
+
+	void Cbd3(int16_t* R, const uint8_t* Buf)
+	{
+		const __m256i mask249 = _mm256_set1_epi32(0x249249);
+		const __m256i mask6DB = _mm256_set1_epi32(0x6DB6DB);
+		const __m256i mask07 = _mm256_set1_epi32(7);
+		const __m256i mask70 = _mm256_set1_epi32(7 << 16);
+		const __m256i mask3 = _mm256_set1_epi16(3);
+		const __m256i shufbidx = _mm256_set_epi8(-1, 15, 14, 13, -1, 12, 11, 10, -1, 9, 8, 7, -1, 6, 5, 4,
+			-1, 11, 10, 9, -1, 8, 7, 6, -1, 5, 4, 3, -1, 2, 1, 0);
+		__m256i f0;
+		__m256i f1;
+		__m256i f2;
+		__m256i f3;
+		size_t i;
+
+		for (i = 0; i < KYBER_N / 32; ++i)
+		{
+			f0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&Buf[24 * i]));
+			f0 = _mm256_permute4x64_epi64(f0, 0x94);
+			f0 = _mm256_shuffle_epi8(f0, shufbidx);
+
+			f1 = _mm256_srli_epi32(f0, 1);
+			f2 = _mm256_srli_epi32(f0, 2);
+			f0 = _mm256_and_si256(mask249, f0);
+			f1 = _mm256_and_si256(mask249, f1);
+			f2 = _mm256_and_si256(mask249, f2);
+			f0 = _mm256_add_epi32(f0, f1);
+			f0 = _mm256_add_epi32(f0, f2);
+
+			f1 = _mm256_srli_epi32(f0, 3);
+			f0 = _mm256_add_epi32(f0, mask6DB);
+			f0 = _mm256_sub_epi32(f0, f1);
+
+			f1 = _mm256_slli_epi32(f0, 10);
+			f2 = _mm256_srli_epi32(f0, 12);
+			f3 = _mm256_srli_epi32(f0, 2);
+			f0 = _mm256_and_si256(f0, mask07);
+			f1 = _mm256_and_si256(f1, mask70);
+			f2 = _mm256_and_si256(f2, mask07);
+			f3 = _mm256_and_si256(f3, mask70);
+			f0 = _mm256_add_epi16(f0, f1);
+			f1 = _mm256_add_epi16(f2, f3);
+			f0 = _mm256_sub_epi16(f0, mask3);
+			f1 = _mm256_sub_epi16(f1, mask3);
+
+			f2 = _mm256_unpacklo_epi32(f0, f1);
+			f3 = _mm256_unpackhi_epi32(f0, f1);
+
+			f0 = _mm256_permute2x128_si256(f2, f3, 0x20);
+			f1 = _mm256_permute2x128_si256(f2, f3, 0x31);
+
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(&R[32 * i]), f0);
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(&R[(32 * i) + 16]), f1);
+		}
+	}
+
+	void PolyCompressP128(uint8_t* R, const int16_t* A)
+	{
+		const __m256i v = _mm256_set1_epi16(20159);
+		const __m256i shift1 = _mm256_set1_epi16(1 << 9);
+		const __m256i mask = _mm256_set1_epi16(15);
+		const __m256i shift2 = _mm256_set1_epi16((16 << 8) + 1);
+		const __m256i permdidx = _mm256_set_epi32(7, 3, 6, 2, 5, 1, 4, 0);
+		__m256i f0;
+		__m256i f1;
+		__m256i f2;
+		__m256i f3;
+
+		for (size_t i = 0; i < KYBER_N / 64; ++i)
+		{
+			f0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&A[64 * i]));
+			f1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&A[(64 * i) + 16]));
+			f2 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&A[(64 * i) + 32]));
+			f3 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&A[(64 * i) + 48]));
+			f0 = _mm256_mulhi_epi16(f0, v);
+			f1 = _mm256_mulhi_epi16(f1, v);
+			f2 = _mm256_mulhi_epi16(f2, v);
+			f3 = _mm256_mulhi_epi16(f3, v);
+			f0 = _mm256_mulhrs_epi16(f0, shift1);
+			f1 = _mm256_mulhrs_epi16(f1, shift1);
+			f2 = _mm256_mulhrs_epi16(f2, shift1);
+			f3 = _mm256_mulhrs_epi16(f3, shift1);
+			f0 = _mm256_and_si256(f0, mask);
+			f1 = _mm256_and_si256(f1, mask);
+			f2 = _mm256_and_si256(f2, mask);
+			f3 = _mm256_and_si256(f3, mask);
+			f0 = _mm256_packus_epi16(f0, f1);
+			f2 = _mm256_packus_epi16(f2, f3);
+			f0 = _mm256_maddubs_epi16(f0, shift2);
+			f2 = _mm256_maddubs_epi16(f2, shift2);
+			f0 = _mm256_packus_epi16(f0, f2);
+			f0 = _mm256_permutevar8x32_epi32(f0, permdidx);
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(&R[32 * i]), f0);
+		}
+	}
+
+	void PolyDecompressP128(int16_t* R, const uint8_t* A)
+	{
+		const __m256i q = _mm256_set1_epi16(KYBER_Q);
+		const __m256i shufbidx = _mm256_set_epi8(7, 7, 7, 7, 6, 6, 6, 6, 5, 5, 5, 5, 4, 4, 4, 4,
+			3, 3, 3, 3, 2, 2, 2, 2, 1, 1, 1, 1, 0, 0, 0, 0);
+		const __m256i mask = _mm256_set1_epi32(0x00F0000F);
+		const __m256i shift = _mm256_set1_epi32((128 << 16) + 2048);
+		__m256i f;
+
+		for (size_t i = 0; i < KYBER_N / 16; ++i)
+		{
+			f = _mm256_broadcastq_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(&A[8 * i])));
+			f = _mm256_shuffle_epi8(f, shufbidx);
+			f = _mm256_and_si256(f, mask);
+			f = _mm256_mullo_epi16(f, shift);
+			f = _mm256_mulhrs_epi16(f, q);
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(&R[16 * i]), f);
+		}
+	}
+
+	void PolyCompressP160(uint8_t* R, const int16_t* A)
+	{
+		const __m256i v = _mm256_set1_epi16(20159);
+		const __m256i shift1 = _mm256_set1_epi16(1 << 10);
+		const __m256i mask = _mm256_set1_epi16(31);
+		const __m256i shift2 = _mm256_set1_epi16((32 << 8) + 1);
+		const __m256i shift3 = _mm256_set1_epi32((1024 << 16) + 1);
+		const __m256i sllvdidx = _mm256_set1_epi64x(12);
+		const __m256i shufbidx = _mm256_set_epi8(8, -1, -1, -1, -1, -1, 4, 3, 2, 1, 0, -1, 12, 11, 10, 9,
+			-1, 12, 11, 10, 9, 8, -1, -1, -1, -1, -1, 4, 3, 2, 1, 0);
+		__m256i f0;
+		__m256i f1;
+		__m128i t0;
+		__m128i t1;
+
+		for (size_t i = 0; i < KYBER_N / 32; ++i)
+		{
+			f0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&A[32 * i]));
+			f1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&A[(32 * i) + 16]));
+			f0 = _mm256_mulhi_epi16(f0, v);
+			f1 = _mm256_mulhi_epi16(f1, v);
+			f0 = _mm256_mulhrs_epi16(f0, shift1);
+			f1 = _mm256_mulhrs_epi16(f1, shift1);
+			f0 = _mm256_and_si256(f0, mask);
+			f1 = _mm256_and_si256(f1, mask);
+			f0 = _mm256_packus_epi16(f0, f1);
+			f0 = _mm256_maddubs_epi16(f0, shift2);
+			f0 = _mm256_madd_epi16(f0, shift3);
+			f0 = _mm256_sllv_epi32(f0, sllvdidx);
+			f0 = _mm256_srlv_epi64(f0, sllvdidx);
+			f0 = _mm256_shuffle_epi8(f0, shufbidx);
+			t0 = _mm256_castsi256_si128(f0);
+			t1 = _mm256_extracti128_si256(f0, 1);
+			t0 = _mm_blendv_epi8(t0, t1, _mm256_castsi256_si128(shufbidx));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(&R[20 * i]), t0);
+			_mm_store_ss(reinterpret_cast<float*>(&R[(20 * i) + 16]), _mm_castsi128_ps(t1));
+		}
+	}
+
+	void PolyDecompressP160(int16_t* R, const uint8_t* A)
+	{
+		const __m256i q = _mm256_set1_epi16(KYBER_Q);
+		const __m256i shufbidx = _mm256_set_epi8(9, 9, 9, 8, 8, 8, 8, 7, 7, 6, 6, 6, 6, 5, 5, 5,
+			4, 4, 4, 3, 3, 3, 3, 2, 2, 1, 1, 1, 1, 0, 0, 0);
+		const __m256i mask = _mm256_set_epi16(248, 1984, 62, 496, 3968, 124, 992, 31,
+			248, 1984, 62, 496, 3968, 124, 992, 31);
+		const __m256i shift = _mm256_set_epi16(128, 16, 512, 64, 8, 256, 32, 1024,
+			128, 16, 512, 64, 8, 256, 32, 1024);
+		__m256i f;
+
+		for (size_t i = 0; i < KYBER_N / 16; ++i)
+		{
+			f = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&A[10 * i])));
+			f = _mm256_shuffle_epi8(f, shufbidx);
+			f = _mm256_and_si256(f, mask);
+			f = _mm256_mullo_epi16(f, shift);
+			f = _mm256_mulhrs_epi16(f, q);
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(&R[16 * i]), f);
+		}
+	}
+
+	void PolyFromMsg(int16_t* R, const uint8_t* Msg)
+	{
+		const __m256i shift = _mm256_broadcastsi128_si256(_mm_set_epi32(0, 1, 2, 3));
+		const __m256i idx = _mm256_broadcastsi128_si256(_mm_set_epi8(15, 14, 11, 10, 7, 6, 3, 2, 13, 12, 9, 8, 5, 4, 1, 0));
+		const __m256i hqs = _mm256_set1_epi16((KYBER_Q + 1) / 2);
+		__m256i f;
+		__m256i g0;
+		__m256i g1;
+		__m256i g2;
+		__m256i g3;
+		__m256i h0;
+		__m256i h1;
+		__m256i h2;
+		__m256i h3;
+
+		f = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(Msg));
+		g3 = _mm256_shuffle_epi32(f, 0);
+		g3 = _mm256_sllv_epi32(g3, shift);
+		g3 = _mm256_shuffle_epi8(g3, idx);
+		g0 = _mm256_slli_epi16(g3, 12);
+		g1 = _mm256_slli_epi16(g3, 8);
+		g2 = _mm256_slli_epi16(g3, 4);
+		g0 = _mm256_srai_epi16(g0, 15);
+		g1 = _mm256_srai_epi16(g1, 15);
+		g2 = _mm256_srai_epi16(g2, 15);
+		g3 = _mm256_srai_epi16(g3, 15);
+		g0 = _mm256_and_si256(g0, hqs);  /* 19 18 17 16  3  2  1  0 */
+		g1 = _mm256_and_si256(g1, hqs);  /* 23 22 21 20  7  6  5  4 */
+		g2 = _mm256_and_si256(g2, hqs);  /* 27 26 25 24 11 10  9  8 */
+		g3 = _mm256_and_si256(g3, hqs);  /* 31 30 29 28 15 14 13 12 */
+		h0 = _mm256_unpacklo_epi64(g0, g1);
+		h2 = _mm256_unpackhi_epi64(g0, g1);
+		h1 = _mm256_unpacklo_epi64(g2, g3);
+		h3 = _mm256_unpackhi_epi64(g2, g3);
+		g0 = _mm256_permute2x128_si256(h0, h1, 0x20);
+		g2 = _mm256_permute2x128_si256(h0, h1, 0x31);
+		g1 = _mm256_permute2x128_si256(h2, h3, 0x20);
+		g3 = _mm256_permute2x128_si256(h2, h3, 0x31);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(&R[0]), g0);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(&R[16]), g1);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(&R[128]), g2);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(&R[128 + 16]), g3);
+
+		g3 = _mm256_shuffle_epi32(f, 0x55 * 1);
+		g3 = _mm256_sllv_epi32(g3, shift);
+		g3 = _mm256_shuffle_epi8(g3, idx);
+		g0 = _mm256_slli_epi16(g3, 12);
+		g1 = _mm256_slli_epi16(g3, 8);
+		g2 = _mm256_slli_epi16(g3, 4);
+		g0 = _mm256_srai_epi16(g0, 15);
+		g1 = _mm256_srai_epi16(g1, 15);
+		g2 = _mm256_srai_epi16(g2, 15);
+		g3 = _mm256_srai_epi16(g3, 15);
+		g0 = _mm256_and_si256(g0, hqs);
+		g1 = _mm256_and_si256(g1, hqs);
+		g2 = _mm256_and_si256(g2, hqs);
+		g3 = _mm256_and_si256(g3, hqs);
+		h0 = _mm256_unpacklo_epi64(g0, g1);
+		h2 = _mm256_unpackhi_epi64(g0, g1);
+		h1 = _mm256_unpacklo_epi64(g2, g3);
+		h3 = _mm256_unpackhi_epi64(g2, g3);
+		g0 = _mm256_permute2x128_si256(h0, h1, 0x20);
+		g2 = _mm256_permute2x128_si256(h0, h1, 0x31);
+		g1 = _mm256_permute2x128_si256(h2, h3, 0x20);
+		g3 = _mm256_permute2x128_si256(h2, h3, 0x31);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(&R[32]), g0);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(&R[32 + 16]), g1);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(&R[128 + 32]), g2);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(&R[128 + 32 + 16]), g3);
+
+		g3 = _mm256_shuffle_epi32(f, 0x55 * 2);
+		g3 = _mm256_sllv_epi32(g3, shift);
+		g3 = _mm256_shuffle_epi8(g3, idx);
+		g0 = _mm256_slli_epi16(g3, 12);
+		g1 = _mm256_slli_epi16(g3, 8);
+		g2 = _mm256_slli_epi16(g3, 4);
+		g0 = _mm256_srai_epi16(g0, 15);
+		g1 = _mm256_srai_epi16(g1, 15);
+		g2 = _mm256_srai_epi16(g2, 15);
+		g3 = _mm256_srai_epi16(g3, 15);
+		g0 = _mm256_and_si256(g0, hqs);
+		g1 = _mm256_and_si256(g1, hqs);
+		g2 = _mm256_and_si256(g2, hqs);
+		g3 = _mm256_and_si256(g3, hqs);
+		h0 = _mm256_unpacklo_epi64(g0, g1);
+		h2 = _mm256_unpackhi_epi64(g0, g1);
+		h1 = _mm256_unpacklo_epi64(g2, g3);
+		h3 = _mm256_unpackhi_epi64(g2, g3);
+		g0 = _mm256_permute2x128_si256(h0, h1, 0x20);
+		g2 = _mm256_permute2x128_si256(h0, h1, 0x31);
+		g1 = _mm256_permute2x128_si256(h2, h3, 0x20);
+		g3 = _mm256_permute2x128_si256(h2, h3, 0x31);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(&R[32 * 2]), g0);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(&R[(32 * 2) + 16]), g1);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(&R[128 + (32 * 2)]), g2);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(&R[128 + (32 * 2) + 16]), g3);
+
+		g3 = _mm256_shuffle_epi32(f, 0x55 * 3);
+		g3 = _mm256_sllv_epi32(g3, shift);
+		g3 = _mm256_shuffle_epi8(g3, idx);
+		g0 = _mm256_slli_epi16(g3, 12);
+		g1 = _mm256_slli_epi16(g3, 8);
+		g2 = _mm256_slli_epi16(g3, 4);
+		g0 = _mm256_srai_epi16(g0, 15);
+		g1 = _mm256_srai_epi16(g1, 15);
+		g2 = _mm256_srai_epi16(g2, 15);
+		g3 = _mm256_srai_epi16(g3, 15);
+		g0 = _mm256_and_si256(g0, hqs);
+		g1 = _mm256_and_si256(g1, hqs);
+		g2 = _mm256_and_si256(g2, hqs);
+		g3 = _mm256_and_si256(g3, hqs);
+		h0 = _mm256_unpacklo_epi64(g0, g1);
+		h2 = _mm256_unpackhi_epi64(g0, g1);
+		h1 = _mm256_unpacklo_epi64(g2, g3);
+		h3 = _mm256_unpackhi_epi64(g2, g3);
+		g0 = _mm256_permute2x128_si256(h0, h1, 0x20);
+		g2 = _mm256_permute2x128_si256(h0, h1, 0x31);
+		g1 = _mm256_permute2x128_si256(h2, h3, 0x20);
+		g3 = _mm256_permute2x128_si256(h2, h3, 0x31);
+
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(&R[32 * 3]), g0);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(&R[(32 * 3) + 16]), g1);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(&R[128 + (32 * 3)]), g2);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(&R[128 + (32 * 3) + 16]), g3);
+	}
+
+	void PolyAdd(int16_t* R, const int16_t* A, const int16_t* B)
+	{
+		__m256i f0;
+		__m256i f1;
+
+		for (size_t i = 0; i < KYBER_N; i += 16)
+		{
+			f0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&A[i]));
+			f1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&B[i]));
+			f0 = _mm256_add_epi16(f0, f1);
+
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(&R[i]), f0);
+		}
+	}
+
+	void PolySub(int16_t* R, const int16_t* A, const int16_t* B)
+	{
+		__m256i f0;
+		__m256i f1;
+
+		for (size_t i = 0; i < KYBER_N; i += 16)
+		{
+			f0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&A[i]));
+			f1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&B[i]));
+			f0 = _mm256_sub_epi16(f0, f1);
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(&R[i]), f0);
+		}
+	}
+
+	void PolyDecompress10P320(int16_t* R, const uint8_t* A)
+	{
+		const __m256i q = _mm256_set1_epi32((KYBER_Q << 16) + 4 * KYBER_Q);
+		const __m256i shufbidx = _mm256_set_epi8(11, 10, 10, 9, 9, 8, 8, 7,
+			6, 5, 5, 4, 4, 3, 3, 2, 9, 8, 8, 7, 7, 6, 6, 5, 4, 3, 3, 2, 2, 1, 1, 0);
+		const __m256i sllvdidx = _mm256_set1_epi64x(4);
+		const __m256i mask = _mm256_set1_epi32((32736 << 16) + 8184);
+		__m256i f;
+
+		for (size_t i = 0; i < KYBER_N / 16; ++i)
+		{
+			f = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&A[20 * i]));
+			f = _mm256_permute4x64_epi64(f, 0x94);
+			f = _mm256_shuffle_epi8(f, shufbidx);
+			f = _mm256_sllv_epi32(f, sllvdidx);
+			f = _mm256_srli_epi16(f, 1);
+			f = _mm256_and_si256(f, mask);
+			f = _mm256_mulhrs_epi16(f, q);
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(&R[16 * i]), f);
+		}
+	}
+
+	void PolyDecompress11P352(int16_t* R, const uint8_t* A)
+	{
+		const __m256i q = _mm256_set1_epi16(KYBER_Q);
+		const __m256i shufbidx = _mm256_set_epi8(13, 12, 12, 11, 10, 9, 9, 8,
+			8, 7, 6, 5, 5, 4, 4, 3, 10, 9, 9, 8, 7, 6, 6, 5, 5, 4, 3, 2, 2, 1, 1, 0);
+		const __m256i srlvdidx = _mm256_set_epi32(0, 0, 1, 0, 0, 0, 1, 0);
+		const __m256i srlvqidx = _mm256_set_epi64x(2, 0, 2, 0);
+		const __m256i shift = _mm256_set_epi16(4, 32, 1, 8, 32, 1, 4, 32, 4, 32, 1, 8, 32, 1, 4, 32);
+		const __m256i mask = _mm256_set1_epi16(32752);
+		__m256i f;
+
+		for (size_t i = 0; i < KYBER_N / 16; ++i)
+		{
+			f = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&A[22 * i]));
+			f = _mm256_permute4x64_epi64(f, 0x94);
+			f = _mm256_shuffle_epi8(f, shufbidx);
+			f = _mm256_srlv_epi32(f, srlvdidx);
+			f = _mm256_srlv_epi64(f, srlvqidx);
+			f = _mm256_mullo_epi16(f, shift);
+			f = _mm256_srli_epi16(f, 1);
+			f = _mm256_and_si256(f, mask);
+			f = _mm256_mulhrs_epi16(f, q);
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(&R[16 * i]), f);
+		}
+	}
+
+	uint32_t RejUniform(int16_t* R, const uint8_t* Buf)
+	{
+		static const int8_t KYBER_REJ_IDX[KYBER_N][8] =
+		{
+			{ -1, -1, -1, -1, -1, -1, -1, -1 }, { 0, -1, -1, -1, -1, -1, -1, -1 },
+			{ 2, -1, -1, -1, -1, -1, -1, -1 }, { 0,  2, -1, -1, -1, -1, -1, -1 },
+			{ 4, -1, -1, -1, -1, -1, -1, -1 }, { 0,  4, -1, -1, -1, -1, -1, -1 },
+			{ 2,  4, -1, -1, -1, -1, -1, -1 }, { 0,  2,  4, -1, -1, -1, -1, -1 },
+			{ 6, -1, -1, -1, -1, -1, -1, -1 }, { 0,  6, -1, -1, -1, -1, -1, -1 },
+			{ 2,  6, -1, -1, -1, -1, -1, -1 }, { 0,  2,  6, -1, -1, -1, -1, -1 },
+			{ 4,  6, -1, -1, -1, -1, -1, -1 }, { 0,  4,  6, -1, -1, -1, -1, -1 },
+			{ 2,  4,  6, -1, -1, -1, -1, -1 }, { 0,  2,  4,  6, -1, -1, -1, -1 },
+			{ 8, -1, -1, -1, -1, -1, -1, -1 }, { 0,  8, -1, -1, -1, -1, -1, -1 },
+			{ 2,  8, -1, -1, -1, -1, -1, -1 }, { 0,  2,  8, -1, -1, -1, -1, -1 },
+			{ 4,  8, -1, -1, -1, -1, -1, -1 }, { 0,  4,  8, -1, -1, -1, -1, -1 },
+			{ 2,  4,  8, -1, -1, -1, -1, -1 }, { 0,  2,  4,  8, -1, -1, -1, -1 },
+			{ 6,  8, -1, -1, -1, -1, -1, -1 }, { 0,  6,  8, -1, -1, -1, -1, -1 },
+			{ 2,  6,  8, -1, -1, -1, -1, -1 }, { 0,  2,  6,  8, -1, -1, -1, -1 },
+			{ 4,  6,  8, -1, -1, -1, -1, -1 }, { 0,  4,  6,  8, -1, -1, -1, -1 },
+			{ 2,  4,  6,  8, -1, -1, -1, -1 }, { 0,  2,  4,  6,  8, -1, -1, -1 },
+			{ 10, -1, -1, -1, -1, -1, -1, -1 },{ 0, 10, -1, -1, -1, -1, -1, -1 },
+			{ 2, 10, -1, -1, -1, -1, -1, -1 }, { 0,  2, 10, -1, -1, -1, -1, -1 },
+			{ 4, 10, -1, -1, -1, -1, -1, -1 }, { 0,  4, 10, -1, -1, -1, -1, -1 },
+			{ 2,  4, 10, -1, -1, -1, -1, -1 }, { 0,  2,  4, 10, -1, -1, -1, -1 },
+			{ 6, 10, -1, -1, -1, -1, -1, -1 }, { 0,  6, 10, -1, -1, -1, -1, -1 },
+			{ 2,  6, 10, -1, -1, -1, -1, -1 }, { 0,  2,  6, 10, -1, -1, -1, -1 },
+			{ 4,  6, 10, -1, -1, -1, -1, -1 }, { 0,  4,  6, 10, -1, -1, -1, -1 },
+			{ 2,  4,  6, 10, -1, -1, -1, -1 }, { 0,  2,  4,  6, 10, -1, -1, -1 },
+			{ 8, 10, -1, -1, -1, -1, -1, -1 }, { 0,  8, 10, -1, -1, -1, -1, -1 },
+			{ 2,  8, 10, -1, -1, -1, -1, -1 }, { 0,  2,  8, 10, -1, -1, -1, -1 },
+			{ 4,  8, 10, -1, -1, -1, -1, -1 }, { 0,  4,  8, 10, -1, -1, -1, -1 },
+			{ 2,  4,  8, 10, -1, -1, -1, -1 }, { 0,  2,  4,  8, 10, -1, -1, -1 },
+			{ 6,  8, 10, -1, -1, -1, -1, -1 }, { 0,  6,  8, 10, -1, -1, -1, -1 },
+			{ 2,  6,  8, 10, -1, -1, -1, -1 }, { 0,  2,  6,  8, 10, -1, -1, -1 },
+			{ 4,  6,  8, 10, -1, -1, -1, -1 }, { 0,  4,  6,  8, 10, -1, -1, -1 },
+			{ 2,  4,  6,  8, 10, -1, -1, -1 }, { 0,  2,  4,  6,  8, 10, -1, -1 },
+			{ 12, -1, -1, -1, -1, -1, -1, -1 }, { 0, 12, -1, -1, -1, -1, -1, -1 },
+			{ 2, 12, -1, -1, -1, -1, -1, -1 }, { 0,  2, 12, -1, -1, -1, -1, -1 },
+			{ 4, 12, -1, -1, -1, -1, -1, -1 }, { 0,  4, 12, -1, -1, -1, -1, -1 },
+			{ 2,  4, 12, -1, -1, -1, -1, -1 }, { 0,  2,  4, 12, -1, -1, -1, -1 },
+			{ 6, 12, -1, -1, -1, -1, -1, -1 }, { 0,  6, 12, -1, -1, -1, -1, -1 },
+			{ 2,  6, 12, -1, -1, -1, -1, -1 }, { 0,  2,  6, 12, -1, -1, -1, -1 },
+			{ 4,  6, 12, -1, -1, -1, -1, -1 }, { 0,  4,  6, 12, -1, -1, -1, -1 },
+			{ 2,  4,  6, 12, -1, -1, -1, -1 }, { 0,  2,  4,  6, 12, -1, -1, -1 },
+			{ 8, 12, -1, -1, -1, -1, -1, -1 }, { 0,  8, 12, -1, -1, -1, -1, -1 },
+			{ 2,  8, 12, -1, -1, -1, -1, -1 }, { 0,  2,  8, 12, -1, -1, -1, -1 },
+			{ 4,  8, 12, -1, -1, -1, -1, -1 }, { 0,  4,  8, 12, -1, -1, -1, -1 },
+			{ 2,  4,  8, 12, -1, -1, -1, -1 }, { 0,  2,  4,  8, 12, -1, -1, -1 },
+			{ 6,  8, 12, -1, -1, -1, -1, -1 }, { 0,  6,  8, 12, -1, -1, -1, -1 },
+			{ 2,  6,  8, 12, -1, -1, -1, -1 }, { 0,  2,  6,  8, 12, -1, -1, -1 },
+			{ 4,  6,  8, 12, -1, -1, -1, -1 }, { 0,  4,  6,  8, 12, -1, -1, -1 },
+			{ 2,  4,  6,  8, 12, -1, -1, -1 }, { 0,  2,  4,  6,  8, 12, -1, -1 },
+			{ 10, 12, -1, -1, -1, -1, -1, -1 }, { 0, 10, 12, -1, -1, -1, -1, -1 },
+			{ 2, 10, 12, -1, -1, -1, -1, -1 }, { 0,  2, 10, 12, -1, -1, -1, -1 },
+			{ 4, 10, 12, -1, -1, -1, -1, -1 }, { 0,  4, 10, 12, -1, -1, -1, -1 },
+			{ 2,  4, 10, 12, -1, -1, -1, -1 }, { 0,  2,  4, 10, 12, -1, -1, -1 },
+			{ 6, 10, 12, -1, -1, -1, -1, -1 }, { 0,  6, 10, 12, -1, -1, -1, -1 },
+			{ 2,  6, 10, 12, -1, -1, -1, -1 }, { 0,  2,  6, 10, 12, -1, -1, -1 },
+			{ 4,  6, 10, 12, -1, -1, -1, -1 }, { 0,  4,  6, 10, 12, -1, -1, -1 },
+			{ 2,  4,  6, 10, 12, -1, -1, -1 }, { 0,  2,  4,  6, 10, 12, -1, -1 },
+			{ 8, 10, 12, -1, -1, -1, -1, -1 }, { 0,  8, 10, 12, -1, -1, -1, -1 },
+			{ 2,  8, 10, 12, -1, -1, -1, -1 }, { 0,  2,  8, 10, 12, -1, -1, -1 },
+			{ 4,  8, 10, 12, -1, -1, -1, -1 }, { 0,  4,  8, 10, 12, -1, -1, -1 },
+			{ 2,  4,  8, 10, 12, -1, -1, -1 }, { 0,  2,  4,  8, 10, 12, -1, -1 },
+			{ 6,  8, 10, 12, -1, -1, -1, -1 }, { 0,  6,  8, 10, 12, -1, -1, -1 },
+			{ 2,  6,  8, 10, 12, -1, -1, -1 }, { 0,  2,  6,  8, 10, 12, -1, -1 },
+			{ 4,  6,  8, 10, 12, -1, -1, -1 }, { 0,  4,  6,  8, 10, 12, -1, -1 },
+			{ 2,  4,  6,  8, 10, 12, -1, -1 }, { 0,  2,  4,  6,  8, 10, 12, -1 },
+			{ 14, -1, -1, -1, -1, -1, -1, -1 }, { 0, 14, -1, -1, -1, -1, -1, -1 },
+			{ 2, 14, -1, -1, -1, -1, -1, -1 }, { 0,  2, 14, -1, -1, -1, -1, -1 },
+			{ 4, 14, -1, -1, -1, -1, -1, -1 }, { 0,  4, 14, -1, -1, -1, -1, -1 },
+			{ 2,  4, 14, -1, -1, -1, -1, -1 }, { 0,  2,  4, 14, -1, -1, -1, -1 },
+			{ 6, 14, -1, -1, -1, -1, -1, -1 }, { 0,  6, 14, -1, -1, -1, -1, -1 },
+			{ 2,  6, 14, -1, -1, -1, -1, -1 }, { 0,  2,  6, 14, -1, -1, -1, -1 },
+			{ 4,  6, 14, -1, -1, -1, -1, -1 }, { 0,  4,  6, 14, -1, -1, -1, -1 },
+			{ 2,  4,  6, 14, -1, -1, -1, -1 }, { 0,  2,  4,  6, 14, -1, -1, -1 },
+			{ 8, 14, -1, -1, -1, -1, -1, -1 }, { 0,  8, 14, -1, -1, -1, -1, -1 },
+			{ 2,  8, 14, -1, -1, -1, -1, -1 }, { 0,  2,  8, 14, -1, -1, -1, -1 },
+			{ 4,  8, 14, -1, -1, -1, -1, -1 }, { 0,  4,  8, 14, -1, -1, -1, -1 },
+			{ 2,  4,  8, 14, -1, -1, -1, -1 }, { 0,  2,  4,  8, 14, -1, -1, -1 },
+			{ 6,  8, 14, -1, -1, -1, -1, -1 }, { 0,  6,  8, 14, -1, -1, -1, -1 },
+			{ 2,  6,  8, 14, -1, -1, -1, -1 }, { 0,  2,  6,  8, 14, -1, -1, -1 },
+			{ 4,  6,  8, 14, -1, -1, -1, -1 }, { 0,  4,  6,  8, 14, -1, -1, -1 },
+			{ 2,  4,  6,  8, 14, -1, -1, -1 }, { 0,  2,  4,  6,  8, 14, -1, -1 },
+			{ 10, 14, -1, -1, -1, -1, -1, -1 }, { 0, 10, 14, -1, -1, -1, -1, -1 },
+			{ 2, 10, 14, -1, -1, -1, -1, -1 }, { 0,  2, 10, 14, -1, -1, -1, -1 },
+			{ 4, 10, 14, -1, -1, -1, -1, -1 }, { 0,  4, 10, 14, -1, -1, -1, -1 },
+			{ 2,  4, 10, 14, -1, -1, -1, -1 }, { 0,  2,  4, 10, 14, -1, -1, -1 },
+			{ 6, 10, 14, -1, -1, -1, -1, -1 }, { 0,  6, 10, 14, -1, -1, -1, -1 },
+			{ 2,  6, 10, 14, -1, -1, -1, -1 }, { 0,  2,  6, 10, 14, -1, -1, -1 },
+			{ 4,  6, 10, 14, -1, -1, -1, -1 }, { 0,  4,  6, 10, 14, -1, -1, -1 },
+			{ 2,  4,  6, 10, 14, -1, -1, -1 }, { 0,  2,  4,  6, 10, 14, -1, -1 },
+			{ 8, 10, 14, -1, -1, -1, -1, -1 }, { 0,  8, 10, 14, -1, -1, -1, -1 },
+			{ 2,  8, 10, 14, -1, -1, -1, -1 }, { 0,  2,  8, 10, 14, -1, -1, -1 },
+			{ 4,  8, 10, 14, -1, -1, -1, -1 }, { 0,  4,  8, 10, 14, -1, -1, -1 },
+			{ 2,  4,  8, 10, 14, -1, -1, -1 }, { 0,  2,  4,  8, 10, 14, -1, -1 },
+			{ 6,  8, 10, 14, -1, -1, -1, -1 }, { 0,  6,  8, 10, 14, -1, -1, -1 },
+			{ 2,  6,  8, 10, 14, -1, -1, -1 }, { 0,  2,  6,  8, 10, 14, -1, -1 },
+			{ 4,  6,  8, 10, 14, -1, -1, -1 }, { 0,  4,  6,  8, 10, 14, -1, -1 },
+			{ 2,  4,  6,  8, 10, 14, -1, -1 }, { 0,  2,  4,  6,  8, 10, 14, -1 },
+			{ 12, 14, -1, -1, -1, -1, -1, -1 }, { 0, 12, 14, -1, -1, -1, -1, -1 },
+			{ 2, 12, 14, -1, -1, -1, -1, -1 }, { 0,  2, 12, 14, -1, -1, -1, -1 },
+			{ 4, 12, 14, -1, -1, -1, -1, -1 }, { 0,  4, 12, 14, -1, -1, -1, -1 },
+			{ 2,  4, 12, 14, -1, -1, -1, -1 }, { 0,  2,  4, 12, 14, -1, -1, -1 },
+			{ 6, 12, 14, -1, -1, -1, -1, -1 }, { 0,  6, 12, 14, -1, -1, -1, -1 },
+			{ 2,  6, 12, 14, -1, -1, -1, -1 }, { 0,  2,  6, 12, 14, -1, -1, -1 },
+			{ 4,  6, 12, 14, -1, -1, -1, -1 }, { 0,  4,  6, 12, 14, -1, -1, -1 },
+			{ 2,  4,  6, 12, 14, -1, -1, -1 }, { 0,  2,  4,  6, 12, 14, -1, -1 },
+			{ 8, 12, 14, -1, -1, -1, -1, -1 }, { 0,  8, 12, 14, -1, -1, -1, -1 },
+			{ 2,  8, 12, 14, -1, -1, -1, -1 }, { 0,  2,  8, 12, 14, -1, -1, -1 },
+			{ 4,  8, 12, 14, -1, -1, -1, -1 }, { 0,  4,  8, 12, 14, -1, -1, -1 },
+			{ 2,  4,  8, 12, 14, -1, -1, -1 }, { 0,  2,  4,  8, 12, 14, -1, -1 },
+			{ 6,  8, 12, 14, -1, -1, -1, -1 }, { 0,  6,  8, 12, 14, -1, -1, -1 },
+			{ 2,  6,  8, 12, 14, -1, -1, -1 }, { 0,  2,  6,  8, 12, 14, -1, -1 },
+			{ 4,  6,  8, 12, 14, -1, -1, -1 }, { 0,  4,  6,  8, 12, 14, -1, -1 },
+			{ 2,  4,  6,  8, 12, 14, -1, -1 }, { 0,  2,  4,  6,  8, 12, 14, -1 },
+			{ 10, 12, 14, -1, -1, -1, -1, -1 }, { 0, 10, 12, 14, -1, -1, -1, -1 },
+			{ 2, 10, 12, 14, -1, -1, -1, -1 }, { 0,  2, 10, 12, 14, -1, -1, -1 },
+			{ 4, 10, 12, 14, -1, -1, -1, -1 }, { 0,  4, 10, 12, 14, -1, -1, -1 },
+			{ 2,  4, 10, 12, 14, -1, -1, -1 }, { 0,  2,  4, 10, 12, 14, -1, -1 },
+			{ 6, 10, 12, 14, -1, -1, -1, -1 }, { 0,  6, 10, 12, 14, -1, -1, -1 },
+			{ 2,  6, 10, 12, 14, -1, -1, -1 }, { 0,  2,  6, 10, 12, 14, -1, -1 },
+			{ 4,  6, 10, 12, 14, -1, -1, -1 }, { 0,  4,  6, 10, 12, 14, -1, -1 },
+			{ 2,  4,  6, 10, 12, 14, -1, -1 }, { 0,  2,  4,  6, 10, 12, 14, -1 },
+			{ 8, 10, 12, 14, -1, -1, -1, -1 }, { 0,  8, 10, 12, 14, -1, -1, -1 },
+			{ 2,  8, 10, 12, 14, -1, -1, -1 }, { 0,  2,  8, 10, 12, 14, -1, -1 },
+			{ 4,  8, 10, 12, 14, -1, -1, -1 }, { 0,  4,  8, 10, 12, 14, -1, -1 },
+			{ 2,  4,  8, 10, 12, 14, -1, -1 }, { 0,  2,  4,  8, 10, 12, 14, -1 },
+			{ 6,  8, 10, 12, 14, -1, -1, -1 }, { 0,  6,  8, 10, 12, 14, -1, -1 },
+			{ 2,  6,  8, 10, 12, 14, -1, -1 }, { 0,  2,  6,  8, 10, 12, 14, -1 },
+			{ 4,  6,  8, 10, 12, 14, -1, -1 }, { 0,  4,  6,  8, 10, 12, 14, -1 },
+			{ 2,  4,  6,  8, 10, 12, 14, -1 }, { 0,  2,  4,  6,  8, 10, 12, 14 }
+		};
+
+		const __m256i bound = _mm256_set1_epi16(KYBER_Q);
+		const __m256i ones = _mm256_set1_epi8(1);
+		const __m256i mask = _mm256_set1_epi16(0xFFF);
+		const __m256i idx8 = _mm256_set_epi8(15, 14, 14, 13, 12, 11, 11, 10,
+			9, 8, 8, 7, 6, 5, 5, 4, 11, 10, 10, 9, 8, 7, 7, 6, 5, 4, 4, 3, 2, 1, 1, 0);
+		__m256i f0;
+		__m256i f1;
+		__m256i g0;
+		__m256i g1;
+		__m256i g2;
+		__m256i g3;
+		__m128i f;
+		__m128i t;
+		__m128i pilo;
+		__m128i pihi;
+		uint32_t ctr;
+		uint32_t pos;
+		uint16_t val0;
+		uint16_t val1;
+		uint32_t good;
+
+		ctr = 0;
+		pos = 0;
+
+		while (ctr <= KYBER_N - 32 && pos <= AVX_REJ_UNIFORM_BUFLEN - 48)
+		{
+			f0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&Buf[pos]));
+			f1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&Buf[pos + 24]));
+			f0 = _mm256_permute4x64_epi64(f0, 0x94);
+			f1 = _mm256_permute4x64_epi64(f1, 0x94);
+			f0 = _mm256_shuffle_epi8(f0, idx8);
+			f1 = _mm256_shuffle_epi8(f1, idx8);
+			g0 = _mm256_srli_epi16(f0, 4);
+			g1 = _mm256_srli_epi16(f1, 4);
+			f0 = _mm256_blend_epi16(f0, g0, 0xAA);
+			f1 = _mm256_blend_epi16(f1, g1, 0xAA);
+			f0 = _mm256_and_si256(f0, mask);
+			f1 = _mm256_and_si256(f1, mask);
+			pos += 48;
+
+			g0 = _mm256_cmpgt_epi16(bound, f0);
+			g1 = _mm256_cmpgt_epi16(bound, f1);
+			g0 = _mm256_packs_epi16(g0, g1);
+			good = _mm256_movemask_epi8(g0);
+			g0 = _mm256_castsi128_si256(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(&KYBER_REJ_IDX[good & 0xFF])));
+			g1 = _mm256_castsi128_si256(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(&KYBER_REJ_IDX[(good >> 8) & 0xFF])));
+			g0 = _mm256_inserti128_si256(g0, _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&KYBER_REJ_IDX[(good >> 16) & 0xFF])), 1);
+			g1 = _mm256_inserti128_si256(g1, _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&KYBER_REJ_IDX[(good >> 24) & 0xFF])), 1);
+			g2 = _mm256_add_epi8(g0, ones);
+			g3 = _mm256_add_epi8(g1, ones);
+			g0 = _mm256_unpacklo_epi8(g0, g2);
+			g1 = _mm256_unpacklo_epi8(g1, g3);
+			f0 = _mm256_shuffle_epi8(f0, g0);
+			f1 = _mm256_shuffle_epi8(f1, g1);
+
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(&R[ctr]), _mm256_castsi256_si128(f0));
+			ctr += _mm_popcnt_u32(good & 0xFF);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(&R[ctr]), _mm256_extracti128_si256(f0, 1));
+			ctr += _mm_popcnt_u32((good >> 16) & 0xFF);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(&R[ctr]), _mm256_castsi256_si128(f1));
+			ctr += _mm_popcnt_u32((good >> 8) & 0xFF);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(&R[ctr]), _mm256_extracti128_si256(f1, 1));
+			ctr += _mm_popcnt_u32((good >> 24) & 0xFF);
+		}
+
+		while (ctr <= KYBER_N - 8 && pos <= AVX_REJ_UNIFORM_BUFLEN - 12)
+		{
+			f = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&Buf[pos]));
+			f = _mm_shuffle_epi8(f, _mm256_castsi256_si128(idx8));
+			t = _mm_srli_epi16(f, 4);
+			f = _mm_blend_epi16(f, t, 0xAA);
+			f = _mm_and_si128(f, _mm256_castsi256_si128(mask));
+			pos += 12;
+			t = _mm_cmpgt_epi16(_mm256_castsi256_si128(bound), f);
+			good = _mm_movemask_epi8(t);
+			good = _pext_u32(good, 0x5555);
+			pilo = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&KYBER_REJ_IDX[good]));
+			pihi = _mm_add_epi8(pilo, _mm256_castsi256_si128(ones));
+			pilo = _mm_unpacklo_epi8(pilo, pihi);
+			f = _mm_shuffle_epi8(f, pilo);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(&R[ctr]), f);
+			ctr += _mm_popcnt_u32(good);
+		}
+
+		while (ctr < KYBER_N && pos <= AVX_REJ_UNIFORM_BUFLEN - 3)
+		{
+			val0 = (uint16_t)(((uint16_t)Buf[pos] | ((uint16_t)Buf[pos + 1] << 8)) & 0x0FFF);
+			val1 = (uint16_t)(((uint16_t)Buf[pos + 1] >> 4) | ((uint16_t)Buf[pos + 2] << 4));
+			pos += 3;
+
+			if (val0 < KYBER_Q)
+			{
+				R[ctr] = val0;
+				++ctr;
+			}
+
+			if (val1 < KYBER_Q && ctr < KYBER_N)
+			{
+				R[ctr] = val1;
+				++ctr;
+			}
+		}
+
+		return ctr;
+	}
+
+	void Cmov(uint8_t* R, const uint8_t* X, size_t Length, uint8_t B)
+	{
+		__m256i xvec;
+		__m256i rvec;
+		__m256i bvec;
+		size_t pos;
+
+		B = -B;
+		bvec = _mm256_set1_epi8(B);
+
+		for (pos = 0; pos + 32 <= Length; pos += 32)
+		{
+			rvec = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&R[pos]));
+			xvec = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&X[pos]));
+			xvec = _mm256_xor_si256(xvec, rvec);
+			xvec = _mm256_and_si256(xvec, bvec);
+			rvec = _mm256_xor_si256(rvec, xvec);
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(&R[pos]), rvec);
+		}
+
+		while (pos < Length)
+		{
+			R[pos] ^= B & (X[pos] ^ R[pos]);
+			pos += 1;
+		}
+	}
+
+	int32_t Verify(const uint8_t* A, const uint8_t* B, size_t Length)
+	{
+		__m256i avec;
+		__m256i bvec;
+		__m256i cvec;
+		uint64_t r;
+		size_t pos;
+
+		cvec = _mm256_setzero_si256();
+
+		for (pos = 0; pos + 32 <= Length; pos += 32)
+		{
+			avec = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&A[pos]));
+			bvec = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&B[pos]));
+			avec = _mm256_xor_si256(avec, bvec);
+			cvec = _mm256_or_si256(cvec, avec);
+		}
+
+		r = 1ULL - _mm256_testz_si256(cvec, cvec);
+
+		// the tail is compared a byte at a time, so no read passes the end of either array
+		while (pos < Length)
+		{
+			r |= static_cast<uint64_t>(A[pos] ^ B[pos]);
+			++pos;
+		}
+
+		r = static_cast<uint64_t>((-static_cast<int64_t>(r)) >> 63);
+
+		return static_cast<uint32_t>(r);
+	}
+}
+#else
+using Exception::CryptoAsymmetricException;
+using Enumeration::ErrorCodes;
+#endif
+
+SimdProfiles KyberKernels::Compiled()
+{
+	return HasAvx2() ? SimdProfiles::Simd256 :
+		SimdProfiles::None;
+}
+
+bool KyberKernels::HasAvx2()
+{
+#if defined(CEX_HAS_AVX2)
+	return true;
+#else
+	return false;
+#endif
+}
+
+void KyberKernels::Cbd2Avx2(int16_t* R, const uint8_t* Buf)
+{
+#if defined(CEX_HAS_AVX2)
+	Cbd2(R, Buf);
+#else
+	throw CryptoAsymmetricException(std::string("KyberKernels"), std::string("Cbd2Avx2"), std::string("The AVX2 kernel was not compiled!"), ErrorCodes::NotSupported);
+#endif
+}
+
+void KyberKernels::Cbd3Avx2(int16_t* R, const uint8_t* Buf)
+{
+#if defined(CEX_HAS_AVX2)
+	Cbd3(R, Buf);
+#else
+	throw CryptoAsymmetricException(std::string("KyberKernels"), std::string("Cbd3Avx2"), std::string("The AVX2 kernel was not compiled!"), ErrorCodes::NotSupported);
+#endif
+}
+
+void KyberKernels::CmovAvx2(uint8_t* R, const uint8_t* X, size_t Length, uint8_t B)
+{
+#if defined(CEX_HAS_AVX2)
+	Cmov(R, X, Length, B);
+#else
+	throw CryptoAsymmetricException(std::string("KyberKernels"), std::string("CmovAvx2"), std::string("The AVX2 kernel was not compiled!"), ErrorCodes::NotSupported);
+#endif
+}
+
+void KyberKernels::PolyAddAvx2(int16_t* R, const int16_t* A, const int16_t* B)
+{
+#if defined(CEX_HAS_AVX2)
+	PolyAdd(R, A, B);
+#else
+	throw CryptoAsymmetricException(std::string("KyberKernels"), std::string("PolyAddAvx2"), std::string("The AVX2 kernel was not compiled!"), ErrorCodes::NotSupported);
+#endif
+}
+
+void KyberKernels::PolyCompressAvx2P128(uint8_t* R, const int16_t* A)
+{
+#if defined(CEX_HAS_AVX2)
+	PolyCompressP128(R, A);
+#else
+	throw CryptoAsymmetricException(std::string("KyberKernels"), std::string("PolyCompressAvx2P128"), std::string("The AVX2 kernel was not compiled!"), ErrorCodes::NotSupported);
+#endif
+}
+
+void KyberKernels::PolyCompressAvx2P160(uint8_t* R, const int16_t* A)
+{
+#if defined(CEX_HAS_AVX2)
+	PolyCompressP160(R, A);
+#else
+	throw CryptoAsymmetricException(std::string("KyberKernels"), std::string("PolyCompressAvx2P160"), std::string("The AVX2 kernel was not compiled!"), ErrorCodes::NotSupported);
+#endif
+}
+
+void KyberKernels::PolyDecompressAvx2P128(int16_t* R, const uint8_t* A)
+{
+#if defined(CEX_HAS_AVX2)
+	PolyDecompressP128(R, A);
+#else
+	throw CryptoAsymmetricException(std::string("KyberKernels"), std::string("PolyDecompressAvx2P128"), std::string("The AVX2 kernel was not compiled!"), ErrorCodes::NotSupported);
+#endif
+}
+
+void KyberKernels::PolyDecompressAvx2P160(int16_t* R, const uint8_t* A)
+{
+#if defined(CEX_HAS_AVX2)
+	PolyDecompressP160(R, A);
+#else
+	throw CryptoAsymmetricException(std::string("KyberKernels"), std::string("PolyDecompressAvx2P160"), std::string("The AVX2 kernel was not compiled!"), ErrorCodes::NotSupported);
+#endif
+}
+
+void KyberKernels::PolyDecompress10Avx2P320(int16_t* R, const uint8_t* A)
+{
+#if defined(CEX_HAS_AVX2)
+	PolyDecompress10P320(R, A);
+#else
+	throw CryptoAsymmetricException(std::string("KyberKernels"), std::string("PolyDecompress10Avx2P320"), std::string("The AVX2 kernel was not compiled!"), ErrorCodes::NotSupported);
+#endif
+}
+
+void KyberKernels::PolyDecompress11Avx2P352(int16_t* R, const uint8_t* A)
+{
+#if defined(CEX_HAS_AVX2)
+	PolyDecompress11P352(R, A);
+#else
+	throw CryptoAsymmetricException(std::string("KyberKernels"), std::string("PolyDecompress11Avx2P352"), std::string("The AVX2 kernel was not compiled!"), ErrorCodes::NotSupported);
+#endif
+}
+
+void KyberKernels::PolyFromMsgAvx2(int16_t* R, const uint8_t* Msg)
+{
+#if defined(CEX_HAS_AVX2)
+	PolyFromMsg(R, Msg);
+#else
+	throw CryptoAsymmetricException(std::string("KyberKernels"), std::string("PolyFromMsgAvx2"), std::string("The AVX2 kernel was not compiled!"), ErrorCodes::NotSupported);
+#endif
+}
+
+void KyberKernels::PolySubAvx2(int16_t* R, const int16_t* A, const int16_t* B)
+{
+#if defined(CEX_HAS_AVX2)
+	PolySub(R, A, B);
+#else
+	throw CryptoAsymmetricException(std::string("KyberKernels"), std::string("PolySubAvx2"), std::string("The AVX2 kernel was not compiled!"), ErrorCodes::NotSupported);
+#endif
+}
+
+uint32_t KyberKernels::RejUniformAvx2(int16_t* R, const uint8_t* Buf)
+{
+#if defined(CEX_HAS_AVX2)
+	return RejUniform(R, Buf);
+#else
+	throw CryptoAsymmetricException(std::string("KyberKernels"), std::string("RejUniformAvx2"), std::string("The AVX2 kernel was not compiled!"), ErrorCodes::NotSupported);
+#endif
+}
+
+int32_t KyberKernels::VerifyAvx2(const uint8_t* A, const uint8_t* B, size_t Length)
+{
+#if defined(CEX_HAS_AVX2)
+	return Verify(A, B, Length);
+#else
+	throw CryptoAsymmetricException(std::string("KyberKernels"), std::string("VerifyAvx2"), std::string("The AVX2 kernel was not compiled!"), ErrorCodes::NotSupported);
+#endif
+}
+
+NAMESPACE_KYBEREND
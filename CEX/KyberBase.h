@@ -23,10 +23,8 @@
 #include "IPrng.h"
 #include "IntegerTools.h"
 #include "Keccak.h"
+#include "KyberKernels.h"
 #include "MemoryTools.h"
-#if defined(CEX_HAS_AVX)
-#	include "Intrinsics.h"
-#endif
 
 NAMESPACE_KYBER
 
@@ -306,21 +304,27 @@ public:
 		// coins are in kr+KYBER_SYMBYTES
 		IndCpaEnc(Params, cmp, buf, pk, kr, KYBER_SYMBYTES);
 
-	#if defined(CEX_HAS_AVX2)
-		fail = VerifyAvx2(CipherText, cmp, CipherText.size());
-	#else
-		fail = IntegerTools::Verify(CipherText, cmp, CipherText.size());
-	#endif
+		if (HasAvx2() == true)
+		{
+			fail = KyberKernels::VerifyAvx2(CipherText.data(), cmp.data(), CipherText.size());
+		}
+		else
+		{
+			fail = IntegerTools::Verify(CipherText, cmp, CipherText.size());
+		}
 
 		// overwrite coins in kr with H(c)
 		Keccak::Compute(CipherText, 0, CipherText.size(), kr, KYBER_SYMBYTES, Keccak::KECCAK256_RATE_SIZE);
 
 		// overwrite pre-k with z on re-encryption failure
-	#if defined(CEX_HAS_AVX2)
-		CmovAvx2(kr, PrivateKey, SKPLEN - KYBER_SYMBYTES, KYBER_SYMBYTES, static_cast<uint8_t>(fail));
-	#else
-		IntegerTools::CMov(PrivateKey, SKPLEN - KYBER_SYMBYTES, kr, 0, KYBER_SYMBYTES, static_cast<uint8_t>(fail));
-	#endif
+		if (HasAvx2() == true)
+		{
+			KyberKernels::CmovAvx2(kr.data(), PrivateKey.data() + (SKPLEN - KYBER_SYMBYTES), KYBER_SYMBYTES, static_cast<uint8_t>(fail));
+		}
+		else
+		{
+			IntegerTools::CMov(PrivateKey, SKPLEN - KYBER_SYMBYTES, kr, 0, KYBER_SYMBYTES, static_cast<uint8_t>(fail));
+		}
 
 		// hash concatenation of pre-k and H(c) to k 
 		Keccak::XOFP1600(kr, 0, 2 * KYBER_SYMBYTES, SharedSecret, 0, SharedSecret.size(), Keccak::KECCAK256_RATE_SIZE);
@@ -392,7 +396,10 @@ private:
 	static void Cbd3(Poly &R, const std::vector<uint8_t> &Buf);
 	static int16_t FqMul(int16_t A, int16_t B);
 	static void GenMatrix(std::vector<PolyVec> &A, const std::vector<uint8_t> &Seed, int32_t Transposed, uint32_t K);
+	static void GenMatrixAvx2(std::vector<PolyVec> &A, const std::vector<uint8_t> &Seed, int32_t Transposed, uint32_t K);
+	static bool HasAvx2();
 	static void InvNtt(Poly &R);
+	static uint32_t LoadLe24(const std::vector<uint8_t> &X, size_t XOffset);
 	static int16_t MontgomeryReduce(int32_t A);
 	static void Ntt(Poly &R);
 	static void PackCiphertext(std::vector<uint8_t> &R, const PolyVec &B, const Poly &V, uint32_t K);
@@ -402,6 +409,8 @@ private:
 	static void PolyBaseMulMontgomery(Poly &R, const Poly &A, const Poly &B);
 	static void PolyCbdEta1(Poly &R, const std::vector<uint8_t> &Buf, uint32_t Eta1);
 	static void PolyCbdEta2(Poly &R, const std::vector<uint8_t> &Buf);
+	static void PolyCompress(std::vector<uint8_t> &R, size_t ROffset, const Poly &A, uint32_t K);
+	static void PolyDecompress(Poly &R, const std::vector<uint8_t> &A, size_t AOffset, uint32_t K);
 	static void PolyFromBytes(Poly &R, const std::vector<uint8_t> &A, size_t AOffset);
 	static void PolyFromMsg(Poly &R, const std::vector<uint8_t> &Msg);
 	static void PolyGetNoiseEta1(Poly &R, const std::vector<uint8_t> &Seed, size_t SOffset, uint8_t Nonce, uint32_t Eta1);
@@ -426,22 +435,6 @@ private:
 	static void UnPackCiphertext(PolyVec &B, Poly &V, const std::vector<uint8_t> &C);
 	static void UnPackPk(PolyVec &Pk, std::vector<uint8_t> &Seed, const std::vector<uint8_t> &PackedPk);
 	static void UnPackSk(PolyVec &Sk, const std::vector<uint8_t> &PackedSk);
-
-#if defined(CEX_HAS_AVX2)
-	static void CmovAvx2(std::vector<uint8_t> &R, const std::vector<uint8_t> &X, size_t XOffset, size_t Length, uint8_t B);
-	static void PolyCompressAvx2P128(std::vector<uint8_t> &R, size_t ROffset, const Poly &A);
-	static void PolyCompressAvx2P160(std::vector<uint8_t> &R, size_t ROffset, const Poly &A);
-	static void PolyDecompressAvx2P128(Poly &R, const std::vector<uint8_t>  &A, size_t AOffset);
-	static void PolyDecompressAvx2P160(Poly &R, const std::vector<uint8_t> &A, size_t AOffset);
-	static void PolyDecompress10Avx2P320(Poly &R, const std::vector<uint8_t> &A, size_t AOffset);
-	static void PolyDecompress11Avx2P352(Poly &R, const std::vector<uint8_t> &A, size_t AOffset);
-	static uint32_t RejUniformAvx2(Poly &R, const std::vector<uint8_t> &Buf);
-	static int32_t VerifyAvx2(const std::vector<uint8_t> &A, const std::vector<uint8_t> &B, size_t Length);
-#else
-	static uint32_t LoadLe24(const std::vector<uint8_t> &X, size_t XOffset);
-	static void PolyCompress(std::vector<uint8_t> &R, size_t ROffset, const Poly &A, uint32_t K);
-	static void PolyDecompress(Poly &R, const std::vector<uint8_t> &A, size_t AOffset, uint32_t K);
-#endif
 };
 NAMESPACE_KYBEREND
 #endif
@@ -0,0 +1,110 @@
+#ifndef CEX_KYBERKERNELS_H
+#define CEX_KYBERKERNELS_H
+
+#include "CexDomain.h"
+#include "SimdProfiles.h"
+
+NAMESPACE_KYBER
+
+using Enumeration::SimdProfiles;
+
+/// cond private
+
+/// <summary>
+/// Internal class: the AVX2 Kyber polynomial routines, built in their own instruction set translation unit.
+/// <para>KyberAvx2.cpp is compiled with the AVX2 code generation flag and holds the vectorized sampling, compression and arithmetic routines.
+/// The unit is self-contained: the routines have internal linkage, and the unit includes no shared header with instruction set branches.
+/// Polynomials are passed as pointers to 256 coefficients, and the byte arrays are read and written unaligned.
+/// RejUniformAvx2 reads up to 512 bytes of its input, the sampler buffer must be padded to that length.
+/// A unit compiled without AVX2 reports the variant as absent, and its functions throw if called.
+/// KyberBase selects the routines at run-time with SimdDispatch::Select(Compiled()), RejUniformAvx2 also requires the BMI2 instruction set.</para>
+/// </summary>
+class KyberKernels final
+{
+public:
+
+	/// <summary>
+	/// The widest kernel variant compiled into the library
+	/// </summary>
+	static SimdProfiles Compiled();
+
+	/// <summary>
+	/// The AVX2 kernels were compiled
+	/// </summary>
+	static bool HasAvx2();
+
+	/// <summary>
+	/// The centered binomial distribution with eta 2, 128 input bytes
+	/// </summary>
+	static void Cbd2Avx2(int16_t* R, const uint8_t* Buf);
+
+	/// <summary>
+	/// The centered binomial distribution with eta 3, 192 input bytes; the last load reads 8 bytes past them
+	/// </summary>
+	static void Cbd3Avx2(int16_t* R, const uint8_t* Buf);
+
+	/// <summary>
+	/// Copy X to R in constant time if B is 1, leave R unchanged if B is 0
+	/// </summary>
+	static void CmovAvx2(uint8_t* R, const uint8_t* X, size_t Length, uint8_t B);
+
+	/// <summary>
+	/// Add two polynomials
+	/// </summary>
+	static void PolyAddAvx2(int16_t* R, const int16_t* A, const int16_t* B);
+
+	/// <summary>
+	/// Compress a polynomial to 4 bits per coefficient, 128 output bytes
+	/// </summary>
+	static void PolyCompressAvx2P128(uint8_t* R, const int16_t* A);
+
+	/// <summary>
+	/// Compress a polynomial to 5 bits per coefficient, 160 output bytes
+	/// </summary>
+	static void PolyCompressAvx2P160(uint8_t* R, const int16_t* A);
+
+	/// <summary>
+	/// Decompress a polynomial from 4 bits per coefficient, 128 input bytes
+	/// </summary>
+	static void PolyDecompressAvx2P128(int16_t* R, const uint8_t* A);
+
+	/// <summary>
+	/// Decompress a polynomial from 5 bits per coefficient, 160 input bytes
+	/// </summary>
+	static void PolyDecompressAvx2P160(int16_t* R, const uint8_t* A);
+
+	/// <summary>
+	/// Decompress a polynomial from 10 bits per coefficient, 320 input bytes
+	/// </summary>
+	static void PolyDecompress10Avx2P320(int16_t* R, const uint8_t* A);
+
+	/// <summary>
+	/// Decompress a polynomial from 11 bits per coefficient, 352 input bytes
+	/// </summary>
+	static void PolyDecompress11Avx2P352(int16_t* R, const uint8_t* A);
+
+	/// <summary>
+	/// Convert a 32 byte message to a polynomial
+	/// </summary>
+	static void PolyFromMsgAvx2(int16_t* R, const uint8_t* Msg);
+
+	/// <summary>
+	/// Subtract polynomial B from A
+	/// </summary>
+	static void PolySubAvx2(int16_t* R, const int16_t* A, const int16_t* B);
+
+	/// <summary>
+	/// Rejection sample uniform coefficients from the sampler output, returns the number of coefficients written
+	/// </summary>
+	static uint32_t RejUniformAvx2(int16_t* R, const uint8_t* Buf);
+
+	/// <summary>
+	/// Compare two arrays in constant time, returns 0 if equal, 1 otherwise
+	/// </summary>
+	static int32_t VerifyAvx2(const uint8_t* A, const uint8_t* B, size_t Length);
+};
+
+/// endcond
+
+NAMESPACE_KYBEREND
+#endif
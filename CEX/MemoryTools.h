@@ -21,7 +21,7 @@
 
 #include "CexDomain.h"
 //#include <cstring>
-#if defined(CEX_HAS_AVX) || defined(CEX_HAS_AVX2) || defined(CEX_HAS_AVX512)
+#if defined(CEX_HAS_SSE2) || defined(CEX_HAS_AVX2) || defined(CEX_HAS_AVX512)
 #	include "Intrinsics.h"
 #endif
 
@@ -35,9 +35,9 @@ NAMESPACE_TOOLS
 /// <remarks>
 /// <para>The inlined intrinsics functions use arrays of at least the size indicated by their suffix, i.e. COPY256, expects an array of at least 256 bits in length.
 /// All functions have sequential fallbacks, and the SIMD instruction set will default to the highest available on the compiling system (AVX/AVX2/AVX512).
-/// The size of an operation relates to the size of the intrinsic function: a 128 copy, clear, set or xor function will use AVX, 
+/// The size of an operation relates to the size of the intrinsic function: a 128 copy, clear, set or xor function will use SSE2, 
 /// 256 will process 256 bits with AVX2, and the 512/1024 bit functions can use an experimental AVX512 implementation.
-/// The minimum intrinsics set is AVX, AVX2 is available, and an experimental implementation of AVX512 (not tested yet!) has been added for future compatability.
+/// The library is built for an SSE2 baseline, so the shared code uses the 128-bit functions; the wider paths are only compiled in a build with a global AVX2 or AVX512 code generation flag.
 /// The standard functions Copy, Clear, SetValue, and XOR, use intrinsics calls when the input/output size to that function is at least the size of the minimum available SIMD instruction set.
 /// For example, XOR will loop through an array, and process with the largest available instruction set first. 
 /// If the input/output size is a multiple of 32 bytes, the blocks will be processed by AVX2 until the remainder is less than a complete block, 
@@ -47,7 +47,7 @@ class MemoryTools
 {
 public:
 
-#if defined(CEX_HAS_AVX)
+#if defined(CEX_HAS_SSE2)
 #define CEX_CACHE_SEGMENT 64
 
 #define PREFETCHT0(address, length)									\
@@ -93,10 +93,10 @@ public:
 	{
 		const size_t ELMLEN = sizeof(Array::value_type);
 
-#if defined(CEX_HAS_AVX)
+#if defined(CEX_HAS_SSE2)
 		PREFETCHT1(Input.data() + (Offset * ELMLEN), Length);
 #else
-		volatile Array::value_type tmp;
+		volatile typename Array::value_type tmp;
 
 		tmp = 0;
 
@@ -126,10 +126,10 @@ public:
 	{
 		const size_t ELMLEN = sizeof(Array::value_type);
 
-#if defined(CEX_HAS_AVX)
+#if defined(CEX_HAS_SSE2)
 		PREFETCHT2(Input.data() + (Offset * ELMLEN), Length);
 #else
-		volatile Array::value_type tmp;
+		volatile typename Array::value_type tmp;
 
 		tmp = 0;
 
@@ -173,7 +173,7 @@ public:
 			const size_t ELMLEN = sizeof(ArrayA::value_type);
 			pctr = 0;
 
-#if defined(CEX_HAS_AVX) || defined(CEX_HAS_AVX2) || defined(CEX_HAS_AVX512)
+#if defined(CEX_HAS_SSE2) || defined(CEX_HAS_AVX2) || defined(CEX_HAS_AVX512)
 #	if defined(CEX_HAS_AVX512)
 			const size_t SMDBLK = 64;
 #	elif defined(CEX_HAS_AVX2)
@@ -192,7 +192,7 @@ public:
 					AND512(Input, InOffset + (pctr / INPLEN), Output, OutOffset + (pctr / OTPLEN));
 #	elif defined(CEX_HAS_AVX2)
 					AND256(Input, InOffset + (pctr / INPLEN), Output, OutOffset + (pctr / OTPLEN));
-#	elif defined(CEX_HAS_AVX)
+#	elif defined(CEX_HAS_SSE2)
 					AND128(Input, InOffset + (pctr / INPLEN), Output, OutOffset + (pctr / OTPLEN));
 #	endif
 					pctr += SMDBLK;
@@ -223,7 +223,7 @@ public:
 		CEXASSERT((Input.size() - InOffset) * INPLEN >= 16, "Length is larger than input size");
 		CEXASSERT((Output.size() - OutOffset) * OTPLEN >= 16, "Length is larger than output size");
 
-#if defined(CEX_HAS_AVX)
+#if defined(CEX_HAS_SSE2)
 		_mm_storeu_si128(reinterpret_cast<__m128i*>(&Output[OutOffset]), _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&Input[InOffset])), _mm_loadu_si128(reinterpret_cast<__m128i*>(&Output[OutOffset]))));
 #else
 		for (size_t i = 0; i < (16 / OTPLEN); ++i)
@@ -306,7 +306,7 @@ public:
 			const size_t ELMLEN = sizeof(Array::value_type);
 			pctr = 0;
 
-#if defined(CEX_HAS_AVX) || defined(CEX_HAS_AVX2) || defined(CEX_HAS_AVX512)
+#if defined(CEX_HAS_SSE2) || defined(CEX_HAS_AVX2) || defined(CEX_HAS_AVX512)
 #	if defined(CEX_HAS_AVX512)
 			const size_t SMDBLK = 64 / ELMLEN;
 #	elif defined(CEX_HAS_AVX2)
@@ -325,7 +325,7 @@ public:
 					CLEAR512(Output, Offset + pctr);
 #	elif defined(CEX_HAS_AVX2)
 					CLEAR256(Output, Offset + pctr);
-#	elif defined(CEX_HAS_AVX)
+#	elif defined(CEX_HAS_SSE2)
 					CLEAR128(Output, Offset + pctr);
 #	endif
 					pctr += SMDBLK;
@@ -365,7 +365,7 @@ public:
 		{
 			pctr = 0;
 
-#if defined(CEX_HAS_AVX) || defined(CEX_HAS_AVX2) || defined(CEX_HAS_AVX512)
+#if defined(CEX_HAS_SSE2) || defined(CEX_HAS_AVX2) || defined(CEX_HAS_AVX512)
 #	if defined(CEX_HAS_AVX512)
 			const size_t SMDBLK = 64;
 #	elif defined(CEX_HAS_AVX2)
@@ -384,7 +384,7 @@ public:
 					_mm512_storeu_si512(reinterpret_cast<__m512i*>(Output + pctr), _mm512_setzero_si512());
 #	elif defined(CEX_HAS_AVX2)
 					_mm256_storeu_si256(reinterpret_cast<__m256i*>(Output + pctr), _mm256_setzero_si256());
-#	elif defined(CEX_HAS_AVX)
+#	elif defined(CEX_HAS_SSE2)
 					_mm_storeu_si128(reinterpret_cast<__m128i*>(Output + pctr), _mm_setzero_si128());
 #	endif
 					pctr += SMDBLK;
@@ -412,7 +412,7 @@ public:
 	template <typename Array>
 	inline static void CLEAR128(Array &Output, size_t Offset)
 	{
-#if defined(CEX_HAS_AVX)
+#if defined(CEX_HAS_SSE2)
 		_mm_storeu_si128(reinterpret_cast<__m128i*>(&Output[Offset]), _mm_setzero_si128());
 #else
 		std::memset(&Output[Offset], 0, 16);
@@ -503,7 +503,7 @@ public:
 		{
 			pctr = 0;
 
-#if defined(CEX_HAS_AVX) || defined(CEX_HAS_AVX2) || defined(CEX_HAS_AVX512)
+#if defined(CEX_HAS_SSE2) || defined(CEX_HAS_AVX2) || defined(CEX_HAS_AVX512)
 #	if defined(CEX_HAS_AVX512)
 			const size_t SMDBLK = 64 / ELMLEN;
 #	elif defined(CEX_HAS_AVX2)
@@ -522,7 +522,7 @@ public:
 					COPY512FROMOBJECT(Input + pctr, Output, OutOffset + pctr);
 #	elif defined(CEX_HAS_AVX2)
 					COPY256FROMOBJECT(Input + pctr, Output, OutOffset + pctr);
-#	elif defined(CEX_HAS_AVX)
+#	elif defined(CEX_HAS_SSE2)
 					COPY128FROMOBJECT(Input + pctr, Output, OutOffset + pctr);
 #	endif
 					pctr += SMDBLK;
@@ -560,7 +560,7 @@ public:
 		{
 			pctr = 0;
 
-#if defined(CEX_HAS_AVX) || defined(CEX_HAS_AVX2) || defined(CEX_HAS_AVX512)
+#if defined(CEX_HAS_SSE2) || defined(CEX_HAS_AVX2) || defined(CEX_HAS_AVX512)
 #	if defined(CEX_HAS_AVX512)
 			const size_t SMDBLK = 64 / ELMLEN;
 #	elif defined(CEX_HAS_AVX2)
@@ -579,7 +579,7 @@ public:
 					COPY512TOOBJECT(Input, InOffset + pctr, Output + pctr);
 #	elif defined(CEX_HAS_AVX2)
 					COPY256TOOBJECT(Input, InOffset + pctr, Output + pctr);
-#	elif defined(CEX_HAS_AVX)
+#	elif defined(CEX_HAS_SSE2)
 					COPY128TOOBJECT(Input, InOffset + pctr, Output + pctr);
 #	endif
 					pctr += SMDBLK;
@@ -655,7 +655,7 @@ public:
 		{
 			pctr = 0;
 
-#if defined(CEX_HAS_AVX) || defined(CEX_HAS_AVX2) || defined(CEX_HAS_AVX512)
+#if defined(CEX_HAS_SSE2) || defined(CEX_HAS_AVX2) || defined(CEX_HAS_AVX512)
 #	if defined(CEX_HAS_AVX512)
 			const size_t SMDBLK = 64 / ELMLEN;
 #	elif defined(CEX_HAS_AVX2)
@@ -674,7 +674,7 @@ public:
 					COPY512(Input, InOffset + pctr, Output, OutOffset + pctr);
 #	elif defined(CEX_HAS_AVX2)
 					COPY256(Input, InOffset + pctr, Output, OutOffset + pctr);
-#	elif defined(CEX_HAS_AVX)
+#	elif defined(CEX_HAS_SSE2)
 					COPY128(Input, InOffset + pctr, Output, OutOffset + pctr);
 #	endif
 					pctr += SMDBLK;
@@ -719,11 +719,11 @@ public:
 			const size_t SMDBLK = 64;
 #	elif defined(CEX_HAS_AVX2)
 			const size_t SMDBLK = 32;
-#	elif defined(CEX_HAS_AVX)
+#	elif defined(CEX_HAS_SSE2)
 			const size_t SMDBLK = 16;
 #	endif
 
-#if defined(CEX_HAS_AVX) || defined(CEX_HAS_AVX2) || defined(CEX_HAS_AVX512)
+#if defined(CEX_HAS_SSE2) || defined(CEX_HAS_AVX2) || defined(CEX_HAS_AVX512)
 			if (Length >= SMDBLK)
 			{
 				const size_t ALNLEN = Length - (Length % SMDBLK);
@@ -734,7 +734,7 @@ public:
 					COPY512(Input, InOffset + (pctr / INPLEN), Output, OutOffset + (pctr / OTPLEN));
 #	elif defined(CEX_HAS_AVX2)
 					COPY256(Input, InOffset + (pctr / INPLEN), Output, OutOffset + (pctr / OTPLEN));
-#	elif defined(CEX_HAS_AVX)
+#	elif defined(CEX_HAS_SSE2)
 					COPY128(Input, InOffset + (pctr / INPLEN), Output, OutOffset + (pctr / OTPLEN));
 #	endif
 					pctr += SMDBLK;
@@ -769,7 +769,7 @@ public:
 		{
 			pctr = 0;
 
-#if defined(CEX_HAS_AVX) || defined(CEX_HAS_AVX2) || defined(CEX_HAS_AVX512)
+#if defined(CEX_HAS_SSE2) || defined(CEX_HAS_AVX2) || defined(CEX_HAS_AVX512)
 #	if defined(CEX_HAS_AVX512)
 			const size_t SMDBLK = 64;
 #	elif defined(CEX_HAS_AVX2)
@@ -788,7 +788,7 @@ public:
 					_mm512_storeu_si512(reinterpret_cast<__m512i*>(Output + pctr), _mm512_loadu_si512(reinterpret_cast<const __m512i*>(Input + pctr)));
 #	elif defined(CEX_HAS_AVX2)
 					_mm256_storeu_si256(reinterpret_cast<__m256i*>(Output + pctr), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(Input + pctr)));
-#	elif defined(CEX_HAS_AVX)
+#	elif defined(CEX_HAS_SSE2)
 					_mm_storeu_si128(reinterpret_cast<__m128i*>(Output + pctr), _mm_loadu_si128(reinterpret_cast<const __m128i*>(Input + pctr)));
 #	endif
 					pctr += SMDBLK;
@@ -816,7 +816,7 @@ public:
 	template <typename Object, typename Array>
 	inline static void COPY128FROMOBJECT(const Object* Input, Array &Output, size_t OutOffset)
 	{
-#if defined(CEX_HAS_AVX)
+#if defined(CEX_HAS_SSE2)
 		_mm_storeu_si128(reinterpret_cast<__m128i*>(&Output[OutOffset]), _mm_loadu_si128(reinterpret_cast<const __m128i*>(Input)));
 #else
 		std::memcpy(&Output[OutOffset], Input, 16);
@@ -836,7 +836,7 @@ public:
 	template <typename Object, typename Array>
 	inline static void COPY128TOOBJECT(Array &Input, size_t InOffset, Object* Output)
 	{
-#if defined(CEX_HAS_AVX)
+#if defined(CEX_HAS_SSE2)
 		_mm_storeu_si128(reinterpret_cast<__m128i*>(Output), _mm_loadu_si128(reinterpret_cast<const __m128i*>(&Input[InOffset])));
 #else
 		std::memcpy(Output, &Input[InOffset], 16);
@@ -857,7 +857,7 @@ public:
 	template <typename ArrayA, typename ArrayB>
 	inline static void COPY128(const ArrayA &Input, size_t InOffset, ArrayB &Output, size_t OutOffset)
 	{
-#if defined(CEX_HAS_AVX)
+#if defined(CEX_HAS_SSE2)
 		_mm_storeu_si128(reinterpret_cast<__m128i*>(&Output[OutOffset]), _mm_loadu_si128(reinterpret_cast<const __m128i*>(&Input[InOffset])));
 #else
 		std::memcpy(&Output[OutOffset], &Input[InOffset], 16);
@@ -1113,7 +1113,7 @@ public:
 		{
 			pctr = 0;
 
-#if defined(CEX_HAS_AVX) || defined(CEX_HAS_AVX2) || defined(CEX_HAS_AVX512)
+#if defined(CEX_HAS_SSE2) || defined(CEX_HAS_AVX2) || defined(CEX_HAS_AVX512)
 #	if defined(CEX_HAS_AVX512)
 			const size_t SMDBLK = 64;
 #	elif defined(CEX_HAS_AVX2)
@@ -1132,7 +1132,7 @@ public:
 					OR512(Input, InOffset + (pctr / INPLEN), Output, OutOffset + (pctr / OTPLEN));
 #	elif defined(CEX_HAS_AVX2)
 					OR256(Input, InOffset + (pctr / INPLEN), Output, OutOffset + (pctr / OTPLEN));
-#	elif defined(CEX_HAS_AVX)
+#	elif defined(CEX_HAS_SSE2)
 					OR128(Input, InOffset + (pctr / INPLEN), Output, OutOffset + (pctr / OTPLEN));
 #	endif
 					pctr += SMDBLK;
@@ -1163,7 +1163,7 @@ public:
 		CEXASSERT((Input.size() - InOffset) * INPLEN >= 16, "Length is larger than input size");
 		CEXASSERT((Output.size() - OutOffset) * OTPLEN >= 16, "Length is larger than output size");
 
-#if defined(CEX_HAS_AVX)
+#if defined(CEX_HAS_SSE2)
 		_mm_storeu_si128(reinterpret_cast<__m128i*>(&Output[OutOffset]), _mm_or_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&Input[InOffset])), _mm_loadu_si128(reinterpret_cast<__m128i*>(&Output[OutOffset]))));
 #else
 		for (size_t i = 0; i < (16 / OTPLEN); ++i)
@@ -1246,7 +1246,7 @@ public:
 		{
 			pctr = 0;
 
-#if defined(CEX_HAS_AVX) || defined(CEX_HAS_AVX2) || defined(CEX_HAS_AVX512)
+#if defined(CEX_HAS_SSE2) || defined(CEX_HAS_AVX2) || defined(CEX_HAS_AVX512)
 #	if defined(CEX_HAS_AVX512)
 			const size_t SMDBLK = 64 / ELMLEN;
 #	elif defined(CEX_HAS_AVX2)
@@ -1265,7 +1265,7 @@ public:
 					SETVAL512(Output, Offset + pctr, Value);
 #	elif defined(CEX_HAS_AVX2)
 					SETVAL256(Output, Offset + pctr, Value);
-#	elif defined(CEX_HAS_AVX)
+#	elif defined(CEX_HAS_SSE2)
 					SETVAL128(Output, Offset + pctr, Value);
 #	endif
 					pctr += SMDBLK;
@@ -1293,7 +1293,7 @@ public:
 	{
 		CEXASSERT((Output.size() - Offset) * sizeof(Array::value_type) >= 16, "Length is larger than output size");
 
-#if defined(CEX_HAS_AVX)
+#if defined(CEX_HAS_SSE2)
 		_mm_storeu_si128(reinterpret_cast<__m128i*>(&Output[Offset]), _mm_set1_epi8(Value));
 #else
 		std::memset(&Output[Offset], Value, 16);
@@ -1369,7 +1369,7 @@ public:
 
 		pctr = 0;
 
-#if defined(CEX_HAS_AVX) || defined(CEX_HAS_AVX2) || defined(CEX_HAS_AVX512)
+#if defined(CEX_HAS_SSE2) || defined(CEX_HAS_AVX2) || defined(CEX_HAS_AVX512)
 #	if defined(CEX_HAS_AVX512)
 		const size_t SMDBLK = 64;
 #	elif defined(CEX_HAS_AVX2)
@@ -1388,7 +1388,7 @@ public:
 				XOR512(Input, InOffset + (pctr / INPLEN), Output, OutOffset + (pctr / OTPLEN));
 #	elif defined(CEX_HAS_AVX2)
 				XOR256(Input, InOffset + (pctr / INPLEN), Output, OutOffset + (pctr / OTPLEN));
-#	elif defined(CEX_HAS_AVX)
+#	elif defined(CEX_HAS_SSE2)
 				XOR128(Input, InOffset + (pctr / INPLEN), Output, OutOffset + (pctr / OTPLEN));
 #	endif
 				pctr += SMDBLK;
@@ -1419,7 +1419,7 @@ public:
 
 		pctr = 0;
 
-#if defined(CEX_HAS_AVX) || defined(CEX_HAS_AVX2) || defined(CEX_HAS_AVX512)
+#if defined(CEX_HAS_SSE2) || defined(CEX_HAS_AVX2) || defined(CEX_HAS_AVX512)
 #	if defined(CEX_HAS_AVX512)
 		const size_t SMDBLK = 64;
 #	elif defined(CEX_HAS_AVX2)
@@ -1438,7 +1438,7 @@ public:
 				_mm512_storeu_si512(reinterpret_cast<__m512i*>(Output + pctr), _mm512_xor_si512(_mm512_loadu_si512(reinterpret_cast<const __m512i*>(Input + pctr)), _mm512_loadu_si512(reinterpret_cast<const __m512i*>(Output + pctr))));
 #	elif defined(CEX_HAS_AVX2)
 				_mm256_storeu_si256(reinterpret_cast<__m256i*>(Output + pctr), _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(Input + pctr)), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(Output + pctr))));
-#	elif defined(CEX_HAS_AVX)
+#	elif defined(CEX_HAS_SSE2)
 				_mm_storeu_si128(reinterpret_cast<__m128i*>(Output + pctr), _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(Input + pctr)), _mm_loadu_si128(reinterpret_cast<__m128i*>(Output + pctr))));
 #	endif
 				pctr += SMDBLK;
@@ -1452,6 +1452,59 @@ public:
 		}
 	}
 
+	/// <summary>
+	/// Block XOR two 8-bit byte arrays, writing the result to a third array.
+	/// <para>The Length is the number of *bytes* (8 bit integers) to XOR.
+	/// The output may be the same address as either input, so a transform can be in-place.
+	/// If the length is at least the size of an intrinsics integer boundary: (16=AVX, 32=AVX2, 64=AVX512), 
+	/// the operation is vectorized, otherwise this is a sequential XOR operation.</para>
+	/// </summary>
+	/// 
+	/// <param name="InputA">The first source integer array</param>
+	/// <param name="InputB">The second source integer array</param>
+	/// <param name="Output">The destination integer array</param>
+	/// <param name="Length">The number of bytes to process</param>
+	inline static void XorRaw(const uint8_t* InputA, const uint8_t* InputB, uint8_t* Output, size_t Length)
+	{
+		size_t pctr;
+
+		CEXASSERT(Length > 0, "Length can not be zero");
+
+		pctr = 0;
+
+#if defined(CEX_HAS_SSE2) || defined(CEX_HAS_AVX2) || defined(CEX_HAS_AVX512)
+#	if defined(CEX_HAS_AVX512)
+		const size_t SMDBLK = 64;
+#	elif defined(CEX_HAS_AVX2)
+		const size_t SMDBLK = 32;
+#	else
+		const size_t SMDBLK = 16;
+#	endif
+
+		if (Length >= SMDBLK)
+		{
+			const size_t ALNLEN = Length - (Length % SMDBLK);
+
+			while (pctr != ALNLEN)
+			{
+#	if defined(CEX_HAS_AVX512)
+				_mm512_storeu_si512(reinterpret_cast<__m512i*>(Output + pctr), _mm512_xor_si512(_mm512_loadu_si512(reinterpret_cast<const __m512i*>(InputA + pctr)), _mm512_loadu_si512(reinterpret_cast<const __m512i*>(InputB + pctr))));
+#	elif defined(CEX_HAS_AVX2)
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(Output + pctr), _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(InputA + pctr)), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(InputB + pctr))));
+#	elif defined(CEX_HAS_SSE2)
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(Output + pctr), _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(InputA + pctr)), _mm_loadu_si128(reinterpret_cast<const __m128i*>(InputB + pctr))));
+#	endif
+				pctr += SMDBLK;
+			}
+		}
+#endif
+		while (pctr < Length)
+		{
+			Output[pctr] = InputA[pctr] ^ InputB[pctr];
+			++pctr;
+		}
+	}
+
 	/// <summary>
 	/// Block XOR 128 bits
 	/// </summary>
@@ -1469,7 +1522,7 @@ public:
 		CEXASSERT((Input.size() - InOffset) * INPLEN >= 16, "Length is larger than input size");
 		CEXASSERT((Output.size() - OutOffset) * OTPLEN >= 16, "Length is larger than output size");
 
-#if defined(CEX_HAS_AVX)
+#if defined(CEX_HAS_SSE2)
 		_mm_storeu_si128(reinterpret_cast<__m128i*>(&Output[OutOffset]), _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&Input[InOffset])), _mm_loadu_si128(reinterpret_cast<__m128i*>(&Output[OutOffset]))));
 #else
 		for (size_t i = 0; i < (16 / OTPLEN); ++i)
@@ -1615,7 +1668,7 @@ public:
 			}
 		}
 
-#elif defined(CEX_HAS_AVX)
+#elif defined(CEX_HAS_SSE2)
 
 		const size_t SMDLEN = sizeof(__m128i);
 		const size_t ALNLEN = (Output.size() / SMDLEN) * SMDLEN;
@@ -55,6 +55,7 @@ OFB::OFB(BlockCiphers CipherType)
 		throw CryptoCipherModeException(CipherModeConvert::ToName(CipherModes::OFB), std::string("Constructor"), std::string("The cipher type can not be none!"), ErrorCodes::InvalidParam)),
 	m_parallelProfile(m_blockCipher->BlockSize(), false, BLOCK_SIZE, false, 1)
 {
+	m_parallelProfile.SetAlgorithm(Name());
 }
 
 OFB::OFB(IBlockCipher* Cipher)
@@ -65,6 +66,7 @@ OFB::OFB(IBlockCipher* Cipher)
 		throw CryptoCipherModeException(CipherModeConvert::ToName(CipherModes::OFB), std::string("Constructor"), std::string("The cipher type can not be null!"), ErrorCodes::IllegalOperation)),
 	m_parallelProfile(m_blockCipher->BlockSize(), false, BLOCK_SIZE, false, 1)
 {
+	m_parallelProfile.SetAlgorithm(Name());
 }
 
 OFB::~OFB()
@@ -168,6 +170,13 @@ void OFB::DecryptBlock(const std::vector<uint8_t> &Input, size_t InOffset, std::
 	Encrypt128(Input, InOffset, Output, OutOffset);
 }
 
+void OFB::DecryptBlock(const uint8_t* Input, uint8_t* Output)
+{
+	CEXASSERT(IsInitialized(), "The cipher mode has not been initialized!");
+
+	Encrypt128(Input, Output);
+}
+
 void OFB::EncryptBlock(const std::vector<uint8_t> &Input, std::vector<uint8_t> &Output)
 {
 	CEXASSERT(IsInitialized(), "The cipher mode has not been initialized!");
@@ -182,6 +191,13 @@ void OFB::EncryptBlock(const std::vector<uint8_t> &Input, size_t InOffset, std::
 	Encrypt128(Input, InOffset, Output, OutOffset);
 }
 
+void OFB::EncryptBlock(const uint8_t* Input, uint8_t* Output)
+{
+	CEXASSERT(IsInitialized(), "The cipher mode has not been initialized!");
+
+	Encrypt128(Input, Output);
+}
+
 void OFB::Initialize(bool Encryption, ISymmetricKey &Parameters)
 {
 	if (!SymmetricKeySize::Contains(LegalKeySizes(), Parameters.KeySizes().KeySize(), Parameters.KeySizes().IVSize()))
@@ -218,10 +234,29 @@ void OFB::Transform(const std::vector<uint8_t> &Input, size_t InOffset, std::vec
 	}
 }
 
-void OFB::Encrypt128(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset)
+void OFB::Transform(const uint8_t* Input, uint8_t* Output, size_t Length)
+{
+	CEXASSERT(IsInitialized(), "The cipher mode has not been initialized!");
+
+	const size_t BLKLEN = m_blockCipher->BlockSize();
+	size_t i;
+
+	if (Length % BLKLEN != 0)
+	{
+		throw CryptoCipherModeException(Name(), std::string("Transform"), std::string("Invalid length, must be evenly divisible by the ciphers block size!"), ErrorCodes::InvalidSize);
+	}
+
+	const size_t BLKCNT = Length / BLKLEN;
+
+	for (i = 0; i < BLKCNT; ++i)
+	{
+		Encrypt128(Input + (i * BLKLEN), Output + (i * BLKLEN));
+	}
+}
+
+void OFB::Encrypt128(const uint8_t* Input, uint8_t* Output)
 {
 	CEXASSERT(m_ofbState->Initialized, "The cipher mode has not been initialized!");
-	CEXASSERT(IntegerTools::Min(Input.size() - InOffset, Output.size() - OutOffset) >= m_blockCipher->BlockSize(), "The data arrays are smaller than the block-size!");
 
 	size_t i;
 
@@ -230,11 +265,18 @@ void OFB::Encrypt128(const std::vector<uint8_t> &Input, size_t InOffset, std::ve
 	// xor the iv with the plaintext producing the cipher-text and the next input block
 	for (i = 0; i < BLOCK_SIZE; i++)
 	{
-		Output[OutOffset + i] = static_cast<uint8_t>(m_ofbState->Buffer[i] ^ Input[InOffset + i]);
+		Output[i] = static_cast<uint8_t>(m_ofbState->Buffer[i] ^ Input[i]);
 	}
 
 	// shift output into right end of shift register
 	MemoryTools::Copy(m_ofbState->Buffer, 0, m_ofbState->IV, 0, BLOCK_SIZE);
 }
 
+void OFB::Encrypt128(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset)
+{
+	CEXASSERT(IntegerTools::Min(Input.size() - InOffset, Output.size() - OutOffset) >= m_blockCipher->BlockSize(), "The data arrays are smaller than the block-size!");
+
+	Encrypt128(Input.data() + InOffset, Output.data() + OutOffset);
+}
+
 NAMESPACE_MODEEND
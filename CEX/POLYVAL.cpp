@@ -0,0 +1,142 @@
+#include "POLYVAL.h"
+#include "IntegerTools.h"
+#include "MemoryTools.h"
+#if defined(CEX_HAS_SSE2)
+#	include "Intrinsics.h"
+#endif
+
+NAMESPACE_DIGEST
+
+using Tools::IntegerTools;
+using Tools::MemoryTools;
+
+const std::string POLYVAL::CLASS_NAME("POLYVAL");
+
+//~~~Constructor~~~//
+
+POLYVAL::POLYVAL()
+	:
+	m_msgBuffer(BUFFER_SIZE, 0x00),
+	m_ghashFunction(new GHASH())
+{
+}
+
+POLYVAL::~POLYVAL()
+{
+	Reset();
+}
+
+//~~~Public Functions~~~//
+
+void POLYVAL::Finalize(std::vector<uint8_t> &Output, size_t ADLength, size_t TxtLength)
+{
+	// the byte reversed length block is the ghash length block with the lengths swapped
+	m_ghashFunction->Finalize(Output, TxtLength, ADLength);
+	m_ghashFunction->Clear();
+	Reverse(Output.data(), Output.data(), BLOCK_SIZE);
+}
+
+void POLYVAL::Initialize(const std::vector<uint8_t> &Key)
+{
+	std::vector<uint8_t> tmph(BLOCK_SIZE);
+	uint8_t carry;
+	size_t i;
+
+	// the ghash key is mulX_GHASH(ByteReverse(H))
+	Reverse(Key.data(), tmph.data(), BLOCK_SIZE);
+	carry = tmph[BLOCK_SIZE - 1] & 0x01;
+
+	for (i = BLOCK_SIZE - 1; i > 0; --i)
+	{
+		tmph[i] = static_cast<uint8_t>((tmph[i] >> 1) | (tmph[i - 1] << 7));
+	}
+
+	tmph[0] >>= 1;
+	tmph[0] ^= static_cast<uint8_t>(0xE1 & (0x00 - carry));
+
+	std::vector<uint64_t> gkey =
+	{
+		IntegerTools::BeBytesTo64(tmph, 0),
+		IntegerTools::BeBytesTo64(tmph, 8)
+	};
+
+	m_ghashFunction->Initialize(gkey);
+	MemoryTools::Clear(tmph, 0, tmph.size());
+	MemoryTools::Clear(gkey, 0, gkey.size() * sizeof(uint64_t));
+}
+
+void POLYVAL::Reset()
+{
+	m_ghashFunction->Reset();
+	MemoryTools::Clear(m_msgBuffer, 0, m_msgBuffer.size());
+}
+
+const size_t POLYVAL::TagSize()
+{
+	return TAG_SIZE;
+}
+
+void POLYVAL::Update(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t Length)
+{
+	CEXASSERT(Input.size() - InOffset >= Length, "The input array is too small");
+
+	Update(Input.data() + InOffset, Output, Length);
+}
+
+void POLYVAL::Update(const uint8_t* Input, std::vector<uint8_t> &Output, size_t Length)
+{
+	size_t blen;
+
+	while (Length != 0)
+	{
+		blen = IntegerTools::Min(Length, BUFFER_SIZE);
+		Reverse(Input, m_msgBuffer.data(), blen);
+		// the partial block is padded to a full block
+		m_ghashFunction->Update(m_msgBuffer.data(), Output, ((blen + BLOCK_SIZE - 1) / BLOCK_SIZE) * BLOCK_SIZE);
+		Input += blen;
+		Length -= blen;
+	}
+}
+
+//~~~Private Functions~~~//
+
+void POLYVAL::Reverse(const uint8_t* Input, uint8_t* Output, size_t Length)
+{
+	std::array<uint8_t, BLOCK_SIZE> tmpb;
+	size_t i;
+	size_t j;
+
+	i = 0;
+
+#if defined(CEX_HAS_SSE2)
+	__m128i x;
+
+	// sse2 baseline byte reversal: reverse the words, then the halves of each word, then the bytes of each half
+	for (; i + BLOCK_SIZE <= Length; i += BLOCK_SIZE)
+	{
+		x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Input + i));
+		x = _mm_shuffle_epi32(x, 0x1B);
+		x = _mm_shufflehi_epi16(_mm_shufflelo_epi16(x, 0xB1), 0xB1);
+		x = _mm_or_si128(_mm_slli_epi16(x, 8), _mm_srli_epi16(x, 8));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(Output + i), x);
+	}
+#endif
+
+	// the last partial block is zero-padded before it is reversed
+	for (; i < Length; i += BLOCK_SIZE)
+	{
+		const size_t BLKLEN = IntegerTools::Min(Length - i, BLOCK_SIZE);
+
+		tmpb.fill(0x00);
+		MemoryTools::CopyRaw(Input + i, tmpb.data(), BLKLEN);
+
+		for (j = 0; j < BLOCK_SIZE; ++j)
+		{
+			Output[i + j] = tmpb[BLOCK_SIZE - 1 - j];
+		}
+	}
+
+	MemoryTools::Clear(tmpb, 0, tmpb.size());
+}
+
+NAMESPACE_DIGESTEND
@@ -0,0 +1,109 @@
+#ifndef CEX_POLYVAL_H
+#define CEX_POLYVAL_H
+
+#include "CexDomain.h"
+#include "GHASH.h"
+
+NAMESPACE_DIGEST
+
+/// <summary>
+/// Instantiate the POLYVAL class; this is an *internal class* used by GCM-SIV mode.
+/// <para>POLYVAL is evaluated with the GHASH multiply and aggregated reduction kernels, using the identity from RFC 8452, Appendix A:
+/// POLYVAL(H, X1..Xn) = ByteReverse(GHASH(mulX_GHASH(ByteReverse(H)), ByteReverse(X1)..ByteReverse(Xn))).
+/// The input blocks are byte reversed into a small buffer before they are passed to GHASH, and the hash state is kept in the GHASH byte order until Finalize.</para>
+/// </summary>
+class POLYVAL
+{
+private:
+
+	static const size_t BLOCK_SIZE = 16;
+	// the number of bytes reversed per call to the ghash update
+	static const size_t BUFFER_SIZE = 32 * BLOCK_SIZE;
+	static const std::string CLASS_NAME;
+	static const size_t TAG_SIZE = 16;
+
+	std::vector<uint8_t> m_msgBuffer;
+	std::unique_ptr<GHASH> m_ghashFunction;
+
+public:
+
+	//~~~Constructor~~~//
+
+	/// <summary>
+	/// Copy constructor: copy is restricted, this function has been deleted
+	/// </summary>
+	POLYVAL(const POLYVAL&) = delete;
+
+	/// <summary>
+	/// Copy operator: copy is restricted, this function has been deleted
+	/// </summary>
+	POLYVAL& operator=(const POLYVAL&) = delete;
+
+	/// <summary>
+	/// Constructor: instantiate this class; this is an internal class used by GCM-SIV mode
+	/// </summary>
+	POLYVAL();
+
+	/// <summary>
+	/// Destructor: finalize this class
+	/// </summary>
+	~POLYVAL();
+
+	//~~~Public Functions~~~//
+
+	/// <summary>
+	/// Absorb the length block, and write the POLYVAL result to the state array.
+	/// <para>The length block is the little-endian bit length of the associated data, followed by the bit length of the message.
+	/// The key is retained, and the function can be reused after the state array is cleared.</para>
+	/// </summary>
+	///
+	/// <param name="Output">The hash state array; receives the 16 byte POLYVAL result</param>
+	/// <param name="ADLength">The byte length of the associated data</param>
+	/// <param name="TxtLength">The byte length of the message</param>
+	void Finalize(std::vector<uint8_t> &Output, size_t ADLength, size_t TxtLength);
+
+	/// <summary>
+	/// Initialize the hash key
+	/// </summary>
+	///
+	/// <param name="Key">The 16 byte POLYVAL key</param>
+	void Initialize(const std::vector<uint8_t> &Key);
+
+	/// <summary>
+	/// Reset the hash function
+	/// </summary>
+	void Reset();
+
+	/// <summary>
+	/// Read Only: The hash code length in bytes
+	/// </summary>
+	const size_t TagSize();
+
+	/// <summary>
+	/// Update the hash function.
+	/// <para>A partial last block is zero-padded, so the associated data and the message are each passed with one or more calls,
+	/// where only the last call of each may have a length that is not a multiple of 16 bytes.</para>
+	/// </summary>
+	///
+	/// <param name="Input">The source array</param>
+	/// <param name="InOffset">The offset within the source array</param>
+	/// <param name="Output">The hash state array</param>
+	/// <param name="Length">The number of bytes to process</param>
+	void Update(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t Length);
+
+	/// <summary>
+	/// Update the hash function, reading the message directly from caller memory
+	/// </summary>
+	///
+	/// <param name="Input">A pointer to the first input byte</param>
+	/// <param name="Output">The hash state array</param>
+	/// <param name="Length">The number of bytes to process</param>
+	void Update(const uint8_t* Input, std::vector<uint8_t> &Output, size_t Length);
+
+private:
+
+	static void Reverse(const uint8_t* Input, uint8_t* Output, size_t Length);
+};
+
+NAMESPACE_DIGESTEND
+#endif
@@ -0,0 +1,154 @@
+#include "ParallelGovernor.h"
+#include <thread>
+
+NAMESPACE_TOOLS
+
+//~~~Constructor~~~//
+
+ParallelGovernor::ParallelGovernor()
+	:
+	m_capacity(0),
+	m_isEnabled(true),
+	m_fullGrants(0),
+	m_inFlight(0),
+	m_peakInFlight(0),
+	m_reducedGrants(0),
+	m_sequentialGrants(0)
+{
+	SetCapacity(0);
+}
+
+ParallelGovernor::~ParallelGovernor()
+{
+	m_capacity = 0;
+	m_isEnabled = false;
+	m_inFlight = 0;
+	ResetCounters();
+}
+
+//~~~Accessors~~~//
+
+size_t ParallelGovernor::Capacity()
+{
+	return m_capacity;
+}
+
+size_t ParallelGovernor::FullGrants()
+{
+	return m_fullGrants;
+}
+
+size_t ParallelGovernor::InFlight()
+{
+	return m_inFlight;
+}
+
+bool ParallelGovernor::IsEnabled()
+{
+	return m_isEnabled;
+}
+
+size_t ParallelGovernor::PeakInFlight()
+{
+	return m_peakInFlight;
+}
+
+size_t ParallelGovernor::ReducedGrants()
+{
+	return m_reducedGrants;
+}
+
+size_t ParallelGovernor::SequentialGrants()
+{
+	return m_sequentialGrants;
+}
+
+//~~~Public Functions~~~//
+
+ParallelGovernor& ParallelGovernor::Instance()
+{
+	static ParallelGovernor gov;
+
+	return gov;
+}
+
+size_t ParallelGovernor::Acquire(size_t Degree)
+{
+	const size_t RQSDEG = (Degree != 0) ? Degree : 1;
+	size_t avl;
+	size_t cur;
+	size_t grt;
+	size_t pek;
+
+	cur = m_inFlight.load();
+
+	do
+	{
+		if (m_isEnabled)
+		{
+			// the calling thread is one of the granted threads, so a grant of one is a sequential run
+			avl = (m_capacity > cur) ? m_capacity - cur : 0;
+			grt = (avl >= RQSDEG) ? RQSDEG : (avl > 1) ? avl : 1;
+		}
+		else
+		{
+			grt = RQSDEG;
+		}
+	}
+	while (!m_inFlight.compare_exchange_weak(cur, cur + grt));
+
+	pek = m_peakInFlight.load();
+
+	while (cur + grt > pek && !m_peakInFlight.compare_exchange_weak(pek, cur + grt))
+	{
+	}
+
+	if (grt == RQSDEG)
+	{
+		++m_fullGrants;
+	}
+	else if (grt > 1)
+	{
+		++m_reducedGrants;
+	}
+	else
+	{
+		++m_sequentialGrants;
+	}
+
+	return grt;
+}
+
+void ParallelGovernor::Release(size_t Granted)
+{
+	m_inFlight -= Granted;
+}
+
+void ParallelGovernor::ResetCounters()
+{
+	m_fullGrants = 0;
+	m_peakInFlight = m_inFlight.load();
+	m_reducedGrants = 0;
+	m_sequentialGrants = 0;
+}
+
+void ParallelGovernor::SetCapacity(size_t Threads)
+{
+	const size_t PRCCNT = static_cast<size_t>(std::thread::hardware_concurrency());
+
+	if (Threads != 0)
+	{
+		m_capacity = Threads;
+	}
+	else
+	{
+		m_capacity = (PRCCNT != 0) ? PRCCNT : 1;
+	}
+}
+
+void ParallelGovernor::SetEnabled(bool Enabled)
+{
+	m_isEnabled = Enabled;
+}
+
+NAMESPACE_TOOLSEND
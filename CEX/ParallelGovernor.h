@@ -0,0 +1,147 @@
+// The GPL version 3 License (GPLv3)
+//
+// Copyright (c) 2023 QSCS.ca
+// This file is part of the CEX Cryptographic library.
+//
+// This program is free software : you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef CEX_PARALLELGOVERNOR_H
+#define CEX_PARALLELGOVERNOR_H
+
+#include "CexDomain.h"
+#include <atomic>
+
+NAMESPACE_TOOLS
+
+/// <summary>
+/// A process-wide concurrency governor for the library's parallel loops.
+/// <para>Tracks the number of threads committed to in-flight parallel loops, and scales the degree granted to each new loop down to the processor cores still available.
+/// When the machine is saturated, a loop is granted a single thread and runs sequentially on the calling thread.
+/// Many concurrent callers of a parallel Transform therefore share the processor cores, instead of each fanning out ParallelMaxDegree() threads.</para>
+/// </summary>
+///
+/// <example>
+/// <description>Reading the governor decision counters:</description>
+/// <code>
+/// ParallelGovernor &amp;gov = ParallelGovernor::Instance();
+/// size_t full = gov.FullGrants();
+/// size_t reduced = gov.ReducedGrants();
+/// size_t sequential = gov.SequentialGrants();
+/// </code>
+/// </example>
+class ParallelGovernor final
+{
+private:
+
+	std::atomic<size_t> m_capacity;
+	std::atomic<bool> m_isEnabled;
+	std::atomic<size_t> m_fullGrants;
+	std::atomic<size_t> m_inFlight;
+	std::atomic<size_t> m_peakInFlight;
+	std::atomic<size_t> m_reducedGrants;
+	std::atomic<size_t> m_sequentialGrants;
+
+	ParallelGovernor(const ParallelGovernor&) = delete;
+
+	ParallelGovernor& operator=(const ParallelGovernor&) = delete;
+
+	ParallelGovernor();
+
+	~ParallelGovernor();
+
+public:
+
+	//~~~Accessors~~~//
+
+	/// <summary>
+	/// Read Only: The number of threads the governor allows across all in-flight parallel loops; defaults to the processor count
+	/// </summary>
+	size_t Capacity();
+
+	/// <summary>
+	/// Read Only: The number of loops granted their full requested degree
+	/// </summary>
+	size_t FullGrants();
+
+	/// <summary>
+	/// Read Only: The number of threads currently committed to parallel loops
+	/// </summary>
+	size_t InFlight();
+
+	/// <summary>
+	/// Read/Write: The governor is active; when disabled every loop is granted its requested degree
+	/// </summary>
+	bool IsEnabled();
+
+	/// <summary>
+	/// Read Only: The highest number of threads committed to parallel loops at one time
+	/// </summary>
+	size_t PeakInFlight();
+
+	/// <summary>
+	/// Read Only: The number of loops granted fewer threads than requested
+	/// </summary>
+	size_t ReducedGrants();
+
+	/// <summary>
+	/// Read Only: The number of loops run sequentially on the calling thread because the processor was saturated
+	/// </summary>
+	size_t SequentialGrants();
+
+	//~~~Public Functions~~~//
+
+	/// <summary>
+	/// Get the process-wide governor instance
+	/// </summary>
+	static ParallelGovernor& Instance();
+
+	/// <summary>
+	/// Request threads for a parallel loop, and commit the granted threads to the in-flight count.
+	/// <para>Every call must be paired with a call to Release(size_t) using the returned value.</para>
+	/// </summary>
+	///
+	/// <param name="Degree">The requested degree of parallelism</param>
+	///
+	/// <returns>The granted degree, between 1 and Degree</returns>
+	size_t Acquire(size_t Degree);
+
+	/// <summary>
+	/// Return the threads granted by Acquire(size_t) when the loop completes
+	/// </summary>
+	///
+	/// <param name="Granted">The degree returned by Acquire(size_t)</param>
+	void Release(size_t Granted);
+
+	/// <summary>
+	/// Reset the decision counters and the in-flight peak
+	/// </summary>
+	void ResetCounters();
+
+	/// <summary>
+	/// Set the number of threads the governor allows across all in-flight loops
+	/// </summary>
+	///
+	/// <param name="Threads">The thread capacity; a value of zero restores the processor count</param>
+	void SetCapacity(size_t Threads);
+
+	/// <summary>
+	/// Enable or disable the governor
+	/// </summary>
+	///
+	/// <param name="Enabled">Governor state, enabled by default</param>
+	void SetEnabled(bool Enabled);
+};
+
+NAMESPACE_TOOLSEND
+#endif
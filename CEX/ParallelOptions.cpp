@@ -1,5 +1,9 @@
 #include "ParallelOptions.h"
 #include "CpuDetect.h"
+#include "CpuTopology.h"
+#include "ParallelTuner.h"
+#include "SimdDispatch.h"
+#include <algorithm>
 
 NAMESPACE_ROOT
 
@@ -11,6 +15,7 @@ const std::string ParallelOptions::CLASS_NAME("ParallelOptions");
 
 ParallelOptions::ParallelOptions(size_t BlockSize, bool SimdMultiply, size_t ReservedCache, bool SplitChannel, size_t ParallelMaxDegree)
 	:
+	m_algorithmName(""),
 	m_autoInit(true),
 	m_blockSize(BlockSize != 0 && BlockSize % 2 == 0 ? BlockSize :
 		throw CryptoProcessingException(CLASS_NAME, std::string("Constructor"), std::string("The BlockSize must be a positive even number!"), ErrorCodes::InvalidParam)),
@@ -19,13 +24,17 @@ ParallelOptions::ParallelOptions(size_t BlockSize, bool SimdMultiply, size_t Res
 	m_hasSimd128(false),
 	m_hasSimd256(false),
 	m_hasSimd512(false),
+	m_isHybrid(false),
 	m_isParallel(false),
 	m_l1DataCacheReserved(ReservedCache),
 	m_l1DataCacheTotal(0),
 	m_overrideMaxDegree(false),
 	m_parallelBlockSize(0),
+	m_parallelExecutor(nullptr),
 	m_parallelMaxDegree(ParallelMaxDegree),
 	m_parallelMinimumSize(0),
+	m_parallelPlacement(ParallelPlacements::None),
+	m_parallelSegments(0),
 	m_physicalCores(0),
 	m_processorCount(0),
 	m_simdDetected(SimdProfiles::None),
@@ -41,6 +50,7 @@ ParallelOptions::ParallelOptions(size_t BlockSize, bool SimdMultiply, size_t Res
 
 ParallelOptions::ParallelOptions(size_t BlockSize, bool Parallel, bool SimdMultiply, size_t ReservedCache, bool SplitChannel, size_t ParallelMaxDegree)
 	:
+	m_algorithmName(""),
 	m_autoInit(true),
 	m_blockSize(BlockSize != 0 && BlockSize % 2 == 0 ? BlockSize :
 		throw CryptoProcessingException(CLASS_NAME, std::string("Constructor"), std::string("The BlockSize must be a positive even number!"), ErrorCodes::InvalidParam)),
@@ -49,13 +59,17 @@ ParallelOptions::ParallelOptions(size_t BlockSize, bool Parallel, bool SimdMulti
 	m_hasSimd128(false),
 	m_hasSimd256(false),
 	m_hasSimd512(false),
+	m_isHybrid(false),
 	m_isParallel(Parallel),
 	m_l1DataCacheReserved(ReservedCache),
 	m_l1DataCacheTotal(0),
 	m_overrideMaxDegree(false),
 	m_parallelBlockSize(0),
+	m_parallelExecutor(nullptr),
 	m_parallelMaxDegree(ParallelMaxDegree),
 	m_parallelMinimumSize(0),
+	m_parallelPlacement(ParallelPlacements::None),
+	m_parallelSegments(0),
 	m_physicalCores(0),
 	m_processorCount(0),
 	m_simdDetected(SimdProfiles::None),
@@ -73,6 +87,7 @@ ParallelOptions::ParallelOptions(size_t BlockSize, bool Parallel, bool SimdMulti
 
 ParallelOptions::ParallelOptions(size_t BlockSize, bool Parallel, size_t ParallelBlockSize, size_t ParallelMaxDegree, bool SimdMultiply, size_t ReservedCache, bool SplitChannel)
 	:
+	m_algorithmName(""),
 	m_autoInit(false),
 	m_blockSize(BlockSize != 0 && BlockSize % 2 == 0 ? BlockSize :
 		throw CryptoProcessingException(CLASS_NAME, std::string("Constructor"), std::string("The BlockSize must be a positive even number!"), ErrorCodes::InvalidParam)),
@@ -82,13 +97,17 @@ ParallelOptions::ParallelOptions(size_t BlockSize, bool Parallel, size_t Paralle
 	m_hasSimd128(false),
 	m_hasSimd256(false),
 	m_hasSimd512(false),
+	m_isHybrid(false),
 	m_isParallel(Parallel),
 	m_l1DataCacheReserved(ReservedCache),
 	m_l1DataCacheTotal(0),
 	m_overrideMaxDegree(false),
 	m_parallelBlockSize(ParallelBlockSize),
+	m_parallelExecutor(nullptr),
 	m_parallelMaxDegree(ParallelMaxDegree),
 	m_parallelMinimumSize(0),
+	m_parallelPlacement(ParallelPlacements::None),
+	m_parallelSegments(0),
 	m_physicalCores(0),
 	m_processorCount(0),
 	m_simdDetected(SimdProfiles::None),
@@ -121,6 +140,11 @@ const size_t ParallelOptions::BlockSize()
 	return m_blockSize;
 }
 
+IParallelExecutor* ParallelOptions::Executor()
+{
+	return m_parallelExecutor;
+}
+
 const bool ParallelOptions::HasPrefetch() 
 { 
 	return m_hasPrefetch; 
@@ -156,6 +180,11 @@ const size_t ParallelOptions::L1DataCacheReserved()
 	return m_l1DataCacheReserved;
 }
 
+const bool ParallelOptions::IsHybrid()
+{
+	return m_isHybrid;
+}
+
 bool &ParallelOptions::IsParallel()
 {
 	return m_isParallel;
@@ -181,16 +210,39 @@ const size_t ParallelOptions::ParallelMaxDegree()
 	return m_parallelMaxDegree; 
 }
 
+const size_t ParallelOptions::ParallelSegmentCount()
+{
+	return m_parallelSegments;
+}
+
 const size_t ParallelOptions::PhysicalCores() 
 { 
 	return m_physicalCores; 
 }
 
+const ParallelPlacements ParallelOptions::Placement()
+{
+	return m_parallelPlacement;
+}
+
 const size_t ParallelOptions::ProcessorCount()
 {
 	return m_virtualCores != 0 ? m_virtualCores : m_physicalCores;
 }
 
+const std::string ParallelOptions::ProfileKey()
+{
+	std::string name(m_algorithmName);
+
+	// the profile file is whitespace delimited
+	std::replace(name.begin(), name.end(), ' ', '_');
+
+	return name + std::string("-B") + std::to_string(m_blockSize) + 
+		std::string("-R") + std::to_string(m_l1DataCacheReserved) + 
+		std::string("-M") + std::to_string(m_simdMultiply ? 1 : 0) + 
+		std::string("-C") + std::to_string(m_splitChannel ? 1 : 0);
+}
+
 const SimdProfiles ParallelOptions::SimdProfile() 
 { 
 	return m_simdDetected;
@@ -219,13 +271,8 @@ void ParallelOptions::Calculate()
 
 	if (m_simdMultiply)
 	{
-#if defined(CEX_HAS_AVX512)
+		// the modes process 16 blocks per call, the cipher selects its widest kernel at run-time
 		m_parallelMinimumSize *= 16;
-#elif defined(CEX_HAS_AVX2)
-		m_parallelMinimumSize *= 8;
-#elif defined(CEX_HAS_AVX)
-		m_parallelMinimumSize *= 4;
-#endif
 	}
 
 	// first init is auto
@@ -241,6 +288,7 @@ void ParallelOptions::Calculate()
 
 		// default to capability
 		m_isParallel = (m_processorCount > 1);
+
 		// on init only
 		m_autoInit = false;
 	}
@@ -267,6 +315,8 @@ void ParallelOptions::Calculate()
 	{
 		m_parallelBlockSize = m_parallelBlockSize - (m_parallelBlockSize % m_parallelMinimumSize);
 	}
+
+	CalculateSegments();
 }
 
 void ParallelOptions::Calculate(bool Parallel, size_t ParallelBlockSize, size_t MaxDegree)
@@ -288,6 +338,7 @@ void ParallelOptions::Calculate(bool Parallel, size_t ParallelBlockSize, size_t
 
 void ParallelOptions::Reset()
 {
+	m_algorithmName.clear();
 	m_autoInit = false;
 	m_blockSize = 0;
 	m_defaultParams.IsParallel = false;
@@ -298,13 +349,17 @@ void ParallelOptions::Reset()
 	m_hasSimd128 = false;
 	m_hasSimd256 = false;
 	m_hasSimd512 = false;
+	m_isHybrid = false;
 	m_isParallel = false;
 	m_l1DataCacheReserved = 0;
 	m_l1DataCacheTotal = 0;
 	m_overrideMaxDegree = false;
 	m_parallelBlockSize = 0;
+	m_parallelExecutor = nullptr;
 	m_parallelMaxDegree = 0;
 	m_parallelMinimumSize = 0;
+	m_parallelPlacement = ParallelPlacements::None;
+	m_parallelSegments = 0;
 	m_physicalCores = 0;
 	m_processorCount = 0;
 	m_simdDetected = SimdProfiles::None;
@@ -314,6 +369,24 @@ void ParallelOptions::Reset()
 	m_wideBlock = false;
 }
 
+void ParallelOptions::SetAlgorithm(const std::string &Name)
+{
+	Tools::ParallelTuner &tnr = Tools::ParallelTuner::Instance();
+	size_t tblk;
+	bool tprl;
+
+	m_algorithmName = Name;
+
+	// a measured host profile replaces the cache estimate, unless the values have been changed
+	if (tnr.Count() != 0 && IsDefault() && tnr.Find(ProfileKey(), tblk, tprl) && tblk >= m_parallelMinimumSize)
+	{
+		m_parallelBlockSize = tblk;
+		m_isParallel = (tprl && m_processorCount > 1);
+		Calculate();
+		StoreDefaults();
+	}
+}
+
 void ParallelOptions::SetBlockSize(size_t BlockSize)
 {
 	if (BlockSize < m_parallelMinimumSize)
@@ -325,6 +398,17 @@ void ParallelOptions::SetBlockSize(size_t BlockSize)
 	Calculate();
 }
 
+void ParallelOptions::SetExecutor(IParallelExecutor* Executor)
+{
+	m_parallelExecutor = Executor;
+}
+
+void ParallelOptions::SetHybrid(bool Hybrid)
+{
+	m_isHybrid = Hybrid;
+	CalculateSegments();
+}
+
 void ParallelOptions::SetMaxDegree(size_t MaxDegree)
 {
 	if (MaxDegree == 0)
@@ -337,11 +421,37 @@ void ParallelOptions::SetMaxDegree(size_t MaxDegree)
 	Calculate();
 }
 
+void ParallelOptions::SetPlacement(ParallelPlacements Placement)
+{
+	m_parallelPlacement = Placement;
+}
+
 //~~~Private Functions~~~//
 
+void ParallelOptions::CalculateSegments()
+{
+	size_t mul;
+
+	m_parallelSegments = m_parallelMaxDegree;
+
+	if (m_isHybrid && m_parallelMinimumSize != 0)
+	{
+		// the largest multiplier that keeps each segment a whole multiple of the per-thread minimum size
+		for (mul = HYBRID_SEGMENTS; mul > 1; --mul)
+		{
+			if (m_parallelBlockSize % (m_parallelMinimumSize * mul) == 0)
+			{
+				m_parallelSegments = m_parallelMaxDegree * mul;
+				break;
+			}
+		}
+	}
+}
+
 void ParallelOptions::Detect()
 {
-	CpuDetect dtc;
+	CpuDetect &dtc = CpuDetect::Instance();
+	CpuTopology &topo = CpuTopology::Instance();
 
 	m_hasPrefetch = dtc.PREFETCH();
 	m_hasSHA2 = dtc.SHA();
@@ -350,10 +460,7 @@ void ParallelOptions::Detect()
 	m_hasSimd512 = dtc.AVX512F();
 	m_physicalCores = dtc.PhysicalCores();
 
-	m_simdDetected = m_hasSimd512 ? SimdProfiles::Simd512 : 
-		m_hasSimd256 ? SimdProfiles::Simd256 : 
-		m_hasSimd128 ? SimdProfiles::Simd128 :
-		SimdProfiles::None;
+	m_simdDetected = Tools::SimdDispatch::Instance().Detected();
 
 	m_virtualCores = dtc.VirtualCores();
 	m_processorCount = (m_virtualCores > m_physicalCores) ? m_virtualCores : m_physicalCores;
@@ -369,6 +476,7 @@ void ParallelOptions::Detect()
 	}
 
 	m_isParallel = (m_processorCount > 1);
+	m_isHybrid = topo.IsHybrid();
 	m_l1DataCacheTotal = dtc.L1DataCacheTotal();
 }
 
@@ -4,12 +4,15 @@
 #include "CexDomain.h"
 #include "CpuCores.h"
 #include "CryptoProcessingException.h"
+#include "IParallelExecutor.h"
+#include "ParallelPlacements.h"
 #include "SimdProfiles.h"
 
 NAMESPACE_ROOT
 
 using Enumeration::CpuCores;
 using Exception::CryptoProcessingException;
+using Enumeration::ParallelPlacements;
 using Enumeration::SimdProfiles;
 
 /// <summary>
@@ -52,7 +55,10 @@ private:
 	const size_t DEF_DATACACHE = 16384;
 	// 32mb, not enforced
 	const size_t MAX_PRLALLOC = DEF_DATACACHE * 2000;
+	// the maximum number of segments per thread on hybrid processors
+	const size_t HYBRID_SEGMENTS = 4;
 
+	std::string m_algorithmName;
 	bool m_autoInit;
 	size_t m_blockSize;
 	AutoParallelParams m_defaultParams;
@@ -61,13 +67,17 @@ private:
 	bool m_hasSimd128;
 	bool m_hasSimd256;
 	bool m_hasSimd512;
+	bool m_isHybrid;
 	bool m_isParallel;
 	size_t m_l1DataCacheReserved;
 	size_t m_l1DataCacheTotal;
 	bool m_overrideMaxDegree;
 	size_t m_parallelBlockSize;
+	IParallelExecutor* m_parallelExecutor;
 	size_t m_parallelMaxDegree;
 	size_t m_parallelMinimumSize;
+	ParallelPlacements m_parallelPlacement;
+	size_t m_parallelSegments;
 	size_t m_physicalCores;
 	size_t m_processorCount;
 	SimdProfiles m_simdDetected;
@@ -158,6 +168,11 @@ public:
 	/// </summary>
 	const size_t BlockSize();
 
+	/// <summary>
+	/// Read Only: The executor that runs this algorithms parallel loops, or nullptr if the process-wide executor is used
+	/// </summary>
+	IParallelExecutor* Executor();
+
 	/// <summary>
 	/// Read Only: Returns True if the system supports prefetch intrinsics
 	/// </summary>
@@ -196,6 +211,11 @@ public:
 	/// </summary>
 	const size_t L1DataCacheReserved();
 
+	/// <summary>
+	/// Read Only: The processor has cores of more than one performance class, and the parallel block is divided into more segments than threads
+	/// </summary>
+	const bool IsHybrid();
+
 	/// <summary>
 	/// Read/Write: Enable automatic processor parallelization
 	/// </summary>
@@ -222,18 +242,38 @@ public:
 	/// </summary>
 	const size_t ParallelMaxDegree();
 
+	/// <summary>
+	/// Read Only: The number of segments a parallel block is divided into.
+	/// <para>Equal to ParallelMaxDegree() on homogeneous processors. On hybrid processors the block is divided into up to four segments per thread, 
+	/// the segments are claimed dynamically, so the faster cores process more of the block and the slower cores no longer determine the completion time.</para>
+	/// </summary>
+	const size_t ParallelSegmentCount();
+
 	/// <summary>
 	/// Read Only: The number of processor cores available on the system
 	/// </summary>
 	const size_t PhysicalCores();
 
+	/// <summary>
+	/// Read Only: The thread placement policy applied to this algorithms parallel loops; the default is ParallelPlacements::None
+	/// </summary>
+	const ParallelPlacements Placement();
+
 	/// <summary>
 	/// Read Only: The maximum number of processor cores available on the system including virtul cores
 	/// </summary>
 	const size_t ProcessorCount();
 
 	/// <summary>
-	/// Read Only: The maximum supported SIMD instruction set
+	/// Read Only: The key that identifies this algorithm configuration in the ParallelTuner host profile.
+	/// <para>Derived from the algorithm name set with SetAlgorithm, the block size, the reserved cache size, the SIMD multiplier and the channel layout.</para>
+	/// </summary>
+	const std::string ProfileKey();
+
+	/// <summary>
+	/// Read Only: The maximum supported SIMD instruction set.
+	/// <para>This is the profile detected by SimdDispatch; the processor supports it and the operating system saves its register state. 
+	/// The kernel variant used by a call is chosen by SimdDispatch, which also applies the per-kernel wide thresholds.</para>
 	/// </summary>
 	const SimdProfiles SimdProfile();
 
@@ -274,6 +314,16 @@ public:
 	/// </summary>
 	void Reset();
 
+	/// <summary>
+	/// Set the name of the algorithm that owns this profile, and apply its measured ParallelTuner entry.
+	/// <para>The name is part of the ProfileKey, so each algorithm, and each mode and cipher combination, is calibrated and stored separately.
+	/// The owning algorithm sets its name when it is constructed; if the tuner holds an entry for the key, and the profile still holds its default values,
+	/// the measured parallel block size and parallel state replace the cache-size estimate and become the new defaults.</para>
+	/// </summary>
+	/// 
+	/// <param name="Name">The formal name of the owning algorithm, i.e. CTR-AES</param>
+	void SetAlgorithm(const std::string &Name);
+
 	/// <summary>
 	/// Define parallel-block length in bytes.
 	/// <para>Re-calculates the auto-configured [recommended] valuesand replaces it with a user-defined size.</para>
@@ -282,6 +332,21 @@ public:
 	/// <param name="BlockSize">The new parallel block-size</param>
 	void SetBlockSize(size_t BlockSize);
 
+	/// <summary>
+	/// Set the executor used to schedule this algorithms parallel loops.
+	/// <para>The executor is not owned by this class, and must outlive the algorithm instance; passing nullptr restores the process-wide executor.</para>
+	/// </summary>
+	/// 
+	/// <param name="Executor">The host executor instance, or nullptr</param>
+	void SetExecutor(IParallelExecutor* Executor);
+
+	/// <summary>
+	/// Override the hybrid processor detection, and re-calculate the parallel segment count
+	/// </summary>
+	/// 
+	/// <param name="Hybrid">Divide the parallel block into multiple segments per thread</param>
+	void SetHybrid(bool Hybrid);
+
 	/// <summary>
 	/// Define parallel-block and parallel-minimum sizes based on the max number of cores assigned.
 	/// <para>Re-calculates the default recommended option values based on the number of processor cores (threads) assigned to the operation.
@@ -293,8 +358,18 @@ public:
 	/// a value of 0, or greater than the processors virtual-core count, defaults to the processors virtual-core count</param>
 	void SetMaxDegree(size_t MaxDegree);
 
+	/// <summary>
+	/// Set the thread placement policy used to schedule this algorithms parallel loops.
+	/// <para>A placement other than None pins the pool worker threads to processors; NodeLocal runs each loop on the NUMA node holding the output buffer.
+	/// The placement applies to the library pool, it is ignored by a host executor or an OpenMP build.</para>
+	/// </summary>
+	/// 
+	/// <param name="Placement">The thread placement policy</param>
+	void SetPlacement(ParallelPlacements Placement);
+
 	//~~~Private Functions~~~//
 
+	void CalculateSegments();
 	void Detect();
 	void StoreDefaults();
 };
@@ -0,0 +1,32 @@
+#ifndef CEX_PARALLELPLACEMENTS_H
+#define CEX_PARALLELPLACEMENTS_H
+
+#include "CexDomain.h"
+
+NAMESPACE_ENUMERATION
+
+/// <summary>
+/// The thread placement policy used by the parallel cipher and digest modes
+/// </summary>
+enum class ParallelPlacements : uint8_t
+{
+	/// <summary>
+	/// Worker threads are scheduled by the operating system (default)
+	/// </summary>
+	None = 0,
+	/// <summary>
+	/// Workers are pinned, and a loop runs on the workers of the NUMA node the calling thread is running on
+	/// </summary>
+	Compact = 1,
+	/// <summary>
+	/// Workers are pinned, interleaved across the NUMA nodes, and a loop is spread over every node
+	/// </summary>
+	Scatter = 2,
+	/// <summary>
+	/// Workers are pinned, and a loop runs on the workers of the NUMA node that owns the output buffer pages
+	/// </summary>
+	NodeLocal = 3
+};
+
+NAMESPACE_ENUMERATIONEND
+#endif
@@ -0,0 +1,96 @@
+#include "ParallelScratch.h"
+#include "MemoryTools.h"
+
+NAMESPACE_TOOLS
+
+//~~~Constructor~~~//
+
+ParallelScratch::ParallelScratch()
+	:
+	m_workerBuffers(0),
+	m_workerCounters(0)
+{
+}
+
+ParallelScratch::~ParallelScratch()
+{
+	Clear();
+	m_workerBuffers.clear();
+	m_workerCounters.clear();
+}
+
+//~~~Accessors~~~//
+
+std::vector<uint8_t> &ParallelScratch::Buffer(size_t Worker)
+{
+	CEXASSERT(Worker < m_workerBuffers.size(), "The worker index exceeds the reserved count");
+
+	return m_workerBuffers[Worker];
+}
+
+std::vector<uint8_t> &ParallelScratch::Counter(size_t Worker)
+{
+	CEXASSERT(Worker < m_workerCounters.size(), "The worker index exceeds the reserved count");
+
+	return m_workerCounters[Worker];
+}
+
+size_t ParallelScratch::Workers() const
+{
+	return m_workerCounters.size();
+}
+
+//~~~Public Functions~~~//
+
+void ParallelScratch::Clear()
+{
+	size_t i;
+
+	for (i = 0; i < m_workerCounters.size(); ++i)
+	{
+		MemoryTools::Clear(m_workerCounters[i], 0, m_workerCounters[i].size());
+		MemoryTools::Clear(m_workerBuffers[i], 0, m_workerBuffers[i].size());
+	}
+}
+
+void ParallelScratch::Reserve(size_t Workers, size_t CounterSize, size_t BufferSize)
+{
+	size_t i;
+
+	if (m_workerCounters.size() < Workers)
+	{
+		m_workerCounters.resize(Workers);
+		m_workerBuffers.resize(Workers);
+	}
+
+	for (i = 0; i < Workers; ++i)
+	{
+		if (m_workerCounters[i].size() != CounterSize)
+		{
+			Resize(m_workerCounters[i], CounterSize);
+		}
+
+		if (m_workerBuffers[i].size() != BufferSize)
+		{
+			Resize(m_workerBuffers[i], BufferSize);
+		}
+	}
+}
+
+//~~~Private Functions~~~//
+
+void ParallelScratch::Resize(std::vector<uint8_t> &Buffer, size_t Length)
+{
+	// the unused tail capacity keeps the next allocation off the cache line of this buffer
+	if (Buffer.capacity() < Length + CACHELINE_SIZE)
+	{
+		MemoryTools::Clear(Buffer, 0, Buffer.size());
+		Buffer.clear();
+		Buffer.shrink_to_fit();
+		Buffer.reserve(Length + CACHELINE_SIZE);
+	}
+
+	Buffer.resize(Length);
+}
+
+NAMESPACE_TOOLSEND
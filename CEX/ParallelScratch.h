@@ -0,0 +1,95 @@
+#ifndef CEX_PARALLELSCRATCH_H
+#define CEX_PARALLELSCRATCH_H
+
+#include "CexDomain.h"
+
+NAMESPACE_TOOLS
+
+/// cond private
+
+/// <summary>
+/// Internal class: the per-worker scratch buffers of a parallel cipher instance, reused across Transform calls.
+/// <para>Each worker of a parallel loop owns a counter buffer and a block buffer, indexed by the loop iteration. 
+/// Every buffer is over-allocated by a cache line, so the bytes written by two workers never share a line. 
+/// The buffers are allocated on first use and grow only when the worker count or a buffer size increases; 
+/// once warmed up, the cipher transform performs no heap allocation for its counters.</para>
+/// </summary>
+class ParallelScratch final
+{
+private:
+
+	static const size_t CACHELINE_SIZE = 64;
+
+	std::vector<std::vector<uint8_t>> m_workerBuffers;
+	std::vector<std::vector<uint8_t>> m_workerCounters;
+
+public:
+
+	//~~~Constructor~~~//
+
+	/// <summary>
+	/// Copy constructor: copy is restricted, this function has been deleted
+	/// </summary>
+	ParallelScratch(const ParallelScratch&) = delete;
+
+	/// <summary>
+	/// Copy operator: copy is restricted, this function has been deleted
+	/// </summary>
+	ParallelScratch& operator=(const ParallelScratch&) = delete;
+
+	/// <summary>
+	/// Constructor: instantiate an empty scratch set
+	/// </summary>
+	ParallelScratch();
+
+	/// <summary>
+	/// Destructor: erase and release the buffers
+	/// </summary>
+	~ParallelScratch();
+
+	//~~~Accessors~~~//
+
+	/// <summary>
+	/// The block buffer of a worker
+	/// </summary>
+	///
+	/// <param name="Worker">The worker index</param>
+	std::vector<uint8_t> &Buffer(size_t Worker);
+
+	/// <summary>
+	/// The counter buffer of a worker
+	/// </summary>
+	///
+	/// <param name="Worker">The worker index</param>
+	std::vector<uint8_t> &Counter(size_t Worker);
+
+	/// <summary>
+	/// The number of workers the buffers are allocated for
+	/// </summary>
+	size_t Workers() const;
+
+	//~~~Public Functions~~~//
+
+	/// <summary>
+	/// Erase the contents of the buffers; the memory is retained
+	/// </summary>
+	void Clear();
+
+	/// <summary>
+	/// Ensure the buffers exist for a worker count; allocates only if the count or a size is larger than the current layout
+	/// </summary>
+	///
+	/// <param name="Workers">The number of workers</param>
+	/// <param name="CounterSize">The size of each counter buffer in bytes</param>
+	/// <param name="BufferSize">The size of each block buffer in bytes</param>
+	void Reserve(size_t Workers, size_t CounterSize, size_t BufferSize);
+
+private:
+
+	static void Resize(std::vector<uint8_t> &Buffer, size_t Length);
+};
+
+/// endcond
+
+NAMESPACE_TOOLSEND
+#endif
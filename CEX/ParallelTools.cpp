@@ -1,13 +1,41 @@
 #include "ParallelTools.h"
-
+#include "CpuTopology.h"
+#include "ParallelGovernor.h"
+#include "WorkStealingPool.h"
+#include <atomic>
 #if defined(CEX_HAS_OPENMP)
 #	include <omp.h>
-#else
-#	include <future>
 #endif
 
 NAMESPACE_TOOLS
 
+namespace
+{
+	// the host installed executor, nullptr selects the library default
+	std::atomic<IParallelExecutor*> GlobalExecutor(nullptr);
+
+	// the shared iteration cursor of a loop folded onto fewer threads
+	struct LoopCursor
+	{
+		std::atomic<size_t> Next;
+		size_t To;
+		const std::function<void(size_t)>* Loop;
+
+		LoopCursor(size_t From, size_t Last, const std::function<void(size_t)>* Function)
+			:
+			Next(From),
+			To(Last),
+			Loop(Function)
+		{
+		}
+	};
+}
+
+IParallelExecutor* ParallelTools::Executor()
+{
+	return GlobalExecutor.load();
+}
+
 size_t ParallelTools::ProcessorCount()
 {
 #if defined(CEX_HAS_OPENMP)
@@ -19,35 +47,52 @@ size_t ParallelTools::ProcessorCount()
 
 void ParallelTools::ParallelFor(size_t From, size_t To, const std::function<void(size_t)> &F)
 {
-#if defined(CEX_HAS_OPENMP)
-#	pragma omp parallel num_threads(static_cast<int32_t>(To))
+	IParallelExecutor* exec = GlobalExecutor.load();
+
+	if (exec != nullptr)
 	{
-		size_t i = From + static_cast<size_t>(omp_get_thread_num());
-		F(i);
+		// a host executor schedules against its own core budget
+		exec->BulkRun(From, To, F);
 	}
-#else
-	std::vector<std::future<void>> futures;
-
-	for (size_t i = From; i < To; ++i)
+	else
 	{
-		auto fut = std::async([i, F]()
-		{
-			F(i);
-		});
-		futures.push_back(std::move(fut));
+		Schedule(From, To, F, To - From, ParallelPlacements::None, nullptr);
 	}
+}
+
+void ParallelTools::ParallelFor(ParallelOptions &Options, size_t From, size_t To, const std::function<void(size_t)> &F)
+{
+	ParallelFor(Options, nullptr, From, To, F);
+}
+
+void ParallelTools::ParallelFor(ParallelOptions &Options, const void* Locality, size_t From, size_t To, const std::function<void(size_t)> &F)
+{
+	IParallelExecutor* exec = (Options.Executor() != nullptr) ? Options.Executor() : GlobalExecutor.load();
 
-	for (size_t i = 0; i < futures.size(); ++i)
+	if (exec != nullptr)
 	{
-		futures[i].wait();
+		exec->BulkRun(From, To, F);
+	}
+	else
+	{
+		Schedule(From, To, F, Options.ParallelMaxDegree(), Options.Placement(), Locality);
 	}
-
-	futures.clear();
-#endif
 }
 
 void ParallelTools::ParallelTask(const std::function<void()> &F)
 {
+	IParallelExecutor* exec = GlobalExecutor.load();
+
+	if (exec != nullptr)
+	{
+		exec->BulkRun(0, 1, [&F](size_t)
+		{
+			F();
+		});
+
+		return;
+	}
+
 #if defined(CEX_HAS_OPENMP)
 #	pragma omp parallel
 	{
@@ -57,15 +102,108 @@ void ParallelTools::ParallelTask(const std::function<void()> &F)
 		}
 	}
 #else
-	std::future<void> fut = std::async(std::launch::async, [F]()
+	WorkStealingPool::Instance().Run(F);
+#endif
+}
+
+void ParallelTools::Dispatch(size_t From, size_t To, const std::function<void(size_t)> &F, ParallelPlacements Placement, const void* Locality)
+{
+#if defined(CEX_HAS_OPENMP)
+	// thread placement is left to the OpenMP runtime (OMP_PROC_BIND, OMP_PLACES)
+	static_cast<void>(Placement);
+	static_cast<void>(Locality);
+
+#	pragma omp parallel num_threads(static_cast<int32_t>(To - From))
 	{
-		F();
-	});
+		size_t i = From + static_cast<size_t>(omp_get_thread_num());
+		F(i);
+	}
+#else
+	WorkStealingPool &pool = WorkStealingPool::Instance();
+	CpuTopology &topo = CpuTopology::Instance();
+	int32_t node;
+
+	// dispatch to the persistent pool; no threads are created per call
+	if (Placement == ParallelPlacements::None)
+	{
+		pool.BulkRun(From, To, F);
+	}
+	else
+	{
+		pool.Pin();
+		node = -1;
 
-	fut.get();
+		if (Placement == ParallelPlacements::NodeLocal)
+		{
+			// the system node numbers are mapped to the pools node queue indices
+			node = topo.NodeIndex(CpuTopology::MemoryNode(Locality));
+		}
+
+		if (Placement == ParallelPlacements::Compact || (Placement == ParallelPlacements::NodeLocal && node < 0))
+		{
+			node = topo.NodeIndex(CpuTopology::CurrentNode());
+		}
+
+		pool.BulkRun(From, To, F, node);
+	}
 #endif
 }
 
+void ParallelTools::Schedule(size_t From, size_t To, const std::function<void(size_t)> &F, size_t Degree, ParallelPlacements Placement, const void* Locality)
+{
+	if (To > From)
+	{
+		const size_t LOPCNT = To - From;
+		ParallelGovernor &gov = ParallelGovernor::Instance();
+		const size_t GRTDEG = gov.Acquire((Degree != 0 && Degree < LOPCNT) ? Degree : LOPCNT);
+		LoopCursor cur(From, To, &F);
+		size_t i;
+
+		try
+		{
+			if (GRTDEG == LOPCNT)
+			{
+				Dispatch(From, To, F, Placement, Locality);
+			}
+			else if (GRTDEG > 1)
+			{
+				// the granted threads claim iterations from a shared cursor, so a faster core runs more of the loop;
+				// each iteration is independent, so the output is unchanged
+				// the cursor is captured by a single pointer, which std::function stores without a heap allocation
+				LoopCursor* pcur = &cur;
+
+				Dispatch(0, GRTDEG, [pcur](size_t)
+				{
+					for (size_t k = pcur->Next++; k < pcur->To; k = pcur->Next++)
+					{
+						(*pcur->Loop)(k);
+					}
+				}, Placement, Locality);
+			}
+			else
+			{
+				// the processor is saturated, run sequentially on the calling thread
+				for (i = From; i < To; ++i)
+				{
+					F(i);
+				}
+			}
+		}
+		catch (...)
+		{
+			gov.Release(GRTDEG);
+			throw;
+		}
+
+		gov.Release(GRTDEG);
+	}
+}
+
+void ParallelTools::SetExecutor(IParallelExecutor* Executor)
+{
+	GlobalExecutor.store(Executor);
+}
+
 void ParallelTools::Vectorize(const std::function<void()> &F)
 {
 #if defined(CEX_OPENMP_VERSION_30)
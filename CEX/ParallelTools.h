@@ -20,10 +20,14 @@
 #define CEX_PARALLELUTILS_H
 
 #include "CexDomain.h"
+#include "IParallelExecutor.h"
+#include "ParallelOptions.h"
 #include <functional>
 
 NAMESPACE_TOOLS
 
+using Enumeration::ParallelPlacements;
+
 /// <summary>
 /// Parallel functions class
 /// </summary> 
@@ -32,7 +36,9 @@ class ParallelTools
 public:
 
 	/// <summary>
-	/// A multi-threaded parallel For loop
+	/// A multi-threaded parallel For loop.
+	/// <para>Iterations are dispatched to the process-wide persistent work-stealing pool, the calling thread runs iterations until the loop completes.
+	/// The degree is limited by the ParallelGovernor; when the processor cores are committed to other loops, the iterations are folded onto fewer threads, or run sequentially on the calling thread.</para>
 	/// </summary>
 	/// 
 	/// <param name="From">The inclusive starting position</param> 
@@ -41,17 +47,110 @@ public:
 	static void ParallelFor(size_t From, size_t To, const std::function<void(size_t)> &F);
 
 	/// <summary>
-	/// Execute a function on a new thread
+	/// A multi-threaded parallel For loop scheduled through an algorithms parallel options.
+	/// <para>Runs on the executor installed in the ParallelOptions instance, or on the process-wide executor if none has been set.
+	/// At most ParallelMaxDegree() threads run the loop; when the range is larger, as with the segments of a hybrid processor profile, the threads claim iterations dynamically.</para>
+	/// </summary>
+	/// 
+	/// <param name="Options">The calling algorithms parallel options</param>
+	/// <param name="From">The inclusive starting position</param> 
+	/// <param name="To">The exclusive ending position</param>
+	/// <param name="F">The function delegate</param>
+	static void ParallelFor(ParallelOptions &Options, size_t From, size_t To, const std::function<void(size_t)> &F);
+
+	/// <summary>
+	/// A multi-threaded parallel For loop scheduled through an algorithms parallel options, with a memory locality hint.
+	/// <para>When the options placement is ParallelPlacements::NodeLocal, the loop runs on the pool workers of the NUMA node that owns the Locality address, 
+	/// typically the output buffer written by the loop. The hint is ignored by the other placement policies.</para>
+	/// </summary>
+	/// 
+	/// <param name="Options">The calling algorithms parallel options</param>
+	/// <param name="Locality">An address in the memory written by the loop, or nullptr</param>
+	/// <param name="From">The inclusive starting position</param> 
+	/// <param name="To">The exclusive ending position</param>
+	/// <param name="F">The function delegate</param>
+	static void ParallelFor(ParallelOptions &Options, const void* Locality, size_t From, size_t To, const std::function<void(size_t)> &F);
+
+	/// <summary>
+	/// A multi-threaded parallel For loop over a function object.
+	/// <para>The function object is passed to the scheduler through a pointer-sized wrapper, so a lambda with a large capture list 
+	/// does not cause a std::function heap allocation on each call.</para>
+	/// </summary>
+	/// 
+	/// <param name="From">The inclusive starting position</param> 
+	/// <param name="To">The exclusive ending position</param>
+	/// <param name="F">The function object</param>
+	template<typename Function>
+	static void ParallelFor(size_t From, size_t To, const Function &F)
+	{
+		const Function* fnc = &F;
+
+		ParallelFor(From, To, std::function<void(size_t)>([fnc](size_t I) { (*fnc)(I); }));
+	}
+
+	/// <summary>
+	/// A multi-threaded parallel For loop over a function object, scheduled through an algorithms parallel options.
+	/// <para>The function object is passed to the scheduler through a pointer-sized wrapper, so a lambda with a large capture list 
+	/// does not cause a std::function heap allocation on each call.</para>
+	/// </summary>
+	/// 
+	/// <param name="Options">The calling algorithms parallel options</param>
+	/// <param name="From">The inclusive starting position</param> 
+	/// <param name="To">The exclusive ending position</param>
+	/// <param name="F">The function object</param>
+	template<typename Function>
+	static void ParallelFor(ParallelOptions &Options, size_t From, size_t To, const Function &F)
+	{
+		const Function* fnc = &F;
+
+		ParallelFor(Options, nullptr, From, To, std::function<void(size_t)>([fnc](size_t I) { (*fnc)(I); }));
+	}
+
+	/// <summary>
+	/// A multi-threaded parallel For loop over a function object, scheduled through an algorithms parallel options, with a memory locality hint.
+	/// <para>The function object is passed to the scheduler through a pointer-sized wrapper, so a lambda with a large capture list 
+	/// does not cause a std::function heap allocation on each call.</para>
+	/// </summary>
+	/// 
+	/// <param name="Options">The calling algorithms parallel options</param>
+	/// <param name="Locality">An address in the memory written by the loop, or nullptr</param>
+	/// <param name="From">The inclusive starting position</param> 
+	/// <param name="To">The exclusive ending position</param>
+	/// <param name="F">The function object</param>
+	template<typename Function>
+	static void ParallelFor(ParallelOptions &Options, const void* Locality, size_t From, size_t To, const Function &F)
+	{
+		const Function* fnc = &F;
+
+		ParallelFor(Options, Locality, From, To, std::function<void(size_t)>([fnc](size_t I) { (*fnc)(I); }));
+	}
+
+	/// <summary>
+	/// Execute a function on a pool worker thread and wait for it to complete
 	/// </summary>
 	/// 
 	/// <param name="F">The function delegate</param>
 	static void ParallelTask(const std::function<void()> &F);
 
+	/// <summary>
+	/// Read Only: The process-wide executor installed with SetExecutor(IParallelExecutor*), or nullptr if the library default is used
+	/// </summary>
+	static IParallelExecutor* Executor();
+
 	/// <summary>
 	/// Read Only: The number of processors available on the system
 	/// </summary>
 	static size_t ProcessorCount();
 
+	/// <summary>
+	/// Install a process-wide executor used by every parallel loop that does not set its own executor.
+	/// <para>The executor is not owned by the library, and must remain valid until it is replaced or the process exits.
+	/// Passing nullptr restores the library default scheduler.</para>
+	/// </summary>
+	/// 
+	/// <param name="Executor">The host executor instance, or nullptr</param>
+	static void SetExecutor(IParallelExecutor* Executor);
+
 	/// <summary>
 	/// An SIMD vectorized For loop (not currently used, requires a higher version of OpenMP)
 	/// </summary>
@@ -59,6 +158,11 @@ public:
 	/// <param name="F">The function delegate</param>
 	static void Vectorize(const std::function<void()> &F);
 
+private:
+
+	static void Dispatch(size_t From, size_t To, const std::function<void(size_t)> &F, ParallelPlacements Placement, const void* Locality);
+	static void Schedule(size_t From, size_t To, const std::function<void(size_t)> &F, size_t Degree, ParallelPlacements Placement, const void* Locality);
+
 };
 
 NAMESPACE_TOOLSEND
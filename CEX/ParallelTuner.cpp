@@ -0,0 +1,282 @@
+#include "ParallelTuner.h"
+#include "CpuDetect.h"
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+NAMESPACE_TOOLS
+
+const std::string ParallelTuner::PROFILE_HEADER("CEX-PARALLEL-PROFILE-2");
+const std::string ParallelTuner::PROFILE_VARIABLE("CEX_PARALLEL_PROFILE");
+
+//~~~Constructor~~~//
+
+ParallelTuner::ParallelTuner()
+	:
+	m_hostFingerprint(""),
+	m_profileCount(0),
+	m_profileEntries(),
+	m_profileMutex()
+{
+	CpuDetect &dtc = CpuDetect::Instance();
+	std::ostringstream oss;
+
+	// the values the cache heuristic and the parallel degree are derived from
+	oss << "P" << dtc.PhysicalCores() << "-V" << dtc.VirtualCores() <<
+		"-L1D" << dtc.L1DataCacheTotal() << "-L2" << dtc.L2CacheSize() <<
+		"-F" << dtc.FrequencyMax() <<
+		"-S" << (dtc.AVX512F() ? 512 : dtc.AVX2() ? 256 : dtc.AVX() ? 128 : 0);
+	m_hostFingerprint = oss.str();
+
+	// allow the startup profile to be set via environment variable
+	if (const char* env = std::getenv(PROFILE_VARIABLE.c_str()))
+	{
+		Load(std::string(env));
+	}
+}
+
+ParallelTuner::~ParallelTuner()
+{
+	m_profileCount = 0;
+	m_profileEntries.clear();
+}
+
+//~~~Accessors~~~//
+
+size_t ParallelTuner::Count()
+{
+	return m_profileCount;
+}
+
+const std::string &ParallelTuner::HostFingerprint()
+{
+	return m_hostFingerprint;
+}
+
+//~~~Public Functions~~~//
+
+ParallelTuner& ParallelTuner::Instance()
+{
+	static ParallelTuner tnr;
+
+	return tnr;
+}
+
+bool ParallelTuner::Calibrate(ParallelOptions &Profile, const std::function<void(size_t)> &Transform)
+{
+	const std::string KEY = Profile.ProfileKey();
+	const size_t MINLEN = Profile.ParallelMinimumSize();
+	const size_t PRLBLK = Profile.ParallelBlockSize();
+	const bool PRLSTT = Profile.IsParallel();
+	std::vector<size_t> cnd(0);
+	std::vector<uint64_t> tms(0);
+	uint64_t bstms;
+	uint64_t seqms;
+	size_t blen;
+	size_t tlen;
+	size_t i;
+	bool prl;
+	bool res;
+
+	res = false;
+
+	if (Profile.ProcessorCount() > 1 && MINLEN != 0 && MINLEN <= CAL_MAXLEN)
+	{
+		// the test length is a whole multiple of every candidate block size
+		tlen = MINLEN;
+
+		while (tlen * 2 <= CAL_MAXLEN)
+		{
+			tlen *= 2;
+		}
+
+		try
+		{
+			Profile.IsParallel() = false;
+			seqms = Measure(Transform, tlen);
+			Profile.IsParallel() = true;
+			bstms = seqms;
+
+			for (blen = MINLEN; blen <= tlen; blen *= 2)
+			{
+				Profile.SetBlockSize(blen);
+				cnd.push_back(blen);
+				tms.push_back(Measure(Transform, tlen));
+				bstms = (tms.back() < bstms) ? tms.back() : bstms;
+			}
+		}
+		catch (...)
+		{
+			Profile.IsParallel() = PRLSTT;
+			Profile.SetBlockSize(PRLBLK < MINLEN ? MINLEN : PRLBLK);
+			throw;
+		}
+
+		// the smallest block size within tolerance of the best time; a smaller block is also a lower parallel crossover
+		blen = cnd.back();
+
+		for (i = 0; i < cnd.size(); ++i)
+		{
+			if (tms[i] * 100 <= bstms * (100 + CAL_TOLERANCE))
+			{
+				blen = cnd[i];
+				break;
+			}
+		}
+
+		prl = (bstms * 100 < seqms * (100 - CAL_TOLERANCE));
+
+		if (prl)
+		{
+			Profile.SetBlockSize(blen);
+		}
+		else
+		{
+			blen = (PRLBLK < MINLEN) ? MINLEN : PRLBLK;
+			Profile.SetBlockSize(blen);
+		}
+
+		Profile.IsParallel() = prl;
+		Store(KEY, blen, prl);
+		res = true;
+	}
+
+	return res;
+}
+
+void ParallelTuner::Clear()
+{
+	std::lock_guard<std::mutex> lock(m_profileMutex);
+
+	m_profileEntries.clear();
+	m_profileCount = 0;
+}
+
+bool ParallelTuner::Find(const std::string &ProfileKey, size_t &ParallelBlockSize, bool &IsParallel)
+{
+	std::map<std::string, TuningEntry>::const_iterator itr;
+	bool res;
+
+	res = false;
+
+	// the common case, no profile is loaded, does not take the lock
+	if (m_profileCount != 0)
+	{
+		std::lock_guard<std::mutex> lock(m_profileMutex);
+
+		itr = m_profileEntries.find(ProfileKey);
+
+		if (itr != m_profileEntries.end())
+		{
+			ParallelBlockSize = itr->second.ParallelBlockSize;
+			IsParallel = itr->second.IsParallel;
+			res = true;
+		}
+	}
+
+	return res;
+}
+
+bool ParallelTuner::Load(const std::string &Path)
+{
+	std::ifstream ifs(Path.c_str());
+	std::map<std::string, TuningEntry> ent;
+	std::string hdr;
+	std::string hst;
+	std::string key;
+	TuningEntry tent;
+	size_t plen;
+	int32_t pflg;
+	bool res;
+
+	res = false;
+
+	if (ifs.is_open() && (ifs >> hdr >> hst) && hdr == PROFILE_HEADER && hst == m_hostFingerprint)
+	{
+		while (ifs >> key >> plen >> pflg)
+		{
+			tent.ParallelBlockSize = plen;
+			tent.IsParallel = (pflg != 0);
+			ent[key] = tent;
+		}
+
+		// a truncated or malformed line invalidates the profile
+		if (ifs.eof())
+		{
+			std::lock_guard<std::mutex> lock(m_profileMutex);
+
+			for (std::map<std::string, TuningEntry>::const_iterator itr = ent.begin(); itr != ent.end(); ++itr)
+			{
+				m_profileEntries[itr->first] = itr->second;
+			}
+
+			m_profileCount = m_profileEntries.size();
+			res = true;
+		}
+	}
+
+	return res;
+}
+
+bool ParallelTuner::Save(const std::string &Path)
+{
+	std::ofstream ofs(Path.c_str(), std::ofstream::trunc);
+	bool res;
+
+	res = false;
+
+	if (ofs.is_open())
+	{
+		std::lock_guard<std::mutex> lock(m_profileMutex);
+
+		ofs << PROFILE_HEADER << " " << m_hostFingerprint << "\n";
+
+		for (std::map<std::string, TuningEntry>::const_iterator itr = m_profileEntries.begin(); itr != m_profileEntries.end(); ++itr)
+		{
+			ofs << itr->first << " " << itr->second.ParallelBlockSize << " " << (itr->second.IsParallel ? 1 : 0) << "\n";
+		}
+
+		ofs.flush();
+		res = ofs.good();
+	}
+
+	return res;
+}
+
+void ParallelTuner::Store(const std::string &ProfileKey, size_t ParallelBlockSize, bool IsParallel)
+{
+	std::lock_guard<std::mutex> lock(m_profileMutex);
+	TuningEntry tent;
+
+	tent.ParallelBlockSize = ParallelBlockSize;
+	tent.IsParallel = IsParallel;
+	m_profileEntries[ProfileKey] = tent;
+	m_profileCount = m_profileEntries.size();
+}
+
+//~~~Private Functions~~~//
+
+uint64_t ParallelTuner::Measure(const std::function<void(size_t)> &Transform, size_t Length)
+{
+	std::chrono::steady_clock::time_point start;
+	uint64_t elp;
+	uint64_t res;
+	size_t i;
+
+	// warm the caches and the thread pool
+	Transform(Length);
+	res = 0;
+
+	for (i = 0; i < CAL_SAMPLES; ++i)
+	{
+		start = std::chrono::steady_clock::now();
+		Transform(Length);
+		elp = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+		res = (i == 0 || elp < res) ? elp : res;
+	}
+
+	return res;
+}
+
+NAMESPACE_TOOLSEND
@@ -0,0 +1,194 @@
+// The GPL version 3 License (GPLv3)
+//
+// Copyright (c) 2023 QSCS.ca
+// This file is part of the CEX Cryptographic library.
+//
+// This program is free software : you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef CEX_PARALLELTUNER_H
+#define CEX_PARALLELTUNER_H
+
+#include "CexDomain.h"
+#include "ParallelOptions.h"
+#include <atomic>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <vector>
+
+NAMESPACE_TOOLS
+
+/// <summary>
+/// A process-wide store of measured parallel block sizes, used in place of the cache-size heuristic when a ParallelOptions profile is first calculated.
+/// <para>Calibrate(T*) times an initialized algorithm sequentially and across a range of parallel block sizes,
+/// and records the block size that is both the parallel crossover and within a few percent of the best parallel throughput.
+/// Each entry is keyed by the ParallelOptions::ProfileKey() of the algorithm, which identifies the algorithm by name, and its block size, cache reservation, SIMD multiplier and channel layout.
+/// A new algorithm instance applies its entry when it is constructed.
+/// The entries can be saved to a small text profile, tagged with a fingerprint of the host processor; a profile from another host is ignored on load.
+/// If the CEX_PARALLEL_PROFILE environment variable names a profile file, it is loaded when the tuner is first used.</para>
+/// </summary>
+///
+/// <example>
+/// <description>Calibrating a cipher mode and saving the host profile:</description>
+/// <code>
+/// CTR cpr(BlockCiphers::AES);
+/// cpr.Initialize(true, kp);
+/// ParallelTuner::Instance().Calibrate(&amp;cpr);
+/// ParallelTuner::Instance().Save("cex-parallel.profile");
+/// // later processes
+/// ParallelTuner::Instance().Load("cex-parallel.profile");
+/// </code>
+/// </example>
+class ParallelTuner final
+{
+private:
+
+	static const std::string PROFILE_HEADER;
+	static const std::string PROFILE_VARIABLE;
+	// the largest block size measured; 4MB
+	static const size_t CAL_MAXLEN = 4194304;
+	// the number of timed runs per measurement; the fastest is kept
+	static const size_t CAL_SAMPLES = 3;
+	// a block size within this percentage of the best throughput is accepted
+	static const size_t CAL_TOLERANCE = 5;
+
+	struct TuningEntry
+	{
+		TuningEntry()
+			:
+			IsParallel(false),
+			ParallelBlockSize(0)
+		{
+		}
+
+		bool IsParallel;
+		size_t ParallelBlockSize;
+	};
+
+	std::string m_hostFingerprint;
+	std::atomic<size_t> m_profileCount;
+	std::map<std::string, TuningEntry> m_profileEntries;
+	std::mutex m_profileMutex;
+
+	ParallelTuner(const ParallelTuner&) = delete;
+
+	ParallelTuner& operator=(const ParallelTuner&) = delete;
+
+	ParallelTuner();
+
+	~ParallelTuner();
+
+public:
+
+	//~~~Accessors~~~//
+
+	/// <summary>
+	/// Read Only: The number of algorithm profiles held by the tuner
+	/// </summary>
+	size_t Count();
+
+	/// <summary>
+	/// Read Only: The processor fingerprint written to, and matched against, a saved profile
+	/// </summary>
+	const std::string &HostFingerprint();
+
+	//~~~Public Functions~~~//
+
+	/// <summary>
+	/// Get the process-wide tuner instance
+	/// </summary>
+	static ParallelTuner& Instance();
+
+	/// <summary>
+	/// Calibrate an initialized cipher, and apply the measured values to its ParallelProfile().
+	/// <para>The algorithm must be initialized, and must expose ParallelProfile() and the vector Transform(Input, InOffset, Output, OutOffset, Length) function,
+	/// i.e. a cipher mode or a stream cipher. The measurement transforms up to 4MB of data several times per candidate block size.</para>
+	/// </summary>
+	///
+	/// <param name="Algorithm">The initialized algorithm instance</param>
+	///
+	/// <returns>Returns true if a profile was recorded, false if the processor has a single core</returns>
+	template<class T>
+	bool Calibrate(T* Algorithm)
+	{
+		std::vector<uint8_t> inp(CAL_MAXLEN);
+		std::vector<uint8_t> otp(CAL_MAXLEN);
+
+		return Calibrate(Algorithm->ParallelProfile(), [Algorithm, &inp, &otp](size_t Length)
+		{
+			Algorithm->Transform(inp, 0, otp, 0, Length);
+		});
+	}
+
+	/// <summary>
+	/// Calibrate an algorithm through a transform callback, and apply the measured values to the algorithms profile.
+	/// <para>The callback processes Length bytes with the algorithm that owns Profile; Length is never larger than 4MB.</para>
+	/// </summary>
+	///
+	/// <param name="Profile">The algorithms ParallelProfile()</param>
+	/// <param name="Transform">The callback that processes Length bytes with the algorithm</param>
+	///
+	/// <returns>Returns true if a profile was recorded, false if the processor has a single core</returns>
+	bool Calibrate(ParallelOptions &Profile, const std::function<void(size_t)> &Transform);
+
+	/// <summary>
+	/// Remove every profile entry
+	/// </summary>
+	void Clear();
+
+	/// <summary>
+	/// Get the measured values for an algorithm profile key
+	/// </summary>
+	///
+	/// <param name="ProfileKey">The ParallelOptions::ProfileKey() of the algorithm</param>
+	/// <param name="ParallelBlockSize">Receives the measured parallel block size</param>
+	/// <param name="IsParallel">Receives the measured parallel state; false if the algorithm was faster sequentially</param>
+	///
+	/// <returns>Returns true if the key has an entry</returns>
+	bool Find(const std::string &ProfileKey, size_t &ParallelBlockSize, bool &IsParallel);
+
+	/// <summary>
+	/// Load a saved profile and merge its entries into the tuner
+	/// </summary>
+	///
+	/// <param name="Path">The profile file path</param>
+	///
+	/// <returns>Returns true if the profile was read, false if the file is missing, malformed, or was created on a different host</returns>
+	bool Load(const std::string &Path);
+
+	/// <summary>
+	/// Save the tuner entries to a profile file
+	/// </summary>
+	///
+	/// <param name="Path">The profile file path</param>
+	///
+	/// <returns>Returns true if the profile was written</returns>
+	bool Save(const std::string &Path);
+
+	/// <summary>
+	/// Add or replace the measured values for an algorithm profile key
+	/// </summary>
+	///
+	/// <param name="ProfileKey">The ParallelOptions::ProfileKey() of the algorithm</param>
+	/// <param name="ParallelBlockSize">The parallel block size</param>
+	/// <param name="IsParallel">The algorithm is faster with multi-threading</param>
+	void Store(const std::string &ProfileKey, size_t ParallelBlockSize, bool IsParallel);
+
+private:
+
+	static uint64_t Measure(const std::function<void(size_t)> &Transform, size_t Length);
+};
+
+NAMESPACE_TOOLSEND
+#endif
@@ -0,0 +1,32 @@
+#ifndef CEX_PIPELINESTAGES_H
+#define CEX_PIPELINESTAGES_H
+
+#include "CexDomain.h"
+
+NAMESPACE_ENUMERATION
+
+/// <summary>
+/// The stages of a CipherPipeline
+/// </summary>
+enum class PipelineStages : uint8_t
+{
+	/// <summary>
+	/// The stage that reads chunks from the source stream
+	/// </summary>
+	Source = 0,
+	/// <summary>
+	/// The cipher mode or stream cipher transform stage
+	/// </summary>
+	Transform = 1,
+	/// <summary>
+	/// The digest or MAC stage
+	/// </summary>
+	Authenticate = 2,
+	/// <summary>
+	/// The stage that writes chunks to the sink stream
+	/// </summary>
+	Sink = 3
+};
+
+NAMESPACE_ENUMERATIONEND
+#endif
@@ -17,7 +17,7 @@ const std::string ProviderFromName::CLASS_NAME("ProviderFromName");
 IProvider* ProviderFromName::GetInstance(Providers ProviderType)
 {
 	IProvider* rptr = nullptr;
-	CpuDetect dtc;
+	CpuDetect &dtc = CpuDetect::Instance();
 
 	try
 	{
@@ -3,7 +3,9 @@
 #include "IntegerTools.h"
 #include "KMAC.h"
 #include "MemoryTools.h"
+#include "ParallelScratch.h"
 #include "Rijndael.h"
+#include "SegmentScratch.h"
 #include "SHAKE.h"
 #include "StreamAuthenticators.h"
 
@@ -14,12 +16,14 @@ using Tools::IntegerTools;
 using Mac::KMAC;
 using Enumeration::KmacModes;
 using Tools::MemoryTools;
+using Tools::ParallelScratch;
 using Tools::ParallelTools;
+using Tools::SegmentScratch;
 using Enumeration::ShakeModes;
 using Enumeration::StreamAuthenticators;
 using Enumeration::StreamCipherConvert;
 
-#if defined(CEX_HAS_AVX)
+#if defined(CEX_HAS_AESNI)
 #	if defined(CEX_HAS_AVX512)
 	const __m512i RCS::NI512K0 = _mm512_set_epi64(17361641481138401520, 17361641481138401520, 8102099357864587376, 8102099357864587376,
 		17361641481138401520, 17361641481138401520, 8102099357864587376, 8102099357864587376);
@@ -39,14 +43,14 @@ class RCS::RcsState
 {
 public:
 
-#if defined(CEX_HAS_AVX)
+#if defined(CEX_HAS_AESNI)
 #	if defined(CEX_EXTENDED_AESNI)
 	std::vector<__m256i> RoundKeys;
 #	else
 	std::vector<__m128i> RoundKeys;
 #	endif
 #else
-	SecureVector<uint32_t> RoundKeys;
+	SecureVector<uint64_t> RoundKeys;
 #endif
 
 	SecureVector<uint8_t> Custom;
@@ -57,6 +61,9 @@ public:
 			SymmetricKeySize(IK256_SIZE, BLOCK_SIZE, INFO_SIZE),
 			SymmetricKeySize(IK512_SIZE, BLOCK_SIZE, INFO_SIZE)};
 	std::vector<uint8_t> Nonce;
+	std::vector<uint8_t> Origin;
+	ParallelScratch Scratch;
+	SegmentScratch Segments;
 	uint64_t Counter = 0;
 	uint32_t Rounds = 0;
 	KmacModes Authenticator = KmacModes::None;
@@ -73,6 +80,7 @@ public:
 		MacTag(0),
 		Name(0),
 		Nonce(BLOCK_SIZE, 0x00),
+		Origin(BLOCK_SIZE, 0x00),
 		IsAuthenticated(Authenticate)
 	{
 	}
@@ -85,16 +93,18 @@ public:
 	~RcsState()
 	{
 		LegalKeySizes.clear();
-#if defined(CEX_HAS_AVX)
+#if defined(CEX_HAS_AESNI)
 		MemoryTools::Clear(RoundKeys, 0, RoundKeys.size() * sizeof(__m128i));
 #else
-		MemoryTools::Clear(RoundKeys, 0, RoundKeys.size() * sizeof(uint32_t));
+		MemoryTools::Clear(RoundKeys, 0, RoundKeys.size() * sizeof(uint64_t));
 #endif
 		MemoryTools::Clear(Custom, 0, Custom.size());
 		MemoryTools::Clear(MacKey, 0, MacKey.size());
 		MemoryTools::Clear(MacTag, 0, MacTag.size());
 		MemoryTools::Clear(Name, 0, Name.size());
 		MemoryTools::Clear(Nonce, 0, Nonce.size());
+		MemoryTools::Clear(Origin, 0, Origin.size());
+		Scratch.Clear();
 		Counter = 0;
 		Rounds = 0;
 		Authenticator = KmacModes::None;
@@ -113,10 +123,10 @@ public:
 		vlen = 0;
 
 		MemoryTools::CopyToObject(SecureState, soff, &vlen, sizeof(uint16_t));
-#if defined(CEX_HAS_AVX)
+#if defined(CEX_HAS_AESNI)
 		RoundKeys.resize(vlen / sizeof(__m128i));
 #else
-		RoundKeys.resize(vlen / sizeof(uint32_t));
+		RoundKeys.resize(vlen / sizeof(uint64_t));
 #endif
 		soff += sizeof(uint16_t);
 		MemoryTools::Copy(SecureState, soff, RoundKeys, 0, vlen);
@@ -152,6 +162,12 @@ public:
 		MemoryTools::Copy(SecureState, soff, Nonce, 0, Nonce.size());
 		soff += vlen;
 
+		MemoryTools::CopyToObject(SecureState, soff, &vlen, sizeof(uint16_t));
+		Origin.resize(vlen);
+		soff += sizeof(uint16_t);
+		MemoryTools::Copy(SecureState, soff, Origin, 0, Origin.size());
+		soff += vlen;
+
 		MemoryTools::CopyToObject(SecureState, soff, &Counter, sizeof(uint64_t));
 		soff += sizeof(uint64_t);
 		MemoryTools::CopyToObject(SecureState, soff, &Rounds, sizeof(uint32_t));
@@ -171,16 +187,19 @@ public:
 
 	void Reset()
 	{
-#if defined(CEX_HAS_AVX)
+#if defined(CEX_HAS_AESNI)
 		MemoryTools::Clear(RoundKeys, 0, RoundKeys.size() * sizeof(__m128i));
 #else
-		MemoryTools::Clear(RoundKeys, 0, RoundKeys.size() * sizeof(uint32_t));
+		MemoryTools::Clear(RoundKeys, 0, RoundKeys.size() * sizeof(uint64_t));
 #endif
 		MemoryTools::Clear(Custom, 0, Custom.size());
 		MemoryTools::Clear(MacKey, 0, MacKey.size());
 		MemoryTools::Clear(MacTag, 0, MacTag.size());
 		MemoryTools::Clear(Name, 0, Name.size());
 		MemoryTools::Clear(Nonce, 0, Nonce.size());
+		MemoryTools::Clear(Origin, 0, Origin.size());
+		Scratch.Clear();
+		Segments.Clear();
 		Counter = 0;
 		Rounds = 0;
 		IsEncryption = false;
@@ -189,13 +208,13 @@ public:
 
 	SecureVector<uint8_t> Serialize()
 	{
-#if defined(CEX_HAS_AVX)
+#if defined(CEX_HAS_AESNI)
 		const size_t RKMSZE = sizeof(__m128i);
 #else
-		const size_t RKMSZE = sizeof(uint32_t);
+		const size_t RKMSZE = sizeof(uint64_t);
 #endif
 		const size_t STALEN = (RoundKeys.size() * RKMSZE) + Custom.size() + MacKey.size() + MacTag.size() + Name.size() + 
-			Nonce.size() + sizeof(Counter) + sizeof(Rounds) + sizeof(Authenticator) + sizeof(Mode) + (3 * sizeof(bool)) + (7 * sizeof(uint16_t));
+			Nonce.size() + Origin.size() + sizeof(Counter) + sizeof(Rounds) + sizeof(Authenticator) + sizeof(Mode) + (3 * sizeof(bool)) + (8 * sizeof(uint16_t));
 
 		size_t soff;
 		uint16_t vlen;
@@ -238,6 +257,12 @@ public:
 		MemoryTools::Copy(Nonce, 0, state, soff, Nonce.size());
 		soff += Nonce.size();
 
+		vlen = static_cast<uint16_t>(Origin.size());
+		MemoryTools::CopyFromObject(&vlen, state, soff, sizeof(uint16_t));
+		soff += sizeof(uint16_t);
+		MemoryTools::Copy(Origin, 0, state, soff, Origin.size());
+		soff += Origin.size();
+
 		MemoryTools::CopyFromObject(&Counter, state, soff, sizeof(uint64_t));
 		soff += sizeof(uint64_t);
 		MemoryTools::CopyFromObject(&Rounds, state, soff, sizeof(uint32_t));
@@ -266,6 +291,7 @@ RCS::RCS(bool Authenticate)
 	m_macAuthenticator(nullptr),
 	m_parallelProfile(BLOCK_SIZE, true, STATE_PRECACHED, true)
 {
+	m_parallelProfile.SetAlgorithm(Name());
 }
 
 RCS::RCS(SecureVector<uint8_t> &State)
@@ -283,6 +309,8 @@ RCS::RCS(SecureVector<uint8_t> &State)
 		SymmetricKey kpm(m_rcsState->MacKey);
 		m_macAuthenticator->Initialize(kpm);
 	}
+
+	m_parallelProfile.SetAlgorithm(Name());
 }
 
 RCS::~RCS()
@@ -465,6 +493,7 @@ void RCS::Initialize(bool Encryption, ISymmetricKey &Parameters)
 
 	// copy the nonce to state
 	MemoryTools::Copy(Parameters.IV(), 0, m_rcsState->Nonce, 0, BLOCK_SIZE);
+	MemoryTools::Copy(Parameters.IV(), 0, m_rcsState->Origin, 0, BLOCK_SIZE);
 
 	// cipher key size determines key expansion function and Mac generator type; 256 or 512-bit
 	m_rcsState->Mode = (Parameters.KeySizes().KeySize() == IK512_SIZE) ?
@@ -474,7 +503,7 @@ void RCS::Initialize(bool Encryption, ISymmetricKey &Parameters)
 	// initialize cSHAKE with k,c,n
 	gen.Initialize(Parameters.SecureKey(), m_rcsState->Custom, m_rcsState->Name);
 
-#if defined(CEX_HAS_AVX)
+#if defined(CEX_HAS_AESNI)
 
 	// calculate the size of the round-key array
 	const size_t RNKLEN = static_cast<size_t>(BLOCK_SIZE / sizeof(m_rcsState->RoundKeys[0])) * static_cast<size_t>(m_rcsState->Rounds + 1UL);
@@ -499,7 +528,7 @@ void RCS::Initialize(bool Encryption, ISymmetricKey &Parameters)
 
 	// size the round key array
 	const size_t RNKLEN = static_cast<size_t>(BLOCK_SIZE / sizeof(uint32_t)) * static_cast<size_t>(m_rcsState->Rounds + 1UL);
-	m_rcsState->RoundKeys.resize(RNKLEN);
+	SecureVector<uint32_t> tmpk(RNKLEN);
 	// generate the round keys to a temporary uint8_t array
 	SecureVector<uint8_t> tmpr(RNKLEN * sizeof(uint32_t));
 	// generate the ciphers round-keys
@@ -508,9 +537,12 @@ void RCS::Initialize(bool Encryption, ISymmetricKey &Parameters)
 	// realign in big endian format for ACS test vectors; RCS is the fallback to the AES-NI implementation
 	for (i = 0; i < tmpr.size() / sizeof(uint32_t); ++i)
 	{
-		m_rcsState->RoundKeys[i] = IntegerTools::BeBytesTo32(tmpr, i * sizeof(uint32_t));
+		tmpk[i] = IntegerTools::BeBytesTo32(tmpr, i * sizeof(uint32_t));
 	}
 
+	// transpose the round keys for the bitsliced transforms
+	BitslicedExpand(tmpk, BLOCK_SIZE, m_rcsState->RoundKeys);
+	MemoryTools::Clear(tmpk, 0, tmpk.size() * sizeof(uint32_t));
 	MemoryTools::Clear(tmpr, 0, tmpr.size());
 
 #endif
@@ -544,6 +576,25 @@ void RCS::ParallelMaxDegree(size_t Degree)
 	m_parallelProfile.SetMaxDegree(Degree);
 }
 
+void RCS::Seek(uint64_t Position)
+{
+	if (IsInitialized() == false)
+	{
+		throw CryptoSymmetricException(Name(), std::string("Seek"), std::string("The cipher has not been initialized!"), ErrorCodes::NotInitialized);
+	}
+	if (IsAuthenticator() == true)
+	{
+		throw CryptoSymmetricException(Name(), std::string("Seek"), std::string("The key-stream position can not be set in authentication mode!"), ErrorCodes::IllegalOperation);
+	}
+	if (Position % BLOCK_SIZE != 0)
+	{
+		throw CryptoSymmetricException(Name(), std::string("Seek"), std::string("The position must be aligned to the block size!"), ErrorCodes::InvalidParam);
+	}
+
+	// the counter is the first 16 bytes of the initial nonce, increased by the block index
+	IntegerTools::LeIncrease8(m_rcsState->Origin, m_rcsState->Nonce, 0, 16, static_cast<uint64_t>(Position / BLOCK_SIZE));
+}
+
 void RCS::SetAssociatedData(const std::vector<uint8_t> &Input, size_t Offset, size_t Length)
 {
 	if (IsInitialized() == false)
@@ -569,6 +620,31 @@ void RCS::SetAssociatedData(const std::vector<uint8_t> &Input, size_t Offset, si
 	}
 }
 
+void RCS::SetAssociatedData(const uint8_t* Input, size_t Length)
+{
+	if (IsInitialized() == false)
+	{
+		throw CryptoSymmetricException(Name(), std::string("SetAssociatedData"), std::string("The cipher has not been initialized!"), ErrorCodes::NotInitialized);
+	}
+	if (m_macAuthenticator == nullptr)
+	{
+		throw CryptoSymmetricException(Name(), std::string("SetAssociatedData"), std::string("The cipher has not been configured for authentication!"), ErrorCodes::IllegalOperation);
+	}
+	if (Length == 0)
+	{
+		throw CryptoSymmetricException(Name(), std::string("SetAssociatedData"), std::string("The additional data array can not be zero sized!"), ErrorCodes::InvalidSize);
+	}
+
+	if (IsAuthenticator() == true)
+	{
+		std::vector<uint8_t> code(sizeof(uint32_t));
+		// version 1.1a add AD and encoding to hash
+		static_cast<KMAC*>(m_macAuthenticator.get())->Update(Input, Length);
+		IntegerTools::Le32ToBytes(static_cast<uint32_t>(Length), code, 0);
+		m_macAuthenticator->Update(code, 0, code.size());
+	}
+}
+
 void RCS::Transform(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length)
 {
 	CEXASSERT(IsInitialized(), "The cipher mode has not been initialized!");
@@ -586,7 +662,7 @@ void RCS::Transform(const std::vector<uint8_t> &Input, size_t InOffset, std::vec
 			// add the starting position of the nonce
 			m_macAuthenticator->Update(m_rcsState->Nonce, 0, BLOCK_SIZE);
 			// encrypt the stream
-			Process(Input, InOffset, Output, OutOffset, Length);
+			Process(Input.data(), InOffset, Output, OutOffset, Length);
 			// update the mac with the ciphertext
 			m_macAuthenticator->Update(Output, OutOffset, Length);
 			// update the processed bytes counter
@@ -598,7 +674,7 @@ void RCS::Transform(const std::vector<uint8_t> &Input, size_t InOffset, std::vec
 		else
 		{
 			// encrypt the stream
-			Process(Input, InOffset, Output, OutOffset, Length);
+			Process(Input.data(), InOffset, Output, OutOffset, Length);
 		}
 	}
 	else
@@ -621,7 +697,98 @@ void RCS::Transform(const std::vector<uint8_t> &Input, size_t InOffset, std::vec
 		}
 
 		// decrypt the stream
-		Process(Input, InOffset, Output, OutOffset, Length);
+		Process(Input.data(), InOffset, Output, OutOffset, Length);
+	}
+}
+
+void RCS::Transform(const uint8_t* Input, uint8_t* Output, size_t Length)
+{
+	CEXASSERT(IsInitialized(), "The cipher mode has not been initialized!");
+
+	// the key-stream is generated in segments, and combined with the callers memory in a single pass
+	auto gen = [this](std::vector<uint8_t> &Target, size_t Count)
+	{
+		Process(nullptr, 0, Target, 0, Count);
+	};
+
+	if (IsEncryption() == true)
+	{
+		if (IsAuthenticator() == true)
+		{
+			// add the starting position of the nonce
+			m_macAuthenticator->Update(m_rcsState->Nonce, 0, BLOCK_SIZE);
+			// encrypt the stream
+			m_rcsState->Segments.Keystream(Input, Output, Length, ParallelBlockSize(), gen);
+			// update the mac with the ciphertext
+			static_cast<KMAC*>(m_macAuthenticator.get())->Update(Output, Length);
+			// update the mac counter
+			m_rcsState->Counter += Length;
+			// finalize the mac and add the tag to the stream
+			Finalize(m_rcsState, m_macAuthenticator);
+			MemoryTools::CopyRaw(m_rcsState->MacTag.data(), Output + Length, m_rcsState->MacTag.size());
+		}
+		else
+		{
+			// encrypt the stream
+			m_rcsState->Segments.Keystream(Input, Output, Length, ParallelBlockSize(), gen);
+		}
+	}
+	else
+	{
+		if (IsAuthenticator() == true)
+		{
+			// add the starting position of the nonce
+			m_macAuthenticator->Update(m_rcsState->Nonce, 0, BLOCK_SIZE);
+			// update the mac with the ciphertext
+			static_cast<KMAC*>(m_macAuthenticator.get())->Update(Input, Length);
+			// update the mac counter
+			m_rcsState->Counter += Length;
+			// finalize the mac and verify
+			Finalize(m_rcsState, m_macAuthenticator);
+
+			if (IntegerTools::CompareRaw(Input + Length, m_rcsState->MacTag.data(), m_rcsState->MacTag.size()) == false)
+			{
+				throw CryptoAuthenticationFailure(Name(), std::string("Transform"), std::string("The authentication tag does not match!"), ErrorCodes::AuthenticationFailure);
+			}
+		}
+
+		// decrypt the stream
+		m_rcsState->Segments.Keystream(Input, Output, Length, ParallelBlockSize(), gen);
+	}
+}
+
+void RCS::TransformAt(uint64_t Position, const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length)
+{
+	CEXASSERT(IntegerTools::Min(Input.size() - InOffset, Output.size() - OutOffset) >= Length, "The data arrays are smaller than the length!");
+
+	const size_t HDRLEN = static_cast<size_t>(Position % BLOCK_SIZE);
+	size_t i;
+	size_t prclen;
+
+	Seek(Position - HDRLEN);
+
+	if (HDRLEN != 0 && Length != 0)
+	{
+		// the position is inside a block; use the tail of that blocks key-stream
+		std::vector<uint8_t> otp(BLOCK_SIZE);
+		prclen = IntegerTools::Min(BLOCK_SIZE - HDRLEN, Length);
+		Transform256(m_rcsState->Nonce, 0, otp, 0);
+		IntegerTools::LeIncrement(m_rcsState->Nonce, 16);
+
+		for (i = 0; i < prclen; ++i)
+		{
+			Output[OutOffset + i] = Input[InOffset + i] ^ otp[HDRLEN + i];
+		}
+
+		MemoryTools::Clear(otp, 0, otp.size());
+		InOffset += prclen;
+		OutOffset += prclen;
+		Length -= prclen;
+	}
+
+	if (Length != 0)
+	{
+		Process(Input.data(), InOffset, Output, OutOffset, Length);
 	}
 }
 
@@ -643,7 +810,7 @@ void RCS::Finalize(std::unique_ptr<RcsState> &State, std::unique_ptr<IMac> &Auth
 	Authenticator->Finalize(State->MacTag, 0);
 }
 
-void RCS::Generate(std::vector<uint8_t> &Output, size_t OutOffset, size_t Length, std::vector<uint8_t> &Counter)
+void RCS::Generate(std::vector<uint8_t> &Output, size_t OutOffset, size_t Length, std::vector<uint8_t> &Counter, std::vector<uint8_t> &Buffer)
 {
 	size_t bctr;
 
@@ -660,75 +827,60 @@ void RCS::Generate(std::vector<uint8_t> &Output, size_t OutOffset, size_t Length
 	if (Length >= AVX512BLK)
 	{
 		const size_t PBKALN = Length - (Length % AVX512BLK);
-		std::vector<uint8_t> tmpc(AVX512BLK);
 
 		// stagger counters and process 2 blocks with avx512
 		while (bctr != PBKALN)
 		{
-			MemoryTools::Copy(Counter, 0, tmpc, 0, BLOCK_SIZE);
+			MemoryTools::Copy(Counter, 0, Buffer, 0, BLOCK_SIZE);
 			IntegerTools::LeIncrement(Counter, 16);
-			MemoryTools::Copy(Counter, 0, tmpc, 32, BLOCK_SIZE);
+			MemoryTools::Copy(Counter, 0, Buffer, 32, BLOCK_SIZE);
 			IntegerTools::LeIncrement(Counter, 16);
-			Transform512(tmpc, 0, Output, OutOffset + bctr);
+			Transform512(Buffer, 0, Output, OutOffset + bctr);
 			bctr += AVX512BLK;
 		}
 	}
 
-#elif defined(CEX_HAS_AVX2)
+#elif defined(CEX_HAS_AESNI)
 
-	const size_t AVX2BLK = 8 * BLOCK_SIZE;
+	const size_t AESBLK = 4 * BLOCK_SIZE;
 
-	if (Length >= AVX2BLK)
+	if (Length >= AESBLK)
 	{
-		const size_t PBKALN = Length - (Length % AVX2BLK);
-		std::vector<uint8_t> tmpc(AVX2BLK);
+		const size_t PBKALN = Length - (Length % AESBLK);
 
-		// stagger counters and process 8 blocks with avx2
+		// 4 blocks with aes-ni
 		while (bctr != PBKALN)
 		{
-			MemoryTools::Copy(Counter, 0, tmpc, 0, BLOCK_SIZE);
-			IntegerTools::LeIncrement(Counter, 16);
-			MemoryTools::Copy(Counter, 0, tmpc, 32, BLOCK_SIZE);
+			MemoryTools::Copy(Counter, 0, Buffer, 0, BLOCK_SIZE);
 			IntegerTools::LeIncrement(Counter, 16);
-			MemoryTools::Copy(Counter, 0, tmpc, 64, BLOCK_SIZE);
+			MemoryTools::Copy(Counter, 0, Buffer, 32, BLOCK_SIZE);
 			IntegerTools::LeIncrement(Counter, 16);
-			MemoryTools::Copy(Counter, 0, tmpc, 96, BLOCK_SIZE);
+			MemoryTools::Copy(Counter, 0, Buffer, 64, BLOCK_SIZE);
 			IntegerTools::LeIncrement(Counter, 16);
-			MemoryTools::Copy(Counter, 0, tmpc, 128, BLOCK_SIZE);
+			MemoryTools::Copy(Counter, 0, Buffer, 96, BLOCK_SIZE);
 			IntegerTools::LeIncrement(Counter, 16);
-			MemoryTools::Copy(Counter, 0, tmpc, 160, BLOCK_SIZE);
-			IntegerTools::LeIncrement(Counter, 16);
-			MemoryTools::Copy(Counter, 0, tmpc, 192, BLOCK_SIZE);
-			IntegerTools::LeIncrement(Counter, 16);
-			MemoryTools::Copy(Counter, 0, tmpc, 224, BLOCK_SIZE);
-			IntegerTools::LeIncrement(Counter, 16);
-			Transform2048(tmpc, 0, Output, OutOffset + bctr);
-			bctr += AVX2BLK;
+			Transform1024(Buffer, 0, Output, OutOffset + bctr);
+			bctr += AESBLK;
 		}
 	}
 
-#elif defined(CEX_HAS_AVX)
+#else
 
-	const size_t AVXBLK = 4 * BLOCK_SIZE;
+	const size_t BSLBLK = 2 * BLOCK_SIZE;
 
-	if (Length >= AVXBLK)
+	if (Length >= BSLBLK)
 	{
-		const size_t PBKALN = Length - (Length % AVXBLK);
-		std::vector<uint8_t> tmpc(AVXBLK);
+		const size_t PBKALN = Length - (Length % BSLBLK);
 
-		// 4 blocks with avx
+		// stagger counters and process 2 blocks in the bitsliced state
 		while (bctr != PBKALN)
 		{
-			MemoryTools::Copy(Counter, 0, tmpc, 0, BLOCK_SIZE);
-			IntegerTools::LeIncrement(Counter, 16);
-			MemoryTools::Copy(Counter, 0, tmpc, 32, BLOCK_SIZE);
+			MemoryTools::Copy(Counter, 0, Buffer, 0, BLOCK_SIZE);
 			IntegerTools::LeIncrement(Counter, 16);
-			MemoryTools::Copy(Counter, 0, tmpc, 64, BLOCK_SIZE);
+			MemoryTools::Copy(Counter, 0, Buffer, 32, BLOCK_SIZE);
 			IntegerTools::LeIncrement(Counter, 16);
-			MemoryTools::Copy(Counter, 0, tmpc, 96, BLOCK_SIZE);
-			IntegerTools::LeIncrement(Counter, 16);
-			Transform1024(tmpc, 0, Output, OutOffset + bctr);
-			bctr += AVXBLK;
+			Transform512(Buffer, 0, Output, OutOffset + bctr);
+			bctr += BSLBLK;
 		}
 	}
 
@@ -745,15 +897,14 @@ void RCS::Generate(std::vector<uint8_t> &Output, size_t OutOffset, size_t Length
 
 	if (bctr != Length)
 	{
-		std::vector<uint8_t> otp(BLOCK_SIZE);
-		Transform256(Counter, 0, otp, 0);
+		Transform256(Counter, 0, Buffer, 0);
 		IntegerTools::LeIncrement(Counter, 16);
 		const size_t RMDLEN = Length % BLOCK_SIZE;
-		MemoryTools::Copy(otp, 0, Output, OutOffset + (Length - RMDLEN), RMDLEN);
+		MemoryTools::Copy(Buffer, 0, Output, OutOffset + (Length - RMDLEN), RMDLEN);
 	}
 }
 
-#if defined(CEX_HAS_AVX)
+#if defined(CEX_HAS_AESNI)
 
 #	if defined(CEX_HAS_AVX512)
 __m512i ACS::Load256To512(__m256i &A, __m256i &B)
@@ -782,20 +933,13 @@ __m256i ACS::Shuffle256(const __m256i &Value, const __m256i &Mask)
 }
 #	endif
 
-#else
-CEX_OPTIMIZE_IGNORE
-void RCS::PrefetchSbox()
-{
-	// timing defence: pre-load sbox into l1 cache
-	MemoryTools::PrefetchL1(SBox, 0, SBox.size());
-}
-CEX_OPTIMIZE_RESUME
 #endif
 
-void RCS::Process(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length)
+void RCS::Process(const uint8_t* Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length)
 {
 	size_t i;
 
+	// a null input writes the bare key-stream, which the pointer transform combines with the callers memory
 	const size_t PRLBLK = m_parallelProfile.ParallelBlockSize();
 
 	if (m_parallelProfile.IsParallel() && Length >= PRLBLK)
@@ -821,73 +965,63 @@ void RCS::Process(const std::vector<uint8_t> &Input, size_t InOffset, std::vecto
 	}
 }
 
-void RCS::ProcessParallel(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length)
+void RCS::ProcessParallel(const uint8_t* Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length)
 {
 	const size_t OUTLEN = Output.size() - OutOffset < Length ? Output.size() - OutOffset : Length;
-	const size_t CNKLEN = m_parallelProfile.ParallelBlockSize() / m_parallelProfile.ParallelMaxDegree();
+	const size_t SEGCNT = m_parallelProfile.ParallelSegmentCount();
+	const size_t CNKLEN = m_parallelProfile.ParallelBlockSize() / SEGCNT;
 	const size_t CTRLEN = (CNKLEN / BLOCK_SIZE);
-	std::vector<uint8_t> tmpc(BLOCK_SIZE);
 
-	ParallelTools::ParallelFor(0, m_parallelProfile.ParallelMaxDegree(), [this, &Input, InOffset, &Output, OutOffset, &tmpc, CNKLEN, CTRLEN](size_t i)
+	// the per-worker counters are kept by the instance, and are allocated only on first use
+	m_rcsState->Scratch.Reserve(SEGCNT, BLOCK_SIZE, SCRATCH_SIZE);
+
+	ParallelTools::ParallelFor(m_parallelProfile, Output.data() + OutOffset, 0, SEGCNT, [this, Input, InOffset, &Output, OutOffset, CNKLEN, CTRLEN](size_t i)
 	{
 		// thread level counter
-		std::vector<uint8_t> thdc(BLOCK_SIZE);
+		std::vector<uint8_t> &thdc = m_rcsState->Scratch.Counter(i);
 		// offset counter by chunk size / block size  
 		IntegerTools::LeIncrease8(m_rcsState->Nonce, thdc, static_cast<uint32_t>(CTRLEN * i));
 		const size_t STMPOS = i * CNKLEN;
 		// generate random at output offset
-		this->Generate(Output, OutOffset + STMPOS, CNKLEN, thdc);
-		// xor with input at offsets
-		MemoryTools::XOR(Input, InOffset + STMPOS, Output, OutOffset + STMPOS, CNKLEN);
+		this->Generate(Output, OutOffset + STMPOS, CNKLEN, thdc, m_rcsState->Scratch.Buffer(i));
 
-		// store last counter
-		if (i == m_parallelProfile.ParallelMaxDegree() - 1)
+		// xor with input at offsets
+		if (Input != nullptr)
 		{
-			MemoryTools::Copy(thdc, 0, tmpc, 0, BLOCK_SIZE);
+			MemoryTools::XorRaw(Input + InOffset + STMPOS, Output.data() + OutOffset + STMPOS, CNKLEN);
 		}
 	});
 
 	// copy last counter to class variable
-	MemoryTools::Copy(tmpc, 0, m_rcsState->Nonce, 0, BLOCK_SIZE);
+	MemoryTools::Copy(m_rcsState->Scratch.Counter(SEGCNT - 1), 0, m_rcsState->Nonce, 0, BLOCK_SIZE);
 
 	// last block processing
-	const size_t ALNLEN = CNKLEN * m_parallelProfile.ParallelMaxDegree();
+	const size_t ALNLEN = CNKLEN * SEGCNT;
 	if (ALNLEN < OUTLEN)
 	{
 		const size_t FNLLEN = OUTLEN - ALNLEN;
 		InOffset += ALNLEN;
 		OutOffset += ALNLEN;
 
-		Generate(Output, OutOffset, FNLLEN, m_rcsState->Nonce);
+		Generate(Output, OutOffset, FNLLEN, m_rcsState->Nonce, m_rcsState->Scratch.Buffer(0));
 
-		for (size_t i = 0; i < FNLLEN; ++i)
+		if (Input != nullptr)
 		{
-			Output[OutOffset + i] ^= Input[InOffset + i];
+			MemoryTools::XorRaw(Input + InOffset, Output.data() + OutOffset, FNLLEN);
 		}
 	}
 }
 
-void RCS::ProcessSequential(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length)
+void RCS::ProcessSequential(const uint8_t* Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length)
 {
-	// get block aligned
-	const size_t ALNLEN = Length - (Length % BLOCK_SIZE);
-	size_t i;
-
+	m_rcsState->Scratch.Reserve(1, BLOCK_SIZE, SCRATCH_SIZE);
 	// generate random
-	Generate(Output, OutOffset, Length, m_rcsState->Nonce);
-
-	if (ALNLEN != 0)
-	{
-		MemoryTools::XOR(Input, InOffset, Output, OutOffset, ALNLEN);
-	}
+	Generate(Output, OutOffset, Length, m_rcsState->Nonce, m_rcsState->Scratch.Buffer(0));
 
-	// get the remaining bytes
-	if (ALNLEN != Length)
+	// output is input xor random
+	if (Input != nullptr && Length != 0)
 	{
-		for (i = ALNLEN; i < Length; ++i)
-		{
-			Output[i + OutOffset] ^= Input[i + InOffset];
-		}
+		MemoryTools::XorRaw(Input + InOffset, Output.data() + OutOffset, Length);
 	}
 }
 
@@ -912,7 +1046,7 @@ SecureVector<uint8_t> RCS::Serialize()
 
 void RCS::Transform256(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset)
 {
-#if defined(CEX_HAS_AVX)
+#if defined(CEX_HAS_AESNI)
 #	if defined(CEX_EXTENDED_AESNI)
 
 	static const __m256i SWMASK = _mm256_setr_epi8(0, 17, 22, 23, 4, 5, 26, 27, 8, 9, 14, 31, 12, 13, 18, 19, 
@@ -986,30 +1120,8 @@ void RCS::Transform256(const std::vector<uint8_t> &Input, size_t InOffset, std::
 #	endif
 #else
 
-	SecureVector<uint8_t> state(BLOCK_SIZE, 0x00);
-	size_t i;
-
-	MemoryTools::Copy(Input, InOffset, state, 0, BLOCK_SIZE);
-	KeyAddition(state, m_rcsState->RoundKeys, 0);
+	BitslicedEncrypt256(m_rcsState->RoundKeys, m_rcsState->Rounds, Input, InOffset, Output, OutOffset, BLOCK_SIZE);
 
-	// pre-load the s-box into L1 cache
-#	if defined(CEX_PREFETCH_RIJNDAEL_TABLES)
-	PrefetchSbox();
-#	endif
-
-	for (i = 1; i < m_rcsState->Rounds; ++i)
-	{
-		Substitution(state);
-		ShiftRows256(state);
-		MixColumns(state);
-		KeyAddition(state, m_rcsState->RoundKeys, (i << 3UL));
-	}
-
-	Substitution(state);
-	ShiftRows256(state);
-	KeyAddition(state, m_rcsState->RoundKeys, static_cast<size_t>(m_rcsState->Rounds) << 3UL);
-
-	MemoryTools::Copy(state, 0, Output, OutOffset, BLOCK_SIZE);
 #endif
 }
 
@@ -1040,20 +1152,23 @@ void RCS::Transform512(const std::vector<uint8_t> &Input, size_t InOffset, std::
 	x = Shuffle512(x, SWMASKL);
 	_mm512_storeu_si512(reinterpret_cast<__m256i*>(&Output[OutOffset]), _mm512_aesenclast_epi128(x, Load256To512(m_rcsState->RoundKeys[kctr], m_acsState->RoundKeys[kctr])));
 
-#else
+#elif defined(CEX_HAS_AESNI)
 
 	Transform256(Input, InOffset, Output, OutOffset);
 	Transform256(Input, InOffset + 32, Output, OutOffset + 32);
 
+#else
+
+	// both blocks share the bitsliced state
+	BitslicedEncrypt256(m_rcsState->RoundKeys, m_rcsState->Rounds, Input, InOffset, Output, OutOffset, 2 * BLOCK_SIZE);
+
 #endif
 }
 
 void RCS::Transform1024(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset)
 {
-	Transform256(Input, InOffset, Output, OutOffset);
-	Transform256(Input, InOffset + 32, Output, OutOffset + 32);
-	Transform256(Input, InOffset + 64, Output, OutOffset + 64);
-	Transform256(Input, InOffset + 96, Output, OutOffset + 96);
+	Transform512(Input, InOffset, Output, OutOffset);
+	Transform512(Input, InOffset + 64, Output, OutOffset + 64);
 }
 
 void RCS::Transform2048(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset)
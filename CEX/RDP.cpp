@@ -125,8 +125,8 @@ DrandEngines RDP::Capability()
 {
 	DrandEngines eng;
 
-#if defined(CEX_AVX_INTRINSICS)
-	CpuDetect dtc;
+#if defined(CEX_HAS_RDRAND)
+	CpuDetect &dtc = CpuDetect::Instance();
 
 	if (dtc.RDSEED())
 	{
@@ -178,7 +178,7 @@ void RDP::Generate(uint8_t* Output, size_t Length, DrandEngines DrandType)
 	size_t poff;
 	int32_t res;
 
-#if defined(CEX_AVX_INTRINSICS)
+#if defined(CEX_HAS_RDRAND)
 
 	fctr = 0;
 	poff = 0;
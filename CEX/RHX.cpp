@@ -2,26 +2,33 @@
 #include "IntegerTools.h"
 #include "MemoryTools.h"
 #include "KdfFromName.h"
+#include "CpuDetect.h"
 #include "Rijndael.h"
+#include "RijndaelKernels.h"
+#include "SimdDispatch.h"
+#include "SymmetricKey.h"
+#include <array>
 
 NAMESPACE_BLOCK
 
 using Tools::MemoryTools;
 using Tools::IntegerTools;
 using Enumeration::Kdfs;
+using Tools::SimdDispatch;
+using Enumeration::SimdKernels;
+using Enumeration::SimdProfiles;
+using Cipher::SymmetricKey;
 using namespace Cipher::Block::RijndaelBase;
 
 class RHX::RhxState
 {
 public:
 
-#if defined(CEX_HAS_AVX)
+#if defined(CEX_HAS_AESNI)
 	std::vector<__m128i> RoundKeys;
-#elif defined(CEX_HAS_AVX512)
-	std::vector<__m512i> RoundKeysW;
-#else
-	SecureVector<uint32_t> RoundKeys = { 0 };
 #endif
+	SecureVector<uint32_t> WordKeys = { 0 };
+	SecureVector<uint64_t> SlicedKeys = { 0 };
 
 	SecureVector<uint8_t> Custom = { 0 };
 	std::vector<SymmetricKeySize> LegalKeySizes{
@@ -33,12 +40,21 @@ public:
 	BlockCipherExtensions Extension;
 	bool Destroyed;
 	bool Encryption = false;
+	bool HasAesni;
+	bool HasVaes;
 	bool Initialized = false;
 
 	RhxState(BlockCipherExtensions CipherExtension, bool IsDestroyed)
 		:
 		Extension(CipherExtension),
-		Destroyed(IsDestroyed)
+		Destroyed(IsDestroyed),
+#if defined(CEX_HAS_AESNI)
+		HasAesni(CpuDetect::Instance().AESNI()),
+		HasVaes(HasAesni && CpuDetect::Instance().VAES())
+#else
+		HasAesni(false),
+		HasVaes(false)
+#endif
 	{
 	}
 
@@ -46,21 +62,28 @@ public:
 	{
 		LegalKeySizes.clear();
 		MemoryTools::Clear(Custom, 0, Custom.size());
-		MemoryTools::Clear(RoundKeys, 0, RoundKeys.size() * sizeof(RoundKeys[0]));
+#if defined(CEX_HAS_AESNI)
+		MemoryTools::Clear(RoundKeys, 0, RoundKeys.size() * sizeof(__m128i));
+#endif
+		MemoryTools::Clear(WordKeys, 0, WordKeys.size() * sizeof(uint32_t));
+		MemoryTools::Clear(SlicedKeys, 0, SlicedKeys.size() * sizeof(uint64_t));
 		Rounds = 0;
 		Extension = BlockCipherExtensions::None;
 		Destroyed = false;
 		Encryption = false;
+		HasAesni = false;
+		HasVaes = false;
 		Initialized = false;
 	}
 
 	void Reset()
 	{
 		MemoryTools::Clear(Custom, 0, Custom.size());
-#if defined(CEX_HAS_AVX512)
-		MemoryTools::Clear(RoundKeysW, 0, RoundKeysW.size() * sizeof(__m512i));
+#if defined(CEX_HAS_AESNI)
+		MemoryTools::Clear(RoundKeys, 0, RoundKeys.size() * sizeof(__m128i));
 #endif
-		MemoryTools::Clear(RoundKeys, 0, RoundKeys.size() * sizeof(RoundKeys[0]));
+		MemoryTools::Clear(WordKeys, 0, WordKeys.size() * sizeof(uint32_t));
+		MemoryTools::Clear(SlicedKeys, 0, SlicedKeys.size() * sizeof(uint64_t));
 		Encryption = false;
 		Initialized = false;
 	}
@@ -189,6 +212,11 @@ void RHX::DecryptBlock(const std::vector<uint8_t> &Input, size_t InOffset, std::
 	Decrypt128(Input, InOffset, Output, OutOffset);
 }
 
+void RHX::DecryptBlock(const uint8_t* Input, uint8_t* Output)
+{
+	Decrypt128(Input, Output);
+}
+
 void RHX::EncryptBlock(const std::vector<uint8_t> &Input, std::vector<uint8_t> &Output)
 {
 	Encrypt128(Input, 0, Output, 0);
@@ -199,6 +227,145 @@ void RHX::EncryptBlock(const std::vector<uint8_t> &Input, size_t InOffset, std::
 	Encrypt128(Input, InOffset, Output, OutOffset);
 }
 
+void RHX::EncryptBlock(const uint8_t* Input, uint8_t* Output)
+{
+	Encrypt128(Input, Output);
+}
+
+void RHX::EncryptBatch(const SecureVector<uint8_t> &Keys, size_t KeySize, const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Count)
+{
+#if defined(CEX_HAS_AESNI)
+	const bool HASAES = CpuDetect::Instance().AESNI();
+#endif
+	size_t i;
+	size_t lanes;
+
+	if (KeySize != IK128_SIZE && KeySize != IK256_SIZE)
+	{
+		throw CryptoSymmetricException(std::string("RHX"), std::string("EncryptBatch"), std::string("The key size must be 16 or 32 bytes!"), ErrorCodes::InvalidKey);
+	}
+
+	if (Keys.size() < Count * KeySize || Input.size() < InOffset + (Count * BLOCK_SIZE) || Output.size() < OutOffset + (Count * BLOCK_SIZE))
+	{
+		throw CryptoSymmetricException(std::string("RHX"), std::string("EncryptBatch"), std::string("The arrays are too small for the block count!"), ErrorCodes::InvalidSize);
+	}
+
+	for (i = 0; i < Count; i += lanes)
+	{
+		lanes = (Count - i < BATCH_LANES) ? Count - i : BATCH_LANES;
+
+#if defined(CEX_HAS_AESNI)
+		if (HASAES && KeySize == IK128_SIZE)
+		{
+			BatchEncrypt128(Keys, i * KeySize, Input, InOffset + (i * BLOCK_SIZE), Output, OutOffset + (i * BLOCK_SIZE), lanes);
+		}
+		else if (HASAES)
+		{
+			BatchEncrypt256(Keys, i * KeySize, Input, InOffset + (i * BLOCK_SIZE), Output, OutOffset + (i * BLOCK_SIZE), lanes);
+		}
+		else
+#endif
+		{
+			// the bitsliced blocks share a single key schedule; each key is expanded and used in turn
+			SecureVector<uint8_t> key(KeySize);
+			RHX cpr;
+			size_t j;
+
+			for (j = 0; j < lanes; ++j)
+			{
+				MemoryTools::Copy(Keys, (i + j) * KeySize, key, 0, KeySize);
+				SymmetricKey kp(key);
+				cpr.Initialize(true, kp);
+				cpr.EncryptBlock(Input, InOffset + ((i + j) * BLOCK_SIZE), Output, OutOffset + ((i + j) * BLOCK_SIZE));
+			}
+
+			MemoryTools::Clear(key, 0, key.size());
+		}
+	}
+}
+
+void RHX::EncryptLanes(const std::vector<RHX*> &Ciphers, const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset)
+{
+	size_t i;
+
+	if (Input.size() < InOffset + (Ciphers.size() * BLOCK_SIZE) || Output.size() < OutOffset + (Ciphers.size() * BLOCK_SIZE))
+	{
+		throw CryptoSymmetricException(std::string("RHX"), std::string("EncryptLanes"), std::string("The arrays are too small for the block count!"), ErrorCodes::InvalidSize);
+	}
+
+	for (i = 0; i < Ciphers.size(); ++i)
+	{
+		if (!Ciphers[i]->IsInitialized() || !Ciphers[i]->IsEncryption())
+		{
+			throw CryptoSymmetricException(std::string("RHX"), std::string("EncryptLanes"), std::string("The cipher instances must be initialized for encryption!"), ErrorCodes::NotInitialized);
+		}
+	}
+
+#if defined(CEX_HAS_AESNI)
+	if (CpuDetect::Instance().AESNI())
+	{
+		std::array<const __m128i*, BATCH_LANES> rkp;
+		std::array<__m128i, BATCH_LANES> x;
+		size_t j;
+		size_t lanes;
+		size_t rctr;
+		size_t rnds;
+		bool eqr;
+
+		for (i = 0; i < Ciphers.size(); i += lanes)
+		{
+			lanes = (Ciphers.size() - i < BATCH_LANES) ? Ciphers.size() - i : BATCH_LANES;
+			rnds = Ciphers[i]->m_rhxState->RoundKeys.size();
+			eqr = true;
+
+			for (j = 0; j < lanes; ++j)
+			{
+				rkp[j] = Ciphers[i + j]->m_rhxState->RoundKeys.data();
+				eqr = eqr && (Ciphers[i + j]->m_rhxState->RoundKeys.size() == rnds);
+			}
+
+			if (eqr)
+			{
+				for (j = 0; j < lanes; ++j)
+				{
+					x[j] = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&Input[InOffset + ((i + j) * BLOCK_SIZE)])), rkp[j][0]);
+				}
+
+				for (rctr = 1; rctr < rnds - 1; ++rctr)
+				{
+					for (j = 0; j < lanes; ++j)
+					{
+						x[j] = _mm_aesenc_si128(x[j], rkp[j][rctr]);
+					}
+				}
+
+				for (j = 0; j < lanes; ++j)
+				{
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(&Output[OutOffset + ((i + j) * BLOCK_SIZE)]), _mm_aesenclast_si128(x[j], rkp[j][rnds - 1]));
+				}
+			}
+			else
+			{
+				// the key sizes or extensions differ, so the round counts do not line up
+				for (j = 0; j < lanes; ++j)
+				{
+					Ciphers[i + j]->Encrypt128(Input, InOffset + ((i + j) * BLOCK_SIZE), Output, OutOffset + ((i + j) * BLOCK_SIZE));
+				}
+			}
+		}
+
+		MemoryTools::Clear(x, 0, x.size() * sizeof(__m128i));
+	}
+	else
+#endif
+	{
+		for (i = 0; i < Ciphers.size(); ++i)
+		{
+			Ciphers[i]->Encrypt128(Input, InOffset + (i * BLOCK_SIZE), Output, OutOffset + (i * BLOCK_SIZE));
+		}
+	}
+}
+
 void RHX::Initialize(bool Encryption, ISymmetricKey &Parameters)
 {
 	if (!SymmetricKeySize::Contains(LegalKeySizes(), Parameters.KeySizes().KeySize()))
@@ -236,34 +403,32 @@ void RHX::Initialize(bool Encryption, ISymmetricKey &Parameters)
 		StandardExpand(Parameters.SecureKey(), m_rhxState);
 	}
 
-#if defined(CEX_HAS_AVX)
-	if (!Encryption)
+#if defined(CEX_HAS_AESNI)
+	if (m_rhxState->HasAesni)
 	{
-		size_t i;
-		size_t j;
-
-		std::swap(m_rhxState->RoundKeys[0], m_rhxState->RoundKeys[m_rhxState->RoundKeys.size() - 1]);
-
-		for (i = 1, j = m_rhxState->RoundKeys.size() - 2; i < j; ++i, --j)
+		if (!Encryption)
 		{
-			__m128i temp = _mm_aesimc_si128(m_rhxState->RoundKeys[i]);
-			m_rhxState->RoundKeys[i] = _mm_aesimc_si128(m_rhxState->RoundKeys[j]);
-			m_rhxState->RoundKeys[j] = temp;
-		}
+			size_t i;
+			size_t j;
 
-		m_rhxState->RoundKeys[i] = _mm_aesimc_si128(m_rhxState->RoundKeys[i]);
-	}
-#	if defined(CEX_HAS_AVX512)
+			std::swap(m_rhxState->RoundKeys[0], m_rhxState->RoundKeys[m_rhxState->RoundKeys.size() - 1]);
 
-	m_rhxState->RoundKeysW.resize(m_rhxState->RoundKeys.size());
+			for (i = 1, j = m_rhxState->RoundKeys.size() - 2; i < j; ++i, --j)
+			{
+				__m128i temp = _mm_aesimc_si128(m_rhxState->RoundKeys[i]);
+				m_rhxState->RoundKeys[i] = _mm_aesimc_si128(m_rhxState->RoundKeys[j]);
+				m_rhxState->RoundKeys[j] = temp;
+			}
 
-	for (i = 0; i < m_rhxState->RoundKeys.size(); ++i)
-	{
-		m_rhxState->RoundKeysW[i] = Load128To512(m_rhxState->RoundKeys[i]);
+			m_rhxState->RoundKeys[i] = _mm_aesimc_si128(m_rhxState->RoundKeys[i]);
+		}
 	}
-#	endif
+	else
 #endif
-
+	{
+		// transpose the round keys for the bitsliced transforms
+		BitslicedExpand(m_rhxState->WordKeys, BLOCK_SIZE, m_rhxState->SlicedKeys);
+	}
 
 	// ready to transform data
 	m_rhxState->Initialized = true;
@@ -330,14 +495,19 @@ void RHX::Transform1024(const std::vector<uint8_t> &Input, size_t InOffset, std:
 }
 
 void RHX::Transform2048(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset)
+{
+	Transform2048(Input, InOffset, Output, OutOffset, 16 * BLOCK_SIZE);
+}
+
+void RHX::Transform2048(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length)
 {
 	if (m_rhxState->Encryption)
 	{
-		Encrypt2048(Input, InOffset, Output, OutOffset);
+		Encrypt2048(Input, InOffset, Output, OutOffset, Length);
 	}
 	else
 	{
-		Decrypt2048(Input, InOffset, Output, OutOffset);
+		Decrypt2048(Input, InOffset, Output, OutOffset, Length);
 	}
 }
 
@@ -345,252 +515,262 @@ void RHX::Transform2048(const std::vector<uint8_t> &Input, size_t InOffset, std:
 
 void RHX::SecureExpand(const SecureVector<uint8_t> &Key, std::unique_ptr<RhxState> &State, std::unique_ptr<IKdf> &Generator)
 {
-#if defined(CEX_HAS_AVX)
-	size_t i;
-	size_t j;
-	size_t klen;
-	uint32_t tmpbk;
+#if defined(CEX_HAS_AESNI)
+	if (State->HasAesni)
+	{
+		size_t i;
+		size_t j;
+		size_t klen;
+		uint32_t tmpbk;
+
+		// rounds: k256=22, k512=30, k1024=38
+		State->Rounds = Key.size() != 128 ? (Key.size() / 4) + 14 : 38;
+		// round-key array size
+		klen = ((BLOCK_SIZE / sizeof(uint32_t)) * (State->Rounds + 1)) / 4;
+		SecureVector<uint8_t> tmpr(klen * sizeof(__m128i));
+		// salt is not used
+		SecureVector<uint8_t> salt(0);
+		// initialize the generator
+		SymmetricKey kp(Key, salt, State->Custom);
+		Generator->Initialize(kp);
+		// generate the keying material
+		Generator->Generate(tmpr);
+		// initialize round-key array
+		State->RoundKeys.resize(klen);
+
+		// big endian format to align with test vectors
+		for (i = 0; i < tmpr.size(); i += 4)
+		{
+			tmpbk = IntegerTools::BeBytesTo32(tmpr, i);
+			IntegerTools::Le32ToBytes(tmpbk, tmpr, i);
+		}
 
-	// rounds: k256=22, k512=30, k1024=38
-	State->Rounds = Key.size() != 128 ? (Key.size() / 4) + 14 : 38;
-	// round-key array size
-	klen = ((BLOCK_SIZE / sizeof(uint32_t)) * (State->Rounds + 1)) / 4;
-	SecureVector<uint8_t> tmpr(klen * sizeof(__m128i));
-	// salt is not used
-	SecureVector<uint8_t> salt(0);
-	// initialize the generator
-	SymmetricKey kp(Key, salt, State->Custom);
-	Generator->Initialize(kp);
-	// generate the keying material
-	Generator->Generate(tmpr);
-	// initialize round-key array
-	State->RoundKeys.resize(klen);
+		// copy bytes to working key
+		for (i = 0, j = 0; i < klen; ++i, j += 16)
+		{
+			State->RoundKeys[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&tmpr[j]));
+		}
 
-	// big endian format to align with test vectors
-	for (i = 0; i < tmpr.size(); i += 4)
-	{
-		tmpbk = IntegerTools::BeBytesTo32(tmpr, i);
-		IntegerTools::Le32ToBytes(tmpbk, tmpr, i);
+		MemoryTools::Clear(tmpr, 0, tmpr.size());
 	}
-
-	// copy bytes to working key
-	for (i = 0, j = 0; i < klen; ++i, j += 16)
+	else
+#endif
 	{
-		State->RoundKeys[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&tmpr[j]));
-	}
-
-	MemoryTools::Clear(tmpr, 0, tmpr.size());
-
-#else
-
-	size_t klen;
-
-	// rounds: k256=22, k512=30, k1024=38
-	State->Rounds = Key.size() != 128 ? (Key.size() / 4) + 14 : 38;
-	// round-key array size
-	klen = ((BLOCK_SIZE / sizeof(uint32_t)) * (State->Rounds + 1));
-	SecureVector<uint8_t> tmpr(klen * sizeof(uint32_t));
-	// salt is not used
-	SecureVector<uint8_t> salt(0);
-	// initialize the generator
-	SymmetricKey kp(Key, salt, State->Custom);
-	Generator->Initialize(kp);
-	// generate the keying material
-	Generator->Generate(tmpr);
-	// initialize round-key array
-	State->RoundKeys.resize(klen);
-
-	// copy bytes to round keys
+		size_t klen;
+
+		// rounds: k256=22, k512=30, k1024=38
+		State->Rounds = Key.size() != 128 ? (Key.size() / 4) + 14 : 38;
+		// round-key array size
+		klen = ((BLOCK_SIZE / sizeof(uint32_t)) * (State->Rounds + 1));
+		SecureVector<uint8_t> tmpr(klen * sizeof(uint32_t));
+		// salt is not used
+		SecureVector<uint8_t> salt(0);
+		// initialize the generator
+		SymmetricKey kp(Key, salt, State->Custom);
+		Generator->Initialize(kp);
+		// generate the keying material
+		Generator->Generate(tmpr);
+		// initialize round-key array
+		State->WordKeys.resize(klen);
+
+		// copy bytes to round keys
 #if defined(CEX_IS_LITTLE_ENDIAN)
-	MemoryTools::Copy(tmpr, 0, State->RoundKeys, 0, tmpr.size());
+		MemoryTools::Copy(tmpr, 0, State->WordKeys, 0, tmpr.size());
 #else
-	for (size_t i = 0; i < State->RoundKeys.size(); ++i)
-	{
-		State->RoundKeys[i] = IntegerTools::LeBytesTo32(tmpr, i * sizeof(uint32_t));
-	}
+		for (size_t i = 0; i < State->WordKeys.size(); ++i)
+		{
+			State->WordKeys[i] = IntegerTools::LeBytesTo32(tmpr, i * sizeof(uint32_t));
+		}
 #endif
 
-	MemoryTools::Clear(tmpr, 0, tmpr.size());
-#endif
+		MemoryTools::Clear(tmpr, 0, tmpr.size());
+	}
 }
 
 void RHX::StandardExpand(const SecureVector<uint8_t> &Key, std::unique_ptr<RhxState> &State)
 {
-#if defined(CEX_HAS_AVX)
-
-	const size_t BWORDS = BLOCK_SIZE / sizeof(uint32_t);
-	const size_t KWORDS = Key.size() / sizeof(uint32_t);
-
-	// rounds count calculation
-	State->Rounds = KWORDS + 6;
-	// create the expanded round-keys
-	State->RoundKeys.resize((BWORDS * (State->Rounds + 1)) / sizeof(uint32_t));
-
-	if (KWORDS == 8)
-	{
-		State->RoundKeys[0] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&Key[0]));
-		State->RoundKeys[1] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&Key[16]));
-		State->RoundKeys[2] = _mm_aeskeygenassist_si128(State->RoundKeys[1], 0x01);
-		ExpandRotBlock(State->RoundKeys, 2, 2);
-		ExpandSubBlock(State->RoundKeys, 3, 2);
-		State->RoundKeys[4] = _mm_aeskeygenassist_si128(State->RoundKeys[3], 0x02);
-		ExpandRotBlock(State->RoundKeys, 4, 2);
-		ExpandSubBlock(State->RoundKeys, 5, 2);
-		State->RoundKeys[6] = _mm_aeskeygenassist_si128(State->RoundKeys[5], 0x04);
-		ExpandRotBlock(State->RoundKeys, 6, 2);
-		ExpandSubBlock(State->RoundKeys, 7, 2);
-		State->RoundKeys[8] = _mm_aeskeygenassist_si128(State->RoundKeys[7], 0x08);
-		ExpandRotBlock(State->RoundKeys, 8, 2);
-		ExpandSubBlock(State->RoundKeys, 9, 2);
-		State->RoundKeys[10] = _mm_aeskeygenassist_si128(State->RoundKeys[9], 0x10);
-		ExpandRotBlock(State->RoundKeys, 10, 2);
-		ExpandSubBlock(State->RoundKeys, 11, 2);
-		State->RoundKeys[12] = _mm_aeskeygenassist_si128(State->RoundKeys[11], 0x20);
-		ExpandRotBlock(State->RoundKeys, 12, 2);
-		ExpandSubBlock(State->RoundKeys, 13, 2);
-		State->RoundKeys[14] = _mm_aeskeygenassist_si128(State->RoundKeys[13], 0x40);
-		ExpandRotBlock(State->RoundKeys, 14, 2);
-	}
-	else if (KWORDS == 6)
-	{
-		__m128i K0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&Key[0]));
-		__m128i K1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&Key[8]));
-
-		K1 = _mm_srli_si128(K1, 8);
-		State->RoundKeys[0] = K0;
-		State->RoundKeys[1] = K1;
-		ExpandRotBlock(State->RoundKeys, &K0, &K1, _mm_aeskeygenassist_si128(K1, 0x01), 24);
-		ExpandRotBlock(State->RoundKeys, &K0, &K1, _mm_aeskeygenassist_si128(K1, 0x02), 48);
-		ExpandRotBlock(State->RoundKeys, &K0, &K1, _mm_aeskeygenassist_si128(K1, 0x04), 72);
-		ExpandRotBlock(State->RoundKeys, &K0, &K1, _mm_aeskeygenassist_si128(K1, 0x08), 96);
-		ExpandRotBlock(State->RoundKeys, &K0, &K1, _mm_aeskeygenassist_si128(K1, 0x10), 120);
-		ExpandRotBlock(State->RoundKeys, &K0, &K1, _mm_aeskeygenassist_si128(K1, 0x20), 144);
-		ExpandRotBlock(State->RoundKeys, &K0, &K1, _mm_aeskeygenassist_si128(K1, 0x40), 168);
-		ExpandRotBlock(State->RoundKeys, &K0, &K1, _mm_aeskeygenassist_si128(K1, 0x80), 192);
-	}
-	else
+#if defined(CEX_HAS_AESNI)
+	if (State->HasAesni)
 	{
-		State->RoundKeys[0] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Key.data()));
-		State->RoundKeys[1] = _mm_aeskeygenassist_si128(State->RoundKeys[0], 0x01);
-		ExpandRotBlock(State->RoundKeys, 1, 1);
-		State->RoundKeys[2] = _mm_aeskeygenassist_si128(State->RoundKeys[1], 0x02);
-		ExpandRotBlock(State->RoundKeys, 2, 1);
-		State->RoundKeys[3] = _mm_aeskeygenassist_si128(State->RoundKeys[2], 0x04);
-		ExpandRotBlock(State->RoundKeys, 3, 1);
-		State->RoundKeys[4] = _mm_aeskeygenassist_si128(State->RoundKeys[3], 0x08);
-		ExpandRotBlock(State->RoundKeys, 4, 1);
-		State->RoundKeys[5] = _mm_aeskeygenassist_si128(State->RoundKeys[4], 0x10);
-		ExpandRotBlock(State->RoundKeys, 5, 1);
-		State->RoundKeys[6] = _mm_aeskeygenassist_si128(State->RoundKeys[5], 0x20);
-		ExpandRotBlock(State->RoundKeys, 6, 1);
-		State->RoundKeys[7] = _mm_aeskeygenassist_si128(State->RoundKeys[6], 0x40);
-		ExpandRotBlock(State->RoundKeys, 7, 1);
-		State->RoundKeys[8] = _mm_aeskeygenassist_si128(State->RoundKeys[7], 0x80);
-		ExpandRotBlock(State->RoundKeys, 8, 1);
-		State->RoundKeys[9] = _mm_aeskeygenassist_si128(State->RoundKeys[8], 0x1B);
-		ExpandRotBlock(State->RoundKeys, 9, 1);
-		State->RoundKeys[10] = _mm_aeskeygenassist_si128(State->RoundKeys[9], 0x36);
-		ExpandRotBlock(State->RoundKeys, 10, 1);
-	}
-
-#else
-
-	// block and key in 32bit words
-	const size_t BWORDS = BLOCK_SIZE / sizeof(uint32_t);
-	const size_t KWORDS = Key.size() / sizeof(uint32_t);
+		const size_t BWORDS = BLOCK_SIZE / sizeof(uint32_t);
+		const size_t KWORDS = Key.size() / sizeof(uint32_t);
 
-	// rounds count calculation
-	State->Rounds = KWORDS + 6;
-	// setup expanded key
-	State->RoundKeys.resize(BWORDS * (State->Rounds + 1), 0x0UL);
+		// rounds count calculation
+		State->Rounds = KWORDS + 6;
+		// create the expanded round-keys
+		State->RoundKeys.resize((BWORDS * (State->Rounds + 1)) / sizeof(uint32_t));
 
-	// pre-load the s-box into L1 cache
-#if defined(CEX_PREFETCH_RIJNDAEL_TABLES)
-	PrefetchSbox();
-#endif
-
-	if (KWORDS == 8)
-	{
-		State->RoundKeys[0] = IntegerTools::BeBytesTo32(Key, 0);
-		State->RoundKeys[1] = IntegerTools::BeBytesTo32(Key, 4);
-		State->RoundKeys[2] = IntegerTools::BeBytesTo32(Key, 8);
-		State->RoundKeys[3] = IntegerTools::BeBytesTo32(Key, 12);
-		State->RoundKeys[4] = IntegerTools::BeBytesTo32(Key, 16);
-		State->RoundKeys[5] = IntegerTools::BeBytesTo32(Key, 20);
-		State->RoundKeys[6] = IntegerTools::BeBytesTo32(Key, 24);
-		State->RoundKeys[7] = IntegerTools::BeBytesTo32(Key, 28);
-
-		// k256 R: 8,16,24,32,40,48,56 - S: 12,20,28,36,44,52
-		ExpandRotBlock(State->RoundKeys, 8, 8, 1);
-		ExpandSubBlock(State->RoundKeys, 12, 8);
-		ExpandRotBlock(State->RoundKeys, 16, 8, 2);
-		ExpandSubBlock(State->RoundKeys, 20, 8);
-		ExpandRotBlock(State->RoundKeys, 24, 8, 3);
-		ExpandSubBlock(State->RoundKeys, 28, 8);
-		ExpandRotBlock(State->RoundKeys, 32, 8, 4);
-		ExpandSubBlock(State->RoundKeys, 36, 8);
-		ExpandRotBlock(State->RoundKeys, 40, 8, 5);
-		ExpandSubBlock(State->RoundKeys, 44, 8);
-		ExpandRotBlock(State->RoundKeys, 48, 8, 6);
-		ExpandSubBlock(State->RoundKeys, 52, 8);
-		ExpandRotBlock(State->RoundKeys, 56, 8, 7);
-	}
-	else if (KWORDS == 6)
-	{
-		State->RoundKeys[0] = IntegerTools::BeBytesTo32(Key, 0);
-		State->RoundKeys[1] = IntegerTools::BeBytesTo32(Key, 4);
-		State->RoundKeys[2] = IntegerTools::BeBytesTo32(Key, 8);
-		State->RoundKeys[3] = IntegerTools::BeBytesTo32(Key, 12);
-		State->RoundKeys[4] = IntegerTools::BeBytesTo32(Key, 16);
-		State->RoundKeys[5] = IntegerTools::BeBytesTo32(Key, 20);
-
-		// k192 R: 6,12,18,24,30,36,42,48
-		ExpandRotBlock(State->RoundKeys, 6, 6, 1);
-		State->RoundKeys[10] = State->RoundKeys[4] ^ State->RoundKeys[9];
-		State->RoundKeys[11] = State->RoundKeys[5] ^ State->RoundKeys[10];
-		ExpandRotBlock(State->RoundKeys, 12, 6, 2);
-		State->RoundKeys[16] = State->RoundKeys[10] ^ State->RoundKeys[15];
-		State->RoundKeys[17] = State->RoundKeys[11] ^ State->RoundKeys[16];
-		ExpandRotBlock(State->RoundKeys, 18, 6, 3);
-		State->RoundKeys[22] = State->RoundKeys[16] ^ State->RoundKeys[21];
-		State->RoundKeys[23] = State->RoundKeys[17] ^ State->RoundKeys[22];
-		ExpandRotBlock(State->RoundKeys, 24, 6, 4);
-		State->RoundKeys[28] = State->RoundKeys[22] ^ State->RoundKeys[27];
-		State->RoundKeys[29] = State->RoundKeys[23] ^ State->RoundKeys[28];
-		ExpandRotBlock(State->RoundKeys, 30, 6, 5);
-		State->RoundKeys[34] = State->RoundKeys[28] ^ State->RoundKeys[33];
-		State->RoundKeys[35] = State->RoundKeys[29] ^ State->RoundKeys[34];
-		ExpandRotBlock(State->RoundKeys, 36, 6, 6);
-		State->RoundKeys[40] = State->RoundKeys[34] ^ State->RoundKeys[39];
-		State->RoundKeys[41] = State->RoundKeys[35] ^ State->RoundKeys[40];
-		ExpandRotBlock(State->RoundKeys, 42, 6, 7);
-		State->RoundKeys[46] = State->RoundKeys[40] ^ State->RoundKeys[45];
-		State->RoundKeys[47] = State->RoundKeys[41] ^ State->RoundKeys[46];
-		ExpandRotBlock(State->RoundKeys, 48, 6, 8);
+		if (KWORDS == 8)
+		{
+			State->RoundKeys[0] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&Key[0]));
+			State->RoundKeys[1] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&Key[16]));
+			State->RoundKeys[2] = _mm_aeskeygenassist_si128(State->RoundKeys[1], 0x01);
+			ExpandRotBlock(State->RoundKeys, 2, 2);
+			ExpandSubBlock(State->RoundKeys, 3, 2);
+			State->RoundKeys[4] = _mm_aeskeygenassist_si128(State->RoundKeys[3], 0x02);
+			ExpandRotBlock(State->RoundKeys, 4, 2);
+			ExpandSubBlock(State->RoundKeys, 5, 2);
+			State->RoundKeys[6] = _mm_aeskeygenassist_si128(State->RoundKeys[5], 0x04);
+			ExpandRotBlock(State->RoundKeys, 6, 2);
+			ExpandSubBlock(State->RoundKeys, 7, 2);
+			State->RoundKeys[8] = _mm_aeskeygenassist_si128(State->RoundKeys[7], 0x08);
+			ExpandRotBlock(State->RoundKeys, 8, 2);
+			ExpandSubBlock(State->RoundKeys, 9, 2);
+			State->RoundKeys[10] = _mm_aeskeygenassist_si128(State->RoundKeys[9], 0x10);
+			ExpandRotBlock(State->RoundKeys, 10, 2);
+			ExpandSubBlock(State->RoundKeys, 11, 2);
+			State->RoundKeys[12] = _mm_aeskeygenassist_si128(State->RoundKeys[11], 0x20);
+			ExpandRotBlock(State->RoundKeys, 12, 2);
+			ExpandSubBlock(State->RoundKeys, 13, 2);
+			State->RoundKeys[14] = _mm_aeskeygenassist_si128(State->RoundKeys[13], 0x40);
+			ExpandRotBlock(State->RoundKeys, 14, 2);
+		}
+		else if (KWORDS == 6)
+		{
+			__m128i K0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&Key[0]));
+			__m128i K1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&Key[8]));
+
+			K1 = _mm_srli_si128(K1, 8);
+			State->RoundKeys[0] = K0;
+			State->RoundKeys[1] = K1;
+			ExpandRotBlock(State->RoundKeys, &K0, &K1, _mm_aeskeygenassist_si128(K1, 0x01), 24);
+			ExpandRotBlock(State->RoundKeys, &K0, &K1, _mm_aeskeygenassist_si128(K1, 0x02), 48);
+			ExpandRotBlock(State->RoundKeys, &K0, &K1, _mm_aeskeygenassist_si128(K1, 0x04), 72);
+			ExpandRotBlock(State->RoundKeys, &K0, &K1, _mm_aeskeygenassist_si128(K1, 0x08), 96);
+			ExpandRotBlock(State->RoundKeys, &K0, &K1, _mm_aeskeygenassist_si128(K1, 0x10), 120);
+			ExpandRotBlock(State->RoundKeys, &K0, &K1, _mm_aeskeygenassist_si128(K1, 0x20), 144);
+			ExpandRotBlock(State->RoundKeys, &K0, &K1, _mm_aeskeygenassist_si128(K1, 0x40), 168);
+			ExpandRotBlock(State->RoundKeys, &K0, &K1, _mm_aeskeygenassist_si128(K1, 0x80), 192);
+		}
+		else
+		{
+			State->RoundKeys[0] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Key.data()));
+			State->RoundKeys[1] = _mm_aeskeygenassist_si128(State->RoundKeys[0], 0x01);
+			ExpandRotBlock(State->RoundKeys, 1, 1);
+			State->RoundKeys[2] = _mm_aeskeygenassist_si128(State->RoundKeys[1], 0x02);
+			ExpandRotBlock(State->RoundKeys, 2, 1);
+			State->RoundKeys[3] = _mm_aeskeygenassist_si128(State->RoundKeys[2], 0x04);
+			ExpandRotBlock(State->RoundKeys, 3, 1);
+			State->RoundKeys[4] = _mm_aeskeygenassist_si128(State->RoundKeys[3], 0x08);
+			ExpandRotBlock(State->RoundKeys, 4, 1);
+			State->RoundKeys[5] = _mm_aeskeygenassist_si128(State->RoundKeys[4], 0x10);
+			ExpandRotBlock(State->RoundKeys, 5, 1);
+			State->RoundKeys[6] = _mm_aeskeygenassist_si128(State->RoundKeys[5], 0x20);
+			ExpandRotBlock(State->RoundKeys, 6, 1);
+			State->RoundKeys[7] = _mm_aeskeygenassist_si128(State->RoundKeys[6], 0x40);
+			ExpandRotBlock(State->RoundKeys, 7, 1);
+			State->RoundKeys[8] = _mm_aeskeygenassist_si128(State->RoundKeys[7], 0x80);
+			ExpandRotBlock(State->RoundKeys, 8, 1);
+			State->RoundKeys[9] = _mm_aeskeygenassist_si128(State->RoundKeys[8], 0x1B);
+			ExpandRotBlock(State->RoundKeys, 9, 1);
+			State->RoundKeys[10] = _mm_aeskeygenassist_si128(State->RoundKeys[9], 0x36);
+			ExpandRotBlock(State->RoundKeys, 10, 1);
+		}
 	}
 	else
+#endif
 	{
-		State->RoundKeys[0] = IntegerTools::BeBytesTo32(Key, 0);
-		State->RoundKeys[1] = IntegerTools::BeBytesTo32(Key, 4);
-		State->RoundKeys[2] = IntegerTools::BeBytesTo32(Key, 8);
-		State->RoundKeys[3] = IntegerTools::BeBytesTo32(Key, 12);
-
-		// k128 R: 4,8,12,16,20,24,28,32,36,40
-		ExpandRotBlock(State->RoundKeys, 4, 4, 1);
-		ExpandRotBlock(State->RoundKeys, 8, 4, 2);
-		ExpandRotBlock(State->RoundKeys, 12, 4, 3);
-		ExpandRotBlock(State->RoundKeys, 16, 4, 4);
-		ExpandRotBlock(State->RoundKeys, 20, 4, 5);
-		ExpandRotBlock(State->RoundKeys, 24, 4, 6);
-		ExpandRotBlock(State->RoundKeys, 28, 4, 7);
-		ExpandRotBlock(State->RoundKeys, 32, 4, 8);
-		ExpandRotBlock(State->RoundKeys, 36, 4, 9);
-		ExpandRotBlock(State->RoundKeys, 40, 4, 10);
+		// block and key in 32bit words
+		const size_t BWORDS = BLOCK_SIZE / sizeof(uint32_t);
+		const size_t KWORDS = Key.size() / sizeof(uint32_t);
+
+		// rounds count calculation
+		State->Rounds = KWORDS + 6;
+		// setup expanded key
+		State->WordKeys.resize(BWORDS * (State->Rounds + 1), 0x0UL);
+
+		if (KWORDS == 8)
+		{
+			State->WordKeys[0] = IntegerTools::BeBytesTo32(Key, 0);
+			State->WordKeys[1] = IntegerTools::BeBytesTo32(Key, 4);
+			State->WordKeys[2] = IntegerTools::BeBytesTo32(Key, 8);
+			State->WordKeys[3] = IntegerTools::BeBytesTo32(Key, 12);
+			State->WordKeys[4] = IntegerTools::BeBytesTo32(Key, 16);
+			State->WordKeys[5] = IntegerTools::BeBytesTo32(Key, 20);
+			State->WordKeys[6] = IntegerTools::BeBytesTo32(Key, 24);
+			State->WordKeys[7] = IntegerTools::BeBytesTo32(Key, 28);
+
+			// k256 R: 8,16,24,32,40,48,56 - S: 12,20,28,36,44,52
+			ExpandRotBlock(State->WordKeys, 8, 8, 1);
+			ExpandSubBlock(State->WordKeys, 12, 8);
+			ExpandRotBlock(State->WordKeys, 16, 8, 2);
+			ExpandSubBlock(State->WordKeys, 20, 8);
+			ExpandRotBlock(State->WordKeys, 24, 8, 3);
+			ExpandSubBlock(State->WordKeys, 28, 8);
+			ExpandRotBlock(State->WordKeys, 32, 8, 4);
+			ExpandSubBlock(State->WordKeys, 36, 8);
+			ExpandRotBlock(State->WordKeys, 40, 8, 5);
+			ExpandSubBlock(State->WordKeys, 44, 8);
+			ExpandRotBlock(State->WordKeys, 48, 8, 6);
+			ExpandSubBlock(State->WordKeys, 52, 8);
+			ExpandRotBlock(State->WordKeys, 56, 8, 7);
+		}
+		else if (KWORDS == 6)
+		{
+			State->WordKeys[0] = IntegerTools::BeBytesTo32(Key, 0);
+			State->WordKeys[1] = IntegerTools::BeBytesTo32(Key, 4);
+			State->WordKeys[2] = IntegerTools::BeBytesTo32(Key, 8);
+			State->WordKeys[3] = IntegerTools::BeBytesTo32(Key, 12);
+			State->WordKeys[4] = IntegerTools::BeBytesTo32(Key, 16);
+			State->WordKeys[5] = IntegerTools::BeBytesTo32(Key, 20);
+
+			// k192 R: 6,12,18,24,30,36,42,48
+			ExpandRotBlock(State->WordKeys, 6, 6, 1);
+			State->WordKeys[10] = State->WordKeys[4] ^ State->WordKeys[9];
+			State->WordKeys[11] = State->WordKeys[5] ^ State->WordKeys[10];
+			ExpandRotBlock(State->WordKeys, 12, 6, 2);
+			State->WordKeys[16] = State->WordKeys[10] ^ State->WordKeys[15];
+			State->WordKeys[17] = State->WordKeys[11] ^ State->WordKeys[16];
+			ExpandRotBlock(State->WordKeys, 18, 6, 3);
+			State->WordKeys[22] = State->WordKeys[16] ^ State->WordKeys[21];
+			State->WordKeys[23] = State->WordKeys[17] ^ State->WordKeys[22];
+			ExpandRotBlock(State->WordKeys, 24, 6, 4);
+			State->WordKeys[28] = State->WordKeys[22] ^ State->WordKeys[27];
+			State->WordKeys[29] = State->WordKeys[23] ^ State->WordKeys[28];
+			ExpandRotBlock(State->WordKeys, 30, 6, 5);
+			State->WordKeys[34] = State->WordKeys[28] ^ State->WordKeys[33];
+			State->WordKeys[35] = State->WordKeys[29] ^ State->WordKeys[34];
+			ExpandRotBlock(State->WordKeys, 36, 6, 6);
+			State->WordKeys[40] = State->WordKeys[34] ^ State->WordKeys[39];
+			State->WordKeys[41] = State->WordKeys[35] ^ State->WordKeys[40];
+			ExpandRotBlock(State->WordKeys, 42, 6, 7);
+			State->WordKeys[46] = State->WordKeys[40] ^ State->WordKeys[45];
+			State->WordKeys[47] = State->WordKeys[41] ^ State->WordKeys[46];
+			ExpandRotBlock(State->WordKeys, 48, 6, 8);
+		}
+		else
+		{
+			State->WordKeys[0] = IntegerTools::BeBytesTo32(Key, 0);
+			State->WordKeys[1] = IntegerTools::BeBytesTo32(Key, 4);
+			State->WordKeys[2] = IntegerTools::BeBytesTo32(Key, 8);
+			State->WordKeys[3] = IntegerTools::BeBytesTo32(Key, 12);
+
+			// k128 R: 4,8,12,16,20,24,28,32,36,40
+			ExpandRotBlock(State->WordKeys, 4, 4, 1);
+			ExpandRotBlock(State->WordKeys, 8, 4, 2);
+			ExpandRotBlock(State->WordKeys, 12, 4, 3);
+			ExpandRotBlock(State->WordKeys, 16, 4, 4);
+			ExpandRotBlock(State->WordKeys, 20, 4, 5);
+			ExpandRotBlock(State->WordKeys, 24, 4, 6);
+			ExpandRotBlock(State->WordKeys, 28, 4, 7);
+			ExpandRotBlock(State->WordKeys, 32, 4, 8);
+			ExpandRotBlock(State->WordKeys, 36, 4, 9);
+			ExpandRotBlock(State->WordKeys, 40, 4, 10);
+		}
 	}
-#endif
 }
 
-#if defined(CEX_HAS_AVX)
+#if defined(CEX_HAS_AESNI)
+
+bool RHX::HasAesni()
+{
+	return m_rhxState->HasAesni;
+}
+
+const std::vector<__m128i> &RHX::RoundKeys()
+{
+	return m_rhxState->RoundKeys;
+}
 
 void RHX::ExpandRotBlock(std::vector<__m128i> &Key, __m128i* K1, __m128i* K2, __m128i KR, size_t Offset)
 {
@@ -646,45 +826,168 @@ void RHX::ExpandSubBlock(std::vector<__m128i> &Key, size_t Index, size_t Offset)
 	Key[Index] = _mm_xor_si128(pkb, Key[Index]);
 }
 
-void RHX::Decrypt128(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset)
+void RHX::BatchEncrypt128(const SecureVector<uint8_t> &Keys, size_t KeyOffset, const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Lanes)
 {
-	const size_t RNDCNT = m_rhxState->RoundKeys.size() - 2;
-	size_t kctr = 0;
-	__m128i x;
+	std::array<__m128i, BATCH_LANES> k;
+	std::array<__m128i, BATCH_LANES> x;
+	size_t i;
 
-	x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&Input[InOffset]));
-	x = _mm_xor_si128(x, m_rhxState->RoundKeys[kctr]);
+	for (i = 0; i < Lanes; ++i)
+	{
+		k[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&Keys[KeyOffset + (i * IK128_SIZE)]));
+		x[i] = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&Input[InOffset + (i * BLOCK_SIZE)])), k[i]);
+	}
 
-	while (kctr != RNDCNT)
+	// each round key is expanded from the last, and used immediately by its lane; the lanes are independent, so their latencies overlap
+	for (i = 0; i < Lanes; ++i)
 	{
-		++kctr;
-		x = _mm_aesdec_si128(x, m_rhxState->RoundKeys[kctr]);
+		k[i] = BatchExpand(k[i], _mm_shuffle_epi32(_mm_aeskeygenassist_si128(k[i], 0x01), 0xFF));
+		x[i] = _mm_aesenc_si128(x[i], k[i]);
 	}
 
-	++kctr;
-	_mm_storeu_si128(reinterpret_cast<__m128i*>(&Output[OutOffset]), _mm_aesdeclast_si128(x, m_rhxState->RoundKeys[kctr]));
+	for (i = 0; i < Lanes; ++i)
+	{
+		k[i] = BatchExpand(k[i], _mm_shuffle_epi32(_mm_aeskeygenassist_si128(k[i], 0x02), 0xFF));
+		x[i] = _mm_aesenc_si128(x[i], k[i]);
+	}
+
+	for (i = 0; i < Lanes; ++i)
+	{
+		k[i] = BatchExpand(k[i], _mm_shuffle_epi32(_mm_aeskeygenassist_si128(k[i], 0x04), 0xFF));
+		x[i] = _mm_aesenc_si128(x[i], k[i]);
+	}
+
+	for (i = 0; i < Lanes; ++i)
+	{
+		k[i] = BatchExpand(k[i], _mm_shuffle_epi32(_mm_aeskeygenassist_si128(k[i], 0x08), 0xFF));
+		x[i] = _mm_aesenc_si128(x[i], k[i]);
+	}
+
+	for (i = 0; i < Lanes; ++i)
+	{
+		k[i] = BatchExpand(k[i], _mm_shuffle_epi32(_mm_aeskeygenassist_si128(k[i], 0x10), 0xFF));
+		x[i] = _mm_aesenc_si128(x[i], k[i]);
+	}
+
+	for (i = 0; i < Lanes; ++i)
+	{
+		k[i] = BatchExpand(k[i], _mm_shuffle_epi32(_mm_aeskeygenassist_si128(k[i], 0x20), 0xFF));
+		x[i] = _mm_aesenc_si128(x[i], k[i]);
+	}
+
+	for (i = 0; i < Lanes; ++i)
+	{
+		k[i] = BatchExpand(k[i], _mm_shuffle_epi32(_mm_aeskeygenassist_si128(k[i], 0x40), 0xFF));
+		x[i] = _mm_aesenc_si128(x[i], k[i]);
+	}
+
+	for (i = 0; i < Lanes; ++i)
+	{
+		k[i] = BatchExpand(k[i], _mm_shuffle_epi32(_mm_aeskeygenassist_si128(k[i], 0x80), 0xFF));
+		x[i] = _mm_aesenc_si128(x[i], k[i]);
+	}
+
+	for (i = 0; i < Lanes; ++i)
+	{
+		k[i] = BatchExpand(k[i], _mm_shuffle_epi32(_mm_aeskeygenassist_si128(k[i], 0x1B), 0xFF));
+		x[i] = _mm_aesenc_si128(x[i], k[i]);
+	}
+
+	for (i = 0; i < Lanes; ++i)
+	{
+		k[i] = BatchExpand(k[i], _mm_shuffle_epi32(_mm_aeskeygenassist_si128(k[i], 0x36), 0xFF));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(&Output[OutOffset + (i * BLOCK_SIZE)]), _mm_aesenclast_si128(x[i], k[i]));
+	}
+
+	MemoryTools::Clear(k, 0, k.size() * sizeof(__m128i));
+	MemoryTools::Clear(x, 0, x.size() * sizeof(__m128i));
 }
 
-void RHX::Encrypt128(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset)
+void RHX::BatchEncrypt256(const SecureVector<uint8_t> &Keys, size_t KeyOffset, const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Lanes)
 {
-	const size_t RNDCNT = m_rhxState->RoundKeys.size() - 2;
-	size_t kctr = 0;
-	__m128i x;
+	std::array<__m128i, BATCH_LANES> k0;
+	std::array<__m128i, BATCH_LANES> k1;
+	std::array<__m128i, BATCH_LANES> x;
+	size_t i;
 
-	x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&Input[InOffset]));
-	x = _mm_xor_si128(x, m_rhxState->RoundKeys[kctr]);
+	for (i = 0; i < Lanes; ++i)
+	{
+		k0[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&Keys[KeyOffset + (i * IK256_SIZE)]));
+		k1[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&Keys[KeyOffset + (i * IK256_SIZE) + 16]));
+		x[i] = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&Input[InOffset + (i * BLOCK_SIZE)])), k0[i]);
+		x[i] = _mm_aesenc_si128(x[i], k1[i]);
+	}
 
-	while (kctr != RNDCNT)
+	// the two key halves alternate; each round key is expanded and used immediately by its lane
+	for (i = 0; i < Lanes; ++i)
 	{
-		++kctr;
-		x = _mm_aesenc_si128(x, m_rhxState->RoundKeys[kctr]);
+		k0[i] = BatchExpand(k0[i], _mm_shuffle_epi32(_mm_aeskeygenassist_si128(k1[i], 0x01), 0xFF));
+		x[i] = _mm_aesenc_si128(x[i], k0[i]);
+		k1[i] = BatchExpand(k1[i], _mm_shuffle_epi32(_mm_aeskeygenassist_si128(k0[i], 0x00), 0xAA));
+		x[i] = _mm_aesenc_si128(x[i], k1[i]);
 	}
 
-	++kctr;
-	_mm_storeu_si128(reinterpret_cast<__m128i*>(&Output[OutOffset]), _mm_aesenclast_si128(x, m_rhxState->RoundKeys[kctr]));
+	for (i = 0; i < Lanes; ++i)
+	{
+		k0[i] = BatchExpand(k0[i], _mm_shuffle_epi32(_mm_aeskeygenassist_si128(k1[i], 0x02), 0xFF));
+		x[i] = _mm_aesenc_si128(x[i], k0[i]);
+		k1[i] = BatchExpand(k1[i], _mm_shuffle_epi32(_mm_aeskeygenassist_si128(k0[i], 0x00), 0xAA));
+		x[i] = _mm_aesenc_si128(x[i], k1[i]);
+	}
+
+	for (i = 0; i < Lanes; ++i)
+	{
+		k0[i] = BatchExpand(k0[i], _mm_shuffle_epi32(_mm_aeskeygenassist_si128(k1[i], 0x04), 0xFF));
+		x[i] = _mm_aesenc_si128(x[i], k0[i]);
+		k1[i] = BatchExpand(k1[i], _mm_shuffle_epi32(_mm_aeskeygenassist_si128(k0[i], 0x00), 0xAA));
+		x[i] = _mm_aesenc_si128(x[i], k1[i]);
+	}
+
+	for (i = 0; i < Lanes; ++i)
+	{
+		k0[i] = BatchExpand(k0[i], _mm_shuffle_epi32(_mm_aeskeygenassist_si128(k1[i], 0x08), 0xFF));
+		x[i] = _mm_aesenc_si128(x[i], k0[i]);
+		k1[i] = BatchExpand(k1[i], _mm_shuffle_epi32(_mm_aeskeygenassist_si128(k0[i], 0x00), 0xAA));
+		x[i] = _mm_aesenc_si128(x[i], k1[i]);
+	}
+
+	for (i = 0; i < Lanes; ++i)
+	{
+		k0[i] = BatchExpand(k0[i], _mm_shuffle_epi32(_mm_aeskeygenassist_si128(k1[i], 0x10), 0xFF));
+		x[i] = _mm_aesenc_si128(x[i], k0[i]);
+		k1[i] = BatchExpand(k1[i], _mm_shuffle_epi32(_mm_aeskeygenassist_si128(k0[i], 0x00), 0xAA));
+		x[i] = _mm_aesenc_si128(x[i], k1[i]);
+	}
+
+	for (i = 0; i < Lanes; ++i)
+	{
+		k0[i] = BatchExpand(k0[i], _mm_shuffle_epi32(_mm_aeskeygenassist_si128(k1[i], 0x20), 0xFF));
+		x[i] = _mm_aesenc_si128(x[i], k0[i]);
+		k1[i] = BatchExpand(k1[i], _mm_shuffle_epi32(_mm_aeskeygenassist_si128(k0[i], 0x00), 0xAA));
+		x[i] = _mm_aesenc_si128(x[i], k1[i]);
+	}
+
+	for (i = 0; i < Lanes; ++i)
+	{
+		k0[i] = BatchExpand(k0[i], _mm_shuffle_epi32(_mm_aeskeygenassist_si128(k1[i], 0x40), 0xFF));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(&Output[OutOffset + (i * BLOCK_SIZE)]), _mm_aesenclast_si128(x[i], k0[i]));
+	}
+
+	MemoryTools::Clear(k0, 0, k0.size() * sizeof(__m128i));
+	MemoryTools::Clear(k1, 0, k1.size() * sizeof(__m128i));
+	MemoryTools::Clear(x, 0, x.size() * sizeof(__m128i));
 }
 
-#else
+__m128i RHX::BatchExpand(__m128i Key, __m128i Assist)
+{
+	Key = _mm_xor_si128(Key, _mm_slli_si128(Key, 0x4));
+	Key = _mm_xor_si128(Key, _mm_slli_si128(Key, 0x4));
+	Key = _mm_xor_si128(Key, _mm_slli_si128(Key, 0x4));
+
+	return _mm_xor_si128(Key, Assist);
+}
+
+#endif
 
 void RHX::ExpandRotBlock(SecureVector<uint32_t> &RoundKeys, size_t KeyIndex, size_t KeyOffset, size_t RconIndex)
 {
@@ -692,7 +995,7 @@ void RHX::ExpandRotBlock(SecureVector<uint32_t> &RoundKeys, size_t KeyIndex, siz
 
 	kctr = KeyIndex - KeyOffset;
 	RoundKeys[KeyIndex] = RoundKeys[kctr] ^ 
-		SubWord(static_cast<uint32_t>(RoundKeys[KeyIndex - 1] << 8) | static_cast<uint32_t>(RoundKeys[KeyIndex - 1] >> 24) & 0xFF, SBox) ^ 
+		BitslicedSubWord(static_cast<uint32_t>(RoundKeys[KeyIndex - 1] << 8) | static_cast<uint32_t>(RoundKeys[KeyIndex - 1] >> 24) & 0xFF) ^ 
 		Rcon[RconIndex];
 	++KeyIndex;
 	++kctr;
@@ -710,7 +1013,7 @@ void RHX::ExpandSubBlock(SecureVector<uint32_t> &RoundKeys, size_t KeyIndex, siz
 	size_t kctr;
 
 	kctr = KeyIndex - KeyOffset;
-	RoundKeys[KeyIndex] = SubWord(RoundKeys[KeyIndex - 1], SBox) ^ RoundKeys[kctr];
+	RoundKeys[KeyIndex] = BitslicedSubWord(RoundKeys[KeyIndex - 1]) ^ RoundKeys[kctr];
 	++KeyIndex;
 	++kctr;
 	RoundKeys[KeyIndex] = RoundKeys[kctr] ^ RoundKeys[KeyIndex - 1];
@@ -722,126 +1025,238 @@ void RHX::ExpandSubBlock(SecureVector<uint32_t> &RoundKeys, size_t KeyIndex, siz
 	RoundKeys[KeyIndex] = RoundKeys[kctr] ^ RoundKeys[KeyIndex - 1];
 }
 
-void RHX::Decrypt128(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset)
+void RHX::Decrypt128(const uint8_t* Input, uint8_t* Output)
 {
-	SecureVector<uint8_t> state(BLOCK_SIZE, 0x00);
-	size_t i;
+#if defined(CEX_HAS_AESNI)
+	if (m_rhxState->HasAesni)
+	{
+		const size_t RNDCNT = m_rhxState->RoundKeys.size() - 2;
+		size_t kctr = 0;
+		__m128i x;
 
-	MemoryTools::Copy(Input, InOffset, state, 0, BLOCK_SIZE);
-	KeyAddition(state, m_rhxState->RoundKeys, m_rhxState->Rounds << 2);
+		x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Input));
+		x = _mm_xor_si128(x, m_rhxState->RoundKeys[kctr]);
 
-	// pre-load the s-box into L1 cache
-#if defined(CEX_PREFETCH_RIJNDAEL_TABLES)
-	PrefetchISbox();
-#endif
+		while (kctr != RNDCNT)
+		{
+			++kctr;
+			x = _mm_aesdec_si128(x, m_rhxState->RoundKeys[kctr]);
+		}
 
-	for (i = m_rhxState->Rounds - 1; i > 0; --i)
-	{
-		InvShiftRows(state);
-		InvSubBytes(state);
-		KeyAddition(state, m_rhxState->RoundKeys, (i << 2UL));
-		InvMixColumns(state);
+		++kctr;
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(Output), _mm_aesdeclast_si128(x, m_rhxState->RoundKeys[kctr]));
 	}
+	else
+#endif
+	{
+		std::array<uint8_t, BLOCK_SIZE> tmpb;
 
-	InvShiftRows(state);
-	InvSubBytes(state);
-	KeyAddition(state, m_rhxState->RoundKeys, 0);
-
-	MemoryTools::Copy(state, 0, Output, OutOffset, BLOCK_SIZE);
+		// the bitsliced load copies the block to the state; a block in the callers memory passes through the stack
+		MemoryTools::CopyRaw(Input, tmpb.data(), BLOCK_SIZE);
+		BitslicedDecrypt128(m_rhxState->SlicedKeys, m_rhxState->Rounds, tmpb, 0, tmpb, 0, BLOCK_SIZE);
+		MemoryTools::CopyRaw(tmpb.data(), Output, BLOCK_SIZE);
+		MemoryTools::Clear(tmpb, 0, tmpb.size());
+	}
 }
 
-void RHX::Encrypt128(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset)
+void RHX::Decrypt128(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset)
 {
-	SecureVector<uint8_t> state(BLOCK_SIZE, 0x00);
-	size_t i;
-
-	MemoryTools::Copy(Input, InOffset, state, 0, BLOCK_SIZE);
-	KeyAddition(state, m_rhxState->RoundKeys, 0);
-
-	// pre-load the s-box into L1 cache
-#if defined(CEX_PREFETCH_RIJNDAEL_TABLES)
-	PrefetchSbox();
+#if defined(CEX_HAS_AESNI)
+	if (m_rhxState->HasAesni)
+	{
+		Decrypt128(Input.data() + InOffset, Output.data() + OutOffset);
+	}
+	else
 #endif
-
-	for (i = 1; i < m_rhxState->Rounds; ++i)
 	{
-		Substitution(state);
-		ShiftRows128(state);
-		MixColumns(state);
-		KeyAddition(state, m_rhxState->RoundKeys, (i << 2));
+		BitslicedDecrypt128(m_rhxState->SlicedKeys, m_rhxState->Rounds, Input, InOffset, Output, OutOffset, BLOCK_SIZE);
 	}
-
-	Substitution(state);
-	ShiftRows128(state);
-	KeyAddition(state, m_rhxState->RoundKeys, (m_rhxState->Rounds << 2));
-	MemoryTools::Copy(state, 0, Output, OutOffset, BLOCK_SIZE);
 }
 
-CEX_OPTIMIZE_IGNORE
-void RHX::PrefetchISbox()
+void RHX::Encrypt128(const uint8_t* Input, uint8_t* Output)
 {
-	// timing defence: pre-load inverse sbox into l1 cache
-	MemoryTools::PrefetchL1(ISBox, 0, ISBox.size());
+#if defined(CEX_HAS_AESNI)
+	if (m_rhxState->HasAesni)
+	{
+		const size_t RNDCNT = m_rhxState->RoundKeys.size() - 2;
+		size_t kctr = 0;
+		__m128i x;
+
+		x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Input));
+		x = _mm_xor_si128(x, m_rhxState->RoundKeys[kctr]);
+
+		while (kctr != RNDCNT)
+		{
+			++kctr;
+			x = _mm_aesenc_si128(x, m_rhxState->RoundKeys[kctr]);
+		}
+
+		++kctr;
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(Output), _mm_aesenclast_si128(x, m_rhxState->RoundKeys[kctr]));
+	}
+	else
+#endif
+	{
+		std::array<uint8_t, BLOCK_SIZE> tmpb;
+
+		// the bitsliced load copies the block to the state; a block in the callers memory passes through the stack
+		MemoryTools::CopyRaw(Input, tmpb.data(), BLOCK_SIZE);
+		BitslicedEncrypt128(m_rhxState->SlicedKeys, m_rhxState->Rounds, tmpb, 0, tmpb, 0, BLOCK_SIZE);
+		MemoryTools::CopyRaw(tmpb.data(), Output, BLOCK_SIZE);
+		MemoryTools::Clear(tmpb, 0, tmpb.size());
+	}
 }
-CEX_OPTIMIZE_RESUME
 
-CEX_OPTIMIZE_IGNORE
-void RHX::PrefetchSbox()
+void RHX::Encrypt128(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset)
 {
-	// timing defence: pre-load sbox into l1 cache
-	MemoryTools::PrefetchL1(SBox, 0, SBox.size());
-}
-CEX_OPTIMIZE_RESUME
+#if defined(CEX_HAS_AESNI)
+	if (m_rhxState->HasAesni)
+	{
+		Encrypt128(Input.data() + InOffset, Output.data() + OutOffset);
+	}
+	else
 #endif
+	{
+		BitslicedEncrypt128(m_rhxState->SlicedKeys, m_rhxState->Rounds, Input, InOffset, Output, OutOffset, BLOCK_SIZE);
+	}
+}
 
 //~~~Rounds Processing~~~//
 
 void RHX::Decrypt256(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset)
 {
-	Decrypt128(Input, InOffset, Output, OutOffset);
-	Decrypt128(Input, InOffset + 16, Output, OutOffset + 16);
+#if defined(CEX_HAS_AESNI)
+	if (m_rhxState->HasAesni)
+	{
+		Decrypt128(Input, InOffset, Output, OutOffset);
+		Decrypt128(Input, InOffset + 16, Output, OutOffset + 16);
+	}
+	else
+#endif
+	{
+		BitslicedDecrypt128(m_rhxState->SlicedKeys, m_rhxState->Rounds, Input, InOffset, Output, OutOffset, 2 * BLOCK_SIZE);
+	}
 }
 
 void RHX::Decrypt512(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset)
 {
-	Decrypt256(Input, InOffset, Output, OutOffset);
-	Decrypt256(Input, InOffset + 32, Output, OutOffset + 32);
+#if defined(CEX_HAS_AESNI)
+	if (m_rhxState->HasAesni)
+	{
+		Decrypt256(Input, InOffset, Output, OutOffset);
+		Decrypt256(Input, InOffset + 32, Output, OutOffset + 32);
+	}
+	else
+#endif
+	{
+		// the bitsliced state holds four blocks
+		BitslicedDecrypt128(m_rhxState->SlicedKeys, m_rhxState->Rounds, Input, InOffset, Output, OutOffset, 4 * BLOCK_SIZE);
+	}
 }
 
 void RHX::Decrypt1024(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset)
 {
-	Decrypt512(Input, InOffset, Output, OutOffset);
-	Decrypt512(Input, InOffset + 64, Output, OutOffset + 64);
+#if defined(CEX_HAS_AESNI)
+	if (m_rhxState->HasVaes && SimdDispatch::Instance().Select(RijndaelKernels::Compiled(), SimdKernels::Rijndael, 8 * BLOCK_SIZE) >= SimdProfiles::Simd256)
+	{
+		RijndaelKernels::Decrypt8x256H(reinterpret_cast<const uint8_t*>(m_rhxState->RoundKeys.data()), m_rhxState->RoundKeys.size(), Input.data() + InOffset, Output.data() + OutOffset);
+	}
+	else
+#endif
+	{
+		Decrypt512(Input, InOffset, Output, OutOffset);
+		Decrypt512(Input, InOffset + 64, Output, OutOffset + 64);
+	}
 }
 
-void RHX::Decrypt2048(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset)
+void RHX::Decrypt2048(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length)
 {
-	Decrypt1024(Input, InOffset, Output, OutOffset);
-	Decrypt1024(Input, InOffset + 128, Output, OutOffset + 128);
+#if defined(CEX_HAS_AESNI)
+	// vaes is a separate cpuid feature; an avx512 processor may not have it
+	const SimdProfiles SMDPRF = m_rhxState->HasVaes ? SimdDispatch::Instance().Select(RijndaelKernels::Compiled(), SimdKernels::Rijndael, Length) : SimdProfiles::None;
+
+	if (SMDPRF == SimdProfiles::Simd512)
+	{
+		RijndaelKernels::Decrypt16x512H(reinterpret_cast<const uint8_t*>(m_rhxState->RoundKeys.data()), m_rhxState->RoundKeys.size(), Input.data() + InOffset, Output.data() + OutOffset);
+	}
+	else if (SMDPRF == SimdProfiles::Simd256)
+	{
+		RijndaelKernels::Decrypt16x256H(reinterpret_cast<const uint8_t*>(m_rhxState->RoundKeys.data()), m_rhxState->RoundKeys.size(), Input.data() + InOffset, Output.data() + OutOffset);
+	}
+	else
+#endif
+	{
+		Decrypt1024(Input, InOffset, Output, OutOffset);
+		Decrypt1024(Input, InOffset + 128, Output, OutOffset + 128);
+	}
 }
 
 void RHX::Encrypt256(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset)
 {
-	Encrypt128(Input, InOffset, Output, OutOffset);
-	Encrypt128(Input, InOffset + 16, Output, OutOffset + 16);
+#if defined(CEX_HAS_AESNI)
+	if (m_rhxState->HasAesni)
+	{
+		Encrypt128(Input, InOffset, Output, OutOffset);
+		Encrypt128(Input, InOffset + 16, Output, OutOffset + 16);
+	}
+	else
+#endif
+	{
+		BitslicedEncrypt128(m_rhxState->SlicedKeys, m_rhxState->Rounds, Input, InOffset, Output, OutOffset, 2 * BLOCK_SIZE);
+	}
 }
 
 void RHX::Encrypt512(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset)
 {
-	Encrypt256(Input, InOffset, Output, OutOffset);
-	Encrypt256(Input, InOffset + 32, Output, OutOffset + 32);
+#if defined(CEX_HAS_AESNI)
+	if (m_rhxState->HasAesni)
+	{
+		Encrypt256(Input, InOffset, Output, OutOffset);
+		Encrypt256(Input, InOffset + 32, Output, OutOffset + 32);
+	}
+	else
+#endif
+	{
+		// the bitsliced state holds four blocks
+		BitslicedEncrypt128(m_rhxState->SlicedKeys, m_rhxState->Rounds, Input, InOffset, Output, OutOffset, 4 * BLOCK_SIZE);
+	}
 }
 
 void RHX::Encrypt1024(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset)
 {
-	Encrypt512(Input, InOffset, Output, OutOffset);
-	Encrypt512(Input, InOffset + 64, Output, OutOffset + 64);
+#if defined(CEX_HAS_AESNI)
+	if (m_rhxState->HasVaes && SimdDispatch::Instance().Select(RijndaelKernels::Compiled(), SimdKernels::Rijndael, 8 * BLOCK_SIZE) >= SimdProfiles::Simd256)
+	{
+		RijndaelKernels::Encrypt8x256H(reinterpret_cast<const uint8_t*>(m_rhxState->RoundKeys.data()), m_rhxState->RoundKeys.size(), Input.data() + InOffset, Output.data() + OutOffset);
+	}
+	else
+#endif
+	{
+		Encrypt512(Input, InOffset, Output, OutOffset);
+		Encrypt512(Input, InOffset + 64, Output, OutOffset + 64);
+	}
 }
 
-void RHX::Encrypt2048(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset)
+void RHX::Encrypt2048(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length)
 {
-	Encrypt1024(Input, InOffset, Output, OutOffset);
-	Encrypt1024(Input, InOffset + 128, Output, OutOffset + 128);
+#if defined(CEX_HAS_AESNI)
+	// vaes is a separate cpuid feature; an avx512 processor may not have it
+	const SimdProfiles SMDPRF = m_rhxState->HasVaes ? SimdDispatch::Instance().Select(RijndaelKernels::Compiled(), SimdKernels::Rijndael, Length) : SimdProfiles::None;
+
+	if (SMDPRF == SimdProfiles::Simd512)
+	{
+		RijndaelKernels::Encrypt16x512H(reinterpret_cast<const uint8_t*>(m_rhxState->RoundKeys.data()), m_rhxState->RoundKeys.size(), Input.data() + InOffset, Output.data() + OutOffset);
+	}
+	else if (SMDPRF == SimdProfiles::Simd256)
+	{
+		RijndaelKernels::Encrypt16x256H(reinterpret_cast<const uint8_t*>(m_rhxState->RoundKeys.data()), m_rhxState->RoundKeys.size(), Input.data() + InOffset, Output.data() + OutOffset);
+	}
+	else
+#endif
+	{
+		Encrypt1024(Input, InOffset, Output, OutOffset);
+		Encrypt1024(Input, InOffset + 128, Output, OutOffset + 128);
+	}
 }
 
 //~~~Private Functions~~~//
@@ -903,19 +1318,4 @@ std::vector<SymmetricKeySize> RHX::CalculateKeySizes(BlockCipherExtensions Exten
 	return keys;
 }
 
-#if defined(CEX_HAS_AVX512)
-__m512i RHX::Load128To512(__m128i &V)
-{
-	__m512i x;
-
-	x = _mm512_setzero_si512();
-	x = _mm512_inserti32x4(x, V, 0);
-	x = _mm512_inserti32x4(x, V, 1);
-	x = _mm512_inserti32x4(x, V, 2);
-	x = _mm512_inserti32x4(x, V, 3);
-
-	return x;
-}
-#endif
-
 NAMESPACE_BLOCKEND
@@ -37,12 +37,17 @@
 #define CEX_RHX_H
 
 #include "IBlockCipher.h"
-#if defined(CEX_HAS_AVX)
+#if defined(CEX_HAS_AESNI)
 #	include "Intrinsics.h"
 #endif
 
 NAMESPACE_BLOCK
 
+namespace Mode
+{
+	class GCM;
+}
+
 /// <summary>
 /// A Rijndael cipher using either standard modes, or extended modes of operation using a HKDF(SHA2) or cSHAKE key schedule, and increased transformation rounds.
 /// <para>This cipher should not be used directly but through a cipher mode, or as part of a larger construction.</para>
@@ -85,8 +90,8 @@ NAMESPACE_BLOCK
 /// <item><description>RHX512, (cSHAKE-512 variant) = RHXS51202</description>.</item>
 /// </list>
 /// <para>AHX, the Intel AES-NI implementation is considered the primary AES/eAES implementation, with this version used as a fallback. \n
-/// There are two implementations in this version, the constant-time implementation which is the default, and the table-based implementation, 
-/// which is fast but vulnerable to timing related side-channel attacks.</para>
+/// On a processor without AES-NI the cipher selects a bitsliced, constant-time implementation at run-time; four blocks are transformed in parallel as boolean circuits, 
+/// with no lookup tables or key and data dependent memory accesses.</para>
 /// <para>When using the extended mode of the cipher, the minimum key size is 32 bytes (256 bits), and valid key sizes are 256, 512, and 1024 bits int64_t. \n
 /// RHX is capable of processing up to 38 transformation rounds in extended mode; a 256-bit key uses 22 rounds, a 512-bit key 30 rounds, and a 1024-bit key is set to 38 rounds.</para>
 /// 
@@ -120,6 +125,8 @@ class RHX final : public IBlockCipher
 private:
 
 	static const size_t BLOCK_SIZE = 16;
+	// the number of keys processed together by EncryptBatch
+	static const size_t BATCH_LANES = 8;
 	static const size_t IK128_SIZE = 16;
 	static const size_t IK192_SIZE = 24;
 	static const size_t IK256_SIZE = 32;
@@ -134,6 +141,9 @@ private:
 	std::unique_ptr<RhxState> m_rhxState;
 	std::unique_ptr<IKdf> m_kdfGenerator;
 
+	// the stitched AES-GCM kernel reads the round-key schedule
+	friend class Mode::GCM;
+
 public:
 
 	//~~~Constructor~~~//
@@ -239,6 +249,16 @@ public:
 	/// <param name="OutOffset">Starting offset within the output array</param>
 	void DecryptBlock(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset) override;
 
+	/// <summary>
+	/// Decrypt a block of bytes in the callers memory.
+	/// <para><see cref="Initialize(bool, ISymmetricKey)"/> must be called with the Encryption flag set to <c>false</c> before this method can be used.
+	/// Input and Output must point to at least <see cref="BlockSize"/> bytes, and may be the same address.</para>
+	/// </summary>
+	/// 
+	/// <param name="Input">A pointer to the encrypted bytes</param>
+	/// <param name="Output">A pointer to the decrypted bytes</param>
+	void DecryptBlock(const uint8_t* Input, uint8_t* Output) override;
+
 	/// <summary>
 	/// Encrypt a block of bytes.
 	/// <para><see cref="Initialize(bool, ISymmetricKey)"/> must be called with the Encryption flag set to <c>true</c> before this method can be used.
@@ -261,6 +281,51 @@ public:
 	/// <param name="OutOffset">Starting offset within the output array</param>
 	void EncryptBlock(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset) override;
 
+	/// <summary>
+	/// Encrypt a block of bytes in the callers memory.
+	/// <para><see cref="Initialize(bool, ISymmetricKey)"/> must be called with the Encryption flag set to <c>true</c> before this method can be used.
+	/// Input and Output must point to at least <see cref="BlockSize"/> bytes, and may be the same address.</para>
+	/// </summary>
+	/// 
+	/// <param name="Input">A pointer to the bytes to transform</param>
+	/// <param name="Output">A pointer to the transformed bytes</param>
+	void EncryptBlock(const uint8_t* Input, uint8_t* Output) override;
+
+	/// <summary>
+	/// Encrypt one block under each of many independent AES keys, in a single call.
+	/// <para>Block i of the input is encrypted with key i, using the standard FIPS 197 key schedule; the extended (HKDF and SHAKE) schedules are not used.
+	/// Up to eight keys are processed together: each round key is expanded just before its round, and the key expansion and rounds of all lanes are interleaved, 
+	/// so the AES-NI pipeline stays full when every key encrypts a single block. The expanded keys are never stored in memory. 
+	/// The Keys array is the concatenation of Count keys, each KeySize bytes.</para>
+	/// </summary>
+	/// 
+	/// <param name="Keys">The concatenated cipher keys</param>
+	/// <param name="KeySize">The size of each key in bytes; 16 or 32</param>
+	/// <param name="Input">The input array of plain-text blocks</param>
+	/// <param name="InOffset">Starting offset within the input array</param>
+	/// <param name="Output">The output array of cipher-text blocks</param>
+	/// <param name="OutOffset">Starting offset within the output array</param>
+	/// <param name="Count">The number of keys and blocks</param>
+	///
+	/// <exception cref="CryptoSymmetricException">Thrown if the key size is not 16 or 32 bytes, or an array is too small</exception>
+	static void EncryptBatch(const SecureVector<uint8_t> &Keys, size_t KeySize, const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Count);
+
+	/// <summary>
+	/// Encrypt one block with each of several initialized cipher instances, in a single call.
+	/// <para>Block i of the input is encrypted by Ciphers[i]. Up to eight instances are processed together, with the rounds of every lane interleaved, 
+	/// so the latency of the AES-NI instruction in one lane is hidden by the others. This is the primitive used to run independent chained streams, 
+	/// such as multiple CBC messages, in lockstep. Every instance must be initialized for encryption.</para>
+	/// </summary>
+	/// 
+	/// <param name="Ciphers">The initialized cipher instances, one per block</param>
+	/// <param name="Input">The input array of plain-text blocks</param>
+	/// <param name="InOffset">Starting offset within the input array</param>
+	/// <param name="Output">The output array of cipher-text blocks</param>
+	/// <param name="OutOffset">Starting offset within the output array</param>
+	///
+	/// <exception cref="CryptoSymmetricException">Thrown if an instance is not initialized for encryption, or an array is too small</exception>
+	static void EncryptLanes(const std::vector<RHX*> &Ciphers, const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset);
+
 	/// <summary>
 	/// Initialize the cipher with a populated SymmetricKey or SymmetricSecureKey container
 	/// </summary>
@@ -342,35 +407,50 @@ public:
 	/// <param name="OutOffset">Starting offset in the output array</param>
 	void Transform2048(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset) override;
 
+	/// <summary>
+	/// Transform 16 blocks of bytes, as part of a longer message.
+	/// <para><see cref="Initialize(bool, ISymmetricKey)"/> must be called before this method can be used.
+	/// Input and Output array lengths must be at least 16 * <see cref="BlockSize"/> in length.
+	/// The message length selects the kernel width; the 512-bit kernels are only used when it reaches the wide threshold set in SimdDispatch.</para>
+	/// </summary>
+	/// 
+	/// <param name="Input">The input array of bytes to transform</param>
+	/// <param name="InOffset">Starting offset in the Input array</param>
+	/// <param name="Output">The output array of transformed bytes</param>
+	/// <param name="OutOffset">Starting offset in the output array</param>
+	/// <param name="Length">The number of bytes in the message being transformed by the caller</param>
+	void Transform2048(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length) override;
+
 private:
 
 	static std::vector<SymmetricKeySize> CalculateKeySizes(BlockCipherExtensions Extension);
-#if defined(CEX_HAS_AVX)
+#if defined(CEX_HAS_AESNI)
+	bool HasAesni();
+	const std::vector<__m128i> &RoundKeys();
 	static void ExpandRotBlock(std::vector<__m128i> &Key, __m128i* K1, __m128i* K2, __m128i KR, size_t Offset);
 	static void ExpandRotBlock(std::vector<__m128i> &Key, size_t Index, size_t Offset);
 	static void ExpandSubBlock(std::vector<__m128i> &Key, size_t Index, size_t Offset);
-#	if defined(CEX_HAS_AVX512)
-	static __m512i Load128To512(__m128i &V);
-#	endif
-#else
+	static void BatchEncrypt128(const SecureVector<uint8_t> &Keys, size_t KeyOffset, const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Lanes);
+	static void BatchEncrypt256(const SecureVector<uint8_t> &Keys, size_t KeyOffset, const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Lanes);
+	static __m128i BatchExpand(__m128i Key, __m128i Assist);
+#endif
 	static void ExpandRotBlock(SecureVector<uint32_t> &RoundKeys, size_t KeyIndex, size_t KeyOffset, size_t RconIndex);
 	static void ExpandSubBlock(SecureVector<uint32_t> &RoundKeys, size_t KeyIndex, size_t KeyOffset);
-	static void PrefetchISbox();
-	static void PrefetchSbox();
-#endif
 	static void SecureExpand(const SecureVector<uint8_t> &Key, std::unique_ptr<RhxState> &State, std::unique_ptr<IKdf> &Generator);
 	static void StandardExpand(const SecureVector<uint8_t> &Key, std::unique_ptr<RhxState> &State);
 
+	void Decrypt128(const uint8_t* Input, uint8_t* Output);
 	void Decrypt128(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset);
 	void Decrypt256(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset);
 	void Decrypt512(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset);
 	void Decrypt1024(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset);
-	void Decrypt2048(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset);
+	void Decrypt2048(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length);
+	void Encrypt128(const uint8_t* Input, uint8_t* Output);
 	void Encrypt128(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset);
 	void Encrypt256(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset);
 	void Encrypt512(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset);
 	void Encrypt1024(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset);
-	void Encrypt2048(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset);
+	void Encrypt2048(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length);
 };
 
 NAMESPACE_BLOCKEND
@@ -3,7 +3,9 @@
 #include "IntegerTools.h"
 #include "KMAC.h"
 #include "MemoryTools.h"
+#include "ParallelScratch.h"
 #include "Rijndael.h"
+#include "SegmentScratch.h"
 #include "SHAKE.h"
 
 NAMESPACE_STREAM
@@ -16,7 +18,9 @@ using Tools::IntegerTools;
 using Mac::KMAC;
 using Enumeration::KmacModes;
 using Tools::MemoryTools;
+using Tools::ParallelScratch;
 using Tools::ParallelTools;
+using Tools::SegmentScratch;
 using Enumeration::ShakeModes;
 using Enumeration::StreamCipherConvert;
 
@@ -33,6 +37,9 @@ public:
 		SymmetricKeySize(IK256_SIZE, BLOCK_SIZE, INFO_SIZE),
 		SymmetricKeySize(IK512_SIZE, BLOCK_SIZE, INFO_SIZE)};
 	std::vector<uint8_t> Nonce;
+	std::vector<uint8_t> Origin;
+	ParallelScratch Scratch;
+	SegmentScratch Segments;
 	uint64_t Counter = 0;
 	uint32_t Rounds = 0;
 	KmacModes Authenticator = KmacModes::None;
@@ -48,6 +55,7 @@ public:
 		MacKey(0),
 		Name(0),
 		Nonce(BLOCK_SIZE),
+		Origin(BLOCK_SIZE, 0x00),
 		IsAuthenticated(Authenticate)
 	{
 	}
@@ -65,6 +73,8 @@ public:
 		MemoryTools::Clear(MacTag, 0, MacTag.size());
 		MemoryTools::Clear(Name, 0, Name.size());
 		MemoryTools::Clear(Nonce, 0, Nonce.size());
+		MemoryTools::Clear(Origin, 0, Origin.size());
+		Scratch.Clear();
 		LegalKeySizes.clear();
 		Counter = 0;
 		Rounds = 0;
@@ -119,6 +129,12 @@ public:
 		MemoryTools::Copy(SecureState, soff, Nonce, 0, Nonce.size());
 		soff += vlen;
 
+		MemoryTools::CopyToObject(SecureState, soff, &vlen, sizeof(uint16_t));
+		Origin.resize(vlen);
+		soff += sizeof(uint16_t);
+		MemoryTools::Copy(SecureState, soff, Origin, 0, Origin.size());
+		soff += vlen;
+
 		MemoryTools::CopyToObject(SecureState, soff, &Counter, sizeof(uint64_t));
 		soff += sizeof(uint64_t);
 		MemoryTools::CopyToObject(SecureState, soff, &Rounds, sizeof(uint32_t));
@@ -144,6 +160,9 @@ public:
 		MemoryTools::Clear(MacTag, 0, MacTag.size());
 		MemoryTools::Clear(Name, 0, Name.size());
 		MemoryTools::Clear(Nonce, 0, Nonce.size());
+		MemoryTools::Clear(Origin, 0, Origin.size());
+		Scratch.Clear();
+		Segments.Clear();
 		Counter = 0;
 		Rounds = 0;
 		IsEncryption = false;
@@ -153,7 +172,7 @@ public:
 	SecureVector<uint8_t> Serialize()
 	{
 		const size_t STALEN = (RoundKeys.size() * sizeof(uint32_t)) + Custom.size() + MacKey.size() + MacTag.size() +
-			Name.size() + Nonce.size() + sizeof(uint64_t) + sizeof(uint32_t) + sizeof(KmacModes) + sizeof(ShakeModes) + (3 * sizeof(bool)) + (7 * sizeof(uint16_t));
+			Name.size() + Nonce.size() + Origin.size() + sizeof(uint64_t) + sizeof(uint32_t) + sizeof(KmacModes) + sizeof(ShakeModes) + (3 * sizeof(bool)) + (8 * sizeof(uint16_t));
 
 		size_t soff;
 		uint16_t vlen;
@@ -196,6 +215,12 @@ public:
 		MemoryTools::Copy(Nonce, 0, state, soff, Nonce.size());
 		soff += Nonce.size();
 
+		vlen = static_cast<uint16_t>(Origin.size());
+		MemoryTools::CopyFromObject(&vlen, state, soff, sizeof(uint16_t));
+		soff += sizeof(uint16_t);
+		MemoryTools::Copy(Origin, 0, state, soff, Origin.size());
+		soff += Origin.size();
+
 		MemoryTools::CopyFromObject(&Counter, state, soff, sizeof(uint64_t));
 		soff += sizeof(uint64_t);
 		MemoryTools::CopyFromObject(&Rounds, state, soff, sizeof(uint32_t));
@@ -224,6 +249,7 @@ RWS::RWS(bool Authenticate)
 	m_macAuthenticator(nullptr),
 	m_parallelProfile(BLOCK_SIZE, true, STATE_PRECACHED, true)
 {
+	m_parallelProfile.SetAlgorithm(Name());
 }
 
 RWS::RWS(SecureVector<uint8_t> &State)
@@ -241,6 +267,8 @@ RWS::RWS(SecureVector<uint8_t> &State)
 		SymmetricKey kpm(m_rwsState->MacKey);
 		m_macAuthenticator->Initialize(kpm);
 	}
+
+	m_parallelProfile.SetAlgorithm(Name());
 }
 
 RWS::~RWS()
@@ -429,6 +457,7 @@ void RWS::Initialize(bool Encryption, ISymmetricKey &Parameters)
 
 	// copy the nonce to state
 	MemoryTools::Copy(Parameters.IV(), 0, m_rwsState->Nonce, 0, BLOCK_SIZE);
+	MemoryTools::Copy(Parameters.IV(), 0, m_rwsState->Origin, 0, BLOCK_SIZE);
 
 	// initialize cSHAKE with k,c,n
 	Kdf::SHAKE gen(m_rwsState->Mode);
@@ -479,6 +508,25 @@ void RWS::ParallelMaxDegree(size_t Degree)
 	m_parallelProfile.SetMaxDegree(Degree);
 }
 
+void RWS::Seek(uint64_t Position)
+{
+	if (IsInitialized() == false)
+	{
+		throw CryptoSymmetricException(Name(), std::string("Seek"), std::string("The cipher has not been initialized!"), ErrorCodes::NotInitialized);
+	}
+	if (IsAuthenticator() == true)
+	{
+		throw CryptoSymmetricException(Name(), std::string("Seek"), std::string("The key-stream position can not be set in authentication mode!"), ErrorCodes::IllegalOperation);
+	}
+	if (Position % BLOCK_SIZE != 0)
+	{
+		throw CryptoSymmetricException(Name(), std::string("Seek"), std::string("The position must be aligned to the block size!"), ErrorCodes::InvalidParam);
+	}
+
+	// the counter is the first 16 bytes of the initial nonce, increased by the block index
+	IntegerTools::LeIncrease8(m_rwsState->Origin, m_rwsState->Nonce, 0, 16, static_cast<uint64_t>(Position / BLOCK_SIZE));
+}
+
 void RWS::SetAssociatedData(const std::vector<uint8_t> &Input, size_t Offset, size_t Length)
 {
 	if (IsInitialized() == false)
@@ -504,6 +552,31 @@ void RWS::SetAssociatedData(const std::vector<uint8_t> &Input, size_t Offset, si
 	}
 }
 
+void RWS::SetAssociatedData(const uint8_t* Input, size_t Length)
+{
+	if (IsInitialized() == false)
+	{
+		throw CryptoSymmetricException(Name(), std::string("SetAssociatedData"), std::string("The cipher has not been initialized!"), ErrorCodes::NotInitialized);
+	}
+	if (m_macAuthenticator == nullptr)
+	{
+		throw CryptoSymmetricException(Name(), std::string("SetAssociatedData"), std::string("The cipher has not been configured for authentication!"), ErrorCodes::IllegalOperation);
+	}
+	if (Length == 0)
+	{
+		throw CryptoSymmetricException(Name(), std::string("SetAssociatedData"), std::string("The additional data array can not be zero sized!"), ErrorCodes::InvalidSize);
+	}
+
+	if (IsAuthenticator() == true)
+	{
+		std::vector<uint8_t> code(sizeof(uint32_t));
+		// version 1.1a add AD and encoding to hash
+		static_cast<KMAC*>(m_macAuthenticator.get())->Update(Input, Length);
+		IntegerTools::Le32ToBytes(static_cast<uint32_t>(Length), code, 0);
+		m_macAuthenticator->Update(code, 0, code.size());
+	}
+}
+
 void RWS::Transform(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length)
 {
 	CEXASSERT(IsInitialized(), "The cipher mode has not been initialized!");
@@ -521,7 +594,7 @@ void RWS::Transform(const std::vector<uint8_t> &Input, size_t InOffset, std::vec
 			// add the starting position of the nonce
 			m_macAuthenticator->Update(m_rwsState->Nonce, 0, BLOCK_SIZE);
 			// encrypt the stream
-			Process(Input, InOffset, Output, OutOffset, Length);
+			Process(Input.data(), InOffset, Output, OutOffset, Length);
 			// update the mac with the ciphertext
 			m_macAuthenticator->Update(Output, OutOffset, Length);
 			// update the processed bytes counter
@@ -533,7 +606,7 @@ void RWS::Transform(const std::vector<uint8_t> &Input, size_t InOffset, std::vec
 		else
 		{
 			// encrypt the stream
-			Process(Input, InOffset, Output, OutOffset, Length);
+			Process(Input.data(), InOffset, Output, OutOffset, Length);
 		}
 	}
 	else
@@ -556,7 +629,98 @@ void RWS::Transform(const std::vector<uint8_t> &Input, size_t InOffset, std::vec
 		}
 
 		// decrypt the stream
-		Process(Input, InOffset, Output, OutOffset, Length);
+		Process(Input.data(), InOffset, Output, OutOffset, Length);
+	}
+}
+
+void RWS::Transform(const uint8_t* Input, uint8_t* Output, size_t Length)
+{
+	CEXASSERT(IsInitialized(), "The cipher mode has not been initialized!");
+
+	// the key-stream is generated in segments, and combined with the callers memory in a single pass
+	auto gen = [this](std::vector<uint8_t> &Target, size_t Count)
+	{
+		Process(nullptr, 0, Target, 0, Count);
+	};
+
+	if (IsEncryption() == true)
+	{
+		if (IsAuthenticator() == true)
+		{
+			// add the starting position of the nonce
+			m_macAuthenticator->Update(m_rwsState->Nonce, 0, BLOCK_SIZE);
+			// encrypt the stream
+			m_rwsState->Segments.Keystream(Input, Output, Length, ParallelBlockSize(), gen);
+			// update the mac with the ciphertext
+			static_cast<KMAC*>(m_macAuthenticator.get())->Update(Output, Length);
+			// update the mac counter
+			m_rwsState->Counter += Length;
+			// finalize the mac and add the tag to the stream
+			Finalize(m_rwsState, m_macAuthenticator);
+			MemoryTools::CopyRaw(m_rwsState->MacTag.data(), Output + Length, m_rwsState->MacTag.size());
+		}
+		else
+		{
+			// encrypt the stream
+			m_rwsState->Segments.Keystream(Input, Output, Length, ParallelBlockSize(), gen);
+		}
+	}
+	else
+	{
+		if (IsAuthenticator() == true)
+		{
+			// add the starting position of the nonce
+			m_macAuthenticator->Update(m_rwsState->Nonce, 0, BLOCK_SIZE);
+			// update the mac with the ciphertext
+			static_cast<KMAC*>(m_macAuthenticator.get())->Update(Input, Length);
+			// update the mac counter
+			m_rwsState->Counter += Length;
+			// finalize the mac and verify
+			Finalize(m_rwsState, m_macAuthenticator);
+
+			if (IntegerTools::CompareRaw(Input + Length, m_rwsState->MacTag.data(), m_rwsState->MacTag.size()) == false)
+			{
+				throw CryptoAuthenticationFailure(Name(), std::string("Transform"), std::string("The authentication tag does not match!"), ErrorCodes::AuthenticationFailure);
+			}
+		}
+
+		// decrypt the stream
+		m_rwsState->Segments.Keystream(Input, Output, Length, ParallelBlockSize(), gen);
+	}
+}
+
+void RWS::TransformAt(uint64_t Position, const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length)
+{
+	CEXASSERT(IntegerTools::Min(Input.size() - InOffset, Output.size() - OutOffset) >= Length, "The data arrays are smaller than the length!");
+
+	const size_t HDRLEN = static_cast<size_t>(Position % BLOCK_SIZE);
+	size_t i;
+	size_t prclen;
+
+	Seek(Position - HDRLEN);
+
+	if (HDRLEN != 0 && Length != 0)
+	{
+		// the position is inside a block; use the tail of that blocks key-stream
+		std::vector<uint8_t> otp(BLOCK_SIZE);
+		prclen = IntegerTools::Min(BLOCK_SIZE - HDRLEN, Length);
+		Transform512(m_rwsState->Nonce, 0, otp, 0);
+		IntegerTools::LeIncrement(m_rwsState->Nonce, 16);
+
+		for (i = 0; i < prclen; ++i)
+		{
+			Output[OutOffset + i] = Input[InOffset + i] ^ otp[HDRLEN + i];
+		}
+
+		MemoryTools::Clear(otp, 0, otp.size());
+		InOffset += prclen;
+		OutOffset += prclen;
+		Length -= prclen;
+	}
+
+	if (Length != 0)
+	{
+		Process(Input.data(), InOffset, Output, OutOffset, Length);
 	}
 }
 
@@ -578,7 +742,7 @@ void RWS::Finalize(std::unique_ptr<RwsState> &State, std::unique_ptr<IMac> &Auth
 	Authenticator->Finalize(State->MacTag, 0);
 }
 
-void RWS::Generate(std::vector<uint8_t> &Output, size_t OutOffset, size_t Length, std::vector<uint8_t> &Counter)
+void RWS::Generate(std::vector<uint8_t> &Output, size_t OutOffset, size_t Length, std::vector<uint8_t> &Counter, std::vector<uint8_t> &Buffer)
 {
 	size_t bctr;
 
@@ -588,115 +752,52 @@ void RWS::Generate(std::vector<uint8_t> &Output, size_t OutOffset, size_t Length
 	// as the full counter length. This is because this cipher is not expected to encrypt
 	// more that 2^128 bytes of data with a single key.
 
-#if defined(CEX_HAS_AVX512)
-
-	const size_t AVX512BLK = 16 * BLOCK_SIZE;
+	const size_t WIDBLK = 16 * BLOCK_SIZE;
 
-	if (Length >= AVX512BLK)
+	if (Length >= WIDBLK)
 	{
-		const size_t PBKALN = Length - (Length % AVX512BLK);
-		std::vector<uint8_t> tmpc(AVX512BLK);
+		const size_t PBKALN = Length - (Length % WIDBLK);
 
-		// stagger counters and process 8 blocks with avx512
+		// stagger counters and process 16 blocks
 		while (bctr != PBKALN)
 		{
-			MemoryTools::Copy(Counter, 0, tmpc, 0, BLOCK_SIZE);
-			IntegerTools::LeIncrement(Counter, 16);
-			MemoryTools::Copy(Counter, 0, tmpc, 64, BLOCK_SIZE);
-			IntegerTools::LeIncrement(Counter, 16);
-			MemoryTools::Copy(Counter, 0, tmpc, 128, BLOCK_SIZE);
-			IntegerTools::LeIncrement(Counter, 16);
-			MemoryTools::Copy(Counter, 0, tmpc, 192, BLOCK_SIZE);
-			IntegerTools::LeIncrement(Counter, 16);
-			MemoryTools::Copy(Counter, 0, tmpc, 256, BLOCK_SIZE);
-			IntegerTools::LeIncrement(Counter, 16);
-			MemoryTools::Copy(Counter, 0, tmpc, 320, BLOCK_SIZE);
-			IntegerTools::LeIncrement(Counter, 16);
-			MemoryTools::Copy(Counter, 0, tmpc, 384, BLOCK_SIZE);
-			IntegerTools::LeIncrement(Counter, 16);
-			MemoryTools::Copy(Counter, 0, tmpc, 448, BLOCK_SIZE);
+			MemoryTools::Copy(Counter, 0, Buffer, 0, BLOCK_SIZE);
 			IntegerTools::LeIncrement(Counter, 16);
-			MemoryTools::Copy(Counter, 0, tmpc, 512, BLOCK_SIZE);
+			MemoryTools::Copy(Counter, 0, Buffer, 64, BLOCK_SIZE);
 			IntegerTools::LeIncrement(Counter, 16);
-			MemoryTools::Copy(Counter, 0, tmpc, 576, BLOCK_SIZE);
+			MemoryTools::Copy(Counter, 0, Buffer, 128, BLOCK_SIZE);
 			IntegerTools::LeIncrement(Counter, 16);
-			MemoryTools::Copy(Counter, 0, tmpc, 640, BLOCK_SIZE);
+			MemoryTools::Copy(Counter, 0, Buffer, 192, BLOCK_SIZE);
 			IntegerTools::LeIncrement(Counter, 16);
-			MemoryTools::Copy(Counter, 0, tmpc, 704, BLOCK_SIZE);
+			MemoryTools::Copy(Counter, 0, Buffer, 256, BLOCK_SIZE);
 			IntegerTools::LeIncrement(Counter, 16);
-			MemoryTools::Copy(Counter, 0, tmpc, 768, BLOCK_SIZE);
+			MemoryTools::Copy(Counter, 0, Buffer, 320, BLOCK_SIZE);
 			IntegerTools::LeIncrement(Counter, 16);
-			MemoryTools::Copy(Counter, 0, tmpc, 832, BLOCK_SIZE);
+			MemoryTools::Copy(Counter, 0, Buffer, 384, BLOCK_SIZE);
 			IntegerTools::LeIncrement(Counter, 16);
-			MemoryTools::Copy(Counter, 0, tmpc, 896, BLOCK_SIZE);
+			MemoryTools::Copy(Counter, 0, Buffer, 448, BLOCK_SIZE);
 			IntegerTools::LeIncrement(Counter, 16);
-			MemoryTools::Copy(Counter, 0, tmpc, 960, BLOCK_SIZE);
+			MemoryTools::Copy(Counter, 0, Buffer, 512, BLOCK_SIZE);
 			IntegerTools::LeIncrement(Counter, 16);
-			Transform8192(tmpc, 0, Output, OutOffset + bctr);
-			bctr += AVX512BLK;
-		}
-	}
-
-#elif defined(CEX_HAS_AVX2)
-
-	const size_t AVX2BLK = 8 * BLOCK_SIZE;
-
-	if (Length >= AVX2BLK)
-	{
-		const size_t PBKALN = Length - (Length % AVX2BLK);
-		std::vector<uint8_t> tmpc(AVX2BLK);
-
-		// stagger counters and process 8 blocks with avx2
-		while (bctr != PBKALN)
-		{
-			MemoryTools::Copy(Counter, 0, tmpc, 0, BLOCK_SIZE);
+			MemoryTools::Copy(Counter, 0, Buffer, 576, BLOCK_SIZE);
 			IntegerTools::LeIncrement(Counter, 16);
-			MemoryTools::Copy(Counter, 0, tmpc, 64, BLOCK_SIZE);
+			MemoryTools::Copy(Counter, 0, Buffer, 640, BLOCK_SIZE);
 			IntegerTools::LeIncrement(Counter, 16);
-			MemoryTools::Copy(Counter, 0, tmpc, 128, BLOCK_SIZE);
+			MemoryTools::Copy(Counter, 0, Buffer, 704, BLOCK_SIZE);
 			IntegerTools::LeIncrement(Counter, 16);
-			MemoryTools::Copy(Counter, 0, tmpc, 192, BLOCK_SIZE);
-			IntegerTools::LeIncrement(Counter, 16);
-			MemoryTools::Copy(Counter, 0, tmpc, 256, BLOCK_SIZE);
-			IntegerTools::LeIncrement(Counter, 16);
-			MemoryTools::Copy(Counter, 0, tmpc, 320, BLOCK_SIZE);
-			IntegerTools::LeIncrement(Counter, 16);
-			MemoryTools::Copy(Counter, 0, tmpc, 384, BLOCK_SIZE);
-			IntegerTools::LeIncrement(Counter, 16);
-			MemoryTools::Copy(Counter, 0, tmpc, 448, BLOCK_SIZE);
-			IntegerTools::LeIncrement(Counter, 16);
-			Transform4096(tmpc, 0, Output, OutOffset + bctr);
-			bctr += AVX2BLK;
-		}
-	}
-
-#elif defined(CEX_HAS_AVX)
-
-	const size_t AVXBLK = 4 * BLOCK_SIZE;
-
-	if (Length >= AVXBLK)
-	{
-		const size_t PBKALN = Length - (Length % AVXBLK);
-		std::vector<uint8_t> tmpc(AVXBLK);
-
-		// 4 blocks with avx
-		while (bctr != PBKALN)
-		{
-			MemoryTools::Copy(Counter, 0, tmpc, 0, BLOCK_SIZE);
+			MemoryTools::Copy(Counter, 0, Buffer, 768, BLOCK_SIZE);
 			IntegerTools::LeIncrement(Counter, 16);
-			MemoryTools::Copy(Counter, 0, tmpc, 64, BLOCK_SIZE);
+			MemoryTools::Copy(Counter, 0, Buffer, 832, BLOCK_SIZE);
 			IntegerTools::LeIncrement(Counter, 16);
-			MemoryTools::Copy(Counter, 0, tmpc, 128, BLOCK_SIZE);
+			MemoryTools::Copy(Counter, 0, Buffer, 896, BLOCK_SIZE);
 			IntegerTools::LeIncrement(Counter, 16);
-			MemoryTools::Copy(Counter, 0, tmpc, 192, BLOCK_SIZE);
+			MemoryTools::Copy(Counter, 0, Buffer, 960, BLOCK_SIZE);
 			IntegerTools::LeIncrement(Counter, 16);
-			Transform2048(tmpc, 0, Output, OutOffset + bctr);
-			bctr += AVXBLK;
+			Transform8192(Buffer, 0, Output, OutOffset + bctr);
+			bctr += WIDBLK;
 		}
 	}
 
-#endif
-
 	const size_t BLKALN = Length - (Length % BLOCK_SIZE);
 
 	while (bctr != BLKALN)
@@ -708,11 +809,10 @@ void RWS::Generate(std::vector<uint8_t> &Output, size_t OutOffset, size_t Length
 
 	if (bctr != Length)
 	{
-		std::vector<uint8_t> otp(BLOCK_SIZE);
-		Transform512(Counter, 0, otp, 0);
+		Transform512(Counter, 0, Buffer, 0);
 		IntegerTools::LeIncrement(Counter, 16);
 		const size_t RMDLEN = Length % BLOCK_SIZE;
-		MemoryTools::Copy(otp, 0, Output, OutOffset + (Length - RMDLEN), RMDLEN);
+		MemoryTools::Copy(Buffer, 0, Output, OutOffset + (Length - RMDLEN), RMDLEN);
 	}
 }
 
@@ -724,10 +824,11 @@ void RWS::PrefetchSbox()
 }
 CEX_OPTIMIZE_RESUME
 
-void RWS::Process(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length)
+void RWS::Process(const uint8_t* Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length)
 {
 	size_t i;
 
+	// a null input writes the bare key-stream, which the pointer transform combines with the callers memory
 	const size_t PRLBLK = m_parallelProfile.ParallelBlockSize();
 
 	if (m_parallelProfile.IsParallel() && Length >= PRLBLK)
@@ -753,37 +854,38 @@ void RWS::Process(const std::vector<uint8_t> &Input, size_t InOffset, std::vecto
 	}
 }
 
-void RWS::ProcessParallel(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length)
+void RWS::ProcessParallel(const uint8_t* Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length)
 {
 	const size_t OUTLEN = Output.size() - OutOffset < Length ? Output.size() - OutOffset : Length;
-	const size_t CNKLEN = m_parallelProfile.ParallelBlockSize() / m_parallelProfile.ParallelMaxDegree();
+	const size_t SEGCNT = m_parallelProfile.ParallelSegmentCount();
+	const size_t CNKLEN = m_parallelProfile.ParallelBlockSize() / SEGCNT;
 	const size_t CTRLEN = (CNKLEN / BLOCK_SIZE);
-	std::vector<uint8_t> tmpc(BLOCK_SIZE);
 
-	ParallelTools::ParallelFor(0, m_parallelProfile.ParallelMaxDegree(), [this, &Input, InOffset, &Output, OutOffset, &tmpc, CNKLEN, CTRLEN](size_t i)
+	// the per-worker counters are kept by the instance, and are allocated only on first use
+	m_rwsState->Scratch.Reserve(SEGCNT, BLOCK_SIZE, SCRATCH_SIZE);
+
+	ParallelTools::ParallelFor(m_parallelProfile, Output.data() + OutOffset, 0, SEGCNT, [this, Input, InOffset, &Output, OutOffset, CNKLEN, CTRLEN](size_t i)
 	{
 		// thread level counter
-		std::vector<uint8_t> thdc(BLOCK_SIZE);
+		std::vector<uint8_t> &thdc = m_rwsState->Scratch.Counter(i);
 		// offset counter by chunk size / block size  
 		IntegerTools::LeIncrease8(m_rwsState->Nonce, thdc, static_cast<uint32_t>(CTRLEN * i));
 		const size_t STMPOS = i * CNKLEN;
 		// generate random at output offset
-		this->Generate(Output, OutOffset + STMPOS, CNKLEN, thdc);
-		// xor with input at offsets
-		MemoryTools::XOR(Input, InOffset + STMPOS, Output, OutOffset + STMPOS, CNKLEN);
+		this->Generate(Output, OutOffset + STMPOS, CNKLEN, thdc, m_rwsState->Scratch.Buffer(i));
 
-		// store last counter
-		if (i == m_parallelProfile.ParallelMaxDegree() - 1)
+		// xor with input at offsets
+		if (Input != nullptr)
 		{
-			MemoryTools::Copy(thdc, 0, tmpc, 0, BLOCK_SIZE);
+			MemoryTools::XorRaw(Input + InOffset + STMPOS, Output.data() + OutOffset + STMPOS, CNKLEN);
 		}
 	});
 
 	// copy last counter to class variable
-	MemoryTools::Copy(tmpc, 0, m_rwsState->Nonce, 0, BLOCK_SIZE);
+	MemoryTools::Copy(m_rwsState->Scratch.Counter(SEGCNT - 1), 0, m_rwsState->Nonce, 0, BLOCK_SIZE);
 
 	// last block processing
-	const size_t ALNLEN = CNKLEN * m_parallelProfile.ParallelMaxDegree();
+	const size_t ALNLEN = CNKLEN * SEGCNT;
 
 	if (ALNLEN < OUTLEN)
 	{
@@ -791,36 +893,25 @@ void RWS::ProcessParallel(const std::vector<uint8_t> &Input, size_t InOffset, st
 		InOffset += ALNLEN;
 		OutOffset += ALNLEN;
 
-		Generate(Output, OutOffset, FNLLEN, m_rwsState->Nonce);
+		Generate(Output, OutOffset, FNLLEN, m_rwsState->Nonce, m_rwsState->Scratch.Buffer(0));
 
-		for (size_t i = 0; i < FNLLEN; ++i)
+		if (Input != nullptr)
 		{
-			Output[OutOffset + i] ^= Input[InOffset + i];
+			MemoryTools::XorRaw(Input + InOffset, Output.data() + OutOffset, FNLLEN);
 		}
 	}
 }
 
-void RWS::ProcessSequential(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length)
+void RWS::ProcessSequential(const uint8_t* Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length)
 {
-	// get block aligned
-	const size_t ALNLEN = Length - (Length % BLOCK_SIZE);
-	size_t i;
-
+	m_rwsState->Scratch.Reserve(1, BLOCK_SIZE, SCRATCH_SIZE);
 	// generate random
-	Generate(Output, OutOffset, Length, m_rwsState->Nonce);
+	Generate(Output, OutOffset, Length, m_rwsState->Nonce, m_rwsState->Scratch.Buffer(0));
 
-	if (ALNLEN != 0)
+	// output is input xor random
+	if (Input != nullptr && Length != 0)
 	{
-		MemoryTools::XOR(Input, InOffset, Output, OutOffset, ALNLEN);
-	}
-
-	// get the remaining bytes
-	if (ALNLEN != Length)
-	{
-		for (i = ALNLEN; i < Length; ++i)
-		{
-			Output[i + OutOffset] ^= Input[i + InOffset];
-		}
+		MemoryTools::XorRaw(Input + InOffset, Output.data() + OutOffset, Length);
 	}
 }
 
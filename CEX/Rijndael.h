@@ -21,10 +21,12 @@
 
 #include "CexDomain.h"
 #include "IntegerTools.h"
+#include "MemoryTools.h"
 
 NAMESPACE_RIJNDAELBASE
 
 using Tools::IntegerTools;
+using Tools::MemoryTools;
 
 //~~~Rijndael-based ciphers internal constants~~~//
 
@@ -401,9 +403,172 @@ static void Substitution(ArrayU8 &State)
 	}
 }
 
-// TODO: Not working, fix or remove
 template<typename ArrayU8>
-static void Substitution256(ArrayU8 &State)
+static uint32_t SubWord(uint32_t X, const ArrayU8 &Sbox)
+{
+	return (static_cast<uint32_t>(Sbox[X >> 24] << 24))
+		| (static_cast<uint32_t>(Sbox[(X >> 16) & 0xFF] << 16))
+		| (static_cast<uint32_t>(Sbox[(X >> 8) & 0xFF] << 8))
+		| static_cast<uint32_t>(Sbox[X & 0xFF]);
+}
+
+//~~~Rijndael Bitsliced Functions~~~//
+
+// The bitsliced functions are a table-free, constant-time software Rijndael,
+// used by the ciphers when the AES-NI instruction set is not available.
+// Four 128-bit blocks, or two 256-bit blocks, are held in eight 64-bit words; word k contains bit k of every state byte,
+// so the s-box is evaluated as a boolean circuit, and no memory access depends on the key or the data.
+// Bit (row * 16) + (column * 4) + slot of each word belongs to that row and column of the block in that slot;
+// a 256-bit block occupies two adjacent slots, columns 0-3 in the first and columns 4-7 in the second.
+// This is the layout used by the constant-time 64-bit implementation in BearSSL (T. Pornin).
+
+/// <summary>
+/// The number of bytes held in a bitsliced state
+/// </summary>
+static const size_t RJDBSL_STATE_SIZE = 64;
+
+/// <summary>
+/// The number of 64-bit words in a bitsliced round key
+/// </summary>
+static const size_t RJDBSL_ROUNDKEY_SIZE = 8;
+
+static void BitslicedSwap(uint64_t &X, uint64_t &Y, uint64_t MaskLow, uint64_t MaskHigh, size_t Shift)
+{
+	uint64_t a;
+	uint64_t b;
+
+	a = X;
+	b = Y;
+	X = (a & MaskLow) | ((b & MaskLow) << Shift);
+	Y = ((a & MaskHigh) >> Shift) | (b & MaskHigh);
+}
+
+static void BitslicedOrtho(std::array<uint64_t, 8> &Q)
+{
+	// transpose the state bits between the byte and bit-plane representations; the transform is an involution
+	BitslicedSwap(Q[0], Q[1], 0x5555555555555555ULL, 0xAAAAAAAAAAAAAAAAULL, 1);
+	BitslicedSwap(Q[2], Q[3], 0x5555555555555555ULL, 0xAAAAAAAAAAAAAAAAULL, 1);
+	BitslicedSwap(Q[4], Q[5], 0x5555555555555555ULL, 0xAAAAAAAAAAAAAAAAULL, 1);
+	BitslicedSwap(Q[6], Q[7], 0x5555555555555555ULL, 0xAAAAAAAAAAAAAAAAULL, 1);
+
+	BitslicedSwap(Q[0], Q[2], 0x3333333333333333ULL, 0xCCCCCCCCCCCCCCCCULL, 2);
+	BitslicedSwap(Q[1], Q[3], 0x3333333333333333ULL, 0xCCCCCCCCCCCCCCCCULL, 2);
+	BitslicedSwap(Q[4], Q[6], 0x3333333333333333ULL, 0xCCCCCCCCCCCCCCCCULL, 2);
+	BitslicedSwap(Q[5], Q[7], 0x3333333333333333ULL, 0xCCCCCCCCCCCCCCCCULL, 2);
+
+	BitslicedSwap(Q[0], Q[4], 0x0F0F0F0F0F0F0F0FULL, 0xF0F0F0F0F0F0F0F0ULL, 4);
+	BitslicedSwap(Q[1], Q[5], 0x0F0F0F0F0F0F0F0FULL, 0xF0F0F0F0F0F0F0F0ULL, 4);
+	BitslicedSwap(Q[2], Q[6], 0x0F0F0F0F0F0F0F0FULL, 0xF0F0F0F0F0F0F0F0ULL, 4);
+	BitslicedSwap(Q[3], Q[7], 0x0F0F0F0F0F0F0F0FULL, 0xF0F0F0F0F0F0F0F0ULL, 4);
+}
+
+static void BitslicedInterleaveIn(uint64_t &Q0, uint64_t &Q1, const std::array<uint32_t, 16> &W, size_t WOffset)
+{
+	uint64_t x0;
+	uint64_t x1;
+	uint64_t x2;
+	uint64_t x3;
+
+	x0 = W[WOffset];
+	x1 = W[WOffset + 1];
+	x2 = W[WOffset + 2];
+	x3 = W[WOffset + 3];
+	x0 |= (x0 << 16);
+	x1 |= (x1 << 16);
+	x2 |= (x2 << 16);
+	x3 |= (x3 << 16);
+	x0 &= 0x0000FFFF0000FFFFULL;
+	x1 &= 0x0000FFFF0000FFFFULL;
+	x2 &= 0x0000FFFF0000FFFFULL;
+	x3 &= 0x0000FFFF0000FFFFULL;
+	x0 |= (x0 << 8);
+	x1 |= (x1 << 8);
+	x2 |= (x2 << 8);
+	x3 |= (x3 << 8);
+	x0 &= 0x00FF00FF00FF00FFULL;
+	x1 &= 0x00FF00FF00FF00FFULL;
+	x2 &= 0x00FF00FF00FF00FFULL;
+	x3 &= 0x00FF00FF00FF00FFULL;
+	Q0 = x0 | (x2 << 8);
+	Q1 = x1 | (x3 << 8);
+}
+
+static void BitslicedInterleaveOut(std::array<uint32_t, 16> &W, size_t WOffset, uint64_t Q0, uint64_t Q1)
+{
+	uint64_t x0;
+	uint64_t x1;
+	uint64_t x2;
+	uint64_t x3;
+
+	x0 = Q0 & 0x00FF00FF00FF00FFULL;
+	x1 = Q1 & 0x00FF00FF00FF00FFULL;
+	x2 = (Q0 >> 8) & 0x00FF00FF00FF00FFULL;
+	x3 = (Q1 >> 8) & 0x00FF00FF00FF00FFULL;
+	x0 |= (x0 >> 8);
+	x1 |= (x1 >> 8);
+	x2 |= (x2 >> 8);
+	x3 |= (x3 >> 8);
+	x0 &= 0x0000FFFF0000FFFFULL;
+	x1 &= 0x0000FFFF0000FFFFULL;
+	x2 &= 0x0000FFFF0000FFFFULL;
+	x3 &= 0x0000FFFF0000FFFFULL;
+	W[WOffset] = static_cast<uint32_t>(x0) | static_cast<uint32_t>(x0 >> 16);
+	W[WOffset + 1] = static_cast<uint32_t>(x1) | static_cast<uint32_t>(x1 >> 16);
+	W[WOffset + 2] = static_cast<uint32_t>(x2) | static_cast<uint32_t>(x2 >> 16);
+	W[WOffset + 3] = static_cast<uint32_t>(x3) | static_cast<uint32_t>(x3 >> 16);
+}
+
+template<typename ArrayU8>
+static void BitslicedLoad(const ArrayU8 &Input, size_t InOffset, size_t Length, std::array<uint64_t, 8> &Q)
+{
+	std::array<uint8_t, RJDBSL_STATE_SIZE> tmpb = { 0 };
+	std::array<uint32_t, 16> tmpw;
+	size_t i;
+
+	// a partial state is zero padded
+	MemoryTools::Copy(Input, InOffset, tmpb, 0, Length);
+
+	for (i = 0; i < tmpw.size(); ++i)
+	{
+		tmpw[i] = IntegerTools::LeBytesTo32(tmpb, i * sizeof(uint32_t));
+	}
+
+	for (i = 0; i < 4; ++i)
+	{
+		BitslicedInterleaveIn(Q[i], Q[i + 4], tmpw, i * 4);
+	}
+
+	BitslicedOrtho(Q);
+	MemoryTools::Clear(tmpb, 0, tmpb.size());
+	MemoryTools::Clear(tmpw, 0, tmpw.size() * sizeof(uint32_t));
+}
+
+template<typename ArrayU8>
+static void BitslicedStore(std::array<uint64_t, 8> &Q, ArrayU8 &Output, size_t OutOffset, size_t Length)
+{
+	std::array<uint8_t, RJDBSL_STATE_SIZE> tmpb;
+	std::array<uint32_t, 16> tmpw;
+	size_t i;
+
+	BitslicedOrtho(Q);
+
+	for (i = 0; i < 4; ++i)
+	{
+		BitslicedInterleaveOut(tmpw, i * 4, Q[i], Q[i + 4]);
+	}
+
+	for (i = 0; i < tmpw.size(); ++i)
+	{
+		IntegerTools::Le32ToBytes(tmpw[i], tmpb, i * sizeof(uint32_t));
+	}
+
+	MemoryTools::Copy(tmpb, 0, Output, OutOffset, Length);
+	MemoryTools::Clear(tmpb, 0, tmpb.size());
+	MemoryTools::Clear(tmpw, 0, tmpw.size() * sizeof(uint32_t));
+	MemoryTools::Clear(Q, 0, Q.size() * sizeof(uint64_t));
+}
+
+static void BitslicedSbox(std::array<uint64_t, 8> &Q)
 {
 	// This S-box implementation is a straightforward translation of
 	// the circuit described by Boyar and Peralta in "A new
@@ -412,138 +577,138 @@ static void Substitution256(ArrayU8 &State)
 	// Note that variables x* (input) and s* (output) are numbered
 	// in "reverse" order (x0 is the high bit, x7 is the low bit).
 
-	uint32_t x0; 
-	uint32_t x1; 
-	uint32_t x2; 
-	uint32_t x3; 
-	uint32_t x4; 
-	uint32_t x5; 
-	uint32_t x6; 
-	uint32_t x7;
-	uint32_t y1; 
-	uint32_t y2; 
-	uint32_t y3; 
-	uint32_t y4; 
-	uint32_t y5; 
-	uint32_t y6; 
-	uint32_t y7; 
-	uint32_t y8; 
-	uint32_t y9;
-	uint32_t y10; 
-	uint32_t y11; 
-	uint32_t y12; 
-	uint32_t y13; 
-	uint32_t y14; 
-	uint32_t y15; 
-	uint32_t y16; 
-	uint32_t y17; 
-	uint32_t y18; 
-	uint32_t y19;
-	uint32_t y20; 
-	uint32_t y21;
-	uint32_t z0; 
-	uint32_t z1; 
-	uint32_t z2; 
-	uint32_t z3; 
-	uint32_t z4; 
-	uint32_t z5;
-	uint32_t z6; 
-	uint32_t z7; 
-	uint32_t z8;
-	uint32_t z9;
-	uint32_t z10; 
-	uint32_t z11; 
-	uint32_t z12; 
-	uint32_t z13; 
-	uint32_t z14; 
-	uint32_t z15; 
-	uint32_t z16;
-	uint32_t z17;
-	uint32_t t0; 
-	uint32_t t1; 
-	uint32_t t2; 
-	uint32_t t3; 
-	uint32_t t4; 
-	uint32_t t5; 
-	uint32_t t6; 
-	uint32_t t7; 
-	uint32_t t8; 
-	uint32_t t9;
-	uint32_t t10; 
-	uint32_t t11; 
-	uint32_t t12; 
-	uint32_t t13; 
-	uint32_t t14; 
-	uint32_t t15;
-	uint32_t t16; 
-	uint32_t t17; 
-	uint32_t t18; 
-	uint32_t t19;
-	uint32_t t20; 
-	uint32_t t21;
-	uint32_t t22;
-	uint32_t t23; 
-	uint32_t t24;
-	uint32_t t25; 
-	uint32_t t26; 
-	uint32_t t27; 
-	uint32_t t28; 
-	uint32_t t29;
-	uint32_t t30; 
-	uint32_t t31; 
-	uint32_t t32;
-	uint32_t t33; 
-	uint32_t t34;
-	uint32_t t35; 
-	uint32_t t36;
-	uint32_t t37; 
-	uint32_t t38; 
-	uint32_t t39;
-	uint32_t t40; 
-	uint32_t t41; 
-	uint32_t t42; 
-	uint32_t t43;
-	uint32_t t44;
-	uint32_t t45; 
-	uint32_t t46; 
-	uint32_t t47; 
-	uint32_t t48; 
-	uint32_t t49;
-	uint32_t t50; 
-	uint32_t t51;
-	uint32_t t52; 
-	uint32_t t53;
-	uint32_t t54; 
-	uint32_t t55;
-	uint32_t t56;
-	uint32_t t57;
-	uint32_t t58;
-	uint32_t t59;
-	uint32_t t60;
-	uint32_t t61;
-	uint32_t t62; 
-	uint32_t t63;
-	uint32_t t64;
-	uint32_t t65; 
-	uint32_t t66;
-	uint32_t t67;
-	uint32_t s0; 
-	uint32_t s1;
-	uint32_t s2; 
-	uint32_t s3; 
-	uint32_t s4; 
-	uint32_t s5; 
-	uint32_t s6;
-	uint32_t s7;
-
-	x7 = IntegerTools::BeBytesTo32(State, 0);
-	x6 = IntegerTools::BeBytesTo32(State, 4);
-	x5 = IntegerTools::BeBytesTo32(State, 8);
-	x4 = IntegerTools::BeBytesTo32(State, 12);
-	x3 = IntegerTools::BeBytesTo32(State, 16);
-	x2 = IntegerTools::BeBytesTo32(State, 20);
-	x1 = IntegerTools::BeBytesTo32(State, 24);
-	x0 = IntegerTools::BeBytesTo32(State, 28);
+	uint64_t x0;
+	uint64_t x1;
+	uint64_t x2;
+	uint64_t x3;
+	uint64_t x4;
+	uint64_t x5;
+	uint64_t x6;
+	uint64_t x7;
+	uint64_t y1;
+	uint64_t y2;
+	uint64_t y3;
+	uint64_t y4;
+	uint64_t y5;
+	uint64_t y6;
+	uint64_t y7;
+	uint64_t y8;
+	uint64_t y9;
+	uint64_t y10;
+	uint64_t y11;
+	uint64_t y12;
+	uint64_t y13;
+	uint64_t y14;
+	uint64_t y15;
+	uint64_t y16;
+	uint64_t y17;
+	uint64_t y18;
+	uint64_t y19;
+	uint64_t y20;
+	uint64_t y21;
+	uint64_t z0;
+	uint64_t z1;
+	uint64_t z2;
+	uint64_t z3;
+	uint64_t z4;
+	uint64_t z5;
+	uint64_t z6;
+	uint64_t z7;
+	uint64_t z8;
+	uint64_t z9;
+	uint64_t z10;
+	uint64_t z11;
+	uint64_t z12;
+	uint64_t z13;
+	uint64_t z14;
+	uint64_t z15;
+	uint64_t z16;
+	uint64_t z17;
+	uint64_t t0;
+	uint64_t t1;
+	uint64_t t2;
+	uint64_t t3;
+	uint64_t t4;
+	uint64_t t5;
+	uint64_t t6;
+	uint64_t t7;
+	uint64_t t8;
+	uint64_t t9;
+	uint64_t t10;
+	uint64_t t11;
+	uint64_t t12;
+	uint64_t t13;
+	uint64_t t14;
+	uint64_t t15;
+	uint64_t t16;
+	uint64_t t17;
+	uint64_t t18;
+	uint64_t t19;
+	uint64_t t20;
+	uint64_t t21;
+	uint64_t t22;
+	uint64_t t23;
+	uint64_t t24;
+	uint64_t t25;
+	uint64_t t26;
+	uint64_t t27;
+	uint64_t t28;
+	uint64_t t29;
+	uint64_t t30;
+	uint64_t t31;
+	uint64_t t32;
+	uint64_t t33;
+	uint64_t t34;
+	uint64_t t35;
+	uint64_t t36;
+	uint64_t t37;
+	uint64_t t38;
+	uint64_t t39;
+	uint64_t t40;
+	uint64_t t41;
+	uint64_t t42;
+	uint64_t t43;
+	uint64_t t44;
+	uint64_t t45;
+	uint64_t t46;
+	uint64_t t47;
+	uint64_t t48;
+	uint64_t t49;
+	uint64_t t50;
+	uint64_t t51;
+	uint64_t t52;
+	uint64_t t53;
+	uint64_t t54;
+	uint64_t t55;
+	uint64_t t56;
+	uint64_t t57;
+	uint64_t t58;
+	uint64_t t59;
+	uint64_t t60;
+	uint64_t t61;
+	uint64_t t62;
+	uint64_t t63;
+	uint64_t t64;
+	uint64_t t65;
+	uint64_t t66;
+	uint64_t t67;
+	uint64_t s0;
+	uint64_t s1;
+	uint64_t s2;
+	uint64_t s3;
+	uint64_t s4;
+	uint64_t s5;
+	uint64_t s6;
+	uint64_t s7;
+
+	x7 = Q[0];
+	x6 = Q[1];
+	x5 = Q[2];
+	x4 = Q[3];
+	x3 = Q[4];
+	x2 = Q[5];
+	x1 = Q[6];
+	x0 = Q[7];
 
 	// top linear transformation.
 	y14 = x3 ^ x5;
@@ -664,25 +829,347 @@ static void Substitution256(ArrayU8 &State)
 	s1 = t64 ^ ~s3;
 	s2 = t55 ^ ~t67;
 
-	IntegerTools::Be32ToBytes(s7, State, 0);
-	IntegerTools::Be32ToBytes(s6, State, 4);
-	IntegerTools::Be32ToBytes(s5, State, 8);
-	IntegerTools::Be32ToBytes(s4, State, 12);
-	IntegerTools::Be32ToBytes(s3, State, 16);
-	IntegerTools::Be32ToBytes(s2, State, 20);
-	IntegerTools::Be32ToBytes(s1, State, 24);
-	IntegerTools::Be32ToBytes(s0, State, 28);
+	Q[0] = s7;
+	Q[1] = s6;
+	Q[2] = s5;
+	Q[3] = s4;
+	Q[4] = s3;
+	Q[5] = s2;
+	Q[6] = s1;
+	Q[7] = s0;
 }
 
-template<typename ArrayU8>
-static uint32_t SubWord(uint32_t X, const ArrayU8 &Sbox)
+
+static void BitslicedInvSbox(std::array<uint64_t, 8> &Q)
 {
-	return (static_cast<uint32_t>(Sbox[X >> 24] << 24))
-		| (static_cast<uint32_t>(Sbox[(X >> 16) & 0xFF] << 16))
-		| (static_cast<uint32_t>(Sbox[(X >> 8) & 0xFF] << 8))
-		| static_cast<uint32_t>(Sbox[X & 0xFF]);
+	// the inverse s-box is the forward circuit wrapped in the inverse of its affine transform
+	uint64_t q0;
+	uint64_t q1;
+	uint64_t q2;
+	uint64_t q3;
+	uint64_t q4;
+	uint64_t q5;
+	uint64_t q6;
+	uint64_t q7;
+
+	q0 = ~Q[0];
+	q1 = ~Q[1];
+	q2 = Q[2];
+	q3 = Q[3];
+	q4 = Q[4];
+	q5 = ~Q[5];
+	q6 = ~Q[6];
+	q7 = Q[7];
+	Q[7] = q1 ^ q4 ^ q6;
+	Q[6] = q0 ^ q3 ^ q5;
+	Q[5] = q7 ^ q2 ^ q4;
+	Q[4] = q6 ^ q1 ^ q3;
+	Q[3] = q5 ^ q0 ^ q2;
+	Q[2] = q4 ^ q7 ^ q1;
+	Q[1] = q3 ^ q6 ^ q0;
+	Q[0] = q2 ^ q5 ^ q7;
+
+	BitslicedSbox(Q);
+
+	q0 = ~Q[0];
+	q1 = ~Q[1];
+	q2 = Q[2];
+	q3 = Q[3];
+	q4 = Q[4];
+	q5 = ~Q[5];
+	q6 = ~Q[6];
+	q7 = Q[7];
+	Q[7] = q1 ^ q4 ^ q6;
+	Q[6] = q0 ^ q3 ^ q5;
+	Q[5] = q7 ^ q2 ^ q4;
+	Q[4] = q6 ^ q1 ^ q3;
+	Q[3] = q5 ^ q0 ^ q2;
+	Q[2] = q4 ^ q7 ^ q1;
+	Q[1] = q3 ^ q6 ^ q0;
+	Q[0] = q2 ^ q5 ^ q7;
+}
+
+static void BitslicedInvShiftRows128(std::array<uint64_t, 8> &Q)
+{
+	size_t i;
+	uint64_t x;
+
+	for (i = 0; i < Q.size(); ++i)
+	{
+		x = Q[i];
+		Q[i] = (x & 0x000000000000FFFFULL)
+			| ((x & 0x000000000FFF0000ULL) << 4)
+			| ((x & 0x00000000F0000000ULL) >> 12)
+			| ((x & 0x000000FF00000000ULL) << 8)
+			| ((x & 0x0000FF0000000000ULL) >> 8)
+			| ((x & 0x000F000000000000ULL) << 12)
+			| ((x & 0xFFF0000000000000ULL) >> 4);
+	}
+}
+
+static void BitslicedShiftRows128(std::array<uint64_t, 8> &Q)
+{
+	size_t i;
+	uint64_t x;
+
+	for (i = 0; i < Q.size(); ++i)
+	{
+		x = Q[i];
+		Q[i] = (x & 0x000000000000FFFFULL)
+			| ((x & 0x00000000FFF00000ULL) >> 4)
+			| ((x & 0x00000000000F0000ULL) << 12)
+			| ((x & 0x0000FF0000000000ULL) >> 8)
+			| ((x & 0x000000FF00000000ULL) << 8)
+			| ((x & 0xF000000000000000ULL) >> 12)
+			| ((x & 0x0FFF000000000000ULL) << 4);
+	}
+}
+
+static void BitslicedShiftRows256(std::array<uint64_t, 8> &Q)
+{
+	// rows 1, 2 and 3 of the 8 column state rotate by 1, 3 and 4 columns;
+	// the row is first rotated within each half, then the halves are exchanged where the rotation crosses them
+	size_t i;
+	uint64_t w;
+	uint64_t x;
+	uint64_t y;
+	uint64_t z;
+
+	for (i = 0; i < Q.size(); ++i)
+	{
+		x = Q[i];
+		y = ((x & 0x00000000FFF00000ULL) >> 4)
+			| ((x & 0x00000000000F0000ULL) << 12)
+			| ((x & 0x00000FFF00000000ULL) << 4)
+			| ((x & 0x0000F00000000000ULL) >> 12);
+		z = y | (x & 0xFFFF000000000000ULL);
+		w = ((z & 0x5555555555555555ULL) << 1) | ((z >> 1) & 0x5555555555555555ULL);
+		Q[i] = (x & 0x000000000000FFFFULL)
+			| (z & 0x0000000F0FFF0000ULL)
+			| (w & 0xFFFFFFF0F0000000ULL);
+	}
+}
+
+static void BitslicedInvMixColumns(std::array<uint64_t, 8> &Q)
+{
+	uint64_t q0;
+	uint64_t q1;
+	uint64_t q2;
+	uint64_t q3;
+	uint64_t q4;
+	uint64_t q5;
+	uint64_t q6;
+	uint64_t q7;
+	uint64_t r0;
+	uint64_t r1;
+	uint64_t r2;
+	uint64_t r3;
+	uint64_t r4;
+	uint64_t r5;
+	uint64_t r6;
+	uint64_t r7;
+
+	q0 = Q[0];
+	q1 = Q[1];
+	q2 = Q[2];
+	q3 = Q[3];
+	q4 = Q[4];
+	q5 = Q[5];
+	q6 = Q[6];
+	q7 = Q[7];
+	r0 = (q0 >> 16) | (q0 << 48);
+	r1 = (q1 >> 16) | (q1 << 48);
+	r2 = (q2 >> 16) | (q2 << 48);
+	r3 = (q3 >> 16) | (q3 << 48);
+	r4 = (q4 >> 16) | (q4 << 48);
+	r5 = (q5 >> 16) | (q5 << 48);
+	r6 = (q6 >> 16) | (q6 << 48);
+	r7 = (q7 >> 16) | (q7 << 48);
+
+	Q[0] = q5 ^ q6 ^ q7 ^ r0 ^ r5 ^ r7 ^ IntegerTools::RotFL64(q0 ^ q5 ^ q6 ^ r0 ^ r5, 32);
+	Q[1] = q0 ^ q5 ^ r0 ^ r1 ^ r5 ^ r6 ^ r7 ^ IntegerTools::RotFL64(q1 ^ q5 ^ q7 ^ r1 ^ r5 ^ r6, 32);
+	Q[2] = q0 ^ q1 ^ q6 ^ r1 ^ r2 ^ r6 ^ r7 ^ IntegerTools::RotFL64(q0 ^ q2 ^ q6 ^ r2 ^ r6 ^ r7, 32);
+	Q[3] = q0 ^ q1 ^ q2 ^ q5 ^ q6 ^ r0 ^ r2 ^ r3 ^ r5 ^ IntegerTools::RotFL64(q0 ^ q1 ^ q3 ^ q5 ^ q6 ^ q7 ^ r0 ^ r3 ^ r5 ^ r7, 32);
+	Q[4] = q1 ^ q2 ^ q3 ^ q5 ^ r1 ^ r3 ^ r4 ^ r5 ^ r6 ^ r7 ^ IntegerTools::RotFL64(q1 ^ q2 ^ q4 ^ q5 ^ q7 ^ r1 ^ r4 ^ r5 ^ r6, 32);
+	Q[5] = q2 ^ q3 ^ q4 ^ q6 ^ r2 ^ r4 ^ r5 ^ r6 ^ r7 ^ IntegerTools::RotFL64(q2 ^ q3 ^ q5 ^ q6 ^ r2 ^ r5 ^ r6 ^ r7, 32);
+	Q[6] = q3 ^ q4 ^ q5 ^ q7 ^ r3 ^ r5 ^ r6 ^ r7 ^ IntegerTools::RotFL64(q3 ^ q4 ^ q6 ^ q7 ^ r3 ^ r6 ^ r7, 32);
+	Q[7] = q4 ^ q5 ^ q6 ^ r4 ^ r6 ^ r7 ^ IntegerTools::RotFL64(q4 ^ q5 ^ q7 ^ r4 ^ r7, 32);
+}
+
+static void BitslicedMixColumns(std::array<uint64_t, 8> &Q)
+{
+	uint64_t q0;
+	uint64_t q1;
+	uint64_t q2;
+	uint64_t q3;
+	uint64_t q4;
+	uint64_t q5;
+	uint64_t q6;
+	uint64_t q7;
+	uint64_t r0;
+	uint64_t r1;
+	uint64_t r2;
+	uint64_t r3;
+	uint64_t r4;
+	uint64_t r5;
+	uint64_t r6;
+	uint64_t r7;
+
+	// each column is multiplied by {02}x^3 + {01}x^2 + {01}x + {03};
+	// the rows are 16 bits apart, so a 16-bit rotation aligns the next row of every column
+	q0 = Q[0];
+	q1 = Q[1];
+	q2 = Q[2];
+	q3 = Q[3];
+	q4 = Q[4];
+	q5 = Q[5];
+	q6 = Q[6];
+	q7 = Q[7];
+	r0 = (q0 >> 16) | (q0 << 48);
+	r1 = (q1 >> 16) | (q1 << 48);
+	r2 = (q2 >> 16) | (q2 << 48);
+	r3 = (q3 >> 16) | (q3 << 48);
+	r4 = (q4 >> 16) | (q4 << 48);
+	r5 = (q5 >> 16) | (q5 << 48);
+	r6 = (q6 >> 16) | (q6 << 48);
+	r7 = (q7 >> 16) | (q7 << 48);
+
+	Q[0] = q7 ^ r7 ^ r0 ^ IntegerTools::RotFL64(q0 ^ r0, 32);
+	Q[1] = q0 ^ r0 ^ q7 ^ r7 ^ r1 ^ IntegerTools::RotFL64(q1 ^ r1, 32);
+	Q[2] = q1 ^ r1 ^ r2 ^ IntegerTools::RotFL64(q2 ^ r2, 32);
+	Q[3] = q2 ^ r2 ^ q7 ^ r7 ^ r3 ^ IntegerTools::RotFL64(q3 ^ r3, 32);
+	Q[4] = q3 ^ r3 ^ q7 ^ r7 ^ r4 ^ IntegerTools::RotFL64(q4 ^ r4, 32);
+	Q[5] = q4 ^ r4 ^ r5 ^ IntegerTools::RotFL64(q5 ^ r5, 32);
+	Q[6] = q5 ^ r5 ^ r6 ^ IntegerTools::RotFL64(q6 ^ r6, 32);
+	Q[7] = q6 ^ r6 ^ r7 ^ IntegerTools::RotFL64(q7 ^ r7, 32);
+}
+
+template<typename ArrayU64>
+static void BitslicedKeyAddition(std::array<uint64_t, 8> &Q, const ArrayU64 &Rkeys, size_t RkOffset)
+{
+	size_t i;
+
+	for (i = 0; i < Q.size(); ++i)
+	{
+		Q[i] ^= Rkeys[RkOffset + i];
+	}
+}
+
+template<typename ArrayU32, typename ArrayU64>
+static void BitslicedExpand(const ArrayU32 &RoundKeys, size_t BlockSize, ArrayU64 &SlicedKeys)
+{
+	// each round key is copied into every block slot and transposed, so a round key addition is eight word XORs
+	const size_t RKWLEN = BlockSize / sizeof(uint32_t);
+	const size_t RNDCNT = RoundKeys.size() / RKWLEN;
+	std::array<uint8_t, RJDBSL_STATE_SIZE> tmpk;
+	std::array<uint64_t, 8> q;
+	size_t i;
+	size_t j;
+
+	SlicedKeys.resize(RNDCNT * RJDBSL_ROUNDKEY_SIZE);
+
+	for (i = 0; i < RNDCNT; ++i)
+	{
+		for (j = 0; j < RJDBSL_STATE_SIZE / sizeof(uint32_t); ++j)
+		{
+			IntegerTools::Be32ToBytes(RoundKeys[(i * RKWLEN) + (j % RKWLEN)], tmpk, j * sizeof(uint32_t));
+		}
+
+		BitslicedLoad(tmpk, 0, tmpk.size(), q);
+
+		for (j = 0; j < q.size(); ++j)
+		{
+			SlicedKeys[(i * RJDBSL_ROUNDKEY_SIZE) + j] = q[j];
+		}
+	}
+
+	MemoryTools::Clear(tmpk, 0, tmpk.size());
+	MemoryTools::Clear(q, 0, q.size() * sizeof(uint64_t));
+}
+
+static uint32_t BitslicedSubWord(uint32_t X)
+{
+	std::array<uint64_t, 8> q = { 0 };
+	uint32_t y;
+
+	q[0] = X;
+	BitslicedOrtho(q);
+	BitslicedSbox(q);
+	BitslicedOrtho(q);
+	y = static_cast<uint32_t>(q[0]);
+	MemoryTools::Clear(q, 0, q.size() * sizeof(uint64_t));
+
+	return y;
+}
+
+template<typename ArrayU8A, typename ArrayU8B, typename ArrayU64>
+static void BitslicedDecrypt128(const ArrayU64 &SlicedKeys, size_t Rounds, const ArrayU8A &Input, size_t InOffset, ArrayU8B &Output, size_t OutOffset, size_t Length)
+{
+	std::array<uint64_t, 8> q;
+	size_t i;
+
+	BitslicedLoad(Input, InOffset, Length, q);
+	BitslicedKeyAddition(q, SlicedKeys, Rounds * RJDBSL_ROUNDKEY_SIZE);
+
+	for (i = Rounds - 1; i > 0; --i)
+	{
+		BitslicedInvShiftRows128(q);
+		BitslicedInvSbox(q);
+		BitslicedKeyAddition(q, SlicedKeys, i * RJDBSL_ROUNDKEY_SIZE);
+		BitslicedInvMixColumns(q);
+	}
+
+	BitslicedInvShiftRows128(q);
+	BitslicedInvSbox(q);
+	BitslicedKeyAddition(q, SlicedKeys, 0);
+	BitslicedStore(q, Output, OutOffset, Length);
 }
 
+template<typename ArrayU8A, typename ArrayU8B, typename ArrayU64>
+static void BitslicedEncrypt128(const ArrayU64 &SlicedKeys, size_t Rounds, const ArrayU8A &Input, size_t InOffset, ArrayU8B &Output, size_t OutOffset, size_t Length)
+{
+	std::array<uint64_t, 8> q;
+	size_t i;
+
+	BitslicedLoad(Input, InOffset, Length, q);
+	BitslicedKeyAddition(q, SlicedKeys, 0);
+
+	for (i = 1; i < Rounds; ++i)
+	{
+		BitslicedSbox(q);
+		BitslicedShiftRows128(q);
+		BitslicedMixColumns(q);
+		BitslicedKeyAddition(q, SlicedKeys, i * RJDBSL_ROUNDKEY_SIZE);
+	}
+
+	BitslicedSbox(q);
+	BitslicedShiftRows128(q);
+	BitslicedKeyAddition(q, SlicedKeys, Rounds * RJDBSL_ROUNDKEY_SIZE);
+	BitslicedStore(q, Output, OutOffset, Length);
+}
+
+template<typename ArrayU8A, typename ArrayU8B, typename ArrayU64>
+static void BitslicedEncrypt256(const ArrayU64 &SlicedKeys, size_t Rounds, const ArrayU8A &Input, size_t InOffset, ArrayU8B &Output, size_t OutOffset, size_t Length)
+{
+	std::array<uint64_t, 8> q;
+	size_t i;
+
+	BitslicedLoad(Input, InOffset, Length, q);
+	BitslicedKeyAddition(q, SlicedKeys, 0);
+
+	for (i = 1; i < Rounds; ++i)
+	{
+		BitslicedSbox(q);
+		BitslicedShiftRows256(q);
+		BitslicedMixColumns(q);
+		BitslicedKeyAddition(q, SlicedKeys, i * RJDBSL_ROUNDKEY_SIZE);
+	}
+
+	BitslicedSbox(q);
+	BitslicedShiftRows256(q);
+	BitslicedKeyAddition(q, SlicedKeys, Rounds * RJDBSL_ROUNDKEY_SIZE);
+	BitslicedStore(q, Output, OutOffset, Length);
+}
 
 NAMESPACE_RIJNDAELBASEEND
 #endif
@@ -0,0 +1,75 @@
+#ifndef CEX_RIJNDAELKERNELS_H
+#define CEX_RIJNDAELKERNELS_H
+
+#include "CexDomain.h"
+#include "SimdProfiles.h"
+
+NAMESPACE_BLOCK
+
+using Enumeration::SimdProfiles;
+
+/// cond private
+
+/// <summary>
+/// Internal class: the wide Rijndael round functions, using the VAES instructions that process a 128-bit block in each lane of a 256 or 512-bit register.
+/// <para>RijndaelVaes256.cpp and RijndaelVaes512.cpp are compiled with the AVX2 and AVX512 code generation flags respectively, and the VAES extension. 
+/// The units are self-contained: the round functions have internal linkage, and the units include no shared header with instruction set branches. 
+/// Each function transforms 8 or 16 consecutive blocks with the AES-NI round key schedule, passed as a pointer to KeyCount 16 byte round keys; 
+/// the round keys are broadcast to every lane, so the blocks of all registers are in flight through each round. 
+/// A unit compiled without its instruction set reports the variant as absent, and its functions throw if called. 
+/// VAES is a separate cpuid feature, so RHX checks the processor flag before it selects a variant with SimdDispatch::Select(Compiled(), SimdKernels::Rijndael, Length).</para>
+/// </summary>
+class RijndaelKernels final
+{
+public:
+
+	/// <summary>
+	/// The widest kernel variant compiled into the library
+	/// </summary>
+	static SimdProfiles Compiled();
+
+	/// <summary>
+	/// The VAES-256 kernels were compiled
+	/// </summary>
+	static bool HasVaes256();
+
+	/// <summary>
+	/// The VAES-512 kernels were compiled
+	/// </summary>
+	static bool HasVaes512();
+
+	/// <summary>
+	/// Decrypt 8 blocks using VAES-256 instructions
+	/// </summary>
+	static void Decrypt8x256H(const uint8_t* RoundKeys, size_t KeyCount, const uint8_t* Input, uint8_t* Output);
+
+	/// <summary>
+	/// Decrypt 16 blocks using VAES-256 instructions
+	/// </summary>
+	static void Decrypt16x256H(const uint8_t* RoundKeys, size_t KeyCount, const uint8_t* Input, uint8_t* Output);
+
+	/// <summary>
+	/// Decrypt 16 blocks using VAES-512 instructions
+	/// </summary>
+	static void Decrypt16x512H(const uint8_t* RoundKeys, size_t KeyCount, const uint8_t* Input, uint8_t* Output);
+
+	/// <summary>
+	/// Encrypt 8 blocks using VAES-256 instructions
+	/// </summary>
+	static void Encrypt8x256H(const uint8_t* RoundKeys, size_t KeyCount, const uint8_t* Input, uint8_t* Output);
+
+	/// <summary>
+	/// Encrypt 16 blocks using VAES-256 instructions
+	/// </summary>
+	static void Encrypt16x256H(const uint8_t* RoundKeys, size_t KeyCount, const uint8_t* Input, uint8_t* Output);
+
+	/// <summary>
+	/// Encrypt 16 blocks using VAES-512 instructions
+	/// </summary>
+	static void Encrypt16x512H(const uint8_t* RoundKeys, size_t KeyCount, const uint8_t* Input, uint8_t* Output);
+};
+
+/// endcond
+
+NAMESPACE_BLOCKEND
+#endif
@@ -0,0 +1,237 @@
+#include "RijndaelKernels.h"
+#if defined(CEX_HAS_AVX2) && defined(CEX_HAS_VAES)
+#	include "Intrinsics.h"
+#else
+#	include "CryptoSymmetricException.h"
+#endif
+
+NAMESPACE_BLOCK
+
+// this unit is compiled with the AVX2 and VAES code generation flags; it includes no shared header with instruction set branches,
+// and the round functions have internal linkage, so no inline code compiled here can be linked into another unit
+
+#if defined(CEX_HAS_AVX2) && defined(CEX_HAS_VAES)
+namespace
+{
+	// decrypt 8 blocks, two blocks in each register
+	void Decrypt8x256(const uint8_t* RoundKeys, size_t KeyCount, const uint8_t* Input, uint8_t* Output)
+	{
+		const size_t RNDCNT = KeyCount - 1;
+		__m256i k;
+		__m256i x0;
+		__m256i x1;
+		__m256i x2;
+		__m256i x3;
+		size_t i;
+
+		k = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(RoundKeys)));
+		x0 = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(Input)), k);
+		x1 = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(Input + 32)), k);
+		x2 = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(Input + 64)), k);
+		x3 = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(Input + 96)), k);
+
+		for (i = 1; i != RNDCNT; ++i)
+		{
+			k = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(RoundKeys + (i * 16))));
+			x0 = _mm256_aesdec_epi128(x0, k);
+			x1 = _mm256_aesdec_epi128(x1, k);
+			x2 = _mm256_aesdec_epi128(x2, k);
+			x3 = _mm256_aesdec_epi128(x3, k);
+		}
+
+		k = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(RoundKeys + (RNDCNT * 16))));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(Output), _mm256_aesdeclast_epi128(x0, k));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(Output + 32), _mm256_aesdeclast_epi128(x1, k));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(Output + 64), _mm256_aesdeclast_epi128(x2, k));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(Output + 96), _mm256_aesdeclast_epi128(x3, k));
+	}
+
+	// decrypt 16 blocks, two blocks in each register
+	void Decrypt16x256(const uint8_t* RoundKeys, size_t KeyCount, const uint8_t* Input, uint8_t* Output)
+	{
+		const size_t RNDCNT = KeyCount - 1;
+		__m256i k;
+		__m256i x0;
+		__m256i x1;
+		__m256i x2;
+		__m256i x3;
+		__m256i x4;
+		__m256i x5;
+		__m256i x6;
+		__m256i x7;
+		size_t i;
+
+		k = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(RoundKeys)));
+		x0 = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(Input)), k);
+		x1 = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(Input + 32)), k);
+		x2 = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(Input + 64)), k);
+		x3 = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(Input + 96)), k);
+		x4 = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(Input + 128)), k);
+		x5 = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(Input + 160)), k);
+		x6 = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(Input + 192)), k);
+		x7 = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(Input + 224)), k);
+
+		for (i = 1; i != RNDCNT; ++i)
+		{
+			k = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(RoundKeys + (i * 16))));
+			x0 = _mm256_aesdec_epi128(x0, k);
+			x1 = _mm256_aesdec_epi128(x1, k);
+			x2 = _mm256_aesdec_epi128(x2, k);
+			x3 = _mm256_aesdec_epi128(x3, k);
+			x4 = _mm256_aesdec_epi128(x4, k);
+			x5 = _mm256_aesdec_epi128(x5, k);
+			x6 = _mm256_aesdec_epi128(x6, k);
+			x7 = _mm256_aesdec_epi128(x7, k);
+		}
+
+		k = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(RoundKeys + (RNDCNT * 16))));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(Output), _mm256_aesdeclast_epi128(x0, k));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(Output + 32), _mm256_aesdeclast_epi128(x1, k));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(Output + 64), _mm256_aesdeclast_epi128(x2, k));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(Output + 96), _mm256_aesdeclast_epi128(x3, k));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(Output + 128), _mm256_aesdeclast_epi128(x4, k));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(Output + 160), _mm256_aesdeclast_epi128(x5, k));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(Output + 192), _mm256_aesdeclast_epi128(x6, k));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(Output + 224), _mm256_aesdeclast_epi128(x7, k));
+	}
+
+	// encrypt 8 blocks, two blocks in each register
+	void Encrypt8x256(const uint8_t* RoundKeys, size_t KeyCount, const uint8_t* Input, uint8_t* Output)
+	{
+		const size_t RNDCNT = KeyCount - 1;
+		__m256i k;
+		__m256i x0;
+		__m256i x1;
+		__m256i x2;
+		__m256i x3;
+		size_t i;
+
+		k = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(RoundKeys)));
+		x0 = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(Input)), k);
+		x1 = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(Input + 32)), k);
+		x2 = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(Input + 64)), k);
+		x3 = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(Input + 96)), k);
+
+		for (i = 1; i != RNDCNT; ++i)
+		{
+			k = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(RoundKeys + (i * 16))));
+			x0 = _mm256_aesenc_epi128(x0, k);
+			x1 = _mm256_aesenc_epi128(x1, k);
+			x2 = _mm256_aesenc_epi128(x2, k);
+			x3 = _mm256_aesenc_epi128(x3, k);
+		}
+
+		k = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(RoundKeys + (RNDCNT * 16))));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(Output), _mm256_aesenclast_epi128(x0, k));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(Output + 32), _mm256_aesenclast_epi128(x1, k));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(Output + 64), _mm256_aesenclast_epi128(x2, k));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(Output + 96), _mm256_aesenclast_epi128(x3, k));
+	}
+
+	// encrypt 16 blocks, two blocks in each register
+	void Encrypt16x256(const uint8_t* RoundKeys, size_t KeyCount, const uint8_t* Input, uint8_t* Output)
+	{
+		const size_t RNDCNT = KeyCount - 1;
+		__m256i k;
+		__m256i x0;
+		__m256i x1;
+		__m256i x2;
+		__m256i x3;
+		__m256i x4;
+		__m256i x5;
+		__m256i x6;
+		__m256i x7;
+		size_t i;
+
+		k = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(RoundKeys)));
+		x0 = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(Input)), k);
+		x1 = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(Input + 32)), k);
+		x2 = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(Input + 64)), k);
+		x3 = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(Input + 96)), k);
+		x4 = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(Input + 128)), k);
+		x5 = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(Input + 160)), k);
+		x6 = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(Input + 192)), k);
+		x7 = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(Input + 224)), k);
+
+		for (i = 1; i != RNDCNT; ++i)
+		{
+			k = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(RoundKeys + (i * 16))));
+			x0 = _mm256_aesenc_epi128(x0, k);
+			x1 = _mm256_aesenc_epi128(x1, k);
+			x2 = _mm256_aesenc_epi128(x2, k);
+			x3 = _mm256_aesenc_epi128(x3, k);
+			x4 = _mm256_aesenc_epi128(x4, k);
+			x5 = _mm256_aesenc_epi128(x5, k);
+			x6 = _mm256_aesenc_epi128(x6, k);
+			x7 = _mm256_aesenc_epi128(x7, k);
+		}
+
+		k = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(RoundKeys + (RNDCNT * 16))));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(Output), _mm256_aesenclast_epi128(x0, k));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(Output + 32), _mm256_aesenclast_epi128(x1, k));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(Output + 64), _mm256_aesenclast_epi128(x2, k));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(Output + 96), _mm256_aesenclast_epi128(x3, k));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(Output + 128), _mm256_aesenclast_epi128(x4, k));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(Output + 160), _mm256_aesenclast_epi128(x5, k));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(Output + 192), _mm256_aesenclast_epi128(x6, k));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(Output + 224), _mm256_aesenclast_epi128(x7, k));
+	}
+}
+#else
+using Exception::CryptoSymmetricException;
+using Enumeration::ErrorCodes;
+#endif
+
+SimdProfiles RijndaelKernels::Compiled()
+{
+	return HasVaes512() ? SimdProfiles::Simd512 :
+		HasVaes256() ? SimdProfiles::Simd256 :
+		SimdProfiles::None;
+}
+
+bool RijndaelKernels::HasVaes256()
+{
+#if defined(CEX_HAS_AVX2) && defined(CEX_HAS_VAES)
+	return true;
+#else
+	return false;
+#endif
+}
+
+void RijndaelKernels::Decrypt8x256H(const uint8_t* RoundKeys, size_t KeyCount, const uint8_t* Input, uint8_t* Output)
+{
+#if defined(CEX_HAS_AVX2) && defined(CEX_HAS_VAES)
+	Decrypt8x256(RoundKeys, KeyCount, Input, Output);
+#else
+	throw CryptoSymmetricException(std::string("RijndaelKernels"), std::string("Decrypt8x256H"), std::string("The VAES-256 kernel was not compiled!"), ErrorCodes::NotSupported);
+#endif
+}
+
+void RijndaelKernels::Decrypt16x256H(const uint8_t* RoundKeys, size_t KeyCount, const uint8_t* Input, uint8_t* Output)
+{
+#if defined(CEX_HAS_AVX2) && defined(CEX_HAS_VAES)
+	Decrypt16x256(RoundKeys, KeyCount, Input, Output);
+#else
+	throw CryptoSymmetricException(std::string("RijndaelKernels"), std::string("Decrypt16x256H"), std::string("The VAES-256 kernel was not compiled!"), ErrorCodes::NotSupported);
+#endif
+}
+
+void RijndaelKernels::Encrypt8x256H(const uint8_t* RoundKeys, size_t KeyCount, const uint8_t* Input, uint8_t* Output)
+{
+#if defined(CEX_HAS_AVX2) && defined(CEX_HAS_VAES)
+	Encrypt8x256(RoundKeys, KeyCount, Input, Output);
+#else
+	throw CryptoSymmetricException(std::string("RijndaelKernels"), std::string("Encrypt8x256H"), std::string("The VAES-256 kernel was not compiled!"), ErrorCodes::NotSupported);
+#endif
+}
+
+void RijndaelKernels::Encrypt16x256H(const uint8_t* RoundKeys, size_t KeyCount, const uint8_t* Input, uint8_t* Output)
+{
+#if defined(CEX_HAS_AVX2) && defined(CEX_HAS_VAES)
+	Encrypt16x256(RoundKeys, KeyCount, Input, Output);
+#else
+	throw CryptoSymmetricException(std::string("RijndaelKernels"), std::string("Encrypt16x256H"), std::string("The VAES-256 kernel was not compiled!"), ErrorCodes::NotSupported);
+#endif
+}
+
+NAMESPACE_BLOCKEND
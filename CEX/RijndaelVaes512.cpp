@@ -0,0 +1,114 @@
+#include "RijndaelKernels.h"
+#if defined(CEX_HAS_AVX512) && defined(CEX_HAS_VAES)
+#	include "Intrinsics.h"
+#else
+#	include "CryptoSymmetricException.h"
+#endif
+
+NAMESPACE_BLOCK
+
+// this unit is compiled with the AVX512 and VAES code generation flags; it includes no shared header with instruction set branches,
+// and the round functions have internal linkage, so no inline code compiled here can be linked into another unit
+
+#if defined(CEX_HAS_AVX512) && defined(CEX_HAS_VAES)
+namespace
+{
+	// decrypt 16 blocks, four blocks in each register
+	void Decrypt16x512(const uint8_t* RoundKeys, size_t KeyCount, const uint8_t* Input, uint8_t* Output)
+	{
+		const size_t RNDCNT = KeyCount - 1;
+		__m512i k;
+		__m512i x0;
+		__m512i x1;
+		__m512i x2;
+		__m512i x3;
+		size_t i;
+
+		k = _mm512_broadcast_i32x4(_mm_loadu_si128(reinterpret_cast<const __m128i*>(RoundKeys)));
+		x0 = _mm512_xor_si512(_mm512_loadu_si512(reinterpret_cast<const __m512i*>(Input)), k);
+		x1 = _mm512_xor_si512(_mm512_loadu_si512(reinterpret_cast<const __m512i*>(Input + 64)), k);
+		x2 = _mm512_xor_si512(_mm512_loadu_si512(reinterpret_cast<const __m512i*>(Input + 128)), k);
+		x3 = _mm512_xor_si512(_mm512_loadu_si512(reinterpret_cast<const __m512i*>(Input + 192)), k);
+
+		for (i = 1; i != RNDCNT; ++i)
+		{
+			k = _mm512_broadcast_i32x4(_mm_loadu_si128(reinterpret_cast<const __m128i*>(RoundKeys + (i * 16))));
+			x0 = _mm512_aesdec_epi128(x0, k);
+			x1 = _mm512_aesdec_epi128(x1, k);
+			x2 = _mm512_aesdec_epi128(x2, k);
+			x3 = _mm512_aesdec_epi128(x3, k);
+		}
+
+		k = _mm512_broadcast_i32x4(_mm_loadu_si128(reinterpret_cast<const __m128i*>(RoundKeys + (RNDCNT * 16))));
+		_mm512_storeu_si512(reinterpret_cast<__m512i*>(Output), _mm512_aesdeclast_epi128(x0, k));
+		_mm512_storeu_si512(reinterpret_cast<__m512i*>(Output + 64), _mm512_aesdeclast_epi128(x1, k));
+		_mm512_storeu_si512(reinterpret_cast<__m512i*>(Output + 128), _mm512_aesdeclast_epi128(x2, k));
+		_mm512_storeu_si512(reinterpret_cast<__m512i*>(Output + 192), _mm512_aesdeclast_epi128(x3, k));
+	}
+
+	// encrypt 16 blocks, four blocks in each register
+	void Encrypt16x512(const uint8_t* RoundKeys, size_t KeyCount, const uint8_t* Input, uint8_t* Output)
+	{
+		const size_t RNDCNT = KeyCount - 1;
+		__m512i k;
+		__m512i x0;
+		__m512i x1;
+		__m512i x2;
+		__m512i x3;
+		size_t i;
+
+		k = _mm512_broadcast_i32x4(_mm_loadu_si128(reinterpret_cast<const __m128i*>(RoundKeys)));
+		x0 = _mm512_xor_si512(_mm512_loadu_si512(reinterpret_cast<const __m512i*>(Input)), k);
+		x1 = _mm512_xor_si512(_mm512_loadu_si512(reinterpret_cast<const __m512i*>(Input + 64)), k);
+		x2 = _mm512_xor_si512(_mm512_loadu_si512(reinterpret_cast<const __m512i*>(Input + 128)), k);
+		x3 = _mm512_xor_si512(_mm512_loadu_si512(reinterpret_cast<const __m512i*>(Input + 192)), k);
+
+		for (i = 1; i != RNDCNT; ++i)
+		{
+			k = _mm512_broadcast_i32x4(_mm_loadu_si128(reinterpret_cast<const __m128i*>(RoundKeys + (i * 16))));
+			x0 = _mm512_aesenc_epi128(x0, k);
+			x1 = _mm512_aesenc_epi128(x1, k);
+			x2 = _mm512_aesenc_epi128(x2, k);
+			x3 = _mm512_aesenc_epi128(x3, k);
+		}
+
+		k = _mm512_broadcast_i32x4(_mm_loadu_si128(reinterpret_cast<const __m128i*>(RoundKeys + (RNDCNT * 16))));
+		_mm512_storeu_si512(reinterpret_cast<__m512i*>(Output), _mm512_aesenclast_epi128(x0, k));
+		_mm512_storeu_si512(reinterpret_cast<__m512i*>(Output + 64), _mm512_aesenclast_epi128(x1, k));
+		_mm512_storeu_si512(reinterpret_cast<__m512i*>(Output + 128), _mm512_aesenclast_epi128(x2, k));
+		_mm512_storeu_si512(reinterpret_cast<__m512i*>(Output + 192), _mm512_aesenclast_epi128(x3, k));
+	}
+}
+#else
+using Exception::CryptoSymmetricException;
+using Enumeration::ErrorCodes;
+#endif
+
+bool RijndaelKernels::HasVaes512()
+{
+#if defined(CEX_HAS_AVX512) && defined(CEX_HAS_VAES)
+	return true;
+#else
+	return false;
+#endif
+}
+
+void RijndaelKernels::Decrypt16x512H(const uint8_t* RoundKeys, size_t KeyCount, const uint8_t* Input, uint8_t* Output)
+{
+#if defined(CEX_HAS_AVX512) && defined(CEX_HAS_VAES)
+	Decrypt16x512(RoundKeys, KeyCount, Input, Output);
+#else
+	throw CryptoSymmetricException(std::string("RijndaelKernels"), std::string("Decrypt16x512H"), std::string("The VAES-512 kernel was not compiled!"), ErrorCodes::NotSupported);
+#endif
+}
+
+void RijndaelKernels::Encrypt16x512H(const uint8_t* RoundKeys, size_t KeyCount, const uint8_t* Input, uint8_t* Output)
+{
+#if defined(CEX_HAS_AVX512) && defined(CEX_HAS_VAES)
+	Encrypt16x512(RoundKeys, KeyCount, Input, Output);
+#else
+	throw CryptoSymmetricException(std::string("RijndaelKernels"), std::string("Encrypt16x512H"), std::string("The VAES-512 kernel was not compiled!"), ErrorCodes::NotSupported);
+#endif
+}
+
+NAMESPACE_BLOCKEND
@@ -22,13 +22,8 @@
 #include "CexDomain.h"
 #include "IntegerTools.h"
 #include "MemoryTools.h"
-
-#if defined(CEX_HAS_AVX512)
-#	include "UInt512.h"
-#	include "ULong512.h"
-#elif defined(CEX_HAS_AVX2)
-#	include "UInt256.h"
-#	include "ULong256.h"
+#if defined(CEX_HAS_SHANI)
+#	include "Intrinsics.h"
 #endif
 
 NAMESPACE_DIGEST
@@ -36,24 +31,13 @@ NAMESPACE_DIGEST
 using Tools::IntegerTools;
 using Tools::MemoryTools;
 
-#if defined(CEX_HAS_AVX512)
-	using Numeric::UInt512;
-	using Numeric::ULong512;
-#elif defined(CEX_HAS_AVX2)
-	using Numeric::UInt256;
-	using Numeric::ULong256;
-#endif
-
 /// <summary>
 /// Contains the SHA2-256 and 512bit permutation functions.
 /// <para>The function names are in the format; Permute-rounds-bits-suffix, ex. PermuteR64P512C, 64 rounds, permutes 512 bits, using the compact form of the function. \n
 /// The compact forms of the permutations have the suffix C, and are optimized for performance and low memory consumption 
 /// (enabled in the hash function by adding the CEX_DIGEST_COMPACT to the CexConfig file). \n
 /// The Unrolled forms are optimized for speed and timing neutrality (suffix U), and the vertically vectorized functions have the V suffix. \n
-/// The H suffix denotes functions that take an SIMD wrapper class (ULongXXX) as the state values, and process state in SIMD parallel blocks.</para>
-/// <para>This class contains wide forms of the functions; PermuteR64P8x512H and PermuteR80P4x1024H use AVX2. \n
-/// Experimental functions using AVX512 instructions are also implemented; PermuteR64P16x512H and PermuteR80P8x1024H. \n
-/// These functions are not visible until run-time on some compiler platforms unless the compiler flag (__AVX2__ or __AVX512__) is explicitly declared.</para>
+/// The multi-lane (wide) forms of the permutations are in SHA2Kernels; they are built in their own AVX2 and AVX512 translation units, and selected at run-time.</para>
 /// </summary>
 class SHA2
 {
@@ -62,22 +46,6 @@ private:
 	static const std::vector<uint32_t> SHA2256_RC64;
 	static const std::vector<uint64_t> SHA2512_RC80;
 
-	template<typename T>
-	static void Round256W(T &A, T &B, T &C, T &D, T &E, T &F, T &G, T &H, T &M, T &P)
-	{
-		T R(H + (((E >> 6) | (E << 26)) ^ ((E >> 11) | (E << 21)) ^ ((E >> 25) | (E << 7))) + ((E & F) ^ (~E & G)) + M + P);
-		D += R;
-		H = R + ((((A >> 2) | (A << 30)) ^ ((A >> 13) | (A << 19)) ^ ((A >> 22) | (A << 10))) + ((A & B) ^ (A & C) ^ (B & C)));
-	}
-
-	template<typename T>
-	static void Round512W(T &A, T &B, T &C, T &D, T &E, T &F, T &G, T &H, T &M, T &P)
-	{
-		T R(H + (((E << 50) | (E >> 14)) ^ ((E << 46) | (E >> 18)) ^ ((E << 23) | (E >> 41))) + ((E & F) ^ (~E & G)) + M + P);
-		D += R;
-		H = R + (((A << 36) | (A >> 28)) ^ ((A << 30) | (A >> 34)) ^ ((A << 25) | (A >> 39))) + ((A & B) ^ (A & C) ^ (B & C));
-	}
-
 	template<typename T>
 	inline static T Sigma0(T &X)
 	{
@@ -648,7 +616,7 @@ public:
 		State[7] += H;
 	}
 
-#if defined(CEX_HAS_AVX2)
+#if defined(CEX_HAS_SHANI)
 
 	/// <summary>
 	/// The vertically vectorized form of the SHA2-256 permutation function.
@@ -835,180 +803,6 @@ public:
 	}
 #endif
 
-#if defined(CEX_HAS_AVX512)
-
-	/// <summary>
-	/// The horizontally vectorized form of the SHA2-256 permutation function.
-	/// <para>This function process 16*64 blocks of input in parallel using AVX512 instructions.</para>
-	/// </summary>
-	/// 
-	/// <param name="Input">The input message array</param>
-	/// <param name="InOffset">The starting offset within the Input array</param>
-	/// <param name="State">The permutations UInt512 state array</param>
-	template<typename ArrayU8, typename ArrayU512>
-	static void PermuteR64P16x512H(const ArrayU8 &Input, size_t InOffset, ArrayU512 &State)
-	{
-		std::array<UInt512, 8> A;
-		std::array<UInt512, 64> W;
-		UInt512 K;
-		size_t i;
-		size_t j;
-
-		MemoryTools::Copy(State, 0, A, 0, State.size() * sizeof(UInt512));
-
-#if defined(CEX_IS_LITTLE_ENDIAN)
-		for (i = 0; i < 16; ++i)
-		{
-			W[i].Load(
-				IntegerTools::BeBytesTo32(Input, InOffset + (i * sizeof(uint32_t))),
-				IntegerTools::BeBytesTo32(Input, InOffset + (i * sizeof(uint32_t)) + 64),
-				IntegerTools::BeBytesTo32(Input, InOffset + (i * sizeof(uint32_t)) + 128),
-				IntegerTools::BeBytesTo32(Input, InOffset + (i * sizeof(uint32_t)) + 196),
-				IntegerTools::BeBytesTo32(Input, InOffset + (i * sizeof(uint32_t)) + 256),
-				IntegerTools::BeBytesTo32(Input, InOffset + (i * sizeof(uint32_t)) + 320),
-				IntegerTools::BeBytesTo32(Input, InOffset + (i * sizeof(uint32_t)) + 384),
-				IntegerTools::BeBytesTo32(Input, InOffset + (i * sizeof(uint32_t)) + 448),
-				IntegerTools::BeBytesTo32(Input, InOffset + (i * sizeof(uint32_t)) + 512),
-				IntegerTools::BeBytesTo32(Input, InOffset + (i * sizeof(uint32_t)) + 576),
-				IntegerTools::BeBytesTo32(Input, InOffset + (i * sizeof(uint32_t)) + 640),
-				IntegerTools::BeBytesTo32(Input, InOffset + (i * sizeof(uint32_t)) + 704),
-				IntegerTools::BeBytesTo32(Input, InOffset + (i * sizeof(uint32_t)) + 768),
-				IntegerTools::BeBytesTo32(Input, InOffset + (i * sizeof(uint32_t)) + 832),
-				IntegerTools::BeBytesTo32(Input, InOffset + (i * sizeof(uint32_t)) + 896),
-				IntegerTools::BeBytesTo32(Input, InOffset + (i * sizeof(uint32_t)) + 960));
-		}
-#else
-		MemoryTools::Copy(Input, InOffset, W, 0, A.size() * sizeof(UInt512));
-#endif
-
-		for (i = 16; i < 64; i++)
-		{
-			W[i] = Theta1(W[i - 2]) + W[i - 7] + Theta0(W[i - 15]) + W[i - 16];
-		}
-
-		j = 0;
-		for (i = 0; i < 8; ++i)
-		{
-			K.Load(SHA2256_RC64[j]);
-			Round256W(A[0], A[1], A[2], A[3], A[4], A[5], A[6], A[7], K, W[j]);
-			++j;
-			K.Load(SHA2256_RC64[j]);
-			Round256W(A[7], A[0], A[1], A[2], A[3], A[4], A[5], A[6], K, W[j]);
-			++j;
-			K.Load(SHA2256_RC64[j]);
-			Round256W(A[6], A[7], A[0], A[1], A[2], A[3], A[4], A[5], K, W[j]);
-			++j;
-			K.Load(SHA2256_RC64[j]);
-			Round256W(A[5], A[6], A[7], A[0], A[1], A[2], A[3], A[4], K, W[j]);
-			++j;
-			K.Load(SHA2256_RC64[j]);
-			Round256W(A[4], A[5], A[6], A[7], A[0], A[1], A[2], A[3], K, W[j]);
-			++j;
-			K.Load(SHA2256_RC64[j]);
-			Round256W(A[3], A[4], A[5], A[6], A[7], A[0], A[1], A[2], K, W[j]);
-			++j;
-			K.Load(SHA2256_RC64[j]);
-			Round256W(A[2], A[3], A[4], A[5], A[6], A[7], A[0], A[1], K, W[j]);
-			++j;
-			K.Load(SHA2256_RC64[j]);
-			Round256W(A[1], A[2], A[3], A[4], A[5], A[6], A[7], A[0], K, W[j]);
-			++j;
-		}
-
-		State[0] += A[0];
-		State[1] += A[1];
-		State[2] += A[2];
-		State[3] += A[3];
-		State[4] += A[4];
-		State[5] += A[5];
-		State[6] += A[6];
-		State[7] += A[7];
-	}
-
-#elif defined(CEX_HAS_AVX2)
-
-	/// <summary>
-	/// The horizontally vectorized form of the SHA2-256 permutation function.
-	/// <para>This function processes 8*64 blocks of input in parallel using AVX2 instructions.</para>
-	/// </summary>
-	/// 
-	/// <param name="Input">The input message array</param>
-	/// <param name="InOffset">The starting offset within the Input array</param>
-	/// <param name="State">The permutations UInt256 state array</param>
-	template<typename ArrayU8, typename ArrayU256>
-	static void PermuteR64P8x512H(const ArrayU8 &Input, size_t InOffset, ArrayU256 &State)
-	{
-		std::array<UInt256, 8> A;
-		std::array<UInt256, 64> W;
-		UInt256 K;
-		size_t i;
-		size_t j;
-
-		MemoryTools::Copy(State, 0, A, 0, State.size() * sizeof(UInt256));
-
-#if defined(CEX_IS_LITTLE_ENDIAN)
-		for (i = 0; i < 16; ++i)
-		{
-			W[i].Load(
-				IntegerTools::BeBytesTo32(Input, InOffset + (i * sizeof(uint32_t))),
-				IntegerTools::BeBytesTo32(Input, InOffset + (i * sizeof(uint32_t)) + 64),
-				IntegerTools::BeBytesTo32(Input, InOffset + (i * sizeof(uint32_t)) + 128),
-				IntegerTools::BeBytesTo32(Input, InOffset + (i * sizeof(uint32_t)) + 196),
-				IntegerTools::BeBytesTo32(Input, InOffset + (i * sizeof(uint32_t)) + 256),
-				IntegerTools::BeBytesTo32(Input, InOffset + (i * sizeof(uint32_t)) + 320),
-				IntegerTools::BeBytesTo32(Input, InOffset + (i * sizeof(uint32_t)) + 384),
-				IntegerTools::BeBytesTo32(Input, InOffset + (i * sizeof(uint32_t)) + 448));
-		}
-#else
-		MemoryTools::Copy(Input, InOffset, W, 0, A.size() * sizeof(UInt256));
-#endif
-
-		for (i = 16; i < 64; i++)
-		{
-			W[i] = Theta1(W[i - 2]) + W[i - 7] + Theta0(W[i - 15]) + W[i - 16];
-		}
-
-		j = 0;
-		for (i = 0; i < 8; ++i)
-		{
-			K.Load(SHA2256_RC64[j]);
-			Round256W(A[0], A[1], A[2], A[3], A[4], A[5], A[6], A[7], K, W[j]);
-			++j;
-			K.Load(SHA2256_RC64[j]);
-			Round256W(A[7], A[0], A[1], A[2], A[3], A[4], A[5], A[6], K, W[j]);
-			++j;
-			K.Load(SHA2256_RC64[j]);
-			Round256W(A[6], A[7], A[0], A[1], A[2], A[3], A[4], A[5], K, W[j]);
-			++j;
-			K.Load(SHA2256_RC64[j]);
-			Round256W(A[5], A[6], A[7], A[0], A[1], A[2], A[3], A[4], K, W[j]);
-			++j;
-			K.Load(SHA2256_RC64[j]);
-			Round256W(A[4], A[5], A[6], A[7], A[0], A[1], A[2], A[3], K, W[j]);
-			++j;
-			K.Load(SHA2256_RC64[j]);
-			Round256W(A[3], A[4], A[5], A[6], A[7], A[0], A[1], A[2], K, W[j]);
-			++j;
-			K.Load(SHA2256_RC64[j]);
-			Round256W(A[2], A[3], A[4], A[5], A[6], A[7], A[0], A[1], K, W[j]);
-			++j;
-			K.Load(SHA2256_RC64[j]);
-			Round256W(A[1], A[2], A[3], A[4], A[5], A[6], A[7], A[0], K, W[j]);
-			++j;
-		}
-
-		State[0] += A[0];
-		State[1] += A[1];
-		State[2] += A[2];
-		State[3] += A[3];
-		State[4] += A[4];
-		State[5] += A[5];
-		State[6] += A[6];
-		State[7] += A[7];
-	}
-
-#endif
-
 	//~~~SHA2-384~~~//
 
 	/// <summary>
@@ -1646,169 +1440,6 @@ public:
 		State[6] += G;
 		State[7] += H;
 	}
-
-#if defined(CEX_HAS_AVX512)
-
-	/// <summary>
-	/// The horizontally vectorized form of the SHA2-512 permutation function.
-	/// <para>This function process 8*128 blocks of input in parallel using AVX512 instructions.</para>
-	/// </summary>
-	/// 
-	/// <param name="Input">The input message array</param>
-	/// <param name="InOffset">The starting offset within the Input array</param>
-	/// <param name="State">The permutations UInt512 state array</param>
-	template<typename ArrayU8, typename ArrayU512>
-	static void PermuteR80P8x1024H(const ArrayU8 &Input, size_t InOffset, ArrayU512 &State)
-	{
-		std::array<ULong512, 8> A;
-		std::array<ULong512, 80> W;
-		ULong512 K;
-		size_t i;
-		size_t j;
-
-		MemoryTools::Copy(State, 0, A, 0, State.size() * sizeof(ULong512));
-
-#if defined(CEX_IS_LITTLE_ENDIAN)
-		for (i = 0; i < 16; ++i)
-		{
-			W[i].Load(
-				IntegerTools::BeBytesTo64(Input, InOffset + (i * sizeof(uint64_t))),
-				IntegerTools::BeBytesTo64(Input, InOffset + (i * sizeof(uint64_t)) + 128),
-				IntegerTools::BeBytesTo64(Input, InOffset + (i * sizeof(uint64_t)) + 256),
-				IntegerTools::BeBytesTo64(Input, InOffset + (i * sizeof(uint64_t)) + 384),
-				IntegerTools::BeBytesTo64(Input, InOffset + (i * sizeof(uint64_t)) + 512),
-				IntegerTools::BeBytesTo64(Input, InOffset + (i * sizeof(uint64_t)) + 640),
-				IntegerTools::BeBytesTo64(Input, InOffset + (i * sizeof(uint64_t)) + 768),
-				IntegerTools::BeBytesTo64(Input, InOffset + (i * sizeof(uint64_t)) + 896));
-		}
-#else
-		MemoryTools::Copy(Input, InOffset, W, 0, A.size() * sizeof(ULong512));
-#endif
-
-		for (i = 16; i < 80; i++)
-		{
-			W[i] = Sigma1(W[i - 2]) + W[i - 7] + Sigma0(W[i - 15]) + W[i - 16];
-		}
-
-		j = 0;
-		for (i = 0; i < 10; ++i)
-		{
-			K.Load(SHA2512_RC80[j]);
-			Round512W(A[0], A[1], A[2], A[3], A[4], A[5], A[6], A[7], K, W[j]);
-			++j;
-			K.Load(SHA2512_RC80[j]);
-			Round512W(A[7], A[0], A[1], A[2], A[3], A[4], A[5], A[6], K, W[j]);
-			++j;
-			K.Load(SHA2512_RC80[j]);
-			Round512W(A[6], A[7], A[0], A[1], A[2], A[3], A[4], A[5], K, W[j]);
-			++j;
-			K.Load(SHA2512_RC80[j]);
-			Round512W(A[5], A[6], A[7], A[0], A[1], A[2], A[3], A[4], K, W[j]);
-			++j;
-			K.Load(SHA2512_RC80[j]);
-			Round512W(A[4], A[5], A[6], A[7], A[0], A[1], A[2], A[3], K, W[j]);
-			++j;
-			K.Load(SHA2512_RC80[j]);
-			Round512W(A[3], A[4], A[5], A[6], A[7], A[0], A[1], A[2], K, W[j]);
-			++j;
-			K.Load(SHA2512_RC80[j]);
-			Round512W(A[2], A[3], A[4], A[5], A[6], A[7], A[0], A[1], K, W[j]);
-			++j;
-			K.Load(SHA2512_RC80[j]);
-			Round512W(A[1], A[2], A[3], A[4], A[5], A[6], A[7], A[0], K, W[j]);
-			++j;
-		}
-
-		State[0] += A[0];
-		State[1] += A[1];
-		State[2] += A[2];
-		State[3] += A[3];
-		State[4] += A[4];
-		State[5] += A[5];
-		State[6] += A[6];
-		State[7] += A[7];
-	}
-
-#elif defined(CEX_HAS_AVX2)
-
-	/// <summary>
-	/// The horizontally vectorized form of the SHA2-512 permutation function.
-	/// <para>This function processes 4*128 blocks of input in parallel using AVX2 instructions.</para>
-	/// </summary>
-	/// 
-	/// <param name="Input">The input message array</param>
-	/// <param name="InOffset">The starting offset within the Input array</param>
-	/// <param name="State">The permutations state array</param>
-	template<typename ArrayU8, typename ArrayU256>
-	static void PermuteR80P4x1024H(const ArrayU8 &Input, size_t InOffset, ArrayU256 &State)
-	{
-		std::array<ULong256, 8> A;
-		std::array<ULong256, 80> W;
-		ULong256 K;
-		size_t i;
-		size_t j;
-
-		MemoryTools::Copy(State, 0, A, 0, State.size() * sizeof(ULong256));
-
-#if defined(CEX_IS_LITTLE_ENDIAN)
-		for (i = 0; i < 16; ++i)
-		{
-			W[i].Load(
-				IntegerTools::BeBytesTo64(Input, InOffset + (i * sizeof(uint64_t))),
-				IntegerTools::BeBytesTo64(Input, InOffset + (i * sizeof(uint64_t)) + 128),
-				IntegerTools::BeBytesTo64(Input, InOffset + (i * sizeof(uint64_t)) + 256),
-				IntegerTools::BeBytesTo64(Input, InOffset + (i * sizeof(uint64_t)) + 384));
-		}
-#else
-		MemoryTools::Copy(Input, InOffset, W, 0, A.size() * sizeof(ULong256));
-#endif
-
-		for (i = 16; i < 80; i++)
-		{
-			W[i] = Sigma1(W[i - 2]) + W[i - 7] + Sigma0(W[i - 15]) + W[i - 16];
-		}
-
-		j = 0;
-		for (i = 0; i < 10; ++i)
-		{
-			K.Load(SHA2512_RC80[j]);
-			Round512W(A[0], A[1], A[2], A[3], A[4], A[5], A[6], A[7], K, W[j]);
-			++j;
-			K.Load(SHA2512_RC80[j]);
-			Round512W(A[7], A[0], A[1], A[2], A[3], A[4], A[5], A[6], K, W[j]);
-			++j;
-			K.Load(SHA2512_RC80[j]);
-			Round512W(A[6], A[7], A[0], A[1], A[2], A[3], A[4], A[5], K, W[j]);
-			++j;
-			K.Load(SHA2512_RC80[j]);
-			Round512W(A[5], A[6], A[7], A[0], A[1], A[2], A[3], A[4], K, W[j]);
-			++j;
-			K.Load(SHA2512_RC80[j]);
-			Round512W(A[4], A[5], A[6], A[7], A[0], A[1], A[2], A[3], K, W[j]);
-			++j;
-			K.Load(SHA2512_RC80[j]);
-			Round512W(A[3], A[4], A[5], A[6], A[7], A[0], A[1], A[2], K, W[j]);
-			++j;
-			K.Load(SHA2512_RC80[j]);
-			Round512W(A[2], A[3], A[4], A[5], A[6], A[7], A[0], A[1], K, W[j]);
-			++j;
-			K.Load(SHA2512_RC80[j]);
-			Round512W(A[1], A[2], A[3], A[4], A[5], A[6], A[7], A[0], K, W[j]);
-			++j;
-		}
-
-		State[0] += A[0];
-		State[1] += A[1];
-		State[2] += A[2];
-		State[3] += A[3];
-		State[4] += A[4];
-		State[5] += A[5];
-		State[6] += A[6];
-		State[7] += A[7];
-	}
-
-#endif
-
 };
 
 NAMESPACE_DIGESTEND
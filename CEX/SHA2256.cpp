@@ -3,7 +3,7 @@
 #include "IntegerTools.h"
 #include "MemoryTools.h"
 #include "ParallelTools.h"
-#if defined(CEX_HAS_AVX)
+#if defined(CEX_HAS_SHANI)
 #	include "Intrinsics.h"
 #endif
 
@@ -60,6 +60,8 @@ SHA2256::SHA2256(bool Parallel)
 		SHA2Params(SHA2::SHA2256_DIGEST_SIZE, 0UL, 0x00))
 {
 	Reset();
+
+	m_parallelProfile.SetAlgorithm(Name());
 }
 
 SHA2256::SHA2256(SHA2Params &Params)
@@ -73,6 +75,8 @@ SHA2256::SHA2256(SHA2Params &Params)
 	m_treeParams(Params)
 {
 	Reset();
+
+	m_parallelProfile.SetAlgorithm(Name());
 }
 
 SHA2256::~SHA2256()
@@ -290,7 +294,7 @@ void SHA2256::Update(const std::vector<uint8_t> &Input, size_t InOffset, size_t
 				}
 
 				// empty the message buffer
-				ParallelTools::ParallelFor(0, m_parallelProfile.ParallelMaxDegree(), [this, &Input, InOffset](size_t i)
+				ParallelTools::ParallelFor(m_parallelProfile, 0, m_parallelProfile.ParallelMaxDegree(), [this, &Input, InOffset](size_t i)
 				{
 					Permute(m_msgBuffer, i * SHA2::SHA2256_RATE_SIZE, m_dgtState[i]);
 				});
@@ -306,7 +310,7 @@ void SHA2256::Update(const std::vector<uint8_t> &Input, size_t InOffset, size_t
 				const size_t PRCLEN = Length - (Length % m_parallelProfile.ParallelBlockSize());
 
 				// process large blocks
-				ParallelTools::ParallelFor(0, m_parallelProfile.ParallelMaxDegree(), [this, &Input, InOffset, PRCLEN](size_t i)
+				ParallelTools::ParallelFor(m_parallelProfile, 0, m_parallelProfile.ParallelMaxDegree(), [this, &Input, InOffset, PRCLEN](size_t i)
 				{
 					ProcessLeaf(Input, InOffset + (i * SHA2::SHA2256_RATE_SIZE), m_dgtState[i], PRCLEN);
 				});
@@ -319,7 +323,7 @@ void SHA2256::Update(const std::vector<uint8_t> &Input, size_t InOffset, size_t
 			{
 				const size_t PRMLEN = Length - (Length % m_parallelProfile.ParallelMinimumSize());
 
-				ParallelTools::ParallelFor(0, m_parallelProfile.ParallelMaxDegree(), [this, &Input, InOffset, PRMLEN](size_t i)
+				ParallelTools::ParallelFor(m_parallelProfile, 0, m_parallelProfile.ParallelMaxDegree(), [this, &Input, InOffset, PRMLEN](size_t i)
 				{
 					ProcessLeaf(Input, InOffset + (i * SHA2::SHA2256_RATE_SIZE), m_dgtState[i], PRMLEN);
 				});
@@ -398,7 +402,7 @@ void SHA2256::HashFinal(std::vector<uint8_t> &Input, size_t InOffset, size_t Len
 
 void SHA2256::Permute(const std::vector<uint8_t> &Input, size_t InOffset, SHA2256State &State)
 {
-#if defined(CEX_HAS_AVX2)
+#if defined(CEX_HAS_SHANI)
 	if (m_parallelProfile.HasSHA2())
 	{
 		SHA2::PermuteR64P512V(Input, InOffset, State.H);
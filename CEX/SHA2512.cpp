@@ -63,6 +63,8 @@ SHA2512::SHA2512(bool Parallel)
 		SHA2Params(SHA2::SHA2512_DIGEST_SIZE, 0UL, 0x00))
 {
 	Reset();
+
+	m_parallelProfile.SetAlgorithm(Name());
 }
 
 SHA2512::SHA2512(SHA2Params &Params)
@@ -76,6 +78,8 @@ SHA2512::SHA2512(SHA2Params &Params)
 	m_treeParams(Params)
 {
 	Reset();
+
+	m_parallelProfile.SetAlgorithm(Name());
 }
 
 SHA2512::~SHA2512()
@@ -291,7 +295,7 @@ void SHA2512::Update(const std::vector<uint8_t> &Input, size_t InOffset, size_t
 				}
 
 				// empty the message buffer
-				ParallelTools::ParallelFor(0, m_parallelProfile.ParallelMaxDegree(), [this, &Input, InOffset](size_t i)
+				ParallelTools::ParallelFor(m_parallelProfile, 0, m_parallelProfile.ParallelMaxDegree(), [this, &Input, InOffset](size_t i)
 				{
 					Permute(m_msgBuffer, i * SHA2::SHA2512_RATE_SIZE, m_dgtState[i]);
 				});
@@ -307,7 +311,7 @@ void SHA2512::Update(const std::vector<uint8_t> &Input, size_t InOffset, size_t
 				const size_t PRCLEN = Length - (Length % m_parallelProfile.ParallelBlockSize());
 
 				// process large blocks
-				ParallelTools::ParallelFor(0, m_parallelProfile.ParallelMaxDegree(), [this, &Input, InOffset, PRCLEN](size_t i)
+				ParallelTools::ParallelFor(m_parallelProfile, 0, m_parallelProfile.ParallelMaxDegree(), [this, &Input, InOffset, PRCLEN](size_t i)
 				{
 					ProcessLeaf(Input, InOffset + (i * SHA2::SHA2512_RATE_SIZE), m_dgtState[i], PRCLEN);
 				});
@@ -319,7 +323,7 @@ void SHA2512::Update(const std::vector<uint8_t> &Input, size_t InOffset, size_t
 			if (Length >= m_parallelProfile.ParallelMinimumSize())
 			{
 				const size_t PRMLEN = Length - (Length % m_parallelProfile.ParallelMinimumSize());
-				ParallelTools::ParallelFor(0, m_parallelProfile.ParallelMaxDegree(), [this, &Input, InOffset, PRMLEN](size_t i)
+				ParallelTools::ParallelFor(m_parallelProfile, 0, m_parallelProfile.ParallelMaxDegree(), [this, &Input, InOffset, PRMLEN](size_t i)
 				{
 					ProcessLeaf(Input, InOffset + (i * SHA2::SHA2512_RATE_SIZE), m_dgtState[i], PRMLEN);
 				});
@@ -0,0 +1,278 @@
+#include "SHA2Kernels.h"
+#if defined(CEX_HAS_AVX512)
+#	include "UInt512.h"
+#	include "ULong512.h"
+#else
+#	include "CryptoDigestException.h"
+#endif
+
+NAMESPACE_DIGEST
+
+// this unit is compiled with the AVX512 code generation flag; it includes no shared header with instruction set branches,
+// and the permutations and the SIMD wrappers they use have internal linkage, so no inline code compiled here can be linked into another unit
+
+#if defined(CEX_HAS_AVX512)
+namespace
+{
+	using Numeric::UInt512;
+	using Numeric::ULong512;
+
+	// the SHA2-256 and SHA2-512 round constants
+	const uint32_t SHA2256_RC64[64] =
+	{
+		0x428A2F98UL, 0x71374491UL, 0xB5C0FBCFUL, 0xE9B5DBA5UL, 0x3956C25BUL, 0x59F111F1UL, 0x923F82A4UL, 0xAB1C5ED5UL,
+		0xD807AA98UL, 0x12835B01UL, 0x243185BEUL, 0x550C7DC3UL, 0x72BE5D74UL, 0x80DEB1FEUL, 0x9BDC06A7UL, 0xC19BF174UL,
+		0xE49B69C1UL, 0xEFBE4786UL, 0x0FC19DC6UL, 0x240CA1CCUL, 0x2DE92C6FUL, 0x4A7484AAUL, 0x5CB0A9DCUL, 0x76F988DAUL,
+		0x983E5152UL, 0xA831C66DUL, 0xB00327C8UL, 0xBF597FC7UL, 0xC6E00BF3UL, 0xD5A79147UL, 0x06CA6351UL, 0x14292967UL,
+		0x27B70A85UL, 0x2E1B2138UL, 0x4D2C6DFCUL, 0x53380D13UL, 0x650A7354UL, 0x766A0ABBUL, 0x81C2C92EUL, 0x92722C85UL,
+		0xA2BFE8A1UL, 0xA81A664BUL, 0xC24B8B70UL, 0xC76C51A3UL, 0xD192E819UL, 0xD6990624UL, 0xF40E3585UL, 0x106AA070UL,
+		0x19A4C116UL, 0x1E376C08UL, 0x2748774CUL, 0x34B0BCB5UL, 0x391C0CB3UL, 0x4ED8AA4AUL, 0x5B9CCA4FUL, 0x682E6FF3UL,
+		0x748F82EEUL, 0x78A5636FUL, 0x84C87814UL, 0x8CC70208UL, 0x90BEFFFAUL, 0xA4506CEBUL, 0xBEF9A3F7UL, 0xC67178F2UL
+	};
+
+	const uint64_t SHA2512_RC80[80] =
+	{
+		0x428A2F98D728AE22ULL, 0x7137449123EF65CDULL, 0xB5C0FBCFEC4D3B2FULL, 0xE9B5DBA58189DBBCULL, 0x3956C25BF348B538ULL, 0x59F111F1B605D019ULL, 0x923F82A4AF194F9BULL, 0xAB1C5ED5DA6D8118ULL,
+		0xD807AA98A3030242ULL, 0x12835B0145706FBEULL, 0x243185BE4EE4B28CULL, 0x550C7DC3D5FFB4E2ULL, 0x72BE5D74F27B896FULL, 0x80DEB1FE3B1696B1ULL, 0x9BDC06A725C71235ULL, 0xC19BF174CF692694ULL,
+		0xE49B69C19EF14AD2ULL, 0xEFBE4786384F25E3ULL, 0x0FC19DC68B8CD5B5ULL, 0x240CA1CC77AC9C65ULL, 0x2DE92C6F592B0275ULL, 0x4A7484AA6EA6E483ULL, 0x5CB0A9DCBD41FBD4ULL, 0x76F988DA831153B5ULL,
+		0x983E5152EE66DFABULL, 0xA831C66D2DB43210ULL, 0xB00327C898FB213FULL, 0xBF597FC7BEEF0EE4ULL, 0xC6E00BF33DA88FC2ULL, 0xD5A79147930AA725ULL, 0x06CA6351E003826FULL, 0x142929670A0E6E70ULL,
+		0x27B70A8546D22FFCULL, 0x2E1B21385C26C926ULL, 0x4D2C6DFC5AC42AEDULL, 0x53380D139D95B3DFULL, 0x650A73548BAF63DEULL, 0x766A0ABB3C77B2A8ULL, 0x81C2C92E47EDAEE6ULL, 0x92722C851482353BULL,
+		0xA2BFE8A14CF10364ULL, 0xA81A664BBC423001ULL, 0xC24B8B70D0F89791ULL, 0xC76C51A30654BE30ULL, 0xD192E819D6EF5218ULL, 0xD69906245565A910ULL, 0xF40E35855771202AULL, 0x106AA07032BBD1B8ULL,
+		0x19A4C116B8D2D0C8ULL, 0x1E376C085141AB53ULL, 0x2748774CDF8EEB99ULL, 0x34B0BCB5E19B48A8ULL, 0x391C0CB3C5C95A63ULL, 0x4ED8AA4AE3418ACBULL, 0x5B9CCA4F7763E373ULL, 0x682E6FF3D6B2B8A3ULL,
+		0x748F82EE5DEFB2FCULL, 0x78A5636F43172F60ULL, 0x84C87814A1F0AB72ULL, 0x8CC702081A6439ECULL, 0x90BEFFFA23631E28ULL, 0xA4506CEBDE82BDE9ULL, 0xBEF9A3F7B2C67915ULL, 0xC67178F2E372532BULL,
+		0xCA273ECEEA26619CULL, 0xD186B8C721C0C207ULL, 0xEADA7DD6CDE0EB1EULL, 0xF57D4F7FEE6ED178ULL, 0x06F067AA72176FBAULL, 0x0A637DC5A2C898A6ULL, 0x113F9804BEF90DAEULL, 0x1B710B35131C471BULL,
+		0x28DB77F523047D84ULL, 0x32CAAB7B40C72493ULL, 0x3C9EBE0A15C9BEBCULL, 0x431D67C49C100D4CULL, 0x4CC5D4BECB3E42B6ULL, 0x597F299CFC657E2AULL, 0x5FCB6FAB3AD6FAECULL, 0x6C44198C4A475817ULL
+	};
+
+	inline uint32_t BeLoad32(const uint8_t* Input)
+	{
+		return (static_cast<uint32_t>(Input[0]) << 24) |
+			(static_cast<uint32_t>(Input[1]) << 16) |
+			(static_cast<uint32_t>(Input[2]) << 8) |
+			static_cast<uint32_t>(Input[3]);
+	}
+
+	inline uint64_t BeLoad64(const uint8_t* Input)
+	{
+		return (static_cast<uint64_t>(BeLoad32(Input)) << 32) | static_cast<uint64_t>(BeLoad32(Input + 4));
+	}
+
+	template<typename T>
+	void Round256W(T &A, T &B, T &C, T &D, T &E, T &F, T &G, T &H, T &M, T &P)
+	{
+		T R(H + (((E >> 6) | (E << 26)) ^ ((E >> 11) | (E << 21)) ^ ((E >> 25) | (E << 7))) + ((E & F) ^ (~E & G)) + M + P);
+		D += R;
+		H = R + ((((A >> 2) | (A << 30)) ^ ((A >> 13) | (A << 19)) ^ ((A >> 22) | (A << 10))) + ((A & B) ^ (A & C) ^ (B & C)));
+	}
+
+	template<typename T>
+	void Round512W(T &A, T &B, T &C, T &D, T &E, T &F, T &G, T &H, T &M, T &P)
+	{
+		T R(H + (((E << 50) | (E >> 14)) ^ ((E << 46) | (E >> 18)) ^ ((E << 23) | (E >> 41))) + ((E & F) ^ (~E & G)) + M + P);
+		D += R;
+		H = R + (((A << 36) | (A >> 28)) ^ ((A << 30) | (A >> 34)) ^ ((A << 25) | (A >> 39))) + ((A & B) ^ (A & C) ^ (B & C));
+	}
+
+	template<typename T>
+	T Sigma0(T &X)
+	{
+		return (((X << 63) | (X >> 1)) ^ ((X << 56) | (X >> 8)) ^ (X >> 7));
+	}
+
+	template<typename T>
+	T Sigma1(T &X)
+	{
+		return (((X << 45) | (X >> 19)) ^ ((X << 3) | (X >> 61)) ^ (X >> 6));
+	}
+
+	template<typename T>
+	T Theta0(T &X)
+	{
+		return T(((X >> 7) | (X << 25)) ^ ((X >> 18) | (X << 14)) ^ (X >> 3));
+	}
+
+	template<typename T>
+	T Theta1(T &X)
+	{
+		return T(((X >> 17) | (X << 15)) ^ ((X >> 19) | (X << 13)) ^ (X >> 10));
+	}
+
+	// the SHA2-256 permutation of 16 message blocks, one block in each 32-bit lane
+	void PermuteR64P16x512(const uint8_t* Input, uint32_t* State)
+	{
+		std::array<UInt512, 8> A;
+		std::array<UInt512, 64> W;
+		UInt512 K;
+		size_t i;
+		size_t j;
+
+		for (i = 0; i < 8; ++i)
+		{
+			A[i] = UInt512(State, i * 16);
+		}
+
+		// the wrapper loads its first argument into the highest lane, so the blocks are passed last lane first
+		for (i = 0; i < 16; ++i)
+		{
+			W[i].Load(
+				BeLoad32(Input + (i * sizeof(uint32_t)) + 960),
+				BeLoad32(Input + (i * sizeof(uint32_t)) + 896),
+				BeLoad32(Input + (i * sizeof(uint32_t)) + 832),
+				BeLoad32(Input + (i * sizeof(uint32_t)) + 768),
+				BeLoad32(Input + (i * sizeof(uint32_t)) + 704),
+				BeLoad32(Input + (i * sizeof(uint32_t)) + 640),
+				BeLoad32(Input + (i * sizeof(uint32_t)) + 576),
+				BeLoad32(Input + (i * sizeof(uint32_t)) + 512),
+				BeLoad32(Input + (i * sizeof(uint32_t)) + 448),
+				BeLoad32(Input + (i * sizeof(uint32_t)) + 384),
+				BeLoad32(Input + (i * sizeof(uint32_t)) + 320),
+				BeLoad32(Input + (i * sizeof(uint32_t)) + 256),
+				BeLoad32(Input + (i * sizeof(uint32_t)) + 192),
+				BeLoad32(Input + (i * sizeof(uint32_t)) + 128),
+				BeLoad32(Input + (i * sizeof(uint32_t)) + 64),
+				BeLoad32(Input + (i * sizeof(uint32_t))));
+		}
+
+		for (i = 16; i < 64; i++)
+		{
+			W[i] = Theta1(W[i - 2]) + W[i - 7] + Theta0(W[i - 15]) + W[i - 16];
+		}
+
+		j = 0;
+		for (i = 0; i < 8; ++i)
+		{
+			K.Load(SHA2256_RC64[j]);
+			Round256W(A[0], A[1], A[2], A[3], A[4], A[5], A[6], A[7], K, W[j]);
+			++j;
+			K.Load(SHA2256_RC64[j]);
+			Round256W(A[7], A[0], A[1], A[2], A[3], A[4], A[5], A[6], K, W[j]);
+			++j;
+			K.Load(SHA2256_RC64[j]);
+			Round256W(A[6], A[7], A[0], A[1], A[2], A[3], A[4], A[5], K, W[j]);
+			++j;
+			K.Load(SHA2256_RC64[j]);
+			Round256W(A[5], A[6], A[7], A[0], A[1], A[2], A[3], A[4], K, W[j]);
+			++j;
+			K.Load(SHA2256_RC64[j]);
+			Round256W(A[4], A[5], A[6], A[7], A[0], A[1], A[2], A[3], K, W[j]);
+			++j;
+			K.Load(SHA2256_RC64[j]);
+			Round256W(A[3], A[4], A[5], A[6], A[7], A[0], A[1], A[2], K, W[j]);
+			++j;
+			K.Load(SHA2256_RC64[j]);
+			Round256W(A[2], A[3], A[4], A[5], A[6], A[7], A[0], A[1], K, W[j]);
+			++j;
+			K.Load(SHA2256_RC64[j]);
+			Round256W(A[1], A[2], A[3], A[4], A[5], A[6], A[7], A[0], K, W[j]);
+			++j;
+		}
+
+		for (i = 0; i < 8; ++i)
+		{
+			A[i] += UInt512(State, i * 16);
+			A[i].Store(State, i * 16);
+		}
+	}
+
+	// the SHA2-512 permutation of 8 message blocks, one block in each 64-bit lane
+	void PermuteR80P8x1024(const uint8_t* Input, uint64_t* State)
+	{
+		std::array<ULong512, 8> A;
+		std::array<ULong512, 80> W;
+		ULong512 K;
+		size_t i;
+		size_t j;
+
+		for (i = 0; i < 8; ++i)
+		{
+			A[i] = ULong512(State, i * 8);
+		}
+
+		// the wrapper loads its first argument into the highest lane, so the blocks are passed last lane first
+		for (i = 0; i < 16; ++i)
+		{
+			W[i].Load(
+				BeLoad64(Input + (i * sizeof(uint64_t)) + 896),
+				BeLoad64(Input + (i * sizeof(uint64_t)) + 768),
+				BeLoad64(Input + (i * sizeof(uint64_t)) + 640),
+				BeLoad64(Input + (i * sizeof(uint64_t)) + 512),
+				BeLoad64(Input + (i * sizeof(uint64_t)) + 384),
+				BeLoad64(Input + (i * sizeof(uint64_t)) + 256),
+				BeLoad64(Input + (i * sizeof(uint64_t)) + 128),
+				BeLoad64(Input + (i * sizeof(uint64_t))));
+		}
+
+		for (i = 16; i < 80; i++)
+		{
+			W[i] = Sigma1(W[i - 2]) + W[i - 7] + Sigma0(W[i - 15]) + W[i - 16];
+		}
+
+		j = 0;
+		for (i = 0; i < 10; ++i)
+		{
+			K.Load(SHA2512_RC80[j]);
+			Round512W(A[0], A[1], A[2], A[3], A[4], A[5], A[6], A[7], K, W[j]);
+			++j;
+			K.Load(SHA2512_RC80[j]);
+			Round512W(A[7], A[0], A[1], A[2], A[3], A[4], A[5], A[6], K, W[j]);
+			++j;
+			K.Load(SHA2512_RC80[j]);
+			Round512W(A[6], A[7], A[0], A[1], A[2], A[3], A[4], A[5], K, W[j]);
+			++j;
+			K.Load(SHA2512_RC80[j]);
+			Round512W(A[5], A[6], A[7], A[0], A[1], A[2], A[3], A[4], K, W[j]);
+			++j;
+			K.Load(SHA2512_RC80[j]);
+			Round512W(A[4], A[5], A[6], A[7], A[0], A[1], A[2], A[3], K, W[j]);
+			++j;
+			K.Load(SHA2512_RC80[j]);
+			Round512W(A[3], A[4], A[5], A[6], A[7], A[0], A[1], A[2], K, W[j]);
+			++j;
+			K.Load(SHA2512_RC80[j]);
+			Round512W(A[2], A[3], A[4], A[5], A[6], A[7], A[0], A[1], K, W[j]);
+			++j;
+			K.Load(SHA2512_RC80[j]);
+			Round512W(A[1], A[2], A[3], A[4], A[5], A[6], A[7], A[0], K, W[j]);
+			++j;
+		}
+
+		for (i = 0; i < 8; ++i)
+		{
+			A[i] += ULong512(State, i * 8);
+			A[i].Store(State, i * 8);
+		}
+	}
+}
+#else
+using Exception::CryptoDigestException;
+using Enumeration::ErrorCodes;
+#endif
+
+bool SHA2Kernels::HasAvx512()
+{
+#if defined(CEX_HAS_AVX512)
+	return true;
+#else
+	return false;
+#endif
+}
+
+void SHA2Kernels::PermuteR64P16x512H(const uint8_t* Input, uint32_t* State)
+{
+#if defined(CEX_HAS_AVX512)
+	PermuteR64P16x512(Input, State);
+#else
+	throw CryptoDigestException(std::string("SHA2Kernels"), std::string("PermuteR64P16x512H"), std::string("The AVX512 kernel was not compiled!"), ErrorCodes::NotSupported);
+#endif
+}
+
+void SHA2Kernels::PermuteR80P8x1024H(const uint8_t* Input, uint64_t* State)
+{
+#if defined(CEX_HAS_AVX512)
+	PermuteR80P8x1024(Input, State);
+#else
+	throw CryptoDigestException(std::string("SHA2Kernels"), std::string("PermuteR80P8x1024H"), std::string("The AVX512 kernel was not compiled!"), ErrorCodes::NotSupported);
+#endif
+}
+
+NAMESPACE_DIGESTEND
@@ -0,0 +1,64 @@
+#ifndef CEX_SHA2KERNELS_H
+#define CEX_SHA2KERNELS_H
+
+#include "CexDomain.h"
+#include "SimdProfiles.h"
+
+NAMESPACE_DIGEST
+
+using Enumeration::SimdProfiles;
+
+/// cond private
+
+/// <summary>
+/// Internal class: the multi-lane SHA2 permutations, each built in its own instruction set translation unit.
+/// <para>SHA2Avx2.cpp and SHA2Avx512.cpp are compiled with the AVX2 and AVX512 code generation flags respectively, and each holds its own permutations.
+/// The units are self-contained: the permutations, and the SIMD wrappers they are written with, have internal linkage, and the units include no shared header with instruction set branches.
+/// The input is one message block per lane, laid out one after another; the states are interleaved word arrays, word i of lane j is at State[(i * lanes) + j].
+/// A unit compiled without its instruction set reports the variant as absent, and its functions throw if called.
+/// Callers select a variant at run-time with SimdDispatch::Select(Compiled()).</para>
+/// </summary>
+class SHA2Kernels final
+{
+public:
+
+	/// <summary>
+	/// The widest kernel variant compiled into the library
+	/// </summary>
+	static SimdProfiles Compiled();
+
+	/// <summary>
+	/// The AVX2 kernels were compiled
+	/// </summary>
+	static bool HasAvx2();
+
+	/// <summary>
+	/// The AVX512 kernels were compiled
+	/// </summary>
+	static bool HasAvx512();
+
+	/// <summary>
+	/// The SHA2-256 permutation of 8 * 64 byte blocks into 8 interleaved states (64 words), using AVX2 instructions
+	/// </summary>
+	static void PermuteR64P8x512H(const uint8_t* Input, uint32_t* State);
+
+	/// <summary>
+	/// The SHA2-256 permutation of 16 * 64 byte blocks into 16 interleaved states (128 words), using AVX512 instructions
+	/// </summary>
+	static void PermuteR64P16x512H(const uint8_t* Input, uint32_t* State);
+
+	/// <summary>
+	/// The SHA2-512 permutation of 4 * 128 byte blocks into 4 interleaved states (32 words), using AVX2 instructions
+	/// </summary>
+	static void PermuteR80P4x1024H(const uint8_t* Input, uint64_t* State);
+
+	/// <summary>
+	/// The SHA2-512 permutation of 8 * 128 byte blocks into 8 interleaved states (64 words), using AVX512 instructions
+	/// </summary>
+	static void PermuteR80P8x1024H(const uint8_t* Input, uint64_t* State);
+};
+
+/// endcond
+
+NAMESPACE_DIGESTEND
+#endif
@@ -49,6 +49,8 @@ SHA3256::SHA3256(bool Parallel)
 		KeccakParams(Keccak::KECCAK256_DIGEST_SIZE, 0x00, 0x00))
 {
 	Reset();
+
+	m_parallelProfile.SetAlgorithm(Name());
 }
 
 SHA3256::SHA3256(KeccakParams &Params)
@@ -62,6 +64,8 @@ SHA3256::SHA3256(KeccakParams &Params)
 	m_treeParams(Params)
 {
 	Reset();
+
+	m_parallelProfile.SetAlgorithm(Name());
 }
 
 SHA3256::~SHA3256()
@@ -278,7 +282,7 @@ void SHA3256::Update(const std::vector<uint8_t> &Input, size_t InOffset, size_t
 				}
 
 				// empty the message buffer
-				ParallelTools::ParallelFor(0, m_parallelProfile.ParallelMaxDegree(), [this, &Input, InOffset](size_t i)
+				ParallelTools::ParallelFor(m_parallelProfile, 0, m_parallelProfile.ParallelMaxDegree(), [this, &Input, InOffset](size_t i)
 				{
 					Keccak::FastAbsorb(m_msgBuffer, i * Keccak::KECCAK256_RATE_SIZE, Keccak::KECCAK256_RATE_SIZE, m_dgtState[i].H);
 					Permute(m_dgtState[i].H);
@@ -295,7 +299,7 @@ void SHA3256::Update(const std::vector<uint8_t> &Input, size_t InOffset, size_t
 				const size_t PRCLEN = Length - (Length % m_parallelProfile.ParallelBlockSize());
 
 				// process large blocks
-				ParallelTools::ParallelFor(0, m_parallelProfile.ParallelMaxDegree(), [this, &Input, InOffset, PRCLEN](size_t i)
+				ParallelTools::ParallelFor(m_parallelProfile, 0, m_parallelProfile.ParallelMaxDegree(), [this, &Input, InOffset, PRCLEN](size_t i)
 				{
 					ProcessLeaf(Input, InOffset + (i * Keccak::KECCAK256_RATE_SIZE), m_dgtState[i], PRCLEN);
 				});
@@ -308,7 +312,7 @@ void SHA3256::Update(const std::vector<uint8_t> &Input, size_t InOffset, size_t
 			{
 				const size_t PRMLEN = Length - (Length % m_parallelProfile.ParallelMinimumSize());
 
-				ParallelTools::ParallelFor(0, m_parallelProfile.ParallelMaxDegree(), [this, &Input, InOffset, PRMLEN](size_t i)
+				ParallelTools::ParallelFor(m_parallelProfile, 0, m_parallelProfile.ParallelMaxDegree(), [this, &Input, InOffset, PRMLEN](size_t i)
 				{
 					ProcessLeaf(Input, InOffset + (i * Keccak::KECCAK256_RATE_SIZE), m_dgtState[i], PRMLEN);
 				});
@@ -49,6 +49,8 @@ SHA3512::SHA3512(bool Parallel)
 		KeccakParams(Keccak::KECCAK512_DIGEST_SIZE, 0x00, 0x00))
 {
 	Reset();
+
+	m_parallelProfile.SetAlgorithm(Name());
 }
 
 SHA3512::SHA3512(KeccakParams &Params)
@@ -62,6 +64,8 @@ SHA3512::SHA3512(KeccakParams &Params)
 	m_treeParams(Params)
 {
 	Reset();
+
+	m_parallelProfile.SetAlgorithm(Name());
 }
 
 SHA3512::~SHA3512()
@@ -279,7 +283,7 @@ void SHA3512::Update(const std::vector<uint8_t> &Input, size_t InOffset, size_t
 				}
 
 				// empty the message buffer
-				ParallelTools::ParallelFor(0, m_parallelProfile.ParallelMaxDegree(), [this, &Input, InOffset](size_t i)
+				ParallelTools::ParallelFor(m_parallelProfile, 0, m_parallelProfile.ParallelMaxDegree(), [this, &Input, InOffset](size_t i)
 				{
 					Keccak::FastAbsorb(m_msgBuffer, i * Keccak::KECCAK512_RATE_SIZE, Keccak::KECCAK512_RATE_SIZE, m_dgtState[i].H);
 					Permute(m_dgtState[i].H);
@@ -296,7 +300,7 @@ void SHA3512::Update(const std::vector<uint8_t> &Input, size_t InOffset, size_t
 				const size_t PRCLEN = Length - (Length % m_parallelProfile.ParallelBlockSize());
 
 				// process large blocks
-				ParallelTools::ParallelFor(0, m_parallelProfile.ParallelMaxDegree(), [this, &Input, InOffset, PRCLEN](size_t i)
+				ParallelTools::ParallelFor(m_parallelProfile, 0, m_parallelProfile.ParallelMaxDegree(), [this, &Input, InOffset, PRCLEN](size_t i)
 				{
 					ProcessLeaf(Input, InOffset + (i * Keccak::KECCAK512_RATE_SIZE), m_dgtState[i], PRCLEN);
 				});
@@ -309,7 +313,7 @@ void SHA3512::Update(const std::vector<uint8_t> &Input, size_t InOffset, size_t
 			{
 				const size_t PRMLEN = Length - (Length % m_parallelProfile.ParallelMinimumSize());
 
-				ParallelTools::ParallelFor(0, m_parallelProfile.ParallelMaxDegree(), [this, &Input, InOffset, PRMLEN](size_t i)
+				ParallelTools::ParallelFor(m_parallelProfile, 0, m_parallelProfile.ParallelMaxDegree(), [this, &Input, InOffset, PRMLEN](size_t i)
 				{
 					ProcessLeaf(Input, InOffset + (i * Keccak::KECCAK512_RATE_SIZE), m_dgtState[i], PRMLEN);
 				});
@@ -2,14 +2,8 @@
 #include "Serpent.h"
 #include "IntegerTools.h"
 #include "KdfFromName.h"
-
-#if defined(CEX_HAS_AVX512)
-#	include "UInt512.h"
-#elif defined(CEX_HAS_AVX2)
-#	include "UInt256.h"
-#elif defined(CEX_HAS_AVX)
-#	include "UInt128.h"
-#endif
+#include "SerpentKernels.h"
+#include "SimdDispatch.h"
 
 NAMESPACE_BLOCK
 
@@ -17,6 +11,9 @@ using namespace Cipher::Block::SerpentBase;
 using Tools::IntegerTools;
 using Enumeration::Kdfs;
 using Tools::MemoryTools;
+using Tools::SimdDispatch;
+using Enumeration::SimdKernels;
+using Enumeration::SimdProfiles;
 
 class SHX::ShxState
 {
@@ -187,6 +184,11 @@ void SHX::DecryptBlock(const std::vector<uint8_t> &Input, size_t InOffset, std::
 	Decrypt128(Input, InOffset, Output, OutOffset);
 }
 
+void SHX::DecryptBlock(const uint8_t* Input, uint8_t* Output)
+{
+	Decrypt128(Input, Output);
+}
+
 void SHX::EncryptBlock(const std::vector<uint8_t> &Input, std::vector<uint8_t> &Output)
 {
 	Encrypt128(Input, 0, Output, 0);
@@ -197,6 +199,11 @@ void SHX::EncryptBlock(const std::vector<uint8_t> &Input, size_t InOffset, std::
 	Encrypt128(Input, InOffset, Output, OutOffset);
 }
 
+void SHX::EncryptBlock(const uint8_t* Input, uint8_t* Output)
+{
+	Encrypt128(Input, Output);
+}
+
 void SHX::Initialize(bool Encryption, ISymmetricKey &Parameters)
 {
 	if (!SymmetricKeySize::Contains(LegalKeySizes(), Parameters.KeySizes().KeySize()))
@@ -293,14 +300,19 @@ void SHX::Transform1024(const std::vector<uint8_t> &Input, size_t InOffset, std:
 }
 
 void SHX::Transform2048(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset)
+{
+	Transform2048(Input, InOffset, Output, OutOffset, 16 * BLOCK_SIZE);
+}
+
+void SHX::Transform2048(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length)
 {
 	if (m_shxState->Encryption)
 	{
-		Encrypt2048(Input, InOffset, Output, OutOffset);
+		Encrypt2048(Input, InOffset, Output, OutOffset, Length);
 	}
 	else
 	{
-		Decrypt2048(Input, InOffset, Output, OutOffset);
+		Decrypt2048(Input, InOffset, Output, OutOffset, Length);
 	}
 }
 
@@ -436,7 +448,7 @@ void SHX::StandardExpand(const SecureVector<uint8_t> &Key, std::unique_ptr<ShxSt
 
 //~~~Rounds Processing~~~//
 
-void SHX::Decrypt128(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset)
+void SHX::Decrypt128(const uint8_t* Input, uint8_t* Output)
 {
 	const size_t RNDCNT = 4;
 	size_t kctr;
@@ -447,10 +459,10 @@ void SHX::Decrypt128(const std::vector<uint8_t> &Input, size_t InOffset, std::ve
 
 	// input round
 	kctr = m_shxState->RoundKeys.size();
-	R3 = IntegerTools::LeBytesTo32(Input, InOffset + 12);
-	R2 = IntegerTools::LeBytesTo32(Input, InOffset + 8);
-	R1 = IntegerTools::LeBytesTo32(Input, InOffset + 4);
-	R0 = IntegerTools::LeBytesTo32(Input, InOffset);
+	R3 = IntegerTools::LeBytesTo32Raw(Input + 12);
+	R2 = IntegerTools::LeBytesTo32Raw(Input + 8);
+	R1 = IntegerTools::LeBytesTo32Raw(Input + 4);
+	R0 = IntegerTools::LeBytesTo32Raw(Input);
 	R3 ^= m_shxState->RoundKeys[kctr - 1];
 	R2 ^= m_shxState->RoundKeys[kctr - 2];
 	R1 ^= m_shxState->RoundKeys[kctr - 3];
@@ -526,10 +538,15 @@ void SHX::Decrypt128(const std::vector<uint8_t> &Input, size_t InOffset, std::ve
 	while (kctr != RNDCNT);
 
 	// last round
-	IntegerTools::Le32ToBytes(R3 ^ m_shxState->RoundKeys[kctr - 1], Output, OutOffset + 12);
-	IntegerTools::Le32ToBytes(R2 ^ m_shxState->RoundKeys[kctr - 2], Output, OutOffset + 8);
-	IntegerTools::Le32ToBytes(R1 ^ m_shxState->RoundKeys[kctr - 3], Output, OutOffset + 4);
-	IntegerTools::Le32ToBytes(R0 ^ m_shxState->RoundKeys[kctr - 4], Output, OutOffset);
+	IntegerTools::Le32ToBytesRaw(R3 ^ m_shxState->RoundKeys[kctr - 1], Output + 12);
+	IntegerTools::Le32ToBytesRaw(R2 ^ m_shxState->RoundKeys[kctr - 2], Output + 8);
+	IntegerTools::Le32ToBytesRaw(R1 ^ m_shxState->RoundKeys[kctr - 3], Output + 4);
+	IntegerTools::Le32ToBytesRaw(R0 ^ m_shxState->RoundKeys[kctr - 4], Output);
+}
+
+void SHX::Decrypt128(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset)
+{
+	Decrypt128(Input.data() + InOffset, Output.data() + OutOffset);
 }
 
 void SHX::Decrypt256(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset)
@@ -540,68 +557,44 @@ void SHX::Decrypt256(const std::vector<uint8_t> &Input, size_t InOffset, std::ve
 
 void SHX::Decrypt512(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset)
 {
-#if (!defined(CEX_HAS_AVX512)) && (!defined(CEX_HAS_AVX2)) && defined(CEX_HAS_AVX)
-	DecryptW<Numeric::UInt128>(Input, InOffset, Output, OutOffset, m_shxState->RoundKeys);
-#else
-	Decrypt128(Input, InOffset, Output, OutOffset);
-	Decrypt128(Input, InOffset + 16, Output, OutOffset + 16);
-	Decrypt128(Input, InOffset + 32, Output, OutOffset + 32);
-	Decrypt128(Input, InOffset + 48, Output, OutOffset + 48);
-#endif
+	if (SimdDispatch::Instance().Select(SerpentKernels::Compiled()) >= SimdProfiles::Simd128)
+	{
+		SerpentKernels::Decrypt4x128H(m_shxState->RoundKeys.data(), m_shxState->RoundKeys.size(), Input.data() + InOffset, Output.data() + OutOffset);
+	}
+	else
+	{
+		Decrypt256(Input, InOffset, Output, OutOffset);
+		Decrypt256(Input, InOffset + 32, Output, OutOffset + 32);
+	}
 }
 
 void SHX::Decrypt1024(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset)
 {
-#if (!defined(CEX_HAS_AVX512)) && defined(CEX_HAS_AVX2)
-	DecryptW<Numeric::UInt256>(Input, InOffset, Output, OutOffset, m_shxState->RoundKeys);
-#elif (!defined(CEX_HAS_AVX512)) && (!defined(CEX_HAS_AVX2)) && defined(CEX_HAS_AVX)
-	DecryptW<Numeric::UInt128>(Input, InOffset, Output, OutOffset, m_shxState->RoundKeys);
-	DecryptW<Numeric::UInt128>(Input, InOffset + 64, Output, OutOffset + 64, m_shxState->RoundKeys);
-#else
-	Decrypt128(Input, InOffset, Output, OutOffset);
-	Decrypt128(Input, InOffset + 16, Output, OutOffset + 16);
-	Decrypt128(Input, InOffset + 32, Output, OutOffset + 32);
-	Decrypt128(Input, InOffset + 48, Output, OutOffset + 48);
-	Decrypt128(Input, InOffset + 64, Output, OutOffset + 64);
-	Decrypt128(Input, InOffset + 80, Output, OutOffset + 80);
-	Decrypt128(Input, InOffset + 96, Output, OutOffset + 96);
-	Decrypt128(Input, InOffset + 112, Output, OutOffset + 112);
-#endif
+	if (SimdDispatch::Instance().Select(SerpentKernels::Compiled()) >= SimdProfiles::Simd256)
+	{
+		SerpentKernels::Decrypt8x256H(m_shxState->RoundKeys.data(), m_shxState->RoundKeys.size(), Input.data() + InOffset, Output.data() + OutOffset);
+	}
+	else
+	{
+		Decrypt512(Input, InOffset, Output, OutOffset);
+		Decrypt512(Input, InOffset + 64, Output, OutOffset + 64);
+	}
 }
 
-void SHX::Decrypt2048(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset)
+void SHX::Decrypt2048(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length)
 {
-#if defined(CEX_HAS_AVX512)
-	DecryptW<Numeric::UInt512>(Input, InOffset, Output, OutOffset, m_shxState->RoundKeys);
-#elif (!defined(CEX_HAS_AVX512)) && defined(CEX_HAS_AVX2)
-	DecryptW<Numeric::UInt256>(Input, InOffset, Output, OutOffset, m_shxState->RoundKeys);
-	DecryptW<Numeric::UInt256>(Input, InOffset + 128, Output, OutOffset + 128, m_shxState->RoundKeys);
-#elif (!defined(CEX_HAS_AVX512)) && (!defined(CEX_HAS_AVX2)) && defined(CEX_HAS_AVX)
-	DecryptW<Numeric::UInt128>(Input, InOffset, Output, OutOffset, m_shxState->RoundKeys);
-	DecryptW<Numeric::UInt128>(Input, InOffset + 64, Output, OutOffset + 64, m_shxState->RoundKeys);
-	DecryptW<Numeric::UInt128>(Input, InOffset + 128, Output, OutOffset + 128, m_shxState->RoundKeys);
-	DecryptW<Numeric::UInt128>(Input, InOffset + 192, Output, OutOffset + 192, m_shxState->RoundKeys);
-#else
-	Decrypt128(Input, InOffset, Output, OutOffset);
-	Decrypt128(Input, InOffset + 16, Output, OutOffset + 16);
-	Decrypt128(Input, InOffset + 32, Output, OutOffset + 32);
-	Decrypt128(Input, InOffset + 48, Output, OutOffset + 48);
-	Decrypt128(Input, InOffset + 64, Output, OutOffset + 64);
-	Decrypt128(Input, InOffset + 80, Output, OutOffset + 80);
-	Decrypt128(Input, InOffset + 96, Output, OutOffset + 96);
-	Decrypt128(Input, InOffset + 112, Output, OutOffset + 112);
-	Decrypt128(Input, InOffset + 128, Output, OutOffset + 128);
-	Decrypt128(Input, InOffset + 144, Output, OutOffset + 144);
-	Decrypt128(Input, InOffset + 160, Output, OutOffset + 160);
-	Decrypt128(Input, InOffset + 176, Output, OutOffset + 176);
-	Decrypt128(Input, InOffset + 192, Output, OutOffset + 192);
-	Decrypt128(Input, InOffset + 208, Output, OutOffset + 208);
-	Decrypt128(Input, InOffset + 224, Output, OutOffset + 224);
-	Decrypt128(Input, InOffset + 240, Output, OutOffset + 240);
-#endif
+	if (SimdDispatch::Instance().Select(SerpentKernels::Compiled(), SimdKernels::Serpent, Length) == SimdProfiles::Simd512)
+	{
+		SerpentKernels::Decrypt16x512H(m_shxState->RoundKeys.data(), m_shxState->RoundKeys.size(), Input.data() + InOffset, Output.data() + OutOffset);
+	}
+	else
+	{
+		Decrypt1024(Input, InOffset, Output, OutOffset);
+		Decrypt1024(Input, InOffset + 128, Output, OutOffset + 128);
+	}
 }
 
-void SHX::Encrypt128(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset)
+void SHX::Encrypt128(const uint8_t* Input, uint8_t* Output)
 {
 	const size_t RNDCNT = m_shxState->RoundKeys.size() - 4;
 	size_t kctr;
@@ -612,10 +605,10 @@ void SHX::Encrypt128(const std::vector<uint8_t> &Input, size_t InOffset, std::ve
 
 	// input round
 	kctr = 0;
-	R0 = IntegerTools::LeBytesTo32(Input, InOffset);
-	R1 = IntegerTools::LeBytesTo32(Input, InOffset + 4);
-	R2 = IntegerTools::LeBytesTo32(Input, InOffset + 8);
-	R3 = IntegerTools::LeBytesTo32(Input, InOffset + 12);
+	R0 = IntegerTools::LeBytesTo32Raw(Input);
+	R1 = IntegerTools::LeBytesTo32Raw(Input + 4);
+	R2 = IntegerTools::LeBytesTo32Raw(Input + 8);
+	R3 = IntegerTools::LeBytesTo32Raw(Input + 12);
 
 	// process 8 round blocks
 	do
@@ -685,10 +678,15 @@ void SHX::Encrypt128(const std::vector<uint8_t> &Input, size_t InOffset, std::ve
 	while (kctr != RNDCNT);
 
 	// last round
-	IntegerTools::Le32ToBytes(m_shxState->RoundKeys[kctr] ^ R0, Output, OutOffset);
-	IntegerTools::Le32ToBytes(m_shxState->RoundKeys[kctr + 1] ^ R1, Output, OutOffset + 4);
-	IntegerTools::Le32ToBytes(m_shxState->RoundKeys[kctr + 2] ^ R2, Output, OutOffset + 8);
-	IntegerTools::Le32ToBytes(m_shxState->RoundKeys[kctr + 3] ^ R3, Output, OutOffset + 12);
+	IntegerTools::Le32ToBytesRaw(m_shxState->RoundKeys[kctr] ^ R0, Output);
+	IntegerTools::Le32ToBytesRaw(m_shxState->RoundKeys[kctr + 1] ^ R1, Output + 4);
+	IntegerTools::Le32ToBytesRaw(m_shxState->RoundKeys[kctr + 2] ^ R2, Output + 8);
+	IntegerTools::Le32ToBytesRaw(m_shxState->RoundKeys[kctr + 3] ^ R3, Output + 12);
+}
+
+void SHX::Encrypt128(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset)
+{
+	Encrypt128(Input.data() + InOffset, Output.data() + OutOffset);
 }
 
 void SHX::Encrypt256(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset)
@@ -699,65 +697,41 @@ void SHX::Encrypt256(const std::vector<uint8_t> &Input, size_t InOffset, std::ve
 
 void SHX::Encrypt512(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset)
 {
-#if (!defined(CEX_HAS_AVX512)) && (!defined(CEX_HAS_AVX2)) && defined(CEX_HAS_AVX)
-	EncryptW<Numeric::UInt128>(Input, InOffset, Output, OutOffset, m_shxState->RoundKeys);
-#else
-	Encrypt128(Input, InOffset, Output, OutOffset);
-	Encrypt128(Input, InOffset + 16, Output, OutOffset + 16);
-	Encrypt128(Input, InOffset + 32, Output, OutOffset + 32);
-	Encrypt128(Input, InOffset + 48, Output, OutOffset + 48);
-#endif
+	if (SimdDispatch::Instance().Select(SerpentKernels::Compiled()) >= SimdProfiles::Simd128)
+	{
+		SerpentKernels::Encrypt4x128H(m_shxState->RoundKeys.data(), m_shxState->RoundKeys.size(), Input.data() + InOffset, Output.data() + OutOffset);
+	}
+	else
+	{
+		Encrypt256(Input, InOffset, Output, OutOffset);
+		Encrypt256(Input, InOffset + 32, Output, OutOffset + 32);
+	}
 }
 
 void SHX::Encrypt1024(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset)
 {
-#if (!defined(CEX_HAS_AVX512)) && defined(CEX_HAS_AVX2)
-	EncryptW<Numeric::UInt256>(Input, InOffset, Output, OutOffset, m_shxState->RoundKeys);
-#elif (!defined(CEX_HAS_AVX512)) && (!defined(CEX_HAS_AVX2)) && defined(CEX_HAS_AVX)
-	EncryptW<Numeric::UInt128>(Input, InOffset, Output, OutOffset, m_shxState->RoundKeys);
-	EncryptW<Numeric::UInt128>(Input, InOffset + 64, Output, OutOffset + 64, m_shxState->RoundKeys);
-#else
-	Encrypt128(Input, InOffset, Output, OutOffset);
-	Encrypt128(Input, InOffset + 16, Output, OutOffset + 16);
-	Encrypt128(Input, InOffset + 32, Output, OutOffset + 32);
-	Encrypt128(Input, InOffset + 48, Output, OutOffset + 48);
-	Encrypt128(Input, InOffset + 64, Output, OutOffset + 64);
-	Encrypt128(Input, InOffset + 80, Output, OutOffset + 80);
-	Encrypt128(Input, InOffset + 96, Output, OutOffset + 96);
-	Encrypt128(Input, InOffset + 112, Output, OutOffset + 112);
-#endif
+	if (SimdDispatch::Instance().Select(SerpentKernels::Compiled()) >= SimdProfiles::Simd256)
+	{
+		SerpentKernels::Encrypt8x256H(m_shxState->RoundKeys.data(), m_shxState->RoundKeys.size(), Input.data() + InOffset, Output.data() + OutOffset);
+	}
+	else
+	{
+		Encrypt512(Input, InOffset, Output, OutOffset);
+		Encrypt512(Input, InOffset + 64, Output, OutOffset + 64);
+	}
 }
 
-void SHX::Encrypt2048(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset)
+void SHX::Encrypt2048(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length)
 {
-#if defined(CEX_HAS_AVX512)
-	EncryptW<Numeric::UInt512>(Input, InOffset, Output, OutOffset, m_shxState->RoundKeys);
-#elif (!defined(CEX_HAS_AVX512)) && defined(CEX_HAS_AVX2)
-	EncryptW<Numeric::UInt256>(Input, InOffset, Output, OutOffset, m_shxState->RoundKeys);
-	EncryptW<Numeric::UInt256>(Input, InOffset + 128, Output, OutOffset + 128, m_shxState->RoundKeys);
-#elif (!defined(CEX_HAS_AVX512)) && (!defined(CEX_HAS_AVX2)) && defined(CEX_HAS_AVX)
-	EncryptW<Numeric::UInt128>(Input, InOffset, Output, OutOffset, m_shxState->RoundKeys);
-	EncryptW<Numeric::UInt128>(Input, InOffset + 64, Output, OutOffset + 64, m_shxState->RoundKeys);
-	EncryptW<Numeric::UInt128>(Input, InOffset + 128, Output, OutOffset + 128, m_shxState->RoundKeys);
-	EncryptW<Numeric::UInt128>(Input, InOffset + 192, Output, OutOffset + 192, m_shxState->RoundKeys);
-#else
-	Encrypt128(Input, InOffset, Output, OutOffset);
-	Encrypt128(Input, InOffset + 16, Output, OutOffset + 16);
-	Encrypt128(Input, InOffset + 32, Output, OutOffset + 32);
-	Encrypt128(Input, InOffset + 48, Output, OutOffset + 48);
-	Encrypt128(Input, InOffset + 64, Output, OutOffset + 64);
-	Encrypt128(Input, InOffset + 80, Output, OutOffset + 80);
-	Encrypt128(Input, InOffset + 96, Output, OutOffset + 96);
-	Encrypt128(Input, InOffset + 112, Output, OutOffset + 112);
-	Encrypt128(Input, InOffset + 128, Output, OutOffset + 128);
-	Encrypt128(Input, InOffset + 144, Output, OutOffset + 144);
-	Encrypt128(Input, InOffset + 160, Output, OutOffset + 160);
-	Encrypt128(Input, InOffset + 176, Output, OutOffset + 176);
-	Encrypt128(Input, InOffset + 192, Output, OutOffset + 192);
-	Encrypt128(Input, InOffset + 208, Output, OutOffset + 208);
-	Encrypt128(Input, InOffset + 224, Output, OutOffset + 224);
-	Encrypt128(Input, InOffset + 240, Output, OutOffset + 240);
-#endif
+	if (SimdDispatch::Instance().Select(SerpentKernels::Compiled(), SimdKernels::Serpent, Length) == SimdProfiles::Simd512)
+	{
+		SerpentKernels::Encrypt16x512H(m_shxState->RoundKeys.data(), m_shxState->RoundKeys.size(), Input.data() + InOffset, Output.data() + OutOffset);
+	}
+	else
+	{
+		Encrypt1024(Input, InOffset, Output, OutOffset);
+		Encrypt1024(Input, InOffset + 128, Output, OutOffset + 128);
+	}
 }
 
 //~~~Helper Functions~~~//
@@ -85,6 +85,7 @@ NAMESPACE_BLOCK
 /// <item><description>The internal block-size is fixed at 16 bytes (128 bits) wide.</description></item>
 /// <item><description>The cipher can process 128, 192, and 256-bit keys in standard mode, and 256, 512, and 1024-bit keys in extended mode.</description></item>
 /// <item><description>Transformation rounds assignments are 32 in standard modes, and 40, 48, and 64 rounds (256, 512, and 1024-bit keys).</description></item>
+/// <item><description>The 4, 8, and 16 block transforms use bitsliced AVX, AVX2, or AVX512 kernels, selected at run-time from the widest instruction set supported by the host.</description></item>
 /// <item><description>The Info parameter in a symmetric key container is a user-definable cipher tweak, this can be used to create a unique cipher-text output with a secondary secret.</description></item>
 /// <item><description>Extended mode is set through the constructors BlockCipherExtensions parameter to either None for standard mode, or HKDF(SHA2-256), HKDF(SHA2-512), cSHAKE256, cSHAKE512, or cSHAKE1024 for extended mode operation.</description></item>
 /// <item><description>It is recommended that in extended mode, the key expansion functions security match the key size used; ex. with a 256-bit key use SHAKE-256, or HKDF(SHA2-512) for a 512-bit key.</description></item>
@@ -228,6 +229,16 @@ public:
 	/// <param name="OutOffset">Starting offset within the output array</param>
 	void DecryptBlock(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset) override;
 
+	/// <summary>
+	/// Decrypt a block of bytes in the callers memory.
+	/// <para><see cref="Initialize(bool, ISymmetricKey)"/> must be called with the Encryption flag set to <c>false</c> before this method can be used.
+	/// Input and Output must point to at least <see cref="BlockSize"/> bytes, and may be the same address.</para>
+	/// </summary>
+	/// 
+	/// <param name="Input">A pointer to the encrypted bytes</param>
+	/// <param name="Output">A pointer to the decrypted bytes</param>
+	void DecryptBlock(const uint8_t* Input, uint8_t* Output) override;
+
 	/// <summary>
 	/// Encrypt a block of bytes.
 	/// <para><see cref="Initialize(bool, ISymmetricKey)"/> must be called with the Encryption flag set to <c>true</c> before this method can be used.
@@ -250,6 +261,16 @@ public:
 	/// <param name="OutOffset">Starting offset within the output array</param>
 	void EncryptBlock(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset) override;
 
+	/// <summary>
+	/// Encrypt a block of bytes in the callers memory.
+	/// <para><see cref="Initialize(bool, ISymmetricKey)"/> must be called with the Encryption flag set to <c>true</c> before this method can be used.
+	/// Input and Output must point to at least <see cref="BlockSize"/> bytes, and may be the same address.</para>
+	/// </summary>
+	/// 
+	/// <param name="Input">A pointer to the bytes to transform</param>
+	/// <param name="Output">A pointer to the transformed bytes</param>
+	void EncryptBlock(const uint8_t* Input, uint8_t* Output) override;
+
 	/// <summary>
 	/// Initialize the cipher with a populated SymmetricKey or SymmetricSecureKey container
 	/// </summary>
@@ -331,22 +352,38 @@ public:
 	/// <param name="OutOffset">Starting offset in the output array</param>
 	virtual void Transform2048(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset) override;
 
+	/// <summary>
+	/// Transform 16 blocks of bytes, as part of a longer message.
+	/// <para><see cref="Initialize(bool, ISymmetricKey)"/> must be called before this method can be used.
+	/// Input and Output array lengths must be at least 16 * <see cref="BlockSize"/> in length.
+	/// The message length selects the kernel width; the 512-bit kernels are only used when it reaches the wide threshold set in SimdDispatch.</para>
+	/// </summary>
+	/// 
+	/// <param name="Input">The input array of bytes to transform</param>
+	/// <param name="InOffset">Starting offset in the Input array</param>
+	/// <param name="Output">The output array of transformed bytes</param>
+	/// <param name="OutOffset">Starting offset in the output array</param>
+	/// <param name="Length">The number of bytes in the message being transformed by the caller</param>
+	virtual void Transform2048(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length) override;
+
 private:
 
 	static std::vector<SymmetricKeySize> CalculateKeySizes(BlockCipherExtensions Extension);
 	static void SecureExpand(const SecureVector<uint8_t> &Key, std::unique_ptr<ShxState> &State, std::unique_ptr<IKdf> &Generator);
 	static void StandardExpand(const SecureVector<uint8_t> &Key, std::unique_ptr<ShxState> &State);
 
+	void Decrypt128(const uint8_t* Input, uint8_t* Output);
 	void Decrypt128(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset);
 	void Decrypt256(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset);
 	void Decrypt512(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset);
 	void Decrypt1024(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset);
-	void Decrypt2048(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset);
+	void Decrypt2048(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length);
+	void Encrypt128(const uint8_t* Input, uint8_t* Output);
 	void Encrypt128(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset);
 	void Encrypt256(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset);
 	void Encrypt512(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset);
 	void Encrypt1024(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset);
-	void Encrypt2048(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset);
+	void Encrypt2048(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length);
 
 };
 
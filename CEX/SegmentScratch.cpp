@@ -0,0 +1,121 @@
+#include "SegmentScratch.h"
+#include "IntegerTools.h"
+#include "MemoryTools.h"
+
+NAMESPACE_TOOLS
+
+//~~~Constructor~~~//
+
+SegmentScratch::SegmentScratch()
+	:
+	m_inputBuffer(0),
+	m_outputBuffer(0)
+{
+}
+
+SegmentScratch::~SegmentScratch()
+{
+	Clear();
+	m_inputBuffer.clear();
+	m_outputBuffer.clear();
+}
+
+//~~~Public Functions~~~//
+
+void SegmentScratch::Absorb(const uint8_t* Input, size_t Length, size_t SegmentSize, const std::function<void(const std::vector<uint8_t> &Input, size_t Length)> &Function)
+{
+	const size_t SEGLEN = SegmentLength(SegmentSize, Length);
+	size_t oft;
+	size_t prclen;
+
+	if (Length != 0)
+	{
+		Reserve(m_inputBuffer, SEGLEN);
+		oft = 0;
+
+		while (oft != Length)
+		{
+			prclen = IntegerTools::Min(SEGLEN, Length - oft);
+			MemoryTools::CopyRaw(Input + oft, m_inputBuffer.data(), prclen);
+			Function(m_inputBuffer, prclen);
+			oft += prclen;
+		}
+
+		MemoryTools::Clear(m_inputBuffer, 0, SEGLEN);
+	}
+}
+
+void SegmentScratch::Clear()
+{
+	MemoryTools::Clear(m_inputBuffer, 0, m_inputBuffer.size());
+	MemoryTools::Clear(m_outputBuffer, 0, m_outputBuffer.size());
+}
+
+void SegmentScratch::Keystream(const uint8_t* Input, uint8_t* Output, size_t Length, size_t SegmentSize, const std::function<void(std::vector<uint8_t> &Output, size_t Length)> &Function)
+{
+	const size_t SEGLEN = SegmentLength(SegmentSize, Length);
+	size_t oft;
+	size_t prclen;
+
+	if (Length != 0)
+	{
+		Reserve(m_outputBuffer, SEGLEN);
+		oft = 0;
+
+		while (oft != Length)
+		{
+			prclen = IntegerTools::Min(SEGLEN, Length - oft);
+			Function(m_outputBuffer, prclen);
+			// the message is read and written once
+			MemoryTools::XorRaw(Input + oft, m_outputBuffer.data(), Output + oft, prclen);
+			oft += prclen;
+		}
+
+		MemoryTools::Clear(m_outputBuffer, 0, SEGLEN);
+	}
+}
+
+void SegmentScratch::Stage(const uint8_t* Input, uint8_t* Output, size_t Length, size_t SegmentSize, const std::function<void(const std::vector<uint8_t> &Input, std::vector<uint8_t> &Output, size_t Length)> &Function)
+{
+	const size_t SEGLEN = SegmentLength(SegmentSize, Length);
+	size_t oft;
+	size_t prclen;
+
+	if (Length != 0)
+	{
+		Reserve(m_inputBuffer, SEGLEN);
+		Reserve(m_outputBuffer, SEGLEN);
+		oft = 0;
+
+		while (oft != Length)
+		{
+			prclen = IntegerTools::Min(SEGLEN, Length - oft);
+			MemoryTools::CopyRaw(Input + oft, m_inputBuffer.data(), prclen);
+			Function(m_inputBuffer, m_outputBuffer, prclen);
+			MemoryTools::CopyRaw(m_outputBuffer.data(), Output + oft, prclen);
+			oft += prclen;
+		}
+
+		MemoryTools::Clear(m_inputBuffer, 0, SEGLEN);
+		MemoryTools::Clear(m_outputBuffer, 0, SEGLEN);
+	}
+}
+
+//~~~Private Functions~~~//
+
+void SegmentScratch::Reserve(std::vector<uint8_t> &Buffer, size_t Length)
+{
+	if (Buffer.size() < Length)
+	{
+		MemoryTools::Clear(Buffer, 0, Buffer.size());
+		Buffer.clear();
+		Buffer.resize(Length, 0x00);
+	}
+}
+
+size_t SegmentScratch::SegmentLength(size_t SegmentSize, size_t Length)
+{
+	return IntegerTools::Min((SegmentSize != 0) ? SegmentSize : DEF_SEGMENTSIZE, Length);
+}
+
+NAMESPACE_TOOLSEND
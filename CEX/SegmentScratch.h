@@ -0,0 +1,104 @@
+#ifndef CEX_SEGMENTSCRATCH_H
+#define CEX_SEGMENTSCRATCH_H
+
+#include "CexDomain.h"
+#include <functional>
+
+NAMESPACE_TOOLS
+
+/// cond private
+
+/// <summary>
+/// Internal class: the working buffers of the pointer based transforms, reused across calls.
+/// <para>The key-stream generators operate on vectors; a pointer transform generates the key-stream in segments, and combines each segment with the message in a single pass,
+/// writing input xor key-stream directly to the callers memory, so the message is neither copied nor read twice.
+/// The chained modes and the MAC functions work directly on the callers memory; staging is kept only for the transforms whose wide kernels are vector based (ECB),
+/// and for authenticators that have no pointer core (HMAC, Poly1305). \n
+/// The segment size is a multiple of the cipher block size, normally the parallel block size, so a segmented transform produces the same output as a single vector transform.
+/// The buffers are allocated on first use and grow only when a larger segment is requested; the bytes used by a call are erased before it returns.</para>
+/// </summary>
+class SegmentScratch final
+{
+private:
+
+	static const size_t DEF_SEGMENTSIZE = 16384;
+
+	std::vector<uint8_t> m_inputBuffer;
+	std::vector<uint8_t> m_outputBuffer;
+
+public:
+
+	//~~~Constructor~~~//
+
+	/// <summary>
+	/// Copy constructor: copy is restricted, this function has been deleted
+	/// </summary>
+	SegmentScratch(const SegmentScratch&) = delete;
+
+	/// <summary>
+	/// Copy operator: copy is restricted, this function has been deleted
+	/// </summary>
+	SegmentScratch& operator=(const SegmentScratch&) = delete;
+
+	/// <summary>
+	/// Constructor: instantiate an empty scratch set
+	/// </summary>
+	SegmentScratch();
+
+	/// <summary>
+	/// Destructor: erase and release the buffers
+	/// </summary>
+	~SegmentScratch();
+
+	//~~~Public Functions~~~//
+
+	/// <summary>
+	/// Pass a length of the callers memory to a function in segments, copied to the input buffer
+	/// </summary>
+	///
+	/// <param name="Input">The input bytes</param>
+	/// <param name="Length">The number of bytes to process</param>
+	/// <param name="SegmentSize">The segment size in bytes, a multiple of the block size; zero selects the default size</param>
+	/// <param name="Function">Processes the first Length bytes of the input vector</param>
+	void Absorb(const uint8_t* Input, size_t Length, size_t SegmentSize, const std::function<void(const std::vector<uint8_t> &Input, size_t Length)> &Function);
+
+	/// <summary>
+	/// Erase the contents of the buffers; the memory is retained
+	/// </summary>
+	void Clear();
+
+	/// <summary>
+	/// XOR a length of the callers memory with key-stream generated in segments.
+	/// <para>The function writes the bare key-stream to the buffer, and each segment is combined as Output = Input ^ key-stream in one pass.
+	/// Input and Output may be the same address; the regions must not otherwise overlap.</para>
+	/// </summary>
+	///
+	/// <param name="Input">The input bytes</param>
+	/// <param name="Output">The output bytes</param>
+	/// <param name="Length">The number of bytes to transform</param>
+	/// <param name="SegmentSize">The segment size in bytes, a multiple of the block size; zero selects the default size</param>
+	/// <param name="Function">Writes Length bytes of key-stream to the start of the vector</param>
+	void Keystream(const uint8_t* Input, uint8_t* Output, size_t Length, size_t SegmentSize, const std::function<void(std::vector<uint8_t> &Output, size_t Length)> &Function);
+
+	/// <summary>
+	/// Transform a length of the callers memory in segments staged through the input and output buffers.
+	/// <para>Input and Output may be the same address; the regions must not otherwise overlap.</para>
+	/// </summary>
+	///
+	/// <param name="Input">The input bytes</param>
+	/// <param name="Output">The output bytes</param>
+	/// <param name="Length">The number of bytes to transform</param>
+	/// <param name="SegmentSize">The segment size in bytes, a multiple of the block size; zero selects the default size</param>
+	/// <param name="Function">Transforms the first Length bytes of the input vector to the output vector</param>
+	void Stage(const uint8_t* Input, uint8_t* Output, size_t Length, size_t SegmentSize, const std::function<void(const std::vector<uint8_t> &Input, std::vector<uint8_t> &Output, size_t Length)> &Function);
+
+private:
+
+	static void Reserve(std::vector<uint8_t> &Buffer, size_t Length);
+	static size_t SegmentLength(size_t SegmentSize, size_t Length);
+};
+
+/// endcond
+
+NAMESPACE_TOOLSEND
+#endif
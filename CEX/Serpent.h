@@ -20,7 +20,6 @@
 #define CEX_SERPENT_H
 
 #include "CexDomain.h"
-#include "IntegerTools.h"
 
 NAMESPACE_SERPENTBASE
 
@@ -28,22 +27,59 @@ NAMESPACE_SERPENTBASE
 /// internal
 /// 
 
-using Tools::IntegerTools;
+// this header is included by the instruction set units; it has no dependencies beyond the domain types and no instruction set branches,
+// and every function is a template with internal linkage, so each unit compiles a private copy for the instruction set it is built with
 
-template<typename T, typename ArrayA, typename ArrayB>
-static void DecryptW(const ArrayA &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, ArrayB &Key)
-{
-#if defined(CEX_HAS_AVX) || defined(CEX_HAS_AVX2) || defined(CEX_HAS_AVX512)
+// the wide transforms are defined before the round functions they call
+template<typename T>
+static void LinearTransformW(T &R0, T &R1, T &R2, T &R3);
+template<typename T>
+static void InverseTransformW(T &R0, T &R1, T &R2, T &R3);
+template<typename T>
+static void Sb0(T &R0, T &R1, T &R2, T &R3);
+template<typename T>
+static void Sb1(T &R0, T &R1, T &R2, T &R3);
+template<typename T>
+static void Sb2(T &R0, T &R1, T &R2, T &R3);
+template<typename T>
+static void Sb3(T &R0, T &R1, T &R2, T &R3);
+template<typename T>
+static void Sb4(T &R0, T &R1, T &R2, T &R3);
+template<typename T>
+static void Sb5(T &R0, T &R1, T &R2, T &R3);
+template<typename T>
+static void Sb6(T &R0, T &R1, T &R2, T &R3);
+template<typename T>
+static void Sb7(T &R0, T &R1, T &R2, T &R3);
+template<typename T>
+static void Ib0(T &R0, T &R1, T &R2, T &R3);
+template<typename T>
+static void Ib1(T &R0, T &R1, T &R2, T &R3);
+template<typename T>
+static void Ib2(T &R0, T &R1, T &R2, T &R3);
+template<typename T>
+static void Ib3(T &R0, T &R1, T &R2, T &R3);
+template<typename T>
+static void Ib4(T &R0, T &R1, T &R2, T &R3);
+template<typename T>
+static void Ib5(T &R0, T &R1, T &R2, T &R3);
+template<typename T>
+static void Ib6(T &R0, T &R1, T &R2, T &R3);
+template<typename T>
+static void Ib7(T &R0, T &R1, T &R2, T &R3);
 
+template<typename T>
+static void DecryptW(const uint8_t* Input, uint8_t* Output, const uint32_t* Key, size_t KeyCount)
+{
 	const size_t RNDCNT = 4;
 	const size_t INPOFF = T::size();
-	size_t kctr = Key.size();
+	size_t kctr = KeyCount;
 
 	// input round
-	T R0(Input, InOffset);
-	T R1(Input, InOffset + INPOFF);
-	T R2(Input, InOffset + (INPOFF * 2));
-	T R3(Input, InOffset + (INPOFF * 3));
+	T R0(Input, 0);
+	T R1(Input, INPOFF);
+	T R2(Input, INPOFF * 2);
+	T R3(Input, INPOFF * 3);
 	T::Transpose(R0, R1, R2, R3);
 
 	--kctr;
@@ -164,28 +200,24 @@ static void DecryptW(const ArrayA &Input, size_t InOffset, std::vector<uint8_t>
 	R0 ^= T(Key[kctr]);
 
 	T::Transpose(R0, R1, R2, R3);
-	R0.Store(Output, OutOffset);
-	R1.Store(Output, OutOffset + INPOFF);
-	R2.Store(Output, OutOffset + (INPOFF * 2));
-	R3.Store(Output, OutOffset + (INPOFF * 3));
-
-#endif
+	R0.Store(Output, 0);
+	R1.Store(Output, INPOFF);
+	R2.Store(Output, INPOFF * 2);
+	R3.Store(Output, INPOFF * 3);
 }
 
-template<typename T, typename ArrayA, typename ArrayB>
-static void EncryptW(const ArrayA &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, ArrayB &Key)
+template<typename T>
+static void EncryptW(const uint8_t* Input, uint8_t* Output, const uint32_t* Key, size_t KeyCount)
 {
-#if defined(CEX_HAS_AVX) || defined(CEX_HAS_AVX2) || defined(CEX_HAS_AVX512)
-
-	const size_t RNDCNT = Key.size() - 5;
+	const size_t RNDCNT = KeyCount - 5;
 	const size_t INPOFF = T::size();
 	int32_t kctr = -1;
 
 	// input round
-	T R0(Input, InOffset);
-	T R1(Input, InOffset + INPOFF);
-	T R2(Input, InOffset + (INPOFF * 2));
-	T R3(Input, InOffset + (INPOFF * 3));
+	T R0(Input, 0);
+	T R1(Input, INPOFF);
+	T R2(Input, INPOFF * 2);
+	T R3(Input, INPOFF * 3);
 	T::Transpose(R0, R1, R2, R3);
 
 	// process 8 round blocks
@@ -297,27 +329,25 @@ static void EncryptW(const ArrayA &Input, size_t InOffset, std::vector<uint8_t>
 	R3 ^= T(Key[kctr]);
 
 	T::Transpose(R0, R1, R2, R3);
-	R0.Store(Output, OutOffset);
-	R1.Store(Output, OutOffset + INPOFF);
-	R2.Store(Output, OutOffset + (INPOFF * 2));
-	R3.Store(Output, OutOffset + (INPOFF * 3));
-
-#endif
+	R0.Store(Output, 0);
+	R1.Store(Output, INPOFF);
+	R2.Store(Output, INPOFF * 2);
+	R3.Store(Output, INPOFF * 3);
 }
 
 template<typename T>
 static void LinearTransform(T &R0, T &R1, T &R2, T &R3)
 {
-	R0 = IntegerTools::RotL32(R0, 13);
-	R2 = IntegerTools::RotL32(R2, 3);
+	R0 = (R0 << 13) | (R0 >> 19);
+	R2 = (R2 << 3) | (R2 >> 29);
 	R1 ^= R0 ^ R2;
 	R3 ^= R2 ^ (R0 << 3);
-	R1 = IntegerTools::RotL32(R1, 1);
-	R3 = IntegerTools::RotL32(R3, 7);
+	R1 = (R1 << 1) | (R1 >> 31);
+	R3 = (R3 << 7) | (R3 >> 25);
 	R0 ^= R1 ^ R3;
 	R2 ^= R3 ^ (R1 << 7);
-	R0 = IntegerTools::RotL32(R0, 5);
-	R2 = IntegerTools::RotL32(R2, 22);
+	R0 = (R0 << 5) | (R0 >> 27);
+	R2 = (R2 << 22) | (R2 >> 10);
 }
 
 template<typename T>
@@ -338,16 +368,16 @@ static void LinearTransformW(T &R0, T &R1, T &R2, T &R3)
 template<typename T>
 static void InverseTransform(T &R0, T &R1, T &R2, T &R3)
 {
-	R2 = IntegerTools::RotR32(R2, 22);
-	R0 = IntegerTools::RotR32(R0, 5);
+	R2 = (R2 >> 22) | (R2 << 10);
+	R0 = (R0 >> 5) | (R0 << 27);
 	R2 ^= R3 ^ (R1 << 7);
 	R0 ^= R1 ^ R3;
-	R3 = IntegerTools::RotR32(R3, 7);
-	R1 = IntegerTools::RotR32(R1, 1);
+	R3 = (R3 >> 7) | (R3 << 25);
+	R1 = (R1 >> 1) | (R1 << 31);
 	R3 ^= R2 ^ (R0 << 3);
 	R1 ^= R0 ^ R2;
-	R2 = IntegerTools::RotR32(R2, 3);
-	R0 = IntegerTools::RotR32(R0, 13);
+	R2 = (R2 >> 3) | (R2 << 29);
+	R0 = (R0 >> 13) | (R0 << 19);
 }
 
 template<typename T>
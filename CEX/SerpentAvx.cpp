@@ -0,0 +1,56 @@
+#include "SerpentKernels.h"
+#if defined(CEX_HAS_AVX)
+#	include "Serpent.h"
+#	include "UInt128.h"
+#else
+#	include "CryptoSymmetricException.h"
+#endif
+
+NAMESPACE_BLOCK
+
+// this unit is compiled with the AVX code generation flag; it includes no shared header with instruction set branches,
+// and the transforms and the SIMD wrappers they use have internal linkage, so no inline code compiled here can be linked into another unit
+
+#if defined(CEX_HAS_AVX)
+using namespace Cipher::Block::SerpentBase;
+#else
+using Exception::CryptoSymmetricException;
+using Enumeration::ErrorCodes;
+#endif
+
+SimdProfiles SerpentKernels::Compiled()
+{
+	return HasAvx512() ? SimdProfiles::Simd512 :
+		HasAvx2() ? SimdProfiles::Simd256 :
+		HasAvx() ? SimdProfiles::Simd128 :
+		SimdProfiles::None;
+}
+
+bool SerpentKernels::HasAvx()
+{
+#if defined(CEX_HAS_AVX)
+	return true;
+#else
+	return false;
+#endif
+}
+
+void SerpentKernels::Decrypt4x128H(const uint32_t* RoundKeys, size_t KeyCount, const uint8_t* Input, uint8_t* Output)
+{
+#if defined(CEX_HAS_AVX)
+	DecryptW<Numeric::UInt128>(Input, Output, RoundKeys, KeyCount);
+#else
+	throw CryptoSymmetricException(std::string("SerpentKernels"), std::string("Decrypt4x128H"), std::string("The AVX kernel was not compiled!"), ErrorCodes::NotSupported);
+#endif
+}
+
+void SerpentKernels::Encrypt4x128H(const uint32_t* RoundKeys, size_t KeyCount, const uint8_t* Input, uint8_t* Output)
+{
+#if defined(CEX_HAS_AVX)
+	EncryptW<Numeric::UInt128>(Input, Output, RoundKeys, KeyCount);
+#else
+	throw CryptoSymmetricException(std::string("SerpentKernels"), std::string("Encrypt4x128H"), std::string("The AVX kernel was not compiled!"), ErrorCodes::NotSupported);
+#endif
+}
+
+NAMESPACE_BLOCKEND
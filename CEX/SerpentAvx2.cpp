@@ -0,0 +1,48 @@
+#include "SerpentKernels.h"
+#if defined(CEX_HAS_AVX2)
+#	include "Serpent.h"
+#	include "UInt256.h"
+#else
+#	include "CryptoSymmetricException.h"
+#endif
+
+NAMESPACE_BLOCK
+
+// this unit is compiled with the AVX2 code generation flag; it includes no shared header with instruction set branches,
+// and the transforms and the SIMD wrappers they use have internal linkage, so no inline code compiled here can be linked into another unit
+
+#if defined(CEX_HAS_AVX2)
+using namespace Cipher::Block::SerpentBase;
+#else
+using Exception::CryptoSymmetricException;
+using Enumeration::ErrorCodes;
+#endif
+
+bool SerpentKernels::HasAvx2()
+{
+#if defined(CEX_HAS_AVX2)
+	return true;
+#else
+	return false;
+#endif
+}
+
+void SerpentKernels::Decrypt8x256H(const uint32_t* RoundKeys, size_t KeyCount, const uint8_t* Input, uint8_t* Output)
+{
+#if defined(CEX_HAS_AVX2)
+	DecryptW<Numeric::UInt256>(Input, Output, RoundKeys, KeyCount);
+#else
+	throw CryptoSymmetricException(std::string("SerpentKernels"), std::string("Decrypt8x256H"), std::string("The AVX2 kernel was not compiled!"), ErrorCodes::NotSupported);
+#endif
+}
+
+void SerpentKernels::Encrypt8x256H(const uint32_t* RoundKeys, size_t KeyCount, const uint8_t* Input, uint8_t* Output)
+{
+#if defined(CEX_HAS_AVX2)
+	EncryptW<Numeric::UInt256>(Input, Output, RoundKeys, KeyCount);
+#else
+	throw CryptoSymmetricException(std::string("SerpentKernels"), std::string("Encrypt8x256H"), std::string("The AVX2 kernel was not compiled!"), ErrorCodes::NotSupported);
+#endif
+}
+
+NAMESPACE_BLOCKEND
@@ -0,0 +1,48 @@
+#include "SerpentKernels.h"
+#if defined(CEX_HAS_AVX512)
+#	include "Serpent.h"
+#	include "UInt512.h"
+#else
+#	include "CryptoSymmetricException.h"
+#endif
+
+NAMESPACE_BLOCK
+
+// this unit is compiled with the AVX512 code generation flag; it includes no shared header with instruction set branches,
+// and the transforms and the SIMD wrappers they use have internal linkage, so no inline code compiled here can be linked into another unit
+
+#if defined(CEX_HAS_AVX512)
+using namespace Cipher::Block::SerpentBase;
+#else
+using Exception::CryptoSymmetricException;
+using Enumeration::ErrorCodes;
+#endif
+
+bool SerpentKernels::HasAvx512()
+{
+#if defined(CEX_HAS_AVX512)
+	return true;
+#else
+	return false;
+#endif
+}
+
+void SerpentKernels::Decrypt16x512H(const uint32_t* RoundKeys, size_t KeyCount, const uint8_t* Input, uint8_t* Output)
+{
+#if defined(CEX_HAS_AVX512)
+	DecryptW<Numeric::UInt512>(Input, Output, RoundKeys, KeyCount);
+#else
+	throw CryptoSymmetricException(std::string("SerpentKernels"), std::string("Decrypt16x512H"), std::string("The AVX512 kernel was not compiled!"), ErrorCodes::NotSupported);
+#endif
+}
+
+void SerpentKernels::Encrypt16x512H(const uint32_t* RoundKeys, size_t KeyCount, const uint8_t* Input, uint8_t* Output)
+{
+#if defined(CEX_HAS_AVX512)
+	EncryptW<Numeric::UInt512>(Input, Output, RoundKeys, KeyCount);
+#else
+	throw CryptoSymmetricException(std::string("SerpentKernels"), std::string("Encrypt16x512H"), std::string("The AVX512 kernel was not compiled!"), ErrorCodes::NotSupported);
+#endif
+}
+
+NAMESPACE_BLOCKEND
@@ -0,0 +1,81 @@
+#ifndef CEX_SERPENTKERNELS_H
+#define CEX_SERPENTKERNELS_H
+
+#include "CexDomain.h"
+#include "SimdProfiles.h"
+
+NAMESPACE_BLOCK
+
+using Enumeration::SimdProfiles;
+
+/// cond private
+
+/// <summary>
+/// Internal class: the wide Serpent transforms, processing 4, 8 or 16 blocks with AVX, AVX2 or AVX512 instructions.
+/// <para>SerpentAvx.cpp, SerpentAvx2.cpp and SerpentAvx512.cpp are compiled with their own code generation flags, and instantiate the Serpent wide templates for a 128, 256 or 512-bit register.
+/// The units are self-contained: the transforms have internal linkage, and the units include no shared header with instruction set branches. 
+/// The round keys are passed as a pointer to KeyCount 32-bit words, and the blocks are read and written unaligned.
+/// The blocks are transposed so that each register holds one 32-bit word of every block; the S-boxes are then evaluated as boolean circuits on all of the blocks at once,
+/// and the linear transform and round keys are applied lane-wise.
+/// A unit compiled without its instruction set reports the variant as absent, and its functions throw if called.
+/// SHX selects a variant at run-time with SimdDispatch::Select(Compiled()), and the 512-bit variant with SimdDispatch::Select(Compiled(), SimdKernels::Serpent, Length).</para>
+/// </summary>
+class SerpentKernels final
+{
+public:
+
+	/// <summary>
+	/// The widest kernel variant compiled into the library
+	/// </summary>
+	static SimdProfiles Compiled();
+
+	/// <summary>
+	/// The AVX kernels were compiled
+	/// </summary>
+	static bool HasAvx();
+
+	/// <summary>
+	/// The AVX2 kernels were compiled
+	/// </summary>
+	static bool HasAvx2();
+
+	/// <summary>
+	/// The AVX512 kernels were compiled
+	/// </summary>
+	static bool HasAvx512();
+
+	/// <summary>
+	/// Decrypt 4 blocks using AVX instructions
+	/// </summary>
+	static void Decrypt4x128H(const uint32_t* RoundKeys, size_t KeyCount, const uint8_t* Input, uint8_t* Output);
+
+	/// <summary>
+	/// Decrypt 8 blocks using AVX2 instructions
+	/// </summary>
+	static void Decrypt8x256H(const uint32_t* RoundKeys, size_t KeyCount, const uint8_t* Input, uint8_t* Output);
+
+	/// <summary>
+	/// Decrypt 16 blocks using AVX512 instructions
+	/// </summary>
+	static void Decrypt16x512H(const uint32_t* RoundKeys, size_t KeyCount, const uint8_t* Input, uint8_t* Output);
+
+	/// <summary>
+	/// Encrypt 4 blocks using AVX instructions
+	/// </summary>
+	static void Encrypt4x128H(const uint32_t* RoundKeys, size_t KeyCount, const uint8_t* Input, uint8_t* Output);
+
+	/// <summary>
+	/// Encrypt 8 blocks using AVX2 instructions
+	/// </summary>
+	static void Encrypt8x256H(const uint32_t* RoundKeys, size_t KeyCount, const uint8_t* Input, uint8_t* Output);
+
+	/// <summary>
+	/// Encrypt 16 blocks using AVX512 instructions
+	/// </summary>
+	static void Encrypt16x512H(const uint32_t* RoundKeys, size_t KeyCount, const uint8_t* Input, uint8_t* Output);
+};
+
+/// endcond
+
+NAMESPACE_BLOCKEND
+#endif
@@ -0,0 +1,171 @@
+#include "SimdDispatch.h"
+#include "CpuDetect.h"
+#include <cstdlib>
+
+NAMESPACE_TOOLS
+
+const std::string SimdDispatch::PROFILE_VARIABLE("CEX_SIMD_PROFILE");
+const std::string SimdDispatch::THRESHOLD_VARIABLE("CEX_SIMD_WIDE_THRESHOLD");
+
+//~~~Constructor~~~//
+
+SimdDispatch::SimdDispatch()
+	:
+	m_simdDetected(Detect()),
+	m_simdProfile(SimdProfiles::None),
+	m_wideThresholds()
+{
+	std::string prf;
+	size_t i;
+
+	Reset();
+
+	// allow the startup profile to be lowered via environment variable
+	if (const char* env = std::getenv(PROFILE_VARIABLE.c_str()))
+	{
+		prf = std::string(env);
+
+		if (prf == "none")
+		{
+			SetProfile(SimdProfiles::None);
+		}
+		else if (prf == "avx")
+		{
+			SetProfile(SimdProfiles::Simd128);
+		}
+		else if (prf == "avx2")
+		{
+			SetProfile(SimdProfiles::Simd256);
+		}
+		else if (prf == "avx512")
+		{
+			SetProfile(SimdProfiles::Simd512);
+		}
+		else
+		{
+			// misra
+		}
+	}
+
+	// allow the wide thresholds to be set via environment variable
+	if (const char* env = std::getenv(THRESHOLD_VARIABLE.c_str()))
+	{
+		for (i = 0; i < KERNEL_COUNT; ++i)
+		{
+			m_wideThresholds[i] = static_cast<size_t>(std::strtoull(env, nullptr, 10));
+		}
+	}
+}
+
+SimdDispatch::~SimdDispatch()
+{
+	m_simdDetected = SimdProfiles::None;
+	m_simdProfile = SimdProfiles::None;
+
+	for (size_t i = 0; i < KERNEL_COUNT; ++i)
+	{
+		m_wideThresholds[i] = 0;
+	}
+}
+
+//~~~Accessors~~~//
+
+SimdProfiles SimdDispatch::Detected()
+{
+	return m_simdDetected;
+}
+
+SimdProfiles SimdDispatch::Profile()
+{
+	return m_simdProfile;
+}
+
+//~~~Public Functions~~~//
+
+SimdDispatch& SimdDispatch::Instance()
+{
+	static SimdDispatch dsp;
+
+	return dsp;
+}
+
+void SimdDispatch::Reset()
+{
+	size_t i;
+
+	m_simdProfile = m_simdDetected;
+
+	for (i = 0; i < KERNEL_COUNT; ++i)
+	{
+		m_wideThresholds[i] = DEF_WIDETHRESHOLD;
+	}
+}
+
+SimdProfiles SimdDispatch::Select(SimdProfiles Compiled)
+{
+	const SimdProfiles ACTPRF = m_simdProfile;
+
+	return (static_cast<uint8_t>(Compiled) < static_cast<uint8_t>(ACTPRF)) ? Compiled : ACTPRF;
+}
+
+SimdProfiles SimdDispatch::Select(SimdProfiles Compiled, SimdKernels Kernel, size_t Length)
+{
+	SimdProfiles prf;
+
+	prf = Select(Compiled);
+
+	// small calls do not pay the frequency cost of the 512-bit kernels
+	if (prf == SimdProfiles::Simd512 && Length < m_wideThresholds[static_cast<size_t>(Kernel)])
+	{
+		prf = SimdProfiles::Simd256;
+	}
+
+	return prf;
+}
+
+void SimdDispatch::SetProfile(SimdProfiles Profile)
+{
+	m_simdProfile = (static_cast<uint8_t>(Profile) > static_cast<uint8_t>(m_simdDetected)) ? m_simdDetected : Profile;
+}
+
+void SimdDispatch::SetWideThreshold(SimdKernels Kernel, size_t Length)
+{
+	m_wideThresholds[static_cast<size_t>(Kernel)] = Length;
+}
+
+size_t SimdDispatch::WideThreshold(SimdKernels Kernel)
+{
+	return m_wideThresholds[static_cast<size_t>(Kernel)];
+}
+
+//~~~Private Functions~~~//
+
+SimdProfiles SimdDispatch::Detect()
+{
+	CpuDetect &dtc = CpuDetect::Instance();
+	SimdProfiles prf;
+
+	prf = SimdProfiles::None;
+
+#if defined(CEX_ARCH_X86_X64)
+	// the processor flags alone are not sufficient, the os must also save the extended register state
+	if (CpuDetect::AvxEnabled() && dtc.AVX())
+	{
+		prf = SimdProfiles::Simd128;
+
+		if (dtc.AVX2())
+		{
+			prf = SimdProfiles::Simd256;
+
+			if (dtc.AVX512F() && CpuDetect::Avx512Enabled())
+			{
+				prf = SimdProfiles::Simd512;
+			}
+		}
+	}
+#endif
+
+	return prf;
+}
+
+NAMESPACE_TOOLSEND
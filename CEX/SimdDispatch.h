@@ -0,0 +1,155 @@
+// The GPL version 3 License (GPLv3)
+//
+// Copyright (c) 2023 QSCS.ca
+// This file is part of the CEX Cryptographic library.
+//
+// This program is free software : you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef CEX_SIMDDISPATCH_H
+#define CEX_SIMDDISPATCH_H
+
+#include "CexDomain.h"
+#include "SimdKernels.h"
+#include "SimdProfiles.h"
+#include <array>
+#include <atomic>
+
+NAMESPACE_TOOLS
+
+using Enumeration::SimdKernels;
+using Enumeration::SimdProfiles;
+
+/// <summary>
+/// The process-wide run-time selector for the SIMD kernel variants.
+/// <para>The widest instruction set supported by both the processor and the operating system is detected once, on first use, from the cached CpuDetect features.
+/// Kernel families built in per-ISA translation units call Select(SimdProfiles) with the widest variant compiled into the library, 
+/// so a single binary runs the AVX512 kernels on hosts that support them, and the AVX2 or AVX kernels on older hosts. \n
+/// The active profile can be lowered with SetProfile(SimdProfiles), or at startup with the CEX_SIMD_PROFILE environment variable 
+/// (none, avx, avx2 or avx512), to compare the kernel variants on one machine; it can never be raised above the detected profile.</para>
+/// <para>The 512-bit kernels can lower the core clock for some time after they run, which slows everything else scheduled on that core. 
+/// Each kernel family has a wide threshold: a call that processes fewer bytes than the threshold uses the 256-bit kernel, and only larger calls use the 512-bit kernel. 
+/// The thresholds are set with SetWideThreshold(SimdKernels, size_t), or for every family at startup with the CEX_SIMD_WIDE_THRESHOLD environment variable, 
+/// and can be measured on the host with the SIMD threshold benchmark in the cipher speed tests.</para>
+/// </summary>
+///
+/// <example>
+/// <description>Benchmarking a cipher with the AVX2 kernels on an AVX512 host:</description>
+/// <code>
+/// SimdDispatch::Instance().SetProfile(SimdProfiles::Simd256);
+/// // ... run the benchmark
+/// SimdDispatch::Instance().Reset();
+/// </code>
+/// </example>
+class SimdDispatch final
+{
+private:
+
+	static const std::string PROFILE_VARIABLE;
+	static const std::string THRESHOLD_VARIABLE;
+	static const size_t KERNEL_COUNT = 5;
+	// a single call must process at least 16KB before the 512-bit kernels are used
+	static const size_t DEF_WIDETHRESHOLD = 16384;
+
+	SimdProfiles m_simdDetected;
+	std::atomic<SimdProfiles> m_simdProfile;
+	std::array<std::atomic<size_t>, KERNEL_COUNT> m_wideThresholds;
+
+	SimdDispatch(const SimdDispatch&) = delete;
+
+	SimdDispatch& operator=(const SimdDispatch&) = delete;
+
+	SimdDispatch();
+
+	~SimdDispatch();
+
+public:
+
+	//~~~Accessors~~~//
+
+	/// <summary>
+	/// Read Only: The widest SIMD profile supported by the processor and enabled by the operating system
+	/// </summary>
+	SimdProfiles Detected();
+
+	/// <summary>
+	/// Read Only: The active SIMD profile used to select the kernel variants
+	/// </summary>
+	SimdProfiles Profile();
+
+	//~~~Public Functions~~~//
+
+	/// <summary>
+	/// Get the process-wide dispatch instance
+	/// </summary>
+	static SimdDispatch& Instance();
+
+	/// <summary>
+	/// Restore the active profile to the detected profile, and the wide thresholds to their defaults
+	/// </summary>
+	void Reset();
+
+	/// <summary>
+	/// Get the kernel variant to run for a kernel family
+	/// </summary>
+	///
+	/// <param name="Compiled">The widest variant of the kernel family compiled into the library</param>
+	///
+	/// <returns>The narrower of the active profile and the compiled variant</returns>
+	SimdProfiles Select(SimdProfiles Compiled);
+
+	/// <summary>
+	/// Get the kernel variant to run for a call that processes Length bytes.
+	/// <para>If the selected variant is 512-bit, and Length is less than the families wide threshold, the 256-bit variant is returned.</para>
+	/// </summary>
+	///
+	/// <param name="Compiled">The widest variant of the kernel family compiled into the library</param>
+	/// <param name="Kernel">The kernel family</param>
+	/// <param name="Length">The number of bytes the call processes</param>
+	///
+	/// <returns>The kernel variant to run</returns>
+	SimdProfiles Select(SimdProfiles Compiled, SimdKernels Kernel, size_t Length);
+
+	/// <summary>
+	/// Set the active SIMD profile.
+	/// <para>A profile wider than the detected profile is reduced to the detected profile.</para>
+	/// </summary>
+	///
+	/// <param name="Profile">The SIMD profile used by subsequent kernel calls</param>
+	void SetProfile(SimdProfiles Profile);
+
+	/// <summary>
+	/// Set the smallest call length, in bytes, that uses the 512-bit variant of a kernel family
+	/// </summary>
+	///
+	/// <param name="Kernel">The kernel family</param>
+	/// <param name="Length">The threshold in bytes; zero always uses the 512-bit variant</param>
+	void SetWideThreshold(SimdKernels Kernel, size_t Length);
+
+	/// <summary>
+	/// Get the smallest call length, in bytes, that uses the 512-bit variant of a kernel family
+	/// </summary>
+	///
+	/// <param name="Kernel">The kernel family</param>
+	///
+	/// <returns>The threshold in bytes</returns>
+	size_t WideThreshold(SimdKernels Kernel);
+
+private:
+
+	static SimdProfiles Detect();
+};
+
+NAMESPACE_TOOLSEND
+#endif
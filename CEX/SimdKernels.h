@@ -0,0 +1,36 @@
+#ifndef CEX_SIMDKERNELS_H
+#define CEX_SIMDKERNELS_H
+
+#include "CexDomain.h"
+
+NAMESPACE_ENUMERATION
+
+/// <summary>
+/// The kernel families selected at run-time by the SIMD dispatcher
+/// </summary>
+enum class SimdKernels : uint8_t
+{
+	/// <summary>
+	/// The ChaCha-256 wide permutations used by ChaChaP20
+	/// </summary>
+	ChaCha256 = 0,
+	/// <summary>
+	/// The ChaCha-512 wide permutations used by CSX512
+	/// </summary>
+	ChaCha512 = 1,
+	/// <summary>
+	/// The Threefish wide permutations used by TSX256, TSX512 and TSX1024
+	/// </summary>
+	Threefish = 2,
+	/// <summary>
+	/// The Rijndael VAES round functions used by RHX
+	/// </summary>
+	Rijndael = 3,
+	/// <summary>
+	/// The Serpent wide transforms used by SHX
+	/// </summary>
+	Serpent = 4
+};
+
+NAMESPACE_ENUMERATIONEND
+#endif
@@ -61,6 +61,8 @@ Skein1024::Skein1024(bool Parallel)
 		SkeinParams(Skein::SKEIN1024_DIGEST_SIZE, 0x00, 0x00))
 {
 	Initialize(m_dgtState, m_treeParams);
+
+	m_parallelProfile.SetAlgorithm(Name());
 }
 
 Skein1024::Skein1024(SkeinParams &Params)
@@ -74,6 +76,8 @@ Skein1024::Skein1024(SkeinParams &Params)
 	m_treeParams(Params)
 {
 	Initialize(m_dgtState, m_treeParams);
+
+	m_parallelProfile.SetAlgorithm(Name());
 }
 
 Skein1024::~Skein1024()
@@ -282,7 +286,7 @@ void Skein1024::Update(const std::vector<uint8_t> &Input, size_t InOffset, size_
 				}
 
 				// empty the message buffer
-				ParallelTools::ParallelFor(0, m_parallelProfile.ParallelMaxDegree(), [this, &Input, InOffset](size_t i)
+				ParallelTools::ParallelFor(m_parallelProfile, 0, m_parallelProfile.ParallelMaxDegree(), [this, &Input, InOffset](size_t i)
 				{
 					ProcessBlock(m_msgBuffer, i * Skein::SKEIN1024_RATE_SIZE, m_dgtState[i], Skein::SKEIN1024_RATE_SIZE);
 				});
@@ -298,7 +302,7 @@ void Skein1024::Update(const std::vector<uint8_t> &Input, size_t InOffset, size_
 				const size_t PRCLEN = Length - (Length % m_parallelProfile.ParallelBlockSize());
 
 				// process large blocks
-				ParallelTools::ParallelFor(0, m_parallelProfile.ParallelMaxDegree(), [this, &Input, InOffset, PRCLEN](size_t i)
+				ParallelTools::ParallelFor(m_parallelProfile, 0, m_parallelProfile.ParallelMaxDegree(), [this, &Input, InOffset, PRCLEN](size_t i)
 				{
 					ProcessLeaf(Input, InOffset + (i * Skein::SKEIN1024_RATE_SIZE), m_dgtState[i], PRCLEN);
 				});
@@ -311,7 +315,7 @@ void Skein1024::Update(const std::vector<uint8_t> &Input, size_t InOffset, size_
 			{
 				const size_t PRMLEN = Length - (Length % m_parallelProfile.ParallelMinimumSize());
 
-				ParallelTools::ParallelFor(0, m_parallelProfile.ParallelMaxDegree(), [this, &Input, InOffset, PRMLEN](size_t i)
+				ParallelTools::ParallelFor(m_parallelProfile, 0, m_parallelProfile.ParallelMaxDegree(), [this, &Input, InOffset, PRMLEN](size_t i)
 				{
 					ProcessLeaf(Input, InOffset + (i * Skein::SKEIN1024_RATE_SIZE), m_dgtState[i], PRMLEN);
 				});
@@ -60,6 +60,8 @@ Skein256::Skein256(bool Parallel)
 		SkeinParams(Skein::SKEIN256_DIGEST_SIZE, 0x00, 0x00))
 {
 	Initialize(m_dgtState, m_treeParams);
+
+	m_parallelProfile.SetAlgorithm(Name());
 }
 
 Skein256::Skein256(SkeinParams &Params)
@@ -73,6 +75,8 @@ Skein256::Skein256(SkeinParams &Params)
 	m_treeParams(Params)
 {
 	Initialize(m_dgtState, m_treeParams);
+
+	m_parallelProfile.SetAlgorithm(Name());
 }
 
 Skein256::~Skein256()
@@ -277,7 +281,7 @@ void Skein256::Update(const std::vector<uint8_t> &Input, size_t InOffset, size_t
 				}
 
 				// empty the message buffer
-				ParallelTools::ParallelFor(0, m_parallelProfile.ParallelMaxDegree(), [this, &Input, InOffset](size_t i)
+				ParallelTools::ParallelFor(m_parallelProfile, 0, m_parallelProfile.ParallelMaxDegree(), [this, &Input, InOffset](size_t i)
 				{
 					ProcessBlock(m_msgBuffer, i * Skein::SKEIN256_RATE_SIZE, m_dgtState[i], Skein::SKEIN256_RATE_SIZE);
 				});
@@ -293,7 +297,7 @@ void Skein256::Update(const std::vector<uint8_t> &Input, size_t InOffset, size_t
 				const size_t PRCLEN = Length - (Length % m_parallelProfile.ParallelBlockSize());
 
 				// process large blocks
-				ParallelTools::ParallelFor(0, m_parallelProfile.ParallelMaxDegree(), [this, &Input, InOffset, PRCLEN](size_t i)
+				ParallelTools::ParallelFor(m_parallelProfile, 0, m_parallelProfile.ParallelMaxDegree(), [this, &Input, InOffset, PRCLEN](size_t i)
 				{
 					ProcessLeaf(Input, InOffset + (i * Skein::SKEIN256_RATE_SIZE), m_dgtState[i], PRCLEN);
 				});
@@ -306,7 +310,7 @@ void Skein256::Update(const std::vector<uint8_t> &Input, size_t InOffset, size_t
 			{
 				const size_t PRMLEN = Length - (Length % m_parallelProfile.ParallelMinimumSize());
 
-				ParallelTools::ParallelFor(0, m_parallelProfile.ParallelMaxDegree(), [this, &Input, InOffset, PRMLEN](size_t i)
+				ParallelTools::ParallelFor(m_parallelProfile, 0, m_parallelProfile.ParallelMaxDegree(), [this, &Input, InOffset, PRMLEN](size_t i)
 				{
 					ProcessLeaf(Input, InOffset + (i * Skein::SKEIN256_RATE_SIZE), m_dgtState[i], PRMLEN);
 				});
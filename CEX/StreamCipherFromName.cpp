@@ -22,7 +22,7 @@ const std::string StreamCipherFromName::CLASS_NAME("StreamCipherFromName");
 IStreamCipher* StreamCipherFromName::GetInstance(StreamCiphers StreamCipherType)
 {
 	IStreamCipher* cptr;
-	CpuDetect dtc;
+	CpuDetect &dtc = CpuDetect::Instance();
 
 	cptr = nullptr;
 
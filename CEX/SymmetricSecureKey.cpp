@@ -580,7 +580,7 @@ IStreamCipher* SymmetricSecureKey::GetStreamCipher(SecurityPolicy Policy)
 void SymmetricSecureKey::GetSystemKey(SecurityPolicy Policy, const SecureVector<uint8_t> &Salt, SecureVector<uint8_t> &Output)
 {
 	std::vector<uint8_t> cust(0);
-	CpuDetect dtc;
+	CpuDetect &dtc = CpuDetect::Instance();
 	ShakeModes mode;
 
 	ArrayTools::AppendString(SystemTools::ComputerName(), cust);
@@ -122,8 +122,8 @@ bool SystemTools::HasRdRand()
 {
 	if (!HAS_RDRAND)
 	{
-#if defined(CEX_HAS_AVX)
-		CpuDetect dtc;
+#if defined(CEX_HAS_RDRAND)
+		CpuDetect &dtc = CpuDetect::Instance();
 		HAS_RDRAND = dtc.RDRAND();
 #else
 		HAS_RDRAND = false;
@@ -137,8 +137,8 @@ bool SystemTools::HasRdtsc()
 {
 	if (!TMR_RDTSC)
 	{
-#if defined(CEX_HAS_AVX)
-		CpuDetect dtc;
+#if defined(CEX_ARCH_X86_X64)
+		CpuDetect &dtc = CpuDetect::Instance();
 		TMR_RDTSC = dtc.RDTSCP();
 #else
 		TMR_RDTSC = false;
@@ -3,12 +3,11 @@
 #include "KMAC.h"
 #include "MemoryTools.h"
 #include "ParallelTools.h"
+#include "SegmentScratch.h"
 #include "SHAKE.h"
+#include "SimdDispatch.h"
 #include "Threefish.h"
-
-#if defined(CEX_HAS_AVX2)
-#	include "ULong256.h"
-#endif
+#include "ThreefishKernels.h"
 
 NAMESPACE_STREAM
 
@@ -16,6 +15,10 @@ using Tools::IntegerTools;
 using Mac::KMAC;
 using Tools::MemoryTools;
 using Tools::ParallelTools;
+using Tools::SegmentScratch;
+using Enumeration::SimdKernels;
+using Enumeration::SimdProfiles;
+using Tools::SimdDispatch;
 
 const std::string TSX512::CLASS_NAME("TSX512");
 const std::vector<uint8_t> TSX512::OMEGA_INFO = { 0x54, 0x68, 0x72, 0x65, 0x65, 0x66, 0x69, 0x73, 0x68, 0x50, 0x35, 0x31, 0x32, 0x52, 0x39, 0x36 };
@@ -26,12 +29,14 @@ public:
 
 	std::array<uint64_t, 8> Key = { 0 };
 	std::array<uint64_t, 2> Nonce = { 0 };
+	std::array<uint64_t, 2> Origin = { 0 };
 	std::array<uint64_t, 2> Tweak = { 0 };
 	SecureVector<uint8_t> Custom;
 	std::vector<SymmetricKeySize> LegalKeySizes{
 		SymmetricKeySize(IK512_SIZE, NONCE_SIZE * sizeof(uint64_t), INFO_SIZE) };
 	SecureVector<uint8_t> MacKey;
 	SecureVector<uint8_t> MacTag;
+	SegmentScratch Segments;
 	uint64_t Counter = 0;
 	bool IsAuthenticated = false;
 	bool IsEncryption = false;
@@ -51,6 +56,7 @@ public:
 		LegalKeySizes.clear();
 		MemoryTools::Clear(Key, 0, Key.size() * sizeof(uint64_t));
 		MemoryTools::Clear(Nonce, 0, Nonce.size() * sizeof(uint64_t));
+		MemoryTools::Clear(Origin, 0, Origin.size() * sizeof(uint64_t));
 		MemoryTools::Clear(Tweak, 0, Tweak.size() * sizeof(uint64_t));
 		MemoryTools::Clear(Custom, 0, Custom.size());
 		MemoryTools::Clear(MacKey, 0, MacKey.size());
@@ -65,10 +71,12 @@ public:
 	{
 		MemoryTools::Clear(Key, 0, Key.size() * sizeof(uint64_t));
 		MemoryTools::Clear(Nonce, 0, Nonce.size() * sizeof(uint64_t));
+		MemoryTools::Clear(Origin, 0, Origin.size() * sizeof(uint64_t));
 		MemoryTools::Clear(Tweak, 0, Tweak.size() * sizeof(uint64_t));
 		MemoryTools::Clear(Custom, 0, Custom.size());
 		MemoryTools::Clear(MacKey, 0, MacKey.size());
 		MemoryTools::Clear(MacTag, 0, MacTag.size());
+		Segments.Clear();
 		Counter = 0;
 		IsEncryption = false;
 		IsInitialized = false;
@@ -83,6 +91,7 @@ TSX512::TSX512(bool Authenticate)
 	m_macAuthenticator(nullptr),
 	m_parallelProfile(BLOCK_SIZE, true, STATE_PRECACHED, true)
 {
+	m_parallelProfile.SetAlgorithm(Name());
 }
 
 TSX512::~TSX512()
@@ -224,6 +233,8 @@ void TSX512::Initialize(bool Encryption, ISymmetricKey &Parameters)
 	// copy nonce
 	m_tsx512State->Nonce[0] = IntegerTools::LeBytesTo64(Parameters.IV(), 0);
 	m_tsx512State->Nonce[1] = IntegerTools::LeBytesTo64(Parameters.IV(), 8);
+	m_tsx512State->Origin[0] = m_tsx512State->Nonce[0];
+	m_tsx512State->Origin[1] = m_tsx512State->Nonce[1];
 
 	if (Parameters.KeySizes().InfoSize() != 0)
 	{
@@ -307,6 +318,25 @@ void TSX512::ParallelMaxDegree(size_t Degree)
 	m_parallelProfile.SetMaxDegree(Degree);
 }
 
+void TSX512::Seek(uint64_t Position)
+{
+	if (IsInitialized() == false)
+	{
+		throw CryptoSymmetricException(Name(), std::string("Seek"), std::string("The cipher has not been initialized!"), ErrorCodes::NotInitialized);
+	}
+	if (IsAuthenticator() == true)
+	{
+		throw CryptoSymmetricException(Name(), std::string("Seek"), std::string("The key-stream position can not be set in authentication mode!"), ErrorCodes::IllegalOperation);
+	}
+	if (Position % BLOCK_SIZE != 0)
+	{
+		throw CryptoSymmetricException(Name(), std::string("Seek"), std::string("The position must be aligned to the block size!"), ErrorCodes::InvalidParam);
+	}
+
+	// the counter is the initial nonce increased by the block index
+	IntegerTools::LeIncreaseW(m_tsx512State->Origin, m_tsx512State->Nonce, static_cast<size_t>(Position / BLOCK_SIZE));
+}
+
 void TSX512::SetAssociatedData(const std::vector<uint8_t> &Input, size_t Offset, size_t Length)
 {
 	if (IsInitialized() == false)
@@ -332,6 +362,31 @@ void TSX512::SetAssociatedData(const std::vector<uint8_t> &Input, size_t Offset,
 	}
 }
 
+void TSX512::SetAssociatedData(const uint8_t* Input, size_t Length)
+{
+	if (IsInitialized() == false)
+	{
+		throw CryptoSymmetricException(Name(), std::string("SetAssociatedData"), std::string("The cipher has not been initialized!"), ErrorCodes::NotInitialized);
+	}
+	if (IsAuthenticator() == false)
+	{
+		throw CryptoSymmetricException(Name(), std::string("SetAssociatedData"), std::string("The cipher has not been configured for authentication!"), ErrorCodes::IllegalOperation);
+	}
+	if (Length == 0)
+	{
+		throw CryptoSymmetricException(Name(), std::string("SetAssociatedData"), std::string("The additional data array can not be zero sized!"), ErrorCodes::InvalidSize);
+	}
+
+	if (IsAuthenticator() == true)
+	{
+		std::vector<uint8_t> code(sizeof(uint32_t));
+		// version 1.1a add AD and encoding to hash
+		static_cast<KMAC*>(m_macAuthenticator.get())->Update(Input, Length);
+		IntegerTools::Le32ToBytes(static_cast<uint32_t>(Length), code, 0);
+		m_macAuthenticator->Update(code, 0, code.size());
+	}
+}
+
 void TSX512::Transform(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length)
 {
 	if (IsEncryption() == true)
@@ -347,7 +402,7 @@ void TSX512::Transform(const std::vector<uint8_t> &Input, size_t InOffset, std::
 			m_macAuthenticator->Update(IntegerTools::Le64ToBytes<std::vector<uint8_t>>(m_tsx512State->Nonce[0]), 0, sizeof(uint64_t));
 			m_macAuthenticator->Update(IntegerTools::Le64ToBytes<std::vector<uint8_t>>(m_tsx512State->Nonce[1]), 0, sizeof(uint64_t));
 			// encrypt the stream
-			Process(Input, InOffset, Output, OutOffset, Length);
+			Process(Input.data(), InOffset, Output, OutOffset, Length);
 			// update the mac with the ciphertext
 			m_macAuthenticator->Update(Output, OutOffset, Length);
 			// update the mac counter
@@ -359,7 +414,7 @@ void TSX512::Transform(const std::vector<uint8_t> &Input, size_t InOffset, std::
 		else
 		{
 			// encrypt the stream
-			Process(Input, InOffset, Output, OutOffset, Length);
+			Process(Input.data(), InOffset, Output, OutOffset, Length);
 		}
 	}
 	else
@@ -383,7 +438,97 @@ void TSX512::Transform(const std::vector<uint8_t> &Input, size_t InOffset, std::
 		}
 
 		// decrypt the stream
-		Process(Input, InOffset, Output, OutOffset, Length);
+		Process(Input.data(), InOffset, Output, OutOffset, Length);
+	}
+}
+
+void TSX512::Transform(const uint8_t* Input, uint8_t* Output, size_t Length)
+{
+	// the key-stream is generated in segments, and combined with the callers memory in a single pass
+	auto gen = [this](std::vector<uint8_t> &Target, size_t Count)
+	{
+		Process(nullptr, 0, Target, 0, Count);
+	};
+
+	if (IsEncryption() == true)
+	{
+		if (IsAuthenticator() == true)
+		{
+			// add the starting position of the nonce
+			m_macAuthenticator->Update(IntegerTools::Le64ToBytes<std::vector<uint8_t>>(m_tsx512State->Nonce[0]), 0, sizeof(uint64_t));
+			m_macAuthenticator->Update(IntegerTools::Le64ToBytes<std::vector<uint8_t>>(m_tsx512State->Nonce[1]), 0, sizeof(uint64_t));
+			// encrypt the stream
+			m_tsx512State->Segments.Keystream(Input, Output, Length, ParallelBlockSize(), gen);
+			// update the mac with the ciphertext
+			static_cast<KMAC*>(m_macAuthenticator.get())->Update(Output, Length);
+			// update the mac counter
+			m_tsx512State->Counter += Length;
+			// finalize the mac and add the tag to the stream
+			Finalize(m_tsx512State, m_macAuthenticator);
+			MemoryTools::CopyRaw(m_tsx512State->MacTag.data(), Output + Length, m_tsx512State->MacTag.size());
+		}
+		else
+		{
+			// encrypt the stream
+			m_tsx512State->Segments.Keystream(Input, Output, Length, ParallelBlockSize(), gen);
+		}
+	}
+	else
+	{
+		if (IsAuthenticator() == true)
+		{
+			// add the starting position of the nonce
+			m_macAuthenticator->Update(IntegerTools::Le64ToBytes<std::vector<uint8_t>>(m_tsx512State->Nonce[0]), 0, sizeof(uint64_t));
+			m_macAuthenticator->Update(IntegerTools::Le64ToBytes<std::vector<uint8_t>>(m_tsx512State->Nonce[1]), 0, sizeof(uint64_t));
+			// update the mac with the ciphertext
+			static_cast<KMAC*>(m_macAuthenticator.get())->Update(Input, Length);
+			// update the mac counter
+			m_tsx512State->Counter += Length;
+			// finalize the mac and verify
+			Finalize(m_tsx512State, m_macAuthenticator);
+
+			if (IntegerTools::CompareRaw(Input + Length, m_tsx512State->MacTag.data(), m_tsx512State->MacTag.size()) == false)
+			{
+				throw CryptoAuthenticationFailure(Name(), std::string("Transform"), std::string("The authentication tag does not match!"), ErrorCodes::AuthenticationFailure);
+			}
+		}
+
+		// decrypt the stream
+		m_tsx512State->Segments.Keystream(Input, Output, Length, ParallelBlockSize(), gen);
+	}
+}
+
+void TSX512::TransformAt(uint64_t Position, const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length)
+{
+	CEXASSERT(IntegerTools::Min(Input.size() - InOffset, Output.size() - OutOffset) >= Length, "The data arrays are smaller than the length!");
+
+	const size_t HDRLEN = static_cast<size_t>(Position % BLOCK_SIZE);
+	size_t i;
+	size_t prclen;
+
+	Seek(Position - HDRLEN);
+
+	if (HDRLEN != 0 && Length != 0)
+	{
+		// the position is inside a block; use the tail of that blocks key-stream
+		std::vector<uint8_t> otp(BLOCK_SIZE);
+		prclen = IntegerTools::Min(BLOCK_SIZE - HDRLEN, Length);
+		Generate(m_tsx512State, m_tsx512State->Nonce, otp, 0, BLOCK_SIZE);
+
+		for (i = 0; i < prclen; ++i)
+		{
+			Output[OutOffset + i] = Input[InOffset + i] ^ otp[HDRLEN + i];
+		}
+
+		MemoryTools::Clear(otp, 0, otp.size());
+		InOffset += prclen;
+		OutOffset += prclen;
+		Length -= prclen;
+	}
+
+	if (Length != 0)
+	{
+		Process(Input.data(), InOffset, Output, OutOffset, Length);
 	}
 }
 
@@ -403,15 +548,15 @@ void TSX512::Finalize(std::unique_ptr<TSX512State> &State, std::unique_ptr<IMac>
 
 void TSX512::Generate(std::unique_ptr<TSX512State> &State, std::array<uint64_t, 2> &Counter, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length)
 {
+	const SimdProfiles SMDPRF = SimdDispatch::Instance().Select(ThreefishKernels::Compiled(), SimdKernels::Threefish, Length);
+	const size_t AVX512BLK = 8 * BLOCK_SIZE;
+	const size_t AVX2BLK = 4 * BLOCK_SIZE;
 	size_t ctr;
 
 	ctr = 0;
 
-#if defined(CEX_HAS_AVX512)
-
-	const size_t AVX512BLK = 8 * BLOCK_SIZE;
-
-	if (Length >= AVX512BLK)
+	// the widest kernel the host and the library both support, 256-bit below the wide threshold
+	if (SMDPRF == SimdProfiles::Simd512 && Length >= AVX512BLK)
 	{
 		const size_t SEGALN = Length - (Length % AVX512BLK);
 		std::array<uint64_t, 16> ctr16;
@@ -444,17 +589,12 @@ void TSX512::Generate(std::unique_ptr<TSX512State> &State, std::array<uint64_t,
 			MemoryTools::Copy(Counter, 0, ctr16, 7, 8);
 			MemoryTools::Copy(Counter, 1, ctr16, 15, 8);
 			IntegerTools::LeIncrementW(Counter);
-			Threefish::PemuteP8x512H(State->Key, ctr16, State->Tweak, tmp64, ROUND_COUNT);
+			ThreefishKernels::PemuteP8x512H(State->Key.data(), ctr16.data(), State->Tweak.data(), tmp64.data(), ROUND_COUNT);
 			MemoryTools::Copy(tmp64, 0, Output, OutOffset + ctr, AVX512BLK);
 			ctr += AVX512BLK;
 		}
 	}
-
-#elif defined(CEX_HAS_AVX2)
-
-	const size_t AVX2BLK = 4 * BLOCK_SIZE;
-
-	if (Length >= AVX2BLK)
+	else if (SMDPRF == SimdProfiles::Simd256 && Length >= AVX2BLK)
 	{
 		const size_t SEGALN = Length - (Length % AVX2BLK);
 		std::array<uint64_t, 8> ctr8;
@@ -475,14 +615,12 @@ void TSX512::Generate(std::unique_ptr<TSX512State> &State, std::array<uint64_t,
 			MemoryTools::Copy(Counter, 0, ctr8, 3, 8);
 			MemoryTools::Copy(Counter, 1, ctr8, 7, 8);
 			IntegerTools::LeIncrementW(Counter);
-			Threefish::PemuteP4x512H(State->Key, ctr8, State->Tweak, tmp32, ROUND_COUNT);
+			ThreefishKernels::PemuteP4x512H(State->Key.data(), ctr8.data(), State->Tweak.data(), tmp32.data(), ROUND_COUNT);
 			MemoryTools::Copy(tmp32, 0, Output, OutOffset + ctr, AVX2BLK);
 			ctr += AVX2BLK;
 		}
 	}
 
-#endif
-
 	const size_t ALNLEN = Length - (Length % BLOCK_SIZE);
 	std::array<uint64_t, 8> tmp;
 
@@ -511,29 +649,20 @@ void TSX512::Generate(std::unique_ptr<TSX512State> &State, std::array<uint64_t,
 	}
 }
 
-void TSX512::Process(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length)
+void TSX512::Process(const uint8_t* Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length)
 {
+	// a null input writes the bare key-stream, which the pointer transform combines with the callers memory
 	const size_t PRCLEN = Length;
 
 	if (!m_parallelProfile.IsParallel() || PRCLEN < m_parallelProfile.ParallelMinimumSize())
 	{
 		// generate random
 		Generate(m_tsx512State, m_tsx512State->Nonce, Output, OutOffset, PRCLEN);
-		// output is input ^ random
-		const size_t ALNLEN = PRCLEN - (PRCLEN % BLOCK_SIZE);
-
-		if (ALNLEN != 0)
-		{
-			MemoryTools::XOR(Input, InOffset, Output, OutOffset, ALNLEN);
-		}
 
-		// process the remaining bytes
-		if (ALNLEN != PRCLEN)
+		// output is input ^ random
+		if (Input != nullptr && PRCLEN != 0)
 		{
-			for (size_t i = ALNLEN; i < PRCLEN; ++i)
-			{
-				Output[i + OutOffset] ^= Input[i + InOffset];
-			}
+			MemoryTools::XorRaw(Input + InOffset, Output.data() + OutOffset, PRCLEN);
 		}
 	}
 	else
@@ -542,9 +671,9 @@ void TSX512::Process(const std::vector<uint8_t> &Input, size_t InOffset, std::ve
 		const size_t CNKLEN = (PRCLEN / BLOCK_SIZE / m_parallelProfile.ParallelMaxDegree()) * BLOCK_SIZE;
 		const size_t ALNLEN = CNKLEN * m_parallelProfile.ParallelMaxDegree();
 		const size_t CTROFT = (CNKLEN / BLOCK_SIZE);
-		std::vector<uint64_t> tmpCtr(NONCE_SIZE);
+		std::array<uint64_t, NONCE_SIZE> tmpCtr;
 
-		ParallelTools::ParallelFor(0, m_parallelProfile.ParallelMaxDegree(), [this, &Input, InOffset, &Output, OutOffset, &tmpCtr, CNKLEN, CTROFT](size_t i)
+		ParallelTools::ParallelFor(m_parallelProfile, Output.data() + OutOffset, 0, m_parallelProfile.ParallelMaxDegree(), [this, Input, InOffset, &Output, OutOffset, &tmpCtr, CNKLEN, CTROFT](size_t i)
 		{
 			// thread level counter
 			std::array<uint64_t, NONCE_SIZE> thdCtr;
@@ -553,8 +682,13 @@ void TSX512::Process(const std::vector<uint8_t> &Input, size_t InOffset, std::ve
 			const size_t STMPOS = i * CNKLEN;
 			// create random at offset position
 			this->Generate(m_tsx512State, thdCtr, Output, OutOffset + STMPOS, CNKLEN);
+
 			// xor with input at offset
-			MemoryTools::XOR(Input, InOffset + STMPOS, Output, OutOffset + STMPOS, CNKLEN);
+			if (Input != nullptr)
+			{
+				MemoryTools::XorRaw(Input + InOffset + STMPOS, Output.data() + OutOffset + STMPOS, CNKLEN);
+			}
+
 			// store last counter
 			if (i == m_parallelProfile.ParallelMaxDegree() - 1)
 			{
@@ -574,9 +708,9 @@ void TSX512::Process(const std::vector<uint8_t> &Input, size_t InOffset, std::ve
 
 			Generate(m_tsx512State, m_tsx512State->Nonce, Output, OutOffset, FNLLEN);
 
-			for (size_t i = 0; i < FNLLEN; ++i)
+			if (Input != nullptr)
 			{
-				Output[OutOffset + i] ^= Input[InOffset + i];
+				MemoryTools::XorRaw(Input + InOffset, Output.data() + OutOffset, FNLLEN);
 			}
 		}
 	}
@@ -0,0 +1,323 @@
+#include "ThreadPool.h"
+
+NAMESPACE_ROOT
+
+//~~~Constructor~~~//
+
+ThreadPool::ThreadPool(size_t Threads, size_t QueueSize)
+	:
+	m_dequeuePosition(0),
+	m_enqueuePosition(0),
+	m_idleWorkers(0),
+	m_jobsRemaining(0),
+	m_poolShutdown(false),
+	m_queueMask(0),
+	m_queueSlots(nullptr),
+	m_sleepCondition(),
+	m_sleepMutex(),
+	m_waitCondition(),
+	m_waitMutex(),
+	m_workerThreads(0)
+{
+	const size_t PRCCNT = static_cast<size_t>(std::thread::hardware_concurrency());
+	const size_t WRKCNT = (Threads != 0) ? Threads : (PRCCNT != 0) ? PRCCNT : 1;
+	size_t qlen;
+	size_t i;
+
+	// the ring index is masked, so the capacity is a power of two
+	qlen = 2;
+
+	while (qlen < ((QueueSize != 0) ? QueueSize : DEF_QUEUESIZE))
+	{
+		qlen <<= 1;
+	}
+
+	m_queueMask = qlen - 1;
+	m_queueSlots.reset(new TaskSlot[qlen]);
+
+	for (i = 0; i < qlen; ++i)
+	{
+		m_queueSlots[i].Sequence.store(i, std::memory_order_relaxed);
+	}
+
+	for (i = 0; i < WRKCNT; ++i)
+	{
+		m_workerThreads.push_back(std::thread([this]() { WorkerLoop(); }));
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	JoinAll(true);
+}
+
+//~~~Accessors~~~//
+
+const size_t ThreadPool::JobsRemaining()
+{
+	return m_jobsRemaining;
+}
+
+const size_t ThreadPool::MaximumThreads()
+{
+	return m_workerThreads.size();
+}
+
+const size_t ThreadPool::QueueSize()
+{
+	return m_queueMask + 1;
+}
+
+const size_t ThreadPool::ThreadCount()
+{
+	return m_workerThreads.size();
+}
+
+//~~~Public Functions~~~//
+
+void ThreadPool::AddDetachedTask(std::function<void(void)> Task)
+{
+	Post(std::move(Task));
+}
+
+void ThreadPool::AddTask(std::function<void(void)> Task)
+{
+	Post(std::move(Task));
+}
+
+void ThreadPool::JoinAll(bool WaitForAll)
+{
+	TaskStorage tsk;
+	size_t i;
+
+	if (m_poolShutdown)
+	{
+		return;
+	}
+
+	if (WaitForAll)
+	{
+		WaitAll();
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_sleepMutex);
+		m_poolShutdown = true;
+		m_sleepCondition.notify_all();
+	}
+
+	for (i = 0; i < m_workerThreads.size(); ++i)
+	{
+		if (m_workerThreads[i].joinable())
+		{
+			m_workerThreads[i].join();
+		}
+	}
+
+	// discard the tasks that were not started; a future attached to one is released with an error
+	while (TryDequeue(tsk))
+	{
+		tsk.Reset();
+		--m_jobsRemaining;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_waitMutex);
+		m_waitCondition.notify_all();
+	}
+}
+
+void ThreadPool::WaitAll()
+{
+	TaskStorage tsk;
+
+	// the caller helps to drain the queue, then waits for the running tasks
+	while (m_jobsRemaining != 0 && TryDequeue(tsk))
+	{
+		Execute(tsk);
+	}
+
+	if (m_jobsRemaining != 0)
+	{
+		std::unique_lock<std::mutex> lock(m_waitMutex);
+		m_waitCondition.wait(lock, [this]() { return m_jobsRemaining == 0; });
+	}
+}
+
+//~~~Private Functions~~~//
+
+void ThreadPool::Enqueue(TaskStorage &Task)
+{
+	TaskStorage tsk;
+
+	if (m_poolShutdown)
+	{
+		throw CryptoProcessingException(std::string("ThreadPool"), std::string("Enqueue"), std::string("The pool has been shut down!"), Enumeration::ErrorCodes::IllegalOperation);
+	}
+
+	++m_jobsRemaining;
+
+	// a full queue is drained by the producer; it runs a queued task and retries
+	while (!TryEnqueue(Task))
+	{
+		if (TryDequeue(tsk))
+		{
+			Execute(tsk);
+		}
+		else
+		{
+			std::this_thread::yield();
+		}
+	}
+
+	if (m_idleWorkers != 0)
+	{
+		std::lock_guard<std::mutex> lock(m_sleepMutex);
+		m_sleepCondition.notify_one();
+	}
+}
+
+void ThreadPool::Execute(TaskStorage &Task)
+{
+	// exceptions are delivered through the task future; a task without a future has no receiver
+	try
+	{
+		Task.Invoke();
+	}
+	catch (...)
+	{
+	}
+
+	Task.Reset();
+
+	if (--m_jobsRemaining == 0)
+	{
+		std::lock_guard<std::mutex> lock(m_waitMutex);
+		m_waitCondition.notify_all();
+	}
+}
+
+bool ThreadPool::HasTask()
+{
+	const size_t POS = m_dequeuePosition.load();
+
+	return (static_cast<intptr_t>(m_queueSlots[POS & m_queueMask].Sequence.load() - (POS + 1)) >= 0);
+}
+
+bool ThreadPool::TryDequeue(TaskStorage &Task)
+{
+	TaskSlot* slot;
+	size_t pos;
+	size_t seq;
+	intptr_t dif;
+	bool res;
+
+	res = false;
+	pos = m_dequeuePosition.load(std::memory_order_relaxed);
+
+	for (;;)
+	{
+		slot = &m_queueSlots[pos & m_queueMask];
+		seq = slot->Sequence.load(std::memory_order_acquire);
+		dif = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+
+		if (dif == 0)
+		{
+			// the slot is published; claim it
+			if (m_dequeuePosition.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+			{
+				slot->Task.MoveTo(Task);
+				slot->Sequence.store(pos + m_queueMask + 1, std::memory_order_release);
+				res = true;
+				break;
+			}
+		}
+		else if (dif < 0)
+		{
+			// the queue is empty
+			break;
+		}
+		else
+		{
+			pos = m_dequeuePosition.load(std::memory_order_relaxed);
+		}
+	}
+
+	return res;
+}
+
+bool ThreadPool::TryEnqueue(TaskStorage &Task)
+{
+	TaskSlot* slot;
+	size_t pos;
+	size_t seq;
+	intptr_t dif;
+	bool res;
+
+	res = false;
+	pos = m_enqueuePosition.load(std::memory_order_relaxed);
+
+	for (;;)
+	{
+		slot = &m_queueSlots[pos & m_queueMask];
+		seq = slot->Sequence.load(std::memory_order_acquire);
+		dif = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+
+		if (dif == 0)
+		{
+			// the slot is free; claim it
+			if (m_enqueuePosition.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+			{
+				Task.MoveTo(slot->Task);
+				// sequentially consistent, so a worker going to sleep either sees the task or is counted as idle
+				slot->Sequence.store(pos + 1);
+				res = true;
+				break;
+			}
+		}
+		else if (dif < 0)
+		{
+			// the queue is full
+			break;
+		}
+		else
+		{
+			pos = m_enqueuePosition.load(std::memory_order_relaxed);
+		}
+	}
+
+	return res;
+}
+
+void ThreadPool::WorkerLoop()
+{
+	TaskStorage tsk;
+	size_t spin;
+
+	spin = 0;
+
+	while (!m_poolShutdown)
+	{
+		if (TryDequeue(tsk))
+		{
+			Execute(tsk);
+			spin = 0;
+		}
+		else if (spin < SPIN_CYCLES)
+		{
+			++spin;
+			std::this_thread::yield();
+		}
+		else
+		{
+			std::unique_lock<std::mutex> lock(m_sleepMutex);
+
+			++m_idleWorkers;
+			m_sleepCondition.wait(lock, [this]() { return m_poolShutdown || HasTask(); });
+			--m_idleWorkers;
+			spin = 0;
+		}
+	}
+}
+
+NAMESPACE_ROOTEND
@@ -2,213 +2,668 @@
 #define CEX_THREADPOOL_H
 
 #include "CexDomain.h"
+#include "CryptoProcessingException.h"
 #include <atomic>
+#include <cstddef>
 #include <condition_variable>
+#include <exception>
 #include <functional>
-#include <list>
+#include <memory>
 #include <mutex>
+#include <new>
 #include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 NAMESPACE_ROOT
 
+using Exception::CryptoProcessingException;
+
+/// cond private
+
+/// <summary>
+/// Internal class: the shared completion state of one or more pool tasks
+/// </summary>
+class TaskStateBase
+{
+private:
+
+	std::condition_variable m_doneCondition;
+	std::mutex m_doneMutex;
+	std::exception_ptr m_taskError;
+	std::atomic<size_t> m_tasksRemaining;
+
+public:
+
+	TaskStateBase(const TaskStateBase&) = delete;
+
+	TaskStateBase& operator=(const TaskStateBase&) = delete;
+
+	explicit TaskStateBase(size_t Count)
+		:
+		m_doneCondition(),
+		m_doneMutex(),
+		m_taskError(nullptr),
+		m_tasksRemaining(Count)
+	{
+	}
+
+	virtual ~TaskStateBase()
+	{
+	}
+
+	bool IsReady()
+	{
+		return (m_tasksRemaining == 0);
+	}
+
+	void Complete(std::exception_ptr Error)
+	{
+		std::lock_guard<std::mutex> lock(m_doneMutex);
+
+		if (Error != nullptr && m_taskError == nullptr)
+		{
+			m_taskError = Error;
+		}
+
+		if (--m_tasksRemaining == 0)
+		{
+			m_doneCondition.notify_all();
+		}
+	}
+
+	void Rethrow()
+	{
+		if (m_taskError != nullptr)
+		{
+			std::rethrow_exception(m_taskError);
+		}
+	}
+
+	void Wait()
+	{
+		if (m_tasksRemaining != 0)
+		{
+			std::unique_lock<std::mutex> lock(m_doneMutex);
+			m_doneCondition.wait(lock, [this]() { return m_tasksRemaining == 0; });
+		}
+	}
+};
+
+/// <summary>
+/// Internal class: the completion state and result of a pool task
+/// </summary>
+template<typename T>
+class TaskState : public TaskStateBase
+{
+public:
+
+	T Value;
+
+	TaskState()
+		:
+		TaskStateBase(1),
+		Value()
+	{
+	}
+
+	template<typename F>
+	void Run(F &Function)
+	{
+		std::exception_ptr err = nullptr;
+
+		try
+		{
+			Value = Function();
+		}
+		catch (...)
+		{
+			err = std::current_exception();
+		}
+
+		Complete(err);
+	}
+};
+
+/// <summary>
+/// Internal class: the completion state of a pool task without a result
+/// </summary>
+template<>
+class TaskState<void> : public TaskStateBase
+{
+public:
+
+	explicit TaskState(size_t Count = 1)
+		:
+		TaskStateBase(Count)
+	{
+	}
+
+	template<typename F>
+	void Run(F &Function)
+	{
+		std::exception_ptr err = nullptr;
+
+		try
+		{
+			Function();
+		}
+		catch (...)
+		{
+			err = std::current_exception();
+		}
+
+		Complete(err);
+	}
+};
+
+/// endcond
+
 /// <summary>
-/// A thread pool with dynamically sized thread allocations
+/// A lightweight future returned by ThreadPool::Submit and ThreadPool::SubmitBatch.
+/// <para>Waiting blocks on the task completion; an exception thrown by the task is re-thrown by Get().</para>
 /// </summary>
-class ThreadPool 
+template<typename T>
+class TaskFuture
 {
 private:
 
-    static const size_t DEF_MAXTHREADS = 1024;
+	std::shared_ptr<TaskState<T>> m_taskState;
+
+public:
+
+	/// <summary>
+	/// Initialize an empty future
+	/// </summary>
+	TaskFuture()
+		:
+		m_taskState(nullptr)
+	{
+	}
+
+	/// <summary>
+	/// Initialize the future with a task state
+	/// </summary>
+	///
+	/// <param name="State">The shared task state</param>
+	explicit TaskFuture(const std::shared_ptr<TaskState<T>> &State)
+		:
+		m_taskState(State)
+	{
+	}
+
+	/// <summary>
+	/// Read Only: The future is attached to a task
+	/// </summary>
+	bool IsValid() const
+	{
+		return (m_taskState != nullptr);
+	}
+
+	/// <summary>
+	/// Read Only: The task has completed
+	/// </summary>
+	bool IsReady() const
+	{
+		return (m_taskState != nullptr && m_taskState->IsReady());
+	}
+
+	/// <summary>
+	/// Wait for the task to complete and return its result; re-throws an exception thrown by the task
+	/// </summary>
+	///
+	/// <returns>The task result</returns>
+	T Get()
+	{
+		if (m_taskState == nullptr)
+		{
+			throw CryptoProcessingException(std::string("TaskFuture"), std::string("Get"), std::string("The future is not attached to a task!"), Enumeration::ErrorCodes::IllegalOperation);
+		}
+
+		m_taskState->Wait();
+		m_taskState->Rethrow();
+
+		return Result(m_taskState.get());
+	}
+
+	/// <summary>
+	/// Block until the task has completed
+	/// </summary>
+	void Wait()
+	{
+		if (m_taskState != nullptr)
+		{
+			m_taskState->Wait();
+		}
+	}
+
+private:
+
+	template<typename R>
+	static R Result(TaskState<R>* State)
+	{
+		return std::move(State->Value);
+	}
+
+	static void Result(TaskState<void>*)
+	{
+	}
+};
+
+/// <summary>
+/// A fixed size thread pool with a lock-free bounded task queue.
+/// <para>The worker count is set once at construction, by default to the number of logical processors.
+/// Tasks are stored in a bounded multi-producer multi-consumer ring, each slot holding the task inline in a small fixed buffer, so queueing a task does not allocate.
+/// A callable larger than the slot buffer is moved to the heap.
+/// When the ring is full, the submitting thread runs queued tasks until a slot is free.
+/// Idle workers spin briefly, then sleep; producers only signal when a worker is sleeping.</para>
+/// </summary>
+///
+/// <example>
+/// <description>Submitting tasks:</description>
+/// <code>
+/// ThreadPool pool;
+/// TaskFuture&lt;size_t&gt; ftr = pool.Submit([]() { return Compute(); });
+/// TaskFuture&lt;void&gt; bch = pool.SubmitBatch(64, [&amp;](size_t i) { Process(i); });
+/// size_t res = ftr.Get();
+/// bch.Get();
+/// </code>
+/// </example>
+class ThreadPool final
+{
+private:
 
-    std::vector<std::thread> m_threadPool;
-    std::list<std::function<void(void)>> m_threadQueue;
-    std::atomic_size_t      m_jobsRemaining;
-    std::atomic_size_t      m_maxThreads;
-    std::atomic_bool        m_jobsAbort;
-    std::atomic_bool        m_jobsFinished;
-    std::condition_variable m_jobsAvailable;
-    std::condition_variable m_waitCondition;
-    std::mutex              m_queueMutex;
-    std::mutex              m_waitMutex;
+	static const size_t DEF_QUEUESIZE = 1024;
+	static const size_t SPIN_CYCLES = 64;
+	static const size_t TASK_BUFFER = 64;
+
+	/// cond private
+
+	class TaskStorage
+	{
+	private:
+
+		typename std::aligned_storage<TASK_BUFFER, alignof(std::max_align_t)>::type m_taskBuffer;
+		void (*m_taskDestroy)(void*);
+		void (*m_taskInvoke)(void*);
+		void (*m_taskRelocate)(void*, void*);
+
+	public:
+
+		TaskStorage(const TaskStorage&) = delete;
+
+		TaskStorage& operator=(const TaskStorage&) = delete;
+
+		TaskStorage()
+			:
+			m_taskBuffer(),
+			m_taskDestroy(nullptr),
+			m_taskInvoke(nullptr),
+			m_taskRelocate(nullptr)
+		{
+		}
+
+		~TaskStorage()
+		{
+			Reset();
+		}
+
+		bool IsEmpty() const
+		{
+			return (m_taskInvoke == nullptr);
+		}
+
+		template<typename F>
+		void Emplace(F &&Function)
+		{
+			typedef typename std::decay<F>::type TaskType;
+
+			Store<TaskType>(std::forward<F>(Function), std::integral_constant<bool, (sizeof(TaskType) <= TASK_BUFFER && alignof(TaskType) <= alignof(std::max_align_t) && std::is_nothrow_move_constructible<TaskType>::value)>());
+		}
+
+		void Invoke()
+		{
+			m_taskInvoke(&m_taskBuffer);
+		}
+
+		void MoveTo(TaskStorage &Target)
+		{
+			Target.Reset();
+			m_taskRelocate(&Target.m_taskBuffer, &m_taskBuffer);
+			Target.m_taskDestroy = m_taskDestroy;
+			Target.m_taskInvoke = m_taskInvoke;
+			Target.m_taskRelocate = m_taskRelocate;
+			m_taskDestroy = nullptr;
+			m_taskInvoke = nullptr;
+			m_taskRelocate = nullptr;
+		}
+
+		void Reset()
+		{
+			if (m_taskDestroy != nullptr)
+			{
+				m_taskDestroy(&m_taskBuffer);
+			}
+
+			m_taskDestroy = nullptr;
+			m_taskInvoke = nullptr;
+			m_taskRelocate = nullptr;
+		}
+
+	private:
+
+		template<typename T, typename F>
+		void Store(F &&Function, std::true_type)
+		{
+			// the callable fits the slot buffer
+			::new (static_cast<void*>(&m_taskBuffer)) T(std::forward<F>(Function));
+			m_taskDestroy = [](void* Buffer) { static_cast<T*>(Buffer)->~T(); };
+			m_taskInvoke = [](void* Buffer) { (*static_cast<T*>(Buffer))(); };
+			m_taskRelocate = [](void* Target, void* Source)
+			{
+				::new (Target) T(std::move(*static_cast<T*>(Source)));
+				static_cast<T*>(Source)->~T();
+			};
+		}
+
+		template<typename T, typename F>
+		void Store(F &&Function, std::false_type)
+		{
+			// an oversized callable is held through a pointer in the slot buffer
+			::new (static_cast<void*>(&m_taskBuffer)) T*(new T(std::forward<F>(Function)));
+			m_taskDestroy = [](void* Buffer) { delete *static_cast<T**>(Buffer); };
+			m_taskInvoke = [](void* Buffer) { (**static_cast<T**>(Buffer))(); };
+			m_taskRelocate = [](void* Target, void* Source)
+			{
+				::new (Target) T*(*static_cast<T**>(Source));
+				*static_cast<T**>(Source) = nullptr;
+			};
+		}
+	};
+
+	struct TaskSlot
+	{
+		std::atomic<size_t> Sequence;
+		TaskStorage Task;
+
+		TaskSlot()
+			:
+			Sequence(0),
+			Task()
+		{
+		}
+	};
+
+	template<typename T, typename F>
+	class FutureTask
+	{
+	private:
+
+		F m_taskFunction;
+		std::shared_ptr<TaskState<T>> m_taskState;
+
+	public:
+
+		FutureTask(F &&Function, const std::shared_ptr<TaskState<T>> &State)
+			:
+			m_taskFunction(std::move(Function)),
+			m_taskState(State)
+		{
+		}
+
+		FutureTask(FutureTask &&Other) noexcept(std::is_nothrow_move_constructible<F>::value)
+			:
+			m_taskFunction(std::move(Other.m_taskFunction)),
+			m_taskState(std::move(Other.m_taskState))
+		{
+		}
+
+		~FutureTask()
+		{
+			// a task discarded by JoinAll(false) releases its waiters with an error
+			if (m_taskState != nullptr)
+			{
+				m_taskState->Complete(std::make_exception_ptr(CryptoProcessingException(std::string("ThreadPool"), std::string("JoinAll"), std::string("The task was discarded before it ran!"), Enumeration::ErrorCodes::IllegalOperation)));
+			}
+		}
+
+		void operator()()
+		{
+			std::shared_ptr<TaskState<T>> stt(std::move(m_taskState));
+
+			stt->Run(m_taskFunction);
+		}
+	};
+
+	template<typename F>
+	struct BatchState : public TaskState<void>
+	{
+		F Function;
+
+		BatchState(F &&Loop, size_t Count)
+			:
+			TaskState<void>(Count),
+			Function(std::move(Loop))
+		{
+		}
+	};
+
+	template<typename F>
+	class BatchTask
+	{
+	private:
+
+		std::shared_ptr<BatchState<F>> m_batchState;
+		size_t m_taskIndex;
+
+	public:
+
+		BatchTask(const std::shared_ptr<BatchState<F>> &State, size_t Index)
+			:
+			m_batchState(State),
+			m_taskIndex(Index)
+		{
+		}
+
+		BatchTask(BatchTask &&Other) noexcept
+			:
+			m_batchState(std::move(Other.m_batchState)),
+			m_taskIndex(Other.m_taskIndex)
+		{
+		}
+
+		~BatchTask()
+		{
+			if (m_batchState != nullptr)
+			{
+				m_batchState->Complete(std::make_exception_ptr(CryptoProcessingException(std::string("ThreadPool"), std::string("JoinAll"), std::string("The task was discarded before it ran!"), Enumeration::ErrorCodes::IllegalOperation)));
+			}
+		}
+
+		void operator()()
+		{
+			std::shared_ptr<BatchState<F>> stt(std::move(m_batchState));
+			const size_t IDX = m_taskIndex;
+			auto fnc = [&stt, IDX]() { stt->Function(IDX); };
+
+			stt->Run(fnc);
+		}
+	};
+
+	/// endcond
+
+	std::atomic<size_t> m_dequeuePosition;
+	std::atomic<size_t> m_enqueuePosition;
+	std::atomic<size_t> m_idleWorkers;
+	std::atomic<size_t> m_jobsRemaining;
+	std::atomic<bool> m_poolShutdown;
+	size_t m_queueMask;
+	std::unique_ptr<TaskSlot[]> m_queueSlots;
+	std::condition_variable m_sleepCondition;
+	std::mutex m_sleepMutex;
+	std::condition_variable m_waitCondition;
+	std::mutex m_waitMutex;
+	std::vector<std::thread> m_workerThreads;
 
 public:
 
-    /// <summary>
-    /// The threadpool constructor
-    /// </summary>
-    /// 
-    /// <param name="MaximumThreads">The maximum number of threads in the queue.
-    /// <para>The thread count must be between 2 and 128 threads.</para></param>
-    ThreadPool(size_t MaximumThreads = DEF_MAXTHREADS)
-        : 
-        m_threadPool(0),
-        m_threadQueue(0),
-        m_jobsRemaining(0),
-        m_maxThreads(MaximumThreads > 1 && MaximumThreads <= DEF_MAXTHREADS ?
-            MaximumThreads : 
-            DEF_MAXTHREADS),
-        m_jobsAbort(false), 
-        m_jobsFinished(false)
-    {
-    }
-
-    /// <summary>
-    /// Destructor
-    /// </summary>
-    ~ThreadPool() 
-    {
-        JoinAll();
-    }
-
-    /// <summary>
-    /// Get: The number of threads in the queue
-    /// </summary>
-    const size_t ThreadCount()
-    {
-        std::lock_guard<std::mutex> guard(m_queueMutex);
-
-        return m_threadPool.size();
-    }
-
-    /// <summary>
-    /// Get: The number of jobs remaining in the queue
-    /// </summary>
-    const size_t JobsRemaining() 
-    {
-        std::lock_guard<std::mutex> guard(m_queueMutex);
-
-        return m_threadQueue.size();
-    }
-
-    /// <summary>
-    /// Get: The maximum number of threads the queue can hold
-    /// </summary>
-    const size_t MaximumThreads()
-    {
-        std::lock_guard<std::mutex> guard(m_queueMutex);
-
-        return DEF_MAXTHREADS;
-    }
-
-    /// <summary>
-    /// Add a new job to the thread pool
-    /// </summary>
-    /// 
-    /// <param name="Task">The asynchronous task to run</param>
-    void AddTask(std::function<void(void)> Task)
-    {
-        std::lock_guard<std::mutex> guard(m_queueMutex);
-
-        if (ThreadCount() < MaximumThreads())
-        {
-            m_threadPool.push_back(std::thread([this] { this->Task(); }));
-        }
-
-        m_threadQueue.emplace_back(Task);
-        ++m_jobsRemaining;
-        m_jobsAvailable.notify_one();
-    }
-
-    /// <summary>
-    /// Add a detached new job to the thread pool
-    /// </summary>
-    /// 
-    /// <param name="Task">The asynchronous task to run</param>
-    void AddDetachedTask(std::function<void(void)> Task)
-    {
-        std::lock_guard<std::mutex> guard(m_queueMutex);
-
-        if (ThreadCount() < MaximumThreads())
-        {
-            std::thread thd([this] { this->Task(); });
-            thd.detach();
-            m_threadPool.push_back(thd);
-        }
-
-        m_threadQueue.emplace_back(Task);
-        ++m_jobsRemaining;
-        m_jobsAvailable.notify_one();
-    }
-
-    /// <summary>
-    /// Join all threads in the pool.
-    /// </summary>
-    /// 
-    /// <param name="WaitForAll">If true, waits for the thread queue to empty, else completes current jobs</param>
-    void JoinAll(bool WaitForAll = true)
-    {
-        if (!m_jobsFinished)
-        {
-            if (WaitForAll)
-            {
-                WaitAll();
-            }
-
-            // wake up any thread that's waiting for a new job
-            m_jobsAbort = true;
-
-            m_jobsAvailable.notify_all();
-
-            for (auto &x : m_threadPool)
-            {
-                if (x.joinable())
-                {
-                    x.join();
-                }
-            }
-
-            m_jobsFinished = true;
-        }
-    }
-
-    /// <summary>
-    /// Wait for the pool to empty all work items
-    /// </summary>
-    void WaitAll()
-    {
-        if (m_jobsRemaining > 0)
-        {
-            std::unique_lock<std::mutex> lock(m_waitMutex);
-            m_waitCondition.wait(lock, [this] { return this->m_jobsRemaining == 0; });
-            lock.unlock();
-        }
-    }
+	//~~~Constructor~~~//
+
+	/// <summary>
+	/// Copy constructor: copy is restricted, this function has been deleted
+	/// </summary>
+	ThreadPool(const ThreadPool&) = delete;
+
+	/// <summary>
+	/// Copy operator: copy is restricted, this function has been deleted
+	/// </summary>
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	/// <summary>
+	/// Initialize the pool and start the worker threads
+	/// </summary>
+	///
+	/// <param name="Threads">The number of worker threads; zero uses the number of logical processors</param>
+	/// <param name="QueueSize">The task queue capacity, rounded up to a power of two; zero uses the default of 1024 tasks</param>
+	explicit ThreadPool(size_t Threads = 0, size_t QueueSize = DEF_QUEUESIZE);
+
+	/// <summary>
+	/// Destructor: waits for the queued tasks, and joins the worker threads
+	/// </summary>
+	~ThreadPool();
+
+	//~~~Accessors~~~//
+
+	/// <summary>
+	/// Read Only: The number of tasks queued or running
+	/// </summary>
+	const size_t JobsRemaining();
+
+	/// <summary>
+	/// Read Only: The number of worker threads in the pool
+	/// </summary>
+	const size_t MaximumThreads();
+
+	/// <summary>
+	/// Read Only: The task queue capacity
+	/// </summary>
+	const size_t QueueSize();
+
+	/// <summary>
+	/// Read Only: The number of worker threads in the pool
+	/// </summary>
+	const size_t ThreadCount();
+
+	//~~~Public Functions~~~//
+
+	/// <summary>
+	/// Add a detached task to the pool; the task has no future
+	/// </summary>
+	///
+	/// <param name="Task">The asynchronous task to run</param>
+	void AddDetachedTask(std::function<void(void)> Task);
+
+	/// <summary>
+	/// Add a task to the pool; the task has no future
+	/// </summary>
+	///
+	/// <param name="Task">The asynchronous task to run</param>
+	void AddTask(std::function<void(void)> Task);
+
+	/// <summary>
+	/// Join all threads in the pool
+	/// </summary>
+	///
+	/// <param name="WaitForAll">If true, waits for the task queue to empty, else completes the running tasks and discards the queued tasks</param>
+	void JoinAll(bool WaitForAll = true);
+
+	/// <summary>
+	/// Queue a task without a future; the fastest submission path
+	/// </summary>
+	///
+	/// <param name="Function">The task function</param>
+	template<typename F>
+	void Post(F &&Function)
+	{
+		TaskStorage tsk;
+
+		tsk.Emplace(std::forward<F>(Function));
+		Enqueue(tsk);
+	}
+
+	/// <summary>
+	/// Queue a task, and return a future for its result
+	/// </summary>
+	///
+	/// <param name="Function">The task function</param>
+	///
+	/// <returns>The task future</returns>
+	template<typename F>
+	auto Submit(F &&Function) -> TaskFuture<decltype(std::declval<typename std::decay<F>::type&>()())>
+	{
+		typedef typename std::decay<F>::type FunctionType;
+		typedef decltype(std::declval<FunctionType&>()()) ResultType;
+
+		std::shared_ptr<TaskState<ResultType>> stt = std::make_shared<TaskState<ResultType>>();
+		FunctionType fnc(std::forward<F>(Function));
+		TaskStorage tsk;
+
+		tsk.Emplace(FutureTask<ResultType, FunctionType>(std::move(fnc), stt));
+		Enqueue(tsk);
+
+		return TaskFuture<ResultType>(stt);
+	}
+
+	/// <summary>
+	/// Queue a loop function as Count tasks, each called with its index in [0, Count), and return a single future for the batch.
+	/// <para>The loop function is stored once for the batch; the future is ready when every index has run.</para>
+	/// </summary>
+	///
+	/// <param name="Count">The number of tasks</param>
+	/// <param name="Function">The loop function, called as Function(size_t)</param>
+	///
+	/// <returns>The batch future</returns>
+	template<typename F>
+	TaskFuture<void> SubmitBatch(size_t Count, F &&Function)
+	{
+		typedef typename std::decay<F>::type FunctionType;
+
+		FunctionType fnc(std::forward<F>(Function));
+		std::shared_ptr<BatchState<FunctionType>> stt;
+		size_t i;
+
+		if (Count == 0)
+		{
+			return TaskFuture<void>(std::make_shared<TaskState<void>>(0));
+		}
+
+		stt = std::make_shared<BatchState<FunctionType>>(std::move(fnc), Count);
+
+		for (i = 0; i < Count; ++i)
+		{
+			TaskStorage tsk;
+
+			tsk.Emplace(BatchTask<FunctionType>(stt, i));
+			Enqueue(tsk);
+		}
+
+		return TaskFuture<void>(std::static_pointer_cast<TaskState<void>>(stt));
+	}
+
+	/// <summary>
+	/// Wait for the pool to complete every queued task
+	/// </summary>
+	void WaitAll();
 
 private:
 
-    void Task()
-    {
-        while (!m_jobsAbort)
-        {
-            NextJob()();
-
-            --m_jobsRemaining;
-            m_waitCondition.notify_one();
-        }
-    }
-
-    std::function<void(void)> NextJob()
-    {
-        std::unique_lock<std::mutex> lock(m_queueMutex);
-        std::function<void(void)> func;
-
-        // wait for a job if we don't have any.
-        m_jobsAvailable.wait(lock, [this]() ->bool { return m_threadQueue.size() || m_jobsAbort; });
-
-        // get job from the thread queue
-        if (!m_jobsAbort)
-        {
-            func = m_threadQueue.front();
-            m_threadQueue.pop_front();
-        }
-        else
-        {
-            func = []{};
-            ++m_jobsRemaining;
-        }
-
-        return func;
-    }
+	void Enqueue(TaskStorage &Task);
+	void Execute(TaskStorage &Task);
+	bool HasTask();
+	bool TryDequeue(TaskStorage &Task);
+	bool TryEnqueue(TaskStorage &Task);
+	void WorkerLoop();
 };
 
 NAMESPACE_ROOTEND
@@ -23,154 +23,22 @@
 #include "IntegerTools.h"
 #include "MemoryTools.h"
 
-#if defined(CEX_HAS_AVX512)
-#	include "ULong512.h"
-#elif defined(CEX_HAS_AVX2)
-#	include "ULong256.h"
-#endif
-
 NAMESPACE_STREAM
 
 using Tools::IntegerTools;
 using Tools::MemoryTools;
 
-#if defined(CEX_HAS_AVX512)
-	using Numeric::ULong512;
-#elif defined(CEX_HAS_AVX2)
-	using Numeric::ULong256;
-#endif
-
 /// <summary>
 /// Contains the Threefish 256, 512, and 1024bit permutation functions.
 /// <para>The function names are in the format; Permute-rounds-bits-suffix, ex. PemuteR72P256C, 72 rounds, permutes 256 bits, using the compact form of the function. \n
 /// The compact forms of the permutations have the suffix C, and are optimized for performance and low memory consumption 
 /// (enabled in the hash function by adding the CEX_DIGEST_COMPACT to the CexConfig file). \n
 /// The Unrolled forms are optimized for speed and timing neutrality (suffix U), and the vertically vectorized functions have the V suffix. \n
-/// The H suffix denotes functions that take an SIMD wrapper class (ULongXXX) as the state values, and process state in SIMD parallel blocks.</para>
-/// <para>This class contains wide forms of the functions; PemuteP4x256H, PemuteP4x512H, and PemuteP4x1024H use AVX2 instructions. \n
-/// Experimental functions using AVX512 instructions are also implemented; PemuteP8x256H, PemuteP8x512H, and PemuteP8x1024H. \n
-/// These functions are not visible until run-time on some compiler platforms unless the compiler flag (CEX_HAS_AVX2 or CEX_HAS_AVX512) is explicitly declared.</para>
+/// The wide forms, which process four or eight blocks with AVX2 or AVX512 instructions, are implemented by the ThreefishKernels class, 
+/// each in its own instruction set translation unit, and are selected at run-time.</para>
 /// </summary>
 class Threefish
 {
-private:
-
-#if defined(CEX_HAS_AVX512)
-
-	// AVX512
-	template<typename T, typename ArrayU64x32>
-	static void Store4xULL512(std::array<T, 4> &C, ArrayU64x32 &State)
-	{
-		std::array<uint64_t, 8> tmp;
-		size_t i;
-
-		for (i = 0; i < 4; ++i)
-		{
-			C[i].Store(tmp, 0);
-			State[i] = tmp[0];
-			State[i + 4] = tmp[1];
-			State[i + 8] = tmp[2];
-			State[i + 12] = tmp[3];
-			State[i + 16] = tmp[4];
-			State[i + 20] = tmp[5];
-			State[i + 24] = tmp[6];
-			State[i + 28] = tmp[7];
-		}
-	}
-
-	template<typename T, typename ArrayU64x64>
-	static void Store8xULL512(std::array<T, 8> &C, ArrayU64x64 &State)
-	{
-		std::array<uint64_t, 8> tmp;
-		size_t i;
-
-		for (i = 0; i < 8; ++i)
-		{
-			C[i].Store(tmp, 0);
-			State[i] = tmp[0];
-			State[i + 8] = tmp[1];
-			State[i + 16] = tmp[2];
-			State[i + 24] = tmp[3];
-			State[i + 32] = tmp[4];
-			State[i + 40] = tmp[5];
-			State[i + 48] = tmp[6];
-			State[i + 56] = tmp[7];
-		}
-	}
-
-	template<typename T, typename ArrayU64x128>
-	static void Store16xULL512(std::array<T, 16> &C, ArrayU64x128 &State)
-	{
-		std::array<uint64_t, 8> tmp;
-		size_t i;
-
-		for (i = 0; i < 16; ++i)
-		{
-			C[i].Store(tmp, 0);
-			State[i] = tmp[0];
-			State[i + 16] = tmp[1];
-			State[i + 32] = tmp[2];
-			State[i + 48] = tmp[3];
-			State[i + 64] = tmp[4];
-			State[i + 80] = tmp[5];
-			State[i + 96] = tmp[6];
-			State[i + 112] = tmp[7];
-		}
-	}
-
-#elif defined(CEX_HAS_AVX2)
-
-	// AVX2
-	template<typename T, typename ArrayU64x16>
-	static void Store4xULL256(std::array<T, 4> &C, ArrayU64x16 &State)
-	{
-		std::array<uint64_t, 4> tmp;
-		size_t i;
-
-		for (i = 0; i < 4; ++i)
-		{
-			C[i].Store(tmp, 0);
-			State[i] = tmp[0];
-			State[i + 4] = tmp[1];
-			State[i + 8] = tmp[2];
-			State[i + 12] = tmp[3];
-		}
-	}
-
-	template<typename T, typename ArrayU64x32>
-	static void Store8xULL256(std::array<T, 8> &C, ArrayU64x32 &State)
-	{
-		std::array<uint64_t, 4> tmp;
-		size_t i;
-
-		for (i = 0; i < 8; ++i)
-		{
-			C[i].Store(tmp, 0);
-			State[i] = tmp[0];
-			State[i + 8] = tmp[1];
-			State[i + 16] = tmp[2];
-			State[i + 24] = tmp[3];
-		}
-	}
-
-	template<typename T, typename ArrayU64x64>
-	static void Store16xULL256(std::array<T, 16> &C, ArrayU64x64 &State)
-	{
-		std::array<uint64_t, 4> tmp;
-		size_t i;
-
-		for (i = 0; i < 16; ++i)
-		{
-			C[i].Store(tmp, 0);
-			State[i] = tmp[0];
-			State[i + 16] = tmp[1];
-			State[i + 32] = tmp[2];
-			State[i + 48] = tmp[3];
-		}
-	}
-
-#endif
-
 public:
 
 	//~~~Threefish-256~~~//
@@ -649,210 +517,6 @@ public:
 		State[3] = C3 + K1 + 18;
 	}
 
-#if defined(CEX_HAS_AVX512)
-
-	/// <summary>
-	/// The horizontally vectorized form of the Threefish-256 permutation function.
-	/// <para>This function processes 8*32 blocks of input in parallel using AVX512 instructions.
-	/// Note: The rounds count must be at least 72 and evenly divisible by 8.</para>
-	/// </summary>
-	/// 
-	/// <param name="Key">The input cipher key array (4x uint64)</param>
-	/// <param name="Counter">The cipher counter array (4x uint64)</param>
-	/// <param name="Tweak">The cipher tweak array (2x uint64)</param>
-	/// <param name="State">The permutations state array (32x uint64)</param>
-	/// <param name="Rounds">The number of mixing rounds; the default is 72</param>
-	template<typename ArrayU64x2, typename ArrayU64x4, typename ArrayU64x16, typename ArrayU64x32>
-	static void PemuteP8x256H(const ArrayU64x4 &Key, const ArrayU64x16 &Counter, const ArrayU64x2 &Tweak, ArrayU64x32 &State, size_t Rounds)
-	{
-		std::array<ULong512, 4> C;
-		std::array<ULong512, 5> K;
-		std::array<ULong512, 3> T;
-		size_t i;
-		size_t r;
-		size_t x;
-		size_t y;
-
-		C[0].Load(Counter, 0);
-		C[1].Load(Counter, 8);
-		C[2].Load(0xFFFFFFFFFFFFFFFFULL);
-		C[3].Load(0xFFFFFFFFFFFFFFFFULL);
-		K[0].Load(Key[0]);
-		K[1].Load(Key[1]);
-		K[2].Load(Key[2]);
-		K[3].Load(Key[3]);
-		K[4] = K[0] ^ K[1] ^ K[2] ^ K[3] ^ ULong512(0x1BD11BDAA9FC1A22ULL);
-		T[0].Load(Tweak[0]);
-		T[1].Load(Tweak[1]);
-		T[2] = T[0] ^ T[1];
-
-		r = Rounds / 8;
-		x = 1;
-		y = 0;
-
-		for (i = 0; i < r; ++i)
-		{
-			// 8 rounds, inject k
-			C[1] += K[x] + T[y];
-			x != 0 ? x -= 1 : x += 4;
-			C[0] += C[1] + K[x];
-			C[1] = ULong512::RotL64(C[1], 14) ^ C[0];
-			// mix
-			x > 1 ? x -= 2 : x += 3;
-			C[3] += K[x] + ULong512(i * 2);
-			x > 0 ? x -= 1 : x += 4;
-			y != 2 ? y += 1 : y -= 2;
-			C[2] += C[3] + K[x] + T[y];
-			C[3] = ULong512::RotL64(C[3], 16) ^ C[2];
-			C[0] += C[3];
-			C[3] = ULong512::RotL64(C[3], 52) ^ C[0];
-			C[2] += C[1];
-			C[1] = ULong512::RotL64(C[1], 57) ^ C[2];
-			C[0] += C[1];
-			C[1] = ULong512::RotL64(C[1], 23) ^ C[0];
-			C[2] += C[3];
-			C[3] = ULong512::RotL64(C[3], 40) ^ C[2];
-			C[0] += C[3];
-			C[3] = ULong512::RotL64(C[3], 5) ^ C[0];
-			C[2] += C[1];
-			C[1] = ULong512::RotL64(C[1], 37) ^ C[2];
-			// inject
-			C[1] += K[x] + T[y];
-			x != 0 ? x -= 1 : x += 4;
-			C[0] += C[1] + K[x];
-			C[1] = ULong512::RotL64(C[1], 25) ^ C[0];
-			// mix
-			x > 1 ? x -= 2 : x += 3;
-			C[3] += K[x] + ULong512((i * 2) + 1);
-			x != 0 ? x -= 1 : x += 4;
-			y != 2 ? y += 1 : y -= 2;
-			C[2] += C[3] + K[x] + T[y];
-			C[3] = ULong512::RotL64(C[3], 33) ^ C[2];
-			C[0] += C[3];
-			C[3] = ULong512::RotL64(C[3], 46) ^ C[0];
-			C[2] += C[1];
-			C[1] = ULong512::RotL64(C[1], 12) ^ C[2];
-			C[0] += C[1];
-			C[1] = ULong512::RotL64(C[1], 58) ^ C[0];
-			C[2] += C[3];
-			C[3] = ULong512::RotL64(C[3], 22) ^ C[2];
-			C[0] += C[3];
-			C[3] = ULong512::RotL64(C[3], 32) ^ C[0];
-			C[2] += C[1];
-			C[1] = ULong512::RotL64(C[1], 32) ^ C[2];
-		}
-
-		C[0] += K[3];
-		C[1] += K[4] + T[0];
-		C[2] += K[0] + T[1];
-		C[3] += K[1] + ULong512(Rounds / 4);
-
-		Store4xULL512(C, State);
-	}
-
-#elif defined(CEX_HAS_AVX2)
-
-	/// <summary>
-	/// The horizontally vectorized form of the Threefish-256 permutation function.
-	/// <para>This function processes 4*32 blocks of input in parallel using AVX2 instructions.
-	/// Note: The rounds count must be at least 72 and evenly divisible by 8.</para>
-	/// </summary>
-	/// 
-	/// <param name="Key">The input cipher key array (4x uint64)</param>
-	/// <param name="Counter">The cipher counter array (8x uint64)</param>
-	/// <param name="Tweak">The cipher tweak array (2x uint64)</param>
-	/// <param name="State">The permutations state array (16x uint64)</param>
-	/// <param name="Rounds">The number of mixing rounds; the default is 72</param>
-	template<typename ArrayU64x2, typename ArrayU64x4, typename ArrayU64x8, typename ArrayU64x16>
-	static void PemuteP4x256H(const ArrayU64x4 &Key, const ArrayU64x8 &Counter, const ArrayU64x2 &Tweak, ArrayU64x16 &State, size_t Rounds) 
-	{
-		std::array<ULong256, 4> C;
-		std::array<ULong256, 5> K;
-		std::array<ULong256, 3> T;
-		size_t i;
-		size_t r;
-		size_t x;
-		size_t y;
-
-		C[0].Load(Counter, 0);
-		C[1].Load(Counter, 4);
-		C[2].Load(0xFFFFFFFFFFFFFFFFULL);
-		C[3].Load(0xFFFFFFFFFFFFFFFFULL);
-		K[0].Load(Key[0]);
-		K[1].Load(Key[1]);
-		K[2].Load(Key[2]);
-		K[3].Load(Key[3]);
-		K[4] = K[0] ^ K[1] ^ K[2] ^ K[3] ^ ULong256(0x1BD11BDAA9FC1A22ULL);
-		T[0].Load(Tweak[0]);
-		T[1].Load(Tweak[1]);
-		T[2] = T[0] ^ T[1];
-
-		r = Rounds / 8;
-		x = 1;
-		y = 0;
-
-		for (i = 0; i < r; ++i)
-		{
-			// round n+8, inject k
-			C[1] += K[x] + T[y];
-			x != 0 ? x -= 1 : x += 4;
-			C[0] += C[1] + K[x];
-			C[1] = ULong256::RotL64(C[1], 14) ^ C[0];
-			// mix
-			x > 1 ? x -= 2 : x += 3;
-			C[3] += K[x] + ULong256(static_cast<uint64_t>(i) * 2);
-			x > 0 ? x -= 1 : x += 4;
-			y != 2 ? y += 1 : y -= 2;
-			C[2] += C[3] + K[x] + T[y];
-			C[3] = ULong256::RotL64(C[3], 16) ^ C[2];
-			C[0] += C[3];
-			C[3] = ULong256::RotL64(C[3], 52) ^ C[0];
-			C[2] += C[1];
-			C[1] = ULong256::RotL64(C[1], 57) ^ C[2];
-			C[0] += C[1];
-			C[1] = ULong256::RotL64(C[1], 23) ^ C[0];
-			C[2] += C[3];
-			C[3] = ULong256::RotL64(C[3], 40) ^ C[2];
-			C[0] += C[3];
-			C[3] = ULong256::RotL64(C[3], 5) ^ C[0];
-			C[2] += C[1];
-			C[1] = ULong256::RotL64(C[1], 37) ^ C[2];
-			// inject
-			C[1] += K[x] + T[y];
-			x != 0 ? x -= 1 : x += 4;
-			C[0] += C[1] + K[x];
-			C[1] = ULong256::RotL64(C[1], 25) ^ C[0];
-			// mix
-			x > 1 ? x -= 2 : x += 3;
-			C[3] += K[x] + ULong256((static_cast<uint64_t>(i) * 2) + 1);
-			x != 0 ? x -= 1 : x += 4;
-			y != 2 ? y += 1 : y -= 2;
-			C[2] += C[3] + K[x] + T[y];
-			C[3] = ULong256::RotL64(C[3], 33) ^ C[2];
-			C[0] += C[3];
-			C[3] = ULong256::RotL64(C[3], 46) ^ C[0];
-			C[2] += C[1];
-			C[1] = ULong256::RotL64(C[1], 12) ^ C[2];
-			C[0] += C[1];
-			C[1] = ULong256::RotL64(C[1], 58) ^ C[0];
-			C[2] += C[3];
-			C[3] = ULong256::RotL64(C[3], 22) ^ C[2];
-			C[0] += C[3];
-			C[3] = ULong256::RotL64(C[3], 32) ^ C[0];
-			C[2] += C[1];
-			C[1] = ULong256::RotL64(C[1], 32) ^ C[2];
-		}
-
-		C[0] += K[3];
-		C[1] += K[4] + T[0];
-		C[2] += K[0] + T[1];
-		C[3] += K[1] + ULong256(Rounds / 4);
-
-		Store4xULL256(C, State);
-	}
-
-#endif
-
 	//~~~Threefish-512~~~//
 
 	/// <summary>
@@ -1942,49 +1606,36 @@ public:
 		State[7] = C7 + K7 + 24;
 	}
 
-#if defined(CEX_HAS_AVX512)
+	//~~~Threefish-1024~~~//
 
 	/// <summary>
-	/// The horizontally vectorized form of the Threefish-512 permutation function.
-	/// <para>This function processes 8*64 blocks of input in parallel using AVX512 instructions.
+	/// The compact form of the Threefish-1024 permutation function.
+	/// <para>This function has been optimized for a small memory consumption.
+	/// To enable this function, add the CEX_DIGEST_COMPACT directive to the CexConfig file.
 	/// Note: The rounds count must be at least 72 and evenly divisible by 8.</para>
 	/// </summary>
 	/// 
-	/// <param name="Key">The input cipher key array (8x uint64)</param>
-	/// <param name="Counter">The cipher counter array (16x uint64)</param>
+	/// <param name="Key">The input cipher key array (16x uint64)</param>
+	/// <param name="Counter">The cipher counter array (2x uint64)</param>
 	/// <param name="Tweak">The cipher tweak array (2x uint64)</param>
-	/// <param name="State">The permutations state array (64x uint64)</param>
-	/// <param name="Rounds">The number of mixing rounds; the default is 96</param>
-	template<typename ArrayU64x2, typename ArrayU64x8, typename ArrayU64x16, typename ArrayU64x64>
-	static void PemuteP8x512H(const ArrayU64x8 &Key, const ArrayU64x16 &Counter, const ArrayU64x2 &Tweak, ArrayU64x64 &State, size_t Rounds)
+	/// <param name="State">The permutations state array (16x uint64)</param>
+	/// <param name="Rounds">The number of mixing rounds; the default is 128</param>
+	template<typename ArrayU64x2, typename ArrayU64x16>
+	static void PemuteP1024C(const ArrayU64x16 &Key, const ArrayU64x2 &Counter, const ArrayU64x2 &Tweak, ArrayU64x16 &State, size_t Rounds)
 	{
-		std::array<ULong512, 8> C;
-		std::array<ULong512, 9> K;
-		std::array<ULong512, 3> T;
+		std::array<uint64_t, 16> C;
+		std::array<uint64_t, 17> K;
+		std::array<uint64_t, 3> T;
 		size_t i;
 		size_t r;
 		size_t x;
 		size_t y;
 
-		C[0].Load(Counter, 0);
-		C[1].Load(Counter, 8);
-		C[2].Load(0xFFFFFFFFFFFFFFFFULL);
-		C[3].Load(0xFFFFFFFFFFFFFFFFULL);
-		C[4].Load(0xFFFFFFFFFFFFFFFFULL);
-		C[5].Load(0xFFFFFFFFFFFFFFFFULL);
-		C[6].Load(0xFFFFFFFFFFFFFFFFULL);
-		C[7].Load(0xFFFFFFFFFFFFFFFFULL);
-		K[0].Load(Key[0]);
-		K[1].Load(Key[1]);
-		K[2].Load(Key[2]);
-		K[3].Load(Key[3]);
-		K[4].Load(Key[4]);
-		K[5].Load(Key[5]);
-		K[6].Load(Key[6]);
-		K[7].Load(Key[7]);
-		K[8] = K[0] ^ K[1] ^ K[2] ^ K[3] ^ K[4] ^ K[5] ^ K[6] ^ K[7] ^ ULong512(0x1BD11BDAA9FC1A22ULL);
-		T[0].Load(Tweak[0]);
-		T[1].Load(Tweak[1]);
+		MemoryTools::Copy(Counter, 0, C, 0, 2 * sizeof(uint64_t));
+		MemoryTools::SetValue(C, 2, 14 * sizeof(uint64_t), 0xFF);
+		MemoryTools::Copy(Key, 0, K, 0, 16 * sizeof(uint64_t));
+		K[16] = K[0] ^ K[1] ^ K[2] ^ K[3] ^ K[4] ^ K[5] ^ K[6] ^ K[7] ^ K[8] ^ K[9] ^ K[10] ^ K[11] ^ K[12] ^ K[13] ^ K[14] ^ K[15] ^ 0x1BD11BDAA9FC1A22ULL;
+		MemoryTools::Copy(Tweak, 0, T, 0, 2 * sizeof(uint64_t));
 		T[2] = T[0] ^ T[1];
 
 		r = Rounds / 8;
@@ -1995,371 +1646,64 @@ public:
 		{
 			// round n+8, inject k
 			C[1] += K[x];
-			x != 0 ? x -= 1 : x += 8;
+			x != 0 ? x -= 1 : x += 16;
 			C[0] += C[1] + K[x];
-			C[1] = ULong512::RotL64(C[1], 46) ^ C[0];
-			x < 6 ? x += 3 : x -= 6;
+			C[1] = IntegerTools::RotL64(C[1], 24) ^ C[0];
+			x < 14 ? x += 3 : x -= 14;
 			C[3] += K[x];
-			x != 0 ? x -= 1 : x += 8;
+			x != 0 ? x -= 1 : x += 16;
 			C[2] += C[3] + K[x];
-			C[3] = ULong512::RotL64(C[3], 36) ^ C[2];
-			x < 6 ? x += 3 : x -= 6;
-			C[5] += K[x] + T[y];
-			x != 0 ? x -= 1 : x += 8;
+			C[3] = IntegerTools::RotL64(C[3], 13) ^ C[2];
+			x < 14 ? x += 3 : x -= 14;
+			C[5] += K[x];
+			x != 0 ? x -= 1 : x += 16;
 			C[4] += C[5] + K[x];
-			C[5] = ULong512::RotL64(C[5], 19) ^ C[4];
+			C[5] = IntegerTools::RotL64(C[5], 8) ^ C[4];
+			x < 14 ? x += 3 : x -= 14;
+			C[7] += K[x];
+			x != 0 ? x -= 1 : x += 16;
+			C[6] += C[7] + K[x];
+			C[7] = IntegerTools::RotL64(C[7], 47) ^ C[6];
+			x < 14 ? x += 3 : x -= 14;
+			C[9] += K[x];
+			x != 0 ? x -= 1 : x += 16;
+			C[8] += C[9] + K[x];
+			C[9] = IntegerTools::RotL64(C[9], 8) ^ C[8];
+			x < 14 ? x += 3 : x -= 14;
+			C[11] += K[x];
+			x != 0 ? x -= 1 : x += 16;
+			C[10] += C[11] + K[x];
+			C[11] = IntegerTools::RotL64(C[11], 17) ^ C[10];
+			x < 14 ? x += 3 : x -= 14;
+			C[13] += K[x] + T[y];
+			x != 0 ? x -= 1 : x += 16;
+			C[12] += C[13] + K[x];
+			C[13] = IntegerTools::RotL64(C[13], 22) ^ C[12];
 			// mix
-			x < 6 ? x += 3 : x -= 6;
-			C[7] += K[x] + ULong512(i * 2);
-			x != 0 ? x -= 1 : x += 8;
+			x < 14 ? x += 3 : x -= 14;
+			C[15] += K[x] + (static_cast<uint64_t>(i) * 2);
+			x != 0 ? x -= 1 : x += 16;
 			y != 2 ? y += 1 : y -= 2;
-			C[6] += C[7] + K[x] + T[y];
-			C[7] = ULong512::RotL64(C[7], 37) ^ C[6];
-			C[2] += C[1];
-			C[1] = ULong512::RotL64(C[1], 33) ^ C[2];
-			C[4] += C[7];
-			C[7] = ULong512::RotL64(C[7], 27) ^ C[4];
-			C[6] += C[5];
-			C[5] = ULong512::RotL64(C[5], 14) ^ C[6];
-			C[0] += C[3];
-			C[3] = ULong512::RotL64(C[3], 42) ^ C[0];
-			C[4] += C[1];
-			C[1] = ULong512::RotL64(C[1], 17) ^ C[4];
-			C[6] += C[3];
-			C[3] = ULong512::RotL64(C[3], 49) ^ C[6];
-			C[0] += C[5];
-			C[5] = ULong512::RotL64(C[5], 36) ^ C[0];
-			C[2] += C[7];
-			C[7] = ULong512::RotL64(C[7], 39) ^ C[2];
-			C[6] += C[1];
-			C[1] = ULong512::RotL64(C[1], 44) ^ C[6];
+			C[14] += C[15] + K[x] + T[y];
+			C[15] = IntegerTools::RotL64(C[15], 37) ^ C[14];
+			C[0] += C[9];
+			C[9] = IntegerTools::RotL64(C[9], 38) ^ C[0];
+			C[2] += C[13];
+			C[13] = IntegerTools::RotL64(C[13], 19) ^ C[2];
+			C[6] += C[11];
+			C[11] = IntegerTools::RotL64(C[11], 10) ^ C[6];
+			C[4] += C[15];
+			C[15] = IntegerTools::RotL64(C[15], 55) ^ C[4];
+			C[10] += C[7];
+			C[7] = IntegerTools::RotL64(C[7], 49) ^ C[10];
+			C[12] += C[3];
+			C[3] = IntegerTools::RotL64(C[3], 18) ^ C[12];
+			C[14] += C[5];
+			C[5] = IntegerTools::RotL64(C[5], 23) ^ C[14];
+			C[8] += C[1];
+			C[1] = IntegerTools::RotL64(C[1], 52) ^ C[8];
 			C[0] += C[7];
-			C[7] = ULong512::RotL64(C[7], 9) ^ C[0];
-			C[2] += C[5];
-			C[5] = ULong512::RotL64(C[5], 54) ^ C[2];
-			C[4] += C[3];
-			C[3] = ULong512::RotL64(C[3], 56) ^ C[4];
-			// inject
-			x > 3 ? x -= 4 : x += 5;
-			C[1] += K[x];
-			x != 0 ? x -= 1 : x += 8;
-			C[0] += C[1] + K[x];
-			C[1] = ULong512::RotL64(C[1], 39) ^ C[0];
-			x < 6 ? x += 3 : x -= 6;
-			C[3] += K[x];
-			x != 0 ? x -= 1 : x += 8;
-			C[2] += C[3] + K[x];
-			C[3] = ULong512::RotL64(C[3], 30) ^ C[2];
-			x < 6 ? x += 3 : x -= 6;
-			C[5] += K[x] + T[y];
-			x != 0 ? x -= 1 : x += 8;
-			C[4] += C[5] + K[x];
-			C[5] = ULong512::RotL64(C[5], 34) ^ C[4];
-			// mix
-			x < 6 ? x += 3 : x -= 6;
-			C[7] += K[x] + ULong512((i * 2) + 1);
-			x != 0 ? x -= 1 : x += 8;
-			y != 2 ? y += 1 : y -= 2;
-			C[6] += C[7] + K[x] + T[y];
-			C[7] = ULong512::RotL64(C[7], 24) ^ C[6];
-			C[2] += C[1];
-			C[1] = ULong512::RotL64(C[1], 13) ^ C[2];
-			C[4] += C[7];
-			C[7] = ULong512::RotL64(C[7], 50) ^ C[4];
-			C[6] += C[5];
-			C[5] = ULong512::RotL64(C[5], 10) ^ C[6];
-			C[0] += C[3];
-			C[3] = ULong512::RotL64(C[3], 17) ^ C[0];
-			C[4] += C[1];
-			C[1] = ULong512::RotL64(C[1], 25) ^ C[4];
-			C[6] += C[3];
-			C[3] = ULong512::RotL64(C[3], 29) ^ C[6];
-			C[0] += C[5];
-			C[5] = ULong512::RotL64(C[5], 39) ^ C[0];
-			C[2] += C[7];
-			C[7] = ULong512::RotL64(C[7], 43) ^ C[2];
-			C[6] += C[1];
-			C[1] = ULong512::RotL64(C[1], 8) ^ C[6];
-			C[0] += C[7];
-			C[7] = ULong512::RotL64(C[7], 35) ^ C[0];
-			C[2] += C[5];
-			C[5] = ULong512::RotL64(C[5], 56) ^ C[2];
-			C[4] += C[3];
-			C[3] = ULong512::RotL64(C[3], 22) ^ C[4];
-			x > 3 ? x -= 4 : x += 5;
-		}
-
-		C[0] += K[0];
-		C[1] += K[1];
-		C[2] += K[2];
-		C[3] += K[3];
-		C[4] += K[4];
-		C[5] += K[5] + T[0];
-		C[6] += K[6] + T[1];
-		C[7] += K[7] + ULong512(Rounds / 4);
-
-		Store8xULL512(C, State);
-	}
-
-#elif defined(CEX_HAS_AVX2)
-
-	/// <summary>
-	/// The horizontally vectorized form of the Threefish-512 permutation function.
-	/// <para>This function processes 4*64 blocks of input in parallel using AVX2 instructions.
-	/// Note: The rounds count must be at least 72 and evenly divisible by 8.</para>
-	/// </summary>
-	/// 
-	/// <param name="Key">The input cipher key array (8x uint64)</param>
-	/// <param name="Counter">The cipher counter array (8x uint64)</param>
-	/// <param name="Tweak">The cipher tweak array (2x uint64)</param>
-	/// <param name="State">The permutations state array (32x uint64)</param>
-	/// <param name="Rounds">The number of mixing rounds; the default is 96</param>
-	template<typename ArrayU64x2, typename ArrayU64x8, typename ArrayU64x32>
-	static void PemuteP4x512H(const ArrayU64x8 &Key, const ArrayU64x8 &Counter, const ArrayU64x2 &Tweak, ArrayU64x32 &State, size_t Rounds)
-	{
-		std::array<ULong256, 8> C; // Note: time loading it here
-		std::array<ULong256, 9> K;
-		std::array<ULong256, 3> T;
-		size_t i;
-		size_t r;
-		size_t x;
-		size_t y;
-
-		C[0].Load(Counter, 0);
-		C[1].Load(Counter, 4);
-		C[2].Load(0xFFFFFFFFFFFFFFFFULL);
-		C[3].Load(0xFFFFFFFFFFFFFFFFULL);
-		C[4].Load(0xFFFFFFFFFFFFFFFFULL);
-		C[5].Load(0xFFFFFFFFFFFFFFFFULL);
-		C[6].Load(0xFFFFFFFFFFFFFFFFULL);
-		C[7].Load(0xFFFFFFFFFFFFFFFFULL);
-		K[0].Load(Key[0]);
-		K[1].Load(Key[1]);
-		K[2].Load(Key[2]);
-		K[3].Load(Key[3]);
-		K[4].Load(Key[4]);
-		K[5].Load(Key[5]);
-		K[6].Load(Key[6]);
-		K[7].Load(Key[7]);
-		K[8] = K[0] ^ K[1] ^ K[2] ^ K[3] ^ K[4] ^ K[5] ^ K[6] ^ K[7] ^ ULong256(0x1BD11BDAA9FC1A22ULL);
-		T[0].Load(Tweak[0]);
-		T[1].Load(Tweak[1]);
-		T[2] = T[0] ^ T[1];
-
-		r = Rounds / 8;
-		x = 1;
-		y = 0;
-
-		for (i = 0; i < r; ++i)
-		{
-			// round n+8, inject k
-			C[1] += K[x];
-			x != 0 ? x -= 1 : x += 8;
-			C[0] += C[1] + K[x];
-			C[1] = ULong256::RotL64(C[1], 46) ^ C[0];
-			x < 6 ? x += 3 : x -= 6;
-			C[3] += K[x];
-			x != 0 ? x -= 1 : x += 8;
-			C[2] += C[3] + K[x];
-			C[3] = ULong256::RotL64(C[3], 36) ^ C[2];
-			x < 6 ? x += 3 : x -= 6;
-			C[5] += K[x] + T[y];
-			x != 0 ? x -= 1 : x += 8;
-			C[4] += C[5] + K[x];
-			C[5] = ULong256::RotL64(C[5], 19) ^ C[4];
-			// mix
-			x < 6 ? x += 3 : x -= 6;
-			C[7] += K[x] + ULong256(static_cast<uint64_t>(i) * 2);
-			x != 0 ? x -= 1 : x += 8;
-			y != 2 ? y += 1 : y -= 2;
-			C[6] += C[7] + K[x] + T[y];
-			C[7] = ULong256::RotL64(C[7], 37) ^ C[6];
-			C[2] += C[1];
-			C[1] = ULong256::RotL64(C[1], 33) ^ C[2];
-			C[4] += C[7];
-			C[7] = ULong256::RotL64(C[7], 27) ^ C[4];
-			C[6] += C[5];
-			C[5] = ULong256::RotL64(C[5], 14) ^ C[6];
-			C[0] += C[3];
-			C[3] = ULong256::RotL64(C[3], 42) ^ C[0];
-			C[4] += C[1];
-			C[1] = ULong256::RotL64(C[1], 17) ^ C[4];
-			C[6] += C[3];
-			C[3] = ULong256::RotL64(C[3], 49) ^ C[6];
-			C[0] += C[5];
-			C[5] = ULong256::RotL64(C[5], 36) ^ C[0];
-			C[2] += C[7];
-			C[7] = ULong256::RotL64(C[7], 39) ^ C[2];
-			C[6] += C[1];
-			C[1] = ULong256::RotL64(C[1], 44) ^ C[6];
-			C[0] += C[7];
-			C[7] = ULong256::RotL64(C[7], 9) ^ C[0];
-			C[2] += C[5];
-			C[5] = ULong256::RotL64(C[5], 54) ^ C[2];
-			C[4] += C[3];
-			C[3] = ULong256::RotL64(C[3], 56) ^ C[4];
-			// inject
-			x > 3 ? x -= 4 : x += 5;
-			C[1] += K[x];
-			x != 0 ? x -= 1 : x += 8;
-			C[0] += C[1] + K[x];
-			C[1] = ULong256::RotL64(C[1], 39) ^ C[0];
-			x < 6 ? x += 3 : x -= 6;
-			C[3] += K[x];
-			x != 0 ? x -= 1 : x += 8;
-			C[2] += C[3] + K[x];
-			C[3] = ULong256::RotL64(C[3], 30) ^ C[2];
-			x < 6 ? x += 3 : x -= 6;
-			C[5] += K[x] + T[y];
-			x != 0 ? x -= 1 : x += 8;
-			C[4] += C[5] + K[x];
-			C[5] = ULong256::RotL64(C[5], 34) ^ C[4];
-			// mix
-			x < 6 ? x += 3 : x -= 6;
-			C[7] += K[x] + ULong256((static_cast<uint64_t>(i) * 2) + 1);
-			x != 0 ? x -= 1 : x += 8;
-			y != 2 ? y += 1 : y -= 2;
-			C[6] += C[7] + K[x] + T[y];
-			C[7] = ULong256::RotL64(C[7], 24) ^ C[6];
-			C[2] += C[1];
-			C[1] = ULong256::RotL64(C[1], 13) ^ C[2];
-			C[4] += C[7];
-			C[7] = ULong256::RotL64(C[7], 50) ^ C[4];
-			C[6] += C[5];
-			C[5] = ULong256::RotL64(C[5], 10) ^ C[6];
-			C[0] += C[3];
-			C[3] = ULong256::RotL64(C[3], 17) ^ C[0];
-			C[4] += C[1];
-			C[1] = ULong256::RotL64(C[1], 25) ^ C[4];
-			C[6] += C[3];
-			C[3] = ULong256::RotL64(C[3], 29) ^ C[6];
-			C[0] += C[5];
-			C[5] = ULong256::RotL64(C[5], 39) ^ C[0];
-			C[2] += C[7];
-			C[7] = ULong256::RotL64(C[7], 43) ^ C[2];
-			C[6] += C[1];
-			C[1] = ULong256::RotL64(C[1], 8) ^ C[6];
-			C[0] += C[7];
-			C[7] = ULong256::RotL64(C[7], 35) ^ C[0];
-			C[2] += C[5];
-			C[5] = ULong256::RotL64(C[5], 56) ^ C[2];
-			C[4] += C[3];
-			C[3] = ULong256::RotL64(C[3], 22) ^ C[4];
-			x > 3 ? x -= 4 : x += 5;
-		}
-
-		C[0] += K[0];
-		C[1] += K[1];
-		C[2] += K[2];
-		C[3] += K[3];
-		C[4] += K[4];
-		C[5] += K[5] + T[0];
-		C[6] += K[6] + T[1];
-		C[7] += K[7] + ULong256(Rounds / 4);
-
-		Store8xULL256(C, State);
-	}
-
-#endif
-
-	//~~~Threefish-1024~~~//
-
-	/// <summary>
-	/// The compact form of the Threefish-1024 permutation function.
-	/// <para>This function has been optimized for a small memory consumption.
-	/// To enable this function, add the CEX_DIGEST_COMPACT directive to the CexConfig file.
-	/// Note: The rounds count must be at least 72 and evenly divisible by 8.</para>
-	/// </summary>
-	/// 
-	/// <param name="Key">The input cipher key array (16x uint64)</param>
-	/// <param name="Counter">The cipher counter array (2x uint64)</param>
-	/// <param name="Tweak">The cipher tweak array (2x uint64)</param>
-	/// <param name="State">The permutations state array (16x uint64)</param>
-	/// <param name="Rounds">The number of mixing rounds; the default is 128</param>
-	template<typename ArrayU64x2, typename ArrayU64x16>
-	static void PemuteP1024C(const ArrayU64x16 &Key, const ArrayU64x2 &Counter, const ArrayU64x2 &Tweak, ArrayU64x16 &State, size_t Rounds)
-	{
-		std::array<uint64_t, 16> C;
-		std::array<uint64_t, 17> K;
-		std::array<uint64_t, 3> T;
-		size_t i;
-		size_t r;
-		size_t x;
-		size_t y;
-
-		MemoryTools::Copy(Counter, 0, C, 0, 2 * sizeof(uint64_t));
-		MemoryTools::SetValue(C, 2, 14 * sizeof(uint64_t), 0xFF);
-		MemoryTools::Copy(Key, 0, K, 0, 16 * sizeof(uint64_t));
-		K[16] = K[0] ^ K[1] ^ K[2] ^ K[3] ^ K[4] ^ K[5] ^ K[6] ^ K[7] ^ K[8] ^ K[9] ^ K[10] ^ K[11] ^ K[12] ^ K[13] ^ K[14] ^ K[15] ^ 0x1BD11BDAA9FC1A22ULL;
-		MemoryTools::Copy(Tweak, 0, T, 0, 2 * sizeof(uint64_t));
-		T[2] = T[0] ^ T[1];
-
-		r = Rounds / 8;
-		x = 1;
-		y = 0;
-
-		for (i = 0; i < r; ++i)
-		{
-			// round n+8, inject k
-			C[1] += K[x];
-			x != 0 ? x -= 1 : x += 16;
-			C[0] += C[1] + K[x];
-			C[1] = IntegerTools::RotL64(C[1], 24) ^ C[0];
-			x < 14 ? x += 3 : x -= 14;
-			C[3] += K[x];
-			x != 0 ? x -= 1 : x += 16;
-			C[2] += C[3] + K[x];
-			C[3] = IntegerTools::RotL64(C[3], 13) ^ C[2];
-			x < 14 ? x += 3 : x -= 14;
-			C[5] += K[x];
-			x != 0 ? x -= 1 : x += 16;
-			C[4] += C[5] + K[x];
-			C[5] = IntegerTools::RotL64(C[5], 8) ^ C[4];
-			x < 14 ? x += 3 : x -= 14;
-			C[7] += K[x];
-			x != 0 ? x -= 1 : x += 16;
-			C[6] += C[7] + K[x];
-			C[7] = IntegerTools::RotL64(C[7], 47) ^ C[6];
-			x < 14 ? x += 3 : x -= 14;
-			C[9] += K[x];
-			x != 0 ? x -= 1 : x += 16;
-			C[8] += C[9] + K[x];
-			C[9] = IntegerTools::RotL64(C[9], 8) ^ C[8];
-			x < 14 ? x += 3 : x -= 14;
-			C[11] += K[x];
-			x != 0 ? x -= 1 : x += 16;
-			C[10] += C[11] + K[x];
-			C[11] = IntegerTools::RotL64(C[11], 17) ^ C[10];
-			x < 14 ? x += 3 : x -= 14;
-			C[13] += K[x] + T[y];
-			x != 0 ? x -= 1 : x += 16;
-			C[12] += C[13] + K[x];
-			C[13] = IntegerTools::RotL64(C[13], 22) ^ C[12];
-			// mix
-			x < 14 ? x += 3 : x -= 14;
-			C[15] += K[x] + (static_cast<uint64_t>(i) * 2);
-			x != 0 ? x -= 1 : x += 16;
-			y != 2 ? y += 1 : y -= 2;
-			C[14] += C[15] + K[x] + T[y];
-			C[15] = IntegerTools::RotL64(C[15], 37) ^ C[14];
-			C[0] += C[9];
-			C[9] = IntegerTools::RotL64(C[9], 38) ^ C[0];
-			C[2] += C[13];
-			C[13] = IntegerTools::RotL64(C[13], 19) ^ C[2];
-			C[6] += C[11];
-			C[11] = IntegerTools::RotL64(C[11], 10) ^ C[6];
-			C[4] += C[15];
-			C[15] = IntegerTools::RotL64(C[15], 55) ^ C[4];
-			C[10] += C[7];
-			C[7] = IntegerTools::RotL64(C[7], 49) ^ C[10];
-			C[12] += C[3];
-			C[3] = IntegerTools::RotL64(C[3], 18) ^ C[12];
-			C[14] += C[5];
-			C[5] = IntegerTools::RotL64(C[5], 23) ^ C[14];
-			C[8] += C[1];
-			C[1] = IntegerTools::RotL64(C[1], 52) ^ C[8];
-			C[0] += C[7];
-			C[7] = IntegerTools::RotL64(C[7], 33) ^ C[0];
+			C[7] = IntegerTools::RotL64(C[7], 33) ^ C[0];
 			C[2] += C[5];
 			C[5] = IntegerTools::RotL64(C[5], 4) ^ C[2];
 			C[4] += C[3];
@@ -4786,550 +4130,6 @@ public:
 		State[15] = C15 + K1 + 30;
 	}
 
-#if defined(CEX_HAS_AVX512)
-
-	/// <summary>
-	/// The horizontally vectorized form of the Threefish-1024 permutation function.
-	/// <para>This function processes 8*128 blocks of input in parallel using AVX512 instructions.
-	/// Note: The rounds count must be at least 72 and evenly divisible by 8.</para>
-	/// </summary>
-	/// 
-	/// <param name="Key">The input cipher key array (16x uint64)</param>
-	/// <param name="Counter">The cipher counter array (16x uint64)</param>
-	/// <param name="Tweak">The cipher tweak array (2x uint64)</param>
-	/// <param name="State">The permutations state array (128x uint64)</param>
-	/// <param name="Rounds">The number of mixing rounds; the default is 128</param>
-	template<typename ArrayU64x2, typename ArrayU64x16, typename ArrayU64x128>
-	static void PemuteP8x1024H(const ArrayU64x16 &Key, const ArrayU64x16 &Counter, const ArrayU64x2 &Tweak, ArrayU64x128 &State, size_t Rounds)
-	{
-		std::array<ULong512, 16> C;
-		std::array<ULong512, 17> K;
-		std::array<ULong512, 3> T;
-		size_t i;
-		size_t r;
-		size_t x;
-		size_t y;
-
-		C[0].Load(Counter, 0);
-		C[1].Load(Counter, 8);
-		C[2].Load(0xFFFFFFFFFFFFFFFFULL);
-		C[3].Load(0xFFFFFFFFFFFFFFFFULL);
-		C[4].Load(0xFFFFFFFFFFFFFFFFULL);
-		C[5].Load(0xFFFFFFFFFFFFFFFFULL);
-		C[6].Load(0xFFFFFFFFFFFFFFFFULL);
-		C[7].Load(0xFFFFFFFFFFFFFFFFULL);
-		C[8].Load(0xFFFFFFFFFFFFFFFFULL);
-		C[9].Load(0xFFFFFFFFFFFFFFFFULL);
-		C[10].Load(0xFFFFFFFFFFFFFFFFULL);
-		C[11].Load(0xFFFFFFFFFFFFFFFFULL);
-		C[12].Load(0xFFFFFFFFFFFFFFFFULL);
-		C[13].Load(0xFFFFFFFFFFFFFFFFULL);
-		C[14].Load(0xFFFFFFFFFFFFFFFFULL);
-		C[15].Load(0xFFFFFFFFFFFFFFFFULL);
-		K[0].Load(Key[0]);
-		K[1].Load(Key[1]);
-		K[2].Load(Key[2]);
-		K[3].Load(Key[3]);
-		K[4].Load(Key[4]);
-		K[5].Load(Key[5]);
-		K[6].Load(Key[6]);
-		K[7].Load(Key[7]);
-		K[8].Load(Key[8]);
-		K[9].Load(Key[9]);
-		K[10].Load(Key[10]);
-		K[11].Load(Key[11]);
-		K[12].Load(Key[12]);
-		K[13].Load(Key[13]);
-		K[14].Load(Key[14]);
-		K[15].Load(Key[15]);
-		K[16] = K[0] ^ K[1] ^ K[2] ^ K[3] ^ K[4] ^ K[5] ^ K[6] ^ K[7] ^ K[8] ^ K[9] ^ K[10] ^ K[11] ^ K[12] ^ K[13] ^ K[14] ^ K[15] ^ ULong512(0x1BD11BDAA9FC1A22ULL);
-		T[0].Load(Tweak[0]);
-		T[1].Load(Tweak[1]);
-		T[2] = T[0] ^ T[1];
-
-		r = Rounds / 8;
-		x = 1;
-		y = 0;
-
-		for (i = 0; i < r; ++i)
-		{
-			// round n+8, inject k
-			C[1] += K[x];
-			x != 0 ? x -= 1 : x += 16;
-			C[0] += C[1] + K[x];
-			C[1] = ULong512::RotL64(C[1], 24) ^ C[0];
-			x < 14 ? x += 3 : x -= 14;
-			C[3] += K[x];
-			x != 0 ? x -= 1 : x += 16;
-			C[2] += C[3] + K[x];
-			C[3] = ULong512::RotL64(C[3], 13) ^ C[2];
-			x < 14 ? x += 3 : x -= 14;
-			C[5] += K[x];
-			x != 0 ? x -= 1 : x += 16;
-			C[4] += C[5] + K[x];
-			C[5] = ULong512::RotL64(C[5], 8) ^ C[4];
-			x < 14 ? x += 3 : x -= 14;
-			C[7] += K[x];
-			x != 0 ? x -= 1 : x += 16;
-			C[6] += C[7] + K[x];
-			C[7] = ULong512::RotL64(C[7], 47) ^ C[6];
-			x < 14 ? x += 3 : x -= 14;
-			C[9] += K[x];
-			x != 0 ? x -= 1 : x += 16;
-			C[8] += C[9] + K[x];
-			C[9] = ULong512::RotL64(C[9], 8) ^ C[8];
-			x < 14 ? x += 3 : x -= 14;
-			C[11] += K[x];
-			x != 0 ? x -= 1 : x += 16;
-			C[10] += C[11] + K[x];
-			C[11] = ULong512::RotL64(C[11], 17) ^ C[10];
-			x < 14 ? x += 3 : x -= 14;
-			C[13] += K[x] + T[y];
-			x != 0 ? x -= 1 : x += 16;
-			C[12] += C[13] + K[x];
-			C[13] = ULong512::RotL64(C[13], 22) ^ C[12];
-			// mix
-			x < 14 ? x += 3 : x -= 14;
-			C[15] += K[x] + ULong512(i * 2);
-			x != 0 ? x -= 1 : x += 16;
-			y != 2 ? y += 1 : y -= 2;
-			C[14] += C[15] + K[x] + T[y];
-			C[15] = ULong512::RotL64(C[15], 37) ^ C[14];
-			C[0] += C[9];
-			C[9] = ULong512::RotL64(C[9], 38) ^ C[0];
-			C[2] += C[13];
-			C[13] = ULong512::RotL64(C[13], 19) ^ C[2];
-			C[6] += C[11];
-			C[11] = ULong512::RotL64(C[11], 10) ^ C[6];
-			C[4] += C[15];
-			C[15] = ULong512::RotL64(C[15], 55) ^ C[4];
-			C[10] += C[7];
-			C[7] = ULong512::RotL64(C[7], 49) ^ C[10];
-			C[12] += C[3];
-			C[3] = ULong512::RotL64(C[3], 18) ^ C[12];
-			C[14] += C[5];
-			C[5] = ULong512::RotL64(C[5], 23) ^ C[14];
-			C[8] += C[1];
-			C[1] = ULong512::RotL64(C[1], 52) ^ C[8];
-			C[0] += C[7];
-			C[7] = ULong512::RotL64(C[7], 33) ^ C[0];
-			C[2] += C[5];
-			C[5] = ULong512::RotL64(C[5], 4) ^ C[2];
-			C[4] += C[3];
-			C[3] = ULong512::RotL64(C[3], 51) ^ C[4];
-			C[6] += C[1];
-			C[1] = ULong512::RotL64(C[1], 13) ^ C[6];
-			C[12] += C[15];
-			C[15] = ULong512::RotL64(C[15], 34) ^ C[12];
-			C[14] += C[13];
-			C[13] = ULong512::RotL64(C[13], 41) ^ C[14];
-			C[8] += C[11];
-			C[11] = ULong512::RotL64(C[11], 59) ^ C[8];
-			C[10] += C[9];
-			C[9] = ULong512::RotL64(C[9], 17) ^ C[10];
-			C[0] += C[15];
-			C[15] = ULong512::RotL64(C[15], 5) ^ C[0];
-			C[2] += C[11];
-			C[11] = ULong512::RotL64(C[11], 20) ^ C[2];
-			C[6] += C[13];
-			C[13] = ULong512::RotL64(C[13], 48) ^ C[6];
-			C[4] += C[9];
-			C[9] = ULong512::RotL64(C[9], 41) ^ C[4];
-			C[14] += C[1];
-			C[1] = ULong512::RotL64(C[1], 47) ^ C[14];
-			C[8] += C[5];
-			C[5] = ULong512::RotL64(C[5], 28) ^ C[8];
-			C[10] += C[3];
-			C[3] = ULong512::RotL64(C[3], 16) ^ C[10];
-			C[12] += C[7];
-			C[7] = ULong512::RotL64(C[7], 25) ^ C[12];
-			// inject
-			x > 11 ? x -= 12 : x += 5;
-			C[1] += K[x];
-			x != 0 ? x -= 1 : x += 16;
-			C[0] += C[1] + K[x];
-			C[1] = ULong512::RotL64(C[1], 41) ^ C[0];
-			x < 14 ? x += 3 : x -= 14;
-			C[3] += K[x];
-			x != 0 ? x -= 1 : x += 16;
-			C[2] += C[3] + K[x];
-			C[3] = ULong512::RotL64(C[3], 9) ^ C[2];
-			x < 14 ? x += 3 : x -= 14;
-			C[5] += K[x];
-			x != 0 ? x -= 1 : x += 16;
-			C[4] += C[5] + K[x];
-			C[5] = ULong512::RotL64(C[5], 37) ^ C[4];
-			x < 14 ? x += 3 : x -= 14;
-			C[7] += K[x];
-			x != 0 ? x -= 1 : x += 16;
-			C[6] += C[7] + K[x];
-			C[7] = ULong512::RotL64(C[7], 31) ^ C[6];
-			x < 14 ? x += 3 : x -= 14;
-			C[9] += K[x];
-			x != 0 ? x -= 1 : x += 16;
-			C[8] += C[9] + K[x];
-			C[9] = ULong512::RotL64(C[9], 12) ^ C[8];
-			x < 14 ? x += 3 : x -= 14;
-			C[11] += K[x];
-			x != 0 ? x -= 1 : x += 16;
-			C[10] += C[11] + K[x];
-			C[11] = ULong512::RotL64(C[11], 47) ^ C[10];
-			x < 14 ? x += 3 : x -= 14;
-			C[13] += K[x] + T[y];
-			x != 0 ? x -= 1 : x += 16;
-			C[12] += C[13] + K[x];
-			C[13] = ULong512::RotL64(C[13], 44) ^ C[12];
-			// mix
-			x < 14 ? x += 3 : x -= 14;
-			C[15] += K[x] + ULong512((i * 2) + 1);
-			x != 0 ? x -= 1 : x += 16;
-			y != 2 ? y += 1 : y -= 2;
-			C[14] += C[15] + K[x] + T[y];
-			C[15] = ULong512::RotL64(C[15], 30) ^ C[14];
-			C[0] += C[9];
-			C[9] = ULong512::RotL64(C[9], 16) ^ C[0];
-			C[2] += C[13];
-			C[13] = ULong512::RotL64(C[13], 34) ^ C[2];
-			C[6] += C[11];
-			C[11] = ULong512::RotL64(C[11], 56) ^ C[6];
-			C[4] += C[15];
-			C[15] = ULong512::RotL64(C[15], 51) ^ C[4];
-			C[10] += C[7];
-			C[7] = ULong512::RotL64(C[7], 4) ^ C[10];
-			C[12] += C[3];
-			C[3] = ULong512::RotL64(C[3], 53) ^ C[12];
-			C[14] += C[5];
-			C[5] = ULong512::RotL64(C[5], 42) ^ C[14];
-			C[8] += C[1];
-			C[1] = ULong512::RotL64(C[1], 41) ^ C[8];
-			C[0] += C[7];
-			C[7] = ULong512::RotL64(C[7], 31) ^ C[0];
-			C[2] += C[5];
-			C[5] = ULong512::RotL64(C[5], 44) ^ C[2];
-			C[4] += C[3];
-			C[3] = ULong512::RotL64(C[3], 47) ^ C[4];
-			C[6] += C[1];
-			C[1] = ULong512::RotL64(C[1], 46) ^ C[6];
-			C[12] += C[15];
-			C[15] = ULong512::RotL64(C[15], 19) ^ C[12];
-			C[14] += C[13];
-			C[13] = ULong512::RotL64(C[13], 42) ^ C[14];
-			C[8] += C[11];
-			C[11] = ULong512::RotL64(C[11], 44) ^ C[8];
-			C[10] += C[9];
-			C[9] = ULong512::RotL64(C[9], 25) ^ C[10];
-			C[0] += C[15];
-			C[15] = ULong512::RotL64(C[15], 9) ^ C[0];
-			C[2] += C[11];
-			C[11] = ULong512::RotL64(C[11], 48) ^ C[2];
-			C[6] += C[13];
-			C[13] = ULong512::RotL64(C[13], 35) ^ C[6];
-			C[4] += C[9];
-			C[9] = ULong512::RotL64(C[9], 52) ^ C[4];
-			C[14] += C[1];
-			C[1] = ULong512::RotL64(C[1], 23) ^ C[14];
-			C[8] += C[5];
-			C[5] = ULong512::RotL64(C[5], 31) ^ C[8];
-			C[10] += C[3];
-			C[3] = ULong512::RotL64(C[3], 37) ^ C[10];
-			C[12] += C[7];
-			C[7] = ULong512::RotL64(C[7], 20) ^ C[12];
-			x > 11 ? x -= 12 : x += 5;
-		}
-
-		C[0] += K[3];
-		C[1] += K[4];
-		C[2] += K[5];
-		C[3] += K[6];
-		C[4] += K[7];
-		C[5] += K[8];
-		C[6] += K[9];
-		C[7] += K[10];
-		C[8] += K[11];
-		C[9] += K[12];
-		C[10] += K[13];
-		C[11] += K[14];
-		C[12] += K[15];
-		C[13] += K[16] + T[2];
-		C[14] += K[0] + T[0];
-		C[15] += K[1] + ULong512(Rounds / 4);
-
-		Store16xULL512(C, State);
-	}
-
-#elif defined(CEX_HAS_AVX2)
-
-	/// <summary>
-	/// The horizontally vectorized form of the Threefish-1024 permutation function.
-	/// <para>This function processes 4*128 blocks of input in parallel using AVX2 instructions.
-	/// Note: The rounds count must be at least 72 and evenly divisible by 8.</para>
-	/// </summary>
-	/// 
-	/// <param name="Key">The input cipher key array (16x uint64)</param>
-	/// <param name="Counter">The cipher counter array (8x uint64)</param>
-	/// <param name="Tweak">The cipher tweak array (2x uint64)</param>
-	/// <param name="State">The permutations state array (64x uint64)</param>
-	/// <param name="Rounds">The number of mixing rounds; the default is 128</param>
-	template<typename ArrayU64x2, typename ArrayU64x8, typename ArrayU64x16, typename ArrayU64x64>
-	static void PemuteP4x1024H(const ArrayU64x16 &Key, const ArrayU64x8 &Counter, const ArrayU64x2 &Tweak, ArrayU64x64 &State, size_t Rounds)
-	{
-		std::array<ULong256, 16> C;
-		std::array<ULong256, 17> K;
-		std::array<ULong256, 3> T;
-		size_t i;
-		size_t r;
-		size_t x;
-		size_t y;
-
-		C[0].Load(Counter, 0);
-		C[1].Load(Counter, 4);
-		C[2].Load(0xFFFFFFFFFFFFFFFFULL);
-		C[3].Load(0xFFFFFFFFFFFFFFFFULL);
-		C[4].Load(0xFFFFFFFFFFFFFFFFULL);
-		C[5].Load(0xFFFFFFFFFFFFFFFFULL);
-		C[6].Load(0xFFFFFFFFFFFFFFFFULL);
-		C[7].Load(0xFFFFFFFFFFFFFFFFULL);
-		C[8].Load(0xFFFFFFFFFFFFFFFFULL);
-		C[9].Load(0xFFFFFFFFFFFFFFFFULL);
-		C[10].Load(0xFFFFFFFFFFFFFFFFULL);
-		C[11].Load(0xFFFFFFFFFFFFFFFFULL);
-		C[12].Load(0xFFFFFFFFFFFFFFFFULL);
-		C[13].Load(0xFFFFFFFFFFFFFFFFULL);
-		C[14].Load(0xFFFFFFFFFFFFFFFFULL);
-		C[15].Load(0xFFFFFFFFFFFFFFFFULL);
-		K[0].Load(Key[0]);
-		K[1].Load(Key[1]);
-		K[2].Load(Key[2]);
-		K[3].Load(Key[3]);
-		K[4].Load(Key[4]);
-		K[5].Load(Key[5]);
-		K[6].Load(Key[6]);
-		K[7].Load(Key[7]);
-		K[8].Load(Key[8]);
-		K[9].Load(Key[9]);
-		K[10].Load(Key[10]);
-		K[11].Load(Key[11]);
-		K[12].Load(Key[12]);
-		K[13].Load(Key[13]);
-		K[14].Load(Key[14]);
-		K[15].Load(Key[15]);
-		K[16] = K[0] ^ K[1] ^ K[2] ^ K[3] ^ K[4] ^ K[5] ^ K[6] ^ K[7] ^ K[8] ^ K[9] ^ K[10] ^ K[11] ^ K[12] ^ K[13] ^ K[14] ^ K[15] ^ ULong256(0x1BD11BDAA9FC1A22ULL);
-		T[0].Load(Tweak[0]);
-		T[1].Load(Tweak[1]);
-		T[2] = T[0] ^ T[1];
-
-		r = Rounds / 8;
-		x = 1;
-		y = 0;
-
-		for (i = 0; i < r; ++i)
-		{
-			// round n+8, inject k
-			C[1] += K[x];
-			x != 0 ? x -= 1 : x += 16;
-			C[0] += C[1] + K[x];
-			C[1] = ULong256::RotL64(C[1], 24) ^ C[0];
-			x < 14 ? x += 3 : x -= 14;
-			C[3] += K[x];
-			x != 0 ? x -= 1 : x += 16;
-			C[2] += C[3] + K[x];
-			C[3] = ULong256::RotL64(C[3], 13) ^ C[2];
-			x < 14 ? x += 3 : x -= 14;
-			C[5] += K[x];
-			x != 0 ? x -= 1 : x += 16;
-			C[4] += C[5] + K[x];
-			C[5] = ULong256::RotL64(C[5], 8) ^ C[4];
-			x < 14 ? x += 3 : x -= 14;
-			C[7] += K[x];
-			x != 0 ? x -= 1 : x += 16;
-			C[6] += C[7] + K[x];
-			C[7] = ULong256::RotL64(C[7], 47) ^ C[6];
-			x < 14 ? x += 3 : x -= 14;
-			C[9] += K[x];
-			x != 0 ? x -= 1 : x += 16;
-			C[8] += C[9] + K[x];
-			C[9] = ULong256::RotL64(C[9], 8) ^ C[8];
-			x < 14 ? x += 3 : x -= 14;
-			C[11] += K[x];
-			x != 0 ? x -= 1 : x += 16;
-			C[10] += C[11] + K[x];
-			C[11] = ULong256::RotL64(C[11], 17) ^ C[10];
-			x < 14 ? x += 3 : x -= 14;
-			C[13] += K[x] + T[y];
-			x != 0 ? x -= 1 : x += 16;
-			C[12] += C[13] + K[x];
-			C[13] = ULong256::RotL64(C[13], 22) ^ C[12];
-			// mix
-			x < 14 ? x += 3 : x -= 14;
-			C[15] += K[x] + ULong256(static_cast<uint64_t>(i) * 2);
-			x != 0 ? x -= 1 : x += 16;
-			y != 2 ? y += 1 : y -= 2;
-			C[14] += C[15] + K[x] + T[y];
-			C[15] = ULong256::RotL64(C[15], 37) ^ C[14];
-			C[0] += C[9];
-			C[9] = ULong256::RotL64(C[9], 38) ^ C[0];
-			C[2] += C[13];
-			C[13] = ULong256::RotL64(C[13], 19) ^ C[2];
-			C[6] += C[11];
-			C[11] = ULong256::RotL64(C[11], 10) ^ C[6];
-			C[4] += C[15];
-			C[15] = ULong256::RotL64(C[15], 55) ^ C[4];
-			C[10] += C[7];
-			C[7] = ULong256::RotL64(C[7], 49) ^ C[10];
-			C[12] += C[3];
-			C[3] = ULong256::RotL64(C[3], 18) ^ C[12];
-			C[14] += C[5];
-			C[5] = ULong256::RotL64(C[5], 23) ^ C[14];
-			C[8] += C[1];
-			C[1] = ULong256::RotL64(C[1], 52) ^ C[8];
-			C[0] += C[7];
-			C[7] = ULong256::RotL64(C[7], 33) ^ C[0];
-			C[2] += C[5];
-			C[5] = ULong256::RotL64(C[5], 4) ^ C[2];
-			C[4] += C[3];
-			C[3] = ULong256::RotL64(C[3], 51) ^ C[4];
-			C[6] += C[1];
-			C[1] = ULong256::RotL64(C[1], 13) ^ C[6];
-			C[12] += C[15];
-			C[15] = ULong256::RotL64(C[15], 34) ^ C[12];
-			C[14] += C[13];
-			C[13] = ULong256::RotL64(C[13], 41) ^ C[14];
-			C[8] += C[11];
-			C[11] = ULong256::RotL64(C[11], 59) ^ C[8];
-			C[10] += C[9];
-			C[9] = ULong256::RotL64(C[9], 17) ^ C[10];
-			C[0] += C[15];
-			C[15] = ULong256::RotL64(C[15], 5) ^ C[0];
-			C[2] += C[11];
-			C[11] = ULong256::RotL64(C[11], 20) ^ C[2];
-			C[6] += C[13];
-			C[13] = ULong256::RotL64(C[13], 48) ^ C[6];
-			C[4] += C[9];
-			C[9] = ULong256::RotL64(C[9], 41) ^ C[4];
-			C[14] += C[1];
-			C[1] = ULong256::RotL64(C[1], 47) ^ C[14];
-			C[8] += C[5];
-			C[5] = ULong256::RotL64(C[5], 28) ^ C[8];
-			C[10] += C[3];
-			C[3] = ULong256::RotL64(C[3], 16) ^ C[10];
-			C[12] += C[7];
-			C[7] = ULong256::RotL64(C[7], 25) ^ C[12];
-			// inject
-			x > 11 ? x -= 12 : x += 5;
-			C[1] += K[x];
-			x != 0 ? x -= 1 : x += 16;
-			C[0] += C[1] + K[x];
-			C[1] = ULong256::RotL64(C[1], 41) ^ C[0];
-			x < 14 ? x += 3 : x -= 14;
-			C[3] += K[x];
-			x != 0 ? x -= 1 : x += 16;
-			C[2] += C[3] + K[x];
-			C[3] = ULong256::RotL64(C[3], 9) ^ C[2];
-			x < 14 ? x += 3 : x -= 14;
-			C[5] += K[x];
-			x != 0 ? x -= 1 : x += 16;
-			C[4] += C[5] + K[x];
-			C[5] = ULong256::RotL64(C[5], 37) ^ C[4];
-			x < 14 ? x += 3 : x -= 14;
-			C[7] += K[x];
-			x != 0 ? x -= 1 : x += 16;
-			C[6] += C[7] + K[x];
-			C[7] = ULong256::RotL64(C[7], 31) ^ C[6];
-			x < 14 ? x += 3 : x -= 14;
-			C[9] += K[x];
-			x != 0 ? x -= 1 : x += 16;
-			C[8] += C[9] + K[x];
-			C[9] = ULong256::RotL64(C[9], 12) ^ C[8];
-			x < 14 ? x += 3 : x -= 14;
-			C[11] += K[x];
-			x != 0 ? x -= 1 : x += 16;
-			C[10] += C[11] + K[x];
-			C[11] = ULong256::RotL64(C[11], 47) ^ C[10];
-			x < 14 ? x += 3 : x -= 14;
-			C[13] += K[x] + T[y];
-			x != 0 ? x -= 1 : x += 16;
-			C[12] += C[13] + K[x];
-			C[13] = ULong256::RotL64(C[13], 44) ^ C[12];
-			// mix
-			x < 14 ? x += 3 : x -= 14;
-			C[15] += K[x] + ULong256((static_cast<uint64_t>(i) * 2) + 1);
-			x != 0 ? x -= 1 : x += 16;
-			y != 2 ? y += 1 : y -= 2;
-			C[14] += C[15] + K[x] + T[y];
-			C[15] = ULong256::RotL64(C[15], 30) ^ C[14];
-			C[0] += C[9];
-			C[9] = ULong256::RotL64(C[9], 16) ^ C[0];
-			C[2] += C[13];
-			C[13] = ULong256::RotL64(C[13], 34) ^ C[2];
-			C[6] += C[11];
-			C[11] = ULong256::RotL64(C[11], 56) ^ C[6];
-			C[4] += C[15];
-			C[15] = ULong256::RotL64(C[15], 51) ^ C[4];
-			C[10] += C[7];
-			C[7] = ULong256::RotL64(C[7], 4) ^ C[10];
-			C[12] += C[3];
-			C[3] = ULong256::RotL64(C[3], 53) ^ C[12];
-			C[14] += C[5];
-			C[5] = ULong256::RotL64(C[5], 42) ^ C[14];
-			C[8] += C[1];
-			C[1] = ULong256::RotL64(C[1], 41) ^ C[8];
-			C[0] += C[7];
-			C[7] = ULong256::RotL64(C[7], 31) ^ C[0];
-			C[2] += C[5];
-			C[5] = ULong256::RotL64(C[5], 44) ^ C[2];
-			C[4] += C[3];
-			C[3] = ULong256::RotL64(C[3], 47) ^ C[4];
-			C[6] += C[1];
-			C[1] = ULong256::RotL64(C[1], 46) ^ C[6];
-			C[12] += C[15];
-			C[15] = ULong256::RotL64(C[15], 19) ^ C[12];
-			C[14] += C[13];
-			C[13] = ULong256::RotL64(C[13], 42) ^ C[14];
-			C[8] += C[11];
-			C[11] = ULong256::RotL64(C[11], 44) ^ C[8];
-			C[10] += C[9];
-			C[9] = ULong256::RotL64(C[9], 25) ^ C[10];
-			C[0] += C[15];
-			C[15] = ULong256::RotL64(C[15], 9) ^ C[0];
-			C[2] += C[11];
-			C[11] = ULong256::RotL64(C[11], 48) ^ C[2];
-			C[6] += C[13];
-			C[13] = ULong256::RotL64(C[13], 35) ^ C[6];
-			C[4] += C[9];
-			C[9] = ULong256::RotL64(C[9], 52) ^ C[4];
-			C[14] += C[1];
-			C[1] = ULong256::RotL64(C[1], 23) ^ C[14];
-			C[8] += C[5];
-			C[5] = ULong256::RotL64(C[5], 31) ^ C[8];
-			C[10] += C[3];
-			C[3] = ULong256::RotL64(C[3], 37) ^ C[10];
-			C[12] += C[7];
-			C[7] = ULong256::RotL64(C[7], 20) ^ C[12];
-			x > 11 ? x -= 12 : x += 5;
-		}
-
-		C[0] += K[3];
-		C[1] += K[4];
-		C[2] += K[5];
-		C[3] += K[6];
-		C[4] += K[7];
-		C[5] += K[8];
-		C[6] += K[9];
-		C[7] += K[10];
-		C[8] += K[11];
-		C[9] += K[12];
-		C[10] += K[13];
-		C[11] += K[14];
-		C[12] += K[15];
-		C[13] += K[16] + T[2];
-		C[14] += K[0] + T[0];
-		C[15] += K[1] + ULong256(Rounds / 4);
-
-		Store16xULL256(C, State);
-	}
-
-#endif
-
 };
 
 NAMESPACE_STREAMEND
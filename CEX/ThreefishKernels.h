@@ -0,0 +1,75 @@
+#ifndef CEX_THREEFISHKERNELS_H
+#define CEX_THREEFISHKERNELS_H
+
+#include "CexDomain.h"
+#include "SimdProfiles.h"
+
+NAMESPACE_STREAM
+
+using Enumeration::SimdProfiles;
+
+/// cond private
+
+/// <summary>
+/// Internal class: the wide Threefish permutations, each built in its own instruction set translation unit.
+/// <para>ThreefishAvx2.cpp and ThreefishAvx512.cpp are compiled with the AVX2 and AVX512 code generation flags respectively, and each holds its own permutations.
+/// The units are self-contained: the permutations, and the SIMD wrapper they are written with, have internal linkage, and the units include no shared header with instruction set branches.
+/// Key holds the cipher key words and Tweak the two tweak words; Counter holds the low counter word of every lane followed by the high words, 
+/// and State receives one block for each lane, the blocks written one after another.
+/// A unit compiled without its instruction set reports the variant as absent, and its functions throw if called.
+/// The ciphers select a variant at run-time with SimdDispatch::Select(Compiled(), SimdKernels, Length).</para>
+/// </summary>
+class ThreefishKernels final
+{
+public:
+
+	/// <summary>
+	/// The widest kernel variant compiled into the library
+	/// </summary>
+	static SimdProfiles Compiled();
+
+	/// <summary>
+	/// The AVX2 kernels were compiled
+	/// </summary>
+	static bool HasAvx2();
+
+	/// <summary>
+	/// The AVX512 kernels were compiled
+	/// </summary>
+	static bool HasAvx512();
+
+	/// <summary>
+	/// The Threefish-256 permutation of 4 blocks using AVX2 instructions
+	/// </summary>
+	static void PemuteP4x256H(const uint64_t* Key, const uint64_t* Counter, const uint64_t* Tweak, uint64_t* State, size_t Rounds);
+
+	/// <summary>
+	/// The Threefish-512 permutation of 4 blocks using AVX2 instructions
+	/// </summary>
+	static void PemuteP4x512H(const uint64_t* Key, const uint64_t* Counter, const uint64_t* Tweak, uint64_t* State, size_t Rounds);
+
+	/// <summary>
+	/// The Threefish-1024 permutation of 4 blocks using AVX2 instructions
+	/// </summary>
+	static void PemuteP4x1024H(const uint64_t* Key, const uint64_t* Counter, const uint64_t* Tweak, uint64_t* State, size_t Rounds);
+
+	/// <summary>
+	/// The Threefish-256 permutation of 8 blocks using AVX512 instructions
+	/// </summary>
+	static void PemuteP8x256H(const uint64_t* Key, const uint64_t* Counter, const uint64_t* Tweak, uint64_t* State, size_t Rounds);
+
+	/// <summary>
+	/// The Threefish-512 permutation of 8 blocks using AVX512 instructions
+	/// </summary>
+	static void PemuteP8x512H(const uint64_t* Key, const uint64_t* Counter, const uint64_t* Tweak, uint64_t* State, size_t Rounds);
+
+	/// <summary>
+	/// The Threefish-1024 permutation of 8 blocks using AVX512 instructions
+	/// </summary>
+	static void PemuteP8x1024H(const uint64_t* Key, const uint64_t* Counter, const uint64_t* Tweak, uint64_t* State, size_t Rounds);
+};
+
+/// endcond
+
+NAMESPACE_STREAMEND
+#endif
@@ -0,0 +1,190 @@
+#include "TransformHandle.h"
+#include "CryptoProcessingException.h"
+#include "ParallelTools.h"
+#include "WorkStealingPool.h"
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+
+NAMESPACE_ROOT
+
+using Exception::CryptoProcessingException;
+using Enumeration::ErrorCodes;
+using Tools::ParallelTools;
+using Tools::WorkStealingPool;
+
+class TransformHandle::TransformState
+{
+public:
+
+	std::condition_variable Condition;
+	std::exception_ptr Error;
+	std::mutex Mutex;
+	std::atomic<size_t> Processed;
+	std::atomic<bool> IsCancelled;
+	std::atomic<bool> IsReady;
+	std::atomic<bool> CancelRequested;
+
+	TransformState()
+		:
+		Condition(),
+		Error(nullptr),
+		Mutex(),
+		Processed(0),
+		IsCancelled(false),
+		IsReady(false),
+		CancelRequested(false)
+	{
+	}
+};
+
+//~~~Constructor~~~//
+
+TransformHandle::TransformHandle()
+	:
+	m_transformState(nullptr)
+{
+}
+
+TransformHandle::TransformHandle(const std::shared_ptr<TransformState> &State)
+	:
+	m_transformState(State)
+{
+}
+
+TransformHandle::~TransformHandle()
+{
+}
+
+//~~~Accessors~~~//
+
+bool TransformHandle::IsCancelled() const
+{
+	return (m_transformState != nullptr && m_transformState->IsCancelled);
+}
+
+bool TransformHandle::IsReady() const
+{
+	return (m_transformState != nullptr && m_transformState->IsReady);
+}
+
+bool TransformHandle::IsValid() const
+{
+	return (m_transformState != nullptr);
+}
+
+size_t TransformHandle::Processed() const
+{
+	return (m_transformState != nullptr) ? m_transformState->Processed.load() : 0;
+}
+
+//~~~Public Functions~~~//
+
+void TransformHandle::Cancel()
+{
+	if (m_transformState != nullptr)
+	{
+		m_transformState->CancelRequested = true;
+	}
+}
+
+void TransformHandle::Get()
+{
+	Wait();
+
+	if (m_transformState->Error != nullptr)
+	{
+		std::rethrow_exception(m_transformState->Error);
+	}
+}
+
+TransformHandle TransformHandle::Start(ParallelOptions &Options, size_t Length, size_t ChunkSize, const std::function<void(size_t, size_t)> &Process, const std::function<void(TransformHandle &)> &Completion)
+{
+	std::shared_ptr<TransformState> state = std::make_shared<TransformState>();
+	IParallelExecutor* exec;
+
+	// the cipher's executor, then the process-wide executor, then the library pool
+	exec = (Options.Executor() != nullptr) ? Options.Executor() : ParallelTools::Executor();
+
+	if (exec == nullptr)
+	{
+		exec = &WorkStealingPool::Instance();
+	}
+
+	// the queued task holds its own reference to the state and copies of the functions
+	exec->Submit([state, Length, ChunkSize, Process, Completion]() mutable
+	{
+		Execute(state, Length, ChunkSize, Process, Completion);
+	});
+
+	return TransformHandle(state);
+}
+
+void TransformHandle::Wait()
+{
+	if (m_transformState == nullptr)
+	{
+		throw CryptoProcessingException(std::string("TransformHandle"), std::string("Wait"), std::string("The handle is not attached to a transform!"), ErrorCodes::IllegalOperation);
+	}
+
+	if (!m_transformState->IsReady)
+	{
+		std::unique_lock<std::mutex> lock(m_transformState->Mutex);
+		m_transformState->Condition.wait(lock, [this]() { return m_transformState->IsReady.load(); });
+	}
+}
+
+//~~~Private Functions~~~//
+
+void TransformHandle::Execute(std::shared_ptr<TransformState> &State, size_t Length, size_t ChunkSize, const std::function<void(size_t, size_t)> &Process, const std::function<void(TransformHandle &)> &Completion)
+{
+	size_t clen;
+	size_t pos;
+	bool cmp;
+
+	cmp = false;
+	pos = 0;
+
+	try
+	{
+		// an empty message is still processed once, an authenticator produces a tag
+		while (!cmp && !State->CancelRequested)
+		{
+			clen = (ChunkSize == 0 || Length - pos < ChunkSize) ? Length - pos : ChunkSize;
+			Process(pos, clen);
+			pos += clen;
+			State->Processed = pos;
+			cmp = (pos == Length);
+		}
+	}
+	catch (...)
+	{
+		State->Error = std::current_exception();
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(State->Mutex);
+
+		State->IsCancelled = (State->Error == nullptr && !cmp);
+		State->IsReady = true;
+	}
+
+	State->Condition.notify_all();
+
+	if (Completion)
+	{
+		TransformHandle hnd(State);
+
+		try
+		{
+			Completion(hnd);
+		}
+		catch (...)
+		{
+			// the callback runs on a pool thread, an exception can not be delivered
+		}
+	}
+}
+
+NAMESPACE_ROOTEND
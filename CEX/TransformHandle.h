@@ -0,0 +1,140 @@
+// The GPL version 3 License (GPLv3)
+//
+// Copyright (c) 2023 QSCS.ca
+// This file is part of the CEX Cryptographic library.
+//
+// This program is free software : you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef CEX_TRANSFORMHANDLE_H
+#define CEX_TRANSFORMHANDLE_H
+
+#include "CexDomain.h"
+#include "ParallelOptions.h"
+#include <functional>
+#include <memory>
+
+NAMESPACE_ROOT
+
+/// <summary>
+/// The completion handle of an asynchronous cipher transform, returned by the TransformAsync functions of the cipher interfaces.
+/// <para>The transform runs on the cipher's executor, the process-wide executor, or the library's work-stealing pool, so the calling thread can continue other work while it runs. 
+/// Wait() blocks until the transform has stopped, and Get() also re-throws an exception thrown by the transform. \n
+/// A cipher mode, or a stream cipher without an authenticator, is processed in ParallelBlockSize() chunks; Cancel() stops the transform at the next chunk boundary, 
+/// and Processed() reports the number of bytes that were written to the output. An authenticated transform is a single message, and can only be cancelled before it starts. 
+/// A cancelled cipher must be initialized again before it is reused.</para>
+/// <para>The input and output arrays and the cipher instance must remain valid, and the cipher must not be used by another call, until the handle is ready. 
+/// The handle is a shared reference; copies refer to the same transform.</para>
+/// </summary>
+///
+/// <example>
+/// <description>Encrypting a large message while the calling thread continues other work:</description>
+/// <code>
+/// CTR cpr(BlockCiphers::AES);
+/// cpr.Initialize(true, kp);
+/// TransformHandle hnd = cpr.TransformAsync(Input, 0, Output, 0, Input.size());
+/// // ... other work
+/// hnd.Get();
+/// </code>
+/// </example>
+class TransformHandle final
+{
+private:
+
+	class TransformState;
+	std::shared_ptr<TransformState> m_transformState;
+
+	explicit TransformHandle(const std::shared_ptr<TransformState> &State);
+
+public:
+
+	//~~~Constructor~~~//
+
+	/// <summary>
+	/// Constructor: instantiate an empty handle that is not attached to a transform
+	/// </summary>
+	TransformHandle();
+
+	/// <summary>
+	/// Destructor: finalize this class; an attached transform continues to run
+	/// </summary>
+	~TransformHandle();
+
+	//~~~Accessors~~~//
+
+	/// <summary>
+	/// Read Only: The transform was cancelled before all of the input was processed
+	/// </summary>
+	bool IsCancelled() const;
+
+	/// <summary>
+	/// Read Only: The transform has stopped; it has completed, been cancelled, or thrown an exception
+	/// </summary>
+	bool IsReady() const;
+
+	/// <summary>
+	/// Read Only: The handle is attached to a transform
+	/// </summary>
+	bool IsValid() const;
+
+	/// <summary>
+	/// Read Only: The number of input bytes processed so far
+	/// </summary>
+	size_t Processed() const;
+
+	//~~~Public Functions~~~//
+
+	/// <summary>
+	/// Request cancellation; the transform stops at the next chunk boundary, or does not start if it is still queued
+	/// </summary>
+	void Cancel();
+
+	/// <summary>
+	/// Wait for the transform to stop, and re-throw an exception thrown by the transform.
+	/// <para>A cancelled transform does not throw; check IsCancelled() and Processed().</para>
+	/// </summary>
+	///
+	/// <exception cref="CryptoProcessingException">Thrown if the handle is not attached to a transform</exception>
+	void Get();
+
+	/// <summary>
+	/// Queue a transform on the parallel runtime, and return its handle.
+	/// <para>Used by the TransformAsync functions of the cipher interfaces. 
+	/// The Process function is called with the offset and length of each chunk, in order; a ChunkSize of zero processes the input in a single call. 
+	/// The Completion callback, if set, runs on the worker thread after the handle is ready, and must not throw.</para>
+	/// </summary>
+	///
+	/// <param name="Options">The parallel profile of the cipher; its executor is used if one is set</param>
+	/// <param name="Length">The number of bytes to process</param>
+	/// <param name="ChunkSize">The number of bytes processed between cancellation checks, or zero</param>
+	/// <param name="Process">The function that transforms one chunk</param>
+	/// <param name="Completion">The optional completion callback</param>
+	///
+	/// <returns>The transform handle</returns>
+	static TransformHandle Start(ParallelOptions &Options, size_t Length, size_t ChunkSize, const std::function<void(size_t, size_t)> &Process, const std::function<void(TransformHandle &)> &Completion);
+
+	/// <summary>
+	/// Block until the transform has stopped
+	/// </summary>
+	///
+	/// <exception cref="CryptoProcessingException">Thrown if the handle is not attached to a transform</exception>
+	void Wait();
+
+private:
+
+	static void Execute(std::shared_ptr<TransformState> &State, size_t Length, size_t ChunkSize, const std::function<void(size_t, size_t)> &Process, const std::function<void(TransformHandle &)> &Completion);
+};
+
+NAMESPACE_ROOTEND
+#endif
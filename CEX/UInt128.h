@@ -27,6 +27,9 @@ NAMESPACE_NUMERIC
 
 using Enumeration::SimdIntegers;
 
+// internal linkage; see the note in UInt256.h
+namespace
+{
 /// <summary>
 /// An AVX 128bit SIMD intrinsics wrapper.
 /// <para>Processes blocks of 32bit unsigned integers.</para>
@@ -764,6 +767,7 @@ public:
 		return ~UInt128(_mm_cmpeq_epi32(xmm, X.xmm));
 	}
 };
+}
 
 NAMESPACE_NUMERICEND
 
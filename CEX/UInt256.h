@@ -27,6 +27,10 @@ NAMESPACE_NUMERIC
 
 using Enumeration::SimdIntegers;
 
+// the wrapper is declared in an unnamed namespace, so each translation unit compiles a private copy for the instruction set it is built with;
+// a kernel unit built for a wider instruction set never supplies the inline members used by another unit
+namespace
+{
 /// <summary>
 /// An AVX2 256bit SIMD intrinsics wrapper.
 /// <para>Processes blocks of 32bit unsigned integers.</para>
@@ -803,6 +807,7 @@ private:
 		Xh = _mm256_permute2x128_si256(X0, X1, _MM_SHUFFLE(0, 3, 0, 1));
 	}
 };
+}
 
 NAMESPACE_NUMERICEND
 #endif
\ No newline at end of file
@@ -27,6 +27,9 @@ NAMESPACE_NUMERIC
 
 using Enumeration::SimdIntegers;
 
+// internal linkage; see the note in UInt256.h
+namespace
+{
 /// <summary>
 /// An AVX2 256bit SIMD intrinsics wrapper.
 /// <para>Processes blocks of 64bit unsigned integers.</para>
@@ -171,7 +174,7 @@ public:
 	{
 		CEXASSERT(sizeof(uint32_t) <= sizeof(Array::value_type), "The input array integer size must be less or equal to uint32");
 
-		zmm = _mm256_set_epi64x(static_cast<uint32_t>(Input[Offset]),
+		ymm = _mm256_set_epi64x(static_cast<uint32_t>(Input[Offset]),
 			static_cast<uint32_t>(Input[Offset + (sizeof(uint32_t) / sizeof(Array::value_type))]),
 			static_cast<uint32_t>(Input[Offset + (sizeof(uint32_t) / sizeof(Array::value_type) * 2)]),
 			static_cast<uint32_t>(Input[Offset + (sizeof(uint32_t) / sizeof(Array::value_type) * 3)]));
@@ -677,6 +680,7 @@ public:
 		return ~ULong256(_mm256_cmpeq_epi64(ymm, X.ymm));
 	}
 };
+}
 
 NAMESPACE_NUMERICEND
 #endif
\ No newline at end of file
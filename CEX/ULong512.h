@@ -32,6 +32,9 @@ using Enumeration::SimdIntegers;
 
 // TODO: None of this is tested!
 
+// internal linkage; see the note in UInt256.h
+namespace
+{
 /// <summary>
 /// An AVX512 512bit SIMD intrinsics wrapper.
 /// <para>Processes blocks of 64bit unsigned integers.</para>
@@ -752,6 +755,7 @@ public:
 
 #endif
 };
+}
 
 NAMESPACE_NUMERICEND
 #endif
\ No newline at end of file
@@ -0,0 +1,544 @@
+#include "WorkStealingPool.h"
+#include "CpuTopology.h"
+
+NAMESPACE_TOOLS
+
+namespace
+{
+	const size_t NO_QUEUE = static_cast<size_t>(~0ULL);
+	// the queue index owned by a pool worker thread, set when the worker starts
+	thread_local size_t CurrentQueue = NO_QUEUE;
+}
+
+struct WorkStealingPool::TaskBatch
+{
+	std::mutex Lock;
+	std::condition_variable Done;
+	std::exception_ptr Error;
+	const std::function<void(size_t)>* Loop;
+	std::atomic<size_t> Remaining;
+	const std::function<void()>* Task;
+
+	TaskBatch(const std::function<void(size_t)>* LoopFunction, const std::function<void()>* TaskFunction, size_t Count)
+		:
+		Lock(),
+		Done(),
+		Error(nullptr),
+		Loop(LoopFunction),
+		Remaining(Count),
+		Task(TaskFunction)
+	{
+	}
+};
+
+struct WorkStealingPool::PoolTask
+{
+	TaskBatch* Batch;
+	std::function<void()>* Detached;
+	size_t Index;
+
+	PoolTask()
+		:
+		Batch(nullptr),
+		Detached(nullptr),
+		Index(0)
+	{
+	}
+
+	PoolTask(TaskBatch* TaskSet, size_t Position)
+		:
+		Batch(TaskSet),
+		Detached(nullptr),
+		Index(Position)
+	{
+	}
+
+	explicit PoolTask(std::function<void()>* Function)
+		:
+		Batch(nullptr),
+		Detached(Function),
+		Index(0)
+	{
+	}
+};
+
+class WorkStealingPool::WorkerQueue
+{
+private:
+
+	static const size_t DEF_CAPACITY = 64;
+
+	// a grow-only ring; once it has reached the peak depth, pushing a task does not allocate
+	std::vector<PoolTask> m_taskRing;
+	size_t m_taskCount;
+	size_t m_taskHead;
+
+public:
+
+	std::mutex Lock;
+
+	WorkerQueue()
+		:
+		m_taskRing(DEF_CAPACITY),
+		m_taskCount(0),
+		m_taskHead(0),
+		Lock()
+	{
+	}
+
+	bool Empty() const
+	{
+		return (m_taskCount == 0);
+	}
+
+	PoolTask PopBack()
+	{
+		--m_taskCount;
+
+		return m_taskRing[(m_taskHead + m_taskCount) % m_taskRing.size()];
+	}
+
+	PoolTask PopFront()
+	{
+		PoolTask tsk = m_taskRing[m_taskHead];
+
+		m_taskHead = (m_taskHead + 1) % m_taskRing.size();
+		--m_taskCount;
+
+		return tsk;
+	}
+
+	void PushBack(const PoolTask &Task)
+	{
+		std::vector<PoolTask> tmpr(0);
+		size_t i;
+
+		if (m_taskCount == m_taskRing.size())
+		{
+			tmpr.resize(m_taskRing.size() * 2);
+
+			for (i = 0; i < m_taskCount; ++i)
+			{
+				tmpr[i] = m_taskRing[(m_taskHead + i) % m_taskRing.size()];
+			}
+
+			m_taskRing.swap(tmpr);
+			m_taskHead = 0;
+		}
+
+		m_taskRing[(m_taskHead + m_taskCount) % m_taskRing.size()] = Task;
+		++m_taskCount;
+	}
+};
+
+//~~~Constructor~~~//
+
+WorkStealingPool::WorkStealingPool()
+	:
+	m_nextQueue(0),
+	m_nodeQueues(0),
+	m_pendingTasks(0),
+	m_pinFlag(),
+	m_poolShutdown(false),
+	m_sleepMutex(),
+	m_sleepCondition(),
+	m_submitMutex(),
+	m_submitCondition(),
+	m_submittedTasks(0),
+	m_workerQueues(0),
+	m_workerThreads(0)
+{
+	const size_t PRCCNT = static_cast<size_t>(std::thread::hardware_concurrency());
+	// the calling thread participates in each loop, so one core is left to the caller
+	const size_t WRKCNT = (PRCCNT > 1) ? PRCCNT - 1 : 1;
+	size_t i;
+
+	for (i = 0; i < WRKCNT; ++i)
+	{
+		m_workerQueues.push_back(std::unique_ptr<WorkerQueue>(new WorkerQueue()));
+	}
+
+	for (i = 0; i < WRKCNT; ++i)
+	{
+		m_workerThreads.push_back(std::thread([this, i]() { WorkerLoop(i); }));
+	}
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+	Shutdown();
+}
+
+//~~~Accessors~~~//
+
+const size_t WorkStealingPool::Concurrency()
+{
+	return m_workerThreads.size() + 1;
+}
+
+//~~~Public Functions~~~//
+
+WorkStealingPool& WorkStealingPool::Instance()
+{
+	static WorkStealingPool pool;
+
+	return pool;
+}
+
+void WorkStealingPool::BulkRun(size_t From, size_t To, const std::function<void(size_t)> &F)
+{
+	BulkRun(From, To, F, -1);
+}
+
+void WorkStealingPool::BulkRun(size_t From, size_t To, const std::function<void(size_t)> &F, int32_t Node)
+{
+	const std::vector<size_t>* ques;
+	size_t i;
+
+	if (To <= From)
+	{
+		return;
+	}
+
+	if (To - From == 1 || m_workerQueues.size() == 0 || m_poolShutdown)
+	{
+		for (i = From; i < To; ++i)
+		{
+			F(i);
+		}
+
+		return;
+	}
+
+	ques = nullptr;
+
+	if (Node >= 0)
+	{
+		Pin();
+
+		if (static_cast<size_t>(Node) < m_nodeQueues.size() && m_nodeQueues[Node].size() != 0)
+		{
+			ques = &m_nodeQueues[Node];
+		}
+	}
+
+	const size_t QUECNT = (ques != nullptr) ? ques->size() : m_workerQueues.size();
+	const size_t QUEIDX = (CurrentQueue != NO_QUEUE) ? CurrentQueue : (m_nextQueue++ % m_workerQueues.size());
+	TaskBatch batch(&F, nullptr, To - From);
+
+	// distribute the iterations across the worker deques, the caller runs the first
+	for (i = From + 1; i < To; ++i)
+	{
+		PoolTask tsk(&batch, i);
+
+		if (ques != nullptr)
+		{
+			Push((*ques)[(QUEIDX + (i - From)) % QUECNT], tsk);
+		}
+		else
+		{
+			Push((QUEIDX + (i - From)) % QUECNT, tsk);
+		}
+	}
+
+	PoolTask own(&batch, From);
+	Execute(own);
+	WaitBatch(batch, QUEIDX);
+
+	if (batch.Error != nullptr)
+	{
+		std::rethrow_exception(batch.Error);
+	}
+}
+
+void WorkStealingPool::Pin()
+{
+	std::call_once(m_pinFlag, [this]()
+	{
+		CpuTopology &topo = CpuTopology::Instance();
+		std::vector<size_t> ordr = topo.ScatterOrder();
+		size_t i;
+		size_t prc;
+		int32_t node;
+
+		m_nodeQueues.resize(topo.NodeCount());
+
+		// consecutive workers land on alternating nodes, so a partially loaded pool spans every memory controller
+		for (i = 0; i < m_workerThreads.size() && ordr.size() != 0; ++i)
+		{
+			prc = ordr[(i + 1) % ordr.size()];
+			node = topo.ProcessorNode(prc);
+
+			if (CpuTopology::PinThread(m_workerThreads[i], prc) && node >= 0)
+			{
+				m_nodeQueues[node].push_back(i);
+			}
+		}
+	});
+}
+
+void WorkStealingPool::Run(const std::function<void()> &F)
+{
+	// a worker thread runs the task directly; blocking a worker on its own queue could stall the pool
+	if (CurrentQueue != NO_QUEUE || m_workerQueues.size() == 0 || m_poolShutdown)
+	{
+		F();
+		return;
+	}
+
+	TaskBatch batch(nullptr, &F, 1);
+	PoolTask tsk(&batch, 0);
+
+	Push(m_nextQueue++ % m_workerQueues.size(), tsk);
+
+	std::unique_lock<std::mutex> lock(batch.Lock);
+	batch.Done.wait(lock, [&batch]() { return batch.Remaining == 0; });
+	lock.unlock();
+
+	if (batch.Error != nullptr)
+	{
+		std::rethrow_exception(batch.Error);
+	}
+}
+
+void WorkStealingPool::Shutdown()
+{
+	PoolTask tsk;
+	size_t i;
+
+	if (m_poolShutdown.exchange(true))
+	{
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_sleepMutex);
+		m_sleepCondition.notify_all();
+	}
+
+	for (i = 0; i < m_workerThreads.size(); ++i)
+	{
+		if (m_workerThreads[i].joinable())
+		{
+			m_workerThreads[i].join();
+		}
+	}
+
+	// release any waiter still holding queued work
+	for (i = 0; i < m_workerQueues.size(); ++i)
+	{
+		while (TryPop(i, tsk))
+		{
+			Execute(tsk);
+		}
+	}
+}
+
+void WorkStealingPool::Submit(const std::function<void()> &F)
+{
+	if (m_workerQueues.size() == 0 || m_poolShutdown)
+	{
+		F();
+		return;
+	}
+
+	// the copy is owned by the queued task, and released after it runs
+	PoolTask tsk(new std::function<void()>(F));
+
+	m_submittedTasks++;
+	Push((CurrentQueue != NO_QUEUE) ? CurrentQueue : (m_nextQueue++ % m_workerQueues.size()), tsk);
+}
+
+void WorkStealingPool::Wait()
+{
+	PoolTask tsk;
+
+	// a worker waiting on the pool must keep executing, or it could wait on its own queue
+	while (m_submittedTasks != 0 && CurrentQueue != NO_QUEUE)
+	{
+		if (TryPop(CurrentQueue, tsk) || TrySteal(CurrentQueue, tsk))
+		{
+			Execute(tsk);
+		}
+		else
+		{
+			std::this_thread::yield();
+		}
+	}
+
+	std::unique_lock<std::mutex> lock(m_submitMutex);
+	m_submitCondition.wait(lock, [this]() { return m_submittedTasks == 0; });
+}
+
+size_t WorkStealingPool::WorkerCount()
+{
+	return m_workerThreads.size();
+}
+
+//~~~Private Functions~~~//
+
+void WorkStealingPool::Complete(TaskBatch &Batch, std::exception_ptr &Error)
+{
+	// the decrement is made under the batch lock; the owner can not release the batch until the lock is free
+	std::lock_guard<std::mutex> lock(Batch.Lock);
+
+	if (Error != nullptr && Batch.Error == nullptr)
+	{
+		Batch.Error = Error;
+	}
+
+	if (--Batch.Remaining == 0)
+	{
+		Batch.Done.notify_all();
+	}
+}
+
+void WorkStealingPool::Execute(PoolTask &Task)
+{
+	std::exception_ptr err = nullptr;
+
+	if (Task.Detached != nullptr)
+	{
+		// a submitted task has no caller to receive an exception
+		try
+		{
+			(*Task.Detached)();
+		}
+		catch (...)
+		{
+		}
+
+		delete Task.Detached;
+		Task.Detached = nullptr;
+
+		std::lock_guard<std::mutex> lock(m_submitMutex);
+
+		if (--m_submittedTasks == 0)
+		{
+			m_submitCondition.notify_all();
+		}
+
+		return;
+	}
+
+	try
+	{
+		if (Task.Batch->Loop != nullptr)
+		{
+			(*Task.Batch->Loop)(Task.Index);
+		}
+		else
+		{
+			(*Task.Batch->Task)();
+		}
+	}
+	catch (...)
+	{
+		err = std::current_exception();
+	}
+
+	Complete(*Task.Batch, err);
+}
+
+void WorkStealingPool::Push(size_t Queue, PoolTask &Task)
+{
+	m_pendingTasks++;
+
+	{
+		std::lock_guard<std::mutex> lock(m_workerQueues[Queue]->Lock);
+		m_workerQueues[Queue]->PushBack(Task);
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_sleepMutex);
+	}
+
+	m_sleepCondition.notify_one();
+}
+
+bool WorkStealingPool::TryPop(size_t Queue, PoolTask &Task)
+{
+	std::lock_guard<std::mutex> lock(m_workerQueues[Queue]->Lock);
+	bool res;
+
+	res = false;
+
+	// the owner takes the most recently pushed task
+	if (!m_workerQueues[Queue]->Empty())
+	{
+		Task = m_workerQueues[Queue]->PopBack();
+		m_pendingTasks--;
+		res = true;
+	}
+
+	return res;
+}
+
+bool WorkStealingPool::TrySteal(size_t Queue, PoolTask &Task)
+{
+	const size_t QUECNT = m_workerQueues.size();
+	size_t i;
+	size_t vctm;
+	bool res;
+
+	res = false;
+
+	// thieves take the oldest task from the front of a victims deque
+	for (i = 1; i <= QUECNT && res == false; ++i)
+	{
+		vctm = (Queue + i) % QUECNT;
+		std::lock_guard<std::mutex> lock(m_workerQueues[vctm]->Lock);
+
+		if (!m_workerQueues[vctm]->Empty())
+		{
+			Task = m_workerQueues[vctm]->PopFront();
+			m_pendingTasks--;
+			res = true;
+		}
+	}
+
+	return res;
+}
+
+void WorkStealingPool::WaitBatch(TaskBatch &Batch, size_t Queue)
+{
+	PoolTask tsk;
+
+	// help with queued work until every task of this batch has been claimed
+	while (Batch.Remaining != 0)
+	{
+		if ((CurrentQueue == Queue && TryPop(Queue, tsk)) || TrySteal(Queue, tsk))
+		{
+			Execute(tsk);
+		}
+		else
+		{
+			break;
+		}
+	}
+
+	std::unique_lock<std::mutex> lock(Batch.Lock);
+	Batch.Done.wait(lock, [&Batch]() { return Batch.Remaining == 0; });
+}
+
+void WorkStealingPool::WorkerLoop(size_t Queue)
+{
+	PoolTask tsk;
+
+	CurrentQueue = Queue;
+
+	while (!m_poolShutdown)
+	{
+		if (TryPop(Queue, tsk) || TrySteal(Queue, tsk))
+		{
+			Execute(tsk);
+		}
+		else
+		{
+			std::unique_lock<std::mutex> lock(m_sleepMutex);
+			m_sleepCondition.wait(lock, [this]() { return m_pendingTasks != 0 || m_poolShutdown; });
+		}
+	}
+}
+
+NAMESPACE_TOOLSEND
@@ -0,0 +1,159 @@
+// The GPL version 3 License (GPLv3)
+//
+// Copyright (c) 2023 QSCS.ca
+// This file is part of the CEX Cryptographic library.
+//
+// This program is free software : you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef CEX_WORKSTEALINGPOOL_H
+#define CEX_WORKSTEALINGPOOL_H
+
+#include "CexDomain.h"
+#include "IParallelExecutor.h"
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+NAMESPACE_TOOLS
+
+/// cond private
+
+/// <summary>
+/// Internal class: a process-wide persistent work-stealing thread pool used by the ParallelTools functions.
+/// <para>Each worker owns a task deque; a worker pops work from the back of its own deque, and steals from the front of the other workers deques when idle.
+/// The worker threads are started lazily on first use, and are joined when the process exits.
+/// The thread calling BulkRun participates in the loop, so nested parallel loops can not dead-lock the pool.
+/// This is the default IParallelExecutor used when no executor has been installed.
+/// When a placement policy is requested, the workers are pinned to the logical processors interleaved across the NUMA nodes, and a loop can be directed to the workers of a single node.</para>
+/// </summary>
+class WorkStealingPool final : public IParallelExecutor
+{
+private:
+
+	struct TaskBatch;
+	struct PoolTask;
+	class WorkerQueue;
+
+	std::atomic<size_t> m_nextQueue;
+	std::vector<std::vector<size_t>> m_nodeQueues;
+	std::atomic<size_t> m_pendingTasks;
+	std::once_flag m_pinFlag;
+	std::atomic<bool> m_poolShutdown;
+	std::mutex m_sleepMutex;
+	std::condition_variable m_sleepCondition;
+	std::mutex m_submitMutex;
+	std::condition_variable m_submitCondition;
+	std::atomic<size_t> m_submittedTasks;
+	std::vector<std::unique_ptr<WorkerQueue>> m_workerQueues;
+	std::vector<std::thread> m_workerThreads;
+
+	WorkStealingPool(const WorkStealingPool&) = delete;
+
+	WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+	WorkStealingPool();
+
+	~WorkStealingPool() override;
+
+public:
+
+	//~~~Accessors~~~//
+
+	/// <summary>
+	/// Read Only: The number of threads the pool runs concurrently; the workers and the calling thread
+	/// </summary>
+	const size_t Concurrency() override;
+
+	//~~~Public Functions~~~//
+
+	/// <summary>
+	/// Get the process-wide pool instance; the worker threads are created on the first call
+	/// </summary>
+	static WorkStealingPool& Instance();
+
+	/// <summary>
+	/// Run a loop function over the range [From, To), distributing the iterations across the pool workers.
+	/// <para>The calling thread executes iterations until the loop completes; an exception thrown by an iteration is re-thrown to the caller.</para>
+	/// </summary>
+	///
+	/// <param name="From">The inclusive starting position</param>
+	/// <param name="To">The exclusive ending position</param>
+	/// <param name="F">The function delegate</param>
+	void BulkRun(size_t From, size_t To, const std::function<void(size_t)> &F) override;
+
+	/// <summary>
+	/// Run a loop function over the range [From, To), queueing the iterations on the workers pinned to a NUMA node.
+	/// <para>Pins the pool workers on first use. Idle workers on other nodes may still steal queued iterations.
+	/// If the node has no workers, the iterations are distributed across the whole pool.</para>
+	/// </summary>
+	///
+	/// <param name="From">The inclusive starting position</param>
+	/// <param name="To">The exclusive ending position</param>
+	/// <param name="F">The function delegate</param>
+	/// <param name="Node">The preferred NUMA node, or -1 for every worker</param>
+	void BulkRun(size_t From, size_t To, const std::function<void(size_t)> &F, int32_t Node);
+
+	/// <summary>
+	/// Pin each worker thread to a logical processor, interleaving the workers across the NUMA nodes.
+	/// <para>The workers are pinned once; subsequent calls have no effect.</para>
+	/// </summary>
+	void Pin();
+
+	/// <summary>
+	/// Execute a function on a pool worker thread and wait for it to complete
+	/// </summary>
+	///
+	/// <param name="F">The function delegate</param>
+	void Run(const std::function<void()> &F);
+
+	/// <summary>
+	/// Signal the workers to exit, and join the worker threads
+	/// </summary>
+	void Shutdown();
+
+	/// <summary>
+	/// Queue a copy of a function for asynchronous execution on a pool worker
+	/// </summary>
+	///
+	/// <param name="F">The function delegate</param>
+	void Submit(const std::function<void()> &F) override;
+
+	/// <summary>
+	/// Block until every function queued with Submit(std::function) has completed
+	/// </summary>
+	void Wait() override;
+
+	/// <summary>
+	/// Read Only: The number of persistent worker threads in the pool
+	/// </summary>
+	size_t WorkerCount();
+
+private:
+
+	void Complete(TaskBatch &Batch, std::exception_ptr &Error);
+	void Execute(PoolTask &Task);
+	void Push(size_t Queue, PoolTask &Task);
+	bool TryPop(size_t Queue, PoolTask &Task);
+	bool TrySteal(size_t Queue, PoolTask &Task);
+	void WaitBatch(TaskBatch &Batch, size_t Queue);
+	void WorkerLoop(size_t Queue);
+};
+
+/// endcond
+
+NAMESPACE_TOOLSEND
+#endif
@@ -0,0 +1,493 @@
+#include "XTS.h"
+#include "BlockCipherFromName.h"
+#include "IntegerTools.h"
+#include "MemoryTools.h"
+#include "ParallelScratch.h"
+#include "ParallelTools.h"
+#include "SymmetricKey.h"
+#if defined(CEX_HAS_SSE2)
+#	include "Intrinsics.h"
+#endif
+
+NAMESPACE_MODE
+
+using Enumeration::BlockCipherConvert;
+using Enumeration::CipherModeConvert;
+using Tools::IntegerTools;
+using Tools::MemoryTools;
+using Tools::ParallelScratch;
+using Tools::ParallelTools;
+using Cipher::SymmetricKey;
+
+class XTS::XtsState
+{
+public:
+
+	std::vector<uint8_t> Buffer;
+	std::vector<SymmetricKeySize> LegalKeySizes;
+	ParallelScratch Scratch;
+	std::vector<uint8_t> Sector;
+	bool Destroyed;
+	bool Encryption;
+	bool Initialized;
+
+	XtsState(bool IsDestroyed)
+		:
+		Buffer(SCRATCH_SIZE, 0x00),
+		LegalKeySizes(0),
+		Scratch(),
+		Sector(BLOCK_SIZE, 0x00),
+		Destroyed(IsDestroyed),
+		Encryption(false),
+		Initialized(false)
+	{
+	}
+
+	~XtsState()
+	{
+		Reset();
+		LegalKeySizes.clear();
+	}
+
+	void Reset()
+	{
+		MemoryTools::Clear(Buffer, 0, Buffer.size());
+		MemoryTools::Clear(Sector, 0, Sector.size());
+		Scratch.Clear();
+		Destroyed = false;
+		Encryption = false;
+		Initialized = false;
+	}
+};
+
+//~~~Constructor~~~//
+
+XTS::XTS(BlockCiphers CipherType)
+	:
+	m_xtsState(new XtsState(true)),
+	m_blockCipher(CipherType != BlockCiphers::None ?
+		Helper::BlockCipherFromName::GetInstance(CipherType) :
+		throw CryptoCipherModeException(CipherModeConvert::ToName(CipherModes::XTS), std::string("Constructor"), std::string("The cipher type can not be none!"), ErrorCodes::InvalidParam)),
+	m_tweakCipher(Helper::BlockCipherFromName::GetInstance(CipherType)),
+	m_parallelProfile(BLOCK_SIZE, true, m_blockCipher->StateCacheSize(), true)
+{
+	for (size_t i = 0; i < m_blockCipher->LegalKeySizes().size(); ++i)
+	{
+		m_xtsState->LegalKeySizes.push_back(SymmetricKeySize(m_blockCipher->LegalKeySizes()[i].KeySize() * 2, BLOCK_SIZE, 0));
+	}
+
+	m_parallelProfile.SetAlgorithm(Name());
+}
+
+XTS::XTS(IBlockCipher* Cipher)
+	:
+	m_xtsState(new XtsState(false)),
+	m_blockCipher(Cipher != nullptr ?
+		Cipher :
+		throw CryptoCipherModeException(CipherModeConvert::ToName(CipherModes::XTS), std::string("Constructor"), std::string("The cipher type can not be null!"), ErrorCodes::IllegalOperation)),
+	m_tweakCipher(Helper::BlockCipherFromName::GetInstance(m_blockCipher->Enumeral())),
+	m_parallelProfile(BLOCK_SIZE, true, m_blockCipher->StateCacheSize(), true)
+{
+	for (size_t i = 0; i < m_blockCipher->LegalKeySizes().size(); ++i)
+	{
+		m_xtsState->LegalKeySizes.push_back(SymmetricKeySize(m_blockCipher->LegalKeySizes()[i].KeySize() * 2, BLOCK_SIZE, 0));
+	}
+
+	m_parallelProfile.SetAlgorithm(Name());
+}
+
+XTS::~XTS()
+{
+	if (m_xtsState->Destroyed)
+	{
+		if (m_blockCipher != nullptr)
+		{
+			m_blockCipher.reset(nullptr);
+		}
+	}
+	else
+	{
+		if (m_blockCipher != nullptr)
+		{
+			m_blockCipher.release();
+		}
+	}
+
+	if (m_tweakCipher != nullptr)
+	{
+		m_tweakCipher.reset(nullptr);
+	}
+}
+
+//~~~Accessors~~~//
+
+const size_t XTS::BlockSize()
+{
+	return BLOCK_SIZE;
+}
+
+const BlockCiphers XTS::CipherType()
+{
+	return m_blockCipher->Enumeral();
+}
+
+IBlockCipher* XTS::Engine()
+{
+	return m_blockCipher.get();
+}
+
+const CipherModes XTS::Enumeral()
+{
+	return CipherModes::XTS;
+}
+
+const bool XTS::IsEncryption()
+{
+	return m_xtsState->Encryption;
+}
+
+const bool XTS::IsInitialized()
+{
+	return m_xtsState->Initialized;
+}
+
+const bool XTS::IsParallel()
+{
+	return m_parallelProfile.IsParallel();
+}
+
+const std::vector<SymmetricKeySize> &XTS::LegalKeySizes()
+{
+	return m_xtsState->LegalKeySizes;
+}
+
+const std::string XTS::Name()
+{
+	std::string tmpn;
+
+	tmpn = CipherModeConvert::ToName(Enumeral()) + std::string("-") + BlockCipherConvert::ToName(m_blockCipher->Enumeral());
+
+	return tmpn;
+}
+
+const size_t XTS::ParallelBlockSize()
+{
+	return m_parallelProfile.ParallelBlockSize();
+}
+
+ParallelOptions &XTS::ParallelProfile()
+{
+	return m_parallelProfile;
+}
+
+const std::vector<uint8_t> XTS::Sector()
+{
+	return m_xtsState->Sector;
+}
+
+//~~~Public Functions~~~//
+
+void XTS::DecryptBlock(const std::vector<uint8_t> &Input, std::vector<uint8_t> &Output)
+{
+	CEXASSERT(IsInitialized(), "The cipher mode has not been initialized!");
+	CEXASSERT(!IsEncryption(), "The cipher mode has been initialized for encryption!");
+
+	Transform(Input, 0, Output, 0, BLOCK_SIZE);
+}
+
+void XTS::DecryptBlock(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset)
+{
+	CEXASSERT(IsInitialized(), "The cipher mode has not been initialized!");
+	CEXASSERT(!IsEncryption(), "The cipher mode has been initialized for encryption!");
+
+	Transform(Input, InOffset, Output, OutOffset, BLOCK_SIZE);
+}
+
+void XTS::DecryptBlock(const uint8_t* Input, uint8_t* Output)
+{
+	CEXASSERT(IsInitialized(), "The cipher mode has not been initialized!");
+	CEXASSERT(!IsEncryption(), "The cipher mode has been initialized for encryption!");
+
+	Transform(Input, Output, BLOCK_SIZE);
+}
+
+void XTS::EncryptBlock(const std::vector<uint8_t> &Input, std::vector<uint8_t> &Output)
+{
+	CEXASSERT(IsInitialized(), "The cipher mode has not been initialized!");
+	CEXASSERT(IsEncryption(), "The cipher mode has been initialized for decryption!");
+
+	Transform(Input, 0, Output, 0, BLOCK_SIZE);
+}
+
+void XTS::EncryptBlock(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset)
+{
+	CEXASSERT(IsInitialized(), "The cipher mode has not been initialized!");
+	CEXASSERT(IsEncryption(), "The cipher mode has been initialized for decryption!");
+
+	Transform(Input, InOffset, Output, OutOffset, BLOCK_SIZE);
+}
+
+void XTS::EncryptBlock(const uint8_t* Input, uint8_t* Output)
+{
+	CEXASSERT(IsInitialized(), "The cipher mode has not been initialized!");
+	CEXASSERT(IsEncryption(), "The cipher mode has been initialized for decryption!");
+
+	Transform(Input, Output, BLOCK_SIZE);
+}
+
+void XTS::Initialize(bool Encryption, ISymmetricKey &Parameters)
+{
+	if (!SymmetricKeySize::Contains(LegalKeySizes(), Parameters.KeySizes().KeySize()))
+	{
+		throw CryptoCipherModeException(Name(), std::string("Initialize"), std::string("Invalid key size; key must be one of the LegalKeySizes members in length!"), ErrorCodes::InvalidKey);
+	}
+	if (Parameters.KeySizes().IVSize() != BLOCK_SIZE)
+	{
+		throw CryptoCipherModeException(Name(), std::string("Initialize"), std::string("Requires a data unit number equal in size to the ciphers block size!"), ErrorCodes::InvalidNonce);
+	}
+
+	if (m_parallelProfile.IsParallel())
+	{
+		if (m_parallelProfile.IsParallel() && m_parallelProfile.ParallelBlockSize() < m_parallelProfile.ParallelMinimumSize() || m_parallelProfile.ParallelBlockSize() > m_parallelProfile.ParallelMaximumSize())
+		{
+			throw CryptoCipherModeException(Name(), std::string("Initialize"), std::string("The parallel block size is out of bounds!"), ErrorCodes::InvalidSize);
+		}
+		if (m_parallelProfile.IsParallel() && m_parallelProfile.ParallelBlockSize() % m_parallelProfile.ParallelMinimumSize() != 0)
+		{
+			throw CryptoCipherModeException(Name(), std::string("Initialize"), std::string("The parallel block size must be evenly aligned to the ParallelMinimumSize!"), ErrorCodes::InvalidParam);
+		}
+	}
+
+	const size_t KEYLEN = Parameters.KeySizes().KeySize() / 2;
+	SecureVector<uint8_t> tmpk(KEYLEN);
+
+	// the data key is keyed for the operation, the tweak key always encrypts
+	MemoryTools::Copy(Parameters.SecureKey(), 0, tmpk, 0, KEYLEN);
+	SymmetricKey dkp(tmpk);
+	m_blockCipher->Initialize(Encryption, dkp);
+
+	MemoryTools::Copy(Parameters.SecureKey(), KEYLEN, tmpk, 0, KEYLEN);
+	SymmetricKey tkp(tmpk);
+	m_tweakCipher->Initialize(true, tkp);
+	MemoryTools::Clear(tmpk, 0, tmpk.size());
+
+	MemoryTools::Copy(Parameters.IV(), 0, m_xtsState->Sector, 0, BLOCK_SIZE);
+	m_xtsState->Encryption = Encryption;
+	m_xtsState->Initialized = true;
+}
+
+void XTS::ParallelMaxDegree(size_t Degree)
+{
+	if (Degree == 0 || Degree % 2 != 0 || Degree > m_parallelProfile.ProcessorCount())
+	{
+		throw CryptoCipherModeException(Name(), std::string("ParallelMaxDegree"), std::string("Degree setting is invalid!"), ErrorCodes::InvalidParam);
+	}
+
+	m_parallelProfile.SetMaxDegree(Degree);
+}
+
+void XTS::Transform(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length)
+{
+	CEXASSERT(IsInitialized(), "The cipher mode has not been initialized");
+	CEXASSERT(IntegerTools::Min(Input.size() - InOffset, Output.size() - OutOffset) >= Length, "The data arrays are smaller than the length");
+
+	if (Length < BLOCK_SIZE)
+	{
+		throw CryptoCipherModeException(Name(), std::string("Transform"), std::string("The data unit must be at least one block in length!"), ErrorCodes::InvalidSize);
+	}
+
+	Process(Input.data() + InOffset, Output.data() + OutOffset, Length, m_xtsState->Sector, m_xtsState->Buffer);
+	IntegerTools::LeIncrement(m_xtsState->Sector);
+}
+
+void XTS::Transform(const uint8_t* Input, uint8_t* Output, size_t Length)
+{
+	CEXASSERT(IsInitialized(), "The cipher mode has not been initialized!");
+
+	if (Length < BLOCK_SIZE)
+	{
+		throw CryptoCipherModeException(Name(), std::string("Transform"), std::string("The data unit must be at least one block in length!"), ErrorCodes::InvalidSize);
+	}
+
+	// a transform is one data unit, processed directly on the callers memory
+	Process(Input, Output, Length, m_xtsState->Sector, m_xtsState->Buffer);
+	IntegerTools::LeIncrement(m_xtsState->Sector);
+}
+
+void XTS::TransformSectors(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t SectorSize, size_t SectorCount, uint64_t Sector)
+{
+	CEXASSERT(IsInitialized(), "The cipher mode has not been initialized");
+
+	if (SectorSize < BLOCK_SIZE)
+	{
+		throw CryptoCipherModeException(Name(), std::string("TransformSectors"), std::string("The sector size must be at least one block in length!"), ErrorCodes::InvalidSize);
+	}
+	if (Input.size() < InOffset + (SectorSize * SectorCount) || Output.size() < OutOffset + (SectorSize * SectorCount))
+	{
+		throw CryptoCipherModeException(Name(), std::string("TransformSectors"), std::string("The data arrays are smaller than the sector batch!"), ErrorCodes::InvalidSize);
+	}
+
+	if (SectorCount != 0)
+	{
+		const bool PRLTRN = m_parallelProfile.IsParallel() && SectorCount > 1 && (SectorSize * SectorCount) >= m_parallelProfile.ParallelBlockSize();
+		const size_t SEGCNT = PRLTRN ? IntegerTools::Min(m_parallelProfile.ParallelSegmentCount(), SectorCount) : 1;
+
+		// the per-worker sector numbers and tweak buffers are kept by the instance, and are allocated only on first use
+		m_xtsState->Scratch.Reserve(SEGCNT, BLOCK_SIZE, SCRATCH_SIZE);
+
+		auto seg = [this, &Input, InOffset, &Output, OutOffset, SectorSize, SectorCount, Sector, SEGCNT](size_t i)
+		{
+			// each worker processes a contiguous range of whole sectors
+			const size_t FSTSEC = (SectorCount * i) / SEGCNT;
+			const size_t LSTSEC = (SectorCount * (i + 1)) / SEGCNT;
+			std::vector<uint8_t> &thds = m_xtsState->Scratch.Counter(i);
+			size_t j;
+
+			MemoryTools::Clear(thds, 0, BLOCK_SIZE);
+			IntegerTools::Le64ToBytes(Sector + FSTSEC, thds, 0);
+
+			for (j = FSTSEC; j < LSTSEC; ++j)
+			{
+				this->Process(Input.data() + InOffset + (j * SectorSize), Output.data() + OutOffset + (j * SectorSize), SectorSize, thds, m_xtsState->Scratch.Buffer(i));
+				IntegerTools::LeIncrement(thds);
+			}
+		};
+
+		if (SEGCNT > 1)
+		{
+			ParallelTools::ParallelFor(m_parallelProfile, Output.data() + OutOffset, 0, SEGCNT, seg);
+		}
+		else
+		{
+			seg(0);
+		}
+	}
+}
+
+//~~~Private Functions~~~//
+
+void XTS::Double(std::vector<uint8_t> &Tweak, size_t TweakOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Count)
+{
+	// write Count consecutive block tweaks, and advance the tweak: T = T·x in GF(2^128), with the little-endian bit order of IEEE 1619
+#if defined(CEX_HAS_SSE2)
+
+	// the carry of each 32-bit lane moves to the next lane, the carry of the high lane is reduced by x^7 + x^2 + x + 1
+	const __m128i POLY = _mm_set_epi32(0x87, 1, 1, 1);
+	__m128i t;
+	size_t i;
+
+	t = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&Tweak[TweakOffset]));
+
+	for (i = 0; i < Count; ++i)
+	{
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(&Output[OutOffset + (i * BLOCK_SIZE)]), t);
+		t = _mm_xor_si128(_mm_slli_epi32(t, 1), _mm_shuffle_epi32(_mm_and_si128(_mm_srai_epi32(t, 31), POLY), 0x93));
+	}
+
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(&Tweak[TweakOffset]), t);
+
+#else
+
+	uint64_t thi;
+	uint64_t tlo;
+	uint64_t cry;
+	size_t i;
+
+	tlo = IntegerTools::LeBytesTo64(Tweak, TweakOffset);
+	thi = IntegerTools::LeBytesTo64(Tweak, TweakOffset + sizeof(uint64_t));
+
+	for (i = 0; i < Count; ++i)
+	{
+		IntegerTools::Le64ToBytes(tlo, Output, OutOffset + (i * BLOCK_SIZE));
+		IntegerTools::Le64ToBytes(thi, Output, OutOffset + (i * BLOCK_SIZE) + sizeof(uint64_t));
+		cry = 0ULL - (thi >> 63);
+		thi = (thi << 1) | (tlo >> 63);
+		tlo = (tlo << 1) ^ (cry & 0x87ULL);
+	}
+
+	IntegerTools::Le64ToBytes(tlo, Tweak, TweakOffset);
+	IntegerTools::Le64ToBytes(thi, Tweak, TweakOffset + sizeof(uint64_t));
+
+#endif
+}
+
+void XTS::Process(const uint8_t* Input, uint8_t* Output, size_t Length, const std::vector<uint8_t> &Sector, std::vector<uint8_t> &Buffer)
+{
+	// scratch layout: the block tweaks, the tweaked data, the cipher output, and the running tweak
+	const size_t DATOFF = WIDE_BLOCKS * BLOCK_SIZE;
+	const size_t OTPOFF = 2 * WIDE_BLOCKS * BLOCK_SIZE;
+	const size_t TWKOFF = 3 * WIDE_BLOCKS * BLOCK_SIZE;
+	const size_t RMDLEN = Length % BLOCK_SIZE;
+	size_t bctr;
+
+	// the full blocks processed before ciphertext stealing
+	bctr = (Length / BLOCK_SIZE) - ((RMDLEN != 0) ? 1 : 0);
+
+	// T = EK2(i)
+	m_tweakCipher->EncryptBlock(Sector, 0, Buffer, TWKOFF);
+
+	// 16 blocks; the cipher selects its widest kernel at run-time
+	while (bctr >= WIDE_BLOCKS)
+	{
+		const size_t WIDLEN = WIDE_BLOCKS * BLOCK_SIZE;
+
+		Double(Buffer, TWKOFF, Buffer, 0, WIDE_BLOCKS);
+		MemoryTools::XorRaw(Input, Buffer.data(), Buffer.data() + DATOFF, WIDLEN);
+		m_blockCipher->Transform2048(Buffer, DATOFF, Buffer, OTPOFF, Length);
+		MemoryTools::XorRaw(Buffer.data(), Buffer.data() + OTPOFF, Output, WIDLEN);
+		Input += WIDLEN;
+		Output += WIDLEN;
+		bctr -= WIDE_BLOCKS;
+	}
+
+	while (bctr != 0)
+	{
+		Double(Buffer, TWKOFF, Buffer, 0, 1);
+		MemoryTools::XorRaw(Input, Buffer.data(), Buffer.data() + DATOFF, BLOCK_SIZE);
+		Transform128(Buffer.data() + DATOFF, Output);
+		MemoryTools::XorRaw(Buffer.data(), Output, BLOCK_SIZE);
+		Input += BLOCK_SIZE;
+		Output += BLOCK_SIZE;
+		--bctr;
+	}
+
+	if (RMDLEN != 0)
+	{
+		// ciphertext stealing; the last full block and the partial block use the tweaks of blocks m-1 and m,
+		// decryption processes the full block with the tweak of the partial block first
+		const size_t FSTTWK = IsEncryption() ? 0 : BLOCK_SIZE;
+		const size_t LSTTWK = IsEncryption() ? BLOCK_SIZE : 0;
+
+		Double(Buffer, TWKOFF, Buffer, 0, 2);
+
+		// CC = EK1(Pm-1 ^ T) ^ T
+		MemoryTools::XorRaw(Input, Buffer.data() + FSTTWK, Buffer.data() + DATOFF, BLOCK_SIZE);
+		Transform128(Buffer.data() + DATOFF, Buffer.data() + DATOFF + BLOCK_SIZE);
+		MemoryTools::XOR128(Buffer, FSTTWK, Buffer, DATOFF + BLOCK_SIZE);
+
+		// the partial block is read before the output is written, so the transform can be in-place
+		MemoryTools::CopyRaw(Input + BLOCK_SIZE, Buffer.data() + DATOFF, RMDLEN);
+		MemoryTools::Copy(Buffer, DATOFF + BLOCK_SIZE + RMDLEN, Buffer, DATOFF + RMDLEN, BLOCK_SIZE - RMDLEN);
+		MemoryTools::CopyRaw(Buffer.data() + DATOFF + BLOCK_SIZE, Output + BLOCK_SIZE, RMDLEN);
+
+		// Cm-1 = EK1((Pm || CC) ^ T) ^ T
+		MemoryTools::XOR128(Buffer, LSTTWK, Buffer, DATOFF);
+		Transform128(Buffer.data() + DATOFF, Output);
+		MemoryTools::XorRaw(Buffer.data() + LSTTWK, Output, BLOCK_SIZE);
+	}
+}
+
+void XTS::Transform128(const uint8_t* Input, uint8_t* Output)
+{
+	// the data cipher is keyed for the direction of the operation
+	if (IsEncryption() == true)
+	{
+		m_blockCipher->EncryptBlock(Input, Output);
+	}
+	else
+	{
+		m_blockCipher->DecryptBlock(Input, Output);
+	}
+}
+
+NAMESPACE_MODEEND
@@ -0,0 +1,357 @@
+// The GPL version 3 License (GPLv3)
+//
+// Copyright (c) 2023 QSCS.ca
+// This file is part of the CEX Cryptographic library.
+//
+// This program is free software : you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+//
+// Implementation Details:
+// An implementation of the XEX-based Tweaked CodeBook mode with ciphertext Stealing (XTS).
+
+#ifndef CEX_XTS_H
+#define CEX_XTS_H
+
+#include "ICipherMode.h"
+
+NAMESPACE_MODE
+
+/// <summary>
+/// XTS: An implementation of the XEX-based Tweaked CodeBook mode with ciphertext Stealing (IEEE 1619)
+/// <para>A tweakable mode for the encryption of storage sectors and fixed-size records; every data unit is encrypted independently under its own sector tweak.</para>
+/// </summary>
+///
+/// <example>
+/// <description>Encrypting sequential sectors:</description>
+/// <code>
+/// XTS cipher(BlockCiphers::AES);
+/// // the key is the data key followed by the tweak key, the iv is the 16 byte little-endian number of the first sector
+/// cipher.Initialize(true, SymmetricKey(Key, Sector));
+/// // encrypt one sector; the sector number is incremented
+/// cipher.Transform(Input, 0, Output, 0, 512);
+/// </code>
+/// </example>
+///
+/// <example>
+/// <description>Encrypting a batch of sectors at a random position:</description>
+/// <code>
+/// XTS cipher(BlockCiphers::AES);
+/// cipher.Initialize(true, SymmetricKey(Key, Sector));
+/// // encrypt 64 sectors of 4096 bytes, beginning with sector 1000
+/// cipher.TransformSectors(Input, 0, Output, 0, 4096, 64, 1000);
+/// </code>
+/// </example>
+///
+/// <remarks>
+/// <description><B>Overview:</B></description>
+/// <para>XTS encrypts each 16 byte block of a data unit with the block cipher keyed with K1, between two additions of a block tweak.
+/// The first tweak of a data unit is the encryption of the data unit number with a second key K2, each following block tweak is the previous tweak multiplied by a primitive element (x) in GF(2^128).
+/// A data unit that is not a multiple of the block size is completed with ciphertext stealing, so the cipher-text is always the size of the plain-text.</para>
+///
+/// <description><B>Description:</B></description>
+/// <para><EM>Legend:</EM> \n
+/// <B>C</B>=ciphertext, <B>P</B>=plaintext, <B>K1</B>=data key, <B>K2</B>=tweak key, <B>i</B>=data unit number, <B>E</B>=encrypt, <B>D</B>=decrypt, <B>a</B>=the primitive element x \n
+/// <EM>Encryption</EM> \n
+/// T ← EK2(i), for 0 ≤ j &lt; m, Cj ← EK1(Pj ^ T·a<SUP>j</SUP>) ^ T·a<SUP>j</SUP>. \n
+/// <EM>Decryption</EM> \n
+/// T ← EK2(i), for 0 ≤ j &lt; m, Pj ← DK1(Cj ^ T·a<SUP>j</SUP>) ^ T·a<SUP>j</SUP>. \n
+/// <EM>Ciphertext Stealing</EM> \n
+/// With a partial last block Pm of r bytes: CC ← EK1(Pm-1 ^ T·a<SUP>m-1</SUP>) ^ T·a<SUP>m-1</SUP>, Cm ← the first r bytes of CC, Cm-1 ← EK1((Pm || the last 16-r bytes of CC) ^ T·a<SUP>m</SUP>) ^ T·a<SUP>m</SUP>.</para>
+///
+/// <description><B>Multi-Threading:</B></description>
+/// <para>The data units of a TransformSectors(Input, InOffset, Output, OutOffset, SectorSize, SectorCount, Sector) batch are independent, and are divided into ranges of whole sectors that are processed across threads. \n
+/// Within a data unit, the block tweaks are generated 16 at a time with SIMD multiplication by x, and the blocks are transformed with the wide, 4 or 16 block, block cipher functions (AVX/AVX2/AVX512, or VAES with RHX).</para>
+///
+/// <description>Implementation Notes:</description>
+/// <list type="bullet">
+/// <item><description>The input key is the data key K1 followed by the tweak key K2; the LegalKeySizes() are twice the key sizes of the block cipher.</description></item>
+/// <item><description>The initialization vector is the 16 byte little-endian number of the first data unit, and is required.</description></item>
+/// <item><description>Each Transform(Input, InOffset, Output, OutOffset, Length) call processes one data unit of Length bytes, and increments the data unit number; Length must be at least one block.</description></item>
+/// <item><description>TransformSectors encrypts or decrypts consecutive data units of SectorSize bytes beginning at an explicit sector number, and does not change the data unit number of the instance.</description></item>
+/// <item><description>If IsParallel() is set to true, a batch of at least ParallelBlockSize() bytes is processed with multiple threads.</description></item>
+/// <item><description>The ParallelBlockSize(), IsParallel(), and ParallelThreadsMax() accessors, can be changed through the ParallelProfile() property.</description></item>
+/// </list>
+///
+/// <description>Guiding Publications:</description>
+/// <list type="number">
+/// <item><description>IEEE Std 1619-2007: <a href="https://ieeexplore.ieee.org/document/4493450">Cryptographic Protection of Data on Block-Oriented Storage Devices</a>.</description></item>
+/// <item><description>NIST <a href="https://nvlpubs.nist.gov/nistpubs/Legacy/SP/nistspecialpublication800-38e.pdf">SP800-38E</a>: The XTS-AES Mode for Confidentiality on Storage Devices.</description></item>
+/// </list>
+/// </remarks>
+class XTS final : public ICipherMode
+{
+private:
+
+	static const size_t BLOCK_SIZE = 16;
+	// the number of blocks transformed together by the widest block cipher function
+	static const size_t WIDE_BLOCKS = 16;
+	// the block tweaks, the tweaked data and the cipher output of one wide transform, followed by the running tweak
+	static const size_t SCRATCH_SIZE = (3 * WIDE_BLOCKS * BLOCK_SIZE) + BLOCK_SIZE;
+
+	class XtsState;
+	std::unique_ptr<XtsState> m_xtsState;
+	std::unique_ptr<IBlockCipher> m_blockCipher;
+	std::unique_ptr<IBlockCipher> m_tweakCipher;
+	ParallelOptions m_parallelProfile;
+
+public:
+
+	//~~~Constructor~~~//
+
+	/// <summary>
+	/// Copy constructor: copy is restricted, this function has been deleted
+	/// </summary>
+	XTS(const XTS&) = delete;
+
+	/// <summary>
+	/// Copy operator: copy is restricted, this function has been deleted
+	/// </summary>
+	XTS& operator=(const XTS&) = delete;
+
+	/// <summary>
+	/// Default constructor: default is restricted, this function has been deleted
+	/// </summary>
+	XTS() = delete;
+
+	/// <summary>
+	/// Initialize the Cipher Mode using a block-cipher type name
+	/// </summary>
+	///
+	/// <param name="CipherType">The enumeration type name of the block-cipher</param>
+	///
+	/// <exception cref="CryptoCipherModeException">Thrown if a undefined block-cipher type name is used</exception>
+	explicit XTS(BlockCiphers CipherType);
+
+	/// <summary>
+	/// Initialize the Cipher Mode using a block-cipher instance.
+	/// <para>The tweak cipher is created internally, with the same block cipher type.</para>
+	/// </summary>
+	///
+	/// <param name="Cipher">The uninitialized block-cipher instance; can not be null</param>
+	///
+	/// <exception cref="CryptoCipherModeException">Thrown if a null block-cipher is used</exception>
+	explicit XTS(IBlockCipher* Cipher);
+
+	/// <summary>
+	/// Destructor: finalize this class
+	/// </summary>
+	~XTS() override;
+
+	//~~~Accessors~~~//
+
+	/// <summary>
+	/// Read Only: The ciphers internal block-size in bytes
+	/// </summary>
+	const size_t BlockSize() override;
+
+	/// <summary>
+	/// Read Only: The block ciphers enumeration type name
+	/// </summary>
+	const BlockCiphers CipherType() override;
+
+	/// <summary>
+	/// Read Only: A pointer to the underlying data block-cipher instance
+	/// </summary>
+	IBlockCipher* Engine() override;
+
+	/// <summary>
+	/// Read Only: The cipher modes enumeration type name
+	/// </summary>
+	const CipherModes Enumeral() override;
+
+	/// <summary>
+	/// Read Only: The operation mode, returns true if initialized for encryption, false for decryption
+	/// </summary>
+	const bool IsEncryption() override;
+
+	/// <summary>
+	/// Read Only: The block-cipher mode has been keyed and is ready to transform data
+	/// </summary>
+	const bool IsInitialized() override;
+
+	/// <summary>
+	/// Read Only: Processor parallelization availability.
+	/// <para>Indicates whether parallel processing is available with this mode.
+	/// If parallel capable, a sector batch of at least ParallelBlockSize bytes is processed in parallel.</para>
+	/// </summary>
+	const bool IsParallel() override;
+
+	/// <summary>
+	/// Read Only: A vector of allowed cipher-mode input key uint8_t-sizes; the combined data and tweak key lengths
+	/// </summary>
+	const std::vector<SymmetricKeySize> &LegalKeySizes() override;
+
+	/// <summary>
+	/// Read Only: The cipher-modes formal class name
+	/// </summary>
+	const std::string Name() override;
+
+	/// <summary>
+	/// Read Only: Parallel block size; the uint8_t-size of a sector batch that triggers parallel processing.
+	/// <para>This value can be changed through the ParallelProfile class.</para>
+	/// </summary>
+	const size_t ParallelBlockSize() override;
+
+	/// <summary>
+	/// Read/Write: Contains parallel and SIMD capability flags and sizes
+	/// </summary>
+	ParallelOptions &ParallelProfile() override;
+
+	/// <summary>
+	/// Read Only: The number of the next data unit processed by Transform, as a 16 byte little-endian integer
+	/// </summary>
+	const std::vector<uint8_t> Sector();
+
+	//~~~Public Functions~~~//
+
+	/// <summary>
+	/// Decrypt a single block data unit.
+	/// <para>Decrypts one block with the tweak of the current data unit, and increments the data unit number.
+	/// Initialize(bool, ISymmetricKey) must be called with the Encryption flag set to false before this method can be used.</para>
+	/// </summary>
+	///
+	/// <param name="Input">The input vector of cipher-text bytes</param>
+	/// <param name="Output">The output vector of plain-text bytes</param>
+	void DecryptBlock(const std::vector<uint8_t> &Input, std::vector<uint8_t> &Output) override;
+
+	/// <summary>
+	/// Decrypt a single block data unit with offset parameters.
+	/// <para>Decrypts one block with the tweak of the current data unit, and increments the data unit number.
+	/// Initialize(bool, ISymmetricKey) must be called with the Encryption flag set to false before this method can be used.</para>
+	/// </summary>
+	///
+	/// <param name="Input">The input vector of cipher-text bytes</param>
+	/// <param name="InOffset">Starting offset within the input vector</param>
+	/// <param name="Output">The output vector of plain-text bytes</param>
+	/// <param name="OutOffset">Starting offset within the output vector</param>
+	void DecryptBlock(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset) override;
+
+	/// <summary>
+	/// Decrypt a block of bytes in the callers memory.
+	/// <para>Decrypts one block of bytes without copying it to a vector; Input and Output may be the same address.
+	/// Initialize(bool, ISymmetricKey) must be called before this method can be used.</para>
+	/// </summary>
+	/// 
+	/// <param name="Input">A pointer to the block of cipher-text bytes</param>
+	/// <param name="Output">A pointer to the block of plain-text bytes</param>
+	void DecryptBlock(const uint8_t* Input, uint8_t* Output) override;
+
+	/// <summary>
+	/// Encrypt a single block data unit.
+	/// <para>Encrypts one block with the tweak of the current data unit, and increments the data unit number.
+	/// Initialize(bool, ISymmetricKey) must be called with the Encryption flag set to true before this method can be used.</para>
+	/// </summary>
+	///
+	/// <param name="Input">The input vector of plain-text bytes</param>
+	/// <param name="Output">The output vector of cipher-text bytes</param>
+	void EncryptBlock(const std::vector<uint8_t> &Input, std::vector<uint8_t> &Output) override;
+
+	/// <summary>
+	/// Encrypt a single block data unit with offset parameters.
+	/// <para>Encrypts one block with the tweak of the current data unit, and increments the data unit number.
+	/// Initialize(bool, ISymmetricKey) must be called with the Encryption flag set to true before this method can be used.</para>
+	/// </summary>
+	///
+	/// <param name="Input">The input vector of plain-text bytes</param>
+	/// <param name="InOffset">Starting offset within the input vector</param>
+	/// <param name="Output">The output vector of cipher-text bytes</param>
+	/// <param name="OutOffset">Starting offset within the output vector</param>
+	void EncryptBlock(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset) override;
+
+	/// <summary>
+	/// Encrypt a block of bytes in the callers memory.
+	/// <para>Encrypts one block of bytes without copying it to a vector; Input and Output may be the same address.
+	/// Initialize(bool, ISymmetricKey) must be called before this method can be used.</para>
+	/// </summary>
+	/// 
+	/// <param name="Input">A pointer to the block of plain-text bytes</param>
+	/// <param name="Output">A pointer to the block of cipher-text bytes</param>
+	void EncryptBlock(const uint8_t* Input, uint8_t* Output) override;
+
+	/// <summary>
+	/// Initialize the Cipher instance
+	/// </summary>
+	///
+	/// <param name="Encryption">Operation mode, true if cipher is used for encryption, false to decrypt</param>
+	/// <param name="Parameters">SymmetricKey containing the data key followed by the tweak key, and the 16 byte little-endian number of the first data unit</param>
+	///
+	/// <exception cref="CryptoCipherModeException">Thrown if an invalid key or data unit number is used</exception>
+	void Initialize(bool Encryption, ISymmetricKey &Parameters) override;
+
+	/// <summary>
+	/// Set the maximum number of threads allocated when using multi-threaded processing.
+	/// <para>When set to zero, thread count is set automatically. If set to 1, runs in sequential mode.
+	/// Thread count must be an even number, and not exceed the number of processor cores.</para>
+	/// </summary>
+	///
+	/// <param name="Degree">The number of threads to allocate</param>
+	///
+	/// <exception cref="CryptoCipherModeException">Thrown if the degree parameter is invalid</exception>
+	void ParallelMaxDegree(size_t Degree) override;
+
+	/// <summary>
+	/// Transform one data unit with offset parameters.
+	/// <para>Encrypts or decrypts Length bytes as a single data unit with the tweak of the current data unit number, then increments the number.
+	/// A length that is not a multiple of the block size is processed with ciphertext stealing.
+	/// Initialize(bool, ISymmetricKey) must be called before this method can be used.</para>
+	/// </summary>
+	///
+	/// <param name="Input">The input vector of bytes to transform</param>
+	/// <param name="InOffset">Starting offset within the input vector</param>
+	/// <param name="Output">The output vector of transformed bytes</param>
+	/// <param name="OutOffset">Starting offset within the output vector</param>
+	/// <param name="Length">The number of bytes in the data unit; must be at least one block</param>
+	///
+	/// <exception cref="CryptoCipherModeException">Thrown if the length is smaller than a block</exception>
+	void Transform(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Length) override;
+
+	/// <summary>
+	/// Transform a length of bytes in the callers memory. 
+	/// <para>The pointer form of Transform, for buffers that are not held in a vector, such as pooled, mapped or scatter-gather memory.
+	/// The data unit is staged through a working buffer and processed by the vector transform, which advances the sector number as it does;
+	/// Input and Output may be the same address for an in-place transform, but must not otherwise overlap.
+	/// Initialize(bool, ISymmetricKey) must be called before this method can be used.</para>
+	/// </summary>
+	/// 
+	/// <param name="Input">A pointer to the bytes to transform</param>
+	/// <param name="Output">A pointer to the transformed bytes</param>
+	/// <param name="Length">The number of bytes to transform</param>
+	void Transform(const uint8_t* Input, uint8_t* Output, size_t Length) override;
+
+	/// <summary>
+	/// Transform a batch of consecutive data units, beginning at an explicit sector number.
+	/// <para>Sector j of the batch is processed with the tweak of data unit Sector + j; the data unit number of the instance is not changed,
+	/// so sectors can be processed in any order. If IsParallel() is set to true, and the batch is at least ParallelBlockSize() bytes, the sectors are divided across threads.
+	/// Initialize(bool, ISymmetricKey) must be called before this method can be used.</para>
+	/// </summary>
+	///
+	/// <param name="Input">The input vector of bytes to transform</param>
+	/// <param name="InOffset">Starting offset within the input vector</param>
+	/// <param name="Output">The output vector of transformed bytes</param>
+	/// <param name="OutOffset">Starting offset within the output vector</param>
+	/// <param name="SectorSize">The size of each data unit in bytes; must be at least one block</param>
+	/// <param name="SectorCount">The number of data units to transform</param>
+	/// <param name="Sector">The number of the first data unit</param>
+	///
+	/// <exception cref="CryptoCipherModeException">Thrown if the sector size is smaller than a block, or the vectors are too small</exception>
+	void TransformSectors(const std::vector<uint8_t> &Input, size_t InOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t SectorSize, size_t SectorCount, uint64_t Sector);
+
+private:
+
+	static void Double(std::vector<uint8_t> &Tweak, size_t TweakOffset, std::vector<uint8_t> &Output, size_t OutOffset, size_t Count);
+	void Process(const uint8_t* Input, uint8_t* Output, size_t Length, const std::vector<uint8_t> &Sector, std::vector<uint8_t> &Buffer);
+	void Transform128(const uint8_t* Input, uint8_t* Output);
+};
+
+NAMESPACE_MODEEND
+#endif
@@ -1,7 +1,14 @@
 #include "AeadTest.h"
+#include "../CEX/CMUL.h"
+#include "../CEX/CTR.h"
 #include "../CEX/GCM.h"
+#include "../CEX/GCMSIV.h"
+#include "../CEX/GHASH.h"
 #include "../CEX/HBA.h"
 #include "../CEX/IntegerTools.h"
+#include "../CEX/MemoryTools.h"
+#include "../CEX/POLYVAL.h"
+#include "../CEX/RHX.h"
 #include "../CEX/SecureRandom.h"
 
 namespace Test
@@ -9,12 +16,19 @@ namespace Test
 	using Enumeration::AeadModes;
 	using Enumeration::AeadModeConvert;
 	using Enumeration::BlockCiphers;
+	using Numeric::CMUL;
+	using Cipher::Block::Mode::CTR;
 	using Exception::CryptoAuthenticationFailure;
 	using Exception::CryptoCipherModeException;
 	using Cipher::Block::Mode::GCM;
+	using Cipher::Block::Mode::GCMSIV;
+	using Digest::GHASH;
 	using Cipher::Block::Mode::HBA;
 	using Cipher::Block::IBlockCipher;
+	using Cipher::Block::RHX;
 	using Tools::IntegerTools;
+	using Tools::MemoryTools;
+	using Digest::POLYVAL;
 	using Enumeration::StreamAuthenticators;
 	using Cipher::SymmetricKeySize;
 
@@ -105,6 +119,9 @@ namespace Test
 			Stress(hbar256k256);
 			OnProgress(std::string("AeadTest: Passed HBA stress tests.."));
 
+			Pointer(hbar256k256);
+			OnProgress(std::string("AeadTest: Passed HBA pointer and in-place transform tests.."));
+
 			delete hbaa256h256;
 			delete hbaa256k256;
 			delete hbar256k256;
@@ -132,10 +149,38 @@ namespace Test
 			Kat(gcma, m_key[18], m_nonce[18], m_associatedText[18], m_plainText[18], m_cipherText[51]);
 			Kat(gcma, m_key[19], m_nonce[19], m_associatedText[19], m_plainText[19], m_cipherText[52]);
 			Kat(gcma, m_key[20], m_nonce[20], m_associatedText[20], m_plainText[20], m_cipherText[53]);
-			delete gcma;
 
 			OnProgress(std::string("AeadTest: Passed GCM known answer comparison tests.."));
 
+			Parallel(gcma);
+			Segments();
+			OnProgress(std::string("AeadTest: Passed GCM parallel and segmented hash tests.."));
+
+			Pointer(gcma);
+			OnProgress(std::string("AeadTest: Passed GCM pointer and in-place transform tests.."));
+			delete gcma;
+
+			Stitched();
+			OnProgress(std::string("AeadTest: Passed GCM stitched and aggregated reference comparison tests.."));
+
+			// GCM-SIV
+			GCMSIV* sivsa = new GCMSIV(Enumeration::BlockCiphers::AES);
+			Kat(sivsa, m_key[21], m_nonce[21], m_associatedText[21], m_plainText[21], m_cipherText[54]);
+			Kat(sivsa, m_key[22], m_nonce[22], m_associatedText[22], m_plainText[22], m_cipherText[55]);
+			Kat(sivsa, m_key[23], m_nonce[23], m_associatedText[23], m_plainText[23], m_cipherText[56]);
+			Kat(sivsa, m_key[24], m_nonce[24], m_associatedText[24], m_plainText[24], m_cipherText[57]);
+			Kat(sivsa, m_key[25], m_nonce[25], m_associatedText[25], m_plainText[25], m_cipherText[58]);
+			Kat(sivsa, m_key[26], m_nonce[26], m_associatedText[26], m_plainText[26], m_cipherText[59]);
+			Kat(sivsa, m_key[27], m_nonce[27], m_associatedText[27], m_plainText[27], m_cipherText[60]);
+			OnProgress(std::string("AeadTest: Passed GCM-SIV known answer comparison tests.."));
+
+			Parallel(sivsa);
+			Stress(sivsa);
+			Pointer(sivsa);
+			delete sivsa;
+			GcmSiv();
+			OnProgress(std::string("AeadTest: Passed GCM-SIV parallel, stress, pointer, and POLYVAL tests.."));
+
 			return SUCCESS;
 		}
 		catch (TestException const &ex)
@@ -318,7 +363,100 @@ namespace Test
 		}
 	}
 
-	void AeadTest::Kat(IAeadMode* Cipher, const std::vector<uint8_t> &Key, const std::vector<uint8_t> &Nonce, 
+	void AeadTest::GcmSiv()
+	{
+		std::vector<uint8_t> dec;
+		std::vector<uint8_t> enc1;
+		std::vector<uint8_t> enc2;
+		std::vector<uint8_t> exp;
+		std::vector<uint8_t> hkey;
+		std::vector<uint8_t> msg;
+		std::vector<uint8_t> y(16);
+		Prng::SecureRandom rng;
+		GCMSIV cpr(BlockCiphers::AES);
+		POLYVAL pvl;
+		size_t i;
+		bool fail;
+
+		// the POLYVAL result of RFC 8452 C.1, the 8 byte message with the derived authentication key
+		HexConverter::Decode(std::string("D9B360279694941AC5DBC6987ADA7377"), hkey);
+		HexConverter::Decode(std::string("0100000000000000"), msg);
+		HexConverter::Decode(std::string("EB93B7740962C5E49D2A90A7DC5CEC74"), exp);
+		pvl.Initialize(hkey);
+		pvl.Update(msg, 0, y, msg.size());
+		pvl.Finalize(y, 0, msg.size());
+
+		if (y != exp)
+		{
+			throw TestException(std::string("GcmSiv"), std::string("POLYVAL"), std::string("The hash output is not equal! -AV1"));
+		}
+
+		for (i = 0; i < TEST_CYCLES; ++i)
+		{
+			msg.resize(rng.NextUInt32(5000, 1));
+			rng.Generate(msg);
+			std::vector<uint8_t> aad = rng.Generate(rng.NextUInt32(64, 1));
+			std::vector<uint8_t> key = rng.Generate((i % 2 == 0) ? 16 : 32);
+			std::vector<uint8_t> nonce = rng.Generate(12);
+			SymmetricKey kp(key, nonce);
+
+			enc1.resize(msg.size() + cpr.TagSize());
+			cpr.Initialize(true, kp);
+			cpr.SetAssociatedData(aad, 0, aad.size());
+			cpr.Transform(msg, 0, enc1, 0, msg.size());
+
+			// a nonce-only initialization reuses the key-generating key
+			const std::vector<uint8_t> ZKEY(0);
+			SymmetricKey np(ZKEY, nonce);
+			enc2.resize(msg.size() + cpr.TagSize());
+			cpr.Initialize(true, np);
+			cpr.SetAssociatedData(aad, 0, aad.size());
+			cpr.Transform(msg, 0, enc2, 0, msg.size());
+
+			if (enc1 != enc2)
+			{
+				throw TestException(std::string("GcmSiv"), cpr.Name(), std::string("The nonce initialized output is not equal! -AV2"));
+			}
+
+			// in-place decryption
+			cpr.Initialize(false, kp);
+			cpr.SetAssociatedData(aad, 0, aad.size());
+			cpr.Transform(enc2, 0, enc2, 0, msg.size());
+
+			if (IntegerTools::Compare(enc2, 0, msg, 0, msg.size()) == false)
+			{
+				throw TestException(std::string("GcmSiv"), cpr.Name(), std::string("The decrypted output is not equal! -AV3"));
+			}
+
+			// a modified cipher-text is rejected, and the output is erased
+			enc1[rng.NextUInt32(static_cast<uint32_t>(msg.size() - 1), 0)] ^= 0x01;
+			dec.resize(msg.size());
+			fail = false;
+			cpr.Initialize(false, kp);
+			cpr.SetAssociatedData(aad, 0, aad.size());
+
+			try
+			{
+				cpr.Transform(enc1, 0, dec, 0, msg.size());
+			}
+			catch (CryptoAuthenticationFailure const &)
+			{
+				fail = true;
+			}
+
+			if (fail == false)
+			{
+				throw TestException(std::string("GcmSiv"), cpr.Name(), std::string("The modified cipher-text was authenticated! -AV4"));
+			}
+
+			if (dec != std::vector<uint8_t>(msg.size(), 0x00))
+			{
+				throw TestException(std::string("GcmSiv"), cpr.Name(), std::string("The unauthenticated output was not erased! -AV5"));
+			}
+		}
+	}
+
+	void AeadTest::Kat(IAeadMode* Cipher, const std::vector<uint8_t> &Key, const std::vector<uint8_t> &Nonce,
 		const std::vector<uint8_t> &AssociatedText, const std::vector<uint8_t> &PlainText, const std::vector<uint8_t> &CipherText)
 	{
 		const size_t CPTLEN = CipherText.size();
@@ -433,6 +571,250 @@ namespace Test
 		}
 	}
 
+	void AeadTest::Segments()
+	{
+		std::vector<uint8_t> exp(16);
+		std::vector<uint8_t> msg;
+		std::vector<uint8_t> prt(16);
+		std::vector<uint8_t> tag(16);
+		std::vector<uint64_t> hkey(2);
+		Prng::SecureRandom rng;
+		GHASH gsh;
+		size_t i;
+		size_t j;
+		size_t scnt;
+		size_t slen;
+
+		for (i = 0; i < TEST_CYCLES; ++i)
+		{
+			msg.resize(rng.NextUInt32(20000, 1));
+			rng.Generate(msg);
+			hkey[0] = rng.NextUInt64();
+			hkey[1] = rng.NextUInt64();
+			gsh.Initialize(hkey);
+
+			// the sequential hash of the message
+			exp = rng.Generate(16);
+			tag = exp;
+			gsh.Update(msg, 0, exp, msg.size());
+			gsh.Finalize(exp, 0, msg.size());
+			gsh.Clear();
+
+			// block aligned segments of random length, and a last segment with the remainder
+			scnt = rng.NextUInt32(8, 1);
+			slen = ((msg.size() / scnt) / 16) * 16;
+
+			for (j = 0; j < scnt; ++j)
+			{
+				const size_t PRTLEN = (j == scnt - 1) ? msg.size() - (j * slen) : slen;
+				gsh.Partial(msg, j * slen, PRTLEN, prt);
+				gsh.Combine(prt, (PRTLEN + 15) / 16, tag);
+			}
+
+			gsh.Finalize(tag, 0, msg.size());
+			gsh.Clear();
+
+			if (tag != exp)
+			{
+				throw TestException(std::string("Segments"), std::string("GHASH"), std::string("The combined segment hash is not equal! -AS1"));
+			}
+		}
+	}
+
+	void AeadTest::Stitched()
+	{
+		const std::vector<uint8_t> ZEROES(16, 0x00);
+		std::array<uint64_t, CMUL::CMUL_STATE_SIZE> hkey;
+		std::array<uint8_t, CMUL::CMUL_BLOCK_SIZE> y;
+		std::vector<uint8_t> ctr(16);
+		std::vector<uint8_t> dec;
+		std::vector<uint8_t> enc;
+		std::vector<uint8_t> exp;
+		std::vector<uint8_t> h(16);
+		std::vector<uint8_t> j0(16);
+		std::vector<uint8_t> msg;
+		std::vector<uint8_t> pad;
+		std::vector<uint8_t> tag(16);
+		std::vector<uint8_t> aad;
+		Prng::SecureRandom rng;
+		GCM cpr(BlockCiphers::AES);
+		RHX blk;
+		CTR ctm(BlockCiphers::AES);
+		size_t i;
+		size_t j;
+
+		cpr.ParallelProfile().IsParallel() = false;
+
+		for (i = 0; i < TEST_CYCLES; ++i)
+		{
+			// lengths below, at, and well above the eight block stitched chunk
+			msg.resize((i == 0) ? 0 : rng.NextUInt32(3000, 1));
+			aad.resize(rng.NextUInt32(40, 0));
+			rng.Generate(msg);
+			rng.Generate(aad);
+			std::vector<uint8_t> key = rng.Generate(32);
+			std::vector<uint8_t> nonce = rng.Generate(12);
+
+			// reference: H = E(0), J0 = N || 1, C = CTR(J0 + 1), T = GHASH(A, C) ^ E(J0)
+			SymmetricKey bkp(key);
+			blk.Initialize(true, bkp);
+			blk.EncryptBlock(ZEROES, 0, h, 0);
+			MemoryTools::Copy(nonce, 0, j0, 0, nonce.size());
+			j0[15] = 0x01;
+			blk.EncryptBlock(j0, 0, tag, 0);
+			MemoryTools::COPY128(j0, 0, ctr, 0);
+			IntegerTools::BeIncrement8(ctr);
+
+			exp.resize(msg.size() + 16);
+			SymmetricKey ckp(key, ctr);
+			ctm.Initialize(true, ckp);
+			ctm.Transform(msg, 0, exp, 0, msg.size());
+
+			hkey[0] = IntegerTools::BeBytesTo64(h, 0);
+			hkey[1] = IntegerTools::BeBytesTo64(h, 8);
+			y.fill(0x00);
+
+			pad.resize(aad.size() + ((16 - (aad.size() % 16)) % 16));
+			std::fill(pad.begin(), pad.end(), 0x00);
+			MemoryTools::Copy(aad, 0, pad, 0, aad.size());
+
+			for (j = 0; j < pad.size(); j += 16)
+			{
+				MemoryTools::XOR128(pad, j, y, 0);
+				CMUL::PermuteR128P128C(hkey, y);
+			}
+
+			pad.resize(msg.size() + ((16 - (msg.size() % 16)) % 16));
+			std::fill(pad.begin(), pad.end(), 0x00);
+			MemoryTools::Copy(exp, 0, pad, 0, msg.size());
+
+			for (j = 0; j < pad.size(); j += 16)
+			{
+				MemoryTools::XOR128(pad, j, y, 0);
+				CMUL::PermuteR128P128C(hkey, y);
+			}
+
+			pad.resize(16);
+			IntegerTools::Be64ToBytes(static_cast<uint64_t>(aad.size()) * 8, pad, 0);
+			IntegerTools::Be64ToBytes(static_cast<uint64_t>(msg.size()) * 8, pad, 8);
+			MemoryTools::XOR128(pad, 0, y, 0);
+			CMUL::PermuteR128P128C(hkey, y);
+			MemoryTools::XOR128(y, 0, tag, 0);
+			MemoryTools::Copy(tag, 0, exp, msg.size(), 16);
+
+			// the mode output
+			SymmetricKey kp(key, nonce);
+			enc.resize(msg.size() + cpr.TagSize());
+			cpr.Initialize(true, kp);
+			cpr.SetAssociatedData(aad, 0, aad.size());
+			cpr.Transform(msg, 0, enc, 0, msg.size());
+
+			if (enc != exp)
+			{
+				throw TestException(std::string("Stitched"), cpr.Name(), std::string("The encrypted output is not equal! -AT1"));
+			}
+
+			dec.resize(msg.size());
+			cpr.Initialize(false, kp);
+			cpr.SetAssociatedData(aad, 0, aad.size());
+			cpr.Transform(enc, 0, dec, 0, msg.size());
+
+			if (dec != msg)
+			{
+				throw TestException(std::string("Stitched"), cpr.Name(), std::string("The decrypted output is not equal! -AT2"));
+			}
+		}
+	}
+
+	void AeadTest::Pointer(IAeadMode* Cipher)
+	{
+		SymmetricKeySize keySize = Cipher->LegalKeySizes()[0];
+		std::vector<uint8_t> assoc;
+		std::vector<uint8_t> data;
+		std::vector<uint8_t> enc1;
+		std::vector<uint8_t> enc2;
+		std::vector<uint8_t> key(32);
+		std::vector<uint8_t> nonce(keySize.IVSize());
+		Prng::SecureRandom rng;
+
+		Cipher->ParallelProfile().IsParallel() = true;
+
+		for (size_t i = 0; i < TEST_CYCLES; ++i)
+		{
+			// the message and associated data span several segments
+			const size_t MSGLEN = rng.NextUInt32(static_cast<uint32_t>(Cipher->ParallelBlockSize() * 3), 1);
+			const size_t ADLEN = rng.NextUInt32(static_cast<uint32_t>(Cipher->ParallelBlockSize() * 2), 1);
+			assoc.resize(ADLEN);
+			data.resize(MSGLEN);
+			enc1.resize(MSGLEN + Cipher->TagSize());
+			enc2.resize(MSGLEN + Cipher->TagSize());
+			rng.Generate(assoc);
+			rng.Generate(data);
+			rng.Generate(key);
+			rng.Generate(nonce);
+			SymmetricKey kp(key, nonce);
+
+			Cipher->Initialize(true, kp);
+			Cipher->SetAssociatedData(assoc, 0, assoc.size());
+			Cipher->Transform(data, 0, enc1, 0, MSGLEN);
+
+			// encrypt to a separate buffer
+			Cipher->Initialize(true, kp);
+			Cipher->SetAssociatedData(assoc.data(), assoc.size());
+			Cipher->Transform(data.data(), enc2.data(), MSGLEN);
+
+			if (enc1 != enc2)
+			{
+				throw TestException(std::string("Pointer"), Cipher->Name(), std::string("AeadTest: Encrypted output is not equal! -AP1"));
+			}
+
+			// encrypt in place; the tag is written after the message
+			MemoryTools::Clear(enc2, 0, enc2.size());
+			MemoryTools::Copy(data, 0, enc2, 0, MSGLEN);
+			Cipher->Initialize(true, kp);
+			Cipher->SetAssociatedData(assoc.data(), assoc.size());
+			Cipher->Transform(enc2.data(), enc2.data(), MSGLEN);
+
+			if (enc1 != enc2)
+			{
+				throw TestException(std::string("Pointer"), Cipher->Name(), std::string("AeadTest: Encrypted output is not equal! -AP2"));
+			}
+
+			// decrypt in place
+			Cipher->Initialize(false, kp);
+			Cipher->SetAssociatedData(assoc.data(), assoc.size());
+
+			try
+			{
+				Cipher->Transform(enc2.data(), enc2.data(), MSGLEN);
+			}
+			catch (CryptoAuthenticationFailure const&)
+			{
+				throw TestException(std::string("Pointer"), Cipher->Name(), std::string("AeadTest: Authentication failure! -AP3"));
+			}
+
+			if (IntegerTools::Compare(data, 0, enc2, 0, MSGLEN) == false)
+			{
+				throw TestException(std::string("Pointer"), Cipher->Name(), std::string("AeadTest: Decrypted output is not equal! -AP4"));
+			}
+
+			// a modified tag must fail authentication
+			enc1[MSGLEN] ^= 0x01;
+			Cipher->Initialize(false, kp);
+			Cipher->SetAssociatedData(assoc.data(), assoc.size());
+
+			try
+			{
+				Cipher->Transform(enc1.data(), enc2.data(), MSGLEN);
+
+				throw TestException(std::string("Pointer"), Cipher->Name(), std::string("AeadTest: Exception handling failure! -AP5"));
+			}
+			catch (CryptoAuthenticationFailure const&)
+			{
+			}
+		}
+	}
+
 	void AeadTest::Stress(IAeadMode* Cipher)
 	{
 		SymmetricKeySize keySize = Cipher->LegalKeySizes()[0];
@@ -517,9 +899,17 @@ namespace Test
 			std::string("FEFFE9928665731C6D6A8F9467308308FEFFE9928665731C6D6A8F9467308308"),
 			std::string("FEFFE9928665731C6D6A8F9467308308FEFFE9928665731C6D6A8F9467308308"),
 			std::string("FEFFE9928665731C6D6A8F9467308308FEFFE9928665731C6D6A8F9467308308"),
-			std::string("FEFFE9928665731C6D6A8F9467308308FEFFE9928665731C6D6A8F9467308308")
+			std::string("FEFFE9928665731C6D6A8F9467308308FEFFE9928665731C6D6A8F9467308308"),
+			// GCM-SIV
+			std::string("01000000000000000000000000000000"),
+			std::string("01000000000000000000000000000000"),
+			std::string("01000000000000000000000000000000"),
+			std::string("01000000000000000000000000000000"),
+			std::string("0100000000000000000000000000000000000000000000000000000000000000"),
+			std::string("0100000000000000000000000000000000000000000000000000000000000000"),
+			std::string("0100000000000000000000000000000000000000000000000000000000000000")
 		};
-		HexConverter::Decode(key, 21, m_key);
+		HexConverter::Decode(key, 28, m_key);
 
 		const std::vector<std::string> nonce =
 		{
@@ -545,9 +935,17 @@ namespace Test
 			std::string("CAFEBABEFACEDBADDECAF888"),
 			std::string("CAFEBABEFACEDBADDECAF888"),
 			std::string("CAFEBABEFACEDBAD"),
-			std::string("9313225DF88406E555909C5AFF5269AA6A7A9538534F7DA1E4C303D2A318A728C3C0C95156809539FCF0E2429A6B525416AEDBF5A0DE6A57A637B39B")
+			std::string("9313225DF88406E555909C5AFF5269AA6A7A9538534F7DA1E4C303D2A318A728C3C0C95156809539FCF0E2429A6B525416AEDBF5A0DE6A57A637B39B"),
+			// GCM-SIV
+			std::string("030000000000000000000000"),
+			std::string("030000000000000000000000"),
+			std::string("030000000000000000000000"),
+			std::string("030000000000000000000000"),
+			std::string("030000000000000000000000"),
+			std::string("030000000000000000000000"),
+			std::string("030000000000000000000000")
 		};
-		HexConverter::Decode(nonce, 21, m_nonce);
+		HexConverter::Decode(nonce, 28, m_nonce);
 
 		const std::vector<std::string> associatedtext =
 		{
@@ -573,9 +971,17 @@ namespace Test
 			std::string(""),
 			std::string("FEEDFACEDEADBEEFFEEDFACEDEADBEEFABADDAD2"),
 			std::string("FEEDFACEDEADBEEFFEEDFACEDEADBEEFABADDAD2"),
-			std::string("FEEDFACEDEADBEEFFEEDFACEDEADBEEFABADDAD2")
+			std::string("FEEDFACEDEADBEEFFEEDFACEDEADBEEFABADDAD2"),
+			// GCM-SIV
+			std::string(""),
+			std::string(""),
+			std::string("01"),
+			std::string("0100000000000000000000000000000002000000"),
+			std::string(""),
+			std::string(""),
+			std::string("01")
 		};
-		HexConverter::Decode(associatedtext, 21, m_associatedText);
+		HexConverter::Decode(associatedtext, 28, m_associatedText);
 
 		const std::vector<std::string> plaintext =
 		{
@@ -601,9 +1007,17 @@ namespace Test
 			std::string("D9313225F88406E5A55909C5AFF5269A86A7A9531534F7DA2E4C303D8A318A721C3C0C95956809532FCF0E2449A6B525B16AEDF5AA0DE657BA637B391AAFD255"),
 			std::string("D9313225F88406E5A55909C5AFF5269A86A7A9531534F7DA2E4C303D8A318A721C3C0C95956809532FCF0E2449A6B525B16AEDF5AA0DE657BA637B39"),
 			std::string("D9313225F88406E5A55909C5AFF5269A86A7A9531534F7DA2E4C303D8A318A721C3C0C95956809532FCF0E2449A6B525B16AEDF5AA0DE657BA637B39"),
-			std::string("D9313225F88406E5A55909C5AFF5269A86A7A9531534F7DA2E4C303D8A318A721C3C0C95956809532FCF0E2449A6B525B16AEDF5AA0DE657BA637B39")
+			std::string("D9313225F88406E5A55909C5AFF5269A86A7A9531534F7DA2E4C303D8A318A721C3C0C95956809532FCF0E2449A6B525B16AEDF5AA0DE657BA637B39"),
+			// GCM-SIV
+			std::string(""),
+			std::string("010000000000000000000000000000000200000000000000000000000000000003000000000000000000000000000000"),
+			std::string("0200000000000000"),
+			std::string("030000000000000000000000"),
+			std::string(""),
+			std::string("0100000000000000000000000000000002000000000000000000000000000000"),
+			std::string("020000000000000000000000000000000300000000000000000000000000000004000000000000000000000000000000")
 		};
-		HexConverter::Decode(plaintext, 21, m_plainText);
+		HexConverter::Decode(plaintext, 28, m_plainText);
 
 		const std::vector<std::string> ciphertext =
 		{
@@ -703,9 +1117,17 @@ namespace Test
 			std::string("522DC1F099567D07F47F37A32A84427D643A8CDCBFE5C0C97598A2BD2555D1AA8CB08E48590DBB3DA7B08B1056828838C5F61E6393BA7A0ABCC9F662898015ADB094DAC5D93471BDEC1A502270E3CC6C"),
 			std::string("522DC1F099567D07F47F37A32A84427D643A8CDCBFE5C0C97598A2BD2555D1AA8CB08E48590DBB3DA7B08B1056828838C5F61E6393BA7A0ABCC9F66276FC6ECE0F4E1768CDDF8853BB2D551B"),
 			std::string("C3762DF1CA787D32AE47C13BF19844CBAF1AE14D0B976AFAC52FF7D79BBA9DE0FEB582D33934A4F0954CC2363BC73F7862AC430E64ABE499F47C9B1F3A337DBF46A792C45E454913FE2EA8F2"),
-			std::string("5A8DEF2F0C9E53F1F75D7853659E2A20EEB2B22AAFDE6419A058AB4F6F746BF40FC0C3B780F244452DA3EBF1C5D82CDEA2418997200EF82E44AE7E3FA44A8266EE1C8EB0C8B5D4CF5AE9F19A")
+			std::string("5A8DEF2F0C9E53F1F75D7853659E2A20EEB2B22AAFDE6419A058AB4F6F746BF40FC0C3B780F244452DA3EBF1C5D82CDEA2418997200EF82E44AE7E3FA44A8266EE1C8EB0C8B5D4CF5AE9F19A"),
+			// GCM-SIV
+			std::string("DC20E2D83F25705BB49E439ECA56DE25"),
+			std::string("3FD24CE1F5A67B75BF2351F181A475C7B800A5B4D3DCF70106B1EEA82FA1D64DF42BF7226122FA92E17A40EEAAC1201B5E6E311DBF395D35B0FE39C2714388F8"),
+			std::string("1E6DABA35669F4273B0A1A2560969CDF790D99759ABD1508"),
+			std::string("AAC158BF77840F4BD1B53F6A4EB4961DBDDC4B0993A09A3EADBF4B70"),
+			std::string("07F5F4169BBF55A8400CD47EA6FD400F"),
+			std::string("4A6A9DB4C8C6549201B9EDB53006CBA821EC9CF850948A7C86C68AC7539D027FE819E63ABCD020B006A976397632EB5D"),
+			std::string("C67A1F0F567A5198AA1FCC8E3F21314336F7F51CA8B1AF61FEAC35A86416FA47FBCA3B5F749CDF564527F2314F42FE2503332742B228C647173616CFD44C54EB")
 		};
-		HexConverter::Decode(ciphertext, 54, m_cipherText);
+		HexConverter::Decode(ciphertext, 61, m_cipherText);
 
 		/*lint -restore */
 	}
@@ -12,7 +12,8 @@ namespace Test
 	/// Tests the AEAD cipher modes.
 	/// <para>Tests each AEAD mode for correct operation, including KAT, parallel-mode, auto-increment, exception handling, and stress tests.
 	/// HBA KAT tests are original vectors, generated with this library.
-	/// GCM KAT vectors are talken from: The Galois/Counter Mode of Operation (GCM), "https://eprint.iacr.org/2004/193.pdf"</para>
+	/// GCM KAT vectors are talken from: The Galois/Counter Mode of Operation (GCM), "https://eprint.iacr.org/2004/193.pdf"
+	/// GCM-SIV KAT vectors are taken from: RFC 8452, Appendix C, "https://tools.ietf.org/html/rfc8452"</para>
 	/// </summary>
 	class AeadTest final : public ITest
 	{
@@ -72,6 +73,11 @@ namespace Test
 		/// </summary>
 		void Exception();
 
+		/// <summary>
+		/// Test the POLYVAL function with the RFC 8452 example, and the GCM-SIV in-place decryption, nonce reuse, and tag rejection
+		/// </summary>
+		void GcmSiv();
+
 		/// <summary>
 		/// Compare output with known answer vectors
 		/// </summary>
@@ -92,6 +98,24 @@ namespace Test
 		/// <param name="Cipher">The cipher instance</param>
 		void Parallel(IAeadMode* Cipher);
 
+		/// <summary>
+		/// Compare the pointer forms of SetAssociatedData and Transform, out of place and in place, to the vector forms
+		/// </summary>
+		///
+		/// <param name="Cipher">The cipher instance</param>
+		void Pointer(IAeadMode* Cipher);
+
+		/// <summary>
+		/// Compare the GHASH segment hashes joined with powers of H, to the sequential hash
+		/// </summary>
+		void Segments();
+
+		/// <summary>
+		/// Compare the GCM output with a reference built from the CTR mode and the portable GHASH multiply, 
+		/// covering the stitched encryption and aggregated hash paths
+		/// </summary>
+		void Stitched();
+
 		/// <summary>
 		/// Test operations in a looping stress test
 		/// </summary>
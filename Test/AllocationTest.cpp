@@ -0,0 +1,175 @@
+#include "AllocationTest.h"
+#include "../CEX/BCG.h"
+#include "../CEX/ChaChaP20.h"
+#include "../CEX/CSX512.h"
+#include "../CEX/CTR.h"
+#include "../CEX/ICM.h"
+#include "../CEX/RCS.h"
+#include "../CEX/RWS.h"
+#include "../CEX/TSX512.h"
+#include <cstdlib>
+#include <new>
+
+// the counting allocator; replaces the global operators for the test executable
+void* operator new(size_t Size)
+{
+	void* ptr;
+
+	if (Test::AllocationTest::IsCounting)
+	{
+		++Test::AllocationTest::AllocationCount;
+	}
+
+	ptr = std::malloc(Size != 0 ? Size : 1);
+
+	if (ptr == nullptr)
+	{
+		throw std::bad_alloc();
+	}
+
+	return ptr;
+}
+
+void* operator new[](size_t Size)
+{
+	return operator new(Size);
+}
+
+void operator delete(void* Pointer) noexcept
+{
+	std::free(Pointer);
+}
+
+void operator delete[](void* Pointer) noexcept
+{
+	std::free(Pointer);
+}
+
+void operator delete(void* Pointer, size_t) noexcept
+{
+	std::free(Pointer);
+}
+
+void operator delete[](void* Pointer, size_t) noexcept
+{
+	std::free(Pointer);
+}
+
+namespace Test
+{
+	using Drbg::BCG;
+	using Cipher::Stream::ChaChaP20;
+	using Cipher::Stream::CSX512;
+	using Cipher::Block::Mode::CTR;
+	using Cipher::Block::Mode::ICM;
+	using Cipher::Stream::RCS;
+	using Cipher::Stream::RWS;
+	using Cipher::Stream::TSX512;
+	using Enumeration::BlockCiphers;
+
+	const std::string AllocationTest::CLASSNAME = "AllocationTest";
+	const std::string AllocationTest::DESCRIPTION = "Steady-state allocation test; counts the heap allocations of repeated sequential and parallel cipher transforms and generator requests.";
+	const std::string AllocationTest::SUCCESS = "SUCCESS! All Allocation tests have executed succesfully.";
+
+	std::atomic<size_t> AllocationTest::AllocationCount(0);
+	std::atomic<bool> AllocationTest::IsCounting(false);
+
+	AllocationTest::AllocationTest()
+		:
+		m_progressEvent()
+	{
+	}
+
+	AllocationTest::~AllocationTest()
+	{
+		IsCounting = false;
+	}
+
+	const std::string AllocationTest::Description()
+	{
+		return DESCRIPTION;
+	}
+
+	TestEventHandler &AllocationTest::Progress()
+	{
+		return m_progressEvent;
+	}
+
+	std::string AllocationTest::Run()
+	{
+		try
+		{
+			CipherMode();
+			OnProgress(std::string("AllocationTest: Passed CTR and ICM steady-state and precomputed key-stream allocation tests.."));
+			Generator();
+			OnProgress(std::string("AllocationTest: Passed BCG steady-state allocation tests.."));
+			StreamCipher();
+			OnProgress(std::string("AllocationTest: Passed CSX512, ChaChaP20, RCS, RWS and TSX512 steady-state allocation tests.."));
+
+			return SUCCESS;
+		}
+		catch (TestException const &ex)
+		{
+			IsCounting = false;
+			throw TestException(CLASSNAME, ex.Function(), ex.Origin(), ex.Message());
+		}
+		catch (CryptoException &ex)
+		{
+			IsCounting = false;
+			throw TestException(CLASSNAME, ex.Location(), ex.Origin(), ex.Message());
+		}
+		catch (std::exception const &ex)
+		{
+			IsCounting = false;
+			throw TestException(CLASSNAME, std::string("Unknown Origin"), std::string(ex.what()));
+		}
+	}
+
+	void AllocationTest::CipherMode()
+	{
+		CTR* ctr = new CTR(BlockCiphers::AES);
+		Measure(ctr, std::string("AM"));
+		MeasurePrecompute(ctr, std::string("AP1"));
+		delete ctr;
+
+		ICM* icm = new ICM(BlockCiphers::AES);
+		Measure(icm, std::string("AI"));
+		MeasurePrecompute(icm, std::string("AP2"));
+		delete icm;
+	}
+
+	void AllocationTest::Generator()
+	{
+		BCG* bcg = new BCG(Enumeration::Providers::None, true);
+		MeasureGenerator(bcg, std::string("AG"));
+		delete bcg;
+	}
+
+	void AllocationTest::StreamCipher()
+	{
+		CSX512* csx = new CSX512(false);
+		Measure(csx, std::string("AC"));
+		delete csx;
+
+		ChaChaP20* cha = new ChaChaP20(false);
+		Measure(cha, std::string("AH"));
+		delete cha;
+
+		RCS* rcs = new RCS(false);
+		Measure(rcs, std::string("AR"));
+		delete rcs;
+
+		RWS* rws = new RWS(false);
+		Measure(rws, std::string("AW"));
+		delete rws;
+
+		TSX512* tsx = new TSX512(false);
+		Measure(tsx, std::string("AT"));
+		delete tsx;
+	}
+
+	void AllocationTest::OnProgress(const std::string &Data)
+	{
+		m_progressEvent(Data);
+	}
+}
@@ -0,0 +1,205 @@
+#ifndef CEXTEST_ALLOCATIONTEST_H
+#define CEXTEST_ALLOCATIONTEST_H
+
+#include "ITest.h"
+#include "../CEX/SymmetricKey.h"
+#include <atomic>
+
+namespace Test
+{
+	/// <summary>
+	/// Steady-state allocation test; counts the heap allocations made by repeated sequential and parallel transforms of the counter mode and stream ciphers, and the BCG generator.
+	/// <para>The test replaces the global operator new and delete with a counting version; the counter is only active while a transform is measured.</para>
+	/// </summary>
+	class AllocationTest : public ITest
+	{
+	private:
+
+		static const std::string CLASSNAME;
+		static const std::string DESCRIPTION;
+		static const std::string SUCCESS;
+		static const size_t TEST_CYCLES = 4;
+
+		TestEventHandler m_progressEvent;
+
+	public:
+
+		/// <summary>
+		/// The number of allocations made while counting is enabled
+		/// </summary>
+		static std::atomic<size_t> AllocationCount;
+
+		/// <summary>
+		/// Enables the allocation counter
+		/// </summary>
+		static std::atomic<bool> IsCounting;
+
+		/// <summary>
+		/// Initialize this class
+		/// </summary>
+		AllocationTest();
+
+		/// <summary>
+		/// Destructor
+		/// </summary>
+		~AllocationTest();
+
+		/// <summary>
+		/// Get: The test description
+		/// </summary>
+		const std::string Description() override;
+
+		/// <summary>
+		/// Progress return event callback
+		/// </summary>
+		TestEventHandler &Progress() override;
+
+		/// <summary>
+		/// Start the tests
+		/// </summary>
+		std::string Run() override;
+
+		/// <summary>
+		/// Test the CTR and ICM block cipher modes allocate nothing after the first transform, with and without a precomputed key-stream
+		/// </summary>
+		void CipherMode();
+
+		/// <summary>
+		/// Test the BCG generator allocates nothing after the first request
+		/// </summary>
+		void Generator();
+
+		/// <summary>
+		/// Test the CSX512, ChaChaP20, RCS, RWS and TSX512 stream ciphers allocate nothing after the first transform
+		/// </summary>
+		void StreamCipher();
+
+	private:
+
+		template<typename T>
+		static void Measure(T* Cipher, const std::string &Code)
+		{
+			const size_t MSGLEN = (Cipher->ParallelProfile().ParallelBlockSize() * 2) + 17;
+			Cipher::SymmetricKeySize ks = Cipher->LegalKeySizes()[0];
+			std::vector<uint8_t> inp(MSGLEN);
+			std::vector<uint8_t> key(ks.KeySize());
+			std::vector<uint8_t> nonce(ks.IVSize());
+			std::vector<uint8_t> otp(MSGLEN);
+			size_t i;
+			size_t j;
+
+			TestUtils::GetRandom(inp);
+			TestUtils::GetRandom(key);
+			TestUtils::GetRandom(nonce);
+			Cipher::SymmetricKey kp(key, nonce);
+
+			for (i = 0; i < 2; ++i)
+			{
+				Cipher->Initialize(true, kp);
+				Cipher->ParallelProfile().IsParallel() = (i != 0);
+				// the first transform allocates the scratch buffers and starts the thread pool
+				Cipher->Transform(inp, 0, otp, 0, MSGLEN);
+
+				AllocationCount = 0;
+				IsCounting = true;
+
+				for (j = 0; j < TEST_CYCLES; ++j)
+				{
+					Cipher->Transform(inp, 0, otp, 0, MSGLEN);
+				}
+
+				IsCounting = false;
+
+				if (AllocationCount != 0)
+				{
+					throw TestException(std::string("Measure"), Cipher->Name(), std::string((i == 0) ? "The sequential" : "The parallel") +
+						std::string(" transform allocated memory! -") + Code + std::to_string(i + 1));
+				}
+			}
+		}
+
+		template<typename T>
+		static void MeasurePrecompute(T* Cipher, const std::string &Code)
+		{
+			// the message is near the cache size, so the ring is drained by each transform and refilled by the worker,
+			// and a transform that finds it empty generates the remainder on the calling thread
+			const size_t CACHE = 4096;
+			const size_t MSGLEN = CACHE - 3;
+			Cipher::SymmetricKeySize ks = Cipher->LegalKeySizes()[0];
+			std::vector<uint8_t> inp(MSGLEN);
+			std::vector<uint8_t> key(ks.KeySize());
+			std::vector<uint8_t> nonce(ks.IVSize());
+			std::vector<uint8_t> otp(MSGLEN);
+			size_t i;
+
+			TestUtils::GetRandom(inp);
+			TestUtils::GetRandom(key);
+			TestUtils::GetRandom(nonce);
+			Cipher::SymmetricKey kp(key, nonce);
+
+			Cipher->Precompute(CACHE);
+			Cipher->Initialize(true, kp);
+			Cipher->Transform(inp, 0, otp, 0, MSGLEN);
+
+			AllocationCount = 0;
+			IsCounting = true;
+
+			for (i = 0; i < TEST_CYCLES; ++i)
+			{
+				Cipher->Transform(inp, 0, otp, 0, MSGLEN);
+			}
+
+			IsCounting = false;
+			Cipher->Precompute(0);
+
+			if (AllocationCount != 0)
+			{
+				throw TestException(std::string("MeasurePrecompute"), Cipher->Name(), std::string("The precomputed transform allocated memory! -") + Code);
+			}
+		}
+
+		template<typename T>
+		static void MeasureGenerator(T* Generator, const std::string &Code)
+		{
+			const size_t MSGLEN = (Generator->ParallelProfile().ParallelBlockSize() * 2) + 17;
+			Cipher::SymmetricKeySize ks = Generator->LegalKeySizes()[0];
+			std::vector<uint8_t> key(ks.KeySize());
+			std::vector<uint8_t> nonce(ks.IVSize());
+			SecureVector<uint8_t> otp(MSGLEN);
+			size_t i;
+			size_t j;
+
+			TestUtils::GetRandom(key);
+			TestUtils::GetRandom(nonce);
+			Cipher::SymmetricKey kp(key, nonce);
+
+			for (i = 0; i < 2; ++i)
+			{
+				Generator->Initialize(kp);
+				Generator->ParallelProfile().IsParallel() = (i != 0);
+				// the first request allocates the scratch buffers and starts the thread pool
+				Generator->Generate(otp, 0, MSGLEN);
+
+				AllocationCount = 0;
+				IsCounting = true;
+
+				for (j = 0; j < TEST_CYCLES; ++j)
+				{
+					Generator->Generate(otp, 0, MSGLEN);
+				}
+
+				IsCounting = false;
+
+				if (AllocationCount != 0)
+				{
+					throw TestException(std::string("MeasureGenerator"), Generator->Name(), std::string((i == 0) ? "The sequential" : "The parallel") +
+						std::string(" request allocated memory! -") + Code + std::to_string(i + 1));
+				}
+			}
+		}
+
+		void OnProgress(const std::string &Data);
+	};
+}
+
+#endif
@@ -1,39 +1,30 @@
 #include "CSXTest.h"
 #include "../CEX/ChaCha.h"
+#include "../CEX/ChaChaKernels.h"
 #include "../CEX/CSX512.h"
 #include "../CEX/IntegerTools.h"
 #include "../CEX/MemoryTools.h"
 #include "../CEX/SecureRandom.h"
+#include "../CEX/SimdDispatch.h"
 #include "../CEX/SymmetricKey.h"
 
-#if defined(__AVX2__)
-#	include "../CEX/ULong256.h"
-#endif
-#if defined(__AVX512__)
-#	include "../CEX/ULong512.h"
-#endif
-
 namespace Test
 {
 	using Cipher::Stream::ChaCha;
+	using Cipher::Stream::ChaChaKernels;
 	using Cipher::Stream::CSX512;
 	using Exception::CryptoAuthenticationFailure;
 	using Exception::CryptoSymmetricException;
 	using Tools::IntegerTools;
 	using Tools::MemoryTools;
 	using Prng::SecureRandom;
+	using Enumeration::SimdKernels;
+	using Enumeration::SimdProfiles;
+	using Tools::SimdDispatch;
 	using Enumeration::StreamAuthenticators;
 	using Cipher::SymmetricKey;
 	using Cipher::SymmetricKeySize;
 
-#if defined(__AVX2__)
-	using Numeric::ULong256;
-#endif
-
-#if defined(__AVX512__)
-	using Numeric::ULong512;
-#endif
-
 	const std::string CSXTest::CLASSNAME = "CSXTest";
 	const std::string CSXTest::DESCRIPTION = "Tests the CSX stream cipher authenticated stream cipher.";
 	const std::string CSXTest::SUCCESS = "SUCCESS! All CSX tests have executed succesfully.";
@@ -89,6 +80,10 @@ namespace Test
 			CompareP1024();
 			OnProgress(std::string("CSXTest: Passed CSX-512 permutation variants equivalence test.."));
 
+			// compare the output of each simd kernel variant the host supports
+			Dispatch(csx512s);
+			OnProgress(std::string("CSXTest: Passed CSX-512 run-time kernel selection equivalence test.."));
+
 			Exception(csx512s);
 			OnProgress(std::string("CSXTest: Passed CSX-512 exception handling tests.."));
 
@@ -108,6 +103,9 @@ namespace Test
 			MonteCarlo(csx512s, m_message[0], m_key[1], m_nonce[0], m_monte[0]);
 			OnProgress(std::string("CSXTest: Passed CSX-512 monte carlo tests.."));
 
+			Seek(csx512s);
+			OnProgress(std::string("CSXTest: Passed CSX-512 random access transform and seek tests.."));
+
 			Parallel(csx512s);
 			OnProgress(std::string("CSXTest: Passed CSX-512 parallel to sequential equivalence test.."));
 
@@ -201,43 +199,102 @@ namespace Test
 
 		ChaCha::PermuteP1024C(output1, 0, counter, state, ROUNDS);
 
-#if defined(__AVX512__)
+		const SimdProfiles DETPRF = SimdDispatch::Instance().Detected();
 
-		std::array<uint64_t, 16> counter16{ 128, 128, 128, 128, 128, 128, 128, 128, 1, 1, 1, 1, 1, 1, 1, 1 };
-		std::vector<uint8_t> output4(1024);
+		// every kernel compiled into the library and supported by the host is compared with the scalar permutation
+		if (ChaChaKernels::HasAvx512() && DETPRF >= SimdProfiles::Simd512)
+		{
+			std::array<uint64_t, 16> counter16{ 128, 128, 128, 128, 128, 128, 128, 128, 1, 1, 1, 1, 1, 1, 1, 1 };
+			std::vector<uint8_t> output4(1024);
 
-		ChaCha::PermuteP8x1024H(output4, 0, counter16, state, ROUNDS);
+			ChaChaKernels::PermuteP8x1024H(output4.data(), counter16.data(), state.data(), ROUNDS);
 
-		for (size_t i = 0; i < 1024; i += 128)
+			for (size_t i = 0; i < 1024; i += 128)
+			{
+				for (size_t j = 0; j < 128; ++j)
+				{
+					if (output4[i + j] != output1[j])
+					{
+						throw TestException(std::string("CompareP512"), std::string("PermuteP16x512H"), std::string("Permutation output is not equal! -CP3"));
+					}
+				}
+			}
+		}
+
+		if (ChaChaKernels::HasAvx2() && DETPRF >= SimdProfiles::Simd256)
 		{
-			for (size_t j = 0; j < 128; ++j)
+			std::array<uint64_t, 8> counter8{ 128, 128, 128, 128, 1, 1, 1, 1 };
+			std::vector<uint8_t> output3(512);
+
+			ChaChaKernels::PermuteP4x1024H(output3.data(), counter8.data(), state.data(), ROUNDS);
+
+			for (size_t i = 0; i < 512; i += 128)
 			{
-				if (output4[i + j] != output1[j])
+				for (size_t j = 0; j < 128; ++j)
 				{
-					throw TestException(std::string("CompareP512"), std::string("PermuteP16x512H"), std::string("Permutation output is not equal! -CP3"));
+					if (output3[i + j] != output1[j])
+					{
+						throw TestException(std::string("CompareP512"), std::string("PermuteP8x512H"), std::string("Permutation output is not equal! -CP2"));
+					}
 				}
 			}
 		}
+	}
 
-#elif defined(__AVX2__)
+	void CSXTest::Dispatch(IStreamCipher* Cipher)
+	{
+		const size_t MSGLEN = (16 * 128 * 3) + 37;
+		Cipher::SymmetricKeySize ks = Cipher->LegalKeySizes()[0];
+		SimdDispatch &dsp = SimdDispatch::Instance();
+		std::vector<uint8_t> cpt1(MSGLEN);
+		std::vector<uint8_t> cpt2(MSGLEN);
+		std::vector<uint8_t> inp(MSGLEN);
+		std::vector<uint8_t> key(ks.KeySize());
+		std::vector<uint8_t> nonce(ks.IVSize());
+		Prng::SecureRandom rnd;
+		size_t i;
 
-		std::array<uint64_t, 8> counter8{ 128, 128, 128, 128, 1, 1, 1, 1 };
-		std::vector<uint8_t> output3(512);
+		rnd.Generate(key, 0, key.size());
+		rnd.Generate(nonce, 0, nonce.size());
+		rnd.Generate(inp, 0, MSGLEN);
+		SymmetricKey kp(key, nonce);
 
-		ChaCha::PermuteP4x1024H(output3, 0, counter8, state, ROUNDS);
+		// the portable permutation is the reference
+		dsp.SetProfile(SimdProfiles::None);
+		Cipher->Initialize(true, kp);
+		Cipher->ParallelProfile().IsParallel() = false;
+		Cipher->Transform(inp, 0, cpt1, 0, MSGLEN);
+
+		// the message is shorter than the default wide threshold
+		dsp.SetWideThreshold(SimdKernels::ChaCha512, 0);
 
-		for (size_t i = 0; i < 512; i += 128)
+		for (i = 1; i <= static_cast<size_t>(dsp.Detected()); ++i)
 		{
-			for (size_t j = 0; j < 128; ++j)
+			dsp.SetProfile(static_cast<SimdProfiles>(i));
+
+			if (dsp.Profile() != static_cast<SimdProfiles>(i))
 			{
-				if (output3[i + j] != output1[j])
-				{
-					throw TestException(std::string("CompareP512"), std::string("PermuteP8x512H"), std::string("Permutation output is not equal! -CP2"));
-				}
+				dsp.Reset();
+				throw TestException(std::string("Dispatch"), Cipher->Name(), std::string("The profile was not applied! -CD1"));
+			}
+
+			Cipher->Initialize(true, kp);
+			Cipher->ParallelProfile().IsParallel() = false;
+			Cipher->Transform(inp, 0, cpt2, 0, MSGLEN);
+
+			if (cpt1 != cpt2)
+			{
+				dsp.Reset();
+				throw TestException(std::string("Dispatch"), Cipher->Name(), std::string("Cipher output is not equal! -CD2"));
 			}
 		}
 
-#endif
+		dsp.Reset();
+
+		if (dsp.Profile() != dsp.Detected())
+		{
+			throw TestException(std::string("Dispatch"), Cipher->Name(), std::string("The profile was not restored! -CD3"));
+		}
 	}
 
 	void CSXTest::Exception(IStreamCipher* Cipher)
@@ -441,6 +498,83 @@ namespace Test
 		}
 	}
 
+	void CSXTest::Seek(IStreamCipher* Cipher)
+	{
+		const size_t MSGLEN = (Cipher->ParallelBlockSize() * 2) + 1000;
+		Cipher::SymmetricKeySize ks = Cipher->LegalKeySizes()[0];
+		std::vector<uint8_t> cpt(MSGLEN);
+		std::vector<uint8_t> inp(MSGLEN);
+		std::vector<uint8_t> key(ks.KeySize());
+		std::vector<uint8_t> nonce(ks.IVSize());
+		std::vector<uint8_t> otp(MSGLEN);
+		Prng::SecureRandom rnd;
+		size_t plen;
+		size_t pos;
+
+		for (size_t i = 0; i < TEST_CYCLES; ++i)
+		{
+			rnd.Generate(key, 0, key.size());
+			rnd.Generate(nonce, 0, nonce.size());
+			rnd.Generate(inp, 0, MSGLEN);
+			SymmetricKey kp(key, nonce);
+
+			// encrypt the whole stream
+			Cipher->Initialize(true, kp);
+			Cipher->ParallelProfile().IsParallel() = true;
+			Cipher->Transform(inp, 0, cpt, 0, MSGLEN);
+
+			// decrypt a random window at an unaligned position
+			pos = static_cast<size_t>(rnd.NextUInt32(static_cast<uint32_t>(MSGLEN - 1), 0));
+			plen = static_cast<size_t>(rnd.NextUInt32(static_cast<uint32_t>(MSGLEN - pos), 1));
+			MemoryTools::Clear(otp, 0, otp.size());
+			Cipher->Initialize(false, kp);
+			Cipher->TransformAt(pos, cpt, pos, otp, pos, plen);
+
+			if (IntegerTools::Compare(inp, pos, otp, pos, plen) == false)
+			{
+				throw TestException(std::string("Seek"), Cipher->Name(), std::string("Cipher output is not equal! -CK1"));
+			}
+
+			// decrypt the stream as two disjoint ranges, in reverse order
+			MemoryTools::Clear(otp, 0, otp.size());
+			Cipher->Initialize(false, kp);
+			Cipher->TransformAt(pos, cpt, pos, otp, pos, MSGLEN - pos);
+			Cipher->TransformAt(0, cpt, 0, otp, 0, pos);
+
+			if (otp != inp)
+			{
+				throw TestException(std::string("Seek"), Cipher->Name(), std::string("Cipher output is not equal! -CK2"));
+			}
+
+			// seek to a block aligned position and continue with a standard transform
+			pos -= (pos % 128);
+			MemoryTools::Clear(otp, 0, otp.size());
+			Cipher->Initialize(false, kp);
+			Cipher->Seek(pos);
+			Cipher->Transform(cpt, pos, otp, pos, MSGLEN - pos);
+
+			if (IntegerTools::Compare(inp, pos, otp, pos, MSGLEN - pos) == false)
+			{
+				throw TestException(std::string("Seek"), Cipher->Name(), std::string("Cipher output is not equal! -CK3"));
+			}
+
+			// an unaligned seek must be rejected
+			try
+			{
+				Cipher->Seek(pos + 1);
+
+				throw TestException(std::string("Seek"), Cipher->Name(), std::string("Exception handling failure! -CK4"));
+			}
+			catch (CryptoSymmetricException const &)
+			{
+			}
+			catch (TestException const &)
+			{
+				throw;
+			}
+		}
+	}
+
 	void CSXTest::Sequential(IStreamCipher* Cipher, const std::vector<uint8_t> &Message, std::vector<uint8_t> &Key, std::vector<uint8_t> &Nonce,
 		const std::vector<uint8_t> &Output1, const std::vector<uint8_t> &Output2, const std::vector<uint8_t> &Output3)
 	{
@@ -85,6 +85,13 @@ namespace Test
 		/// </summary>
 		void CompareP1024();
 
+		/// <summary>
+		/// Compare the cipher output using each run-time selectable SIMD kernel variant for equivalence
+		/// </summary>
+		/// 
+		/// <param name="Cipher">The cipher instance pointer</param>
+		void Dispatch(IStreamCipher* Cipher);
+
 		/// <summary>
 		/// Test exception handlers for correct execution
 		/// </summary>
@@ -121,6 +128,13 @@ namespace Test
 		/// <param name="Cipher">The cipher instance pointer</param>
 		void Parallel(IStreamCipher* Cipher);
 
+		/// <summary>
+		/// Tests random access decryption with TransformAt and Seek against a sequentially encrypted stream in a looping [TEST_CYCLES] test
+		/// </summary>
+		/// 
+		/// <param name="Cipher">The cipher instance pointer</param>
+		void Seek(IStreamCipher* Cipher);
+
 		/// <summary>
 		/// Test a single initialization and sequential successive calls to the transform
 		/// </summary>
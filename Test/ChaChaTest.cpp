@@ -1,22 +1,18 @@
 #include "ChaChaTest.h"
 #include "../CEX/ChaCha.h"
+#include "../CEX/ChaChaKernels.h"
 #include "../CEX/ChaChaP20.h"
 #include "../CEX/CSX512.h"
 #include "../CEX/IntegerTools.h"
 #include "../CEX/MemoryTools.h"
 #include "../CEX/SecureRandom.h"
+#include "../CEX/SimdDispatch.h"
 #include "../CEX/SymmetricKey.h"
 
-#if defined(__AVX2__)
-#	include "../CEX/ULong256.h"
-#endif
-#if defined(__AVX512__)
-#	include "../CEX/ULong512.h"
-#endif
-
 namespace Test
 {
 	using Cipher::Stream::ChaCha;
+	using Cipher::Stream::ChaChaKernels;
 	using Cipher::Stream::ChaChaP20;
 	using Cipher::Stream::CSX512;
 	using Exception::CryptoAuthenticationFailure;
@@ -24,18 +20,13 @@ namespace Test
 	using Tools::IntegerTools;
 	using Tools::MemoryTools;
 	using Prng::SecureRandom;
+	using Enumeration::SimdKernels;
+	using Enumeration::SimdProfiles;
+	using Tools::SimdDispatch;
 	using Enumeration::StreamAuthenticators;
 	using Cipher::SymmetricKey;
 	using Cipher::SymmetricKeySize;
 
-#if defined(__AVX2__)
-	using Numeric::ULong256;
-#endif
-
-#if defined(__AVX512__)
-	using Numeric::ULong512;
-#endif
-
 	const std::string ChaChaTest::CLASSNAME = "ChaChaTest";
 	const std::string ChaChaTest::DESCRIPTION = "Tests the 256 and 512 bit versions of the ChaCha stream cipher (ChaChaP20 and CSX512) authenticated stream ciphers.";
 	const std::string ChaChaTest::SUCCESS = "SUCCESS! All ChaCha tests have executed succesfully.";
@@ -93,6 +84,10 @@ namespace Test
 			CompareP256();
 			OnProgress(std::string("ChaChaTest: Passed ChaCha-256 permutation variants equivalence test.."));
 
+			// compare the output of each simd kernel variant the host supports
+			Dispatch(csx256s);
+			OnProgress(std::string("ChaChaTest: Passed ChaCha-256 run-time kernel selection equivalence test.."));
+
 			// test all exception handlers for correct operation
 			Exception(csx256s);
 			OnProgress(std::string("ChaChaTest: Passed ChaCha-256 exception handling tests.."));
@@ -120,10 +115,23 @@ namespace Test
 			MonteCarlo(csx256s, m_message[0], m_key[0], m_nonce[0], m_monte[0]);
 			OnProgress(std::string("ChaChaTest: Passed ChaCha-256 monte carlo tests.."));
 
+			// decrypt windows of an encrypted stream at random positions
+			Seek(csx256s);
+			OnProgress(std::string("ChaChaTest: Passed ChaCha-256 random access transform and seek tests.."));
+
+			// compare packet transforms through the background key-stream cache with the uncached output
+			Precompute(csx256s);
+			OnProgress(std::string("ChaChaTest: Passed ChaCha-256 background key-stream cache tests.."));
+
 			// compare parallel output with sequential for equality
 			Parallel(csx256s);
 			OnProgress(std::string("ChaChaTest: Passed ChaCha-256 parallel to sequential equivalence test.."));
 
+			// compare the pointer transforms with the vector transforms, with and without authentication
+			Pointer(csx256s);
+			Pointer(csx256a);
+			OnProgress(std::string("ChaChaTest: Passed ChaCha-256 pointer and in-place transform tests.."));
+
 			// looping test of successful decryption with random keys and input
 			Stress(csx256s);
 			OnProgress(std::string("ChaChaTest: Passed ChaCha-256 stress tests.."));
@@ -218,61 +226,65 @@ namespace Test
 			throw TestException(std::string("CompareP256"), std::string("PermuteP512"), std::string("Permutation output is not equal! -CP1"));
 		}
 
-#if defined(__AVX512__)
+		const SimdProfiles DETPRF = SimdDispatch::Instance().Detected();
 
-		std::array<uint32_t, 32> counter32{ 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1 };
-		std::vector<uint8_t> output5(1024);
+		// every kernel compiled into the library and supported by the host is compared with the scalar permutation
+		if (ChaChaKernels::HasAvx512() && DETPRF >= SimdProfiles::Simd512)
+		{
+			std::array<uint32_t, 32> counter32{ 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1 };
+			std::vector<uint8_t> output5(1024);
 
-		ChaCha::PermuteP16x512H(output5, 0, counter32, state, ROUNDS);
+			ChaChaKernels::PermuteP16x512H(output5.data(), counter32.data(), state.data(), ROUNDS);
 
-		for (size_t i = 0; i < 1024; i += 64)
-		{
-			for (size_t j = 0; j < 64; ++j)
+			for (size_t i = 0; i < 1024; i += 64)
 			{
-				if (output5[i + j] != output1[j])
+				for (size_t j = 0; j < 64; ++j)
 				{
-					throw TestException(std::string("CompareP256"), std::string("PermuteP16x512H"), std::string("Permutation output is not equal! -CP4"));
+					if (output5[i + j] != output1[j])
+					{
+						throw TestException(std::string("CompareP256"), std::string("PermuteP16x512H"), std::string("Permutation output is not equal! -CP4"));
+					}
 				}
 			}
 		}
 
-#elif defined(__AVX2__)
-
-		std::array<uint32_t, 16> counter16{ 128, 128, 128, 128, 128, 128, 128, 128, 1, 1, 1, 1, 1, 1, 1, 1 };
-		std::vector<uint8_t> output4(512);
+		if (ChaChaKernels::HasAvx2() && DETPRF >= SimdProfiles::Simd256)
+		{
+			std::array<uint32_t, 16> counter16{ 128, 128, 128, 128, 128, 128, 128, 128, 1, 1, 1, 1, 1, 1, 1, 1 };
+			std::vector<uint8_t> output4(512);
 
-		ChaCha::PermuteP8x512H(output4, 0, counter16, state, ROUNDS);
+			ChaChaKernels::PermuteP8x512H(output4.data(), counter16.data(), state.data(), ROUNDS);
 
-		for (size_t i = 0; i < 512; i += 64)
-		{
-			for (size_t j = 0; j < 64; ++j)
+			for (size_t i = 0; i < 512; i += 64)
 			{
-				if (output4[i + j] != output1[j])
+				for (size_t j = 0; j < 64; ++j)
 				{
-					throw TestException(std::string("CompareP256"), std::string("PermuteP8x512H"), std::string("Permutation output is not equal! -CP3"));
+					if (output4[i + j] != output1[j])
+					{
+						throw TestException(std::string("CompareP256"), std::string("PermuteP8x512H"), std::string("Permutation output is not equal! -CP3"));
+					}
 				}
 			}
 		}
 
-#elif defined(__AVX__)
-
-		std::array<uint32_t, 8> counter8{ 128, 128, 128, 128, 1, 1, 1, 1 };
-		std::vector<uint8_t> output3(256);
+		if (ChaChaKernels::HasAvx() && DETPRF >= SimdProfiles::Simd128)
+		{
+			std::array<uint32_t, 8> counter8{ 128, 128, 128, 128, 1, 1, 1, 1 };
+			std::vector<uint8_t> output3(256);
 
-		ChaCha::PermuteP4x512H(output3, 0, counter8, state, ROUNDS);
+			ChaChaKernels::PermuteP4x512H(output3.data(), counter8.data(), state.data(), ROUNDS);
 
-		for (size_t i = 0; i < 256; i += 64)
-		{
-			for (size_t j = 0; j < 64; ++j)
+			for (size_t i = 0; i < 256; i += 64)
 			{
-				if (output3[i + j] != output1[j])
+				for (size_t j = 0; j < 64; ++j)
 				{
-					throw TestException(std::string("CompareP256"), std::string("PermuteP4x512H"), std::string("Permutation output is not equal! -CP2"));
+					if (output3[i + j] != output1[j])
+					{
+						throw TestException(std::string("CompareP256"), std::string("PermuteP4x512H"), std::string("Permutation output is not equal! -CP2"));
+					}
 				}
 			}
 		}
-
-#endif
 	}
 
 	void ChaChaTest::CompareP1024()
@@ -290,43 +302,102 @@ namespace Test
 
 		ChaCha::PermuteP1024C(output1, 0, counter, state, ROUNDS);
 
-#if defined(__AVX512__)
+		const SimdProfiles DETPRF = SimdDispatch::Instance().Detected();
 
-		std::array<uint64_t, 16> counter16{ 128, 128, 128, 128, 128, 128, 128, 128, 1, 1, 1, 1, 1, 1, 1, 1 };
-		std::vector<uint8_t> output4(1024);
+		// every kernel compiled into the library and supported by the host is compared with the scalar permutation
+		if (ChaChaKernels::HasAvx512() && DETPRF >= SimdProfiles::Simd512)
+		{
+			std::array<uint64_t, 16> counter16{ 128, 128, 128, 128, 128, 128, 128, 128, 1, 1, 1, 1, 1, 1, 1, 1 };
+			std::vector<uint8_t> output4(1024);
 
-		ChaCha::PermuteP8x1024H(output4, 0, counter16, state, ROUNDS);
+			ChaChaKernels::PermuteP8x1024H(output4.data(), counter16.data(), state.data(), ROUNDS);
 
-		for (size_t i = 0; i < 1024; i += 128)
+			for (size_t i = 0; i < 1024; i += 128)
+			{
+				for (size_t j = 0; j < 128; ++j)
+				{
+					if (output4[i + j] != output1[j])
+					{
+						throw TestException(std::string("CompareP512"), std::string("PermuteP16x512H"), std::string("Permutation output is not equal! -CP3"));
+					}
+				}
+			}
+		}
+
+		if (ChaChaKernels::HasAvx2() && DETPRF >= SimdProfiles::Simd256)
 		{
-			for (size_t j = 0; j < 128; ++j)
+			std::array<uint64_t, 8> counter8{ 128, 128, 128, 128, 1, 1, 1, 1 };
+			std::vector<uint8_t> output3(512);
+
+			ChaChaKernels::PermuteP4x1024H(output3.data(), counter8.data(), state.data(), ROUNDS);
+
+			for (size_t i = 0; i < 512; i += 128)
 			{
-				if (output4[i + j] != output1[j])
+				for (size_t j = 0; j < 128; ++j)
 				{
-					throw TestException(std::string("CompareP512"), std::string("PermuteP16x512H"), std::string("Permutation output is not equal! -CP3"));
+					if (output3[i + j] != output1[j])
+					{
+						throw TestException(std::string("CompareP512"), std::string("PermuteP8x512H"), std::string("Permutation output is not equal! -CP2"));
+					}
 				}
 			}
 		}
+	}
+
+	void ChaChaTest::Dispatch(IStreamCipher* Cipher)
+	{
+		const size_t MSGLEN = (16 * 128 * 3) + 37;
+		Cipher::SymmetricKeySize ks = Cipher->LegalKeySizes()[0];
+		SimdDispatch &dsp = SimdDispatch::Instance();
+		std::vector<uint8_t> cpt1(MSGLEN);
+		std::vector<uint8_t> cpt2(MSGLEN);
+		std::vector<uint8_t> inp(MSGLEN);
+		std::vector<uint8_t> key(ks.KeySize());
+		std::vector<uint8_t> nonce(ks.IVSize());
+		Prng::SecureRandom rnd;
+		size_t i;
 
-#elif defined(__AVX2__)
+		rnd.Generate(key, 0, key.size());
+		rnd.Generate(nonce, 0, nonce.size());
+		rnd.Generate(inp, 0, MSGLEN);
+		SymmetricKey kp(key, nonce);
 
-		std::array<uint64_t, 8> counter8{ 128, 128, 128, 128, 1, 1, 1, 1 };
-		std::vector<uint8_t> output3(512);
+		// the portable permutation is the reference
+		dsp.SetProfile(SimdProfiles::None);
+		Cipher->Initialize(true, kp);
+		Cipher->ParallelProfile().IsParallel() = false;
+		Cipher->Transform(inp, 0, cpt1, 0, MSGLEN);
 
-		ChaCha::PermuteP4x1024H(output3, 0, counter8, state, ROUNDS);
+		// the message is shorter than the default wide threshold
+		dsp.SetWideThreshold(SimdKernels::ChaCha256, 0);
 
-		for (size_t i = 0; i < 512; i += 128)
+		for (i = 1; i <= static_cast<size_t>(dsp.Detected()); ++i)
 		{
-			for (size_t j = 0; j < 128; ++j)
+			dsp.SetProfile(static_cast<SimdProfiles>(i));
+
+			if (dsp.Profile() != static_cast<SimdProfiles>(i))
 			{
-				if (output3[i + j] != output1[j])
-				{
-					throw TestException(std::string("CompareP512"), std::string("PermuteP8x512H"), std::string("Permutation output is not equal! -CP2"));
-				}
+				dsp.Reset();
+				throw TestException(std::string("Dispatch"), Cipher->Name(), std::string("The profile was not applied! -CD1"));
+			}
+
+			Cipher->Initialize(true, kp);
+			Cipher->ParallelProfile().IsParallel() = false;
+			Cipher->Transform(inp, 0, cpt2, 0, MSGLEN);
+
+			if (cpt1 != cpt2)
+			{
+				dsp.Reset();
+				throw TestException(std::string("Dispatch"), Cipher->Name(), std::string("Cipher output is not equal! -CD2"));
 			}
 		}
 
-#endif
+		dsp.Reset();
+
+		if (dsp.Profile() != dsp.Detected())
+		{
+			throw TestException(std::string("Dispatch"), Cipher->Name(), std::string("The profile was not restored! -CD3"));
+		}
 	}
 
 	void ChaChaTest::Exception(IStreamCipher* Cipher)
@@ -519,6 +590,294 @@ namespace Test
 		}
 	}
 
+	void ChaChaTest::Pointer(IStreamCipher* Cipher)
+	{
+		const uint32_t MINSMP = static_cast<uint32_t>(Cipher->ParallelBlockSize());
+		const uint32_t MAXSMP = static_cast<uint32_t>(Cipher->ParallelBlockSize()) * 4;
+		const size_t TAGLEN = Cipher->IsAuthenticator() ? Cipher->TagSize() : 0;
+		Cipher::SymmetricKeySize ks = Cipher->LegalKeySizes()[0];
+		std::vector<uint8_t> ad(32);
+		std::vector<uint8_t> cpt1;
+		std::vector<uint8_t> cpt2;
+		std::vector<uint8_t> inp;
+		std::vector<uint8_t> key(ks.KeySize());
+		std::vector<uint8_t> nonce(ks.IVSize());
+		Prng::SecureRandom rnd;
+
+		Cipher->ParallelProfile().IsParallel() = true;
+
+		for (size_t i = 0; i < TEST_CYCLES; ++i)
+		{
+			// a random length spanning several segments, not block aligned
+			const size_t MSGLEN = static_cast<size_t>(rnd.NextUInt32(MAXSMP, MINSMP));
+			cpt1.resize(MSGLEN + TAGLEN);
+			cpt2.resize(MSGLEN + TAGLEN);
+			inp.resize(MSGLEN);
+
+			rnd.Generate(ad, 0, ad.size());
+			rnd.Generate(key, 0, key.size());
+			rnd.Generate(nonce, 0, nonce.size());
+			rnd.Generate(inp, 0, MSGLEN);
+			SymmetricKey kp(key, nonce);
+
+			// the vector transform
+			Cipher->Initialize(true, kp);
+
+			if (Cipher->IsAuthenticator())
+			{
+				Cipher->SetAssociatedData(ad, 0, ad.size());
+			}
+
+			Cipher->Transform(inp, 0, cpt1, 0, MSGLEN);
+
+			// the pointer transform in place, the tag is written after the cipher-text
+			MemoryTools::Clear(cpt2, 0, cpt2.size());
+			MemoryTools::Copy(inp, 0, cpt2, 0, MSGLEN);
+			Cipher->Initialize(true, kp);
+
+			if (Cipher->IsAuthenticator())
+			{
+				Cipher->SetAssociatedData(ad.data(), ad.size());
+			}
+
+			Cipher->Transform(cpt2.data(), cpt2.data(), MSGLEN);
+
+			if (cpt1 != cpt2)
+			{
+				throw TestException(std::string("Pointer"), Cipher->Name(), std::string("Cipher output is not equal! -CR1"));
+			}
+
+			// decrypt in place
+			Cipher->Initialize(false, kp);
+
+			if (Cipher->IsAuthenticator())
+			{
+				Cipher->SetAssociatedData(ad.data(), ad.size());
+			}
+
+			try
+			{
+				Cipher->Transform(cpt2.data(), cpt2.data(), MSGLEN);
+			}
+			catch (CryptoAuthenticationFailure const&)
+			{
+				throw TestException(std::string("Pointer"), Cipher->Name(), std::string("Authentication failure! -CR2"));
+			}
+
+			if (IntegerTools::Compare(inp, 0, cpt2, 0, MSGLEN) == false)
+			{
+				throw TestException(std::string("Pointer"), Cipher->Name(), std::string("Cipher output is not equal! -CR3"));
+			}
+		}
+	}
+
+	void ChaChaTest::Precompute(ChaChaP20* Cipher)
+	{
+		const size_t BLKLEN = 64;
+		const size_t CACHE = 4096;
+		const size_t PKTCNT = 24;
+		SymmetricKeySize ks = Cipher->LegalKeySizes()[0];
+		std::vector<uint8_t> cpt1;
+		std::vector<uint8_t> cpt2;
+		std::vector<uint8_t> inp;
+		std::vector<uint8_t> otp;
+		std::vector<uint8_t> key(ks.KeySize());
+		std::vector<uint8_t> nonce(ks.IVSize());
+		std::vector<size_t> kpos(PKTCNT);
+		std::vector<size_t> plen(PKTCNT);
+		std::vector<size_t> ppos(PKTCNT);
+		std::vector<uint8_t> ctr1;
+		std::vector<uint8_t> ctr2;
+		SecureRandom rnd;
+		size_t i;
+		size_t j;
+		size_t msglen;
+		size_t spos;
+
+		for (i = 0; i < TEST_CYCLES; ++i)
+		{
+			// packet sized messages, and one longer than the cache
+			msglen = 0;
+			spos = 0;
+
+			for (j = 0; j < PKTCNT; ++j)
+			{
+				plen[j] = (j == PKTCNT / 3) ? (CACHE * 3) + 7 : static_cast<size_t>(rnd.NextUInt32(1500, 1));
+				ppos[j] = msglen;
+				kpos[j] = spos;
+				// each call starts the key-stream on a block boundary
+				spos += plen[j] + ((BLKLEN - (plen[j] % BLKLEN)) % BLKLEN);
+				msglen += plen[j];
+			}
+
+			cpt1.resize(msglen);
+			cpt2.resize(msglen);
+			inp.resize(msglen);
+			otp.resize(msglen);
+			rnd.Generate(key, 0, key.size());
+			rnd.Generate(nonce, 0, nonce.size());
+			rnd.Generate(inp, 0, msglen);
+			SymmetricKey kp(key, nonce);
+
+			// the reference stream
+			Cipher->Precompute(0);
+			Cipher->Initialize(true, kp);
+
+			for (j = 0; j < PKTCNT; ++j)
+			{
+				Cipher->Transform(inp, ppos[j], cpt1, ppos[j], plen[j]);
+			}
+
+			ctr1 = Cipher->Nonce();
+
+			// the same packets through the cache, disabled and enabled again part way through the stream
+			Cipher->Precompute(CACHE);
+			Cipher->Initialize(true, kp);
+
+			for (j = 0; j < PKTCNT; ++j)
+			{
+				if (j == PKTCNT / 2)
+				{
+					Cipher->Precompute(0);
+				}
+				else if (j == (PKTCNT / 4) * 3)
+				{
+					Cipher->Precompute(CACHE);
+				}
+
+				Cipher->Transform(inp, ppos[j], cpt2, ppos[j], plen[j]);
+			}
+
+			if (cpt1 != cpt2)
+			{
+				throw TestException(std::string("Precompute"), Cipher->Name(), std::string("Cipher output is not equal! -CP1"));
+			}
+
+			// the counter is synchronized with the cache position
+			ctr2 = Cipher->Nonce();
+
+			if (ctr1 != ctr2)
+			{
+				throw TestException(std::string("Precompute"), Cipher->Name(), std::string("Cipher counter is not equal! -CP2"));
+			}
+
+			// rekeying discards the cached key-stream of the previous key
+			rnd.Generate(key, 0, key.size());
+			SymmetricKey kp2(key, nonce);
+			Cipher->Initialize(true, kp2);
+			Cipher->Transform(inp, ppos[0], otp, ppos[0], plen[0]);
+
+			// decrypt the packets in reverse order, seeking to the key-stream position of each
+			MemoryTools::Clear(otp, 0, otp.size());
+			Cipher->Initialize(false, kp);
+
+			for (j = PKTCNT; j != 0; --j)
+			{
+				Cipher->Seek(kpos[j - 1]);
+				Cipher->Transform(cpt1, ppos[j - 1], otp, ppos[j - 1], plen[j - 1]);
+			}
+
+			if (otp != inp)
+			{
+				throw TestException(std::string("Precompute"), Cipher->Name(), std::string("Cipher output is not equal! -CP3"));
+			}
+
+			// the capacity must be a multiple of four blocks
+			try
+			{
+				Cipher->Precompute(BLKLEN);
+
+				throw TestException(std::string("Precompute"), Cipher->Name(), std::string("Exception handling failure! -CP4"));
+			}
+			catch (CryptoSymmetricException const &)
+			{
+			}
+			catch (TestException const &)
+			{
+				throw;
+			}
+		}
+
+		Cipher->Precompute(0);
+	}
+
+	void ChaChaTest::Seek(IStreamCipher* Cipher)
+	{
+		const size_t MSGLEN = (Cipher->ParallelBlockSize() * 2) + 1000;
+		Cipher::SymmetricKeySize ks = Cipher->LegalKeySizes()[0];
+		std::vector<uint8_t> cpt(MSGLEN);
+		std::vector<uint8_t> inp(MSGLEN);
+		std::vector<uint8_t> key(ks.KeySize());
+		std::vector<uint8_t> nonce(ks.IVSize());
+		std::vector<uint8_t> otp(MSGLEN);
+		Prng::SecureRandom rnd;
+		size_t plen;
+		size_t pos;
+
+		for (size_t i = 0; i < TEST_CYCLES; ++i)
+		{
+			rnd.Generate(key, 0, key.size());
+			rnd.Generate(nonce, 0, nonce.size());
+			rnd.Generate(inp, 0, MSGLEN);
+			SymmetricKey kp(key, nonce);
+
+			// encrypt the whole stream
+			Cipher->Initialize(true, kp);
+			Cipher->ParallelProfile().IsParallel() = true;
+			Cipher->Transform(inp, 0, cpt, 0, MSGLEN);
+
+			// decrypt a random window at an unaligned position
+			pos = static_cast<size_t>(rnd.NextUInt32(static_cast<uint32_t>(MSGLEN - 1), 0));
+			plen = static_cast<size_t>(rnd.NextUInt32(static_cast<uint32_t>(MSGLEN - pos), 1));
+			MemoryTools::Clear(otp, 0, otp.size());
+			Cipher->Initialize(false, kp);
+			Cipher->TransformAt(pos, cpt, pos, otp, pos, plen);
+
+			if (IntegerTools::Compare(inp, pos, otp, pos, plen) == false)
+			{
+				throw TestException(std::string("Seek"), Cipher->Name(), std::string("Cipher output is not equal! -CK1"));
+			}
+
+			// decrypt the stream as two disjoint ranges, in reverse order
+			MemoryTools::Clear(otp, 0, otp.size());
+			Cipher->Initialize(false, kp);
+			Cipher->TransformAt(pos, cpt, pos, otp, pos, MSGLEN - pos);
+			Cipher->TransformAt(0, cpt, 0, otp, 0, pos);
+
+			if (otp != inp)
+			{
+				throw TestException(std::string("Seek"), Cipher->Name(), std::string("Cipher output is not equal! -CK2"));
+			}
+
+			// seek to a block aligned position and continue with a standard transform
+			pos -= (pos % 128);
+			MemoryTools::Clear(otp, 0, otp.size());
+			Cipher->Initialize(false, kp);
+			Cipher->Seek(pos);
+			Cipher->Transform(cpt, pos, otp, pos, MSGLEN - pos);
+
+			if (IntegerTools::Compare(inp, pos, otp, pos, MSGLEN - pos) == false)
+			{
+				throw TestException(std::string("Seek"), Cipher->Name(), std::string("Cipher output is not equal! -CK3"));
+			}
+
+			// an unaligned seek must be rejected
+			try
+			{
+				Cipher->Seek(pos + 1);
+
+				throw TestException(std::string("Seek"), Cipher->Name(), std::string("Exception handling failure! -CK4"));
+			}
+			catch (CryptoSymmetricException const &)
+			{
+			}
+			catch (TestException const &)
+			{
+				throw;
+			}
+		}
+	}
+
 	void ChaChaTest::Sequential(IStreamCipher* Cipher, const std::vector<uint8_t> &Message, std::vector<uint8_t> &Key, std::vector<uint8_t> &Nonce,
 		const std::vector<uint8_t> &Output1, const std::vector<uint8_t> &Output2, const std::vector<uint8_t> &Output3)
 	{
@@ -2,10 +2,12 @@
 #define CEXTEST_CHACHATEST_H
 
 #include "ITest.h"
+#include "../CEX/ChaChaP20.h"
 #include "../CEX/IStreamCipher.h"
 
 namespace Test
 {
+	using Cipher::Stream::ChaChaP20;
 	using Cipher::Stream::IStreamCipher;
 
 	/// <summary>
@@ -90,6 +92,13 @@ namespace Test
 		/// </summary>
 		void CompareP1024();
 
+		/// <summary>
+		/// Compare the cipher output using each run-time selectable SIMD kernel variant for equivalence
+		/// </summary>
+		/// 
+		/// <param name="Cipher">The cipher instance pointer</param>
+		void Dispatch(IStreamCipher* Cipher);
+
 		/// <summary>
 		/// Test exception handlers for correct execution
 		/// </summary>
@@ -126,6 +135,27 @@ namespace Test
 		/// <param name="Cipher">The cipher instance pointer</param>
 		void Parallel(IStreamCipher* Cipher);
 
+		/// <summary>
+		/// Compares the pointer forms of SetAssociatedData and Transform, out of place and in place, with the vector forms in a looping [TEST_CYCLES] test
+		/// </summary>
+		/// 
+		/// <param name="Cipher">The cipher instance pointer</param>
+		void Pointer(IStreamCipher* Cipher);
+
+		/// <summary>
+		/// Compares packet sized transforms through the background key-stream cache with the uncached output, across rekeying, seeks, and enabling or disabling the cache mid-stream, in a looping [TEST_CYCLES] test
+		/// </summary>
+		/// 
+		/// <param name="Cipher">The cipher instance pointer</param>
+		void Precompute(ChaChaP20* Cipher);
+
+		/// <summary>
+		/// Tests random access decryption with TransformAt and Seek against a sequentially encrypted stream in a looping [TEST_CYCLES] test
+		/// </summary>
+		/// 
+		/// <param name="Cipher">The cipher instance pointer</param>
+		void Seek(IStreamCipher* Cipher);
+
 		/// <summary>
 		/// Test a single initialization and sequential successive calls to the transform
 		/// </summary>
@@ -6,6 +6,7 @@
 #include "../CEX/ICM.h"
 #include "../CEX/IntegerTools.h"
 #include "../CEX/OFB.h"
+#include "../CEX/XTS.h"
 #include "../CEX/SecureRandom.h"
 
 namespace Test
@@ -155,6 +156,12 @@ namespace Test
 			Stress(ofbm);
 			OnProgress(std::string("Passed OFB stress tests.."));
 
+			Streams();
+			OnProgress(std::string("Passed CBC multi-stream encryption tests.."));
+
+			Xts();
+			OnProgress(std::string("Passed XTS known answer, ciphertext stealing, and sector batch tests.."));
+
 			delete cbcm;
 			delete cfbm;
 			delete ctrm;
@@ -1273,4 +1280,176 @@ namespace Test
 			}
 		}
 	}
+
+	void CipherModeTest::Streams()
+	{
+		const size_t STMCNT = 21;
+		std::vector<std::vector<uint8_t>> cpt1(STMCNT);
+		std::vector<std::vector<uint8_t>> cpt2(STMCNT);
+		std::vector<std::vector<uint8_t>> inp(STMCNT);
+		std::vector<CBC*> ref(STMCNT);
+		std::vector<CBC*> stm(STMCNT);
+		SecureRandom rnd;
+		size_t i;
+		size_t j;
+		size_t klen;
+
+		for (j = 0; j < 3; ++j)
+		{
+			for (i = 0; i < STMCNT; ++i)
+			{
+				// all 256-bit AES keys, mixed 128 and 256-bit keys, and the Serpent fallback
+				klen = (j == 1 && i % 3 == 0) ? 16 : 32;
+				stm[i] = new CBC(j == 2 ? BlockCiphers::Serpent : BlockCiphers::AES);
+				ref[i] = new CBC(j == 2 ? BlockCiphers::Serpent : BlockCiphers::AES);
+				SymmetricKey kp(rnd.Generate(klen), rnd.Generate(16));
+				stm[i]->Initialize(true, kp);
+				ref[i]->Initialize(true, kp);
+
+				// includes empty messages, and lengths that retire the lanes at different steps
+				inp[i].resize((i == 4) ? 0 : rnd.NextUInt32(128, 1) * 16);
+				rnd.Generate(inp[i]);
+				cpt1[i].resize(inp[i].size());
+				cpt2[i].resize(inp[i].size());
+				ref[i]->Transform(inp[i], 0, cpt1[i], 0, inp[i].size());
+			}
+
+			CBC::EncryptStreams(stm, inp, cpt2);
+
+			for (i = 0; i < STMCNT; ++i)
+			{
+				if (cpt1[i] != cpt2[i])
+				{
+					throw TestException(std::string("Streams"), stm[i]->Name(), std::string("The stream output is not equal! -TM1"));
+				}
+
+				if (stm[i]->IV() != ref[i]->IV())
+				{
+					throw TestException(std::string("Streams"), stm[i]->Name(), std::string("The stream chaining state is not equal! -TM2"));
+				}
+
+				delete stm[i];
+				delete ref[i];
+			}
+		}
+	}
+
+	void CipherModeTest::Xts()
+	{
+		// IEEE 1619-2007 vectors 1, 2, 15 and 17: key1 || key2, the data unit number, the plain-text, and the cipher-text
+		const std::vector<std::string> vectors =
+		{
+			std::string("0000000000000000000000000000000000000000000000000000000000000000"),
+			std::string("00000000000000000000000000000000"),
+			std::string("0000000000000000000000000000000000000000000000000000000000000000"),
+			std::string("917CF69EBD68B2EC9B9FE9A3EADDA692CD43D2F59598ED858C02C2652FBF922E"),
+			std::string("1111111111111111111111111111111122222222222222222222222222222222"),
+			std::string("33333333330000000000000000000000"),
+			std::string("4444444444444444444444444444444444444444444444444444444444444444"),
+			std::string("C454185E6A16936E39334038ACEF838BFB186FFF7480ADC4289382ECD6D394F0"),
+			std::string("FFFEFDFCFBFAF9F8F7F6F5F4F3F2F1F0BFBEBDBCBBBAB9B8B7B6B5B4B3B2B1B0"),
+			std::string("9A785634120000000000000000000000"),
+			std::string("000102030405060708090A0B0C0D0E0F10"),
+			std::string("6C1625DB4671522D3D7599601DE7CA09ED"),
+			std::string("FFFEFDFCFBFAF9F8F7F6F5F4F3F2F1F0BFBEBDBCBBBAB9B8B7B6B5B4B3B2B1B0"),
+			std::string("9A785634120000000000000000000000"),
+			std::string("000102030405060708090A0B0C0D0E0F101112"),
+			std::string("E5DF1351C0544BA1350B3363CD8EF4BEEDBF9D")
+		};
+
+		const std::vector<size_t> SECLEN = { 16, 512, 520, 4096, 4111 };
+		std::vector<uint8_t> dec;
+		std::vector<uint8_t> enc1;
+		std::vector<uint8_t> enc2;
+		std::vector<uint8_t> enc3;
+		std::vector<uint8_t> exp;
+		std::vector<uint8_t> key;
+		std::vector<uint8_t> msg;
+		std::vector<uint8_t> nonce;
+		SecureRandom rnd;
+		XTS cpr(BlockCiphers::AES);
+		size_t i;
+		size_t j;
+		size_t scnt;
+		size_t slen;
+		uint64_t sec;
+
+		for (i = 0; i < vectors.size(); i += 4)
+		{
+			HexConverter::Decode(vectors[i], key);
+			HexConverter::Decode(vectors[i + 1], nonce);
+			HexConverter::Decode(vectors[i + 2], msg);
+			HexConverter::Decode(vectors[i + 3], exp);
+			enc1.resize(msg.size());
+			dec.resize(msg.size());
+
+			SymmetricKey kp(key, nonce);
+			cpr.Initialize(true, kp);
+			cpr.Transform(msg, 0, enc1, 0, msg.size());
+
+			if (enc1 != exp)
+			{
+				throw TestException(std::string("Xts"), cpr.Name(), std::string("The encrypted output does not match the known answer! -MX1"));
+			}
+
+			cpr.Initialize(false, kp);
+			cpr.Transform(enc1, 0, dec, 0, enc1.size());
+
+			if (dec != msg)
+			{
+				throw TestException(std::string("Xts"), cpr.Name(), std::string("The decrypted output does not match the known answer! -MX2"));
+			}
+		}
+
+		// sector batches compared with sequential data units, with aligned and stolen sector sizes
+		for (i = 0; i < SECLEN.size(); ++i)
+		{
+			for (j = 0; j < 2; ++j)
+			{
+				XTS bch(j == 0 ? BlockCiphers::AES : BlockCiphers::Serpent);
+				slen = SECLEN[i];
+				scnt = rnd.NextUInt32(64, 1);
+				sec = rnd.NextUInt32();
+				key = rnd.Generate(j == 0 ? 64 : 32);
+				msg.resize(slen * scnt);
+				rnd.Generate(msg);
+				enc1.resize(msg.size());
+				enc2.resize(msg.size());
+				enc3.resize(msg.size());
+				dec.resize(msg.size());
+				nonce.resize(16);
+				std::fill(nonce.begin(), nonce.end(), 0x00);
+				IntegerTools::Le64ToBytes(sec, nonce, 0);
+
+				SymmetricKey kp(key, nonce);
+				bch.Initialize(true, kp);
+
+				for (size_t k = 0; k < scnt; ++k)
+				{
+					bch.Transform(msg, k * slen, enc1, k * slen, slen);
+				}
+
+				bch.ParallelProfile().IsParallel() = false;
+				bch.TransformSectors(msg, 0, enc2, 0, slen, scnt, sec);
+				bch.ParallelProfile().IsParallel() = true;
+				bch.ParallelProfile().SetBlockSize(bch.ParallelProfile().ParallelMinimumSize());
+				bch.TransformSectors(msg, 0, enc3, 0, slen, scnt, sec);
+
+				if (enc1 != enc2 || enc1 != enc3)
+				{
+					throw TestException(std::string("Xts"), bch.Name(), std::string("The sector batch output is not equal! -MX3"));
+				}
+
+				// in-place decryption of the batch
+				bch.Initialize(false, kp);
+				dec = enc3;
+				bch.TransformSectors(dec, 0, dec, 0, slen, scnt, sec);
+
+				if (dec != msg)
+				{
+					throw TestException(std::string("Xts"), bch.Name(), std::string("The sector batch decryption is not equal! -MX4"));
+				}
+			}
+		}
+	}
 }
@@ -92,6 +92,16 @@ namespace Test
 		/// <param name="Cipher">The cipher mode instance pointer</param>
 		void Stress(ICipherMode* Cipher);
 
+		/// <summary>
+		/// Compare the CBC multi-stream encryption with a sequential transform of each stream
+		/// </summary>
+		void Streams();
+
+		/// <summary>
+		/// Test XTS with the IEEE 1619 vectors, and compare sector batches with sequential data units
+		/// </summary>
+		void Xts();
+
     private:
 
 		void Initialize();
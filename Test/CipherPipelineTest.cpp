@@ -0,0 +1,302 @@
+#include "CipherPipelineTest.h"
+#include "../CEX/CBC.h"
+#include "../CEX/CipherPipeline.h"
+#include "../CEX/CTR.h"
+#include "../CEX/HMAC.h"
+#include "../CEX/MemoryStream.h"
+#include "../CEX/RCS.h"
+#include "../CEX/SecureRandom.h"
+#include "../CEX/SHA2256.h"
+#include "../CEX/SymmetricKey.h"
+
+namespace Test
+{
+	using Cipher::Block::Mode::CBC;
+	using Cipher::Block::Mode::CTR;
+	using Processing::CipherPipeline;
+	using Exception::CryptoProcessingException;
+	using Mac::HMAC;
+	using IO::MemoryStream;
+	using Processing::PipelineStatistics;
+	using Enumeration::PipelineStages;
+	using Cipher::Stream::RCS;
+	using Prng::SecureRandom;
+	using Digest::SHA2256;
+	using Cipher::SymmetricKey;
+
+	const std::string CipherPipelineTest::CLASSNAME = "CipherPipelineTest";
+	const std::string CipherPipelineTest::DESCRIPTION = "CipherPipeline output test; compares a threaded AES-CTR and HMAC-SHA2-256 pipeline with the cipher and MAC instances.";
+	const std::string CipherPipelineTest::SUCCESS = "SUCCESS! All CipherPipeline tests have executed succesfully.";
+
+	CipherPipelineTest::CipherPipelineTest()
+		:
+		m_progressEvent()
+	{
+	}
+
+	CipherPipelineTest::~CipherPipelineTest()
+	{
+	}
+
+	const std::string CipherPipelineTest::Description()
+	{
+		return DESCRIPTION;
+	}
+
+	TestEventHandler &CipherPipelineTest::Progress()
+	{
+		return m_progressEvent;
+	}
+
+	std::string CipherPipelineTest::Run()
+	{
+		try
+		{
+			Equivalence();
+			OnProgress(std::string("CipherPipelineTest: Passed encrypt-then-MAC and decryption pipeline comparison tests.."));
+			Statistics();
+			OnProgress(std::string("CipherPipelineTest: Passed stage counter and digest pipeline tests.."));
+			Exception();
+			OnProgress(std::string("CipherPipelineTest: Passed configuration and exception propagation tests.."));
+
+			return SUCCESS;
+		}
+		catch (TestException const &ex)
+		{
+			throw TestException(CLASSNAME, ex.Function(), ex.Origin(), ex.Message());
+		}
+		catch (CryptoException &ex)
+		{
+			throw TestException(CLASSNAME, ex.Location(), ex.Origin(), ex.Message());
+		}
+		catch (std::exception const &ex)
+		{
+			throw TestException(CLASSNAME, std::string("Unknown Origin"), std::string(ex.what()));
+		}
+	}
+
+	void CipherPipelineTest::Equivalence()
+	{
+		SecureRandom rnd;
+		CTR cpr(Enumeration::BlockCiphers::AES);
+		HMAC mac(Enumeration::SHA2Digests::SHA2256);
+		CipherPipeline ppl(4096, 3);
+		std::vector<uint8_t> code1(mac.TagSize());
+		std::vector<uint8_t> code2(0);
+		std::vector<uint8_t> dec(0);
+		std::vector<uint8_t> enc(0);
+		std::vector<uint8_t> msg(0);
+		SymmetricKey kp(rnd.Generate(32), rnd.Generate(16));
+		SymmetricKey mkp(rnd.Generate(32));
+		size_t i;
+
+		for (i = 0; i < TEST_CYCLES; ++i)
+		{
+			// includes an empty stream, and lengths that are not a multiple of the chunk or block size
+			msg.resize((i == 0) ? 0 : rnd.NextUInt32(100000, 1));
+			rnd.Generate(msg);
+			enc.resize(msg.size());
+			dec.resize(msg.size());
+
+			cpr.Initialize(true, kp);
+			cpr.Transform(msg, 0, enc, 0, msg.size());
+			mac.Initialize(mkp);
+			mac.Update(enc, 0, enc.size());
+			mac.Finalize(code1, 0);
+
+			// encrypt-then-mac
+			MemoryStream src(msg);
+			MemoryStream snk;
+			cpr.Initialize(true, kp);
+			mac.Initialize(mkp);
+			ppl.Transform(&cpr);
+			ppl.Authenticate(&mac);
+			ppl.Run(&src, &snk);
+
+			if (snk.ToArray() != enc)
+			{
+				throw TestException(std::string("Equivalence"), cpr.Name(), std::string("The pipeline ciphertext is not equal! -PE1"));
+			}
+
+			if (ppl.Code() != code1)
+			{
+				throw TestException(std::string("Equivalence"), mac.Name(), std::string("The pipeline MAC code is not equal! -PE2"));
+			}
+
+			// authenticate the ciphertext input, and decrypt
+			MemoryStream csrc(enc);
+			MemoryStream psnk;
+			cpr.Initialize(false, kp);
+			mac.Initialize(mkp);
+			ppl.Authenticate(&mac, true);
+			ppl.Run(&csrc, &psnk);
+
+			if (psnk.ToArray() != msg)
+			{
+				throw TestException(std::string("Equivalence"), cpr.Name(), std::string("The pipeline plaintext is not equal! -PE3"));
+			}
+
+			if (ppl.Code() != code1)
+			{
+				throw TestException(std::string("Equivalence"), mac.Name(), std::string("The pipeline input MAC code is not equal! -PE4"));
+			}
+		}
+
+		// the default chunk size is the cipher parallel block size
+		CipherPipeline dpl;
+		msg.resize(cpr.ParallelBlockSize() * 2 + 17);
+		rnd.Generate(msg);
+		enc.resize(msg.size());
+		cpr.Initialize(true, kp);
+		cpr.Transform(msg, 0, enc, 0, msg.size());
+
+		MemoryStream src(msg);
+		MemoryStream snk;
+		cpr.Initialize(true, kp);
+		dpl.Transform(&cpr);
+		dpl.Run(&src, &snk);
+
+		if (snk.ToArray() != enc || dpl.ChunkSize() != cpr.ParallelBlockSize() || dpl.Code().size() != 0)
+		{
+			throw TestException(std::string("Equivalence"), cpr.Name(), std::string("The default chunk pipeline output is not equal! -PE5"));
+		}
+	}
+
+	void CipherPipelineTest::Exception()
+	{
+		SecureRandom rnd;
+		CBC cbc(Enumeration::BlockCiphers::AES);
+		RCS rcs(true);
+		std::vector<uint8_t> msg(1000);
+		SymmetricKey kp(rnd.Generate(32), rnd.Generate(16));
+		bool thr;
+
+		// the queue depth is too small
+		thr = false;
+
+		try
+		{
+			CipherPipeline ppl(4096, 1);
+		}
+		catch (CryptoProcessingException const &)
+		{
+			thr = true;
+		}
+
+		if (!thr)
+		{
+			throw TestException(std::string("Exception"), CLASSNAME, std::string("The invalid queue depth was accepted! -PX1"));
+		}
+
+		// authenticated stream ciphers are rejected
+		thr = false;
+
+		try
+		{
+			CipherPipeline ppl;
+			ppl.Transform(&rcs);
+		}
+		catch (CryptoProcessingException const &)
+		{
+			thr = true;
+		}
+
+		if (!thr)
+		{
+			throw TestException(std::string("Exception"), rcs.Name(), std::string("The authenticated stream cipher was accepted! -PX2"));
+		}
+
+		// the chunk size is not a multiple of the block size
+		thr = false;
+
+		try
+		{
+			CipherPipeline ppl(1000, 2);
+			MemoryStream src(msg);
+			cbc.Initialize(true, kp);
+			ppl.Transform(&cbc);
+			ppl.Run(&src, nullptr);
+		}
+		catch (CryptoProcessingException const &)
+		{
+			thr = true;
+		}
+
+		if (!thr)
+		{
+			throw TestException(std::string("Exception"), cbc.Name(), std::string("The unaligned chunk size was accepted! -PX3"));
+		}
+
+		// a partial block in a block mode is thrown by the transform stage and re-thrown by run
+		thr = false;
+
+		try
+		{
+			CipherPipeline ppl(1024, 2);
+			MemoryStream src(msg);
+			MemoryStream snk;
+			cbc.Initialize(true, kp);
+			ppl.Transform(&cbc);
+			ppl.Run(&src, &snk);
+		}
+		catch (CryptoProcessingException const &)
+		{
+			thr = true;
+		}
+
+		if (!thr)
+		{
+			throw TestException(std::string("Exception"), cbc.Name(), std::string("The stage exception was not propagated! -PX4"));
+		}
+	}
+
+	void CipherPipelineTest::Statistics()
+	{
+		const size_t CHKLEN = 4096;
+		SecureRandom rnd;
+		SHA2256 dgt;
+		CipherPipeline ppl(CHKLEN, 4);
+		std::vector<uint8_t> code1(dgt.DigestSize());
+		std::vector<uint8_t> msg(CHKLEN * 10 + 100);
+		PipelineStatistics sts;
+
+		rnd.Generate(msg);
+		dgt.Compute(msg, code1);
+
+		// digest only; the source and authentication stages
+		MemoryStream src(msg);
+		ppl.Authenticate(&dgt);
+		ppl.Run(&src, nullptr);
+
+		if (ppl.Code() != code1)
+		{
+			throw TestException(std::string("Statistics"), dgt.Name(), std::string("The pipeline digest is not equal! -PS1"));
+		}
+
+		sts = ppl.Statistics(PipelineStages::Source);
+
+		if (sts.Bytes != msg.size() || sts.Chunks != 11)
+		{
+			throw TestException(std::string("Statistics"), CLASSNAME, std::string("The source stage counters are invalid! -PS2"));
+		}
+
+		sts = ppl.Statistics(PipelineStages::Authenticate);
+
+		if (sts.Bytes != msg.size() || sts.Chunks != 11)
+		{
+			throw TestException(std::string("Statistics"), CLASSNAME, std::string("The authentication stage counters are invalid! -PS3"));
+		}
+
+		sts = ppl.Statistics(PipelineStages::Transform);
+
+		if (sts.Bytes != 0 || sts.Chunks != 0 || sts.Throughput() != 0.0)
+		{
+			throw TestException(std::string("Statistics"), CLASSNAME, std::string("The unused stage counters are not zero! -PS4"));
+		}
+	}
+
+	void CipherPipelineTest::OnProgress(const std::string &Data)
+	{
+		m_progressEvent(Data);
+	}
+}
@@ -0,0 +1,70 @@
+#ifndef CEXTEST_CIPHERPIPELINETEST_H
+#define CEXTEST_CIPHERPIPELINETEST_H
+
+#include "ITest.h"
+
+namespace Test
+{
+	/// <summary>
+	/// Tests the CipherPipeline class output against direct output from the cipher and MAC instances
+	/// </summary>
+	class CipherPipelineTest final : public ITest
+	{
+	private:
+
+		static const std::string CLASSNAME;
+		static const std::string DESCRIPTION;
+		static const std::string SUCCESS;
+		static const size_t TEST_CYCLES = 16;
+
+		TestEventHandler m_progressEvent;
+
+	public:
+
+		/// <summary>
+		/// Compare CipherPipeline output to cipher and Mac instance output
+		/// </summary>
+		CipherPipelineTest();
+
+		/// <summary>
+		/// Destructor
+		/// </summary>
+		~CipherPipelineTest();
+
+		/// <summary>
+		/// Get: The test description
+		/// </summary>
+		const std::string Description() override;
+
+		/// <summary>
+		/// Test the encrypt-then-MAC and decrypt pipelines against the cipher and MAC instances, with random stream lengths
+		/// </summary>
+		void Equivalence();
+
+		/// <summary>
+		/// Test the invalid configurations are rejected, and a stage exception is re-thrown by Run
+		/// </summary>
+		void Exception();
+
+		/// <summary>
+		/// Progress return event callback
+		/// </summary>
+		TestEventHandler &Progress() override;
+
+		/// <summary>
+		/// Start the tests
+		/// </summary>
+		std::string Run() override;
+
+		/// <summary>
+		/// Test the stage counters, and a digest-only pipeline
+		/// </summary>
+		void Statistics();
+
+	private:
+
+		void OnProgress(const std::string &Data);
+	};
+}
+
+#endif
@@ -1,22 +1,32 @@
 #include "CipherSpeedTest.h"
 #include "../CEX/CpuDetect.h"
+#include "../CEX/CpuTopology.h"
 #include "../CEX/RHX.h"
 #include "../CEX/SHX.h"
 #include "../CEX/CTR.h"
 #include "../CEX/CBC.h"
 #include "../CEX/CFB.h"
 #include "../CEX/ECB.h"
+#include "../CEX/GCM.h"
+#include "../CEX/GCMSIV.h"
 #include "../CEX/HBA.h"
 #include "../CEX/ICM.h"
 #include "../CEX/OFB.h"
+#include "../CEX/ChaChaKernels.h"
 #include "../CEX/ChaChaP20.h"
 #include "../CEX/CSX512.h"
 #include "../CEX/RCS.h"
+#include "../CEX/SHA2256.h"
+#include "../CEX/SimdDispatch.h"
 #include "../CEX/TSX256.h"
 #include "../CEX/TSX512.h"
 #include "../CEX/TSX1024.h"
 
 #include "../CEX/Keccak.h"
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <thread>
 
 namespace Test
 {
@@ -24,7 +34,11 @@ namespace Test
 	using namespace Cipher::Block::Mode;
 	using namespace Cipher::Stream;
 	using Enumeration::KmacModes;
+	using Enumeration::ParallelPlacements;
+	using Enumeration::SimdKernels;
+	using Enumeration::SimdProfiles;
 	using Enumeration::StreamAuthenticators;
+	using Tools::SimdDispatch;
 
 	const std::string CipherSpeedTest::CLASSNAME = "CipherSpeedTest";
 	const std::string CipherSpeedTest::DESCRIPTION = "Cipher Speed Tests.";
@@ -84,6 +98,10 @@ namespace Test
 			CTRSpeedTest(true, false);
 			OnProgress(std::string("***AES-CTR Parallel Encryption***"));
 			CTRSpeedTest(true, true);
+			OnProgress(std::string("***AES-CTR Parallel Encryption: Scatter Placement***"));
+			PlacementSpeedTest(ParallelPlacements::Scatter);
+			OnProgress(std::string("***AES-CTR Parallel Encryption: Node-Local Placement***"));
+			PlacementSpeedTest(ParallelPlacements::NodeLocal);
 
 			OnProgress(std::string("***AES-ICM Sequential Encryption***"));
 			ICMSpeedTest(true, false);
@@ -94,10 +112,13 @@ namespace Test
 			OFBSpeedTest(true, false);
 
 			OnProgress(std::string("### AEAD Authenticated Cipher Modes ###"));
-			OnProgress(std::string("### Tests speeds of HBA authenticated mode"));
+			OnProgress(std::string("### Tests speeds of the GCM, GCM-SIV and HBA authenticated modes"));
 			OnProgress(std::string("### Uses the standard rounds and a 256 bit key"));
 			OnProgress(std::string(""));
 
+			OnProgress(std::string("***AES-GCM/GCM-SIV/HBA Parallel Encryption: 64KB messages, rekeyed per message***"));
+			AeadSpeedTest(true);
+
 			//OnProgress(std::string("***AES-HBA Sequential Encryption***"));
 			//HBASpeedTest(true, false);
 			//OnProgress(std::string("***AES-HBA Parallel Encryption***"));
@@ -117,6 +138,18 @@ namespace Test
 #endif
 			CSX512SpeedTest();
 
+			OnProgress(std::string("### SIMD WIDE THRESHOLD TESTS ###"));
+			OnProgress(std::string("### Compares the 256-bit and 512-bit ChaCha kernels on mixed traffic, from 1KB to 128KB per call"));
+			OnProgress(std::string("### Each call is followed by a 1KB SHA2-256 hash, standing in for the other work on the core"));
+			OnProgress(std::string(""));
+			SimdThresholdSpeedTest();
+
+			OnProgress(std::string("### KEY-STREAM CACHE LATENCY TESTS ###"));
+			OnProgress(std::string("### Per-call latency of 64 to 1500 byte packets, with and without background key-stream precomputation"));
+			OnProgress(std::string("### Each packet follows a short idle period, in which the cache worker can refill"));
+			OnProgress(std::string(""));
+			PacketLatencySpeedTest();
+
 			OnProgress(std::string("***RCS: Monte Carlo test (K=256; R=22)***"));
 			RCSSpeedTest();
 
@@ -196,6 +229,22 @@ namespace Test
 		}
 	}
 
+	void CipherSpeedTest::PlacementSpeedTest(ParallelPlacements Placement)
+	{
+		CpuTopology topo;
+
+		OnProgress(std::string("NUMA nodes: ") + TestUtils::ToString(topo.NodeCount()) + std::string(", logical processors: ") + TestUtils::ToString(topo.ProcessorCount()));
+
+		{
+			RHX* eng = new RHX();
+			CTR* cpr = new CTR(eng);
+			cpr->ParallelProfile().SetPlacement(Placement);
+			ParallelBlockLoop(cpr, true, true, MB100, 32, 16, 10, m_progressEvent);
+			delete cpr;
+			delete eng;
+		}
+	}
+
 	void CipherSpeedTest::ICMSpeedTest(bool Encrypt, bool Parallel)
 	{
 		{
@@ -231,6 +280,74 @@ namespace Test
 		}
 	}
 
+	void CipherSpeedTest::AeadSpeedTest(bool Parallel)
+	{
+		RHX* eng1 = new RHX();
+		GCM* cpr1 = new GCM(eng1);
+		OnProgress(std::string("AES-GCM:"));
+		AeadLoop(cpr1, Parallel, 32, 16, 64 * KB1, 10);
+		delete cpr1;
+		delete eng1;
+
+		RHX* eng2 = new RHX();
+		GCMSIV* cpr2 = new GCMSIV(eng2);
+		OnProgress(std::string("AES-GCM-SIV:"));
+		AeadLoop(cpr2, Parallel, 32, 12, 64 * KB1, 10);
+		delete cpr2;
+		delete eng2;
+
+		RHX* eng3 = new RHX();
+		HBA* cpr3 = new HBA(eng3, StreamAuthenticators::HMACSHA2256);
+		OnProgress(std::string("AES-HBA(HMAC-SHA2-256):"));
+		AeadLoop(cpr3, Parallel, 32, 16, 64 * KB1, 10);
+		delete cpr3;
+		delete eng3;
+	}
+
+	void CipherSpeedTest::AeadLoop(IAeadMode* Cipher, bool Parallel, size_t KeySize, size_t NonceSize, size_t MessageSize, size_t Loops)
+	{
+		const size_t MSGCNT = DATA_SIZE / MessageSize;
+		std::vector<uint8_t> assoc(16, 0x00);
+		std::vector<uint8_t> buffer1(MessageSize, 0x00);
+		std::vector<uint8_t> buffer2(MessageSize + Cipher->TagSize(), 0x00);
+		std::string glen;
+		std::string mbps;
+		std::string resp;
+		std::string secs;
+		uint64_t dur;
+		uint64_t len;
+		uint64_t rate;
+		uint64_t start;
+		size_t i;
+		size_t j;
+
+		Cipher::SymmetricKey* keyParam = TestUtils::GetRandomKey(KeySize, NonceSize);
+		Cipher->ParallelProfile().IsParallel() = Parallel;
+		start = TestUtils::GetTimeMs64();
+
+		for (i = 0; i < Loops; ++i)
+		{
+			for (j = 0; j < MSGCNT; ++j)
+			{
+				// each message is a full AEAD operation; key setup, associated data, transform, and tag
+				Cipher->Initialize(true, *keyParam);
+				Cipher->SetAssociatedData(assoc, 0, assoc.size());
+				Cipher->Transform(buffer1, 0, buffer2, 0, buffer1.size());
+			}
+		}
+
+		dur = TestUtils::GetTimeMs64() - start;
+		len = static_cast<uint64_t>(Loops) * MSGCNT * MessageSize;
+		rate = GetBytesPerSecond(dur, len);
+		glen = TestUtils::ToString(len / GB1);
+		mbps = TestUtils::ToString((rate / MB1));
+		secs = TestUtils::ToString(static_cast<double>(dur) / 1000.0);
+		resp = std::string(glen + "GB in " + secs + " seconds, avg. " + mbps + " MB per Second");
+		OnProgress(resp);
+		OnProgress(std::string(""));
+		delete keyParam;
+	}
+
 	//*** Stream Cipher Tests ***//
 
 	void CipherSpeedTest::CSX256SpeedTest()
@@ -247,6 +364,170 @@ namespace Test
 		delete cpr;
 	}
 
+	void CipherSpeedTest::SimdThresholdSpeedTest()
+	{
+		ChaChaP20* cpr256 = new ChaChaP20(false);
+		CSX512* cpr512 = new CSX512(false);
+		TSX512* cprtsx = new TSX512(false);
+
+		OnProgress(std::string("***ChaChaP20: SIMD wide threshold***"));
+		SimdThresholdLoop(cpr256, SimdKernels::ChaCha256, 32, 8);
+		OnProgress(std::string("***CSX512: SIMD wide threshold***"));
+		SimdThresholdLoop(cpr512, SimdKernels::ChaCha512, 64, 16);
+		OnProgress(std::string("***TSX512: SIMD wide threshold***"));
+		SimdThresholdLoop(cprtsx, SimdKernels::Threefish, 64, 16);
+
+		delete cpr256;
+		delete cpr512;
+		delete cprtsx;
+	}
+
+	void CipherSpeedTest::PacketLatencySpeedTest()
+	{
+		const size_t CACHE = 16384;
+
+		RHX* eng1 = new RHX();
+		CTR* cpr1 = new CTR(eng1);
+		OnProgress(std::string("***AES-CTR: packet latency***"));
+		PacketLatencyLoop(cpr1, 32, 16, 0);
+		PacketLatencyLoop(cpr1, 32, 16, CACHE);
+		delete cpr1;
+		delete eng1;
+
+		ChaChaP20* cpr2 = new ChaChaP20(false);
+		OnProgress(std::string("***ChaChaP20: packet latency***"));
+		PacketLatencyLoop(cpr2, 32, 8, 0);
+		PacketLatencyLoop(cpr2, 32, 8, CACHE);
+		delete cpr2;
+	}
+
+	template <typename T>
+	void CipherSpeedTest::PacketLatencyLoop(T* Cipher, size_t KeySize, size_t IvSize, size_t CacheSize)
+	{
+		const size_t MAXLEN = 1500;
+		const size_t MINLEN = 64;
+		const size_t PKTCNT = 20000;
+		std::vector<uint8_t> inp(MAXLEN, 0x00);
+		std::vector<uint8_t> otp(MAXLEN, 0x00);
+		std::vector<uint64_t> smp(PKTCNT);
+		std::chrono::steady_clock::time_point start;
+		std::string resp;
+		size_t i;
+		size_t len;
+
+		Cipher::SymmetricKey* keyParam = TestUtils::GetRandomKey(KeySize, IvSize);
+		Cipher->ParallelProfile().IsParallel() = false;
+		Cipher->Precompute(CacheSize);
+		Cipher->Initialize(true, *keyParam);
+
+		for (i = 0; i < PKTCNT; ++i)
+		{
+			// a spread of packet sizes, and the idle time between packets in which the worker refills the cache
+			len = MINLEN + ((i * 7919) % (MAXLEN - MINLEN + 1));
+			std::this_thread::sleep_for(std::chrono::microseconds(20));
+
+			start = std::chrono::steady_clock::now();
+			Cipher->Transform(inp, 0, otp, 0, len);
+			smp[i] = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+		}
+
+		std::sort(smp.begin(), smp.end());
+		resp = (CacheSize == 0) ? std::string("Without cache: ") : std::string("With a " + TestUtils::ToString(CacheSize / KB1) + "KB cache: ");
+		resp += std::string("p50 " + TestUtils::ToString(smp[PKTCNT / 2]) + " ns, p99 " + TestUtils::ToString(smp[(PKTCNT * 99) / 100]) + " ns");
+		OnProgress(resp);
+
+		if (CacheSize != 0)
+		{
+			OnProgress(std::string(""));
+		}
+
+		Cipher->Precompute(0);
+		delete keyParam;
+	}
+
+	void CipherSpeedTest::SimdThresholdLoop(IStreamCipher* Cipher, SimdKernels Kernel, size_t KeySize, size_t IvSize)
+	{
+		const size_t MAXLEN = 131072;
+		const size_t MINLEN = 1024;
+		const size_t NBRLEN = 1024;
+		SimdDispatch &dsp = SimdDispatch::Instance();
+		Digest::SHA2256 dgt;
+		std::vector<uint8_t> hash(dgt.DigestSize(), 0x00);
+		std::vector<uint8_t> inp(MAXLEN, 0x00);
+		std::vector<uint8_t> nbr(NBRLEN, 0x00);
+		std::vector<uint8_t> otp(MAXLEN, 0x00);
+		uint64_t nrwms;
+		uint64_t start;
+		uint64_t widms;
+		size_t i;
+		size_t len;
+		size_t loops;
+		size_t thr;
+
+		if (dsp.Detected() != SimdProfiles::Simd512 || !ChaChaKernels::HasAvx512())
+		{
+			OnProgress(std::string("The host or the library does not support the 512-bit kernels; the threshold was not measured."));
+			OnProgress(std::string(""));
+		}
+		else
+		{
+			Cipher::SymmetricKey* keyParam = TestUtils::GetRandomKey(KeySize, IvSize);
+			Cipher->Initialize(true, *keyParam);
+			Cipher->ParallelProfile().IsParallel() = false;
+			thr = std::numeric_limits<size_t>::max();
+
+			// the threshold is the smallest size from which the wide kernel is faster at every larger size
+			for (len = MAXLEN; len >= MINLEN; len /= 2)
+			{
+				loops = static_cast<size_t>(DATA_SIZE / len);
+
+				dsp.SetWideThreshold(Kernel, std::numeric_limits<size_t>::max());
+				start = TestUtils::GetTimeMs64();
+
+				for (i = 0; i < loops; ++i)
+				{
+					Cipher->Transform(inp, 0, otp, 0, len);
+					dgt.Compute(nbr, hash);
+				}
+
+				nrwms = TestUtils::GetTimeMs64() - start;
+
+				dsp.SetWideThreshold(Kernel, 0);
+				start = TestUtils::GetTimeMs64();
+
+				for (i = 0; i < loops; ++i)
+				{
+					Cipher->Transform(inp, 0, otp, 0, len);
+					dgt.Compute(nbr, hash);
+				}
+
+				widms = TestUtils::GetTimeMs64() - start;
+
+				if (widms < nrwms && (len == MAXLEN || thr == len * 2))
+				{
+					thr = len;
+				}
+
+				OnProgress(TestUtils::ToString(len) + std::string(" bytes per call: 256-bit ") + TestUtils::ToString(nrwms) + 
+					std::string(" ms, 512-bit ") + TestUtils::ToString(widms) + std::string(" ms"));
+			}
+
+			dsp.SetWideThreshold(Kernel, thr);
+
+			if (thr != std::numeric_limits<size_t>::max())
+			{
+				OnProgress(std::string("Measured wide threshold: ") + TestUtils::ToString(thr) + std::string(" bytes"));
+			}
+			else
+			{
+				OnProgress(std::string("The 512-bit kernel was not faster at any size; the wide kernel is disabled for this cipher"));
+			}
+
+			OnProgress(std::string(""));
+			delete keyParam;
+		}
+	}
+
 	void CipherSpeedTest::RCSSpeedTest()
 	{
 		RCS* cpr = new RCS(false);
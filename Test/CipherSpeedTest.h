@@ -2,6 +2,10 @@
 #define CEXTEST_CIPHERSPEEDTEST_H
 
 #include "ITest.h"
+#include "../CEX/IAeadMode.h"
+#include "../CEX/IStreamCipher.h"
+#include "../CEX/ParallelPlacements.h"
+#include "../CEX/SimdKernels.h"
 
 namespace Test
 {
@@ -150,6 +154,8 @@ namespace Test
 			delete keyParam;
 		}
 
+		void AeadLoop(Cipher::Block::Mode::IAeadMode* Cipher, bool Parallel, size_t KeySize, size_t NonceSize, size_t MessageSize, size_t Loops);
+		void AeadSpeedTest(bool Parallel);
 		void CBCSpeedTest(bool Encrypt, bool Parallel);
 		void CFBSpeedTest(bool Encrypt, bool Parallel);
 		void CTRSpeedTest(bool Encrypt, bool Parallel);
@@ -165,8 +171,14 @@ namespace Test
 		void ICMSpeedTest(bool Encrypt, bool Parallel);
 		void OFBSpeedTest(bool Encrypt, bool Parallel);
 		void OnProgress(const std::string &Data);
+		template <typename T>
+		void PacketLatencyLoop(T* Cipher, size_t KeySize, size_t IvSize, size_t CacheSize);
+		void PacketLatencySpeedTest();
+		void PlacementSpeedTest(Enumeration::ParallelPlacements Placement);
 		void RHXSpeedTest(size_t KeySize = 32);
 		void SHXSpeedTest(size_t KeySize = 32);
+		void SimdThresholdLoop(Cipher::Stream::IStreamCipher* Cipher, Enumeration::SimdKernels Kernel, size_t KeySize, size_t IvSize);
+		void SimdThresholdSpeedTest();
 	};
 }
 
@@ -1,20 +1,79 @@
 #include "ParallelModeTest.h"
 #include "TestUtils.h"
 #include "../CEX/CBC.h"
+#include "../CEX/CryptoCipherModeException.h"
 #include "../CEX/CTR.h"
 #include "../CEX/ECB.h"
 #include "../CEX/ICM.h"
 #include "../CEX/IntegerTools.h"
+#include "../CEX/MemoryTools.h"
+#include "../CEX/IParallelExecutor.h"
+#include "../CEX/ParallelGovernor.h"
+#include "../CEX/ParallelTuner.h"
 #include "../CEX/SecureRandom.h"
+#include <atomic>
+#include <cstdio>
+#include <thread>
 
 namespace Test
 {
 	using namespace Cipher::Block::Mode;
+	using Exception::CryptoCipherModeException;
 	using Tools::IntegerTools;
+	using Tools::MemoryTools;
+	using Tools::ParallelGovernor;
+	using Tools::ParallelTuner;
 	using Prng::SecureRandom;
 	using Cipher::SymmetricKey;
 	using Cipher::SymmetricKeySize;
 
+	/// <summary>
+	/// A host executor stand-in; runs each loop index on its own thread and counts the scheduled work
+	/// </summary>
+	class TestExecutor final : public IParallelExecutor
+	{
+	public:
+
+		std::atomic<size_t> Scheduled;
+
+		TestExecutor()
+			:
+			Scheduled(0)
+		{
+		}
+
+		const size_t Concurrency() override
+		{
+			return static_cast<size_t>(std::thread::hardware_concurrency());
+		}
+
+		void BulkRun(size_t From, size_t To, const std::function<void(size_t)> &F) override
+		{
+			std::vector<std::thread> thds;
+
+			for (size_t i = From; i < To; ++i)
+			{
+				++Scheduled;
+				thds.push_back(std::thread([i, &F]() { F(i); }));
+			}
+
+			for (size_t i = 0; i < thds.size(); ++i)
+			{
+				thds[i].join();
+			}
+		}
+
+		void Submit(const std::function<void()> &F) override
+		{
+			++Scheduled;
+			F();
+		}
+
+		void Wait() override
+		{
+		}
+	};
+
 	const std::string ParallelModeTest::CLASSNAME = "ParallelModeTest";
 	const std::string ParallelModeTest::DESCRIPTION = "Stress test compares output from parallel and linear modes for equality.";
 	const std::string ParallelModeTest::SUCCESS = "SUCCESS! Parallel stress tests have executed succesfully.";
@@ -69,6 +128,67 @@ namespace Test
 			OnProgress(std::string("ParallelModeTest: Passed ICM parallel to sequential equivalence test.."));
 			delete cpr4;
 
+			CTR* cpr5 = new CTR(Enumeration::BlockCiphers::AES);
+			Executor(cpr5);
+			OnProgress(std::string("ParallelModeTest: Passed CTR user executor scheduling test.."));
+			delete cpr5;
+
+			Concurrent();
+			OnProgress(std::string("ParallelModeTest: Passed CTR concurrent callers governor test.."));
+
+			CBC* cpr6 = new CBC(Enumeration::BlockCiphers::AES);
+			Hybrid(cpr6, false);
+			OnProgress(std::string("ParallelModeTest: Passed CBC hybrid segmentation equivalence test.."));
+			delete cpr6;
+
+			CTR* cpr7 = new CTR(Enumeration::BlockCiphers::AES);
+			Hybrid(cpr7, true);
+			OnProgress(std::string("ParallelModeTest: Passed CTR hybrid segmentation equivalence test.."));
+			delete cpr7;
+
+			Tuning();
+			OnProgress(std::string("ParallelModeTest: Passed CTR host profile calibration and reload test.."));
+
+			CTR* cpr8 = new CTR(Enumeration::BlockCiphers::AES);
+			Seek(cpr8);
+			OnProgress(std::string("ParallelModeTest: Passed CTR random access transform and seek test.."));
+			delete cpr8;
+
+			ICM* cpr9 = new ICM(Enumeration::BlockCiphers::AES);
+			Seek(cpr9);
+			OnProgress(std::string("ParallelModeTest: Passed ICM random access transform and seek test.."));
+			delete cpr9;
+
+			CTR* cpr10 = new CTR(Enumeration::BlockCiphers::AES);
+			Precompute(cpr10);
+			OnProgress(std::string("ParallelModeTest: Passed CTR background key-stream cache equivalence test.."));
+			delete cpr10;
+
+			ICM* cpr11 = new ICM(Enumeration::BlockCiphers::AES);
+			Precompute(cpr11);
+			OnProgress(std::string("ParallelModeTest: Passed ICM background key-stream cache equivalence test.."));
+			delete cpr11;
+
+			CBC* cpr12 = new CBC(Enumeration::BlockCiphers::AES);
+			Pointer(cpr12);
+			OnProgress(std::string("ParallelModeTest: Passed CBC pointer and in-place transform equivalence test.."));
+			delete cpr12;
+
+			CTR* cpr13 = new CTR(Enumeration::BlockCiphers::AES);
+			Pointer(cpr13);
+			OnProgress(std::string("ParallelModeTest: Passed CTR pointer and in-place transform equivalence test.."));
+			delete cpr13;
+
+			ECB* cpr14 = new ECB(Enumeration::BlockCiphers::AES);
+			Pointer(cpr14);
+			OnProgress(std::string("ParallelModeTest: Passed ECB pointer and in-place transform equivalence test.."));
+			delete cpr14;
+
+			ICM* cpr15 = new ICM(Enumeration::BlockCiphers::AES);
+			Pointer(cpr15);
+			OnProgress(std::string("ParallelModeTest: Passed ICM pointer and in-place transform equivalence test.."));
+			delete cpr15;
+
 			return SUCCESS;
 		}
 		catch (TestException const &ex)
@@ -85,6 +205,427 @@ namespace Test
 		}
 	}
 
+	void ParallelModeTest::Concurrent()
+	{
+		ParallelGovernor &gov = ParallelGovernor::Instance();
+		std::vector<std::thread> thds;
+		std::atomic<size_t> errors(0);
+		size_t i;
+
+		gov.ResetCounters();
+
+		for (i = 0; i < TEST_THREADS; ++i)
+		{
+			thds.push_back(std::thread([&errors]()
+			{
+				CTR cpr1(Enumeration::BlockCiphers::AES);
+				CTR cpr2(Enumeration::BlockCiphers::AES);
+				const size_t MSGLEN = cpr2.ParallelProfile().ParallelBlockSize() * 4;
+				std::vector<uint8_t> cpt1(MSGLEN);
+				std::vector<uint8_t> cpt2(MSGLEN);
+				std::vector<uint8_t> inp(MSGLEN);
+				std::vector<uint8_t> key(32);
+				std::vector<uint8_t> iv(16);
+				Prng::SecureRandom rnd;
+
+				rnd.Generate(key, 0, key.size());
+				rnd.Generate(iv, 0, iv.size());
+				rnd.Generate(inp, 0, inp.size());
+				SymmetricKey k(key, iv);
+
+				cpr1.ParallelProfile().IsParallel() = false;
+				cpr1.Initialize(true, k);
+				cpr1.Transform(inp, 0, cpt1, 0, MSGLEN);
+
+				cpr2.Initialize(true, k);
+				cpr2.ParallelProfile().IsParallel() = true;
+
+				for (size_t j = 0; j < TEST_CYCLES / 10; ++j)
+				{
+					cpr2.Initialize(true, k);
+					cpr2.Transform(inp, 0, cpt2, 0, MSGLEN);
+
+					if (cpt1 != cpt2)
+					{
+						++errors;
+					}
+				}
+			}));
+		}
+
+		for (i = 0; i < thds.size(); ++i)
+		{
+			thds[i].join();
+		}
+
+		if (errors != 0)
+		{
+			throw TestException(std::string("Concurrent"), std::string("CTR"), std::string("Cipher output is not equal! -TC1"));
+		}
+
+		if (gov.InFlight() != 0)
+		{
+			throw TestException(std::string("Concurrent"), std::string("CTR"), std::string("The governor did not release every granted thread! -TC2"));
+		}
+
+		if (gov.PeakInFlight() > gov.Capacity() + TEST_THREADS)
+		{
+			throw TestException(std::string("Concurrent"), std::string("CTR"), std::string("The governor exceeded the thread capacity! -TC3"));
+		}
+	}
+
+	void ParallelModeTest::Executor(ICipherMode* Cipher)
+	{
+		const size_t MSGLEN = Cipher->ParallelProfile().ParallelBlockSize() * 2;
+		Cipher::SymmetricKeySize ks = Cipher->LegalKeySizes()[0];
+		std::vector<uint8_t> cpt1(MSGLEN);
+		std::vector<uint8_t> cpt2(MSGLEN);
+		std::vector<uint8_t> inp(MSGLEN);
+		std::vector<uint8_t> key(ks.KeySize());
+		std::vector<uint8_t> iv(ks.IVSize());
+		Prng::SecureRandom rnd;
+		TestExecutor exec;
+
+		rnd.Generate(key, 0, key.size());
+		rnd.Generate(iv, 0, iv.size());
+		rnd.Generate(inp, 0, inp.size());
+		SymmetricKey k(key, iv);
+
+		// sequential
+		Cipher->Initialize(true, k);
+		Cipher->ParallelProfile().IsParallel() = false;
+		Cipher->Transform(inp, 0, cpt1, 0, MSGLEN);
+
+		// parallel, scheduled on the test executor
+		Cipher->ParallelProfile().SetExecutor(&exec);
+		Cipher->Initialize(true, k);
+		Cipher->ParallelProfile().IsParallel() = true;
+		Cipher->Transform(inp, 0, cpt2, 0, MSGLEN);
+		Cipher->ParallelProfile().SetExecutor(nullptr);
+
+		if (exec.Scheduled == 0)
+		{
+			throw TestException(std::string("Executor"), Cipher->Name(), std::string("The parallel transform did not use the installed executor! -TE1"));
+		}
+
+		if (cpt1 != cpt2)
+		{
+			throw TestException(std::string("Executor"), Cipher->Name(), std::string("Cipher output is not equal! -TE2"));
+		}
+	}
+
+	void ParallelModeTest::Hybrid(ICipherMode* Cipher, bool Encryption)
+	{
+		Cipher->ParallelProfile().SetHybrid(true);
+
+		if (Cipher->ParallelProfile().ParallelSegmentCount() <= Cipher->ParallelProfile().ParallelMaxDegree())
+		{
+			throw TestException(std::string("Hybrid"), Cipher->Name(), std::string("The parallel block was not divided into segments! -TH1"));
+		}
+
+		Stress(Cipher, Encryption);
+		Cipher->ParallelProfile().SetHybrid(false);
+
+		if (Cipher->ParallelProfile().ParallelSegmentCount() != Cipher->ParallelProfile().ParallelMaxDegree())
+		{
+			throw TestException(std::string("Hybrid"), Cipher->Name(), std::string("The segment count was not restored! -TH2"));
+		}
+	}
+
+	void ParallelModeTest::Pointer(ICipherMode* Cipher)
+	{
+		const size_t BLKLEN = Cipher->BlockSize();
+		const uint32_t MINSMP = static_cast<uint32_t>(Cipher->ParallelProfile().ParallelBlockSize());
+		const uint32_t MAXSMP = static_cast<uint32_t>(Cipher->ParallelProfile().ParallelBlockSize()) * 4;
+		Cipher::SymmetricKeySize ks = Cipher->LegalKeySizes()[0];
+		std::vector<uint8_t> cpt1;
+		std::vector<uint8_t> cpt2;
+		std::vector<uint8_t> inp;
+		std::vector<uint8_t> key(ks.KeySize());
+		std::vector<uint8_t> iv(ks.IVSize());
+		Prng::SecureRandom rnd;
+
+		for (size_t i = 0; i < TEST_CYCLES; ++i)
+		{
+			// a random number of blocks, spanning several segments
+			size_t plen = static_cast<size_t>(rnd.NextUInt32(MAXSMP, MINSMP));
+			plen -= (plen % BLKLEN);
+			cpt1.resize(plen);
+			cpt2.resize(plen);
+			inp.resize(plen);
+
+			rnd.Generate(key, 0, key.size());
+			rnd.Generate(iv, 0, iv.size());
+			rnd.Generate(inp, 0, plen);
+			SymmetricKey k(key, iv);
+
+			// the vector transform
+			Cipher->Initialize(true, k);
+			Cipher->ParallelProfile().IsParallel() = true;
+			Cipher->Transform(inp, 0, cpt1, 0, plen);
+
+			// the pointer transform to a separate buffer
+			Cipher->Initialize(true, k);
+			Cipher->Transform(inp.data(), cpt2.data(), plen);
+
+			if (cpt1 != cpt2)
+			{
+				throw TestException(std::string("Pointer"), Cipher->Name(), std::string("Cipher output is not equal! -TR1"));
+			}
+
+			// the pointer transform in place
+			MemoryTools::Copy(inp, 0, cpt2, 0, plen);
+			Cipher->Initialize(true, k);
+			Cipher->Transform(cpt2.data(), cpt2.data(), plen);
+
+			if (cpt1 != cpt2)
+			{
+				throw TestException(std::string("Pointer"), Cipher->Name(), std::string("Cipher output is not equal! -TR2"));
+			}
+
+			// decrypt in place
+			Cipher->Initialize(false, k);
+			Cipher->Transform(cpt2.data(), cpt2.data(), plen);
+
+			if (cpt2 != inp)
+			{
+				throw TestException(std::string("Pointer"), Cipher->Name(), std::string("Cipher output is not equal! -TR3"));
+			}
+
+			// successive blocks with the vector and pointer block functions
+			Cipher->Initialize(true, k);
+			Cipher->EncryptBlock(inp, 0, cpt1, 0);
+			Cipher->EncryptBlock(inp, BLKLEN, cpt1, BLKLEN);
+			Cipher->Initialize(true, k);
+			MemoryTools::Copy(inp, 0, cpt2, 0, 2 * BLKLEN);
+			Cipher->EncryptBlock(inp.data(), cpt2.data());
+			Cipher->EncryptBlock(cpt2.data() + BLKLEN, cpt2.data() + BLKLEN);
+
+			if (IntegerTools::Compare(cpt1, 0, cpt2, 0, 2 * BLKLEN) == false)
+			{
+				throw TestException(std::string("Pointer"), Cipher->Name(), std::string("Cipher output is not equal! -TR4"));
+			}
+
+			Cipher->Initialize(false, k);
+			Cipher->DecryptBlock(cpt2.data(), cpt2.data());
+			Cipher->DecryptBlock(cpt2.data() + BLKLEN, cpt2.data() + BLKLEN);
+
+			if (IntegerTools::Compare(inp, 0, cpt2, 0, 2 * BLKLEN) == false)
+			{
+				throw TestException(std::string("Pointer"), Cipher->Name(), std::string("Cipher output is not equal! -TR5"));
+			}
+		}
+	}
+
+	template <typename T>
+	void ParallelModeTest::Precompute(T* Cipher)
+	{
+		const size_t BLKLEN = Cipher->BlockSize();
+		const size_t CACHE = 4096;
+		const size_t PKTCNT = 24;
+		Cipher::SymmetricKeySize ks = Cipher->LegalKeySizes()[0];
+		std::vector<uint8_t> cpt1;
+		std::vector<uint8_t> cpt2;
+		std::vector<uint8_t> inp;
+		std::vector<uint8_t> otp;
+		std::vector<uint8_t> key(ks.KeySize());
+		std::vector<uint8_t> nonce(ks.IVSize());
+		std::vector<size_t> kpos(PKTCNT);
+		std::vector<size_t> plen(PKTCNT);
+		std::vector<size_t> ppos(PKTCNT);
+		std::vector<uint8_t> ctr1;
+		std::vector<uint8_t> ctr2;
+		SecureRandom rnd;
+		size_t i;
+		size_t j;
+		size_t msglen;
+		size_t spos;
+
+		for (i = 0; i < TEST_CYCLES; ++i)
+		{
+			// packet sized messages, and one longer than the cache
+			msglen = 0;
+			spos = 0;
+
+			for (j = 0; j < PKTCNT; ++j)
+			{
+				plen[j] = (j == PKTCNT / 3) ? (CACHE * 3) + 7 : static_cast<size_t>(rnd.NextUInt32(1500, 1));
+				ppos[j] = msglen;
+				kpos[j] = spos;
+				// each call starts the key-stream on a block boundary
+				spos += plen[j] + ((BLKLEN - (plen[j] % BLKLEN)) % BLKLEN);
+				msglen += plen[j];
+			}
+
+			cpt1.resize(msglen);
+			cpt2.resize(msglen);
+			inp.resize(msglen);
+			otp.resize(msglen);
+			rnd.Generate(key, 0, key.size());
+			rnd.Generate(nonce, 0, nonce.size());
+			rnd.Generate(inp, 0, msglen);
+			SymmetricKey kp(key, nonce);
+
+			// the reference stream
+			Cipher->Precompute(0);
+			Cipher->Initialize(true, kp);
+
+			for (j = 0; j < PKTCNT; ++j)
+			{
+				Cipher->Transform(inp, ppos[j], cpt1, ppos[j], plen[j]);
+			}
+
+			ctr1 = Cipher->Nonce();
+
+			// the same packets through the cache, disabled and enabled again part way through the stream
+			Cipher->Precompute(CACHE);
+			Cipher->Initialize(true, kp);
+
+			for (j = 0; j < PKTCNT; ++j)
+			{
+				if (j == PKTCNT / 2)
+				{
+					Cipher->Precompute(0);
+				}
+				else if (j == (PKTCNT / 4) * 3)
+				{
+					Cipher->Precompute(CACHE);
+				}
+
+				Cipher->Transform(inp, ppos[j], cpt2, ppos[j], plen[j]);
+			}
+
+			if (cpt1 != cpt2)
+			{
+				throw TestException(std::string("Precompute"), Cipher->Name(), std::string("Cipher output is not equal! -TP1"));
+			}
+
+			// the counter is synchronized with the cache position
+			ctr2 = Cipher->Nonce();
+
+			if (ctr1 != ctr2)
+			{
+				throw TestException(std::string("Precompute"), Cipher->Name(), std::string("Cipher counter is not equal! -TP2"));
+			}
+
+			// rekeying discards the cached key-stream of the previous key
+			rnd.Generate(key, 0, key.size());
+			SymmetricKey kp2(key, nonce);
+			Cipher->Initialize(true, kp2);
+			Cipher->Transform(inp, ppos[0], otp, ppos[0], plen[0]);
+
+			// decrypt the packets in reverse order, seeking to the key-stream position of each
+			MemoryTools::Clear(otp, 0, otp.size());
+			Cipher->Initialize(false, kp);
+
+			for (j = PKTCNT; j != 0; --j)
+			{
+				Cipher->Seek(kpos[j - 1]);
+				Cipher->Transform(cpt1, ppos[j - 1], otp, ppos[j - 1], plen[j - 1]);
+			}
+
+			if (otp != inp)
+			{
+				throw TestException(std::string("Precompute"), Cipher->Name(), std::string("Cipher output is not equal! -TP3"));
+			}
+
+			// the capacity must be a multiple of four blocks
+			try
+			{
+				Cipher->Precompute(BLKLEN);
+
+				throw TestException(std::string("Precompute"), Cipher->Name(), std::string("Exception handling failure! -TP4"));
+			}
+			catch (CryptoCipherModeException const &)
+			{
+			}
+			catch (TestException const &)
+			{
+				throw;
+			}
+		}
+
+		Cipher->Precompute(0);
+	}
+
+	template <typename T>
+	void ParallelModeTest::Seek(T* Cipher)
+	{
+		const size_t MSGLEN = (Cipher->ParallelBlockSize() * 2) + 1000;
+		Cipher::SymmetricKeySize ks = Cipher->LegalKeySizes()[0];
+		std::vector<uint8_t> cpt(MSGLEN);
+		std::vector<uint8_t> inp(MSGLEN);
+		std::vector<uint8_t> key(ks.KeySize());
+		std::vector<uint8_t> nonce(ks.IVSize());
+		std::vector<uint8_t> otp(MSGLEN);
+		Prng::SecureRandom rnd;
+		size_t plen;
+		size_t pos;
+
+		for (size_t i = 0; i < TEST_CYCLES; ++i)
+		{
+			rnd.Generate(key, 0, key.size());
+			rnd.Generate(nonce, 0, nonce.size());
+			rnd.Generate(inp, 0, MSGLEN);
+			SymmetricKey kp(key, nonce);
+
+			// encrypt the whole stream
+			Cipher->Initialize(true, kp);
+			Cipher->ParallelProfile().IsParallel() = true;
+			Cipher->Transform(inp, 0, cpt, 0, MSGLEN);
+
+			// decrypt a random window at an unaligned position
+			pos = static_cast<size_t>(rnd.NextUInt32(static_cast<uint32_t>(MSGLEN - 1), 0));
+			plen = static_cast<size_t>(rnd.NextUInt32(static_cast<uint32_t>(MSGLEN - pos), 1));
+			MemoryTools::Clear(otp, 0, otp.size());
+			Cipher->Initialize(false, kp);
+			Cipher->TransformAt(pos, cpt, pos, otp, pos, plen);
+
+			if (IntegerTools::Compare(inp, pos, otp, pos, plen) == false)
+			{
+				throw TestException(std::string("Seek"), Cipher->Name(), std::string("Cipher output is not equal! -TK1"));
+			}
+
+			// decrypt the stream as two disjoint ranges, in reverse order
+			MemoryTools::Clear(otp, 0, otp.size());
+			Cipher->Initialize(false, kp);
+			Cipher->TransformAt(pos, cpt, pos, otp, pos, MSGLEN - pos);
+			Cipher->TransformAt(0, cpt, 0, otp, 0, pos);
+
+			if (otp != inp)
+			{
+				throw TestException(std::string("Seek"), Cipher->Name(), std::string("Cipher output is not equal! -TK2"));
+			}
+
+			// seek to a block aligned position and continue with a standard transform
+			pos -= (pos % Cipher->BlockSize());
+			MemoryTools::Clear(otp, 0, otp.size());
+			Cipher->Initialize(false, kp);
+			Cipher->Seek(pos);
+			Cipher->Transform(cpt, pos, otp, pos, MSGLEN - pos);
+
+			if (IntegerTools::Compare(inp, pos, otp, pos, MSGLEN - pos) == false)
+			{
+				throw TestException(std::string("Seek"), Cipher->Name(), std::string("Cipher output is not equal! -TK3"));
+			}
+
+			// an unaligned seek must be rejected
+			try
+			{
+				Cipher->Seek(pos + 1);
+
+				throw TestException(std::string("Seek"), Cipher->Name(), std::string("Exception handling failure! -TK4"));
+			}
+			catch (CryptoCipherModeException const &)
+			{
+			}
+			catch (TestException const &)
+			{
+				throw;
+			}
+		}
+	}
+
 	void ParallelModeTest::Stress(IAeadMode* Cipher, bool Encryption)
 	{
 		const uint32_t MINSMP = static_cast<uint32_t>(Cipher->ParallelProfile().ParallelBlockSize());
@@ -222,6 +763,71 @@ namespace Test
 
 	//~~~Private Functions~~~//
 
+	void ParallelModeTest::Tuning()
+	{
+		const std::string PRFPTH = "cex-parallel-test.profile";
+		ParallelTuner &tnr = ParallelTuner::Instance();
+		CTR cpr1(Enumeration::BlockCiphers::AES);
+		const std::string KEY = cpr1.ParallelProfile().ProfileKey();
+		const size_t TUNLEN = cpr1.ParallelProfile().ParallelMinimumSize() * 2;
+		Cipher::SymmetricKeySize ks = cpr1.LegalKeySizes()[0];
+		std::vector<uint8_t> key(ks.KeySize());
+		std::vector<uint8_t> iv(ks.IVSize());
+		SecureRandom rnd;
+		size_t blk;
+		bool prl;
+
+		rnd.Generate(key, 0, key.size());
+		rnd.Generate(iv, 0, iv.size());
+		SymmetricKey k(key, iv);
+		cpr1.Initialize(true, k);
+
+		// a single core processor is not calibrated
+		if (tnr.Calibrate(&cpr1))
+		{
+			if (!tnr.Find(KEY, blk, prl) || blk != cpr1.ParallelProfile().ParallelBlockSize() || prl != cpr1.ParallelProfile().IsParallel())
+			{
+				throw TestException(std::string("Tuning"), cpr1.Name(), std::string("The calibrated values were not applied to the profile! -TT1"));
+			}
+		}
+
+		tnr.Store(KEY, TUNLEN, true);
+
+		if (!tnr.Save(PRFPTH))
+		{
+			throw TestException(std::string("Tuning"), cpr1.Name(), std::string("The host profile could not be written! -TT2"));
+		}
+
+		tnr.Clear();
+
+		if (!tnr.Load(PRFPTH) || !tnr.Find(KEY, blk, prl) || blk != TUNLEN || !prl)
+		{
+			std::remove(PRFPTH.c_str());
+			throw TestException(std::string("Tuning"), cpr1.Name(), std::string("The host profile was not reloaded! -TT3"));
+		}
+
+		std::remove(PRFPTH.c_str());
+
+		// a new instance starts from the profile, and is still equivalent to sequential processing
+		CTR cpr2(Enumeration::BlockCiphers::AES);
+
+		if (cpr2.ParallelProfile().ParallelBlockSize() != TUNLEN)
+		{
+			throw TestException(std::string("Tuning"), cpr2.Name(), std::string("The profile block size was not used by a new instance! -TT4"));
+		}
+
+		// another mode with the same cipher and block parameters has its own entry
+		ICM cpr3(Enumeration::BlockCiphers::AES);
+
+		if (cpr3.ParallelProfile().ProfileKey() == KEY || tnr.Find(cpr3.ParallelProfile().ProfileKey(), blk, prl))
+		{
+			throw TestException(std::string("Tuning"), cpr3.Name(), std::string("The profile of another algorithm was applied! -TT5"));
+		}
+
+		Stress(&cpr2, true);
+		tnr.Clear();
+	}
+
 	void ParallelModeTest::OnProgress(const std::string &Data)
 	{
 		m_progressEvent(Data);
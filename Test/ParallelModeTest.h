@@ -21,6 +21,7 @@ namespace Test
 		static const std::string SUCCESS;
 		static const size_t MAXM_ALLOC = 262140;
 		static const size_t TEST_CYCLES = 100;
+		static const size_t TEST_THREADS = 16;
 
 		TestEventHandler m_progressEvent;
 
@@ -52,11 +53,54 @@ namespace Test
 
 		//~~~Public Functions~~~//
 
+		/// <summary>
+		/// Runs parallel CTR transforms from many threads at once, and checks the output and the concurrency governor accounting
+		/// </summary>
+		void Concurrent();
+
+		/// <summary>
+		/// Runs a parallel transform on a user installed executor, and compares the output with the sequential transform
+		/// </summary>
+		/// 
+		/// <param name="Cipher">The cipher instance pointer</param>
+		void Executor(ICipherMode* Cipher);
+
+		/// <summary>
+		/// Forces hybrid processor segmentation, and compares the segmented parallel output with the sequential output
+		/// </summary>
+		/// 
+		/// <param name="Cipher">The cipher instance pointer</param>
+		/// <param name="Encryption">Test encryption or decryption output</param>
+		void Hybrid(ICipherMode* Cipher, bool Encryption);
+
+		/// <summary>
+		/// Compares the pointer forms of the block and segmented transforms, out of place and in place, with the vector transforms in a looping [TEST_CYCLES] test
+		/// </summary>
+		/// 
+		/// <param name="Cipher">The cipher instance pointer</param>
+		void Pointer(ICipherMode* Cipher);
+
+		/// <summary>
+		/// Compares packet sized transforms through the background key-stream cache with the uncached output, across rekeying, seeks, and enabling or disabling the cache mid-stream, in a looping [TEST_CYCLES] test
+		/// </summary>
+		/// 
+		/// <param name="Cipher">The counter mode instance pointer</param>
+		template <typename T>
+		void Precompute(T* Cipher);
+
 		/// <summary>
 		/// Start the tests
 		/// </summary>
 		std::string Run() override;
 
+		/// <summary>
+		/// Tests random access decryption with TransformAt and Seek against a sequentially encrypted stream in a looping [TEST_CYCLES] test
+		/// </summary>
+		/// 
+		/// <param name="Cipher">The counter mode instance pointer</param>
+		template <typename T>
+		void Seek(T* Cipher);
+
 		/// <summary>
 		/// Compares synchronous to parallel processed random-sized, pseudo-random array transformations and their inverse in a looping [TEST_CYCLES] stress-test
 		/// </summary>
@@ -73,6 +117,11 @@ namespace Test
 		/// <param name="Encryption">Test encryption or decryption output</param>
 		void Stress(ICipherMode* Cipher, bool Encryption);
 
+		/// <summary>
+		/// Test calibration, and the save and reload of the host profile, and that a new instance starts from the stored block size
+		/// </summary>
+		void Tuning();
+
 	private:
 
 		void OnProgress(const std::string &Data);
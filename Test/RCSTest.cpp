@@ -99,6 +99,10 @@ namespace Test
 			MonteCarlo(rcss, m_message[0], m_key[0], m_nonce[0], m_monte[0]);
 			OnProgress(std::string("RCSTest: Passed RCS-256/512 monte carlo tests.."));
 
+			// decrypt windows of an encrypted stream at random positions
+			Seek(rcss);
+			OnProgress(std::string("RCSTest: Passed RCS-256/512 random access transform and seek tests.."));
+
 			// compare parallel output with sequential for equality
 			Parallel(rcss);
 			OnProgress(std::string("RCSTest: Passed RCS-256/512 parallel to sequential equivalence test.."));
@@ -468,6 +472,83 @@ namespace Test
 		}
 	}
 
+	void RCSTest::Seek(IStreamCipher* Cipher)
+	{
+		const size_t MSGLEN = (Cipher->ParallelBlockSize() * 2) + 1000;
+		Cipher::SymmetricKeySize ks = Cipher->LegalKeySizes()[0];
+		std::vector<uint8_t> cpt(MSGLEN);
+		std::vector<uint8_t> inp(MSGLEN);
+		std::vector<uint8_t> key(ks.KeySize());
+		std::vector<uint8_t> nonce(ks.IVSize());
+		std::vector<uint8_t> otp(MSGLEN);
+		Prng::SecureRandom rnd;
+		size_t plen;
+		size_t pos;
+
+		for (size_t i = 0; i < TEST_CYCLES; ++i)
+		{
+			rnd.Generate(key, 0, key.size());
+			rnd.Generate(nonce, 0, nonce.size());
+			rnd.Generate(inp, 0, MSGLEN);
+			SymmetricKey kp(key, nonce);
+
+			// encrypt the whole stream
+			Cipher->Initialize(true, kp);
+			Cipher->ParallelProfile().IsParallel() = true;
+			Cipher->Transform(inp, 0, cpt, 0, MSGLEN);
+
+			// decrypt a random window at an unaligned position
+			pos = static_cast<size_t>(rnd.NextUInt32(static_cast<uint32_t>(MSGLEN - 1), 0));
+			plen = static_cast<size_t>(rnd.NextUInt32(static_cast<uint32_t>(MSGLEN - pos), 1));
+			MemoryTools::Clear(otp, 0, otp.size());
+			Cipher->Initialize(false, kp);
+			Cipher->TransformAt(pos, cpt, pos, otp, pos, plen);
+
+			if (IntegerTools::Compare(inp, pos, otp, pos, plen) == false)
+			{
+				throw TestException(std::string("Seek"), Cipher->Name(), std::string("Cipher output is not equal! -TK1"));
+			}
+
+			// decrypt the stream as two disjoint ranges, in reverse order
+			MemoryTools::Clear(otp, 0, otp.size());
+			Cipher->Initialize(false, kp);
+			Cipher->TransformAt(pos, cpt, pos, otp, pos, MSGLEN - pos);
+			Cipher->TransformAt(0, cpt, 0, otp, 0, pos);
+
+			if (otp != inp)
+			{
+				throw TestException(std::string("Seek"), Cipher->Name(), std::string("Cipher output is not equal! -TK2"));
+			}
+
+			// seek to a block aligned position and continue with a standard transform
+			pos -= (pos % 128);
+			MemoryTools::Clear(otp, 0, otp.size());
+			Cipher->Initialize(false, kp);
+			Cipher->Seek(pos);
+			Cipher->Transform(cpt, pos, otp, pos, MSGLEN - pos);
+
+			if (IntegerTools::Compare(inp, pos, otp, pos, MSGLEN - pos) == false)
+			{
+				throw TestException(std::string("Seek"), Cipher->Name(), std::string("Cipher output is not equal! -TK3"));
+			}
+
+			// an unaligned seek must be rejected
+			try
+			{
+				Cipher->Seek(pos + 1);
+
+				throw TestException(std::string("Seek"), Cipher->Name(), std::string("Exception handling failure! -TK4"));
+			}
+			catch (CryptoSymmetricException const &)
+			{
+			}
+			catch (TestException const &)
+			{
+				throw;
+			}
+		}
+	}
+
 	void RCSTest::Sequential(IStreamCipher* Cipher, const std::vector<uint8_t> &Message, std::vector<uint8_t> &Key, std::vector<uint8_t> &Nonce,
 		const std::vector<uint8_t> &Output1, const std::vector<uint8_t> &Output2, const std::vector<uint8_t> &Output3)
 	{
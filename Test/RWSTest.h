@@ -138,6 +138,13 @@ namespace Test
 		/// <param name="Cipher">The cipher instance pointer</param>
 		void Parallel(IStreamCipher* Cipher);
 
+		/// <summary>
+		/// Tests random access decryption with TransformAt and Seek against a sequentially encrypted stream in a looping [TEST_CYCLES] test
+		/// </summary>
+		/// 
+		/// <param name="Cipher">The cipher instance pointer</param>
+		void Seek(IStreamCipher* Cipher);
+
 		/// <summary>
 		/// Tests the the ciphers state serialization function
 		/// </summary>
@@ -3,12 +3,15 @@
 #include "../CEX/IntegerTools.h"
 #include "../CEX/RHX.h"
 #include "../CEX/SecureRandom.h"
+#include "../CEX/SimdDispatch.h"
 
 namespace Test
 {
 	using Cipher::Block::Mode::CTR;
 	using Tools::IntegerTools;
 	using Prng::SecureRandom;
+	using Enumeration::SimdProfiles;
+	using Tools::SimdDispatch;
 	using namespace Cipher::Block;
 
 	const std::string RijndaelTest::CLASSNAME = "RijndaelTest";
@@ -119,6 +122,18 @@ namespace Test
 
 			OnProgress(std::string("RijndaelTest: Passed Rijndael extended Monte Carlo tests.."));
 
+			RHX* cpr12 = new RHX();
+			Dispatch(cpr12);
+			delete cpr12;
+			RHX* cpr13 = new RHX(BlockCipherExtensions::HKDF512);
+			Dispatch(cpr13);
+			delete cpr13;
+
+			OnProgress(std::string("RijndaelTest: Passed Rijndael SIMD kernel dispatch tests.."));
+
+			Batch();
+			OnProgress(std::string("RijndaelTest: Passed Rijndael multi-key batch encryption tests.."));
+
 			CTR* cpr11 = new CTR(BlockCiphers::AES);
 			Parallel(cpr11);
 			OnProgress(std::string("RijndaelTest: Passed Rijndael parallel to sequential equivalence test.."));
@@ -143,6 +158,143 @@ namespace Test
 		}
 	}
 
+	void RijndaelTest::Batch()
+	{
+		// an odd count exercises the partial lane group
+		const size_t BLKCNT = 37;
+		std::vector<uint8_t> blk(16);
+		std::vector<uint8_t> exp(BLKCNT * 16);
+		std::vector<uint8_t> inp(BLKCNT * 16);
+		std::vector<uint8_t> otp(BLKCNT * 16);
+		SecureRandom rnd;
+		RHX cpr;
+		size_t i;
+		size_t j;
+		size_t klen;
+		bool thr;
+
+		for (i = 0; i < 2; ++i)
+		{
+			klen = (i == 0) ? 16 : 32;
+			SecureVector<uint8_t> keys(BLKCNT * klen);
+			rnd.Generate(keys, 0, keys.size());
+			rnd.Generate(inp, 0, inp.size());
+
+			for (j = 0; j < BLKCNT; ++j)
+			{
+				SymmetricKey kp(std::vector<uint8_t>(keys.begin() + (j * klen), keys.begin() + ((j + 1) * klen)));
+				cpr.Initialize(true, kp);
+				cpr.EncryptBlock(inp, j * 16, exp, j * 16);
+			}
+
+			RHX::EncryptBatch(keys, klen, inp, 0, otp, 0, BLKCNT);
+
+			if (otp != exp)
+			{
+				throw TestException(std::string("Batch"), cpr.Name(), std::string("The batch output is not equal! -RB1"));
+			}
+
+			// a single key, and an offset output
+			std::vector<uint8_t> otp2(32);
+			RHX::EncryptBatch(keys, klen, inp, 0, otp2, 16, 1);
+
+			if (!std::equal(otp2.begin() + 16, otp2.end(), exp.begin()))
+			{
+				throw TestException(std::string("Batch"), cpr.Name(), std::string("The single key batch output is not equal! -RB2"));
+			}
+		}
+
+		// 192-bit keys are not supported
+		thr = false;
+
+		try
+		{
+			SecureVector<uint8_t> keys(BLKCNT * 24);
+			RHX::EncryptBatch(keys, 24, inp, 0, otp, 0, BLKCNT);
+		}
+		catch (CryptoSymmetricException const &)
+		{
+			thr = true;
+		}
+
+		if (!thr)
+		{
+			throw TestException(std::string("Batch"), cpr.Name(), std::string("The invalid key size was accepted! -RB3"));
+		}
+	}
+
+	void RijndaelTest::Dispatch(IBlockCipher* Cipher)
+	{
+		const size_t MSGLEN = 256;
+		std::vector<Cipher::SymmetricKeySize> ks = Cipher->LegalKeySizes();
+		SimdDispatch &dsp = SimdDispatch::Instance();
+		std::vector<uint8_t> cpt1(MSGLEN);
+		std::vector<uint8_t> cpt2(MSGLEN);
+		std::vector<uint8_t> inp(MSGLEN);
+		std::vector<uint8_t> otp(MSGLEN);
+		SecureRandom rnd;
+		size_t i;
+		size_t j;
+		size_t k;
+
+		for (i = 0; i < ks.size(); ++i)
+		{
+			SymmetricKey kp(rnd.Generate(ks[i].KeySize()));
+			rnd.Generate(inp, 0, MSGLEN);
+
+			// the single block transform is the reference
+			Cipher->Initialize(true, kp);
+
+			for (j = 0; j < MSGLEN; j += 16)
+			{
+				Cipher->Transform(inp, j, cpt1, j);
+			}
+
+			for (k = 0; k <= static_cast<size_t>(dsp.Detected()); ++k)
+			{
+				dsp.SetProfile(static_cast<SimdProfiles>(k));
+
+				Cipher->Initialize(true, kp);
+				Cipher->Transform2048(inp, 0, cpt2, 0);
+
+				if (cpt1 != cpt2)
+				{
+					dsp.Reset();
+					throw TestException(std::string("Dispatch"), Cipher->Name(), std::string("The 2048-bit transform output is not equal! -RD1"));
+				}
+
+				Cipher->Transform1024(inp, 0, cpt2, 0);
+				Cipher->Transform1024(inp, 128, cpt2, 128);
+
+				if (cpt1 != cpt2)
+				{
+					dsp.Reset();
+					throw TestException(std::string("Dispatch"), Cipher->Name(), std::string("The 1024-bit transform output is not equal! -RD2"));
+				}
+
+				Cipher->Initialize(false, kp);
+				Cipher->Transform2048(cpt1, 0, otp, 0);
+
+				if (otp != inp)
+				{
+					dsp.Reset();
+					throw TestException(std::string("Dispatch"), Cipher->Name(), std::string("The 2048-bit inverse transform output is not equal! -RD3"));
+				}
+
+				Cipher->Transform1024(cpt1, 0, otp, 0);
+				Cipher->Transform1024(cpt1, 128, otp, 128);
+
+				if (otp != inp)
+				{
+					dsp.Reset();
+					throw TestException(std::string("Dispatch"), Cipher->Name(), std::string("The 1024-bit inverse transform output is not equal! -RD4"));
+				}
+			}
+
+			dsp.Reset();
+		}
+	}
+
 	void RijndaelTest::Exception()
 	{
 		// test initialization with illegal key input size
@@ -68,6 +68,18 @@ namespace Test
 		/// </summary>
 		std::string Run() override;
 
+		/// <summary>
+		/// Compare the multi-key batch encryption with a cipher instance per key
+		/// </summary>
+		void Batch();
+
+		/// <summary>
+		/// Compare the wide transforms of every SIMD kernel variant supported by the host with the single block transform
+		/// </summary>
+		/// 
+		/// <param name="Cipher">The cipher instance pointer</param>
+		void Dispatch(IBlockCipher* Cipher);
+
 		/// <summary>
 		/// Test exception handlers for correct execution
 		/// </summary>
@@ -1,15 +1,12 @@
 #include "SHA3Test.h"
 #include "../CEX/IntegerTools.h"
 #include "../CEX/Keccak.h"
+#include "../CEX/KeccakKernels.h"
 #include "../CEX/SHA3256.h"
 #include "../CEX/SHA3512.h"
 #include "../CEX/MemoryTools.h"
 #include "../CEX/SecureRandom.h"
-#if defined(__AVX512__)
-#	include "../CEX/ULong512.h"
-#elif defined(__AVX2__)
-#	include "../CEX/ULong256.h"
-#endif
+#include "../CEX/SimdDispatch.h"
 
 namespace Test
 {
@@ -19,11 +16,8 @@ namespace Test
 	using Prng::SecureRandom;
 	using Cipher::SymmetricKey;
 	using namespace Digest;
-#if defined(__AVX512__)
-	using Numeric::ULong512;
-#elif defined(__AVX2__)
-	using Numeric::ULong256;
-#endif
+	using Enumeration::SimdProfiles;
+	using Tools::SimdDispatch;
 
 	const std::string SHA3Test::CLASSNAME = "SHA3Test";
 	const std::string SHA3Test::DESCRIPTION = "SHA-3 Vector KATs; tests the 256, 512, and 1024 versions of Keccak.";
@@ -308,41 +302,67 @@ namespace Test
 			throw TestException(std::string("PermutationR24"), std::string("PermuteR24P1600"), std::string("Permutation output is not equal!"));
 		}
 
-#if defined(__AVX512__)
+		const SimdProfiles DETPRF = SimdDispatch::Instance().Detected();
 
-		std::vector<ULong512> state512(25, ULong512(0));
+		// every kernel compiled into the library and supported by the host is compared with the scalar permutation
+		if (KeccakKernels::HasAvx512() && DETPRF >= SimdProfiles::Simd512)
+		{
+			std::vector<uint64_t> state512(200, 0);
 
-		Keccak::PermuteR24P8x1600H(state512);
+			KeccakKernels::PermuteR24P8x1600H(state512.data(), 24);
 
-		std::vector<uint64_t> state512ull(200);
-		std::memcpy(state512ull.data(), state512.data(), 200 * sizeof(uint64_t));
+			for (size_t i = 0; i < 200; ++i)
+			{
+				if (state512[i] != state1[i / 8])
+				{
+					throw TestException(std::string("PermutationR24"), std::string("PermuteR24P8x1600H"), std::string("Permutation output is not equal!"));
+				}
+			}
+		}
 
-		for (size_t i = 0; i < 25; ++i)
+		if (KeccakKernels::HasAvx2() && DETPRF >= SimdProfiles::Simd256)
 		{
-			if (state512ull[i] != state1[i / 8])
+			std::vector<uint64_t> state256(100, 0);
+
+			KeccakKernels::PermuteR24P4x1600H(state256.data(), 24);
+
+			for (size_t i = 0; i < 100; ++i)
 			{
-				throw TestException(std::string("PermutationR24"), std::string("PermuteR24P8x1600H"), std::string("Permutation output is not equal!"));
+				if (state256[i] != state1[i / 4])
+				{
+					throw TestException(std::string("PermutationR24"), std::string("PermuteR24P4x1600H"), std::string("Permutation output is not equal!"));
+				}
 			}
-		}
 
-#elif defined(__AVX2__)
+			// the four lane shake absorb and squeeze must match the sequential functions
+			std::vector<std::vector<uint8_t>> msg(4, std::vector<uint8_t>(34));
+			std::vector<std::vector<uint8_t>> otp(4, std::vector<uint8_t>(2 * Keccak::KECCAK128_RATE_SIZE));
+			std::vector<uint8_t> exp(2 * Keccak::KECCAK128_RATE_SIZE);
+			std::array<uint64_t, 25> state3;
+			SecureRandom rnd;
 
-		std::vector<ULong256> state256(25, ULong256(0));
+			MemoryTools::Clear(state256, 0, state256.size() * sizeof(uint64_t));
 
-		Keccak::PermuteR24P4x1600H(state256);
+			for (size_t i = 0; i < 4; ++i)
+			{
+				rnd.Generate(msg[i]);
+			}
 
-		std::vector<uint64_t> state256ull(100);
-		std::memcpy(state256ull.data(), state256.data(), 100 * sizeof(uint64_t));
+			KeccakKernels::AbsorbR24x1600H(state256.data(), Keccak::KECCAK128_RATE_SIZE, msg[0].data(), msg[1].data(), msg[2].data(), msg[3].data(), msg[0].size(), Keccak::KECCAK_SHAKE_DOMAIN);
+			KeccakKernels::SqueezeBlocksR24x1600H(state256.data(), Keccak::KECCAK128_RATE_SIZE, otp[0].data(), otp[1].data(), otp[2].data(), otp[3].data(), 2);
 
-		for (size_t i = 0; i < 25; ++i)
-		{
-			if (state256ull[i] != state1[i / 4])
+			for (size_t i = 0; i < 4; ++i)
 			{
-				throw TestException(std::string("PermutationR24"), std::string("PermuteR24P4x1600H"), std::string("Permutation output is not equal!"));
+				MemoryTools::Clear(state3, 0, state3.size() * sizeof(uint64_t));
+				Keccak::Absorb(msg[i], 0, msg[i].size(), Keccak::KECCAK128_RATE_SIZE, Keccak::KECCAK_SHAKE_DOMAIN, state3);
+				Keccak::Squeeze(state3, exp, 0, 2, Keccak::KECCAK128_RATE_SIZE);
+
+				if (otp[i] != exp)
+				{
+					throw TestException(std::string("PermutationR24"), std::string("SqueezeBlocksR24x1600H"), std::string("Absorb and squeeze output is not equal!"));
+				}
 			}
 		}
-
-#endif
 	}
 
 	void SHA3Test::PermutationR48()
@@ -361,41 +381,38 @@ namespace Test
 			throw TestException(std::string("PermutationR48"), std::string("PermuteR48P1600"), std::string("Permutation output is not equal!"));
 		}
 
-#if defined(__AVX512__)
-
-		std::vector<ULong512> state512(25, ULong512(0));
+		const SimdProfiles DETPRF = SimdDispatch::Instance().Detected();
 
-		Keccak::PermuteR48P8x1600H(state512);
+		// every kernel compiled into the library and supported by the host is compared with the scalar permutation
+		if (KeccakKernels::HasAvx512() && DETPRF >= SimdProfiles::Simd512)
+		{
+			std::vector<uint64_t> state512(200, 0);
 
-		std::vector<uint64_t> state512ull(200);
-		MemoryTools::Copy(state512, 0, state512ull, 0, 200 * sizeof(uint64_t));
+			KeccakKernels::PermuteR48P8x1600H(state512.data());
 
-		for (size_t i = 0; i < 25; ++i)
-		{
-			if (state512ull[i] != state1[i / 8])
+			for (size_t i = 0; i < 200; ++i)
 			{
-				throw TestException(std::string("PermutationR48"), std::string("PermuteR48P8x1600H"), std::string("Permutation output is not equal!"));
+				if (state512[i] != state1[i / 8])
+				{
+					throw TestException(std::string("PermutationR48"), std::string("PermuteR48P8x1600H"), std::string("Permutation output is not equal!"));
+				}
 			}
 		}
 
-#elif defined(__AVX2__)
-
-		std::vector<ULong256> state256(25, ULong256(0));
-
-		Keccak::PermuteR48P4x1600H(state256);
+		if (KeccakKernels::HasAvx2() && DETPRF >= SimdProfiles::Simd256)
+		{
+			std::vector<uint64_t> state256(100, 0);
 
-		std::vector<uint64_t> state256ull(100);
-		MemoryTools::Copy(state256, 0, state256ull, 0, 100 * sizeof(uint64_t));
+			KeccakKernels::PermuteR48P4x1600H(state256.data());
 
-		for (size_t i = 0; i < 25; ++i)
-		{
-			if (state256ull[i] != state1[i / 4])
+			for (size_t i = 0; i < 100; ++i)
 			{
-				throw TestException(std::string("PermutationR48"), std::string("PermuteR48P4x1600H"), std::string("Permutation output is not equal!"));
+				if (state256[i] != state1[i / 4])
+				{
+					throw TestException(std::string("PermutationR48"), std::string("PermuteR48P4x1600H"), std::string("Permutation output is not equal!"));
+				}
 			}
 		}
-
-#endif
 	}
 
 	void SHA3Test::Stress(IDigest* Digest)
@@ -3,12 +3,15 @@
 #include "../CEX/SHX.h"
 #include "../CEX/IntegerTools.h"
 #include "../CEX/SecureRandom.h"
+#include "../CEX/SimdDispatch.h"
 
 namespace Test
 {
 	using Cipher::Block::Mode::CTR;
 	using Tools::IntegerTools;
 	using Prng::SecureRandom;
+	using Enumeration::SimdProfiles;
+	using Tools::SimdDispatch;
 	using namespace Cipher::Block;
 	using namespace TestFiles::Nessie;
  
@@ -93,6 +96,15 @@ namespace Test
 			delete cpr8;
 			OnProgress(std::string("SerpentTest: Passed SHX monte carlo known answer tests.."));
 
+			SHX* cpr9 = new SHX();
+			Dispatch(cpr9);
+			delete cpr9;
+			SHX* cpr10 = new SHX(BlockCipherExtensions::HKDF512);
+			Dispatch(cpr10);
+			delete cpr10;
+
+			OnProgress(std::string("SerpentTest: Passed Serpent SIMD kernel dispatch tests.."));
+
 			CTR* cpr = new CTR(BlockCiphers::Serpent);
 			Parallel(cpr);
 			OnProgress(std::string("SerpentTest: Passed Serpent parallel to sequential equivalence test.."));
@@ -117,6 +129,80 @@ namespace Test
 		}
 	}
 
+	void SerpentTest::Dispatch(IBlockCipher* Cipher)
+	{
+		const size_t MSGLEN = 256;
+		std::vector<Cipher::SymmetricKeySize> ks = Cipher->LegalKeySizes();
+		SimdDispatch &dsp = SimdDispatch::Instance();
+		std::vector<uint8_t> cpt1(MSGLEN);
+		std::vector<uint8_t> cpt2(MSGLEN);
+		std::vector<uint8_t> inp(MSGLEN);
+		std::vector<uint8_t> otp(MSGLEN);
+		SecureRandom rnd;
+		size_t i;
+		size_t j;
+		size_t k;
+
+		for (i = 0; i < ks.size(); ++i)
+		{
+			SymmetricKey kp(rnd.Generate(ks[i].KeySize()));
+			rnd.Generate(inp, 0, MSGLEN);
+
+			// the single block transform is the reference
+			Cipher->Initialize(true, kp);
+
+			for (j = 0; j < MSGLEN; j += 16)
+			{
+				Cipher->Transform(inp, j, cpt1, j);
+			}
+
+			for (k = 0; k <= static_cast<size_t>(dsp.Detected()); ++k)
+			{
+				dsp.SetProfile(static_cast<SimdProfiles>(k));
+
+				Cipher->Initialize(true, kp);
+				Cipher->Transform2048(inp, 0, cpt2, 0);
+
+				if (cpt1 != cpt2)
+				{
+					dsp.Reset();
+					throw TestException(std::string("Dispatch"), Cipher->Name(), std::string("The 2048-bit transform output is not equal! -SD1"));
+				}
+
+				for (j = 0; j < MSGLEN; j += 64)
+				{
+					Cipher->Transform512(inp, j, cpt2, j);
+				}
+
+				if (cpt1 != cpt2)
+				{
+					dsp.Reset();
+					throw TestException(std::string("Dispatch"), Cipher->Name(), std::string("The 512-bit transform output is not equal! -SD2"));
+				}
+
+				Cipher->Initialize(false, kp);
+				Cipher->Transform2048(cpt1, 0, otp, 0);
+
+				if (otp != inp)
+				{
+					dsp.Reset();
+					throw TestException(std::string("Dispatch"), Cipher->Name(), std::string("The 2048-bit inverse transform output is not equal! -SD3"));
+				}
+
+				Cipher->Transform1024(cpt1, 0, otp, 0);
+				Cipher->Transform1024(cpt1, 128, otp, 128);
+
+				if (otp != inp)
+				{
+					dsp.Reset();
+					throw TestException(std::string("Dispatch"), Cipher->Name(), std::string("The 1024-bit inverse transform output is not equal! -SD4"));
+				}
+			}
+
+			dsp.Reset();
+		}
+	}
+
 	void SerpentTest::Exception()
 	{
 		// test initialization with illegal key input size
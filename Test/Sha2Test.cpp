@@ -5,16 +5,8 @@
 #include "../CEX/SHA2.h"
 #include "../CEX/SHA2256.h"
 #include "../CEX/SHA2512.h"
-
-#if defined(__AVX2__)
-#	include "../CEX/UInt256.h"
-#	include "../CEX/ULong256.h"
-#endif
-
-#if defined(__AVX512__)
-#	include "../CEX/UInt512.h"
-#	include "../CEX/ULong512.h"
-#endif
+#include "../CEX/SHA2Kernels.h"
+#include "../CEX/SimdDispatch.h"
 
 namespace Test
 {
@@ -22,15 +14,10 @@ namespace Test
 	using Tools::IntegerTools;
 	using Tools::MemoryTools;
 	using Prng::SecureRandom;
-#if defined(__AVX2__)
-	using Numeric::UInt256;
-	using Numeric::ULong256;
-#endif
-#if defined(__AVX512__)
-	using Numeric::UInt512;
-	using Numeric::ULong512;
-#endif
+	using Enumeration::SimdProfiles;
+	using Tools::SimdDispatch;
 	using Digest::SHA2;
+	using Digest::SHA2Kernels;
 	using Digest::SHA2256;
 	using Digest::SHA2512; 
 	using Digest::SHA2Params;
@@ -402,43 +389,66 @@ namespace Test
 			throw TestException(std::string("PermutationR64"), std::string("PermuteR64P512"), std::string("Permutation output is not equal!"));
 		}
 
-#if defined(__AVX512__)
+		const SimdProfiles DETPRF = SimdDispatch::Instance().Detected();
 
-		std::vector<uint8_t> input512(1024, 128U);
-		std::vector<UInt512> state512(8, UInt512(0));
+		// every kernel compiled into the library and supported by the host is compared with the scalar permutation
+		if (SHA2Kernels::HasAvx512() && DETPRF >= SimdProfiles::Simd512)
+		{
+			std::vector<uint8_t> input512(16 * 64);
+			std::vector<uint32_t> state512(8 * 16, 0);
+			std::array<uint32_t, 8> statel;
 
-		SHA2::PermuteR64P16x512H(input512, 0, state512);
+			// a different block in each lane, so every lane offset is checked
+			for (size_t i = 0; i < input512.size(); ++i)
+			{
+				input512[i] = static_cast<uint8_t>(i + (i / 64));
+			}
 
-		std::vector<uint32_t> state512ul(64);
-		std::memcpy(state512ul.data(), state512.data(), 64 * sizeof(uint32_t));
+			SHA2Kernels::PermuteR64P16x512H(input512.data(), state512.data());
 
-		for (size_t i = 0; i < 64; ++i)
-		{
-			if (state512ul[i] != state1[i / 16])
+			for (size_t i = 0; i < 16; ++i)
 			{
-				throw TestException(std::string("PermutationR64"), std::string("PermuteR64P16x512H"), std::string("Permutation output is not equal!"));
+				MemoryTools::Clear(statel, 0, 8 * sizeof(uint32_t));
+				SHA2::PermuteR64P512U(input512, i * 64, statel);
+
+				for (size_t j = 0; j < 8; ++j)
+				{
+					if (state512[(j * 16) + i] != statel[j])
+					{
+						throw TestException(std::string("PermutationR64"), std::string("PermuteR64P16x512H"), std::string("Permutation output is not equal!"));
+					}
+				}
 			}
 		}
 
-#elif defined(__AVX2__)
-
-		std::vector<uint8_t> input256(512, 128U);
-		std::vector<UInt256> state256(8, UInt256(0));
+		if (SHA2Kernels::HasAvx2() && DETPRF >= SimdProfiles::Simd256)
+		{
+			std::vector<uint8_t> input256(8 * 64);
+			std::vector<uint32_t> state256(8 * 8, 0);
+			std::array<uint32_t, 8> statel;
 
-		SHA2::PermuteR64P8x512H(input256, 0, state256);
+			// a different block in each lane, so every lane offset is checked
+			for (size_t i = 0; i < input256.size(); ++i)
+			{
+				input256[i] = static_cast<uint8_t>(i + (i / 64));
+			}
 
-		std::vector<uint32_t> state256ul(32);
-		std::memcpy(state256ul.data(), state256.data(), 32 * sizeof(uint32_t));
+			SHA2Kernels::PermuteR64P8x512H(input256.data(), state256.data());
 
-		for (size_t i = 0; i < 32; ++i)
-		{
-			if (state256ul[i] != state1[i / 8])
+			for (size_t i = 0; i < 8; ++i)
 			{
-				throw TestException(std::string("PermutationR64"), std::string("PermuteR64P8x512H"), std::string("Permutation output is not equal!"));
+				MemoryTools::Clear(statel, 0, 8 * sizeof(uint32_t));
+				SHA2::PermuteR64P512U(input256, i * 64, statel);
+
+				for (size_t j = 0; j < 8; ++j)
+				{
+					if (state256[(j * 8) + i] != statel[j])
+					{
+						throw TestException(std::string("PermutationR64"), std::string("PermuteR64P8x512H"), std::string("Permutation output is not equal!"));
+					}
+				}
 			}
 		}
-
-#endif
 	}
 
 	void SHA2Test::PermutationR80()
@@ -458,43 +468,66 @@ namespace Test
 			throw TestException(std::string("PermutationR80"), std::string("PermuteR80P1024"), std::string("Permutation output is not equal! -SP1"));
 		}
 
-#if defined(__AVX512__)
+		const SimdProfiles DETPRF = SimdDispatch::Instance().Detected();
 
-		std::vector<uint8_t> input512(1024, 128U);
-		std::vector<ULong512> state512(8, ULong512(0));
+		// every kernel compiled into the library and supported by the host is compared with the scalar permutation
+		if (SHA2Kernels::HasAvx512() && DETPRF >= SimdProfiles::Simd512)
+		{
+			std::vector<uint8_t> input512(8 * 128);
+			std::vector<uint64_t> state512(8 * 8, 0);
+			std::array<uint64_t, 8> statel;
 
-		SHA2::PermuteR80P8x1024H(input512, 0, state512);
+			// a different block in each lane, so every lane offset is checked
+			for (size_t i = 0; i < input512.size(); ++i)
+			{
+				input512[i] = static_cast<uint8_t>(i + (i / 128));
+			}
 
-		std::vector<uint64_t> state512ull(64);
-		MemoryTools::Copy(state512, 0, state512ull, 0, 64 * sizeof(uint64_t));
+			SHA2Kernels::PermuteR80P8x1024H(input512.data(), state512.data());
 
-		for (size_t i = 0; i < 64; ++i)
-		{
-			if (state512ull[i] != state1[i / 8])
+			for (size_t i = 0; i < 8; ++i)
 			{
-				throw TestException(std::string("PermutationR80"), std::string("PermuteR80P8x1024H"), std::string("Permutation output is not equal! -SP3"));
+				MemoryTools::Clear(statel, 0, 8 * sizeof(uint64_t));
+				SHA2::PermuteR80P1024U(input512, i * 128, statel);
+
+				for (size_t j = 0; j < 8; ++j)
+				{
+					if (state512[(j * 8) + i] != statel[j])
+					{
+						throw TestException(std::string("PermutationR80"), std::string("PermuteR80P8x1024H"), std::string("Permutation output is not equal! -SP3"));
+					}
+				}
 			}
 		}
 
-#elif defined(__AVX2__)
-
-		std::vector<uint8_t> input256(512, 128U);
-		std::vector<ULong256> state256(8, ULong256(0));
+		if (SHA2Kernels::HasAvx2() && DETPRF >= SimdProfiles::Simd256)
+		{
+			std::vector<uint8_t> input256(4 * 128);
+			std::vector<uint64_t> state256(8 * 4, 0);
+			std::array<uint64_t, 8> statel;
 
-		SHA2::PermuteR80P4x1024H(input256, 0, state256);
+			// a different block in each lane, so every lane offset is checked
+			for (size_t i = 0; i < input256.size(); ++i)
+			{
+				input256[i] = static_cast<uint8_t>(i + (i / 128));
+			}
 
-		std::vector<uint64_t> state256ull(32);
-		MemoryTools::Copy(state256, 0, state256ull, 0, 32 * sizeof(uint64_t));
+			SHA2Kernels::PermuteR80P4x1024H(input256.data(), state256.data());
 
-		for (size_t i = 0; i < 32; ++i)
-		{
-			if (state256ull[i] != state1[i / 4])
+			for (size_t i = 0; i < 4; ++i)
 			{
-				throw TestException(std::string("PermutationR80"), std::string("PermuteR80P4x1024H"), std::string("Permutation output is not equal! -SP2"));
+				MemoryTools::Clear(statel, 0, 8 * sizeof(uint64_t));
+				SHA2::PermuteR80P1024U(input256, i * 128, statel);
+
+				for (size_t j = 0; j < 8; ++j)
+				{
+					if (state256[(j * 4) + i] != statel[j])
+					{
+						throw TestException(std::string("PermutationR80"), std::string("PermuteR80P4x1024H"), std::string("Permutation output is not equal! -SP2"));
+					}
+				}
 			}
 		}
-
-#endif
 	}
 
 	void SHA2Test::Stress(IDigest* Digest)
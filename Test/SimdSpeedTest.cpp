@@ -324,7 +324,7 @@ namespace Test
 		size_t i;
 
 		// Large Block Copy
-#if defined(CEX_AVX_INTRINSICS)
+#if defined(CEX_HAS_SSE2)
 
 		// sequential copy: 1KB uint8_t buffers
 		OnProgress(glen + std::string(" using 512 uint8_t buffers with sequential memcpy: "));
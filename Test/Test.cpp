@@ -7,6 +7,7 @@
 #include "../Test/TestUtils.h"
 #include "../Test/ACPTest.h"
 #include "../Test/AeadTest.h"
+#include "../Test/AllocationTest.h"
 #include "../Test/AesAvsTest.h"
 #include "../Test/AsymmetricKeyTest.h"
 #include "../Test/AsymmetricSpeedTest.h"
@@ -17,6 +18,7 @@
 #include "../Test/CSXTest.h"
 #include "../Test/CipherModeTest.h"
 #include "../Test/CipherSpeedTest.h"
+#include "../Test/CipherPipelineTest.h"
 #include "../Test/CipherStreamTest.h"
 #include "../Test/CJPTest.h"
 #include "../Test/CMACTest.h"
@@ -64,6 +66,8 @@
 #include "../Test/SphincsPlusTest.h"
 #include "../Test/SymmetricKeyGeneratorTest.h"
 #include "../Test/SymmetricKeyTest.h"
+#include "../Test/ThreadPoolTest.h"
+#include "../Test/TransformAsyncTest.h"
 #include "../Test/ThreefishTest.h"
 #include "../Test/UtilityTest.h"
 #include "../Test/XMSSTest.h"
@@ -307,27 +311,18 @@ int32_t main()
 	}
 	PrintHeader("", "");
 
+	// the library is built for an sse baseline, the wide kernels are selected at run-time
 	if (hasAvx2)
 	{
-#if !defined(CEX_HAS_AVX2)
-		PrintHeader("Warning! AVX2 support was detected! Set the enhanced instruction set to arch:AVX2 for best performance.");
-#else
-		PrintHeader("AVX2 intrinsics support has been enabled.");
-#endif
+		PrintHeader("AVX2 intrinsics support has been detected, the AVX2 kernels are enabled.");
 	}
 	else if (hasAvx)
 	{
-#if defined(CEX_HAS_AVX2)
-		PrintHeader("AVX2 is not supported on this system! AVX intrinsics support is available, set enable enhanced instruction set to arch:AVX");
-#elif !defined(CEX_HAS_AVX)
-		PrintHeader("AVX intrinsics support has been detected, set enhanced instruction set to arch:AVX for best performance.");
-#else
-		PrintHeader("AVX intrinsics support has been enabled.");
-#endif
+		PrintHeader("AVX intrinsics support has been detected, the AVX kernels are enabled.");
 	}
 	else
 	{
-		PrintHeader("The minimum SIMD intrinsics support (AVX) was not detected, intrinsics have been disabled!");
+		PrintHeader("AVX support was not detected, the SSE and sequential implementations are used.");
 	}
 	PrintHeader("", "");
 
@@ -342,7 +337,7 @@ int32_t main()
 		{
 			PrintHeader("TESTING SYMMETRIC BLOCK CIPHERS");
 
-#if defined(CEX_HAS_AVX)
+#if defined(CEX_HAS_AESNI)
 			if (hasAesni)
 			{
 				PrintHeader("Testing the AES-NI implementation (AES-NI)");
@@ -353,7 +348,7 @@ int32_t main()
 			PrintHeader("Testing the AES software implementation (AES)");
 			TestRun(new AesAvsTest());
 
-#if defined(CEX_HAS_AVX)
+#if defined(CEX_HAS_AESNI)
 			if (hasAesni)
 			{
 				PrintHeader("Testing the AES-NI implementation (AES-NI)");
@@ -371,6 +366,7 @@ int32_t main()
 			TestRun(new AeadTest());
 			PrintHeader("TESTING PARALLEL CIPHER MODES");
 			TestRun(new ParallelModeTest());
+			TestRun(new AllocationTest());
 			PrintHeader("TESTING CIPHER PADDING MODES");
 			TestRun(new PaddingTest());
 			PrintHeader("TESTING SYMMETRIC STREAM CIPHERS");
@@ -380,6 +376,7 @@ int32_t main()
 			TestRun(new RWSTest());
 			TestRun(new ThreefishTest());
 			PrintHeader("TESTING CRYPTOGRAPHIC STREAM PROCESSORS");
+			TestRun(new CipherPipelineTest());
 			TestRun(new CipherStreamTest());
 			TestRun(new DigestStreamTest());
 			TestRun(new MacStreamTest());
@@ -427,6 +424,8 @@ int32_t main()
 			TestRun(new MemUtilsTest());
 			TestRun(new SimdWrapperTest());
 			PrintHeader("TESTING UTILITY CLASS FUNCTIONS");
+			TestRun(new ThreadPoolTest());
+			TestRun(new TransformAsyncTest());
 			TestRun(new UtilityTest());
 			PrintHeader("TESTING ASYMMETRIC CIPHERS");
 			TestRun(new ECDHTest());
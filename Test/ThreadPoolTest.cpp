@@ -0,0 +1,218 @@
+#include "ThreadPoolTest.h"
+#include "../CEX/ThreadPool.h"
+#include <array>
+#include <atomic>
+#include <thread>
+
+namespace Test
+{
+	using CEX::TaskFuture;
+	using CEX::ThreadPool;
+
+	const std::string ThreadPoolTest::CLASSNAME = "ThreadPoolTest";
+	const std::string ThreadPoolTest::DESCRIPTION = "ThreadPool test; tests task futures, batches, exception propagation, and high-rate submission.";
+	const std::string ThreadPoolTest::SUCCESS = "SUCCESS! All ThreadPool tests have executed succesfully.";
+
+	ThreadPoolTest::ThreadPoolTest()
+		:
+		m_progressEvent()
+	{
+	}
+
+	ThreadPoolTest::~ThreadPoolTest()
+	{
+	}
+
+	const std::string ThreadPoolTest::Description()
+	{
+		return DESCRIPTION;
+	}
+
+	TestEventHandler &ThreadPoolTest::Progress()
+	{
+		return m_progressEvent;
+	}
+
+	std::string ThreadPoolTest::Run()
+	{
+		try
+		{
+			Future();
+			OnProgress(std::string("ThreadPoolTest: Passed task future and exception tests.."));
+			Batch();
+			OnProgress(std::string("ThreadPoolTest: Passed task batch tests.."));
+			Stress();
+			OnProgress(std::string("ThreadPoolTest: Passed concurrent submission stress tests.."));
+
+			return SUCCESS;
+		}
+		catch (TestException const &ex)
+		{
+			throw TestException(CLASSNAME, ex.Function(), ex.Origin(), ex.Message());
+		}
+		catch (CryptoException &ex)
+		{
+			throw TestException(CLASSNAME, ex.Location(), ex.Origin(), ex.Message());
+		}
+		catch (std::exception const &ex)
+		{
+			throw TestException(CLASSNAME, std::string("Unknown Origin"), std::string(ex.what()));
+		}
+	}
+
+	void ThreadPoolTest::Batch()
+	{
+		const size_t BCHLEN = 1000;
+		ThreadPool pool(4, 64);
+		std::vector<std::atomic<size_t>> cnt(BCHLEN);
+		TaskFuture<void> ftr;
+		size_t i;
+		bool thr;
+
+		for (i = 0; i < BCHLEN; ++i)
+		{
+			cnt[i] = 0;
+		}
+
+		// more tasks than queue slots; the producer drains the queue when it is full
+		ftr = pool.SubmitBatch(BCHLEN, [&cnt](size_t Index) { ++cnt[Index]; });
+		ftr.Get();
+
+		for (i = 0; i < BCHLEN; ++i)
+		{
+			if (cnt[i] != 1)
+			{
+				throw TestException(std::string("Batch"), std::string("SubmitBatch"), std::string("The batch index did not run exactly once! -TB1"));
+			}
+		}
+
+		thr = false;
+		ftr = pool.SubmitBatch(BCHLEN, [](size_t Index)
+		{
+			if (Index == BCHLEN / 2)
+			{
+				throw std::runtime_error("batch task");
+			}
+		});
+
+		try
+		{
+			ftr.Get();
+		}
+		catch (std::runtime_error const &)
+		{
+			thr = true;
+		}
+
+		if (!thr)
+		{
+			throw TestException(std::string("Batch"), std::string("SubmitBatch"), std::string("The batch exception was not propagated! -TB2"));
+		}
+
+		if (pool.SubmitBatch(0, [](size_t) {}).IsReady() == false)
+		{
+			throw TestException(std::string("Batch"), std::string("SubmitBatch"), std::string("The empty batch is not ready! -TB3"));
+		}
+	}
+
+	void ThreadPoolTest::Future()
+	{
+		ThreadPool pool;
+		std::vector<TaskFuture<size_t>> ftr(0);
+		std::array<uint64_t, 32> big;
+		TaskFuture<void> err;
+		TaskFuture<uint64_t> hft;
+		size_t i;
+		bool thr;
+
+		if (pool.ThreadCount() == 0)
+		{
+			throw TestException(std::string("Future"), std::string("ThreadCount"), std::string("The pool has no worker threads! -TF1"));
+		}
+
+		for (i = 0; i < 256; ++i)
+		{
+			ftr.push_back(pool.Submit([i]() { return i * i; }));
+		}
+
+		for (i = 0; i < 256; ++i)
+		{
+			if (ftr[i].Get() != i * i)
+			{
+				throw TestException(std::string("Future"), std::string("Submit"), std::string("The task future returned the wrong value! -TF2"));
+			}
+		}
+
+		// a capture larger than the slot buffer is stored on the heap
+		big.fill(3);
+		hft = pool.Submit([big]() { uint64_t sum = 0; for (uint64_t x : big) { sum += x; } return sum; });
+
+		if (hft.Get() != 96)
+		{
+			throw TestException(std::string("Future"), std::string("Submit"), std::string("The heap stored task returned the wrong value! -TF3"));
+		}
+
+		thr = false;
+		err = pool.Submit([]() { throw CryptoException(std::string("ThreadPoolTest"), std::string("Future"), std::string("task"), Enumeration::ErrorCodes::IllegalOperation); });
+
+		try
+		{
+			err.Get();
+		}
+		catch (CryptoException const &)
+		{
+			thr = true;
+		}
+
+		if (!thr)
+		{
+			throw TestException(std::string("Future"), std::string("Submit"), std::string("The task exception was not propagated! -TF4"));
+		}
+
+		pool.WaitAll();
+
+		if (pool.JobsRemaining() != 0)
+		{
+			throw TestException(std::string("Future"), std::string("WaitAll"), std::string("The pool has outstanding jobs after WaitAll! -TF5"));
+		}
+	}
+
+	void ThreadPoolTest::Stress()
+	{
+		const size_t PRDCNT = 4;
+		ThreadPool pool(4, 16);
+		std::vector<std::thread> prd(0);
+		std::atomic<size_t> cnt(0);
+		size_t i;
+
+		for (i = 0; i < PRDCNT; ++i)
+		{
+			prd.push_back(std::thread([&pool, &cnt]()
+			{
+				size_t j;
+
+				for (j = 0; j < TEST_CYCLES / PRDCNT; ++j)
+				{
+					pool.Post([&cnt]() { ++cnt; });
+				}
+			}));
+		}
+
+		for (i = 0; i < PRDCNT; ++i)
+		{
+			prd[i].join();
+		}
+
+		pool.WaitAll();
+
+		if (cnt != (TEST_CYCLES / PRDCNT) * PRDCNT)
+		{
+			throw TestException(std::string("Stress"), std::string("Post"), std::string("The task count does not match the submission count! -TS1"));
+		}
+	}
+
+	void ThreadPoolTest::OnProgress(const std::string &Data)
+	{
+		m_progressEvent(Data);
+	}
+}
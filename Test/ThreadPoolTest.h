@@ -0,0 +1,70 @@
+#ifndef CEXTEST_THREADPOOLTEST_H
+#define CEXTEST_THREADPOOLTEST_H
+
+#include "ITest.h"
+
+namespace Test
+{
+	/// <summary>
+	/// ThreadPool test; tests task futures, batches, exception propagation, and high-rate submission
+	/// </summary>
+	class ThreadPoolTest : public ITest
+	{
+	private:
+
+		static const std::string CLASSNAME;
+		static const std::string DESCRIPTION;
+		static const std::string SUCCESS;
+		static const size_t TEST_CYCLES = 100000;
+
+		TestEventHandler m_progressEvent;
+
+	public:
+
+		/// <summary>
+		/// Initialize this class
+		/// </summary>
+		ThreadPoolTest();
+
+		/// <summary>
+		/// Destructor
+		/// </summary>
+		~ThreadPoolTest();
+
+		/// <summary>
+		/// Get: The test description
+		/// </summary>
+		const std::string Description() override;
+
+		/// <summary>
+		/// Progress return event callback
+		/// </summary>
+		TestEventHandler &Progress() override;
+
+		/// <summary>
+		/// Start the tests
+		/// </summary>
+		std::string Run() override;
+
+		/// <summary>
+		/// Test a batch completes every index once, and a thrown exception reaches the future
+		/// </summary>
+		void Batch();
+
+		/// <summary>
+		/// Test the future results and exception propagation of single tasks
+		/// </summary>
+		void Future();
+
+		/// <summary>
+		/// Test many small tasks submitted from several threads through a small queue
+		/// </summary>
+		void Stress();
+
+	private:
+
+		void OnProgress(const std::string &Data);
+	};
+}
+
+#endif
@@ -2,40 +2,31 @@
 #include "../CEX/IntegerTools.h"
 #include "../CEX/MemoryTools.h"
 #include "../CEX/SecureRandom.h"
+#include "../CEX/SimdDispatch.h"
 #include "../CEX/SymmetricKey.h"
 #include "../CEX/Threefish.h"
+#include "../CEX/ThreefishKernels.h"
 #include "../CEX/TSX256.h"
 #include "../CEX/TSX512.h"
 #include "../CEX/TSX1024.h"
 
-#if defined(__AVX2__)
-#	include "../CEX/ULong256.h"
-#endif
-#if defined(__AVX512__)
-#	include "../CEX/ULong512.h"
-#endif
-
 namespace Test
 {
 	using Exception::CryptoSymmetricException;
 	using Tools::IntegerTools;
 	using Tools::MemoryTools;
 	using Prng::SecureRandom;
+	using Tools::SimdDispatch;
+	using Enumeration::SimdProfiles;
 	using Enumeration::StreamAuthenticators;
 	using Cipher::SymmetricKey;
 	using Cipher::SymmetricKeySize;
 	using Cipher::Stream::Threefish;
+	using Cipher::Stream::ThreefishKernels;
 	using Cipher::Stream::TSX256;
 	using Cipher::Stream::TSX512;
 	using Cipher::Stream::TSX1024;
 
-#if defined(__AVX2__)
-	using Numeric::ULong256;
-#endif
-
-#if defined(__AVX512__)
-	using Numeric::ULong512;
-#endif
 
 	const std::string ThreefishTest::CLASSNAME = "ThreefishTest";
 	const std::string ThreefishTest::DESCRIPTION = "Tests the 256, 512, and 1024 bit versions of the ThreeFish stream cipher (TSX256, TSX512, TSX1024) authenticated stream ciphers.";
@@ -113,6 +104,10 @@ namespace Test
 			MonteCarlo(tsx256s, m_message[0], m_key[0], m_nonce[0], m_monte[0]);
 			OnProgress(std::string("ThreefishTest: Passed Threefish-256 monte carlo tests.."));
 
+			// decrypt windows of an encrypted stream at random positions
+			Seek(tsx256s);
+			OnProgress(std::string("ThreefishTest: Passed Threefish-256 random access transform and seek tests.."));
+
 			// compare parallel output with sequential for equality
 			Parallel(tsx256s);
 			OnProgress(std::string("ThreefishTest: Passed Threefish-256 parallel to sequential equivalence test.."));
@@ -151,6 +146,9 @@ namespace Test
 			MonteCarlo(tsx512s, m_message[1], m_key[1], m_nonce[1], m_monte[1]);
 			OnProgress(std::string("ThreefishTest: Passed Threefish-512 monte carlo tests.."));
 
+			Seek(tsx512s);
+			OnProgress(std::string("ThreefishTest: Passed Threefish-512 random access transform and seek tests.."));
+
 			Parallel(tsx512s);
 			OnProgress(std::string("ThreefishTest: Passed Threefish-512 parallel to sequential equivalence test.."));
 
@@ -186,6 +184,9 @@ namespace Test
 			MonteCarlo(tsx1024s, m_message[2], m_key[2], m_nonce[2], m_monte[2]);
 			OnProgress(std::string("ThreefishTest: Passed Threefish-1024 monte carlo tests.."));
 
+			Seek(tsx1024s);
+			OnProgress(std::string("ThreefishTest: Passed Threefish-1024 random access transform and seek tests.."));
+
 			Parallel(tsx1024s);
 			OnProgress(std::string("ThreefishTest: Passed Threefish-1024 parallel to sequential equivalence test.."));
 
@@ -287,47 +288,50 @@ namespace Test
 			throw TestException(std::string("CompareP256"), std::string("PemuteP256"), std::string("Permutation output is not equal! -TP1"));
 		}
 
-#if defined(__AVX512__)
+		const SimdProfiles DETPRF = SimdDispatch::Instance().Detected();
 
-		std::array<uint64_t, 16> counter16{ 128, 128, 128, 128, 128, 128, 128, 128, 1, 1, 1, 1, 1, 1, 1, 1 };
-		std::array<uint64_t, 32> state4;
+		// every kernel compiled into the library and supported by the host is compared with the scalar permutation
+		if (ThreefishKernels::HasAvx512() && DETPRF >= SimdProfiles::Simd512)
+		{
+			std::array<uint64_t, 16> counter16{ 128, 128, 128, 128, 128, 128, 128, 128, 1, 1, 1, 1, 1, 1, 1, 1 };
+			std::array<uint64_t, 32> state4;
 
-		MemoryTools::Clear(state4, 0, 32 * sizeof(uint64_t));
+			MemoryTools::Clear(state4, 0, 32 * sizeof(uint64_t));
 
-		Threefish::PemuteP8x256H(key, counter16, tweak, state4, 72);
+			ThreefishKernels::PemuteP8x256H(key.data(), counter16.data(), tweak.data(), state4.data(), 72);
 
-		for (size_t i = 0; i < 32; i += 4)
-		{
-			for (size_t j = 0; j < 4; ++j)
+			for (size_t i = 0; i < 32; i += 4)
 			{
-				if (state4[i + j] != state1[j])
+				for (size_t j = 0; j < 4; ++j)
 				{
-					throw TestException(std::string("CompareP256"), std::string("PemuteP8x256H"), std::string("Permutation output is not equal! -TP3"));
+					if (state4[i + j] != state1[j])
+					{
+						throw TestException(std::string("CompareP256"), std::string("PemuteP8x256H"), std::string("Permutation output is not equal! -TP3"));
+					}
 				}
 			}
 		}
 
-#elif defined(__AVX2__)
-
-		std::array<uint64_t, 8> counter8{ 128, 128, 128, 128, 1, 1, 1, 1 };
-		std::array<uint64_t, 16> state3;
+		if (ThreefishKernels::HasAvx2() && DETPRF >= SimdProfiles::Simd256)
+		{
+			std::array<uint64_t, 8> counter8{ 128, 128, 128, 128, 1, 1, 1, 1 };
+			std::array<uint64_t, 16> state3;
 
-		MemoryTools::Clear(state3, 0, 16 * sizeof(uint64_t));
+			MemoryTools::Clear(state3, 0, 16 * sizeof(uint64_t));
 
-		Threefish::PemuteP4x256H(key, counter8, tweak, state3, 72);
+			ThreefishKernels::PemuteP4x256H(key.data(), counter8.data(), tweak.data(), state3.data(), 72);
 
-		for (size_t i = 0; i < 16; i += 4)
-		{
-			for (size_t j = 0; j < 4; ++j)
+			for (size_t i = 0; i < 16; i += 4)
 			{
-				if (state3[i + j] != state1[j])
+				for (size_t j = 0; j < 4; ++j)
 				{
-					throw TestException(std::string("CompareP256"), std::string("PemuteP4x256H"), std::string("Permutation output is not equal! -TP2"));
+					if (state3[i + j] != state1[j])
+					{
+						throw TestException(std::string("CompareP256"), std::string("PemuteP4x256H"), std::string("Permutation output is not equal! -TP2"));
+					}
 				}
 			}
 		}
-
-#endif
 	}
 
 	void ThreefishTest::CompareP512()
@@ -352,48 +356,50 @@ namespace Test
 			throw TestException(std::string("CompareP512"), std::string("PemuteP512"), std::string("Permutation output is not equal! -TP1"));
 		}
 
-#if defined(__AVX512__)
+		const SimdProfiles DETPRF = SimdDispatch::Instance().Detected();
 
-		std::array<uint64_t, 16> counter16{ 128, 128, 128, 128, 128, 128, 128, 128, 1, 1, 1, 1, 1, 1, 1, 1 };
-		std::array<uint64_t, 64> state4;
+		// every kernel compiled into the library and supported by the host is compared with the scalar permutation
+		if (ThreefishKernels::HasAvx512() && DETPRF >= SimdProfiles::Simd512)
+		{
+			std::array<uint64_t, 16> counter16{ 128, 128, 128, 128, 128, 128, 128, 128, 1, 1, 1, 1, 1, 1, 1, 1 };
+			std::array<uint64_t, 64> state4;
 
-		MemoryTools::Clear(state4, 0, 64 * sizeof(uint64_t));
+			MemoryTools::Clear(state4, 0, 64 * sizeof(uint64_t));
 
-		Threefish::PemuteP8x512H(key, counter16, tweak, state4, 96);
+			ThreefishKernels::PemuteP8x512H(key.data(), counter16.data(), tweak.data(), state4.data(), 96);
 
-		for (size_t i = 0; i < 64; i += 8)
-		{
-			for (size_t j = 0; j < 8; ++j)
+			for (size_t i = 0; i < 64; i += 8)
 			{
-				if (state4[i + j] != state1[j])
+				for (size_t j = 0; j < 8; ++j)
 				{
-					throw TestException(std::string("CompareP512"), std::string("PemuteP8x512H"), std::string("Permutation output is not equal! -TP3"));
+					if (state4[i + j] != state1[j])
+					{
+						throw TestException(std::string("CompareP512"), std::string("PemuteP8x512H"), std::string("Permutation output is not equal! -TP3"));
+					}
 				}
 			}
 		}
 
-#elif defined(__AVX2__)
-
-		std::array<uint64_t, 8> counter8{ 128, 128, 128, 128, 1, 1, 1, 1 };
-		std::array<uint64_t, 32> state3;
+		if (ThreefishKernels::HasAvx2() && DETPRF >= SimdProfiles::Simd256)
+		{
+			std::array<uint64_t, 8> counter8{ 128, 128, 128, 128, 1, 1, 1, 1 };
+			std::array<uint64_t, 32> state3;
 
-		MemoryTools::Clear(state3, 0, 32 * sizeof(uint64_t));
+			MemoryTools::Clear(state3, 0, 32 * sizeof(uint64_t));
 
-		Threefish::PemuteP4x512H(key, counter8, tweak, state3, 96);
+			ThreefishKernels::PemuteP4x512H(key.data(), counter8.data(), tweak.data(), state3.data(), 96);
 
-		for (size_t i = 0; i < 32; i += 8)
-		{
-			for (size_t j = 0; j < 8; ++j)
+			for (size_t i = 0; i < 32; i += 8)
 			{
-				if (state3[i + j] != state1[j])
+				for (size_t j = 0; j < 8; ++j)
 				{
-					throw TestException(std::string("CompareP512"), std::string("PemuteP4x512H"), std::string("Permutation output is not equal! -TP2"));
+					if (state3[i + j] != state1[j])
+					{
+						throw TestException(std::string("CompareP512"), std::string("PemuteP4x512H"), std::string("Permutation output is not equal! -TP2"));
+					}
 				}
 			}
 		}
-
-#endif
-
 	}
 
 	void ThreefishTest::CompareP1024()
@@ -418,48 +424,50 @@ namespace Test
 			throw TestException(std::string("CompareP1024"), std::string("PemuteP1024"), std::string("Permutation output is not equal! -TP1"));
 		}
 
-#if defined(__AVX512__)
+		const SimdProfiles DETPRF = SimdDispatch::Instance().Detected();
 
-		std::array<uint64_t, 16> counter16{ 128, 128, 128, 128, 128, 128, 128, 128, 1, 1, 1, 1, 1, 1, 1, 1 };
-		std::array<uint64_t, 128> state4;
+		// every kernel compiled into the library and supported by the host is compared with the scalar permutation
+		if (ThreefishKernels::HasAvx512() && DETPRF >= SimdProfiles::Simd512)
+		{
+			std::array<uint64_t, 16> counter16{ 128, 128, 128, 128, 128, 128, 128, 128, 1, 1, 1, 1, 1, 1, 1, 1 };
+			std::array<uint64_t, 128> state4;
 
-		MemoryTools::Clear(state4, 0, 128 * sizeof(uint64_t));
+			MemoryTools::Clear(state4, 0, 128 * sizeof(uint64_t));
 
-		Threefish::PemuteP8x1024H(key, counter16, tweak, state4, 120);
+			ThreefishKernels::PemuteP8x1024H(key.data(), counter16.data(), tweak.data(), state4.data(), 120);
 
-		for (size_t i = 0; i < 128; i += 16)
-		{
-			for (size_t j = 0; j < 16; ++j)
+			for (size_t i = 0; i < 128; i += 16)
 			{
-				if (state4[i + j] != state1[j])
+				for (size_t j = 0; j < 16; ++j)
 				{
-					throw TestException(std::string("CompareP1024"), std::string("PemuteP8x1024H"), std::string("Permutation output is not equal! -TP3"));
+					if (state4[i + j] != state1[j])
+					{
+						throw TestException(std::string("CompareP1024"), std::string("PemuteP8x1024H"), std::string("Permutation output is not equal! -TP3"));
+					}
 				}
 			}
 		}
 
-#elif defined(__AVX2__)
-		
-		std::array<uint64_t, 8> counter8{ 128, 128, 128, 128, 1, 1, 1, 1 };
-		std::array<uint64_t, 64> state3;
+		if (ThreefishKernels::HasAvx2() && DETPRF >= SimdProfiles::Simd256)
+		{
+			std::array<uint64_t, 8> counter8{ 128, 128, 128, 128, 1, 1, 1, 1 };
+			std::array<uint64_t, 64> state3;
 
-		MemoryTools::Clear(state3, 0, 64 * sizeof(uint64_t));
+			MemoryTools::Clear(state3, 0, 64 * sizeof(uint64_t));
 
-		Threefish::PemuteP4x1024H(key, counter8, tweak, state3, 120);
+			ThreefishKernels::PemuteP4x1024H(key.data(), counter8.data(), tweak.data(), state3.data(), 120);
 
-		for (size_t i = 0; i < 64; i += 16)
-		{
-			for (size_t j = 0; j < 16; ++j)
+			for (size_t i = 0; i < 64; i += 16)
 			{
-				if (state3[i + j] != state1[j])
+				for (size_t j = 0; j < 16; ++j)
 				{
-					throw TestException(std::string("CompareP1024"), std::string("PemuteP4x1024H"), std::string("Permutation output is not equal! -TP2"));
+					if (state3[i + j] != state1[j])
+					{
+						throw TestException(std::string("CompareP1024"), std::string("PemuteP4x1024H"), std::string("Permutation output is not equal! -TP2"));
+					}
 				}
 			}
 		}
-
-#endif
-
 	}
 
 	void ThreefishTest::Exception(IStreamCipher* Cipher)
@@ -721,6 +729,83 @@ namespace Test
 		}
 	}
 
+	void ThreefishTest::Seek(IStreamCipher* Cipher)
+	{
+		const size_t MSGLEN = (Cipher->ParallelBlockSize() * 2) + 1000;
+		Cipher::SymmetricKeySize ks = Cipher->LegalKeySizes()[0];
+		std::vector<uint8_t> cpt(MSGLEN);
+		std::vector<uint8_t> inp(MSGLEN);
+		std::vector<uint8_t> key(ks.KeySize());
+		std::vector<uint8_t> nonce(ks.IVSize());
+		std::vector<uint8_t> otp(MSGLEN);
+		Prng::SecureRandom rnd;
+		size_t plen;
+		size_t pos;
+
+		for (size_t i = 0; i < TEST_CYCLES; ++i)
+		{
+			rnd.Generate(key, 0, key.size());
+			rnd.Generate(nonce, 0, nonce.size());
+			rnd.Generate(inp, 0, MSGLEN);
+			SymmetricKey kp(key, nonce);
+
+			// encrypt the whole stream
+			Cipher->Initialize(true, kp);
+			Cipher->ParallelProfile().IsParallel() = true;
+			Cipher->Transform(inp, 0, cpt, 0, MSGLEN);
+
+			// decrypt a random window at an unaligned position
+			pos = static_cast<size_t>(rnd.NextUInt32(static_cast<uint32_t>(MSGLEN - 1), 0));
+			plen = static_cast<size_t>(rnd.NextUInt32(static_cast<uint32_t>(MSGLEN - pos), 1));
+			MemoryTools::Clear(otp, 0, otp.size());
+			Cipher->Initialize(false, kp);
+			Cipher->TransformAt(pos, cpt, pos, otp, pos, plen);
+
+			if (IntegerTools::Compare(inp, pos, otp, pos, plen) == false)
+			{
+				throw TestException(std::string("Seek"), Cipher->Name(), std::string("Cipher output is not equal! -TK1"));
+			}
+
+			// decrypt the stream as two disjoint ranges, in reverse order
+			MemoryTools::Clear(otp, 0, otp.size());
+			Cipher->Initialize(false, kp);
+			Cipher->TransformAt(pos, cpt, pos, otp, pos, MSGLEN - pos);
+			Cipher->TransformAt(0, cpt, 0, otp, 0, pos);
+
+			if (otp != inp)
+			{
+				throw TestException(std::string("Seek"), Cipher->Name(), std::string("Cipher output is not equal! -TK2"));
+			}
+
+			// seek to a block aligned position and continue with a standard transform
+			pos -= (pos % 128);
+			MemoryTools::Clear(otp, 0, otp.size());
+			Cipher->Initialize(false, kp);
+			Cipher->Seek(pos);
+			Cipher->Transform(cpt, pos, otp, pos, MSGLEN - pos);
+
+			if (IntegerTools::Compare(inp, pos, otp, pos, MSGLEN - pos) == false)
+			{
+				throw TestException(std::string("Seek"), Cipher->Name(), std::string("Cipher output is not equal! -TK3"));
+			}
+
+			// an unaligned seek must be rejected
+			try
+			{
+				Cipher->Seek(pos + 1);
+
+				throw TestException(std::string("Seek"), Cipher->Name(), std::string("Exception handling failure! -TK4"));
+			}
+			catch (CryptoSymmetricException const &)
+			{
+			}
+			catch (TestException const &)
+			{
+				throw;
+			}
+		}
+	}
+
 	void ThreefishTest::Stress(IStreamCipher* Cipher)
 	{
 		const uint32_t MINPRL = static_cast<uint32_t>(Cipher->ParallelProfile().ParallelBlockSize());
@@ -144,6 +144,13 @@ namespace Test
 		/// <param name="Cipher">The cipher instance pointer</param>
 		void Parallel(IStreamCipher* Cipher);
 
+		/// <summary>
+		/// Tests random access decryption with TransformAt and Seek against a sequentially encrypted stream in a looping [TEST_CYCLES] test
+		/// </summary>
+		/// 
+		/// <param name="Cipher">The cipher instance pointer</param>
+		void Seek(IStreamCipher* Cipher);
+
 		/// <summary>
 		/// Test transformation and inverse with random in a looping [TEST_CYCLES] stress-test
 		/// </summary>
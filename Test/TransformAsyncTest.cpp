@@ -0,0 +1,267 @@
+#include "TransformAsyncTest.h"
+#include "../CEX/CSX512.h"
+#include "../CEX/CTR.h"
+#include "../CEX/GCM.h"
+#include "../CEX/HBA.h"
+#include "../CEX/IParallelExecutor.h"
+#include "../CEX/RCS.h"
+#include <atomic>
+#include <thread>
+
+namespace Test
+{
+	using namespace Cipher::Block::Mode;
+	using Cipher::Stream::CSX512;
+	using Cipher::Stream::RCS;
+	using Exception::CryptoAuthenticationFailure;
+	using Enumeration::BlockCiphers;
+	using Enumeration::StreamAuthenticators;
+	using Cipher::SymmetricKey;
+	using Cipher::SymmetricKeySize;
+
+	/// <summary>
+	/// An executor stand-in that holds submitted functions until they are released; loops run on the calling thread
+	/// </summary>
+	class DeferredExecutor final : public IParallelExecutor
+	{
+	public:
+
+		std::vector<std::function<void()>> Queued;
+
+		DeferredExecutor()
+			:
+			Queued(0)
+		{
+		}
+
+		const size_t Concurrency() override
+		{
+			return 1;
+		}
+
+		void BulkRun(size_t From, size_t To, const std::function<void(size_t)> &F) override
+		{
+			for (size_t i = From; i < To; ++i)
+			{
+				F(i);
+			}
+		}
+
+		void Submit(const std::function<void()> &F) override
+		{
+			Queued.push_back(F);
+		}
+
+		void Wait() override
+		{
+			for (size_t i = 0; i < Queued.size(); ++i)
+			{
+				Queued[i]();
+			}
+
+			Queued.clear();
+		}
+	};
+
+	const std::string TransformAsyncTest::CLASSNAME = "TransformAsyncTest";
+	const std::string TransformAsyncTest::DESCRIPTION = "TransformAsync test; compares asynchronous and blocking transforms, and tests callbacks, cancellation and exception propagation.";
+	const std::string TransformAsyncTest::SUCCESS = "SUCCESS! All TransformAsync tests have executed succesfully.";
+
+	TransformAsyncTest::TransformAsyncTest()
+		:
+		m_progressEvent()
+	{
+	}
+
+	TransformAsyncTest::~TransformAsyncTest()
+	{
+	}
+
+	const std::string TransformAsyncTest::Description()
+	{
+		return DESCRIPTION;
+	}
+
+	TestEventHandler &TransformAsyncTest::Progress()
+	{
+		return m_progressEvent;
+	}
+
+	std::string TransformAsyncTest::Run()
+	{
+		try
+		{
+			Equivalence();
+			OnProgress(std::string("TransformAsyncTest: Passed asynchronous to blocking transform equivalence tests.."));
+			Callback();
+			OnProgress(std::string("TransformAsyncTest: Passed completion callback tests.."));
+			Cancellation();
+			OnProgress(std::string("TransformAsyncTest: Passed cancellation and exception propagation tests.."));
+
+			return SUCCESS;
+		}
+		catch (TestException const &ex)
+		{
+			throw TestException(CLASSNAME, ex.Function(), ex.Origin(), ex.Message());
+		}
+		catch (CryptoException &ex)
+		{
+			throw TestException(CLASSNAME, ex.Location(), ex.Origin(), ex.Message());
+		}
+		catch (std::exception const &ex)
+		{
+			throw TestException(CLASSNAME, std::string("Unknown Origin"), std::string(ex.what()));
+		}
+	}
+
+	void TransformAsyncTest::Callback()
+	{
+		const size_t MSGLEN = MESSAGE_SIZE;
+		CTR cpr(BlockCiphers::AES);
+		SymmetricKeySize ks = cpr.LegalKeySizes()[0];
+		std::vector<uint8_t> inp(MSGLEN);
+		std::vector<uint8_t> key(ks.KeySize());
+		std::vector<uint8_t> nonce(ks.IVSize());
+		std::vector<uint8_t> otp(MSGLEN);
+		std::atomic<size_t> cnt(0);
+		std::atomic<bool> rdy(false);
+		TransformHandle hnd;
+		size_t i;
+
+		TestUtils::GetRandom(key);
+		SymmetricKey kp(key, nonce);
+		cpr.Initialize(true, kp);
+
+		hnd = cpr.TransformAsync(inp, 0, otp, 0, MSGLEN, [&cnt, &rdy](TransformHandle &Handle)
+		{
+			rdy = Handle.IsReady() && !Handle.IsCancelled();
+			++cnt;
+		});
+
+		hnd.Get();
+
+		// the callback runs after the handle is ready
+		for (i = 0; i < 10000 && cnt == 0; ++i)
+		{
+			std::this_thread::yield();
+		}
+
+		if (cnt != 1 || !rdy)
+		{
+			throw TestException(std::string("Callback"), cpr.Name(), std::string("The completion callback did not run once with a ready handle! -TC1"));
+		}
+
+		if (hnd.Processed() != MSGLEN)
+		{
+			throw TestException(std::string("Callback"), cpr.Name(), std::string("The processed length is invalid! -TC2"));
+		}
+	}
+
+	void TransformAsyncTest::Cancellation()
+	{
+		const size_t MSGLEN = MESSAGE_SIZE;
+		CTR cpr(BlockCiphers::AES);
+		GCM gcm(BlockCiphers::AES);
+		DeferredExecutor exe;
+		SymmetricKeySize ks = cpr.LegalKeySizes()[0];
+		std::vector<uint8_t> inp(MSGLEN);
+		std::vector<uint8_t> key(ks.KeySize());
+		std::vector<uint8_t> nonce(ks.IVSize());
+		std::vector<uint8_t> otp(MSGLEN + 16);
+		TransformHandle hnd;
+		bool thr;
+
+		TestUtils::GetRandom(inp);
+		TestUtils::GetRandom(key);
+		SymmetricKey kp(key, nonce);
+
+		// the transform is held in the executor queue, and is cancelled before it starts
+		cpr.Initialize(true, kp);
+		cpr.ParallelProfile().SetExecutor(&exe);
+		hnd = cpr.TransformAsync(inp, 0, otp, 0, MSGLEN);
+
+		if (hnd.IsReady() || exe.Queued.size() != 1)
+		{
+			throw TestException(std::string("Cancellation"), cpr.Name(), std::string("The transform was not queued on the cipher executor! -TN1"));
+		}
+
+		hnd.Cancel();
+		exe.Wait();
+
+		if (!hnd.IsReady() || !hnd.IsCancelled() || hnd.Processed() != 0)
+		{
+			throw TestException(std::string("Cancellation"), cpr.Name(), std::string("The queued transform was not cancelled! -TN2"));
+		}
+
+		// a cancelled transform does not throw
+		hnd.Get();
+		cpr.ParallelProfile().SetExecutor(nullptr);
+
+		// an authentication failure is re-thrown by the handle
+		ks = gcm.LegalKeySizes()[0];
+		nonce.resize(ks.IVSize());
+		SymmetricKey kpg(key, nonce);
+		gcm.Initialize(true, kpg);
+		gcm.Transform(inp, 0, otp, 0, MSGLEN);
+		otp[0] ^= 1;
+		gcm.Initialize(false, kpg);
+		thr = false;
+
+		try
+		{
+			gcm.TransformAsync(otp, 0, inp, 0, MSGLEN).Get();
+		}
+		catch (CryptoAuthenticationFailure const &)
+		{
+			thr = true;
+		}
+
+		if (!thr)
+		{
+			throw TestException(std::string("Cancellation"), gcm.Name(), std::string("The authentication exception was not propagated! -TN3"));
+		}
+
+		// an empty handle can not be waited on
+		thr = false;
+
+		try
+		{
+			TransformHandle().Wait();
+		}
+		catch (CryptoException const &)
+		{
+			thr = true;
+		}
+
+		if (!thr)
+		{
+			throw TestException(std::string("Cancellation"), std::string("TransformHandle"), std::string("The empty handle did not throw! -TN4"));
+		}
+	}
+
+	void TransformAsyncTest::Equivalence()
+	{
+		CTR* ctr = new CTR(BlockCiphers::AES);
+		GCM* gcm = new GCM(BlockCiphers::AES);
+		HBA* hba = new HBA(BlockCiphers::AES, StreamAuthenticators::HMACSHA2256);
+		RCS* rcs = new RCS(false);
+		CSX512* csx = new CSX512(true);
+
+		Compare(ctr, 0, std::string("TE"));
+		Compare(gcm, gcm->TagSize(), std::string("TG"));
+		Compare(hba, hba->TagSize(), std::string("TH"));
+		Compare(rcs, 0, std::string("TR"));
+		Compare(csx, csx->TagSize(), std::string("TX"));
+
+		delete ctr;
+		delete gcm;
+		delete hba;
+		delete rcs;
+		delete csx;
+	}
+
+	void TransformAsyncTest::OnProgress(const std::string &Data)
+	{
+		m_progressEvent(Data);
+	}
+}
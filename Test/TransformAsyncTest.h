@@ -0,0 +1,107 @@
+#ifndef CEXTEST_TRANSFORMASYNCTEST_H
+#define CEXTEST_TRANSFORMASYNCTEST_H
+
+#include "ITest.h"
+#include "../CEX/SymmetricKey.h"
+#include "../CEX/TransformHandle.h"
+
+namespace Test
+{
+	/// <summary>
+	/// TransformAsync test; compares asynchronous and blocking transforms, and tests completion callbacks, cancellation and exception propagation
+	/// </summary>
+	class TransformAsyncTest : public ITest
+	{
+	private:
+
+		static const std::string CLASSNAME;
+		static const std::string DESCRIPTION;
+		static const std::string SUCCESS;
+		static const size_t MESSAGE_SIZE = 1048613;
+
+		TestEventHandler m_progressEvent;
+
+	public:
+
+		/// <summary>
+		/// Initialize this class
+		/// </summary>
+		TransformAsyncTest();
+
+		/// <summary>
+		/// Destructor
+		/// </summary>
+		~TransformAsyncTest();
+
+		/// <summary>
+		/// Get: The test description
+		/// </summary>
+		const std::string Description() override;
+
+		/// <summary>
+		/// Progress return event callback
+		/// </summary>
+		TestEventHandler &Progress() override;
+
+		/// <summary>
+		/// Start the tests
+		/// </summary>
+		std::string Run() override;
+
+		/// <summary>
+		/// Test the completion callback runs once with a ready handle
+		/// </summary>
+		void Callback();
+
+		/// <summary>
+		/// Test a queued transform is cancelled before it starts, and an authentication failure reaches the handle
+		/// </summary>
+		void Cancellation();
+
+		/// <summary>
+		/// Compare the asynchronous transform of CTR, GCM, HBA, RCS and CSX512 with the blocking transform
+		/// </summary>
+		void Equivalence();
+
+	private:
+
+		template<typename T>
+		static void Compare(T* Cipher, size_t TagSize, const std::string &Code)
+		{
+			const size_t MSGLEN = MESSAGE_SIZE;
+			Cipher::SymmetricKeySize ks = Cipher->LegalKeySizes()[0];
+			std::vector<uint8_t> inp(MSGLEN);
+			std::vector<uint8_t> key(ks.KeySize());
+			std::vector<uint8_t> nonce(ks.IVSize());
+			std::vector<uint8_t> otp1(MSGLEN + TagSize);
+			std::vector<uint8_t> otp2(MSGLEN + TagSize);
+			TransformHandle hnd;
+
+			TestUtils::GetRandom(inp);
+			TestUtils::GetRandom(key);
+			TestUtils::GetRandom(nonce);
+			Cipher::SymmetricKey kp(key, nonce);
+
+			Cipher->Initialize(true, kp);
+			Cipher->Transform(inp, 0, otp1, 0, MSGLEN);
+
+			Cipher->Initialize(true, kp);
+			hnd = Cipher->TransformAsync(inp, 0, otp2, 0, MSGLEN);
+			hnd.Get();
+
+			if (!hnd.IsReady() || hnd.IsCancelled() || hnd.Processed() != MSGLEN)
+			{
+				throw TestException(std::string("Compare"), Cipher->Name(), std::string("The handle state is invalid! -") + Code + std::string("1"));
+			}
+
+			if (otp1 != otp2)
+			{
+				throw TestException(std::string("Compare"), Cipher->Name(), std::string("The asynchronous output is not equal! -") + Code + std::string("2"));
+			}
+		}
+
+		void OnProgress(const std::string &Data);
+	};
+}
+
+#endif